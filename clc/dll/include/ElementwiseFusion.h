@@ -0,0 +1,284 @@
+// Copyright (C) 1998-2026 Object Vision b.v.
+// License: GNU GPL 3
+/////////////////////////////////////////////////////////////////////////////
+
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+File: ElementwiseFusion.h
+Purpose:
+- Fusion of chains of elementwise attribute operators (OperAttrUni, OperAttrBin, OperAttrTer) into a single per-tile kernel,
+  such as sqrt(a*a + b*b) * factor, without allocating the tiles of the intermediate results.
+
+Summary:
+- A pipelined result of an elementwise operator with separable value types is an ElementwiseTileFunctor; besides providing its tiles,
+  it can create a block_evaluator for each tile that calculates any block of consecutive elements of that tile.
+- An elementwise operator that finds such an argument without repetitive users evaluates the argument's block_evaluator
+  per block of FUSION_BLOCK_SIZE elements into a small buffer instead of requesting the argument's tiles.
+  Nested fusable arguments are evaluated recursively per block, so the intermediates of a chain stay in cache.
+- Fusion doesn't change results: a fused argument still provides (and calculates) its tiles to any other consumer.
+- A failure in a fused argument is caught, and its result item is marked as failed, by the argument's own block_evaluator,
+  as its tile calculation would, before it propagates to the consumer.
+- The block evaluators of all tiles are created when the pipelined result is constructed, which requests the future tiles of
+  the materialized arguments of the whole chain, as the unfused operators do, so that they can be prepared in advance.
+*/
+
+#if !defined(__CLC_ELEMENTWISEFUSION_H)
+#define __CLC_ELEMENTWISEFUSION_H
+
+#include "geo/ElemTraits.h"
+
+#include "AbstrDataItem.h"
+#include "DataArray.h"
+#include "ParallelTiles.h"
+#include "TileFunctorImpl.h"
+
+constexpr tile_offset FUSION_BLOCK_SIZE = 4096;
+
+template <typename V>
+struct block_evaluator
+{
+	using seq_t = typename sequence_traits<V>::seq_t;
+
+	virtual ~block_evaluator() {}
+
+	// calculates the elements [first, first + resBlock.size()) of the tile for which this evaluator was created
+	virtual void Eval(tile_offset first, seq_t resBlock) = 0;
+};
+
+template <typename V> using block_evaluator_ptr = std::unique_ptr<block_evaluator<V>>;
+template <typename V> using block_evaluator_factory = std::function<block_evaluator_ptr<V>(tile_id)>;
+
+template <typename V>
+struct elementwise_tile_source
+{
+	virtual auto CreateBlockEvaluator(tile_id t) const -> block_evaluator_ptr<V> = 0;
+};
+
+// returns the pipelined elementwise calculation of argA to fuse with, or nullptr when argA is to be read tile by tile.
+template <typename V>
+auto GetFusableSource(const AbstrDataItem* argA, bool isParam) -> const elementwise_tile_source<V>*
+{
+	static_assert(is_separable_v<V>);
+	if (isParam || argA->HasRepetitiveUsers())
+		return nullptr; // intermediates that are kept for other users are materialized once
+	return dynamic_cast<const elementwise_tile_source<V>*>(const_array_cast<V>(argA));
+}
+
+// *****************************************************************************
+//	item_block_evaluator: fail handling of the result item of an evaluator
+// *****************************************************************************
+
+template <typename V>
+struct item_block_evaluator : block_evaluator<V>
+{
+	using typename block_evaluator<V>::seq_t;
+
+	item_block_evaluator(SharedPtr<AbstrDataItem> resultAdi, block_evaluator_ptr<V> evaluator)
+		: m_ResultAdi(std::move(resultAdi))
+		, m_Evaluator(std::move(evaluator))
+	{}
+
+	void Eval(tile_offset first, seq_t resBlock) override
+	{
+		if (m_ResultAdi->WasFailed(FailType::Data))
+			m_ResultAdi->ThrowFail();
+		try {
+			m_Evaluator->Eval(first, resBlock);
+		}
+		catch (...)
+		{
+			m_ResultAdi->CatchFail(FailType::Data);
+			throw;
+		}
+	}
+
+private:
+	SharedPtr<AbstrDataItem> m_ResultAdi;
+	block_evaluator_ptr<V>   m_Evaluator;
+};
+
+// *****************************************************************************
+//	fused_arg: provides consecutive blocks of one argument tile
+// *****************************************************************************
+
+template <typename V>
+struct fused_arg
+{
+	using seq_t  = typename sequence_traits<V>::seq_t;
+	using cseq_t = typename sequence_traits<V>::cseq_t;
+
+	fused_arg(const DataArray<V>* arr, const elementwise_tile_source<V>* src, tile_id t, bool isParam)
+		: m_IsParam(isParam)
+	{
+		static_assert(is_separable_v<V>);
+		if (src && !isParam)
+			m_Evaluator = src->CreateBlockEvaluator(t);
+		else
+			m_FutureTile = arr->GetFutureTile(isParam ? 0 : t);
+	}
+
+	bool IsFused() const { return bool(m_Evaluator); }
+	bool NeedsTile() const { return m_FutureTile && !m_Tile; }
+
+	void AcquireTile()
+	{
+		if (NeedsTile())
+			m_Tile = m_FutureTile->GetTile();
+	}
+
+	auto GetBlock(tile_offset first, tile_offset n) -> cseq_t
+	{
+		if (m_Evaluator)
+		{
+			assert(n <= FUSION_BLOCK_SIZE);
+			if (!m_Buffer)
+				m_Buffer = std::make_unique<V[]>(FUSION_BLOCK_SIZE);
+			m_Evaluator->Eval(first, seq_t(m_Buffer.get(), n));
+			return cseq_t(m_Buffer.get(), n);
+		}
+		AcquireTile();
+		if (m_IsParam)
+			return m_Tile.get_view();
+		assert(first + n <= m_Tile.size());
+		return cseq_t(m_Tile.begin() + first, n);
+	}
+
+private:
+	bool m_IsParam;
+
+	block_evaluator_ptr<V> m_Evaluator;
+	std::unique_ptr<V[]>   m_Buffer;
+	std::shared_ptr<typename DataArray<V>::future_tile> m_FutureTile;
+	typename DataArray<V>::locked_cseq_t m_Tile;
+};
+
+inline void AcquireTiles() {}
+
+// obtains the tiles of the materialized arguments, concurrently when more than one is needed
+template <typename Head, typename ...Tail>
+void AcquireTiles(Head& head, Tail&... tail)
+{
+	if (head.NeedsTile() && (tail.NeedsTile() || ...))
+	{
+		auto futureHead = throttled_async([&head] { head.AcquireTile(); return true; });
+		AcquireTiles(tail...);
+		futureHead->get();
+	}
+	else
+	{
+		head.AcquireTile();
+		AcquireTiles(tail...);
+	}
+}
+
+// *****************************************************************************
+//	elementwise_evaluator: applies a CalcTile to blocks of its arguments
+// *****************************************************************************
+
+template <typename ResultValueType, typename CalcFunc, typename ...ArgValueTypes>
+struct elementwise_evaluator : block_evaluator<ResultValueType>
+{
+	using typename block_evaluator<ResultValueType>::seq_t;
+
+	elementwise_evaluator(CalcFunc&& calcFunc, fused_arg<ArgValueTypes>&&... args)
+		: m_CalcFunc(std::move(calcFunc))
+		, m_Args(std::move(args)...)
+	{}
+
+	void Eval(tile_offset first, seq_t resBlock) override
+	{
+		std::apply([](auto&... args) { AcquireTiles(args...); }, m_Args);
+
+		// without fused arguments, the whole range is calculated at once, as done for materialized arguments
+		bool hasFusedArgs = std::apply([](const auto&... args) { return (args.IsFused() || ...); }, m_Args);
+		tile_offset n = resBlock.size();
+		tile_offset blockSize = hasFusedArgs ? FUSION_BLOCK_SIZE : n;
+		for (tile_offset i = 0; i < n; i += blockSize)
+		{
+			tile_offset m = std::min<tile_offset>(blockSize, n - i);
+			std::apply([this, first, i, m, &resBlock](auto&... args)
+				{
+					m_CalcFunc(seq_t(resBlock.begin() + i, m), args.GetBlock(first + i, m)...);
+				}
+			,	m_Args
+			);
+		}
+	}
+
+private:
+	CalcFunc m_CalcFunc;
+	std::tuple<fused_arg<ArgValueTypes>...> m_Args;
+};
+
+template <typename ResultValueType, typename CalcFunc, typename ...ArgValueTypes>
+auto make_elementwise_evaluator(CalcFunc&& calcFunc, fused_arg<ArgValueTypes>&&... args) -> block_evaluator_ptr<ResultValueType>
+{
+	return std::make_unique<elementwise_evaluator<ResultValueType, std::decay_t<CalcFunc>, ArgValueTypes...>>(std::forward<CalcFunc>(calcFunc), std::move(args)...);
+}
+
+// *****************************************************************************
+//	ElementwiseTileFunctor: a pipelined result that can be fused with its consumers
+// *****************************************************************************
+
+template <typename V, typename Base>
+struct ElementwiseTileFunctor : Base, elementwise_tile_source<V>
+{
+	template <typename ...Args>
+	ElementwiseTileFunctor(block_evaluator_factory<V> evaluatorFactory, Args&&... args)
+		: Base(std::forward<Args>(args)...)
+		, m_EvaluatorFactory(std::move(evaluatorFactory))
+	{}
+
+	auto CreateBlockEvaluator(tile_id t) const -> block_evaluator_ptr<V> override
+	{
+		return m_EvaluatorFactory(t);
+	}
+
+	block_evaluator_factory<V> m_EvaluatorFactory;
+};
+
+template <typename V>
+auto make_unique_ElementwiseTileFunctor(SharedPtr<AbstrDataItem> resultAdi, bool lazy, const AbstrTileRangeData* tiledDomainRangeData, range_data_ptr_or_void<field_of_t<V>> valueRangePtr, block_evaluator_factory<V> evaluatorFactory MG_DEBUG_ALLOCATOR_SRC(SharedStr srcStr))
+-> std::unique_ptr<TileFunctor<V>>
+{
+	// evaluators of this result, both for its own tiles and for fusing consumers, report failures to resultAdi
+	block_evaluator_factory<V> itemEvaluatorFactory = [resultAdi, evaluatorFactory = std::move(evaluatorFactory)](tile_id t) -> block_evaluator_ptr<V>
+		{
+			return std::make_unique<item_block_evaluator<V>>(resultAdi, evaluatorFactory(t));
+		};
+
+	using prepare_state = std::shared_ptr<block_evaluator<V>>;
+	auto prepareFunc = [itemEvaluatorFactory](tile_id t) -> prepare_state { return itemEvaluatorFactory(t); };
+	auto applyFunc = [](typename sequence_traits<V>::seq_t resData, const prepare_state& evaluator)
+		{
+			evaluator->Eval(0, resData);
+		};
+
+	if (lazy)
+	{
+		auto tn = tiledDomainRangeData->GetNrTiles();
+		auto preparedStates = OwningPtrReservedArray<prepare_state>(tn);
+		for (tile_id t = 0; t != tn; ++t)
+			preparedStates.emplace_back(prepareFunc(t));
+
+		auto lazyApplyFunc = [applyFunc, preparedStates = std::move(preparedStates)](AbstrDataObject* ado, tile_id t)
+			{
+				auto resData = mutable_array_cast<V>(ado)->GetWritableTile(t, dms_rw_mode::write_only_all);
+				applyFunc(resData.get_view(), preparedStates[t]);
+			};
+		using base_t = LazyTileFunctor<V, decltype(lazyApplyFunc)>;
+		return std::make_unique<ElementwiseTileFunctor<V, base_t>>(std::move(itemEvaluatorFactory)
+			, resultAdi, tiledDomainRangeData, valueRangePtr, std::move(lazyApplyFunc) MG_DEBUG_ALLOCATOR_SRC(std::move(srcStr))
+		);
+	}
+
+	using base_t = FutureTileFunctor<V, prepare_state, false, decltype(prepareFunc), decltype(applyFunc)>;
+	return std::make_unique<ElementwiseTileFunctor<V, base_t>>(std::move(itemEvaluatorFactory)
+		, resultAdi, tiledDomainRangeData, valueRangePtr, std::move(prepareFunc), std::move(applyFunc) MG_DEBUG_ALLOCATOR_SRC(std::move(srcStr))
+	);
+}
+
+#endif //!defined(__CLC_ELEMENTWISEFUSION_H)
@@ -0,0 +1,287 @@
+// Copyright (C) 1998-2026 Object Vision b.v.
+// License: GNU GPL 3
+/////////////////////////////////////////////////////////////////////////////
+
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+File: HashAggregation.h
+Purpose:
+- Multi-threaded aggregation of values per distinct key, such as counts of values for unique, modus, frequency_table and unique_count,
+  or weights of (partition, value) pairs for modus_weighted, when the values range is too large for a counting table.
+
+Summary:
+- Each task adds a range of elements to its own open addressing table (linear probing, at most half full) that maps keys to accumulators.
+  Tiles are divided over the available threads as contiguous tile ranges; a tile with more than HASH_AGGREGATION_CHUNK_SIZE elements
+  is split into chunks that are added concurrently to separate tables.
+- The entries of all tables are then collected, stably radix sorted on the keys (see set/ParallelSort.h) and equal keys are combined.
+  The resulting (key, accumulator) pairs are thus ordered as DataLessThanCompare, i.e. with null first, as the sort-merge based ValuesTable functions.
+- Tables are combined in a fixed order, so results only depend on the number of threads through the summation order of floating point accumulators.
+- Keys are values with a radix_key, or Pair<SizeT, V> of a partition index and such a value; nulls are ordinary keys, callers skip them if required.
+- Callers only take this path for a wide values range (see IsWideValueRange); values of a small range keep the sort-merge paths,
+  as their runs collapse to few (value, count) pairs.
+*/
+
+#if !defined(__CLC_HASHAGGREGATION_H)
+#define __CLC_HASHAGGREGATION_H
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "geo/Pair.h"
+#include "mem/ManagedAllocData.h"
+#include "set/ParallelSort.h"
+
+#include "ParallelTiles.h"
+
+constexpr SizeT HASH_AGGREGATION_CHUNK_SIZE = 1 << 20;
+constexpr SizeT HASH_AGGREGATION_MIN_CAPACITY = 256;
+constexpr SizeT HASH_AGGREGATION_MIN_VALUE_RANGE = 1 << 16;
+
+// valueRangeCardinality is undefined for values of an unknown or uncountable range, such as floats
+inline bool IsWideValueRange(SizeT valueRangeCardinality)
+{
+	return !IsDefined(valueRangeCardinality) || valueRangeCardinality > HASH_AGGREGATION_MIN_VALUE_RANGE;
+}
+
+// finalizer of MurmurHash3; spreads the bits of radix keys of nearby values over the whole table
+inline UInt64 hash_aggregation_mix(UInt64 h)
+{
+	h ^= h >> 33;
+	h *= 0xff51afd7ed558ccdULL;
+	h ^= h >> 33;
+	h *= 0xc4ceb9a53ca4fe85ULL;
+	h ^= h >> 33;
+	return h;
+}
+
+// *****************************************************************************
+//	hash_aggregation_key
+// *****************************************************************************
+
+template <typename K> struct hash_aggregation_key {}; // specialized for the supported key types
+
+template <typename V>
+	requires parallel_sort::has_radix_key_v<V>
+struct hash_aggregation_key<V>
+{
+	static UInt64 Hash(V v) { return hash_aggregation_mix(parallel_sort::radix_key(v)); }
+	static bool Equal(V a, V b) { return parallel_sort::radix_key(a) == parallel_sort::radix_key(b); } // all NaNs are equal, -0.0 equals +0.0
+
+	template <typename Entry, typename Executor>
+	static void Sort(Entry* data, Entry* buffer, SizeT n, const Executor& exec)
+	{
+		parallel_sort::radix_sort(data, buffer, n, [](const Entry& e) { return parallel_sort::radix_key(e.first); }, exec);
+	}
+};
+
+template <typename V>
+	requires parallel_sort::has_radix_key_v<V>
+struct hash_aggregation_key<Pair<SizeT, V>>
+{
+	static UInt64 Hash(const Pair<SizeT, V>& pv) { return hash_aggregation_mix(pv.first * 0x9E3779B97F4A7C15ULL ^ UInt64(parallel_sort::radix_key(pv.second))); }
+	static bool Equal(const Pair<SizeT, V>& a, const Pair<SizeT, V>& b) { return a.first == b.first && parallel_sort::radix_key(a.second) == parallel_sort::radix_key(b.second); }
+
+	// stable LSD sort: first on the value, then on the partition
+	template <typename Entry, typename Executor>
+	static void Sort(Entry* data, Entry* buffer, SizeT n, const Executor& exec)
+	{
+		parallel_sort::radix_sort(data, buffer, n, [](const Entry& e) { return parallel_sort::radix_key(e.first.second); }, exec);
+		parallel_sort::radix_sort(data, buffer, n, [](const Entry& e) { return SizeT(e.first.first); }, exec);
+	}
+};
+
+template <typename K> constexpr bool has_hash_aggregation_key_v = requires(const K& key) { hash_aggregation_key<K>::Hash(key); };
+
+// *****************************************************************************
+//	hash_aggregation_table
+// *****************************************************************************
+
+template <typename K, typename A>
+struct hash_aggregation_table
+{
+	using key_traits = hash_aggregation_key<K>;
+	using entry_type = std::pair<K, A>;
+
+	// returns the accumulator of key, which is value-initialized when key is new
+	A& operator [](const K& key)
+	{
+		if (2 * (m_Size + 1) > m_Tags.size())
+			Grow();
+
+		UInt64 hash = key_traits::Hash(key);
+		UInt32 tag = Tag(hash);
+		SizeT mask = m_Tags.size() - 1;
+		for (SizeT i = hash & mask; ; i = (i + 1) & mask)
+		{
+			if (!m_Tags[i])
+			{
+				m_Tags[i] = tag;
+				m_Entries[i] = entry_type(key, A());
+				++m_Size;
+				return m_Entries[i].second;
+			}
+			if (m_Tags[i] == tag && key_traits::Equal(m_Entries[i].first, key))
+				return m_Entries[i].second;
+		}
+	}
+
+	SizeT size() const { return m_Size; }
+
+	template <typename Func>
+	void ForEach(Func&& func) const
+	{
+		for (SizeT i = 0, n = m_Tags.size(); i != n; ++i)
+			if (m_Tags[i])
+				func(m_Entries[i]);
+	}
+
+	void clear()
+	{
+		m_Tags = {};
+		m_Entries = {};
+		m_Size = 0;
+	}
+
+private:
+	// the high bits of the hash, which are not used for addressing; never 0, which marks an empty slot
+	static UInt32 Tag(UInt64 hash) { return UInt32(hash >> 32) | 1; }
+
+	void Grow()
+	{
+		SizeT newCapacity = std::max<SizeT>(HASH_AGGREGATION_MIN_CAPACITY, 2 * m_Tags.size());
+		auto oldTags    = std::exchange(m_Tags,    std::vector<UInt32>(newCapacity, 0));
+		auto oldEntries = std::exchange(m_Entries, std::vector<entry_type>(newCapacity));
+
+		SizeT mask = m_Tags.size() - 1;
+		for (SizeT j = 0, n = oldTags.size(); j != n; ++j)
+		{
+			if (!oldTags[j])
+				continue;
+			UInt64 hash = key_traits::Hash(oldEntries[j].first);
+			SizeT i = hash & mask;
+			while (m_Tags[i])
+				i = (i + 1) & mask;
+			m_Tags[i] = oldTags[j];
+			m_Entries[i] = std::move(oldEntries[j]);
+		}
+	}
+
+	std::vector<UInt32>     m_Tags;
+	std::vector<entry_type> m_Entries;
+	SizeT                   m_Size = 0;
+};
+
+// *****************************************************************************
+//	HashAggregate
+// *****************************************************************************
+
+// provided to the addTile callback of HashAggregate to add the elements of one tile
+template <typename K, typename A>
+struct hash_aggregation_tile_adder
+{
+	using table_type = hash_aggregation_table<K, A>;
+
+	// calls addRange(first, last, table) for ranges that together cover [0, n), possibly concurrently for different tables
+	template <typename AddRange>
+	void AddRanges(SizeT n, AddRange&& addRange)
+	{
+		if (n <= HASH_AGGREGATION_CHUNK_SIZE)
+		{
+			addRange(SizeT(0), n, m_Tables->front());
+			return;
+		}
+		SizeT nrChunks = (n + HASH_AGGREGATION_CHUNK_SIZE - 1) / HASH_AGGREGATION_CHUNK_SIZE;
+		SizeT firstChunkTable = m_Tables->size();
+		m_Tables->resize(firstChunkTable + nrChunks);
+		auto chunkTables = m_Tables->begin() + firstChunkTable;
+		m_Exec(nrChunks, [&addRange, chunkTables, n](SizeT c)
+			{
+				SizeT first = c * HASH_AGGREGATION_CHUNK_SIZE;
+				addRange(first, std::min(first + HASH_AGGREGATION_CHUNK_SIZE, n), chunkTables[c]);
+			}
+		);
+	}
+
+	std::vector<table_type>* m_Tables;
+	tile_task_executor       m_Exec;
+};
+
+// aggregates the elements of nrTiles tiles; addTile(t, tileAdder) must call tileAdder.AddRanges once for the elements of tile t.
+// Accumulators of equal keys in different tables are combined by mergeAcc(A& acc, const A& other).
+// Returns the (key, accumulator) pairs ordered by key, with null first.
+template <typename K, typename A, typename AddTile, typename MergeAcc>
+auto HashAggregate(tile_id nrTiles, AddTile&& addTile, MergeAcc&& mergeAcc) -> my_vector<std::pair<K, A>>
+{
+	using table_type = hash_aggregation_table<K, A>;
+	using entry_type = std::pair<K, A>;
+	using key_traits = hash_aggregation_key<K>;
+
+	if (!nrTiles)
+		return {};
+
+	tile_task_executor exec;
+	SizeT nrWorkers = std::min<SizeT>(exec.nrThreads, nrTiles);
+	std::vector<std::vector<table_type>> workerTables(nrWorkers);
+
+	// each worker adds a contiguous range of tiles, such that the order of the tables doesn't depend on the scheduling
+	exec(nrWorkers, [&](SizeT w)
+		{
+			auto& tables = workerTables[w];
+			tables.resize(1);
+			hash_aggregation_tile_adder<K, A> tileAdder{ &tables, exec };
+			for (tile_id t = w * nrTiles / nrWorkers, te = (w + 1) * nrTiles / nrWorkers; t != te; ++t)
+				addTile(t, tileAdder);
+		}
+	);
+
+	std::vector<table_type*> tables;
+	std::vector<SizeT> offsets(1, 0);
+	for (auto& wt : workerTables)
+		for (auto& table : wt)
+			if (table.size())
+			{
+				tables.emplace_back(&table);
+				offsets.emplace_back(offsets.back() + table.size());
+			}
+	SizeT n = offsets.back();
+	if (!n)
+		return {};
+
+	auto entries = std::make_unique<entry_type[]>(n);
+	exec(tables.size(), [&](SizeT i)
+		{
+			auto dst = entries.get() + offsets[i];
+			tables[i]->ForEach([&dst](const entry_type& e) { *dst++ = e; });
+			tables[i]->clear();
+		}
+	);
+	workerTables = {};
+	{
+		auto buffer = std::make_unique<entry_type[]>(n);
+		key_traits::Sort(entries.get(), buffer.get(), n, exec);
+	}
+
+	SizeT nrKeys = 1;
+	for (SizeT i = 1; i != n; ++i)
+		if (!key_traits::Equal(entries[i - 1].first, entries[i].first))
+			++nrKeys;
+
+	my_vector<entry_type> result;
+	result.reserve(nrKeys MG_DEBUG_ALLOCATOR_SRC("HashAggregate"));
+	result.emplace_back(MG_DEBUG_ALLOCATOR_FIRST("HashAggregate") entries[0]);
+	for (SizeT i = 1; i != n; ++i)
+	{
+		if (key_traits::Equal(result.back().first, entries[i].first))
+			mergeAcc(result.back().second, entries[i].second);
+		else
+			result.emplace_back(MG_DEBUG_ALLOCATOR_FIRST("HashAggregate") entries[i]);
+	}
+	assert(result.size() == nrKeys);
+	return result;
+}
+
+#endif // !defined(__CLC_HASHAGGREGATION_H)
@@ -11,6 +11,7 @@
 
 #include "AbstrUnit.h"
 #include "DataItemClass.h"
+#include "ElementwiseFusion.h"
 #include "ParallelTiles.h"
 #include "TileFunctorImpl.h"
 #include "UnitCreators.h"
@@ -118,11 +119,32 @@ struct TernaryAttrOper : AbstrTernaryAttrOper
 	using Arg3Type = DataArray<Arg3ValueType>;
 	using ResultType = DataArray<ResultValueType>;
 
+	static constexpr bool is_fusable = is_separable_v<ResultValueType> && is_separable_v<Arg1ValueType> && is_separable_v<Arg2ValueType> && is_separable_v<Arg3ValueType>;
+
 public:
 	TernaryAttrOper(AbstrOperGroup* gr, UnitCreatorPtr ucp, ValueComposition vc, bool needsUndefInfo)
 		: AbstrTernaryAttrOper(gr, ResultType::GetStaticClass(), Arg1Type::GetStaticClass(), Arg2Type::GetStaticClass(), Arg3Type::GetStaticClass(), ucp, vc, needsUndefInfo)
 	{}
 
+	// return true if CalcTile calculates each element only from the elements at the same position, which allows fusion, see ElementwiseFusion.h
+	virtual bool IsElementwise() const { return false; }
+
+	auto CreateBlockEvaluator(const Arg1Type* arg1, const Arg2Type* arg2, const Arg3Type* arg3
+		,	const elementwise_tile_source<Arg1ValueType>* src1, const elementwise_tile_source<Arg2ValueType>* src2, const elementwise_tile_source<Arg3ValueType>* src3
+		,	ArgFlags af, tile_id t MG_DEBUG_ALLOCATOR_SRC(SharedStr srcStr)) const -> block_evaluator_ptr<ResultValueType>
+		requires is_fusable
+	{
+		return make_elementwise_evaluator<ResultValueType>(
+			[this, af MG_DEBUG_ALLOCATOR_SRC_PARAM](sequence_traits<ResultValueType>::seq_t resData, sequence_traits<Arg1ValueType>::cseq_t arg1Data, sequence_traits<Arg2ValueType>::cseq_t arg2Data, sequence_traits<Arg3ValueType>::cseq_t arg3Data)
+			{
+				this->CalcTile(resData, arg1Data, arg2Data, arg3Data, af MG_DEBUG_ALLOCATOR_SRC(srcStr.c_str()));
+			}
+		,	fused_arg<Arg1ValueType>(arg1, src1, t, af & AF1_ISPARAM)
+		,	fused_arg<Arg2ValueType>(arg2, src2, t, af & AF2_ISPARAM)
+		,	fused_arg<Arg3ValueType>(arg3, src3, t, af & AF3_ISPARAM)
+		);
+	}
+
 	auto CreateFutureTileFunctor(SharedPtr<AbstrDataItem> resultAdi, bool lazy, const AbstrUnit* valuesUnitA, const AbstrDataItem* arg1A, const AbstrDataItem* arg2A, const AbstrDataItem* arg3A, ArgFlags af MG_DEBUG_ALLOCATOR_SRC(SharedStr srcStr)) const -> SharedPtr<const AbstrDataObject> override
 	{
 		auto rangedArg = (af & AF1_ISPARAM) ? (af & AF2_ISPARAM) ? arg3A : arg2A : arg1A;
@@ -133,6 +155,21 @@ public:
 		auto arg2 = MakeSharedFromBorrowedObjectPtr(const_array_cast<Arg2ValueType>(arg2A)); assert(arg2);
 		auto arg3 = MakeSharedFromBorrowedObjectPtr(const_array_cast<Arg3ValueType>(arg3A)); assert(arg3);
 
+		if constexpr (is_fusable)
+		{
+			if (IsElementwise())
+			{
+				auto src1 = GetFusableSource<Arg1ValueType>(arg1A, af & AF1_ISPARAM);
+				auto src2 = GetFusableSource<Arg2ValueType>(arg2A, af & AF2_ISPARAM);
+				auto src3 = GetFusableSource<Arg3ValueType>(arg3A, af & AF3_ISPARAM);
+				block_evaluator_factory<ResultValueType> evaluatorFactory = [this, arg1, arg2, arg3, src1, src2, src3, af MG_DEBUG_ALLOCATOR_SRC_PARAM](tile_id t)
+					{
+						return this->CreateBlockEvaluator(arg1.get(), arg2.get(), arg3.get(), src1, src2, src3, af, t MG_DEBUG_ALLOCATOR_SRC_PARAM);
+					};
+				return make_unique_ElementwiseTileFunctor<ResultValueType>(resultAdi, lazy, tileRangeData.get(), get_range_ptr_of_valuesunit(valuesUnit), std::move(evaluatorFactory) MG_DEBUG_ALLOCATOR_SRC_PARAM).release();
+			}
+		}
+
 		using prepare_data = std::tuple<std::shared_ptr<typename Arg1Type::future_tile>, std::shared_ptr<typename Arg2Type::future_tile>, std::shared_ptr<typename Arg3Type::future_tile>>;
 		auto futureTileFunctor = make_unique_FutureTileFunctor<ResultValueType, prepare_data, false>(resultAdi, lazy, tileRangeData.get(), get_range_ptr_of_valuesunit(valuesUnit)
 			, [arg1, arg2, arg3, af](tile_id t) { return prepare_data{ arg1->GetFutureTile(af & AF1_ISPARAM ? 0 : t), arg2->GetFutureTile(af & AF2_ISPARAM ? 0 : t), arg3->GetFutureTile(af & AF3_ISPARAM ? 0 : t) }; }
@@ -148,6 +185,20 @@ public:
 
 	void Calculate(AbstrDataObject* res, const AbstrDataItem* arg1A, const AbstrDataItem* arg2A, const AbstrDataItem* arg3A, ArgFlags af, tile_id t) const override
 	{
+		if constexpr (is_fusable)
+		{
+			if (IsElementwise())
+			{
+				auto resData = mutable_array_cast<ResultValueType>(res)->GetWritableTile(t);
+				auto evaluator = CreateBlockEvaluator(const_array_cast<Arg1ValueType>(arg1A), const_array_cast<Arg2ValueType>(arg2A), const_array_cast<Arg3ValueType>(arg3A)
+					, GetFusableSource<Arg1ValueType>(arg1A, af & AF1_ISPARAM), GetFusableSource<Arg2ValueType>(arg2A, af & AF2_ISPARAM), GetFusableSource<Arg3ValueType>(arg3A, af & AF3_ISPARAM)
+					, af, t MG_DEBUG_ALLOCATOR_SRC(res->md_SrcStr)
+				);
+				evaluator->Eval(0, resData.get_view());
+				return;
+			}
+		}
+
 		auto arg1Data = const_array_cast<Arg1ValueType>(arg1A)->GetTile(af & AF1_ISPARAM ? 0 : t);
 		auto arg2Data = const_array_cast<Arg2ValueType>(arg2A)->GetTile(af & AF2_ISPARAM ? 0 : t);
 		auto arg3Data = const_array_cast<Arg3ValueType>(arg3A)->GetTile(af & AF3_ISPARAM ? 0 : t);
@@ -14,6 +14,7 @@
 #include "AbstrUnit.h"
 
 #include "AttrUniStruct.h"
+#include "ElementwiseFusion.h"
 #include "ParallelTiles.h"
 #include "TileFunctorImpl.h"
 #include "UnitProcessor.h"
@@ -105,11 +106,28 @@ struct UnaryAttrOperator : AbstrUnaryAttrOperator
 	using Arg1Type = DataArray<Arg1ValueType>;
 	using ResultType = DataArray<ResultValueType>;
 
+	static constexpr bool is_fusable = is_separable_v<ResultValueType> && is_separable_v<Arg1ValueType>;
+
 public:
 	UnaryAttrOperator(AbstrOperGroup* gr, ArgFlags possibleArgFlags, UnitCreatorPtr ucp, ValueComposition vc)
 		: AbstrUnaryAttrOperator(gr, ResultType::GetStaticClass(), Arg1Type::GetStaticClass(), possibleArgFlags, ucp, vc)
 	{}
 
+	// return true if CalcTile calculates each element only from the elements at the same position, which allows fusion, see ElementwiseFusion.h
+	virtual bool IsElementwise() const { return false; }
+
+	auto CreateBlockEvaluator(const Arg1Type* arg1, const elementwise_tile_source<Arg1ValueType>* src1, const AbstrUnit* arg1VU, ArgFlags af, tile_id t MG_DEBUG_ALLOCATOR_SRC(SharedStr srcStr)) const -> block_evaluator_ptr<ResultValueType>
+		requires is_fusable
+	{
+		return make_elementwise_evaluator<ResultValueType>(
+			[this, arg1VU, af MG_DEBUG_ALLOCATOR_SRC_PARAM](sequence_traits<ResultValueType>::seq_t resData, sequence_traits<Arg1ValueType>::cseq_t arg1Data)
+			{
+				this->CalcTile(resData, arg1Data, arg1VU, af MG_DEBUG_ALLOCATOR_SRC(srcStr.c_str()));
+			}
+		,	fused_arg<Arg1ValueType>(arg1, src1, t, false)
+		);
+	}
+
 	auto CreateFutureTileFunctor(SharedPtr<AbstrDataItem> resultAdi, bool lazy, const AbstrUnit* valuesUnitA, const AbstrDataItem* arg1A, ArgFlags af MG_DEBUG_ALLOCATOR_SRC(SharedStr srcStr)) const -> SharedPtr<const AbstrDataObject> override
 	{
 		auto tileRangeData = AsUnit(arg1A->GetAbstrDomainUnit()->GetCurrRangeItem())->GetTiledRangeData();
@@ -118,6 +136,19 @@ public:
 		auto arg1 = MakeSharedFromBorrowedObjectPtr(const_array_cast<Arg1ValueType>(arg1A)); assert(arg1);
 		auto arg1VU = MakeSharedFromBorrowedObjectPtr(arg1A->GetAbstrValuesUnit());
 
+		if constexpr (is_fusable)
+		{
+			if (IsElementwise())
+			{
+				auto src1 = GetFusableSource<Arg1ValueType>(arg1A, false);
+				block_evaluator_factory<ResultValueType> evaluatorFactory = [this, arg1, src1, arg1VU, af MG_DEBUG_ALLOCATOR_SRC_PARAM](tile_id t)
+					{
+						return this->CreateBlockEvaluator(arg1.get(), src1, arg1VU.get(), af, t MG_DEBUG_ALLOCATOR_SRC_PARAM);
+					};
+				return make_unique_ElementwiseTileFunctor<ResultValueType>(resultAdi, lazy, tileRangeData.get(), get_range_ptr_of_valuesunit(valuesUnit), std::move(evaluatorFactory) MG_DEBUG_ALLOCATOR_SRC_PARAM).release();
+			}
+		}
+
 		using prepare_data = std::shared_ptr<typename Arg1Type::future_tile>;
 		auto futureTileFunctor = make_unique_FutureTileFunctor<ResultValueType, prepare_data, false>(resultAdi.get(), lazy, tileRangeData.get(), get_range_ptr_of_valuesunit(valuesUnit)
 			, [arg1, af](tile_id t) { return arg1->GetFutureTile(t); }
@@ -133,6 +164,17 @@ public:
 
 	void Calculate(AbstrDataObject* res, const AbstrDataItem* arg1A, ArgFlags af, tile_id t) const override
 	{
+		if constexpr (is_fusable)
+		{
+			if (IsElementwise())
+			{
+				auto resData = mutable_array_cast<ResultValueType>(res)->GetWritableTile(t);
+				auto evaluator = CreateBlockEvaluator(const_array_cast<Arg1ValueType>(arg1A), GetFusableSource<Arg1ValueType>(arg1A, false), arg1A->GetAbstrValuesUnit(), af, t MG_DEBUG_ALLOCATOR_SRC(res->md_SrcStr));
+				evaluator->Eval(0, resData.get_view());
+				return;
+			}
+		}
+
 		auto arg1Data = const_array_cast<Arg1ValueType>(arg1A)->GetTile(t);
 		auto resData = mutable_array_cast<ResultValueType>(res)->GetWritableTile(t);
 
@@ -154,6 +196,8 @@ struct UnaryAttrAssignOperator : UnaryAttrOperator<typename TUniAssign::assignee
 			)
 	{}
 
+	bool IsElementwise() const override { return true; }
+
 	void CalcTile(sequence_traits<typename TUniAssign::assignee_type>::seq_t resData, sequence_traits<typename TUniAssign::arg1_type>::cseq_t arg1Data, const AbstrUnit* argVU, ArgFlags af MG_DEBUG_ALLOCATOR_SRC_ARG) const override
 	{
 		assert(arg1Data.size() == resData.size());
@@ -172,6 +216,8 @@ struct UnaryAttrFuncOperator: UnaryAttrOperator<typename TUniOper::res_type, typ
 			)
 	{}
 
+	bool IsElementwise() const override { return true; }
+
 	void CalcTile(sequence_traits<typename TUniOper::res_type>::seq_t resData, sequence_traits<typename TUniOper::arg1_type>::cseq_t arg1Data, const AbstrUnit* argVU, ArgFlags af MG_DEBUG_ALLOCATOR_SRC_ARG) const override
 	{
 		assert(arg1Data.size() == resData.size());
@@ -192,6 +238,8 @@ struct UnaryAttrSpecialFuncOperator: UnaryAttrOperator<typename TUniOper::res_ty
 			)
 	{}
 
+	bool IsElementwise() const override { return true; }
+
 	void CalcTile(sequence_traits<typename TUniOper::res_type>::seq_t resData, sequence_traits<typename TUniOper::arg1_type>::cseq_t arg1Data, const AbstrUnit* argVU, ArgFlags af MG_DEBUG_ALLOCATOR_SRC_ARG) const override
 	{
 		assert(arg1Data.size() == resData.size());
@@ -215,6 +263,8 @@ struct UnaryAttr_XY_FuncOperator : UnaryAttrOperator<ResCoordType, PointType>
 	{
 	}
 
+	bool IsElementwise() const override { return true; }
+
 	void CalcTile(sequence_traits<ResCoordType>::seq_t resData, sequence_traits<PointType>::cseq_t arg1Data, const AbstrUnit* argVU, ArgFlags af MG_DEBUG_ALLOCATOR_SRC_ARG) const override
 	{
 		assert(arg1Data.size() == resData.size());
@@ -11,7 +11,6 @@
 #define __CLC_OPERRELUNI_H
 
 #include <algorithm>
-#include <execution>
 #include <map>
 #include <set>
 
@@ -19,8 +18,11 @@
 #include "set/VectorFunc.h"
 #include "geo/StringBounds.h"
 #include "set/IndexCompare.h"
+#include "set/ParallelSort.h"
 #include "set/VectorFunc.h"
 
+#include "ParallelTiles.h"
+
 #include "makeCululative.h"
 #include "pcount.h"
 #include "prototypes.h"
@@ -172,9 +174,6 @@ InIt indexed_upperbound(InIt first, InIt last, vIt beginData, const V& value)
 //                         UNARY RELATIONAL FUNCTIONS
 // *****************************************************************************
 
-template <typename V>
-using execution_policy = std::conditional_t < sizeof(V) < 4, std::execution::sequenced_policy, std::execution::parallel_policy >;
-
 template<typename IndexContainer, typename ConstDataIter>
 void make_index_skip_null(IndexContainer& resData, SizeT n, ConstDataIter unsortedDataBegin)
 {
@@ -189,7 +188,7 @@ void make_index_skip_null(IndexContainer& resData, SizeT n, ConstDataIter unsort
 		if (IsDefined(unsortedDataBegin[i]))
 			resData.emplace_back(i);
 
-	std::stable_sort(execution_policy<IndexValue>(), resData.begin(), resData.end(), NonnullIndexCompareOper<ConstDataIter, IndexValue>(unsortedDataBegin));
+	parallel_sort::index_sort(resData.begin(), resData.end(), unsortedDataBegin, NonnullIndexCompareOper<ConstDataIter, IndexValue>(unsortedDataBegin), tile_task_executor());
 }
 
 template<typename IndexContainer, typename ConstDataIter>
@@ -204,7 +203,7 @@ void make_index_non_null_values(IndexContainer& resData, SizeT n, ConstDataIter
 		resData.emplace_back(i);
 	}
 
-	std::stable_sort(execution_policy<IndexValue>(), resData.begin(), resData.end(), NonnullIndexCompareOper<ConstDataIter, IndexValue>(unsortedDataBegin));
+	parallel_sort::index_sort(resData.begin(), resData.end(), unsortedDataBegin, NonnullIndexCompareOper<ConstDataIter, IndexValue>(unsortedDataBegin), tile_task_executor());
 }
 
 template<typename IndexContainer, typename ConstDataIter>
@@ -216,7 +215,7 @@ void make_index_all_values(IndexContainer& resData, SizeT n, ConstDataIter unsor
 	for (SizeT i = 0; i != n; ++i)
 		resData.emplace_back(i);
 
-	std::stable_sort(execution_policy<IndexValue>(), resData.begin(), resData.end(), IndexCompareOper<ConstDataIter, IndexValue>(unsortedDataBegin));
+	parallel_sort::index_sort(resData.begin(), resData.end(), unsortedDataBegin, IndexCompareOper<ConstDataIter, IndexValue>(unsortedDataBegin), tile_task_executor());
 }
 
 template<typename IndexIter, typename ConstDataIter>
@@ -224,7 +223,7 @@ void make_index_in_existing_span(IndexIter resDataBegin, IndexIter resDataEnd, C
 {
 	using IndexValue = typename std::iterator_traits<IndexIter>::value_type ;
 	span_fill_sequential_index_numbers(resDataBegin, resDataEnd);
-	std::stable_sort(execution_policy<IndexValue>(), resDataBegin, resDataEnd, IndexCompareOper<ConstDataIter, IndexValue>(unsortedDataBegin));
+	parallel_sort::index_sort(resDataBegin, resDataEnd, unsortedDataBegin, IndexCompareOper<ConstDataIter, IndexValue>(unsortedDataBegin), tile_task_executor());
 }
 
 template<typename IndexIter, bit_size_t N, typename CB>
@@ -287,27 +286,51 @@ void make_subindex(
 	ConstOrderIter prevOrderEnd = prevOrderBegin + size;
 	fast_copy(prevIndexBegin, prevIndexEnd, resDataBegin);
 
+	// collect the ranges of equal prevOrder, which are ordered independently
+	std::vector<std::pair<SizeT, SizeT>> ranges;
 	ConstOrderIter prevOrderRangeBegin = prevOrderBegin;
 	while (true)
 	{
 		prevOrderRangeBegin = std::adjacent_find(prevOrderRangeBegin, prevOrderEnd); // skip ordering elements of singletons
 		if (prevOrderRangeBegin == prevOrderEnd)
-			return;
+			break;
 		assert(prevOrderRangeBegin+1 != prevOrderEnd); // 
 		typename std::iterator_traits<ConstOrderIter>::value_type v = *prevOrderRangeBegin;
 		assert(v == prevOrderRangeBegin[1]); // we found an adjacent pair
 		ConstOrderIter prevOrderRangeEnd = prevOrderRangeBegin+2;
 		while (prevOrderRangeEnd != prevOrderEnd && *prevOrderRangeEnd == v)
 			++prevOrderRangeEnd;
-		std::stable_sort(
-			resDataBegin + SizeT(prevOrderRangeBegin - prevOrderBegin), 
-			resDataBegin + SizeT(prevOrderRangeEnd   - prevOrderBegin), 
-			IndexCompareOper<ConstDataIter, IndexValue>(
-				unsortedDataBegin
-			)
-		);
+		ranges.emplace_back(prevOrderRangeBegin - prevOrderBegin, prevOrderRangeEnd - prevOrderBegin);
 		prevOrderRangeBegin = prevOrderRangeEnd;
 	}
+
+	// large ranges are sorted one after another with all threads; batches of consecutive small ranges are sorted concurrently
+	tile_task_executor exec;
+	IndexCompareOper<ConstDataIter, IndexValue> comp(unsortedDataBegin);
+	std::vector<std::pair<SizeT, SizeT>> batches; // of ranges
+	SizeT batchSize = 0;
+	for (SizeT r = 0; r != ranges.size(); ++r)
+	{
+		SizeT rangeSize = ranges[r].second - ranges[r].first;
+		if (rangeSize >= parallel_sort::MIN_CHUNK_SIZE)
+		{
+			parallel_sort::index_sort(resDataBegin + ranges[r].first, resDataBegin + ranges[r].second, unsortedDataBegin, comp, exec);
+			batchSize = 0;
+			continue;
+		}
+		if (!batchSize)
+			batches.emplace_back(r, r);
+		batches.back().second = r + 1;
+		batchSize += rangeSize;
+		if (batchSize >= parallel_sort::MIN_CHUNK_SIZE)
+			batchSize = 0;
+	}
+	exec(batches.size(), [&](SizeT b)
+		{
+			for (SizeT r = batches[b].first; r != batches[b].second; ++r)
+				std::stable_sort(resDataBegin + ranges[r].first, resDataBegin + ranges[r].second, comp);
+		}
+	);
 }
 
 template<typename IndexContainer, typename ConstIter2>
@@ -24,6 +24,7 @@
 
 #include "AggrFuncNum.h"
 #include "AttrBinStruct.h"
+#include "HashAggregation.h"
 #include "IndexGetterCreator.h"
 #include "TileChannel.h"
 #include "ValuesTableTypes.h"
@@ -58,6 +59,29 @@ auto GetValuesRange(const DataArray<V>* tileFunctor) -> typename Unit<V>::range_
 	return vrd->GetRange();
 }
 
+// the cardinality of a values range, or undefined when it isn't countable or known; see IsWideValueRange
+template <typename V, typename Range>
+SizeT GetValuesRangeCardinality(const Range& valuesRange)
+{
+	if constexpr (is_integral_v<scalar_of_t<V>>)
+	{
+		if (!valuesRange.empty())
+			return Cardinality(valuesRange);
+	}
+	return UNDEFINED_VALUE(SizeT);
+}
+
+template <typename V>
+SizeT GetValuesRangeCardinality(const DataArray<V>* tileFunctor)
+{
+	if constexpr (is_integral_v<scalar_of_t<V>>)
+	{
+		if (auto vrd = tileFunctor->GetValueRangeData())
+			return GetValuesRangeCardinality<V>(vrd->GetRange());
+	}
+	return UNDEFINED_VALUE(SizeT);
+}
+
 //----------------------------------------------------------------------
 
 
@@ -403,6 +427,64 @@ auto GetPartitionedWallCounts(future_tile_array<V>& values_fta, const AbstrDataI
 	return MergeToLeft(firstHalf->get(), secondHalf);
 }
 
+// alternative for GetWeededWallCounts without weeding and GetPartitionedWallCounts for values with a hash_aggregation_key; see HashAggregation.h
+template <ordered_value_type V, count_type C>
+auto GetHashedWallCounts(future_tile_array<V>& values_fta) -> ValueCountPairContainerT<V, C>
+{
+	return HashAggregate<V, C>(values_fta.size()
+	,	[&values_fta](tile_id t, auto& tileAdder)
+		{
+			auto tileData = values_fta[t]->GetTile(); values_fta[t] = nullptr;
+			tileAdder.AddRanges(tileData.size(), [&tileData](SizeT i, SizeT e, auto& table)
+				{
+					auto values = tileData.begin();
+					for (; i != e; ++i)
+					{
+						if constexpr (has_undefines_v<V>)
+						{
+							if (!IsDefined(values[i]))
+								continue;
+						}
+						SafeIncrementCounter(table[values[i]]);
+					}
+				}
+			);
+		}
+	,	[](C& acc, const C& other) { SafeAccumulate(acc, other); }
+	);
+}
+
+template <ordered_value_type V, count_type C>
+auto GetHashedPartitionedWallCounts(future_tile_array<V>& values_fta, const AbstrDataItem* indicesItem, abstr_future_tile_array& part_fta, bool valueMustBeDefined) -> PartionedValueCountPairContainerT<V, C>
+{
+	using partition_value_pair = Pair<SizeT, V>;
+	return HashAggregate<partition_value_pair, C>(values_fta.size()
+	,	[&values_fta, indicesItem, &part_fta, valueMustBeDefined](tile_id t, auto& tileAdder)
+		{
+			auto tileData = values_fta[t]->GetTile(); values_fta[t] = nullptr;
+			auto indexGetter = std::unique_ptr<IndexGetter>(IndexGetterCreator::Create(indicesItem, part_fta[t])); part_fta[t] = nullptr;
+			tileAdder.AddRanges(tileData.size(), [&tileData, &indexGetter, valueMustBeDefined](SizeT i, SizeT e, auto& table)
+				{
+					auto values = tileData.begin();
+					for (; i != e; ++i)
+					{
+						if constexpr (has_undefines_v<V>)
+						{
+							if (valueMustBeDefined && !IsDefined(values[i]))
+								continue;
+						}
+						SizeT part_i = indexGetter->Get(i);
+						if (!IsDefined(part_i))
+							continue;
+						SafeIncrementCounter(table[partition_value_pair(part_i, values[i])]);
+					}
+				}
+			);
+		}
+	,	[](C& acc, const C& other) { SafeAccumulate(acc, other); }
+	);
+}
+
 inline auto GetDomain(const AbstrDataItem* adi)  { return adi->GetAbstrDomainUnit(); }
 //auto GetDomain(Couple<const AbstrDataItem*> adis) { return adis.first->GetAbstrDomainUnit(); }
 
@@ -539,7 +621,15 @@ auto GetWeededCountsOfV(const DataArray<V>* valuesTF, bool noOutOfRangeValues,
 			}
 		}
 		auto values_fta = GetFutureTileArray(valuesTF);
-		auto vcxxx = GetWeededWallCounts<V, C>(values_fta, maxPairCount);
+		auto vcxxx = [valuesTF, &values_fta, maxPairCount]()
+			{
+				if constexpr (has_hash_aggregation_key_v<V>)
+				{
+					if (maxPairCount == SizeT(-1) && IsWideValueRange(GetValuesRangeCardinality<V>(valuesTF)))
+						return GetHashedWallCounts<V, C>(values_fta);
+				}
+				return GetWeededWallCounts<V, C>(values_fta, maxPairCount);
+			}();
 		if constexpr (std::is_same_v<R, V>)
 			return vcxxx;
 		else
@@ -26,6 +26,7 @@
 #include "OperAccUni.h"
 #include "OperAccBin.h"
 #include "OperRelUni.h"
+#include "HashAggregation.h"
 #include "ValuesTable.h"
 #include "IndexGetterCreator.h"
 
@@ -209,7 +210,15 @@ template<typename V, typename R, typename AggrFunc>
 void ModusTotBySet(const DataArray<V>* tileFunctor, typename sequence_traits<R>::container_type::reference resData, AggrFunc aggrFunc)
 {
 	auto values_fta = GetFutureTileArray(tileFunctor);
-	auto counters = GetWeededWallCounts<V, SizeT>(values_fta, SizeT(-1));
+	auto counters = [tileFunctor, &values_fta]()
+		{
+			if constexpr (has_hash_aggregation_key_v<V>)
+			{
+				if (IsWideValueRange(GetValuesRangeCardinality<V>(tileFunctor)))
+					return GetHashedWallCounts<V, SizeT>(values_fta);
+			}
+			return GetWeededWallCounts<V, SizeT>(values_fta, SizeT(-1));
+		}();
 
 	resData = aggrFunc(counters.begin(), counters.end()
 	,	[](auto i) { return i->second; }
@@ -279,16 +288,24 @@ void ModusTotDispatcher(const DataArray<V>* valuesTF, bool noOutOfRangeValues, t
 template<typename V, typename OIV, typename AggrFunc>
 void ModusPartBySet(const AbstrDataItem* indicesItem, abstr_future_tile_array part_fta
 	, future_tile_array<V> values_fta
-	, OIV resBegin, SizeT pCount, bool valueMustBeDefined, AggrFunc aggrFunc)  // countable dommain unit of result; P can be Void.
+	, OIV resBegin, SizeT pCount, SizeT valuesRangeCardinality, bool valueMustBeDefined, AggrFunc aggrFunc)  // countable dommain unit of result; P can be Void.
 {
 	assert(values_fta.size() == part_fta.size());
 
 	using value_type = std::pair<SizeT, V>;
 	auto tn = values_fta.size();
 
-	auto counters = GetPartitionedWallCounts<V, SizeT>(values_fta
-		, indicesItem, part_fta
-		, 0, tn, pCount, valueMustBeDefined);
+	auto counters = [&]()
+		{
+			if constexpr (has_hash_aggregation_key_v<V>)
+			{
+				if (IsWideValueRange(valuesRangeCardinality))
+					return GetHashedPartitionedWallCounts<V, SizeT>(values_fta, indicesItem, part_fta, valueMustBeDefined);
+			}
+			return GetPartitionedWallCounts<V, SizeT>(values_fta
+				, indicesItem, part_fta
+				, 0, tn, pCount, valueMustBeDefined);
+		}();
 
 	auto i = counters.begin(), e = counters.end();
 	auto ri = 0;
@@ -356,23 +373,32 @@ void ModusPartByTable(const AbstrDataItem* indicesItem, future_tile_array<V> val
 //											WeightedModusTot
 // *****************************************************************************
 
+template<typename V>
+auto GetHashedWeightedCounts(const DataArray<V>* valuesTF, const AbstrDataItem* weightItem)
+{
+	return HashAggregate<V, Float64>(valuesTF->GetTiledRangeData()->GetNrTiles()
+	,	[valuesTF, weightItem](tile_id t, auto& tileAdder)
+		{
+			auto valuesLock = valuesTF->GetLockedDataRead(t);
+			auto weightsGetter = std::unique_ptr<AbstrValueGetter<Float64>>( WeightGetterCreator::Create(weightItem, t) );
+			tileAdder.AddRanges(valuesLock.size(), [&valuesLock, &weightsGetter](SizeT i, SizeT e, auto& table)
+				{
+					auto values = valuesLock.begin();
+					for (; i != e; ++i)
+						if (IsDefined(values[i]))
+							table[values[i]] += weightsGetter->Get(i);
+				}
+			);
+		}
+	,	[](Float64& acc, Float64 other) { acc += other; }
+	);
+}
+
 // assume v >> n; time complexity: n*log(min(v, n))
 template<typename V>
 void WeightedModusTotBySet(const DataArray<V>* valuesTF, const AbstrDataItem* weightItem, typename sequence_traits<V>::container_type::reference resData)
 {
-	std::map<V, Float64> counters;
-
-	for (tile_id t =0, tn = valuesTF->GetTiledRangeData()->GetNrTiles(); t!=tn; ++t)
-	{
-		auto valuesLock  = valuesTF->GetLockedDataRead(t);
-		auto valuesIter  = valuesLock.begin(), valuesEnd   = valuesLock.end();
-		auto weightsGetter = std::unique_ptr<AbstrValueGetter<Float64>>( WeightGetterCreator::Create(weightItem, t) );
-
-		SizeT weightsIter = 0;
-		for (; valuesIter != valuesEnd; ++weightsIter, ++valuesIter)
-			if (IsDefined(*valuesIter))
-				counters[*valuesIter] += weightsGetter->Get(weightsIter);
-	}
+	auto counters = GetHashedWeightedCounts<V>(valuesTF, weightItem);
 
 
 	modusFunc<Float64, V> aggrFunc;
@@ -460,40 +486,48 @@ void WeightedModusTotDispatcher(const DataArray<V>* valuesTF, bool noOutOfRangeV
 //											WeightedModusPart
 // *****************************************************************************
 
+template<typename V>
+auto GetHashedPartitionedWeightedCounts(const DataArray<V>* valuesTF, const AbstrDataItem* weightItem, const AbstrDataItem* indicesItem, SizeT pCount)
+{
+	using partition_value_pair = Pair<SizeT, V>;
+	return HashAggregate<partition_value_pair, Float64>(valuesTF->GetTiledRangeData()->GetNrTiles()
+	,	[valuesTF, weightItem, indicesItem, pCount](tile_id t, auto& tileAdder)
+		{
+			auto valuesLock = valuesTF->GetLockedDataRead(t);
+			auto indexGetter = std::unique_ptr<IndexGetter>( IndexGetterCreator::Create(indicesItem, t) );
+			auto weightsGetter = std::unique_ptr<AbstrValueGetter<Float64>>( WeightGetterCreator::Create(weightItem, t) );
+			tileAdder.AddRanges(valuesLock.size(), [&valuesLock, &indexGetter, &weightsGetter, pCount](SizeT i, SizeT e, auto& table)
+				{
+					auto values = valuesLock.begin();
+					for (; i != e; ++i)
+						if (IsDefined(values[i]))
+						{
+							Float64 weight = weightsGetter->Get(i);
+							if (IsDefined(weight))
+							{
+								SizeT p = indexGetter->Get(i);
+								if (IsDefined(p))
+								{
+									assert(p < pCount);
+									table[partition_value_pair(p, values[i])] += weight;
+								}
+							}
+						}
+				}
+			);
+		}
+	,	[](Float64& acc, Float64 other) { acc += other; }
+	);
+}
+
 // assume v >> n; time complexity: n*log(min(v, n))
 template<typename V, typename OIV>
 void WeightedModusPartBySet(const DataArray<V>* valuesTF, const AbstrDataItem* weightItem, const AbstrDataItem* indicesItem,
 	OIV resBegin, 
 	SizeT pCount)  // countable dommain unit of result; P can be Void.
 {
-	typedef std::pair<SizeT, V> value_type;
-	std::map<value_type, Float64> wieghtAccumulators;
-
-	for (tile_id t=0, tn= valuesTF->GetTiledRangeData()->GetNrTiles(); t!=tn; ++t)
-	{
-		auto valuesLock  = valuesTF->GetLockedDataRead(t);
-		auto valuesIter  = valuesLock.begin(),
-			 valuesEnd   = valuesLock.end();
-
-		auto indexGetter = std::unique_ptr<IndexGetter>( IndexGetterCreator::Create(indicesItem, t) );
-		auto weightsGetter = std::unique_ptr<AbstrValueGetter<Float64>>( WeightGetterCreator::Create(weightItem, t) );
+	auto wieghtAccumulators = GetHashedPartitionedWeightedCounts<V>(valuesTF, weightItem, indicesItem, pCount);
 
-		SizeT i=0;
-		for (; valuesIter != valuesEnd; ++i, ++valuesIter)
-			if (IsDefined(*valuesIter))
-			{
-				Float64 weight = weightsGetter->Get(i);
-				if (IsDefined(weight))
-				{
-					SizeT p = indexGetter->Get(i);
-					if (IsDefined(p))
-					{
-						assert(p < pCount);
-						wieghtAccumulators[value_type(p, *valuesIter)] += weight;
-					}
-				}
-			}
-	}
 	modusFunc<SizeT, V> aggrFunc;
 	auto getCount = [](auto counterPtr) { return counterPtr->second; };
 	auto getValue = [](auto counterPtr) { return counterPtr->first.second; };
@@ -702,12 +736,10 @@ struct ModusPart : OperAccPartUniWithCFTA<V, typename AggrFunc::result_type>
 			// Countable values; go for Table if sensible
 			assert(IsNotUndef(pdi.resCount)); //consequence of the checks on indexRange
 
+			SizeT v = MAX_VALUE(SizeT);
 			if constexpr (is_integral_v<scalar_of_t<V>>)
 			{
-				SizeT v = MAX_VALUE(SizeT);
-				auto range = pdi.valuesRangeData->GetRange();
-				if (!range.empty())
-					v =  Cardinality(range);
+				v = GetValuesRangeCardinality<V>(pdi.valuesRangeData->GetRange());
 
 				if (IsDefined(v) && this->m_ValueMustBeDefined
 					//		&& (!resCount || v / map_node_type_size<V> <= n / resCount / sizeof(SizeT))
@@ -718,7 +750,7 @@ struct ModusPart : OperAccPartUniWithCFTA<V, typename AggrFunc::result_type>
 					return;
 				}
 			}
-			ModusPartBySet<V>(pdi.arg2A, std::move(pdi.part_fta), std::move(pdi.values_fta), resBegin, pdi.resCount, this->m_ValueMustBeDefined, m_AggrFunc);
+			ModusPartBySet<V>(pdi.arg2A, std::move(pdi.part_fta), std::move(pdi.values_fta), resBegin, pdi.resCount, v, this->m_ValueMustBeDefined, m_AggrFunc);
 		}
 	}
 
@@ -393,6 +393,8 @@ struct BinaryAttrFuncOper : BinaryAttrOper<typename BinOper::res_type, typename
 		: BinaryAttrOper<typename BinOper::res_type, typename BinOper::arg1_type, typename BinOper::arg2_type>(gr, BinOper::unit_creator, composition_of<typename BinOper::res_type>::value)
 	{}
 
+	bool IsElementwise() const override { return true; }
+
 	void CalcTile(sequence_traits<typename BinOper::res_type>::seq_t resData, sequence_traits<typename BinOper::arg1_type>::cseq_t arg1Data, sequence_traits<typename BinOper::arg2_type>::cseq_t arg2Data, ArgFlags af MG_DEBUG_ALLOCATOR_SRC_ARG) const override
 	{
 		do_binary_func(resData, arg1Data, arg2Data, BinOper(), af & AF1_ISPARAM, af & AF2_ISPARAM, af & AF1_HASUNDEFINED, af & AF2_HASUNDEFINED);
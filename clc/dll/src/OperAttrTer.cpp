@@ -127,6 +127,8 @@ struct MonalTernaryAttrOperator : TernaryAttrOper<typename AttrOper::assignee_ty
 			)
 	{}
 
+	bool IsElementwise() const override { return true; }
+
 	// Override TernaryAttrOper
 	void CalcTile(sequence_traits<typename AttrOper::assignee_type>::seq_t resData
 		,	sequence_traits<typename AttrOper::arg1_type>::cseq_t arg1Data
@@ -148,6 +150,8 @@ struct DualTernaryAttrOperator : TernaryAttrOper<typename AttrOper::assignee_typ
 			)
 	{}
 
+	bool IsElementwise() const override { return true; }
+
 	// Override TernaryAttrOper
 	void CalcTile(sequence_traits<typename AttrOper::assignee_type>::seq_t resData
 		,	sequence_traits<typename AttrOper::arg1_type>::cseq_t arg1Data
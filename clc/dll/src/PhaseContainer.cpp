@@ -14,6 +14,7 @@
 
 #include "act/ActorVisitor.h"
 #include "act/SupplierVisitFlag.h"
+#include "utl/scoped_exit.h"
 
 #include "CopyTreeContext.h"
 #include "LispTreeType.h"
@@ -142,7 +143,8 @@ struct PhaseContainerOperator : BinaryOperator
 
 		auto resultPhaseNumber = resultHolder.m_PhaseNumber;
 		auto resultRoot = resultHolder.GetNew();
-		auto lockFence = tmp_swapper<phase_number>(s_CurrBlockedPhaseNumber, resultPhaseNumber);
+		auto prevBlockedPhaseNumber = s_CurrBlockedPhaseNumber.exchange(resultPhaseNumber); // atomic, as worker threads test the fence without lock
+		auto unlockFence = make_scoped_exit([prevBlockedPhaseNumber]() { s_CurrBlockedPhaseNumber = prevBlockedPhaseNumber; });
 		auto lockCurrPhaseContainer = tmp_swapper(s_CurrPhaseContainer, resultRoot);
 
 		if (!resultRoot->m_ReadAssets.has_value())
@@ -10,11 +10,13 @@
 
 #include "mci/CompositeCast.h"
 #include "set/DataCompare.h"
+#include "set/ParallelSort.h"
 #include "utl/TypeListOper.h"
 #include "RtcTypeLists.h"
 
 #include "DataArray.h"
 #include "DataItemClass.h"
+#include "ParallelTiles.h"
 #include "Unit.h"
 #include "UnitClass.h"
 
@@ -66,7 +68,7 @@ public:
 			dms_assert(resData.size() == unsortedData.size());
 			fast_copy(unsortedData.begin(), unsortedData.end(), resData.begin());
 
-			std::sort(resData.begin(), resData.end(), DataLessThanCompare<V>());
+			parallel_sort::sort(resData.begin(), resData.end(), DataLessThanCompare<V>(), tile_task_executor());
 
 			resLock.Commit();
 		}
@@ -17,8 +17,10 @@
 
 #include "DataArray.h"
 #include "DataItemClass.h"
+#include "HashAggregation.h"
 #include "ParallelTiles.h"
 #include "TileChannel.h"
+#include "ValuesTable.h"
 #include "Unit.h"
 #include "UnitClass.h"
 #include "UnitProcessor.h"
@@ -189,6 +191,38 @@ std::vector<V> GetUniqueWallValues(const DataArray<V>* ado, tile_id t, tile_id n
 	return MergeToLeft<V>(firstHalf->get(), std::move(secondHalf), mustBeDefined);
 }
 
+// alternative for GetUniqueWallValues for values with a hash_aggregation_key, see HashAggregation.h
+template <typename V>
+std::vector<V> GetHashedUniqueValues(const DataArray<V>* ado, bool mustBeDefined)
+{
+	auto uniqueValues = HashAggregate<V, Void>(ado->GetTiledRangeData()->GetNrTiles()
+	,	[ado, mustBeDefined](tile_id t, auto& tileAdder)
+		{
+			auto tileData = ado->GetTile(t);
+			tileAdder.AddRanges(tileData.size(), [&tileData, mustBeDefined](SizeT i, SizeT e, auto& table)
+				{
+					auto values = tileData.begin();
+					for (; i != e; ++i)
+					{
+						if constexpr (has_undefines_v<V>)
+						{
+							if (mustBeDefined && !IsDefined(values[i]))
+								continue;
+						}
+						table[values[i]];
+					}
+				}
+			);
+		}
+	,	[](Void&, const Void&) {}
+	);
+
+	std::vector<V> result;
+	result.reserve(uniqueValues.size());
+	for (const auto& valueVoidPair : uniqueValues)
+		result.emplace_back(valueVoidPair.first);
+	return result;
+}
 
 template<fixed_elem V>
 void GetUniqueValues(AbstrUnit* res, AbstrDataItem* resSub, const AbstrDataItem* adi, bool mustBeDefined)
@@ -221,9 +255,18 @@ void GetUniqueValues(AbstrUnit* res, AbstrDataItem* resSub, const AbstrDataItem*
 		}
 		else
 		{
-			tile_id tn = ado->GetTiledRangeData()->GetNrTiles();
-			if (tn)
-				values = GetUniqueWallValues<V>(ado, 0, tn, mustBeDefined);
+			values = [ado, mustBeDefined]() -> std::vector<V>
+				{
+					if constexpr (has_hash_aggregation_key_v<V>)
+					{
+						if (IsWideValueRange(GetValuesRangeCardinality<V>(ado)))
+							return GetHashedUniqueValues<V>(ado, mustBeDefined);
+					}
+					tile_id tn = ado->GetTiledRangeData()->GetNrTiles();
+					if (!tn)
+						return {};
+					return GetUniqueWallValues<V>(ado, 0, tn, mustBeDefined);
+				}();
 		}
 	}
 
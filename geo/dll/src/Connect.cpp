@@ -19,16 +19,19 @@
 #include "ptr/Resource.h"
 #include "set/DataCompare.h"
 
+#include "CheckedDomain.h"
 #include "DataArray.h"
 #include "DataItemClass.h"
 #include "IndexAssigner.h"
 #include "ParallelTiles.h"
+#include "TileChannel.h"
 #include "TreeItemClass.h"
 #include "Unit.h"
 #include "UnitClass.h"
 
 #include "IndexGetterCreator.h"
 #include "LispTreeType.h"
+#include "SpatialIndexItem.h"
 
 CommonOperGroup cogCONNEIGH("connect_neighbour",   oper_policy::dynamic_result_class | oper_policy::better_not_in_meta_scripting);
 CommonOperGroup cogCON     ("connect",             oper_policy::dynamic_result_class | oper_policy::better_not_in_meta_scripting);
@@ -36,6 +39,7 @@ CommonOperGroup cogCCON    ("capacitated_connect", oper_policy::dynamic_result_c
 CommonOperGroup cogCONINFO ("connect_info", oper_policy::better_not_in_meta_scripting);
 CommonOperGroup cogDISTINFO("dist_info", oper_policy::better_not_in_meta_scripting);
 CommonOperGroup cogIndex   ("spatialIndex", oper_policy::better_not_in_meta_scripting);
+CommonOperGroup cogPackedIndex("spatial_index", oper_policy::better_not_in_meta_scripting);
 
 CommonOperGroup cogCON_EQ("connect_eq", oper_policy::dynamic_result_class | oper_policy::better_not_in_meta_scripting);
 CommonOperGroup cogCON_NE("connect_ne", oper_policy::dynamic_result_class | oper_policy::better_not_in_meta_scripting);
@@ -479,13 +483,13 @@ static TokenID s_InArc = GetTokenID_st("InArc");
 static TokenID s_InSegm = GetTokenID_st("InSegm");
 static TokenID s_SegmID = GetTokenID_st("SegmID");
 
-template <compare_type CT, bool HasMaxDist, bool HasMinDist>
+template <compare_type CT, bool HasMaxDist, bool HasMinDist, bool HasIndex>
 using ConnectInfoBaseClass = std::conditional_t < CT == compare_type::none,
-	std::conditional_t<HasMaxDist, std::conditional_t<HasMinDist, QuaternaryOperator, TernaryOperator>, BinaryOperator>
+	std::conditional_t<HasMaxDist, std::conditional_t<HasMinDist, QuaternaryOperator, TernaryOperator>, std::conditional_t<HasIndex, TernaryOperator, BinaryOperator>>
 	, std::conditional_t<HasMaxDist, std::conditional_t<HasMinDist, SexenaryOperator, QuinaryOperator>, QuaternaryOperator>>;
 
-template <typename P, typename E = UInt32, compare_type CT = compare_type::none, typename SegmID = UInt32, typename SqrtDistType = Float64, bool HasMaxDist = false, bool HasMinDist = false, bool OnlyDistResult = false>
-class ConnectInfoOperator : ConnectInfoBaseClass<CT, HasMaxDist, HasMinDist>
+template <typename P, typename E = UInt32, compare_type CT = compare_type::none, typename SegmID = UInt32, typename SqrtDistType = Float64, bool HasMaxDist = false, bool HasMinDist = false, bool OnlyDistResult = false, bool HasIndex = false>
+class ConnectInfoOperator : ConnectInfoBaseClass<CT, HasMaxDist, HasMinDist, HasIndex>
 {
 	using PointType = P;
 	using PolygonType = sequence_traits<PointType>::container_type;
@@ -508,6 +512,8 @@ class ConnectInfoOperator : ConnectInfoBaseClass<CT, HasMaxDist, HasMinDist>
 	typedef DataArray<SegmID>              ResSubType6; // segm-id
 
 	using SpatialIndexType = SpatialIndex<CoordType, typename Arg1Type::const_iterator>;
+	using PackedRTreeType  = PackedRTree<CoordType, typename Arg1Type::const_iterator>;
+	using IndexType = std::conditional_t<HasIndex, PackedRTreeType, SpatialIndexType>;
 
 	static auto cogInfo() { return OnlyDistResult ? &cogDISTINFO : &cogCONINFO; }
 	static const Class* ResultCls()
@@ -519,12 +525,21 @@ class ConnectInfoOperator : ConnectInfoBaseClass<CT, HasMaxDist, HasMinDist>
 
 public:
 	ConnectInfoOperator()
-		requires(CT == compare_type::none && !HasMinDist && !HasMaxDist)
+		requires(CT == compare_type::none && !HasMinDist && !HasMaxDist && !HasIndex)
 		:	BinaryOperator(cogInfo(), ResultCls()
 			,	Arg1Type::GetStaticClass(), Arg2Type::GetStaticClass()
 			)
 	{}
 
+	// (arcs, points, spatial_index(arcs)): queries the PackedRTree that the result of spatial_index keeps instead of building a SpatialIndex
+	ConnectInfoOperator()
+		requires(CT == compare_type::none && !HasMinDist && !HasMaxDist && HasIndex)
+		:	TernaryOperator(cogInfo(), ResultCls()
+			,	Arg1Type::GetStaticClass(), Arg2Type::GetStaticClass()
+			,	Unit<UInt32>::GetStaticClass()
+			)
+	{}
+
 	ConnectInfoOperator()
 		requires(CT == compare_type::none && !HasMinDist && HasMaxDist)
 	:	TernaryOperator(cogInfo(), ResultCls()
@@ -606,6 +621,7 @@ public:
 
 		const AbstrDataItem* argMaxDist = (HasMaxDist) ? AsDataItem(args[argCount++]) : nullptr;
 		const AbstrDataItem* argMinDist = (HasMinDist) ? AsDataItem(args[argCount++]) : nullptr;
+		const AbstrUnit*     argIndex   = (HasIndex  ) ? AsUnit    (args[argCount++]) : nullptr;
 		assert(args.size() == argCount);
 
 		const AbstrUnit* polyUnit    = arg1A->GetAbstrValuesUnit();
@@ -625,6 +641,8 @@ public:
 			pointEntity->UnifyDomain(argMinDist->GetAbstrDomainUnit(), "Domain of Point attribute", "Domain of Minimum Distances", UnifyMode(UM_Throw | UM_AllowVoidRight));
 		if (HasMaxDist)
 			pointEntity->UnifyDomain(argMaxDist->GetAbstrDomainUnit(), "Domain of Point attribute", "Domain of Maximum Distances", UnifyMode(UM_Throw| UM_AllowVoidRight));
+		if (HasIndex)
+			CheckSpatialIndexItem(argIndex, polyEntity, polyUnit, true);
 
 		bool hasNonVoidMinDist = HasMinDist && !(argMinDist->HasVoidDomainGuarantee());
 		bool hasNonVoidMaxDist = HasMaxDist && !(argMaxDist->HasVoidDomainGuarantee());
@@ -681,7 +699,14 @@ public:
 
 			auto arg1Data = arg1->GetLockedDataRead();
 			assert(arg1Count == arg1Data.size());
-			SpatialIndexType spIndex(arg1Data.begin(), arg1Data.end(), 0);
+			std::optional<SpatialIndexItemView<PackedRTreeType>> spIndexView;
+			std::optional<SpatialIndexType> spIndexBuilt;
+			const IndexType* spIndexPtr = nullptr;
+			if constexpr (HasIndex)
+				spIndexPtr = &spIndexView.emplace(argIndex, arg1Data.begin(), arg1Count).GetTree();
+			else
+				spIndexPtr = &spIndexBuilt.emplace(arg1Data.begin(), arg1Data.end(), 0);
+			const IndexType& spIndex = *spIndexPtr;
 
 			const E* polyIDsPtr = nullptr;
 			typename DataArray<E>::locked_cseq_t polyIDs;  if (arg1_ID) { polyIDs = const_array_cast<E>(arg1_ID)->GetLockedDataRead(); polyIDsPtr = polyIDs.begin(); }
@@ -1274,6 +1299,85 @@ struct SpatialIndexOper : TernaryAttrOper< QuadIdType, T, T, LevelType>
 	}
 };
 
+// *****************************************************************************
+//									SpatialIndexTreeOperator
+// *****************************************************************************
+
+// spatial_index(points or arcs): a PackedRTree of the features, kept as the unit of its leaves with the attributes and the sub-unit
+// that SpatialIndexItem.h describes. Being a unit with attributes, it is cached, can be stored and is shared by all connect_info,
+// dist_info and point_in_polygon calls that take it as argument, which query a view on these attributes without building a tree.
+
+template <typename P, bool ForPolygons>
+struct SpatialIndexTreeOperator : UnaryOperator
+{
+	using PointType   = P;
+	using CoordType   = typename PointType::field_type;
+	using FeatureType = std::conditional_t<ForPolygons, typename sequence_traits<PointType>::container_type, PointType>;
+	using ArgType     = DataArray<FeatureType>;
+	using ResultUnitType  = Unit<UInt32>;
+	using PackedRTreeType = PackedRTree<CoordType, typename ArgType::const_iterator>;
+	static_assert(PackedRTreeType::c_HasLeafBoxes == ForPolygons);
+
+	SpatialIndexTreeOperator()
+		: UnaryOperator(&cogPackedIndex, ResultUnitType::GetStaticClass(), ArgType::GetStaticClass())
+	{}
+
+	bool CreateResult(TreeItemDualRef& resultHolder, const ArgSeqType& args, bool mustCalc) const override
+	{
+		assert(args.size() == 1);
+		const AbstrDataItem* argA = AsDataItem(args[0]);
+		assert(argA);
+
+		const Unit<UInt32>* featureEntity = checked_domain<UInt32>(argA, "a1");
+		const AbstrUnit* valuesUnit = argA->GetAbstrValuesUnit();
+
+		AbstrUnit* res = ResultUnitType::GetStaticClass()->CreateResultUnit(resultHolder).release();
+		assert(res);
+		resultHolder = res;
+
+		AbstrDataItem* resFeatureRel = CreateDataItem(res, SpatialIndexFeatureRelID(), res, featureEntity);
+		resFeatureRel->SetTSF(TSF_Categorical);
+		AbstrDataItem* resLeafLower = ForPolygons ? CreateDataItem(res, SpatialIndexLowerID(), res, valuesUnit) : nullptr;
+		AbstrDataItem* resLeafUpper = ForPolygons ? CreateDataItem(res, SpatialIndexUpperID(), res, valuesUnit) : nullptr;
+
+		AbstrUnit* resNode = ResultUnitType::GetStaticClass()->CreateUnit(res, SpatialIndexNodeID()).release();
+		AbstrDataItem* resNodeLower = CreateDataItem(resNode, SpatialIndexLowerID(), resNode, valuesUnit);
+		AbstrDataItem* resNodeUpper = CreateDataItem(resNode, SpatialIndexUpperID(), resNode, valuesUnit);
+
+		if (!mustCalc)
+			return true;
+
+		// feature_rel holds the positions of the features
+		if (featureEntity->GetRange().first != 0)
+			argA->throwItemError("spatial_index requires the features to have a zero-based domain");
+
+		DataReadLock argLock(argA);
+		auto argData = const_array_cast<FeatureType>(argLock)->GetDataRead();
+
+		PackedRTreeType spIndex(argData.begin(), argData.end());
+
+		res->SetCount(spIndex.NrLeafs());
+		resNode->SetCount(spIndex.NrNodes());
+
+		auto write = [](AbstrDataItem* resItem, const auto* first, SizeT n)
+			{
+				using V = std::remove_cvref_t<decltype(*first)>;
+				auto resChannel = locked_tile_write_channel<V>(resItem);
+				resChannel.Write(first, first + n);
+				resChannel.Commit();
+			};
+		write(resFeatureRel, spIndex.GetOrder(), spIndex.NrLeafs());
+		if constexpr (ForPolygons)
+		{
+			write(resLeafLower, spIndex.GetLeafLower(), spIndex.NrLeafs());
+			write(resLeafUpper, spIndex.GetLeafUpper(), spIndex.NrLeafs());
+		}
+		write(resNodeLower, spIndex.GetNodeLower(), spIndex.NrNodes());
+		write(resNodeUpper, spIndex.GetNodeUpper(), spIndex.NrNodes());
+		return true;
+	}
+};
+
 // *****************************************************************************
 //											INSTANTIATION
 // *****************************************************************************
@@ -1323,10 +1427,15 @@ namespace
 		ConnectInfoOperator <PointType, UInt32, compare_type::none, UInt32, Float32, true, true, true> dcmdmd32;
 		ConnectInfoOperator <PointType, UInt32, compare_type::eq, UInt32, Float64, false, false, true> dc_eq;
 		ConnectInfoOperator <PointType, UInt32, compare_type::ne, UInt32, Float64, false, false, true> dc_ne;
+		ConnectInfoOperator <PointType, UInt32, compare_type::none, UInt32, Float64, false, false, false, true> ciIndexed;
+		ConnectInfoOperator <PointType, UInt32, compare_type::none, UInt32, Float64, false, false, true, true> dcIndexed;
 
 		SpatialIndexOper<PointType, UInt4, UInt32>    spatialIndex4;
 		SpatialIndexOper<PointType, UInt2, UInt8>     spatialIndex2;
 		SpatialIndexOper<PointType, Bool,  UInt4>     spatialIndex1;
+
+		SpatialIndexTreeOperator<PointType, false> packedPointIndex;
+		SpatialIndexTreeOperator<PointType, true > packedArcIndex;
 	};
 
 	tl_oper::inst_tuple_templ<typelists::seq_points, ConnectOperators > connectOperatorInstances;
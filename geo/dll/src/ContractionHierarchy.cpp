@@ -0,0 +1,464 @@
+// Copyright (C) 1998-2026 Object Vision b.v.
+// License: GNU GPL 3
+/////////////////////////////////////////////////////////////////////////////
+//
+// File: ContractionHierarchy.cpp
+//
+// Purpose:
+//   contraction_hierarchy(Link_impedance, Link_F1, Link_F2[, Link_bidirectional]) preprocesses a network once
+//   for repeated impedance_table_ch / impedance_matrix_ch runs (see Dijkstra.cpp), such as scenario variants
+//   that only differ in their zones.
+//
+// Result:
+//   a unit of CH links with the attributes F1, F2 and impedance, and the attribute Node_rank of the nodes:
+//   - all nodes are contracted one by one; contracting node v removes it from the remaining graph and adds a
+//     shortcut u->w with impedance d(u,v) + d(v,w) for each pair of remaining neighbours for which the
+//     witness search from u finds no path to w that is at most as short without v.
+//   - the CH links are the links of each node to its remaining neighbours at the time of its contraction,
+//     thus the original links (two-way links in both directions) and the shortcuts; parallel links are merged.
+//   - Node_rank is the contraction order; each CH link connects nodes of different rank.
+//
+// Node ordering:
+//   lazy updated priorities: the number of shortcuts minus the number of removed links (edge difference)
+//   plus the number of already contracted neighbours, which spreads contractions evenly over the network.
+//   Initial priorities are calculated in parallel; contractions are sequential.
+//
+// Witness searches are limited to CH_WITNESS_MAX_SETTLED nodes; a limited search only adds superfluous shortcuts.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "GeoPCH.h"
+
+#if defined(CC_PRAGMAHDRSTOP)
+#pragma hdrstop
+#endif
+
+#include "dbg/SeverityType.h"
+#include "dbg/Timer.h"
+#include "geo/HeapElem.h"
+#include "ptr/OwningPtrSizedArray.h"
+#include "set/VectorFunc.h"
+
+#include "CheckedDomain.h"
+#include "DataCheckMode.h"
+#include "DataItemClass.h"
+#include "OperationContext.h"
+#include "ParallelTiles.h"
+#include "TileChannel.h"
+#include "UnitClass.h"
+
+constexpr UInt32 CH_WITNESS_MAX_SETTLED = 500;
+
+template <typename NodeType, typename ImpType>
+struct ch_arc
+{
+	NodeType m_Node;
+	ImpType  m_Imp;
+};
+
+template <typename NodeType, typename ImpType>
+using ch_adjacency = std::vector<std::vector<ch_arc<NodeType, ImpType>>>;
+
+// *****************************************************************************
+// ch_witness_search: thread local limited Dijkstra search in the remaining graph; impedances are reset in O(1) with stamps
+// *****************************************************************************
+
+template <typename NodeType, typename ImpType>
+struct ch_witness_search
+{
+	using HeapElemType = heapElemType<ImpType, NodeType>;
+
+	void Init(NodeType nrV)
+	{
+		if (m_Imp)
+			return;
+		m_Imp   = OwningPtrSizedArray<ImpType>(nrV, dont_initialize MG_DEBUG_ALLOCATOR_SRC("contraction_hierarchy: m_Imp"));
+		m_Stamp = OwningPtrSizedArray<UInt32 >(nrV, value_construct MG_DEBUG_ALLOCATOR_SRC("contraction_hierarchy: m_Stamp"));
+		m_NrV = nrV;
+	}
+
+	// searches from source without passing excluded until maxImp is exceeded or CH_WITNESS_MAX_SETTLED nodes are settled
+	void Run(const ch_adjacency<NodeType, ImpType>& out, NodeType source, NodeType excluded, ImpType maxImp)
+	{
+		if (!++m_CurrTick) // wrapped around
+		{
+			fast_zero(m_Stamp.begin(), m_Stamp.begin() + m_NrV);
+			m_CurrTick = 1;
+		}
+		m_Heap.clear();
+		Improve(source, 0);
+
+		UInt32 nrSettled = 0;
+		while (!m_Heap.empty())
+		{
+			NodeType currNode = m_Heap.front().Value();
+			ImpType  currImp  = m_Heap.front().Imp();
+			std::pop_heap(m_Heap.begin(), m_Heap.end());
+			m_Heap.pop_back();
+			if (m_Imp[currNode] < currImp)
+				continue;
+			if (maxImp < currImp || ++nrSettled > CH_WITNESS_MAX_SETTLED)
+				break;
+
+			for (const auto& arc : out[currNode])
+			{
+				if (arc.m_Node == excluded)
+					continue;
+				ImpType d = currImp + arc.m_Imp;
+				if (!(maxImp < d) && IsBetter(arc.m_Node, d))
+					Improve(arc.m_Node, d);
+			}
+		}
+	}
+
+	// a path to w is found with at most the given impedance
+	bool IsWitnessed(NodeType w, ImpType imp) const { return m_Stamp[w] == m_CurrTick && !(imp < m_Imp[w]); }
+
+private:
+	bool IsBetter(NodeType v, ImpType d) const { return m_Stamp[v] != m_CurrTick || d < m_Imp[v]; }
+
+	void Improve(NodeType v, ImpType d)
+	{
+		m_Imp[v] = d;
+		m_Stamp[v] = m_CurrTick;
+		m_Heap.emplace_back(v, d);
+		std::push_heap(m_Heap.begin(), m_Heap.end());
+	}
+
+	NodeType m_NrV = 0;
+	UInt32   m_CurrTick = 0;
+	OwningPtrSizedArray<ImpType> m_Imp;
+	OwningPtrSizedArray<UInt32>  m_Stamp;
+	std::vector<HeapElemType>    m_Heap;
+};
+
+// *****************************************************************************
+// ch_builder: the remaining graph during contraction and the resulting CH links
+// *****************************************************************************
+
+template <typename NodeType, typename ImpType>
+struct ch_builder
+{
+	using arc_type = ch_arc<NodeType, ImpType>;
+	using witness_search = ch_witness_search<NodeType, ImpType>;
+
+	ch_builder(NodeType nrV)
+		: m_Out(nrV), m_In(nrV)
+		, m_NrContractedNeighbours(nrV, 0)
+	{}
+
+	void AddArc(NodeType u, NodeType w, ImpType imp)
+	{
+		if (u == w)
+			return;
+		for (auto& arc : m_Out[u])
+			if (arc.m_Node == w)
+			{
+				if (imp < arc.m_Imp)
+				{
+					arc.m_Imp = imp;
+					for (auto& inArc : m_In[w])
+						if (inArc.m_Node == u)
+							inArc.m_Imp = imp;
+				}
+				return;
+			}
+		m_Out[u].emplace_back(arc_type{ w, imp });
+		m_In[w].emplace_back(arc_type{ u, imp });
+	}
+
+	// calls func(u, w, imp) for each shortcut u->w that the contraction of v requires
+	template <typename Func>
+	void ForEachShortcut(NodeType v, witness_search& ws, Func&& func) const
+	{
+		const auto& outArcs = m_Out[v];
+		for (const auto& inArc : m_In[v])
+		{
+			bool hasOutArc = false;
+			ImpType maxOutImp = 0;
+			for (const auto& outArc : outArcs)
+				if (outArc.m_Node != inArc.m_Node)
+				{
+					MakeMax(maxOutImp, outArc.m_Imp);
+					hasOutArc = true;
+				}
+			if (!hasOutArc)
+				continue;
+
+			ws.Run(m_Out, inArc.m_Node, v, inArc.m_Imp + maxOutImp);
+			for (const auto& outArc : outArcs)
+			{
+				if (outArc.m_Node == inArc.m_Node)
+					continue;
+				ImpType imp = inArc.m_Imp + outArc.m_Imp;
+				if (!ws.IsWitnessed(outArc.m_Node, imp))
+					func(inArc.m_Node, outArc.m_Node, imp);
+			}
+		}
+	}
+
+	Int64 Priority(NodeType v, witness_search& ws) const
+	{
+		Int64 nrShortcuts = 0;
+		ForEachShortcut(v, ws, [&nrShortcuts](NodeType, NodeType, ImpType) { ++nrShortcuts; });
+		return nrShortcuts - Int64(m_In[v].size() + m_Out[v].size()) + m_NrContractedNeighbours[v];
+	}
+
+	void Contract(NodeType v, witness_search& ws)
+	{
+		m_Shortcuts.clear();
+		ForEachShortcut(v, ws, [this](NodeType u, NodeType w, ImpType imp) { m_Shortcuts.emplace_back(u, arc_type{ w, imp }); });
+
+		for (const auto& outArc : m_Out[v])
+		{
+			AddLink(v, outArc.m_Node, outArc.m_Imp);
+			RemoveArc(m_In[outArc.m_Node], v);
+			++m_NrContractedNeighbours[outArc.m_Node];
+		}
+		for (const auto& inArc : m_In[v])
+		{
+			AddLink(inArc.m_Node, v, inArc.m_Imp);
+			RemoveArc(m_Out[inArc.m_Node], v);
+			++m_NrContractedNeighbours[inArc.m_Node];
+		}
+		m_Out[v] = {};
+		m_In[v] = {};
+
+		for (const auto& shortcut : m_Shortcuts)
+			AddArc(shortcut.first, shortcut.second.m_Node, shortcut.second.m_Imp);
+		m_NrShortcuts += m_Shortcuts.size();
+	}
+
+	ch_adjacency<NodeType, ImpType> m_Out, m_In; // arcs between remaining nodes; at most one arc per ordered pair
+	std::vector<UInt32> m_NrContractedNeighbours;
+	std::vector<std::pair<NodeType, arc_type>> m_Shortcuts;
+	SizeT m_NrShortcuts = 0;
+
+	std::vector<NodeType> m_LinkF1, m_LinkF2;
+	std::vector<ImpType>  m_LinkImp;
+
+private:
+	static void RemoveArc(std::vector<arc_type>& arcs, NodeType node)
+	{
+		for (auto& arc : arcs)
+			if (arc.m_Node == node)
+			{
+				arc = arcs.back();
+				arcs.pop_back();
+				return;
+			}
+	}
+
+	void AddLink(NodeType f1, NodeType f2, ImpType imp)
+	{
+		m_LinkF1.emplace_back(f1);
+		m_LinkF2.emplace_back(f2);
+		m_LinkImp.emplace_back(imp);
+	}
+};
+
+// returns false when canceled
+template <typename NodeType, typename ImpType>
+bool BuildContractionHierarchy(ch_builder<NodeType, ImpType>& builder, NodeType nrV, NodeType* nodeRank)
+{
+	using witness_search = ch_witness_search<NodeType, ImpType>;
+	using HeapElemType = heapElemType<Int64, NodeType>;
+
+	Timer processTimer;
+
+	std::vector<Int64> priority(nrV);
+	concurrency::combinable<witness_search> wsC;
+	parallel_for<NodeType>(nrV, [&](NodeType v)
+		{
+			auto& ws = wsC.local();
+			ws.Init(nrV);
+			priority[v] = builder.Priority(v, ws);
+		}
+	);
+	if (CancelableFrame::CurrActiveCanceled())
+		return false;
+
+	std::vector<HeapElemType> heap;
+	heap.reserve(nrV);
+	for (NodeType v = 0; v != nrV; ++v)
+		heap.emplace_back(v, priority[v]);
+	std::make_heap(heap.begin(), heap.end());
+	priority = {};
+
+	witness_search ws;
+	ws.Init(nrV);
+	NodeType nrContracted = 0;
+	while (!heap.empty())
+	{
+		NodeType v = heap.front().Value();
+		std::pop_heap(heap.begin(), heap.end());
+		heap.pop_back();
+
+		// lazy update: contract v only if its current priority is still minimal
+		Int64 currPriority = builder.Priority(v, ws);
+		if (!heap.empty() && heap.front().Imp() < currPriority)
+		{
+			heap.emplace_back(v, currPriority);
+			std::push_heap(heap.begin(), heap.end());
+			continue;
+		}
+
+		builder.Contract(v, ws);
+		nodeRank[v] = nrContracted++;
+
+		if (processTimer.PassedSecs())
+		{
+			if (CancelableFrame::CurrActiveCanceled())
+				return false;
+			reportF(SeverityTypeID::ST_MajorTrace, "contraction_hierarchy: contracted %s of %s nodes, %s shortcuts"
+				, AsString(nrContracted), AsString(nrV), AsString(builder.m_NrShortcuts));
+		}
+	}
+	return true;
+}
+
+// *****************************************************************************
+// ContractionHierarchyOperator
+// *****************************************************************************
+
+#include "RtcTypeLists.h"
+#include "utl/TypeListOper.h"
+
+namespace {
+	CommonOperGroup cogCH("contraction_hierarchy", oper_policy::better_not_in_meta_scripting);
+
+	TokenID s_F1 = GetTokenID_st("F1");
+	TokenID s_F2 = GetTokenID_st("F2");
+	TokenID s_Impedance = GetTokenID_st("impedance");
+	TokenID s_NodeRank = GetTokenID_st("Node_rank");
+}
+
+template <typename T>
+class ContractionHierarchyOperator : public VariadicOperator
+{
+	using ImpType = T;
+	using NodeType = UInt32;
+	using LinkType = UInt32;
+	using RankType = UInt32;
+
+	using ArgImpType  = DataArray<ImpType>;
+	using ArgNodeType = DataArray<NodeType>;
+	using ArgFlagType = DataArray<Bool>;
+
+	using ResultUnitType = Unit<LinkType>;
+
+public:
+	ContractionHierarchyOperator(AbstrOperGroup* og, bool hasBidirFlag)
+		: VariadicOperator(og, ResultUnitType::GetStaticClass(), hasBidirFlag ? 4 : 3)
+	{
+		ClassCPtr* argClsIter = m_ArgClasses.get();
+		*argClsIter++ = ArgImpType::GetStaticClass();
+		*argClsIter++ = ArgNodeType::GetStaticClass();
+		*argClsIter++ = ArgNodeType::GetStaticClass();
+		if (hasBidirFlag)
+			*argClsIter++ = ArgFlagType::GetStaticClass();
+		assert(m_ArgClassesEnd == argClsIter);
+	}
+
+	bool CreateResult(TreeItemDualRef& resultHolder, const ArgSeqType& args, bool mustCalc) const override
+	{
+		const AbstrDataItem* adiLinkImp = AsDataItem(args[0]);
+		const AbstrDataItem* adiLinkF1  = AsDataItem(args[1]);
+		const AbstrDataItem* adiLinkF2  = AsDataItem(args[2]);
+		const AbstrDataItem* adiLinkBidirFlag = (args.size() > 3) ? AsDataItem(args[3]) : nullptr;
+
+		const Unit<LinkType>* e = checked_domain<LinkType>(adiLinkImp, "Link Impedance");
+		const AbstrUnit* v = adiLinkF1->GetAbstrValuesUnit();
+		const AbstrUnit* impUnit = adiLinkImp->GetAbstrValuesUnit();
+		e->UnifyDomain(adiLinkF1->GetAbstrDomainUnit(), "Links", "Domain of FromNode_rel attribute", UM_Throw);
+		e->UnifyDomain(adiLinkF2->GetAbstrDomainUnit(), "Links", "Domain of ToNode_rel attribute", UM_Throw);
+		v->UnifyDomain(adiLinkF2->GetAbstrValuesUnit(), "Nodes", "Values of ToNode_rel attribute", UM_Throw);
+		if (adiLinkBidirFlag)
+			e->UnifyDomain(adiLinkBidirFlag->GetAbstrDomainUnit(), "Links", "Domain of Bidirectional flag attribute", UM_Throw);
+
+		AbstrUnit* res = ResultUnitType::GetStaticClass()->CreateResultUnit(resultHolder).release();
+		assert(res);
+		res->SetTSF(TSF_Categorical);
+		resultHolder = res;
+
+		AbstrDataItem* resF1 = CreateDataItem(res, s_F1, res, v);
+		AbstrDataItem* resF2 = CreateDataItem(res, s_F2, res, v);
+		AbstrDataItem* resImp = CreateDataItem(res, s_Impedance, res, impUnit);
+		AbstrDataItem* resRank = CreateDataItem(res, s_NodeRank, v, Unit<RankType>::GetStaticClass()->CreateDefault());
+		resF1->SetTSF(TSF_Categorical);
+		resF2->SetTSF(TSF_Categorical);
+
+		if (!mustCalc)
+			return true;
+
+		DataReadLock argLinkImpLock(adiLinkImp);
+		DataReadLock argLinkF1Lock(adiLinkF1);
+		DataReadLock argLinkF2Lock(adiLinkF2);
+		DataReadLock argLinkFlagLock(adiLinkBidirFlag);
+
+		CheckDefineMode(adiLinkImp, "Link_impedance");
+		CheckNoneMode  (adiLinkF1, "Link_Node1_rel");
+		CheckNoneMode  (adiLinkF2, "Link_Node2_rel");
+
+		auto linkImpData = const_array_cast<ImpType>(adiLinkImp)->GetLockedDataRead();
+		auto linkF1Data  = const_array_cast<NodeType>(adiLinkF1)->GetLockedDataRead();
+		auto linkF2Data  = const_array_cast<NodeType>(adiLinkF2)->GetLockedDataRead();
+		auto linkBidirFlagData = adiLinkBidirFlag ? const_array_cast<Bool>(adiLinkBidirFlag)->GetLockedDataRead() : ArgFlagType::locked_cseq_t();
+
+		if (IsDefined(vector_find_if(linkImpData, [](ImpType imp) { return imp < 0; })))
+			throwDmsErrD("Illegal negative value in Impedance data");
+
+		NodeType nrV = v->GetCount();
+		LinkType nrE = e->GetCount();
+
+		ch_builder<NodeType, ImpType> builder(nrV);
+		for (LinkType link = 0; link != nrE; ++link)
+		{
+			NodeType f1 = linkF1Data[link], f2 = linkF2Data[link];
+			if (!(f1 < nrV) || !(f2 < nrV) || !IsDefined(linkImpData[link]))
+				continue;
+			builder.AddArc(f1, f2, linkImpData[link]);
+			if (adiLinkBidirFlag && Bool(linkBidirFlagData[link]))
+				builder.AddArc(f2, f1, linkImpData[link]);
+		}
+
+		OwningPtrSizedArray<RankType> nodeRank(nrV, dont_initialize MG_DEBUG_ALLOCATOR_SRC("contraction_hierarchy: nodeRank"));
+		if (!BuildContractionHierarchy(builder, nrV, nodeRank.begin()))
+			return false;
+
+		reportF(SeverityTypeID::ST_MajorTrace, "contraction_hierarchy: %s nodes contracted, resulting in %s links of which %s shortcuts"
+			, AsString(nrV), AsString(builder.m_LinkF1.size()), AsString(builder.m_NrShortcuts));
+
+		MG_USERCHECK2(builder.m_LinkF1.size() < MAX_VALUE(LinkType), "contraction_hierarchy: too many links");
+		res->SetCount(builder.m_LinkF1.size());
+
+		auto resF1Channel = locked_tile_write_channel<NodeType>(resF1);
+		resF1Channel.Write(begin_ptr(builder.m_LinkF1), end_ptr(builder.m_LinkF1));
+		resF1Channel.Commit();
+
+		auto resF2Channel = locked_tile_write_channel<NodeType>(resF2);
+		resF2Channel.Write(begin_ptr(builder.m_LinkF2), end_ptr(builder.m_LinkF2));
+		resF2Channel.Commit();
+
+		auto resImpChannel = locked_tile_write_channel<ImpType>(resImp);
+		resImpChannel.Write(begin_ptr(builder.m_LinkImp), end_ptr(builder.m_LinkImp));
+		resImpChannel.Commit();
+
+		auto resRankChannel = locked_tile_write_channel<RankType>(resRank);
+		resRankChannel.Write(nodeRank.begin(), nodeRank.begin() + nrV);
+		resRankChannel.Commit();
+		return true;
+	}
+};
+
+// *****************************************************************************
+// Instantiation & Registration
+// *****************************************************************************
+
+namespace
+{
+	using ImpTypeList = tl::type_list<Float64, Float32, UInt32, UInt64>;
+	using ContractionHierarchyOperListType = tl_oper::inst_tuple_templ<ImpTypeList, ContractionHierarchyOperator>;
+
+	ContractionHierarchyOperListType chOpers(&cogCH, false);
+	ContractionHierarchyOperListType chBidirOpers(&cogCH, true);
+}
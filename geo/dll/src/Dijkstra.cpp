@@ -15,6 +15,8 @@
 //     * Path reconstruction via TraceBack or LinkSet output
 //     * Link-flow accumulation (assignment style)
 //     * Multi-threaded per-origin parallelization with thread-local heaps
+//     * Searches restricted to given OD pairs, optionally goal directed (landmarks) or bidirectional
+//     * Queries on a contraction hierarchy that is preprocessed by contraction_hierarchy (see ContractionHierarchy.cpp)
 //
 // Core components overview:
 //   - TreeRelations: Lightweight parent/child traversal support for accepted nodes.
@@ -24,6 +26,10 @@
 //                        (dense vs sparse result modes) and maps result indices.
 //   - ResultInfo:     Bundled raw pointers into output buffers (filled inside ProcessDijkstra).
 //   - ProcessDijkstra: The main iterative multi-origin driver; executes parallel for each origin.
+//   - ProcessDijkstraPairs: Driver for given OD pairs; stops each search when the requested DstZones are final.
+//   - LandmarkInfo:   Impedances from and to landmark nodes for the lower bounds of goal directed searches,
+//                     calculated per call or given as the result of landmark_impedances.
+//   - CHGraphInfo, CHBuckets, ProcessDijkstraCH: Many-to-many queries on a contraction hierarchy (impedance_table_ch / impedance_matrix_ch).
 //   - DijkstraMatrOperator<T>: Operator wrapper exposing functionality to scripting/runtime.
 //
 // Concurrency design:
@@ -35,6 +41,8 @@
 //
 // Heap / traversal notes:
 //   - The custom heap supports "stale" nodes & finalization semantics to avoid redundant processing.
+//   - The frontier is a binary heap; with heap(fast), a radix heap for integral impedances or a 4-ary heap for
+//     floating point impedances, which can choose other paths among paths of equal impedance (see DijkstraHeapPolicy.h).
 //   - Endpoints may have their own impedance offsets (entered post-finalization via a secondary heap).
 //   - Euclidean pruning short-circuits CommitY if geometric distance exceeds a threshold.
 //
@@ -80,6 +88,7 @@
 #include "DataItemClass.h"
 #include "OperationContext.h"
 #include "ParallelTiles.h"
+#include "TileChannel.h"
 #include "UnitClass.h"
 
 #include "makeCululative.h"
@@ -88,6 +97,7 @@
 #include "DijkstraFlags.h"
 #include "InvertedRel.h"
 
+#include <limits>
 #include <numeric>
 #include <semaphore>
 
@@ -135,6 +145,22 @@ void CheckFlags(DijkstraFlag df)
 	MG_USERCHECK2(flags(df & DijkstraFlag::UseLinkAttr) || !flags(df & DijkstraFlag::ProdOdLinkAttr), "alternative(link_Attr) required for link_attr");
 	MG_USERCHECK2(flags(df & DijkstraFlag::UseLinkAttr) || !flags(df & DijkstraFlag::ProdOrgSumLinkAttr), "alternative(link_Attr) required for interaction:OrgZone_SumLinkAttr");
 	MG_CHECK(((df & DijkstraFlag::EuclidFlags) == DijkstraFlag::None) || ((df & DijkstraFlag::EuclidFlags) == DijkstraFlag::EuclidFlags));
+	MG_USERCHECK2(flags(df & DijkstraFlag::OD) || !flags(df & DijkstraFlag::OdPairs), "pairs(OrgZone_rel,DstZone_rel) requires an impedance_matrix");
+	MG_USERCHECK2(flags(df & DijkstraFlag::OdPairs) || !flags(df & DijkstraFlag::SearchFlags), "search(landmarks) and search(bidirectional) require pairs(OrgZone_rel,DstZone_rel)");
+	MG_CHECK(flags(df & DijkstraFlag::GoalDirected) || !flags(df & (DijkstraFlag::LandmarkNode | DijkstraFlag::LandmarkImp)));
+	MG_USERCHECK2(!flags(df & DijkstraFlag::LandmarkNode) || !flags(df & DijkstraFlag::LandmarkImp), "search(landmarks(Node_rel)) cannot be combined with search(landmarks(FromLandmark_imp,ToLandmark_imp))");
+	MG_USERCHECK2(!flags(df & DijkstraFlag::OdPairs) || !flags(df & (DijkstraFlag::DstLimit | DijkstraFlag::EuclidFlags | DijkstraFlag::UseAltLinkImp | DijkstraFlag::UseLinkAttr | DijkstraFlag::InteractionOrMaxImp | DijkstraFlag::OrgMinImp | DijkstraFlag::DstMinImp | DijkstraFlag::PrecalculatedNrDstZones))
+		, "pairs(OrgZone_rel,DstZone_rel) cannot be combined with limit, euclid, alternative, interaction, max_imp, OrgMinImp, DstMinImp or precalculateted_NrDstZones");
+	MG_USERCHECK2(!flags(df & DijkstraFlag::OdPairs) || !flags(df & (DijkstraFlag::ProdOdStartPoint_rel | DijkstraFlag::ProdOdEndPoint_rel | DijkstraFlag::ProdOdLinkSet))
+		, "pairs(OrgZone_rel,DstZone_rel) only produces the od attributes impedance, OrgZone_rel and DstZone_rel");
+	MG_USERCHECK2(!flags(df & DijkstraFlag::ContractionHierarchy) || !flags(df & (DijkstraFlag::Bidirectional | DijkstraFlag::BidirFlag))
+		, "the links of a contraction hierarchy are directed; use contraction_hierarchy with a bidirectional flag for two-way links");
+	MG_USERCHECK2(!flags(df & DijkstraFlag::ContractionHierarchy) || !flags(df & (DijkstraFlag::DstLimit | DijkstraFlag::EuclidFlags | DijkstraFlag::OdPairs | DijkstraFlag::UseAltLinkImp | DijkstraFlag::UseLinkAttr | DijkstraFlag::InteractionOrMaxImp | DijkstraFlag::PrecalculatedNrDstZones))
+		, "a contraction hierarchy cannot be combined with limit, euclid, pairs, alternative, interaction, max_imp or precalculateted_NrDstZones");
+	MG_USERCHECK2(!flags(df & DijkstraFlag::ContractionHierarchy) || !flags(df & (DijkstraFlag::ProdTraceBack | DijkstraFlag::ProdOdStartPoint_rel | DijkstraFlag::ProdOdEndPoint_rel | DijkstraFlag::ProdOdLinkSet))
+		, "the links of a contraction hierarchy include shortcuts, thus it cannot produce TraceBack, StartPoint_rel, EndPoint_rel or LinkSet");
+	MG_USERCHECK2(!flags(df & DijkstraFlag::FastHeap) || !flags(df & (DijkstraFlag::OdPairs | DijkstraFlag::ContractionHierarchy))
+		, "heap(fast) cannot be combined with pairs or a contraction hierarchy, which use their own heaps");
 }
 
 using sqr_dist_t = UInt32;
@@ -253,6 +279,7 @@ struct NetworkInfo {
 // GraphInfo:
 //   Stores raw arrays for F1/F2 endpoints and original link impedance.
 //   Also stores inverted adjacency (node->edge lists) for forward/backward traversal.
+//   The reverse adjacency (links that end in a node) is only initialized for searches towards destinations.
 // *****************************************************************************
 template <typename NodeType, typename LinkType, typename ImpType>
 struct GraphInfo {
@@ -261,6 +288,44 @@ struct GraphInfo {
 	const ImpType * linkImpDataPtr;
 
 	Inverted_rel<LinkType> node_link1_inv, node_link2_inv;
+	bool hasTwoWayLinks = false; // node_link2_inv is initialized
+
+	// reverse traversal: links by F2 and two-way links by F1; refers to the forward relations when all links are two-way
+	Inverted_rel<LinkType> node_link2_all_inv, node_link1_twoway_inv;
+	const Inverted_rel<LinkType>* rev_link2_inv = nullptr;
+	const Inverted_rel<LinkType>* rev_link1_inv = nullptr;
+
+	// calls func(link, otherNode, linkImp) for each link that can be traversed from node
+	template <typename Func>
+	void ForEachOutLink(NodeType node, Func&& func) const
+	{
+		for (LinkType link = node_link1_inv.First(node); link != UNDEFINED_VALUE(LinkType); link = node_link1_inv.Next(link))
+			func(link, linkF2Data[link], linkImpDataPtr[link]);
+		if (hasTwoWayLinks)
+			for (LinkType link = node_link2_inv.First(node); link != UNDEFINED_VALUE(LinkType); link = node_link2_inv.Next(link))
+				func(link, linkF1Data[link], linkImpDataPtr[link]);
+	}
+
+	// calls func(link, otherNode, linkImp) for each link that can be traversed towards node
+	template <typename Func>
+	void ForEachInLink(NodeType node, Func&& func) const
+	{
+		assert(rev_link2_inv);
+		for (LinkType link = rev_link2_inv->First(node); link != UNDEFINED_VALUE(LinkType); link = rev_link2_inv->Next(link))
+			func(link, linkF1Data[link], linkImpDataPtr[link]);
+		if (rev_link1_inv)
+			for (LinkType link = rev_link1_inv->First(node); link != UNDEFINED_VALUE(LinkType); link = rev_link1_inv->Next(link))
+				func(link, linkF2Data[link], linkImpDataPtr[link]);
+	}
+
+	template <typename Func>
+	void ForEachLink(NodeType node, bool towardsNode, Func&& func) const
+	{
+		if (towardsNode)
+			ForEachInLink(node, std::forward<Func>(func));
+		else
+			ForEachOutLink(node, std::forward<Func>(func));
+	}
 };
 
 // *****************************************************************************
@@ -514,8 +579,8 @@ struct WriteBlock {
 //   Works in-place over node arrays then maps node results back to OD
 //   result layout via NodeZoneConnector.
 // *****************************************************************************
-template <typename NodeType, typename LinkType, typename ZoneType, typename ImpType>
-void UpdateALW(const NetworkInfo<NodeType, ZoneType, ImpType>& ni, const OwningDijkstraHeap<NodeType, LinkType, ZoneType, ImpType>& dh, 
+template <typename NodeType, typename LinkType, typename ZoneType, typename ImpType, typename HeapPolicy>
+void UpdateALW(const NetworkInfo<NodeType, ZoneType, ImpType>& ni, const OwningDijkstraHeap<NodeType, LinkType, ZoneType, ImpType, HeapPolicy>& dh, 
 	const TreeRelations& tr, const NodeZoneConnector<NodeType, LinkType, ZoneType, ImpType>& nzc,
 	const ImpType* altLinkWeights, bool altLinkWeightsHasVoidDomain, ZoneType orgZone, ZoneType zonalResultCount, SizeT resultCountBase, ImpType* nodeALW, ImpType* altLinkImp)
 {
@@ -627,6 +692,7 @@ SizeT ProcessDijkstra(TreeItemDualRef& resultHolder
 	// Thread-local combinables (one copy per worker thread)
 	concurrency::combinable<NodeZoneConnector<NodeType, LinkType, ZoneType, ImpType>> nzcC;
 	concurrency::combinable<OwningDijkstraHeap<NodeType, LinkType, ZoneType, ImpType>> dhC;
+	concurrency::combinable<OwningDijkstraHeap<NodeType, LinkType, ZoneType, ImpType, fast_heap_policy_t<ImpType, NodeType>>> fastDhC; // heap(fast)
 	concurrency::combinable<TreeRelations> trC;
 	concurrency::combinable< std::vector<ImpType>> pot_ijC;
 
@@ -649,9 +715,9 @@ SizeT ProcessDijkstra(TreeItemDualRef& resultHolder
 		&resultHolder,
 		&writeBlocks,
 		&ni, &graph, &node_endPoint_inv, &zoneCount, &resultCount, &processTimer,
-		&nzcC, &dhC, &trC, &pot_ijC, &resLinkFlowC,
+		&nzcC, &trC, &pot_ijC, &resLinkFlowC,
 		&res
-		](ZoneType orgZone)
+		](ZoneType orgZone, auto& dhC)
 		{
 			DSM::CancelIfOutOfInterest(resultHolder.GetNew());
 			if (CancelableFrame::CurrActiveCanceled())
@@ -807,7 +873,7 @@ SizeT ProcessDijkstra(TreeItemDualRef& resultHolder
 					dms_assert(currLink < ni.nrE);
 					NodeType otherNode = graph.linkF2Data[currLink];
 					ImpType deltaCost = graph.linkImpDataPtr[currLink];
-					if (deltaCost < dh.m_MaxImp)
+					if (dh.IsBelowMaxImp(currImp, deltaCost))
 						dh.InsertNode(otherNode, currImp + deltaCost, currLink);
 					currLink = graph.node_link1_inv.Next(currLink);
 				}
@@ -821,7 +887,7 @@ SizeT ProcessDijkstra(TreeItemDualRef& resultHolder
 					dms_assert(currLink < ni.nrE);
 					NodeType otherNode = graph.linkF1Data[currLink];
 					ImpType deltaCost = graph.linkImpDataPtr[currLink];
-					if (deltaCost < dh.m_MaxImp)
+					if (dh.IsBelowMaxImp(currImp, deltaCost))
 						dh.InsertNode(otherNode, currImp + deltaCost, currLink);
 					currLink = graph.node_link2_inv.Next(currLink);
 				}
@@ -1180,7 +1246,15 @@ SizeT ProcessDijkstra(TreeItemDualRef& resultHolder
 		};
 
 	// Launch parallel per-origin processing
-	parallel_for<ZoneType>(ni.nrOrgZones, orgZoneTask);
+	bool useFastHeap = flags(df & DijkstraFlag::FastHeap);
+	parallel_for<ZoneType>(ni.nrOrgZones, [&orgZoneTask, &dhC, &fastDhC, useFastHeap](ZoneType orgZone)
+		{
+			if (useFastHeap)
+				orgZoneTask(orgZone, fastDhC);
+			else
+				orgZoneTask(orgZone, dhC);
+		}
+	);
 
 	// Combine link-flow contributions
 	if (res.LinkFlow)
@@ -1201,6 +1275,906 @@ SizeT ProcessDijkstra(TreeItemDualRef& resultHolder
 	return resultCount;
 }
 
+// *****************************************************************************
+// Searches for given OD pairs (DijkstraFlag::OdPairs):
+//   Each origin only needs the impedances to the DstZones of its pairs, so its search stops as soon as these are final
+//   instead of exploring the whole network. Two search strategies reduce the number of scanned nodes further:
+//   - GoalDirected (ALT): A* with lower bounds of the remaining impedance, derived with the triangle inequality
+//     from the impedances from and to a few landmark nodes:
+//       dist(v, w) >= d(L, w) - d(L, v)  and  dist(v, w) >= d(v, L) - d(w, L)
+//     These are calculated once per operator call and stored per node, alongside the network, or given as the
+//     result of landmark_impedances, which can be stored with the network and reused by repeated runs.
+//   - BidirectionalSearch: for origins with at most DIJKSTRA_BIDIRECTIONAL_MAX_DSTZONES requested DstZones, each pair is
+//     searched from both ends, expanding the side with the smallest key, until the sum of both smallest keys reaches
+//     the shortest found connection. Combined with landmarks, both sides use the average potential
+//       p(v) = (h_dst(v) - h_org(v)) / 2
+//     which keeps the reduced link impedances of both searches non-negative.
+//   Results are written in the order of the pairs; pairs that are not connected within the optional OrgZone_max_imp
+//   get an undefined impedance.
+// *****************************************************************************
+
+constexpr UInt32 DIJKSTRA_NR_LANDMARKS = 8;
+constexpr UInt32 DIJKSTRA_BIDIRECTIONAL_MAX_DSTZONES = 4;
+constexpr UInt32 DIJKSTRA_GOAL_DIRECTED_MAX_DSTZONES = 64; // evaluating the lower bound is linear in the number of requested DstZones
+
+using bound_t = Float64;
+constexpr bound_t INFINITE_BOUND = std::numeric_limits<bound_t>::infinity();
+
+template <typename ImpType>
+bound_t AsBound(ImpType d)
+{
+	return (d == MAX_VALUE(ImpType)) ? INFINITE_BOUND : bound_t(d);
+}
+
+// Full search from root, or towards root; dist[v] becomes MAX_VALUE(ImpType) for nodes that are not connected.
+template <typename NodeType, typename LinkType, typename ImpType>
+void CalcRootImpedances(const GraphInfo<NodeType, LinkType, ImpType>& graph, NodeType nrV, NodeType root, bool towardsRoot, ImpType* dist)
+{
+	using HeapElemType = heapElemType<ImpType, NodeType>;
+
+	fast_fill(dist, dist + nrV, MAX_VALUE(ImpType));
+	std::vector<HeapElemType> heap;
+	dist[root] = 0;
+	heap.emplace_back(root, ImpType(0));
+	while (!heap.empty())
+	{
+		NodeType currNode = heap.front().Value();
+		ImpType  currImp = heap.front().Imp();
+		std::pop_heap(heap.begin(), heap.end());
+		heap.pop_back();
+		if (dist[currNode] < currImp)
+			continue;
+
+		graph.ForEachLink(currNode, towardsRoot, [&heap, dist, currImp](LinkType, NodeType otherNode, ImpType linkImp)
+			{
+				ImpType d = currImp + linkImp;
+				if (d < dist[otherNode])
+				{
+					dist[otherNode] = d;
+					heap.emplace_back(otherNode, d);
+					std::push_heap(heap.begin(), heap.end());
+				}
+			}
+		);
+	}
+}
+
+// per landmark: the bounds of a set of nodes with offsets (start points with their impedance or end points with their impedance)
+struct landmark_set_bound
+{
+	std::vector<bound_t> m_From, m_To;
+};
+
+template <typename NodeType, typename LinkType, typename ImpType>
+struct LandmarkInfo
+{
+	using weighted_node = std::pair<NodeType, ImpType>;
+
+	// uses the given landmark nodes, or selects DIJKSTRA_NR_LANDMARKS nodes that are far apart:
+	// each next landmark is the node with the largest impedance from the nearest already selected landmark.
+	void Init(const GraphInfo<NodeType, LinkType, ImpType>& graph, NodeType nrV, const NodeType* landmarkNodes, SizeT nrGivenLandmarks)
+	{
+		std::vector<NodeType> landmarks;
+		if (landmarkNodes)
+		{
+			for (SizeT i = 0; i != nrGivenLandmarks; ++i)
+				if (landmarkNodes[i] < nrV)
+					landmarks.emplace_back(landmarkNodes[i]);
+			m_NrLandmarks = landmarks.size();
+		}
+		else
+			m_NrLandmarks = Min<NodeType>(DIJKSTRA_NR_LANDMARKS, nrV);
+		if (!m_NrLandmarks)
+			return;
+
+		m_OwnedFromLandmark = OwningPtrSizedArray<ImpType>(SizeT(nrV) * m_NrLandmarks, dont_initialize MG_DEBUG_ALLOCATOR_SRC("dijkstra: m_FromLandmark"));
+		m_OwnedToLandmark   = OwningPtrSizedArray<ImpType>(SizeT(nrV) * m_NrLandmarks, dont_initialize MG_DEBUG_ALLOCATOR_SRC("dijkstra: m_ToLandmark"));
+		m_FromLandmark = m_OwnedFromLandmark.begin();
+		m_ToLandmark   = m_OwnedToLandmark.begin();
+
+		auto storeColumn = [this, nrV](ImpType* table, UInt32 l, const ImpType* dist)
+			{
+				for (NodeType v = 0; v != nrV; ++v)
+					table[SizeT(v) * m_NrLandmarks + l] = dist[v];
+			};
+
+		bool fromLandmarksDone = !landmarkNodes;
+		if (fromLandmarksDone)
+		{
+			std::vector<ImpType> dist(nrV), minDist(nrV, MAX_VALUE(ImpType));
+			CalcRootImpedances(graph, nrV, NodeType(0), false, begin_ptr(dist));
+			NodeType landmark = FarthestNode(dist);
+			for (UInt32 l = 0; l != m_NrLandmarks; ++l)
+			{
+				landmarks.emplace_back(landmark);
+				CalcRootImpedances(graph, nrV, landmark, false, begin_ptr(dist));
+				storeColumn(m_OwnedFromLandmark.begin(), l, begin_ptr(dist));
+				for (NodeType v = 0; v != nrV; ++v)
+					MakeMin(minDist[v], dist[v]);
+				landmark = FarthestNode(minDist);
+			}
+		}
+
+		UInt32 nrTasks = fromLandmarksDone ? m_NrLandmarks : 2 * m_NrLandmarks;
+		parallel_for<UInt32>(nrTasks, [this, &graph, &landmarks, nrV, &storeColumn](UInt32 task)
+			{
+				bool towardsLandmark = (task < m_NrLandmarks);
+				UInt32 l = towardsLandmark ? task : task - m_NrLandmarks;
+				std::vector<ImpType> dist(nrV);
+				CalcRootImpedances(graph, nrV, landmarks[l], towardsLandmark, begin_ptr(dist));
+				storeColumn(towardsLandmark ? m_OwnedToLandmark.begin() : m_OwnedFromLandmark.begin(), l, begin_ptr(dist));
+			}
+		);
+		m_Landmarks = std::move(landmarks);
+	}
+
+	// uses the tables of landmark_impedances, of which the domain has nrV * nrLandmarks entries
+	void Attach(NodeType nrV, const ImpType* fromLandmark, const ImpType* toLandmark, SizeT nrEntries)
+	{
+		MG_USERCHECK2(nrV && nrEntries % nrV == 0
+			, "search(landmarks(FromLandmark_imp,ToLandmark_imp)): the number of entries is expected to be a multiple of the number of nodes, as produced by landmark_impedances for the same network");
+		m_NrLandmarks = nrEntries / nrV;
+		m_FromLandmark = fromLandmark;
+		m_ToLandmark = toLandmark;
+	}
+
+	bound_t FromLandmark(NodeType v, UInt32 l) const { return AsBound(m_FromLandmark[SizeT(v) * m_NrLandmarks + l]); }
+	bound_t ToLandmark  (NodeType v, UInt32 l) const { return AsBound(m_ToLandmark  [SizeT(v) * m_NrLandmarks + l]); }
+
+	// bounds of a set of end points y with impedance c_y, for dist(v, set) = min_y dist(v, y) + c_y:
+	//   m_From[L] = min_y d(L, y) + c_y and m_To[L] = max_y d(y, L) - c_y, or -inf if some y cannot reach L
+	void MakeTowardsSetBound(landmark_set_bound& sb, const std::vector<weighted_node>& nodes) const
+	{
+		sb.m_From.assign(m_NrLandmarks, INFINITE_BOUND);
+		sb.m_To.assign(m_NrLandmarks, -INFINITE_BOUND);
+		for (UInt32 l = 0; l != m_NrLandmarks; ++l)
+		{
+			bool allReachLandmark = true;
+			for (const auto& node : nodes)
+			{
+				MakeMin(sb.m_From[l], FromLandmark(node.first, l) + node.second);
+				bound_t dyL = ToLandmark(node.first, l);
+				if (dyL == INFINITE_BOUND)
+					allReachLandmark = false;
+				else
+					MakeMax(sb.m_To[l], dyL - node.second);
+			}
+			if (!allReachLandmark)
+				sb.m_To[l] = -INFINITE_BOUND;
+		}
+	}
+
+	// bounds of a set of start points x with impedance a_x, for dist(set, v) = min_x a_x + dist(x, v):
+	//   m_From[L] = max_x d(L, x) - a_x, or -inf if L cannot reach some x, and m_To[L] = min_x d(x, L) + a_x
+	void MakeFromSetBound(landmark_set_bound& sb, const std::vector<weighted_node>& nodes) const
+	{
+		sb.m_From.assign(m_NrLandmarks, -INFINITE_BOUND);
+		sb.m_To.assign(m_NrLandmarks, INFINITE_BOUND);
+		for (UInt32 l = 0; l != m_NrLandmarks; ++l)
+		{
+			bool allReachedFromLandmark = true;
+			for (const auto& node : nodes)
+			{
+				MakeMin(sb.m_To[l], ToLandmark(node.first, l) + node.second);
+				bound_t dLx = FromLandmark(node.first, l);
+				if (dLx == INFINITE_BOUND)
+					allReachedFromLandmark = false;
+				else
+					MakeMax(sb.m_From[l], dLx - node.second);
+			}
+			if (!allReachedFromLandmark)
+				sb.m_From[l] = -INFINITE_BOUND;
+		}
+	}
+
+	// lower bound of dist(v, set); INFINITE_BOUND if v cannot reach the set
+	bound_t LowerBoundTowards(NodeType v, const landmark_set_bound& sb) const
+	{
+		bound_t lb = 0;
+		for (UInt32 l = 0; l != m_NrLandmarks; ++l)
+		{
+			bound_t dLv = FromLandmark(v, l);
+			if (dLv != INFINITE_BOUND)
+				MakeMax(lb, sb.m_From[l] - dLv);
+			if (sb.m_To[l] != -INFINITE_BOUND)
+				MakeMax(lb, ToLandmark(v, l) - sb.m_To[l]);
+		}
+		return lb;
+	}
+
+	// lower bound of dist(set, v); INFINITE_BOUND if the set cannot reach v
+	bound_t LowerBoundFrom(NodeType v, const landmark_set_bound& sb) const
+	{
+		bound_t lb = 0;
+		for (UInt32 l = 0; l != m_NrLandmarks; ++l)
+		{
+			if (sb.m_From[l] != -INFINITE_BOUND)
+				MakeMax(lb, FromLandmark(v, l) - sb.m_From[l]);
+			bound_t dvL = ToLandmark(v, l);
+			if (dvL != INFINITE_BOUND)
+				MakeMax(lb, sb.m_To[l] - dvL);
+		}
+		return lb;
+	}
+
+	UInt32 m_NrLandmarks = 0;
+	const ImpType* m_FromLandmark = nullptr; // d(L, v) at v * m_NrLandmarks + L
+	const ImpType* m_ToLandmark = nullptr;   // d(v, L) at v * m_NrLandmarks + L
+	std::vector<NodeType> m_Landmarks;       // the nodes of the landmarks when calculated by Init
+
+	OwningPtrSizedArray<ImpType> m_OwnedFromLandmark, m_OwnedToLandmark;
+
+private:
+	static NodeType FarthestNode(const std::vector<ImpType>& dist)
+	{
+		NodeType result = 0;
+		for (NodeType v = 1, n = dist.size(); v < n; ++v)
+			if (dist[v] != MAX_VALUE(ImpType) && (dist[result] == MAX_VALUE(ImpType) || dist[result] < dist[v]))
+				result = v;
+		return result;
+	}
+};
+
+// one direction of a search for OD pairs with keys that include a potential; the impedances are reset in O(1) with stamps
+template <typename NodeType, typename ImpType>
+struct pair_search_side
+{
+	struct heap_elem
+	{
+		bound_t  m_Key;
+		ImpType  m_Imp;
+		NodeType m_Node;
+
+		bool operator <(const heap_elem& b) const { return m_Key > b.m_Key; } // bubble smallest keys to the top of the heap first
+	};
+
+	void Init(NodeType nrV)
+	{
+		if (m_Imp)
+			return;
+		m_NrV = nrV;
+		m_Imp   = OwningPtrSizedArray<ImpType>(nrV, dont_initialize MG_DEBUG_ALLOCATOR_SRC("dijkstra: pair_search_side.m_Imp"));
+		m_Stamp = OwningPtrSizedArray<UInt32 >(nrV, value_construct MG_DEBUG_ALLOCATOR_SRC("dijkstra: pair_search_side.m_Stamp"));
+	}
+
+	void Reset()
+	{
+		m_Heap.clear();
+		if (!++m_CurrTick) // wrapped around
+		{
+			fast_zero(m_Stamp.begin(), m_Stamp.begin() + m_NrV);
+			m_CurrTick = 1;
+		}
+	}
+
+	bool    IsReached(NodeType v) const { return m_Stamp[v] == m_CurrTick; }
+	ImpType Imp(NodeType v) const { assert(IsReached(v)); return m_Imp[v]; }
+	bool    IsBetter(NodeType v, ImpType d) const { return !IsReached(v) || d < m_Imp[v]; }
+
+	void Improve(NodeType v, ImpType d, bound_t key)
+	{
+		assert(IsBetter(v, d));
+		m_Imp[v] = d;
+		m_Stamp[v] = m_CurrTick;
+		m_Heap.emplace_back(heap_elem{ key, d, v });
+		std::push_heap(m_Heap.begin(), m_Heap.end());
+	}
+
+	bool    Empty() const { return m_Heap.empty(); }
+	bound_t TopKey() const { return m_Heap.empty() ? INFINITE_BOUND : m_Heap.front().m_Key; }
+
+	// returns false if the popped element was superseded by a later improvement
+	bool Pop(heap_elem& top)
+	{
+		top = m_Heap.front();
+		std::pop_heap(m_Heap.begin(), m_Heap.end());
+		m_Heap.pop_back();
+		return top.m_Imp == m_Imp[top.m_Node];
+	}
+
+	NodeType m_NrV = 0;
+	UInt32   m_CurrTick = 0;
+	OwningPtrSizedArray<ImpType> m_Imp;
+	OwningPtrSizedArray<UInt32>  m_Stamp;
+	std::vector<heap_elem>       m_Heap;
+};
+
+// thread local state of the searches for the pairs of one OrgZone at a time
+template <typename NodeType, typename ZoneType, typename ImpType>
+struct pair_search_context
+{
+	void Init(NodeType nrV, ZoneType nrDstZones, bool useBidirectional)
+	{
+		if (m_TargetOfDstZone)
+			return;
+		m_Fwd.Init(nrV);
+		if (useBidirectional)
+			m_Bwd.Init(nrV);
+		m_TargetOfDstZone = OwningPtrSizedArray<ZoneType>(nrDstZones, dont_initialize MG_DEBUG_ALLOCATOR_SRC("dijkstra: m_TargetOfDstZone"));
+		m_TargetOrgZone   = OwningPtrSizedArray<ZoneType>(nrDstZones, Undefined() MG_DEBUG_ALLOCATOR_SRC("dijkstra: m_TargetOrgZone"));
+	}
+
+	// index of dstZone in m_TargetDstZones, or UNDEFINED if not requested for orgZone
+	ZoneType TargetOf(ZoneType dstZone, ZoneType orgZone) const
+	{
+		return m_TargetOrgZone[dstZone] == orgZone ? m_TargetOfDstZone[dstZone] : UNDEFINED_VALUE(ZoneType);
+	}
+
+	ZoneType AddTarget(ZoneType dstZone, ZoneType orgZone)
+	{
+		ZoneType t = TargetOf(dstZone, orgZone);
+		if (!IsDefined(t))
+		{
+			t = m_TargetDstZones.size();
+			m_TargetDstZones.emplace_back(dstZone);
+			m_TargetOrgZone[dstZone] = orgZone;
+			m_TargetOfDstZone[dstZone] = t;
+		}
+		return t;
+	}
+
+	pair_search_side<NodeType, ImpType> m_Fwd, m_Bwd;
+	OwningPtrSizedArray<ZoneType> m_TargetOfDstZone, m_TargetOrgZone;
+
+	std::vector<ZoneType> m_TargetDstZones;
+	std::vector<ImpType>  m_TargetImp; // MAX_VALUE(ImpType) while not final
+	std::vector<landmark_set_bound> m_TargetBounds;
+	landmark_set_bound m_OrgBound;
+	std::vector<std::pair<NodeType, ImpType>> m_WeightedNodes;
+	std::vector<heapElemType<ImpType, ZoneType>> m_EndPointHeap;
+};
+
+template <typename NodeType, typename LinkType, typename ZoneType, typename ImpType, typename MassType>
+SizeT ProcessDijkstraPairs(TreeItemDualRef& resultHolder
+,	const NetworkInfo<NodeType, ZoneType, ImpType>& ni
+,	const ImpType * orgMaxImpedances, bool orgMaxImpedancesHasVoidDomain
+,	const GraphInfo<NodeType, LinkType, ImpType>& graph
+,	const Inverted_rel<ZoneType>& node_endPoint_inv
+,	const ZoneType* pairOrgZones, const ZoneType* pairDstZones, ZoneType nrPairs
+,	const LandmarkInfo<NodeType, LinkType, ImpType>& landmarks
+,	DijkstraFlag df
+,	ResultInfo<ZoneType, ImpType, MassType>&& res
+,	CharPtr actionMsg
+)
+{
+	Timer processTimer;
+	std::atomic<SizeT> zoneCount = 0, nrSearchedPairs = 0;
+
+	if (res.od_SrcZoneIds)
+		fast_copy(pairOrgZones, pairOrgZones + nrPairs, res.od_SrcZoneIds);
+	if (res.od_DstZoneIds)
+		fast_copy(pairDstZones, pairDstZones + nrPairs, res.od_DstZoneIds);
+	if (!res.od_ImpData)
+		return nrPairs;
+	fast_undefine(res.od_ImpData, res.od_ImpData + nrPairs);
+
+	Inverted_rel<ZoneType> orgZone_pair_inv;
+	orgZone_pair_inv.Init(pairOrgZones, nrPairs, ni.nrOrgZones);
+
+	Inverted_rel<ZoneType> dstZone_endPoint_inv;
+	if (ni.endPoints.Zone_rel)
+		dstZone_endPoint_inv.Init(ni.endPoints.Zone_rel, ni.nrY, ni.nrDstZones);
+
+	bool goalDirected  = flags(df & DijkstraFlag::GoalDirected) && landmarks.m_NrLandmarks;
+	bool bidirectional = flags(df & DijkstraFlag::BidirectionalSearch);
+
+	using context_t = pair_search_context<NodeType, ZoneType, ImpType>;
+	using search_side_t = pair_search_side<NodeType, ImpType>;
+	concurrency::combinable<context_t> contextC;
+
+	auto orgZoneTask = [&](ZoneType orgZone)
+		{
+			DSM::CancelIfOutOfInterest(resultHolder.GetNew());
+			if (CancelableFrame::CurrActiveCanceled())
+				return;
+
+			ZoneType firstPair = orgZone_pair_inv.First(orgZone);
+			if (!IsDefined(firstPair))
+				return;
+
+			auto& ctx = contextC.local();
+			ctx.Init(ni.nrV, ni.nrDstZones, bidirectional);
+
+			ImpType maxImp = (orgMaxImpedances) ? orgMaxImpedances[orgMaxImpedancesHasVoidDomain ? 0 : orgZone] : MAX_VALUE(ImpType);
+
+			ctx.m_TargetDstZones.clear();
+			for (ZoneType p = firstPair; IsDefined(p); p = orgZone_pair_inv.Next(p))
+				if (pairDstZones[p] < ni.nrDstZones)
+					ctx.AddTarget(pairDstZones[p], orgZone);
+			ZoneType nrTargets = ctx.m_TargetDstZones.size();
+			ctx.m_TargetImp.assign(nrTargets, MAX_VALUE(ImpType));
+
+			bool useBidirectional = bidirectional && nrTargets <= DIJKSTRA_BIDIRECTIONAL_MAX_DSTZONES;
+			bool useGoal = goalDirected && (useBidirectional || nrTargets <= DIJKSTRA_GOAL_DIRECTED_MAX_DSTZONES);
+
+			// start points with their impedance
+			auto forEachStartPoint = [&](auto&& func)
+				{
+					for (ZoneType x = ni.orgZone_startPoint_inv.FirstOrSame(orgZone); IsDefined(x); x = ni.orgZone_startPoint_inv.NextOrNone(x))
+						func(LookupOrSame(ni.startPoints.Node_rel, x), ni.startPoints.Impedances ? ni.startPoints.Impedances[x] : ImpType(0));
+				};
+			// end points of a DstZone with their impedance
+			auto forEachEndPoint = [&](ZoneType dstZone, auto&& func)
+				{
+					for (ZoneType y = dstZone_endPoint_inv.FirstOrSame(dstZone); IsDefined(y); y = dstZone_endPoint_inv.NextOrNone(y))
+						func(LookupOrSame(ni.endPoints.Node_rel, y), ni.endPoints.Impedances ? ni.endPoints.Impedances[y] : ImpType(0));
+				};
+
+			if (useGoal)
+			{
+				ctx.m_TargetBounds.resize(nrTargets);
+				for (ZoneType t = 0; t != nrTargets; ++t)
+				{
+					ctx.m_WeightedNodes.clear();
+					forEachEndPoint(ctx.m_TargetDstZones[t], [&ctx](NodeType node, ImpType imp) { ctx.m_WeightedNodes.emplace_back(node, imp); });
+					landmarks.MakeTowardsSetBound(ctx.m_TargetBounds[t], ctx.m_WeightedNodes);
+				}
+				if (useBidirectional)
+				{
+					ctx.m_WeightedNodes.clear();
+					forEachStartPoint([&ctx](NodeType node, ImpType imp) { ctx.m_WeightedNodes.emplace_back(node, imp); });
+					landmarks.MakeFromSetBound(ctx.m_OrgBound, ctx.m_WeightedNodes);
+				}
+			}
+
+			auto& fwd = ctx.m_Fwd;
+			if (!useBidirectional)
+			{
+				// one search from the OrgZone that stops when all requested DstZones are final
+				auto lowerBound = [&](NodeType v) -> bound_t
+					{
+						if (!useGoal)
+							return 0;
+						bound_t lb = INFINITE_BOUND;
+						for (ZoneType t = 0; t != nrTargets; ++t)
+							MakeMin(lb, landmarks.LowerBoundTowards(v, ctx.m_TargetBounds[t]));
+						return lb;
+					};
+				auto insertNode = [&](NodeType v, ImpType d)
+					{
+						if (!(d < maxImp) || !fwd.IsBetter(v, d))
+							return;
+						bound_t lb = lowerBound(v);
+						if (lb != INFINITE_BOUND)
+							fwd.Improve(v, d, d + lb);
+					};
+
+				fwd.Reset();
+				forEachStartPoint(insertNode);
+
+				// A DstZone is final when its impedance doesn't exceed the key of the scanned node, as the lower bound of each
+				// end point node doesn't exceed the impedance of that end point and keys don't decrease.
+				auto& endPointHeap = ctx.m_EndPointHeap;
+				endPointHeap.clear();
+				ZoneType nrFinal = 0;
+				auto commitFinal = [&](bound_t maxKey)
+					{
+						while (!endPointHeap.empty() && bound_t(endPointHeap.front().Imp()) <= maxKey)
+						{
+							ZoneType t = endPointHeap.front().Value();
+							if (ctx.m_TargetImp[t] == MAX_VALUE(ImpType))
+							{
+								ctx.m_TargetImp[t] = endPointHeap.front().Imp();
+								++nrFinal;
+							}
+							std::pop_heap(endPointHeap.begin(), endPointHeap.end());
+							endPointHeap.pop_back();
+						}
+					};
+
+				typename search_side_t::heap_elem top;
+				while (!fwd.Empty() && nrFinal < nrTargets)
+				{
+					if (!fwd.Pop(top))
+						continue;
+					for (ZoneType y = node_endPoint_inv.FirstOrSame(top.m_Node); IsDefined(y); y = node_endPoint_inv.NextOrNone(y))
+					{
+						ZoneType dstZone = LookupOrSame(ni.endPoints.Zone_rel, y);
+						if (!(dstZone < ni.nrDstZones))
+							continue;
+						ZoneType t = ctx.TargetOf(dstZone, orgZone);
+						if (!IsDefined(t) || ctx.m_TargetImp[t] != MAX_VALUE(ImpType))
+							continue;
+						ImpType dstImp = top.m_Imp + (ni.endPoints.Impedances ? ni.endPoints.Impedances[y] : ImpType(0));
+						if (dstImp < maxImp)
+						{
+							endPointHeap.emplace_back(t, dstImp);
+							std::push_heap(endPointHeap.begin(), endPointHeap.end());
+						}
+					}
+					commitFinal(top.m_Key);
+					graph.ForEachOutLink(top.m_Node, [&](LinkType, NodeType otherNode, ImpType linkImp) { insertNode(otherNode, top.m_Imp + linkImp); });
+				}
+				commitFinal(INFINITE_BOUND);
+			}
+			else
+			{
+				// bidirectional search per requested DstZone
+				auto& bwd = ctx.m_Bwd;
+				for (ZoneType t = 0; t != nrTargets; ++t)
+				{
+					ImpType shortest = MAX_VALUE(ImpType);
+					auto insertNode = [&](search_side_t& side, const search_side_t& otherSide, bool isForward, NodeType v, ImpType d)
+						{
+							if (!(d < maxImp) || !side.IsBetter(v, d))
+								return;
+							bound_t potential = 0;
+							if (useGoal)
+							{
+								bound_t hDst = landmarks.LowerBoundTowards(v, ctx.m_TargetBounds[t]);
+								bound_t hOrg = landmarks.LowerBoundFrom(v, ctx.m_OrgBound);
+								if (hDst == INFINITE_BOUND || hOrg == INFINITE_BOUND) // v is not on a path from OrgZone to DstZone
+									return;
+								potential = (hDst - hOrg) / 2;
+							}
+							side.Improve(v, d, isForward ? d + potential : d - potential);
+							if (otherSide.IsReached(v))
+								MakeMin(shortest, ImpType(d + otherSide.Imp(v)));
+						};
+
+					fwd.Reset();
+					bwd.Reset();
+					forEachStartPoint([&](NodeType node, ImpType imp) { insertNode(fwd, bwd, true, node, imp); });
+					forEachEndPoint(ctx.m_TargetDstZones[t], [&](NodeType node, ImpType imp) { insertNode(bwd, fwd, false, node, imp); });
+
+					typename search_side_t::heap_elem top;
+					while (true)
+					{
+						bound_t fwdKey = fwd.TopKey(), bwdKey = bwd.TopKey();
+						if (fwdKey + bwdKey >= AsBound(shortest))
+							break;
+						bool isForward = (fwdKey <= bwdKey);
+						auto& side = isForward ? fwd : bwd;
+						auto& otherSide = isForward ? bwd : fwd;
+						if (!side.Pop(top))
+							continue;
+						graph.ForEachLink(top.m_Node, !isForward, [&](LinkType, NodeType otherNode, ImpType linkImp) { insertNode(side, otherSide, isForward, otherNode, top.m_Imp + linkImp); });
+					}
+					if (shortest < maxImp)
+						ctx.m_TargetImp[t] = shortest;
+				}
+			}
+
+			for (ZoneType p = firstPair; IsDefined(p); p = orgZone_pair_inv.Next(p))
+			{
+				ZoneType t = (pairDstZones[p] < ni.nrDstZones) ? ctx.TargetOf(pairDstZones[p], orgZone) : UNDEFINED_VALUE(ZoneType);
+				if (IsDefined(t) && ctx.m_TargetImp[t] != MAX_VALUE(ImpType))
+					res.od_ImpData[p] = ctx.m_TargetImp[t];
+			}
+
+			zoneCount++;
+			nrSearchedPairs += nrTargets;
+			if (processTimer.PassedSecs())
+				reportF(SeverityTypeID::ST_MajorTrace, "impedance_matrix %s %s of %s sources: searched %s od-pairs"
+					, actionMsg
+					, AsString(zoneCount), AsString(ni.nrOrgZones), AsString(nrSearchedPairs));
+		};
+
+	parallel_for<ZoneType>(ni.nrOrgZones, orgZoneTask);
+
+	if (CancelableFrame::CurrActiveCanceled())
+		return UNDEFINED_VALUE(SizeT);
+
+	reportF(SeverityTypeID::ST_MajorTrace, "impedance_matrix %s all %d sources: searched %s od-pairs for %s pairs"
+		, actionMsg
+		, AsString(ni.nrOrgZones), AsString(nrSearchedPairs), AsString(nrPairs));
+
+	return nrPairs;
+}
+
+// *****************************************************************************
+// Queries on a contraction hierarchy (DijkstraFlag::ContractionHierarchy):
+//   The links are the CH links of contraction_hierarchy (see ContractionHierarchy.cpp), given with the Node_rank
+//   of their nodes. Each shortest path has an equivalent path over CH links that first goes up to increasingly
+//   higher ranked nodes and then down to increasingly lower ranked nodes, which gives bucket based many-to-many:
+//   - per DstZone a backward search from its end points over the links from higher ranked nodes;
+//     each settled node gets a bucket entry (DstZone, impedance from that node to the DstZone).
+//   - per OrgZone a forward search from its start points over the links to higher ranked nodes;
+//     its impedance to a DstZone is the minimum over the settled nodes of the forward impedance plus that of their bucket entry.
+//   Both searches stall on demand: a node that is reached with a smaller impedance via a higher ranked node is not expanded.
+//   Results have the layout of ProcessDijkstra; sparse results of an OrgZone are ordered by impedance.
+// *****************************************************************************
+
+template <typename NodeType, typename LinkType, typename ImpType>
+struct CHGraphInfo
+{
+	const NodeType* linkF1Data;
+	const NodeType* linkF2Data;
+	const ImpType * linkImpDataPtr;
+
+	Inverted_rel<LinkType> node_uplink_inv;   // by F1: links to a higher ranked node
+	Inverted_rel<LinkType> node_downlink_inv; // by F2: links from a higher ranked node
+
+	void Init(const NodeType* nodeRank, NodeType nrV, LinkType nrE)
+	{
+		std::vector<NodeType> upLinkF1(nrE, UNDEFINED_VALUE(NodeType)), downLinkF2(nrE, UNDEFINED_VALUE(NodeType));
+		for (LinkType link = 0; link != nrE; ++link)
+		{
+			NodeType f1 = linkF1Data[link], f2 = linkF2Data[link];
+			if (!(f1 < nrV) || !(f2 < nrV) || !IsDefined(linkImpDataPtr[link]))
+				continue;
+			if (nodeRank[f1] < nodeRank[f2])
+				upLinkF1[link] = f1;
+			else if (nodeRank[f2] < nodeRank[f1])
+				downLinkF2[link] = f2;
+		}
+		node_uplink_inv.Init(begin_ptr(upLinkF1), nrE, nrV);
+		node_downlink_inv.Init(begin_ptr(downLinkF2), nrE, nrV);
+	}
+
+	// calls func(otherNode, linkImp) for each link from node to a higher ranked node
+	template <typename Func>
+	void ForEachUpLink(NodeType node, Func&& func) const
+	{
+		for (LinkType link = node_uplink_inv.First(node); link != UNDEFINED_VALUE(LinkType); link = node_uplink_inv.Next(link))
+			func(linkF2Data[link], linkImpDataPtr[link]);
+	}
+
+	// calls func(otherNode, linkImp) for each link from a higher ranked node to node
+	template <typename Func>
+	void ForEachDownLinkTo(NodeType node, Func&& func) const
+	{
+		for (LinkType link = node_downlink_inv.First(node); link != UNDEFINED_VALUE(LinkType); link = node_downlink_inv.Next(link))
+			func(linkF1Data[link], linkImpDataPtr[link]);
+	}
+};
+
+// Upward search from the nodes that are already inserted in side; calls settle(node, imp) for each settled node that is not stalled.
+// The forward search follows links to higher ranked nodes, the backward search follows links from higher ranked nodes in reverse.
+template <typename NodeType, typename LinkType, typename ImpType, typename Settle>
+void CHUpwardSearch(const CHGraphInfo<NodeType, LinkType, ImpType>& ch, bool backward, pair_search_side<NodeType, ImpType>& side, ImpType maxImp, Settle&& settle)
+{
+	typename pair_search_side<NodeType, ImpType>::heap_elem top;
+	while (!side.Empty())
+	{
+		if (!side.Pop(top))
+			continue;
+
+		bool isStalled = false;
+		auto checkStall = [&side, &top, &isStalled](NodeType otherNode, ImpType linkImp)
+			{
+				if (side.IsReached(otherNode) && side.Imp(otherNode) + linkImp < top.m_Imp)
+					isStalled = true;
+			};
+		if (backward)
+			ch.ForEachUpLink(top.m_Node, checkStall);
+		else
+			ch.ForEachDownLinkTo(top.m_Node, checkStall);
+		if (isStalled)
+			continue;
+
+		settle(top.m_Node, top.m_Imp);
+
+		auto relax = [&side, &top, maxImp](NodeType otherNode, ImpType linkImp)
+			{
+				ImpType d = top.m_Imp + linkImp;
+				if (d < maxImp && side.IsBetter(otherNode, d))
+					side.Improve(otherNode, d, d);
+			};
+		if (backward)
+			ch.ForEachDownLinkTo(top.m_Node, relax);
+		else
+			ch.ForEachUpLink(top.m_Node, relax);
+	}
+}
+
+// bucket entries (DstZone, impedance to DstZone) per node, ordered by DstZone
+template <typename NodeType, typename LinkType, typename ZoneType, typename ImpType>
+struct CHBuckets
+{
+	using bucket_entry = std::pair<ZoneType, ImpType>;
+
+	// returns false when canceled
+	bool Init(TreeItemDualRef& resultHolder, const NetworkInfo<NodeType, ZoneType, ImpType>& ni, const CHGraphInfo<NodeType, LinkType, ImpType>& ch, ImpType maxImp)
+	{
+		Inverted_rel<ZoneType> dstZone_endPoint_inv;
+		if (ni.endPoints.Zone_rel)
+			dstZone_endPoint_inv.Init(ni.endPoints.Zone_rel, ni.nrY, ni.nrDstZones);
+
+		std::vector<std::vector<std::pair<NodeType, ImpType>>> dstZoneEntries(ni.nrDstZones);
+		concurrency::combinable<pair_search_side<NodeType, ImpType>> sideC;
+		parallel_for<ZoneType>(ni.nrDstZones, [&](ZoneType dstZone)
+			{
+				DSM::CancelIfOutOfInterest(resultHolder.GetNew());
+				if (CancelableFrame::CurrActiveCanceled())
+					return;
+
+				auto& side = sideC.local();
+				side.Init(ni.nrV);
+				side.Reset();
+				for (ZoneType y = dstZone_endPoint_inv.FirstOrSame(dstZone); IsDefined(y); y = dstZone_endPoint_inv.NextOrNone(y))
+				{
+					NodeType node = LookupOrSame(ni.endPoints.Node_rel, y);
+					ImpType imp = ni.endPoints.Impedances ? ni.endPoints.Impedances[y] : ImpType(0);
+					if (node < ni.nrV && imp < maxImp && side.IsBetter(node, imp))
+						side.Improve(node, imp, imp);
+				}
+				auto& entries = dstZoneEntries[dstZone];
+				CHUpwardSearch(ch, true, side, maxImp, [&entries](NodeType node, ImpType imp) { entries.emplace_back(node, imp); });
+			}
+		);
+		if (CancelableFrame::CurrActiveCanceled())
+			return false;
+
+		m_NodeFirst = OwningPtrSizedArray<SizeT>(SizeT(ni.nrV) + 1, value_construct MG_DEBUG_ALLOCATOR_SRC("dijkstra: CHBuckets.m_NodeFirst"));
+		for (const auto& entries : dstZoneEntries)
+			for (const auto& entry : entries)
+				++m_NodeFirst[entry.first + 1];
+		for (NodeType v = 0; v != ni.nrV; ++v)
+			m_NodeFirst[v + 1] += m_NodeFirst[v];
+
+		m_Entries.resize(m_NodeFirst[ni.nrV]);
+		std::vector<SizeT> nodeFill(m_NodeFirst.begin(), m_NodeFirst.begin() + ni.nrV);
+		for (ZoneType dstZone = 0; dstZone != ni.nrDstZones; ++dstZone)
+		{
+			for (const auto& entry : dstZoneEntries[dstZone])
+				m_Entries[nodeFill[entry.first]++] = bucket_entry(dstZone, entry.second);
+			dstZoneEntries[dstZone] = {};
+		}
+		return true;
+	}
+
+	template <typename Func>
+	void ForEachEntry(NodeType node, Func&& func) const
+	{
+		for (SizeT i = m_NodeFirst[node], e = m_NodeFirst[node + 1]; i != e; ++i)
+			func(m_Entries[i].first, m_Entries[i].second);
+	}
+
+	OwningPtrSizedArray<SizeT> m_NodeFirst;
+	std::vector<bucket_entry>  m_Entries;
+};
+
+// thread local state of the forward searches
+template <typename NodeType, typename ZoneType, typename ImpType>
+struct ch_query_context
+{
+	void Init(NodeType nrV, ZoneType nrDstZones)
+	{
+		if (m_ResImp)
+			return;
+		m_Fwd.Init(nrV);
+		m_ResImp     = OwningPtrSizedArray<ImpType >(nrDstZones, dont_initialize MG_DEBUG_ALLOCATOR_SRC("dijkstra: ch_query_context.m_ResImp"));
+		m_ResOrgZone = OwningPtrSizedArray<ZoneType>(nrDstZones, Undefined() MG_DEBUG_ALLOCATOR_SRC("dijkstra: ch_query_context.m_ResOrgZone"));
+	}
+
+	pair_search_side<NodeType, ImpType> m_Fwd;
+	OwningPtrSizedArray<ImpType>  m_ResImp;
+	OwningPtrSizedArray<ZoneType> m_ResOrgZone; // m_ResImp[dstZone] is valid for m_ResOrgZone[dstZone]
+	std::vector<std::pair<ImpType, ZoneType>> m_Reached;
+};
+
+template <typename NodeType, typename LinkType, typename ZoneType, typename ImpType, typename MassType>
+SizeT ProcessDijkstraCH(TreeItemDualRef& resultHolder
+,	const NetworkInfo<NodeType, ZoneType, ImpType>& ni
+,	const ImpType * orgMaxImpedances, bool orgMaxImpedancesHasVoidDomain
+,	const CHGraphInfo<NodeType, LinkType, ImpType>& ch
+,	const CHBuckets<NodeType, LinkType, ZoneType, ImpType>& buckets
+,	DijkstraFlag df
+,	const SizeT* resCumulCount
+,	SizeT* resCount
+,	ResultInfo<ZoneType, ImpType, MassType>&& res
+,	CharPtr actionMsg
+)
+{
+	Timer processTimer;
+	std::atomic<SizeT> resultCount = 0, zoneCount = 0;
+
+	bool isDense = !(flags(df & DijkstraFlag::OD) && flags(df & DijkstraFlag::SparseResult));
+	concurrency::combinable<ch_query_context<NodeType, ZoneType, ImpType>> contextC;
+
+	auto orgZoneTask = [&](ZoneType orgZone)
+		{
+			DSM::CancelIfOutOfInterest(resultHolder.GetNew());
+			if (CancelableFrame::CurrActiveCanceled())
+				return;
+
+			auto& ctx = contextC.local();
+			ctx.Init(ni.nrV, ni.nrDstZones);
+			auto& fwd = ctx.m_Fwd;
+
+			ImpType maxImp = (orgMaxImpedances) ? orgMaxImpedances[orgMaxImpedancesHasVoidDomain ? 0 : orgZone] : MAX_VALUE(ImpType);
+
+			fwd.Reset();
+			for (ZoneType x = ni.orgZone_startPoint_inv.FirstOrSame(orgZone); IsDefined(x); x = ni.orgZone_startPoint_inv.NextOrNone(x))
+			{
+				NodeType node = LookupOrSame(ni.startPoints.Node_rel, x);
+				ImpType imp = ni.startPoints.Impedances ? ni.startPoints.Impedances[x] : ImpType(0);
+				if (node < ni.nrV && imp < maxImp && fwd.IsBetter(node, imp))
+					fwd.Improve(node, imp, imp);
+			}
+
+			ctx.m_Reached.clear();
+			CHUpwardSearch(ch, false, fwd, maxImp, [&ctx, &buckets, orgZone, maxImp](NodeType node, ImpType imp)
+				{
+					buckets.ForEachEntry(node, [&ctx, orgZone, maxImp, imp](ZoneType dstZone, ImpType dstImp)
+						{
+							ImpType d = imp + dstImp;
+							if (!(d < maxImp))
+								return;
+							if (ctx.m_ResOrgZone[dstZone] != orgZone)
+							{
+								ctx.m_ResOrgZone[dstZone] = orgZone;
+								ctx.m_ResImp[dstZone] = d;
+								ctx.m_Reached.emplace_back(ImpType(), dstZone);
+							}
+							else
+								MakeMin(ctx.m_ResImp[dstZone], d);
+						}
+					);
+				}
+			);
+			for (auto& reached : ctx.m_Reached)
+				reached.first = ctx.m_ResImp[reached.second];
+
+			ZoneType zonalResultCount = isDense ? ni.nrDstZones : ctx.m_Reached.size();
+			SizeT resultCountBase = isDense ? SizeT(ni.nrDstZones) * SizeT(orgZone) : (resCumulCount ? resCumulCount[orgZone] : 0);
+			resultCount += zonalResultCount;
+
+			if (isDense)
+			{
+				if (res.od_ImpData)
+				{
+					auto impPtr = res.od_ImpData + resultCountBase;
+					fast_undefine(impPtr, impPtr + zonalResultCount);
+					for (const auto& reached : ctx.m_Reached)
+						impPtr[reached.second] = reached.first;
+				}
+				if (res.od_DstZoneIds)
+				{
+					auto dstZonePtr = res.od_DstZoneIds + resultCountBase;
+					for (ZoneType j = 0; j != zonalResultCount; ++j)
+						*dstZonePtr++ = j;
+				}
+			}
+			else if (flags(df & DijkstraFlag::Counting))
+			{
+				if (resCount)
+					resCount[orgZone] = zonalResultCount;
+			}
+			else
+			{
+				std::sort(ctx.m_Reached.begin(), ctx.m_Reached.end());
+				if (res.od_ImpData)
+				{
+					auto impPtr = res.od_ImpData + resultCountBase;
+					for (const auto& reached : ctx.m_Reached)
+						*impPtr++ = reached.first;
+				}
+				if (res.od_DstZoneIds)
+				{
+					auto dstZonePtr = res.od_DstZoneIds + resultCountBase;
+					for (const auto& reached : ctx.m_Reached)
+						*dstZonePtr++ = reached.second;
+				}
+			}
+			if (res.od_SrcZoneIds)
+			{
+				auto currPtr = res.od_SrcZoneIds + resultCountBase;
+				fast_fill(currPtr, currPtr + zonalResultCount, orgZone);
+			}
+			if (res.orgZone_NrDstZones)
+				res.orgZone_NrDstZones[orgZone] = zonalResultCount;
+
+			zoneCount++;
+			if (processTimer.PassedSecs())
+				reportF(SeverityTypeID::ST_MajorTrace, "impedance_matrix_ch %s %s of %s sources: resulted in %s od-pairs"
+					, actionMsg
+					, AsString(zoneCount), AsString(ni.nrOrgZones), AsString(resultCount));
+		};
+
+	parallel_for<ZoneType>(ni.nrOrgZones, orgZoneTask);
+
+	if (CancelableFrame::CurrActiveCanceled())
+		return UNDEFINED_VALUE(SizeT);
+
+	reportF(SeverityTypeID::ST_MajorTrace, "impedance_matrix_ch %s all %d sources: resulted in %s od-pairs"
+		, actionMsg
+		, AsString(ni.nrOrgZones), AsString(resultCount));
+
+	return resultCount;
+}
+
 // *****************************************************************************
 // DijkstraMatrOperator<T>:
 //   Runtime operator wrapper integrating with the host framework's
@@ -1265,6 +2239,9 @@ class DijkstraMatrOperator : public VariadicOperator
 		if (flags(df & DijkstraFlag::ImpCut)) ++nrArgs;
 		if (flags(df & DijkstraFlag::DstLimit)) nrArgs += 2;
 		if (flags(df & DijkstraFlag::UseEuclidicFilter)) ++nrArgs;
+		if (flags(df & DijkstraFlag::OdPairs)) nrArgs += 2;
+		if (flags(df & DijkstraFlag::LandmarkNode)) ++nrArgs;
+		if (flags(df & DijkstraFlag::LandmarkImp)) nrArgs += 2;
 		if (flags(df & DijkstraFlag::UseAltLinkImp)) ++nrArgs;
 		if (flags(df & DijkstraFlag::UseLinkAttr)) ++nrArgs;
 		if (flags(df & DijkstraFlag::InteractionVi)) ++nrArgs;
@@ -1273,8 +2250,9 @@ class DijkstraMatrOperator : public VariadicOperator
 		if (flags(df & DijkstraFlag::DistLogit)) nrArgs += 3;
 		if (flags(df & DijkstraFlag::InteractionAlpha)) ++nrArgs;
 		if (flags(df & DijkstraFlag::PrecalculatedNrDstZones)) ++nrArgs;
+		if (flags(df & DijkstraFlag::ContractionHierarchy)) ++nrArgs;
 
-		assert(nrArgs >= 3 && nrArgs <= 25);
+		assert(nrArgs >= 3 && nrArgs <= 31);
 		return nrArgs;
 	}
 
@@ -1334,6 +2312,7 @@ public:
 		const AbstrDataItem* adiLinkImp             = AsDataItem(args[argCounter++]); 
 		const AbstrDataItem* adiLinkF1              = AsDataItem(args[argCounter++]);
 		const AbstrDataItem* adiLinkF2              = AsDataItem(args[argCounter++]);
+		const AbstrDataItem* adiNodeRank            = flags(df & DijkstraFlag::ContractionHierarchy) ? AsCheckedDataItem(args[argCounter++]) : nullptr;
 		const AbstrDataItem* adiLinkBidirFlag       = flags(df & DijkstraFlag::BidirFlag) ? AsCheckedDataItem(args[argCounter++]) : nullptr;
 		const AbstrDataItem* adiStartPointNode      = flags(df & DijkstraFlag::OrgNode) ? AsCheckedDataItem(args[argCounter++]) : nullptr;
 		const AbstrDataItem* adiStartPointImpedance = flags(df & DijkstraFlag::OrgImp) ? AsCheckedDataItem(args[argCounter++]) : nullptr;
@@ -1350,6 +2329,12 @@ public:
 
 		const AbstrDataItem* adiEuclidicSqrDist     = flags(df & DijkstraFlag::UseEuclidicFilter) ? AsCheckedDataItem(args[argCounter++]) : nullptr;
 
+		const AbstrDataItem* adiPairOrgZone         = flags(df & DijkstraFlag::OdPairs) ? AsCheckedDataItem(args[argCounter++]) : nullptr;
+		const AbstrDataItem* adiPairDstZone         = flags(df & DijkstraFlag::OdPairs) ? AsCheckedDataItem(args[argCounter++]) : nullptr;
+		const AbstrDataItem* adiLandmarkNode        = flags(df & DijkstraFlag::LandmarkNode) ? AsCheckedDataItem(args[argCounter++]) : nullptr;
+		const AbstrDataItem* adiFromLandmarkImp     = flags(df & DijkstraFlag::LandmarkImp) ? AsCheckedDataItem(args[argCounter++]) : nullptr;
+		const AbstrDataItem* adiToLandmarkImp       = flags(df & DijkstraFlag::LandmarkImp) ? AsCheckedDataItem(args[argCounter++]) : nullptr;
+
 		const AbstrDataItem* adiLinkAltImp          = flags(df & DijkstraFlag::UseAltLinkImp) ? AsCheckedDataItem(args[argCounter++]) : nullptr;
 		const AbstrDataItem* adiLinkAttr            = flags(df & DijkstraFlag::UseLinkAttr  ) ? AsCheckedDataItem(args[argCounter++]) : nullptr;
 
@@ -1387,6 +2372,13 @@ public:
 		e->UnifyDomain(adiLinkF2->GetAbstrDomainUnit(), "Links", "Domain of ToNode_rel attribute", UM_Throw);
 		v->UnifyDomain(adiLinkF1->GetAbstrValuesUnit(), "Nodes", "Values of FromNode_rel attribute", UM_Throw);
 		v->UnifyDomain(adiLinkF2->GetAbstrValuesUnit(), "Nodes", "Values of ToNode_rel attribute", UM_Throw);
+		if (adiNodeRank)
+		{
+			v->UnifyDomain(adiNodeRank->GetAbstrDomainUnit(), "Nodes", "Domain of Node_rank attribute", UM_Throw);
+			MG_USERCHECK2(adiNodeRank->GetAbstrValuesUnit()->GetValueType()->GetValueClassID() == ValueWrap<NodeType>::GetStaticClass()->GetValueClassID()
+				, "values of Node_rank are expected to be UInt32, as produced by contraction_hierarchy"
+			);
+		}
 		if (adiLinkBidirFlag) e->UnifyDomain(adiLinkBidirFlag->GetAbstrDomainUnit(), "Links", "Domain of Bidirectional flag attribute", UM_Throw);
 		if (adiLinkBidirFlag) MG_USERCHECK(adiLinkBidirFlag->GetAbstrValuesUnit()->IsKindOf(Unit<Bool>::GetStaticClass()));
 		if (adiStartPointNode) v->UnifyDomain(adiStartPointNode->GetAbstrValuesUnit(), "NodeSet", "Domain of StartLink Node_rel", UM_Throw);
@@ -1445,6 +2437,22 @@ public:
 			MG_USERCHECK(adiEuclidicSqrDist->GetValueComposition() == ValueComposition::Single);
 			MG_USERCHECK(adiEuclidicSqrDist->GetAbstrValuesUnit()->GetValueType()->GetValueClassID() == ValueWrap<sqr_dist_t>::GetStaticClass()->GetValueClassID());
 		}
+		if (adiPairOrgZone)
+		{
+			assert(adiPairDstZone);
+			assert(orgZones);
+			adiPairOrgZone->GetAbstrDomainUnit()->UnifyDomain(adiPairDstZone->GetAbstrDomainUnit(), "Pairs", "Domain of pair DstZone_rel", UM_Throw);
+			orgZones->UnifyDomain(adiPairOrgZone->GetAbstrValuesUnit(), "OrgZones", "Values of pair OrgZone_rel", UM_Throw);
+			dstZones->UnifyDomain(adiPairDstZone->GetAbstrValuesUnit(), "DstZones", "Values of pair DstZone_rel", UM_Throw);
+		}
+		if (adiLandmarkNode) v->UnifyDomain(adiLandmarkNode->GetAbstrValuesUnit(), "Nodes", "Values of landmark Node_rel", UM_Throw);
+		if (adiFromLandmarkImp)
+		{
+			assert(adiToLandmarkImp);
+			adiFromLandmarkImp->GetAbstrDomainUnit()->UnifyDomain(adiToLandmarkImp->GetAbstrDomainUnit(), "LandmarkTable", "Domain of ToLandmark_imp", UM_Throw);
+			impUnit->UnifyValues(adiFromLandmarkImp->GetAbstrValuesUnit(), "ImpUnit", "Values of FromLandmark_imp", UnifyMode(UM_Throw | UM_AllowDefault));
+			impUnit->UnifyValues(adiToLandmarkImp->GetAbstrValuesUnit(), "ImpUnit", "Values of ToLandmark_imp", UnifyMode(UM_Throw | UM_AllowDefault));
+		}
 		const Unit<ImpType>* imp2Unit= impUnit;
 		CharPtr impUnitRef = "ImpUnit";
 		if (adiLinkAltImp)
@@ -1639,6 +2647,7 @@ public:
 			DataReadLock arg1Lock(adiLinkImp);
 			DataReadLock argLinkF1Lock(adiLinkF1);
 			DataReadLock argLinkF2Lock(adiLinkF2);
+			DataReadLock argNodeRankLock(adiNodeRank);
 			DataReadLock argLinkFlagLock(adiLinkBidirFlag);
 			DataReadLock arg4Lock(adiStartPointNode);
 			DataReadLock arg5Lock(adiStartPointImpedance);
@@ -1663,10 +2672,16 @@ public:
 			DataReadLock argOrgZoneLocationLock(adiOrgZoneLocation);
 			DataReadLock argDstZoneLocationLock(adiDstZoneLocation);
 			DataReadLock argEuclidicSqrDistLock(adiEuclidicSqrDist);
+			DataReadLock argPairOrgZoneLock(adiPairOrgZone);
+			DataReadLock argPairDstZoneLock(adiPairDstZone);
+			DataReadLock argLandmarkNodeLock(adiLandmarkNode);
+			DataReadLock argFromLandmarkImpLock(adiFromLandmarkImp);
+			DataReadLock argToLandmarkImpLock(adiToLandmarkImp);
 
 			const ArgImpType* argLinkImp = const_array_cast<ImpType>(adiLinkImp);
 			const ArgNodeType* argLinkF1 = const_array_cast<NodeType>(adiLinkF1);
 			const ArgNodeType* argLinkF2 = const_array_cast<NodeType>(adiLinkF2);
+			const SrcNodeType* argNodeRank = const_opt_array_checkedcast<NodeType >(adiNodeRank);
 			const ArgFlagType* argLinkBidirFlag = const_opt_array_checkedcast<Bool     >(adiLinkBidirFlag);
 			const SrcNodeType* argStartPointNode = const_opt_array_checkedcast<NodeType >(adiStartPointNode);
 			const SrcDistType* argStartPointImpedance = const_opt_array_checkedcast<ImpType  >(adiStartPointImpedance);
@@ -1677,6 +2692,11 @@ public:
 			const DstZoneType* argEndPointDstZone = const_opt_array_checkedcast<ZoneType >(adiEndPointDstZone);
 			const ZoneLocType* argDstZoneLocation = const_opt_array_checkedcast<euclid_location_t >(adiDstZoneLocation);
 			const DstZoneType* argPrecalculatedNrDstZones = const_opt_array_checkedcast<ZoneType >(adiPrecalculatedNrDstZones);
+			const SrcZoneType* argPairOrgZone = const_opt_array_checkedcast<ZoneType >(adiPairOrgZone);
+			const DstZoneType* argPairDstZone = const_opt_array_checkedcast<ZoneType >(adiPairDstZone);
+			const SrcNodeType* argLandmarkNode = const_opt_array_checkedcast<NodeType >(adiLandmarkNode);
+			const ArgImpType* argFromLandmarkImp = const_opt_array_checkedcast<ImpType  >(adiFromLandmarkImp);
+			const ArgImpType* argToLandmarkImp = const_opt_array_checkedcast<ImpType  >(adiToLandmarkImp);
 			const ArgImpType* argOrgMinImp = const_opt_array_checkedcast<ImpType  >(adiOrgMinImp);
 			const ArgImpType* argDstMinImp = const_opt_array_checkedcast<ImpType  >(adiDstMinImp);
 			const ArgImpType* argOrgMaxImp = const_opt_array_checkedcast<ImpType  >(adiOrgMaxImp);
@@ -1704,6 +2724,7 @@ public:
 			CheckDefineMode(adiLinkImp, "Link_impedance");
 			CheckNoneMode  (adiLinkF1, "Link_Node1_rel");
 			CheckNoneMode  (adiLinkF2, "Link_Node2_rel");
+			CheckNoneMode  (adiNodeRank, "Node_rank");
 			CheckNoneMode  (adiStartPointNode, "startPoint_Node_rel");
 			CheckDefineMode(adiStartPointImpedance, "startPoint_impedance");
 			CheckNoneMode  (adiStartPoinOrgZone, "startPoint_OrgZone_rel");
@@ -1726,6 +2747,7 @@ public:
 			auto linkImpData           = argLinkImp->GetLockedDataRead();
 			auto linkF1Data            = argLinkF1->GetLockedDataRead();
 			auto linkF2Data            = argLinkF2->GetLockedDataRead();
+			auto nodeRankData          = argNodeRank            ? argNodeRank           ->GetLockedDataRead() : SrcNodeType ::locked_cseq_t();
 			auto linkBidirFlagData     = argLinkBidirFlag       ? argLinkBidirFlag      ->GetLockedDataRead() : ArgFlagType ::locked_cseq_t();
 			auto startpointNodeData    = argStartPointNode      ? argStartPointNode     ->GetLockedDataRead() : SrcNodeType ::locked_cseq_t();
 			auto startpointImpData     = argStartPointImpedance ? argStartPointImpedance->GetLockedDataRead() : SrcDistType ::locked_cseq_t();
@@ -1749,6 +2771,13 @@ public:
 			auto tgDistLogitB          = argDistLogitBetaParam  ? argDistLogitBetaParam ->GetLockedDataRead() : ArgParamType::locked_cseq_t();
 			auto tgDistLogitC          = argDistLogitGammaParam ? argDistLogitGammaParam->GetLockedDataRead() : ArgParamType::locked_cseq_t();
 			auto tgOrgAlpha            = argOrgAlpha            ? argOrgAlpha           ->GetLockedDataRead() : ArgParamType::locked_cseq_t();
+			auto pairOrgZoneData       = argPairOrgZone         ? argPairOrgZone        ->GetLockedDataRead() : SrcZoneType ::locked_cseq_t();
+			auto pairDstZoneData       = argPairDstZone         ? argPairDstZone        ->GetLockedDataRead() : DstZoneType ::locked_cseq_t();
+			auto landmarkNodeData      = argLandmarkNode        ? argLandmarkNode       ->GetLockedDataRead() : SrcNodeType ::locked_cseq_t();
+			auto fromLandmarkImpData   = argFromLandmarkImp     ? argFromLandmarkImp    ->GetLockedDataRead() : ArgImpType  ::locked_cseq_t();
+			auto toLandmarkImpData     = argToLandmarkImp       ? argToLandmarkImp      ->GetLockedDataRead() : ArgImpType  ::locked_cseq_t();
+			SizeT nrPairs = pairOrgZoneData.size();
+			MG_USERCHECK2(nrPairs < MAX_VALUE(ZoneType), "pairs(OrgZone_rel,DstZone_rel): too many pairs");
 
 			NetworkInfo<NodeType, ZoneType, ImpType> networkInfo(
 				v->GetCount(), e->GetCount()
@@ -1767,6 +2796,61 @@ public:
 					graph.node_link2_inv.Init(linkF2Data.begin(), networkInfo.nrE, networkInfo.nrV);
 				else
 					graph.node_link2_inv.Init(linkF2Data.begin(), networkInfo.nrE, networkInfo.nrV, begin_ptr(linkBidirFlagData));
+				graph.hasTwoWayLinks = true;
+			}
+			if (flags(df & (DijkstraFlag::GoalDirected | DijkstraFlag::BidirectionalSearch)))
+			{
+				// searches towards landmarks and destinations traverse links in reverse
+				if (flags(df & DijkstraFlag::Bidirectional))
+				{
+					graph.rev_link2_inv = &graph.node_link2_inv;
+					graph.rev_link1_inv = &graph.node_link1_inv;
+				}
+				else
+				{
+					graph.node_link2_all_inv.Init(linkF2Data.begin(), networkInfo.nrE, networkInfo.nrV);
+					graph.rev_link2_inv = &graph.node_link2_all_inv;
+					if (flags(df & DijkstraFlag::BidirFlag))
+					{
+						graph.node_link1_twoway_inv.Init(linkF1Data.begin(), networkInfo.nrE, networkInfo.nrV, begin_ptr(linkBidirFlagData));
+						graph.rev_link1_inv = &graph.node_link1_twoway_inv;
+					}
+				}
+			}
+			LandmarkInfo<NodeType, LinkType, ImpType> landmarks;
+			if (argFromLandmarkImp)
+				landmarks.Attach(networkInfo.nrV, fromLandmarkImpData.begin(), toLandmarkImpData.begin(), fromLandmarkImpData.size());
+			else if (flags(df & DijkstraFlag::GoalDirected))
+			{
+				landmarks.Init(graph, networkInfo.nrV, argLandmarkNode ? landmarkNodeData.begin() : nullptr, landmarkNodeData.size());
+				reportF(SeverityTypeID::ST_MajorTrace, "impedance_matrix: impedances from and to %d landmarks calculated", landmarks.m_NrLandmarks);
+			}
+			CHGraphInfo<NodeType, LinkType, ImpType> chGraph{ linkF1Data.begin(), linkF2Data.begin(), linkImpDataPtr };
+			CHBuckets<NodeType, LinkType, ZoneType, ImpType> chBuckets;
+			if (flags(df & DijkstraFlag::ContractionHierarchy))
+			{
+				chGraph.Init(nodeRankData.begin(), networkInfo.nrV, networkInfo.nrE);
+				ImpType bucketMaxImp = MAX_VALUE(ImpType);
+				if (argOrgMaxImp)
+				{
+					// the buckets are only filled up to the largest defined OrgZone_max_imp; an undefined float value (NaN) excludes all
+					// destinations of its OrgZone, but an undefined integer value is MAX_VALUE, which leaves the search of its OrgZone unbounded
+					bucketMaxImp = 0;
+					for (ImpType maxImp: orgMaxImpedances)
+					{
+						if (!IsDefined(maxImp))
+						{
+							if constexpr (std::is_floating_point_v<ImpType>)
+								continue;
+							bucketMaxImp = MAX_VALUE(ImpType);
+							break;
+						}
+						MakeMax(bucketMaxImp, maxImp);
+					}
+				}
+				if (!chBuckets.Init(resultHolder, networkInfo, chGraph, bucketMaxImp))
+					return false;
+				reportF(SeverityTypeID::ST_MajorTrace, "impedance_matrix_ch: %s bucket entries of %s destination zones", AsString(chBuckets.m_Entries.size()), AsString(networkInfo.nrDstZones));
 			}
 			Inverted_rel<ZoneType> node_endPoint_inv;
 			if (argEndPointNode)
@@ -1774,12 +2858,30 @@ public:
 
 			SizeT nrRes = -1;
 			OwningPtrSizedArray<SizeT> resCount;
-			if (mutableResultUnit && flags(df & DijkstraFlag::OD_Data))
+			if (mutableResultUnit && flags(df & DijkstraFlag::OdPairs))
+			{
+				nrRes = nrPairs;
+				mutableResultUnit->SetCount(nrRes);
+			}
+			else if (mutableResultUnit && flags(df & DijkstraFlag::OD_Data))
 			{
 				if (flags(df & DijkstraFlag::SparseResult))
 				{
 					resCount = OwningPtrSizedArray<SizeT>(networkInfo.nrOrgZones, dont_initialize MG_DEBUG_ALLOCATOR_SRC("dijkstra: resCount"));
-					if (!flags(df & DijkstraFlag::PrecalculatedNrDstZones))
+					if (flags(df & DijkstraFlag::ContractionHierarchy))
+					{
+						nrRes = ProcessDijkstraCH<NodeType, LinkType, ZoneType, ImpType, MassType>(resultHolder, networkInfo
+							, orgMaxImpedances.begin(), HasVoidDomainGuarantee(adiOrgMaxImp)
+							, chGraph, chBuckets
+							, df | DijkstraFlag::Counting
+							, nullptr, resCount.begin()
+							, ResultInfo<ZoneType, ImpType, MassType>()
+							, "Counting"
+							);
+						if (!IsDefined(nrRes))
+							return false;
+					}
+					else if (!flags(df & DijkstraFlag::PrecalculatedNrDstZones))
 					{
 						nrRes = ProcessDijkstra<NodeType, LinkType, ZoneType, ImpType, MassType, ParamType>(resultHolder, networkInfo
 							, orgMaxImpedances.begin(), HasVoidDomainGuarantee(adiOrgMaxImp)
@@ -1845,7 +2947,35 @@ public:
 			DataWriteLock resDSLock(resDstSupply,      dms_rw_mode::write_only_mustzero);
 			DataWriteLock resLinkFlowLock(resLinkFlow, dms_rw_mode::write_only_mustzero);
 
-			SizeT nrRes2 = ProcessDijkstra<NodeType, LinkType, ZoneType, ImpType, MassType, ParamType>(resultHolder, networkInfo
+			SizeT nrRes2 = flags(df & DijkstraFlag::OdPairs)
+			?	ProcessDijkstraPairs<NodeType, LinkType, ZoneType, ImpType, MassType>(resultHolder, networkInfo
+				,	orgMaxImpedances.begin(), HasVoidDomainGuarantee(adiOrgMaxImp)
+				,	graph, node_endPoint_inv
+				,	pairOrgZoneData.begin(), pairDstZoneData.begin(), nrPairs
+				,	landmarks
+				,	df
+				,	ResultInfo<ZoneType, ImpType, MassType>{
+						.od_ImpData    = resDist    ? mutable_array_cast<ImpType >(resDistLock   )->GetDataWrite(no_tile, dms_rw_mode::write_only_all).begin() : nullptr
+					,	.od_SrcZoneIds = resSrcZone ? mutable_array_cast<ZoneType>(resSrcZoneLock)->GetDataWrite(no_tile, dms_rw_mode::write_only_all).begin() : nullptr
+					,	.od_DstZoneIds = resDstZone ? mutable_array_cast<ZoneType>(resDstZoneLock)->GetDataWrite(no_tile, dms_rw_mode::write_only_all).begin() : nullptr
+					}
+				,	"Filling pairs"
+				)
+			:	flags(df & DijkstraFlag::ContractionHierarchy)
+			?	ProcessDijkstraCH<NodeType, LinkType, ZoneType, ImpType, MassType>(resultHolder, networkInfo
+				,	orgMaxImpedances.begin(), HasVoidDomainGuarantee(adiOrgMaxImp)
+				,	chGraph, chBuckets
+				,	df
+				,	resCount.begin(), nullptr
+				,	ResultInfo<ZoneType, ImpType, MassType>{
+						.od_ImpData         = resDist          ? mutable_array_cast<ImpType >(resDistLock         )->GetDataWrite(no_tile, dms_rw_mode::write_only_all).begin() : nullptr
+					,	.od_SrcZoneIds      = resSrcZone       ? mutable_array_cast<ZoneType>(resSrcZoneLock      )->GetDataWrite(no_tile, dms_rw_mode::write_only_all).begin() : nullptr
+					,	.od_DstZoneIds      = resDstZone       ? mutable_array_cast<ZoneType>(resDstZoneLock      )->GetDataWrite(no_tile, dms_rw_mode::write_only_all).begin() : nullptr
+					,	.orgZone_NrDstZones = resOrgNrDstZones ? mutable_array_cast<ZoneType>(resOrgNrDstZonesLock)->GetDataWrite(no_tile, dms_rw_mode::write_only_all).begin() : nullptr
+					}
+				,	"Filling"
+				)
+			:	ProcessDijkstra<NodeType, LinkType, ZoneType, ImpType, MassType, ParamType>(resultHolder, networkInfo
 			,	orgMaxImpedances.begin(), HasVoidDomainGuarantee(adiOrgMaxImp)
 			,	orgMassLimit.begin(), HasVoidDomainGuarantee(adiOrgMassLimit)
 			,	dstMassLimit.begin(), HasVoidDomainGuarantee(adiDstMassLimit)
@@ -1924,6 +3054,139 @@ private:
 	DijkstraFlag m_OperFlags;
 };
 
+// *****************************************************************************
+// LandmarkImpedancesOperator
+//   landmark_impedances(Link_impedance, Link_F1, Link_F2[, Link_bidirectional]) calculates the impedances from and to
+//   DIJKSTRA_NR_LANDMARKS landmarks once, such that they can be stored with the network and given to repeated
+//   impedance_matrix runs with search(landmarks(FromLandmark_imp,ToLandmark_imp)) instead of being recalculated per run.
+//   The result is the unit of landmarks with their Node_rel and the sub unit Table of nrNodes * nrLandmarks entries
+//   with the attributes FromLandmark_imp (d(L, v)) and ToLandmark_imp (d(v, L)) at v * nrLandmarks + L.
+//   The tables are only lower bounds for impedance_matrix runs on the same links and the same two-way links;
+//   for runs with the bidirectional flag, in which all links are two-way, give const(true, Link) as Link_bidirectional.
+// *****************************************************************************
+
+namespace {
+	CommonOperGroup cogLandmarkImpedances("landmark_impedances", oper_policy::better_not_in_meta_scripting);
+
+	TokenID s_LandmarkNode_rel = GetTokenID_st("Node_rel");
+	TokenID s_LandmarkTable = GetTokenID_st("Table");
+	TokenID s_FromLandmark_imp = GetTokenID_st("FromLandmark_imp");
+	TokenID s_ToLandmark_imp = GetTokenID_st("ToLandmark_imp");
+}
+
+template <typename T>
+class LandmarkImpedancesOperator : public VariadicOperator
+{
+	using ImpType = T;
+	using LinkType = UInt32;
+
+	using ArgImpType  = DataArray<ImpType>;
+	using ArgNodeType = DataArray<NodeType>;
+	using ArgFlagType = DataArray<Bool>;
+
+	using ResultUnitType = Unit<UInt32>;
+
+public:
+	LandmarkImpedancesOperator(AbstrOperGroup* og, bool hasBidirFlag)
+		: VariadicOperator(og, ResultUnitType::GetStaticClass(), hasBidirFlag ? 4 : 3)
+	{
+		ClassCPtr* argClsIter = m_ArgClasses.get();
+		*argClsIter++ = ArgImpType::GetStaticClass();
+		*argClsIter++ = ArgNodeType::GetStaticClass();
+		*argClsIter++ = ArgNodeType::GetStaticClass();
+		if (hasBidirFlag)
+			*argClsIter++ = ArgFlagType::GetStaticClass();
+		assert(m_ArgClassesEnd == argClsIter);
+	}
+
+	bool CreateResult(TreeItemDualRef& resultHolder, const ArgSeqType& args, bool mustCalc) const override
+	{
+		const AbstrDataItem* adiLinkImp = AsDataItem(args[0]);
+		const AbstrDataItem* adiLinkF1  = AsDataItem(args[1]);
+		const AbstrDataItem* adiLinkF2  = AsDataItem(args[2]);
+		const AbstrDataItem* adiLinkBidirFlag = (args.size() > 3) ? AsDataItem(args[3]) : nullptr;
+
+		const Unit<LinkType>* e = checked_domain<LinkType>(adiLinkImp, "Link Impedance");
+		const AbstrUnit* v = adiLinkF1->GetAbstrValuesUnit();
+		const AbstrUnit* impUnit = adiLinkImp->GetAbstrValuesUnit();
+		e->UnifyDomain(adiLinkF1->GetAbstrDomainUnit(), "Links", "Domain of FromNode_rel attribute", UM_Throw);
+		e->UnifyDomain(adiLinkF2->GetAbstrDomainUnit(), "Links", "Domain of ToNode_rel attribute", UM_Throw);
+		v->UnifyDomain(adiLinkF2->GetAbstrValuesUnit(), "Nodes", "Values of ToNode_rel attribute", UM_Throw);
+		if (adiLinkBidirFlag)
+			e->UnifyDomain(adiLinkBidirFlag->GetAbstrDomainUnit(), "Links", "Domain of Bidirectional flag attribute", UM_Throw);
+
+		AbstrUnit* res = ResultUnitType::GetStaticClass()->CreateResultUnit(resultHolder).release();
+		assert(res);
+		res->SetTSF(TSF_Categorical);
+		resultHolder = res;
+
+		AbstrUnit* resTable = ResultUnitType::GetStaticClass()->CreateUnit(res, s_LandmarkTable).release();
+		AbstrDataItem* resNode = CreateDataItem(res, s_LandmarkNode_rel, res, v);
+		AbstrDataItem* resFromImp = CreateDataItem(resTable, s_FromLandmark_imp, resTable, impUnit);
+		AbstrDataItem* resToImp = CreateDataItem(resTable, s_ToLandmark_imp, resTable, impUnit);
+		resNode->SetTSF(TSF_Categorical);
+
+		if (!mustCalc)
+			return true;
+
+		DataReadLock argLinkImpLock(adiLinkImp);
+		DataReadLock argLinkF1Lock(adiLinkF1);
+		DataReadLock argLinkF2Lock(adiLinkF2);
+		DataReadLock argLinkFlagLock(adiLinkBidirFlag);
+
+		CheckDefineMode(adiLinkImp, "Link_impedance");
+		CheckNoneMode  (adiLinkF1, "Link_Node1_rel");
+		CheckNoneMode  (adiLinkF2, "Link_Node2_rel");
+
+		auto linkImpData = const_array_cast<ImpType>(adiLinkImp)->GetLockedDataRead();
+		auto linkF1Data  = const_array_cast<NodeType>(adiLinkF1)->GetLockedDataRead();
+		auto linkF2Data  = const_array_cast<NodeType>(adiLinkF2)->GetLockedDataRead();
+		auto linkBidirFlagData = adiLinkBidirFlag ? const_array_cast<Bool>(adiLinkBidirFlag)->GetLockedDataRead() : ArgFlagType::locked_cseq_t();
+
+		if (IsDefined(vector_find_if(linkImpData, [](ImpType imp) { return imp < 0; })))
+			throwDmsErrD("Illegal negative value in Impedance data");
+
+		NodeType nrV = v->GetCount();
+		LinkType nrE = e->GetCount();
+
+		// the same forward and reverse relations as impedance_matrix with search(landmarks)
+		GraphInfo<NodeType, LinkType, ImpType> graph{ linkF1Data.begin(), linkF2Data.begin(), linkImpData.begin() };
+		graph.node_link1_inv.Init<NodeType>(linkF1Data.begin(), nrE, nrV);
+		graph.node_link2_all_inv.Init(linkF2Data.begin(), nrE, nrV);
+		graph.rev_link2_inv = &graph.node_link2_all_inv;
+		if (adiLinkBidirFlag)
+		{
+			graph.node_link2_inv.Init(linkF2Data.begin(), nrE, nrV, begin_ptr(linkBidirFlagData));
+			graph.hasTwoWayLinks = true;
+			graph.node_link1_twoway_inv.Init(linkF1Data.begin(), nrE, nrV, begin_ptr(linkBidirFlagData));
+			graph.rev_link1_inv = &graph.node_link1_twoway_inv;
+		}
+
+		LandmarkInfo<NodeType, LinkType, ImpType> landmarks;
+		landmarks.Init(graph, nrV, nullptr, 0);
+		if (CancelableFrame::CurrActiveCanceled())
+			return false;
+		reportF(SeverityTypeID::ST_MajorTrace, "landmark_impedances: impedances from and to %d landmarks calculated", landmarks.m_NrLandmarks);
+
+		SizeT nrEntries = SizeT(nrV) * landmarks.m_NrLandmarks;
+		res->SetCount(landmarks.m_NrLandmarks);
+		resTable->SetCount(nrEntries);
+
+		auto resNodeChannel = locked_tile_write_channel<NodeType>(resNode);
+		resNodeChannel.Write(begin_ptr(landmarks.m_Landmarks), end_ptr(landmarks.m_Landmarks));
+		resNodeChannel.Commit();
+
+		auto resFromImpChannel = locked_tile_write_channel<ImpType>(resFromImp);
+		resFromImpChannel.Write(landmarks.m_FromLandmark, landmarks.m_FromLandmark + nrEntries);
+		resFromImpChannel.Commit();
+
+		auto resToImpChannel = locked_tile_write_channel<ImpType>(resToImp);
+		resToImpChannel.Write(landmarks.m_ToLandmark, landmarks.m_ToLandmark + nrEntries);
+		resToImpChannel.Commit();
+		return true;
+	}
+};
+
 // *****************************************************************************
 // Instantiation & Registration
 // *****************************************************************************
@@ -1957,6 +3220,10 @@ namespace
 	CommonOperGroup im32Group("impedance_matrix", oper_policy::allow_extra_args | oper_policy::better_not_in_meta_scripting);
 	CommonOperGroup im64Group("impedance_matrix_od64", oper_policy::allow_extra_args | oper_policy::better_not_in_meta_scripting);
 
+	CommonOperGroup itCHGroup("impedance_table_ch", oper_policy::allow_extra_args | oper_policy::better_not_in_meta_scripting);
+	CommonOperGroup im32CHGroup("impedance_matrix_ch", oper_policy::allow_extra_args | oper_policy::better_not_in_meta_scripting);
+	CommonOperGroup im64CHGroup("impedance_matrix_ch_od64", oper_policy::allow_extra_args | oper_policy::better_not_in_meta_scripting);
+
 	DijkstraOperListType dsOpers  (&dsGroup  , DijkstraFlag());
 	DijkstraOperListType dm32Opers(&dm32Group, DijkstraFlag(DijkstraFlag::OD));
 	DijkstraOperListType dm64Opers(&dm64Group, DijkstraFlag(DijkstraFlag::OD | DijkstraFlag::UInt64_Od));
@@ -1964,4 +3231,13 @@ namespace
 	DijkstraOperListType itOpers(&itGroup, DijkstraFlag());
 	DijkstraOperListType im32Opers(&im32Group, DijkstraFlag(DijkstraFlag::OD));
 	DijkstraOperListType im64Opers(&im64Group, DijkstraFlag(DijkstraFlag::OD | DijkstraFlag::UInt64_Od));
+
+	DijkstraOperListType itCHOpers(&itCHGroup, DijkstraFlag(DijkstraFlag::ContractionHierarchy));
+	DijkstraOperListType im32CHOpers(&im32CHGroup, DijkstraFlag(DijkstraFlag::OD | DijkstraFlag::ContractionHierarchy));
+	DijkstraOperListType im64CHOpers(&im64CHGroup, DijkstraFlag(DijkstraFlag::OD | DijkstraFlag::UInt64_Od | DijkstraFlag::ContractionHierarchy));
+
+	using LandmarkImpedancesOperListType = tl_oper::inst_tuple_templ<DistTypeList, LandmarkImpedancesOperator>;
+
+	LandmarkImpedancesOperListType landmarkOpers(&cogLandmarkImpedances, false);
+	LandmarkImpedancesOperListType landmarkBidirOpers(&cogLandmarkImpedances, true);
 }
@@ -8,7 +8,7 @@
 //   Provides two related template classes implementing the core data
 //   structures used for (variants of) Dijkstra's shortest path algorithm.
 //   - DijkstraHeap:   Non-owning container managing tentative/final distances
-//                     (impedances) and a binary heap of active nodes.
+//                     (impedances) and a priority queue of active nodes.
 //   - OwningDijkstraHeap: Owning variant that allocates result arrays and
 //                         (optionally) traceback information.
 // 
@@ -16,7 +16,10 @@
 //   1. Distance / Impedance (ImpType):
 //        The cost metric being minimized.
 //   2. Heap of frontier nodes (m_NodeHeap):
-//        Maintains nodes discovered but not yet finalized.
+//        Maintains nodes discovered but not yet finalized; its HeapPolicy
+//        (see DijkstraHeapPolicy.h) defaults to a binary heap; fast_heap_policy_t
+//        selects a radix heap for integral impedances and a 4-ary heap for
+//        floating point impedances, which finalize ties in another order.
 //   3. Zone Stamp Mechanism (m_SrcZoneStamp / m_CurrSrcZoneTick):
 //        Optional lazy reset system to avoid O(n) reinitialization per run.
 //        - When enabled (useSrcZoneStamps == true), we keep a per-node stamp
@@ -36,6 +39,7 @@
 //              (may be small bit-packed type).
 //   ZoneType : integral type for stamping iteration cycles.
 //   ImpType  : numeric type representing distance/impedance.
+//   HeapPolicy: priority queue of (node, impedance) elements.
 //
 // Invariants / Expectations:
 //   - Distances are non-negative.
@@ -46,8 +50,8 @@
 //   - m_MaxImp acts as a dynamic upper bound (e.g. for early stopping).
 //
 // Complexity Notes:
-//   - InsertNode: O(log k) where k = current heap size.
-//   - PopNode:    O(log k).
+//   - InsertNode: O(log k) where k = current heap size; O(1) for the radix heap.
+//   - PopNode:    O(log k); O(log C) amortized for the radix heap with impedances up to C.
 //   - ResetImpedances:
 //        * O(1) if zone stamps are active.
 //        * O(n) if explicit fill is required (no zone stamps).
@@ -56,10 +60,8 @@
 //   - Not thread-safe. External synchronization is required if shared.
 //
 // Potential Improvements (TODO):
-//   - Provide custom comparator injection if heapElemType does not encode it.
 //   - Add noexcept specifiers where safe.
 //   - Consider small-vector optimization for tiny graphs.
-//   - Provide an interface to shrink / clear heap without reallocation.
 //   - Validate / fix trailing extra parenthesis in include guard end line.
 //
 // Caution:
@@ -80,16 +82,18 @@
 #include "geo/HeapElem.h"
 #include "ptr/OwningPtrSizedArray.h"
 
+#include "DijkstraHeapPolicy.h"
+
 // *****************************************************************************
 // DijkstraHeap
 //   Non-owning base: external code must set m_ResultDataPtr (and optionally
 //   m_TraceBackDataPtr) before invoking algorithmic operations.
 // *****************************************************************************
-template <typename NodeType, typename LinkType, typename ZoneType, typename ImpType>
+template <typename NodeType, typename LinkType, typename ZoneType, typename ImpType, typename HeapPolicy = dijkstra_heap_policy_t<ImpType, NodeType>>
 struct DijkstraHeap
 {
-	typedef heapElemType<ImpType, NodeType> HeapElemType;  // Must provide ordering for std::push_heap/pop_heap
-	typedef std::vector<HeapElemType>       HeapType;
+	typedef heapElemType<ImpType, NodeType> HeapElemType;
+	typedef HeapPolicy                      HeapType;
 
 	DijkstraHeap()
 		: m_NrV(0)
@@ -128,6 +132,7 @@ struct DijkstraHeap
 	//   - Otherwise performs an O(n) fill with m_MaxImp (infinity sentinel)
 	void ResetImpedances()
 	{
+		m_NodeHeap.Clear(); // keeps the allocated capacity
 		++m_CurrSrcZoneTick;
 		if (!m_SrcZoneStamp)
 			fast_fill(m_ResultDataPtr, m_ResultDataPtr + m_NrV, m_MaxImp); // OPTIMIZE: INIT operations per Src of Complexity Order(nrV)
@@ -182,6 +187,15 @@ struct DijkstraHeap
 		return false;
 	}
 
+	// Returns true if currImp + linkImp is less than m_MaxImp, without calculating a sum that could overflow unsigned impedances.
+	bool IsBelowMaxImp(ImpType currImp, ImpType linkImp) const
+	{
+		if constexpr (std::is_integral_v<ImpType>)
+			return currImp < m_MaxImp && linkImp < m_MaxImp - currImp; // m_MaxImp can have decreased below currImp by early-stop logic
+		else
+			return currImp + linkImp < m_MaxImp;
+	}
+
 	// Attempts to insert node v with tentative distance d and optional backTrace.
 	// Skips insertion if d >= m_MaxImp or not an improvement.
 	void InsertNode(NodeType v, ImpType d, LinkType backTrace)
@@ -193,9 +207,7 @@ struct DijkstraHeap
 			if (!IsBetter(v, d))
 				return;
 
-			// Push into binary heap; heapElemType defines ordering (likely min-heap via > comparator adaptation).
-			m_NodeHeap.push_back(HeapElemType(v, d));
-			std::push_heap(m_NodeHeap.begin(), m_NodeHeap.end());
+			m_NodeHeap.Push(v, d);
 
 			MarkTentative(v, d);
 			if (m_TraceBackDataPtr)
@@ -203,16 +215,34 @@ struct DijkstraHeap
 		}
 	}
 
+	// Pushes node v with the distance that external code has written to m_ResultDataPtr[v], such as the sweeps of griddist_sweep.
+	// Skips the node if that distance is not less than m_MaxImp.
+	void PushTentative(NodeType v)
+	{
+		assert(v < m_NrV);
+		ImpType d = m_ResultDataPtr[v];
+		if (d < m_MaxImp)
+		{
+			m_NodeHeap.Push(v, d);
+			Stamp(v);
+		}
+	}
+
+	// Removes all nodes from the heap; keeps the allocated capacity.
+	void Clear()
+	{
+		m_NodeHeap.Clear();
+	}
+
 	// Removes top (best) node from heap.
 	void PopNode()
 	{
-		std::pop_heap(m_NodeHeap.begin(), m_NodeHeap.end());
-		m_NodeHeap.pop_back();
+		m_NodeHeap.Pop();
 	}
 
-	// Heap state queries.
-	bool                Empty() const { return m_NodeHeap.empty(); }
-	const HeapElemType& Front() const { return m_NodeHeap.front(); }
+	// Heap state queries; Front is not const as the radix heap moves the minimal elements to the front on demand.
+	bool                Empty() const { return m_NodeHeap.Empty(); }
+	const HeapElemType& Front() { return m_NodeHeap.Front(); }
 
 	// External pointers (non-owning by this base type):
 	ImpType* m_ResultDataPtr = nullptr; // Distance array (size: m_NrV)
@@ -222,7 +252,7 @@ struct DijkstraHeap
 protected:
 	NodeType m_NrV = 0;                          // Number of nodes
 	ZoneType m_CurrSrcZoneTick = UNDEFINED_VALUE(ZoneType); // Current stamp tick
-	HeapType m_NodeHeap;                         // Binary heap container
+	HeapType m_NodeHeap;                         // Priority queue of frontier nodes
 	OwningPtrSizedArray<ZoneType> m_SrcZoneStamp; // Optional per-node stamp buffer
 };
 
@@ -231,8 +261,8 @@ protected:
 //   Extends DijkstraHeap by allocating (owning) result buffers.
 //   Optional allocation of traceback data controlled by useTraceBack.
 // *****************************************************************************
-template <typename NodeType, typename LinkType, typename ZoneType, typename ImpType>
-struct OwningDijkstraHeap : DijkstraHeap<NodeType, LinkType, ZoneType,ImpType>
+template <typename NodeType, typename LinkType, typename ZoneType, typename ImpType, typename HeapPolicy = dijkstra_heap_policy_t<ImpType, NodeType>>
+struct OwningDijkstraHeap : DijkstraHeap<NodeType, LinkType, ZoneType, ImpType, HeapPolicy>
 {
 	OwningDijkstraHeap()
 	{}
@@ -246,7 +276,7 @@ struct OwningDijkstraHeap : DijkstraHeap<NodeType, LinkType, ZoneType,ImpType>
 	// Initializes base and allocates buffers if not already allocated.
 	void Init(NodeType nrV, bool useSrcZoneStamps, bool useTraceBack)
 	{
-		DijkstraHeap<NodeType, LinkType, ZoneType, ImpType>::Init(nrV, useSrcZoneStamps);
+		DijkstraHeap<NodeType, LinkType, ZoneType, ImpType, HeapPolicy>::Init(nrV, useSrcZoneStamps);
 		if (nrV && !m_ResultData)
 		{
 			m_ResultData = OwningPtrSizedArray<ImpType>(nrV, dont_initialize MG_DEBUG_ALLOCATOR_SRC("dijkstra: m_ResultData"));
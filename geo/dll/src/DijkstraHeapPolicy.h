@@ -0,0 +1,230 @@
+// Copyright (C) 1998-2026 Object Vision b.v.
+// License: GNU GPL 3
+/////////////////////////////////////////////////////////////////////////////
+
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+File: DijkstraHeapPolicy.h
+Purpose:
+- Priority queues of (node, impedance) elements for the frontier of DijkstraHeap (see Dijkstra.h).
+
+Summary:
+- All policies provide Push(v, d), Empty(), Front(), Pop() and Clear() and keep duplicates of improved nodes;
+  DijkstraHeap::MarkFinal skips the superseded ones.
+- binary_heap_policy: std::push_heap / std::pop_heap on a vector, as DijkstraHeap did before; the default.
+- quaternary_heap_policy: an implicit 4-ary heap; halves the depth of a binary heap and the children of a node share a cache line.
+- radix_heap_policy: buckets by the highest bit in which an impedance differs from the last popped minimum;
+  each element moves to a lower bucket at most once per bit, thus Push is O(1) and Pop is O(log C) amortized for impedances up to C.
+  Requires integral impedances and monotone use: no impedance is pushed that is smaller than the last popped one,
+  which holds for Dijkstra with non negative link impedances. Elements with equal impedance are popped in LIFO order.
+- dijkstra_heap_policy_t is the binary heap, which keeps the order in which nodes with equal impedance are finalized,
+  and thus the chosen paths among paths of equal impedance, as before.
+- fast_heap_policy_t selects the radix heap for integral impedances (such as seconds) and the 4-ary heap for floating point impedances;
+  impedance_table and impedance_matrix use it with the option heap(fast).
+*/
+
+#if !defined(__GEO_DIJKSTRAHEAPPOLICY_H)
+#define __GEO_DIJKSTRAHEAPPOLICY_H
+
+#include <algorithm>
+#include <array>
+#include <assert.h>
+#include <bit>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "geo/HeapElem.h"
+
+// *****************************************************************************
+// binary_heap_policy
+// *****************************************************************************
+
+template <typename ImpType, typename NodeType>
+struct binary_heap_policy
+{
+	using HeapElemType = heapElemType<ImpType, NodeType>; // operator < bubbles the smallest impedance to the top
+
+	void Push(NodeType v, ImpType d)
+	{
+		m_Heap.emplace_back(v, d);
+		std::push_heap(m_Heap.begin(), m_Heap.end());
+	}
+
+	bool Empty() const { return m_Heap.empty(); }
+	const HeapElemType& Front() { assert(!Empty()); return m_Heap.front(); }
+
+	void Pop()
+	{
+		std::pop_heap(m_Heap.begin(), m_Heap.end());
+		m_Heap.pop_back();
+	}
+
+	void Clear() { m_Heap.clear(); }
+
+private:
+	std::vector<HeapElemType> m_Heap;
+};
+
+// *****************************************************************************
+// quaternary_heap_policy
+// *****************************************************************************
+
+template <typename ImpType, typename NodeType>
+struct quaternary_heap_policy
+{
+	using HeapElemType = heapElemType<ImpType, NodeType>;
+	static constexpr std::size_t ARITY = 4;
+
+	void Push(NodeType v, ImpType d)
+	{
+		HeapElemType elem(v, d);
+		std::size_t i = m_Heap.size();
+		m_Heap.emplace_back(elem);
+		while (i)
+		{
+			std::size_t parent = (i - 1) / ARITY;
+			if (!(d < m_Heap[parent].Imp()))
+				break;
+			m_Heap[i] = m_Heap[parent];
+			i = parent;
+		}
+		m_Heap[i] = elem;
+	}
+
+	bool Empty() const { return m_Heap.empty(); }
+	const HeapElemType& Front() { assert(!Empty()); return m_Heap.front(); }
+
+	// moves the hole at the root down along the smallest children to a leaf and then the last element up from there,
+	// which saves comparisons as the last element mostly belongs near the leaves
+	void Pop()
+	{
+		assert(!Empty());
+		std::size_t n = m_Heap.size() - 1;
+		std::size_t i = 0;
+		while (true)
+		{
+			std::size_t firstChild = i * ARITY + 1;
+			if (firstChild >= n)
+				break;
+			std::size_t bestChild = firstChild;
+			for (std::size_t c = firstChild + 1, ce = std::min(firstChild + ARITY, n); c < ce; ++c)
+				if (m_Heap[c].Imp() < m_Heap[bestChild].Imp())
+					bestChild = c;
+			m_Heap[i] = m_Heap[bestChild];
+			i = bestChild;
+		}
+		HeapElemType elem = m_Heap[n];
+		while (i)
+		{
+			std::size_t parent = (i - 1) / ARITY;
+			if (!(elem.Imp() < m_Heap[parent].Imp()))
+				break;
+			m_Heap[i] = m_Heap[parent];
+			i = parent;
+		}
+		m_Heap[i] = elem;
+		m_Heap.pop_back();
+	}
+
+	void Clear() { m_Heap.clear(); }
+
+private:
+	std::vector<HeapElemType> m_Heap;
+};
+
+// *****************************************************************************
+// radix_heap_policy
+// *****************************************************************************
+
+template <typename ImpType, typename NodeType>
+struct radix_heap_policy
+{
+	static_assert(std::is_integral_v<ImpType>, "radix_heap_policy requires integral impedances");
+
+	using HeapElemType = heapElemType<ImpType, NodeType>;
+	using key_type = std::make_unsigned_t<ImpType>;
+	static constexpr std::size_t NR_BUCKETS = std::numeric_limits<key_type>::digits + 1;
+
+	void Push(NodeType v, ImpType d)
+	{
+		assert(d >= 0);
+		assert(!(key_type(d) < m_Last)); // monotone use
+		m_Buckets[BucketOf(key_type(d))].emplace_back(v, d);
+		++m_Size;
+	}
+
+	bool Empty() const { return !m_Size; }
+
+	// moves the elements with the minimal impedance to bucket 0 if it is empty
+	const HeapElemType& Front()
+	{
+		assert(!Empty());
+		if (m_Buckets[0].empty())
+			Redistribute();
+		return m_Buckets[0].back();
+	}
+
+	void Pop()
+	{
+		if (m_Buckets[0].empty())
+			Redistribute();
+		m_Buckets[0].pop_back();
+		if (!--m_Size)
+			m_Last = 0; // the next run may start with any impedance
+	}
+
+	void Clear()
+	{
+		for (auto& bucket : m_Buckets)
+			bucket.clear();
+		m_Size = 0;
+		m_Last = 0;
+	}
+
+private:
+	// 0 for impedances equal to m_Last, otherwise 1 + the index of the highest bit that differs
+	std::size_t BucketOf(key_type key) const { return std::bit_width(key_type(key ^ m_Last)); }
+
+	void Redistribute()
+	{
+		std::size_t i = 1;
+		while (m_Buckets[i].empty())
+		{
+			++i;
+			assert(i < NR_BUCKETS);
+		}
+		auto& bucket = m_Buckets[i];
+		key_type newLast = key_type(bucket.front().Imp());
+		for (const auto& elem : bucket)
+			newLast = std::min(newLast, key_type(elem.Imp()));
+		m_Last = newLast;
+
+		// all elements of bucket i differ less from the new minimum than from the former one, thus move to lower buckets
+		for (const auto& elem : bucket)
+			m_Buckets[BucketOf(key_type(elem.Imp()))].emplace_back(elem);
+		bucket.clear();
+	}
+
+	std::array<std::vector<HeapElemType>, NR_BUCKETS> m_Buckets;
+	key_type    m_Last = 0;
+	std::size_t m_Size = 0;
+};
+
+// *****************************************************************************
+// dijkstra_heap_policy_t and fast_heap_policy_t
+// *****************************************************************************
+
+template <typename ImpType, typename NodeType>
+using dijkstra_heap_policy_t = binary_heap_policy<ImpType, NodeType>;
+
+template <typename ImpType, typename NodeType>
+using fast_heap_policy_t = std::conditional_t<std::is_integral_v<ImpType>
+	,	radix_heap_policy<ImpType, NodeType>
+	,	quaternary_heap_policy<ImpType, NodeType>
+	>;
+
+#endif //!defined(__GEO_DIJKSTRAHEAPPOLICY_H)
@@ -8,6 +8,10 @@
 #pragma hdrstop
 #endif
 
+#include <atomic>
+#include <chrono>
+#include <unordered_map>
+
 #include "dbg/debug.h"
 #include "dbg/SeverityType.h"
 #include "geo/Pair.h"
@@ -20,6 +24,7 @@
 #include "DataArray.h"
 #include "DisplayValue.h"
 #include "MoreDataControllers.h"
+#include "ParallelTiles.h"
 #include "TreeItemClass.h"
 #include "UnitClass.h"
 
@@ -916,7 +921,7 @@ struct htp_info_t : regions_info_t<AR>, htp_meta_extra<S>
 	htp_info_t(const htp_meta_t<S>& meta)
 		: regions_info_t<AR>{ static_cast<const regions_meta_t&>(meta) }
 		, htp_meta_extra<S>(meta)
-		, m_TreeBuilder(*this), m_Threshold() 
+		, m_Threshold() 
 	{
 		m_ggTypes.reserve(meta.m_ggTypes.size());
 		for (const auto& ggm : meta.m_ggTypes)
@@ -945,6 +950,10 @@ struct htp_info_t : regions_info_t<AR>, htp_meta_extra<S>
 		ggType_info_t<S>& gg = m_ggTypes[j];
 		return m_Claims[SizeT(gg.m_FirstClaimID) + this->GetRegionID(ar, gg.m_PartitioningID)];
 	}
+	const claim<S>& GetClaim(UInt32 ar, AT j) const
+	{ 
+		return const_cast<htp_info_t*>(this)->GetClaim(ar, j);
+	}
 	priority_heap<S>& GetHeap(atomic_region_proxy ar, AT j, AT jj)
 	{
 		assert(ar < this->GetNrAtomicRegions() );
@@ -997,13 +1006,36 @@ struct htp_info_t : regions_info_t<AR>, htp_meta_extra<S>
 	bool            CheckLink   (UInt32 facetID) const;
 
 	// ========== more data members
-	directed_dijkstra<htp_info_t> m_TreeBuilder;
-	std::vector<UInt32>           m_ClaimIdList;
-	land_unit_id                  m_NrBelowThreshold = 0;
+	std::atomic<land_unit_id>     m_NrBelowThreshold = 0;
+
+	// claims that are connected by facets form a component; reallocations never cross components, 
+	// thus the cells and claims of different components can be allocated independently.
+	UInt32                        m_NrComponents = 0;
+	std::vector<UInt32>           m_ClaimComponent;          // 1 per claim
+	std::vector<UInt32>           m_AtomicRegionComponent;   // 1 per atomic region
+	std::vector<UInt32>           m_ComponentClaimIds;       // claim ids ordered by component and id
+	std::vector<UInt32>           m_ComponentFirstClaim;     // 1 per component + 1; index in m_ComponentClaimIds
+};
+
+// *****************************************************************************
+//									htp_worker_t
+// *****************************************************************************
+/// htp_worker_t contains the search state of the splitter updates of one thread that allocates the cells of one or more components
+
+template <typename S, typename AR, typename AT>
+struct htp_worker_t
+{
+	htp_worker_t(const htp_info_t<S, AR, AT>& htpInfo)
+		: m_TreeBuilder(htpInfo)
+	{}
+
+	directed_dijkstra<htp_info_t<S, AR, AT>> m_TreeBuilder;
+	std::vector<UInt32>                      m_ClaimIdList;
+	UInt32                                   m_NrSplits = 0;
 
 #if defined(MG_DEBUG)
 	bool CanReportFindMstDown() { return (++md_ReportFindMstDownCounter < 10) || PowerOf2(md_ReportFindMstDownCounter); }
-	UInt32                                md_ReportFindMstDownCounter;
+	UInt32                                   md_ReportFindMstDownCounter = 0;
 #endif
 };
 
@@ -1918,15 +1950,16 @@ void PrepareFacets(htp_info_t<S, AR, AT>& htpInfo)
 
 	htpInfo.m_FacetIds.reserve(SizeT(nrAtomicRegions) * K * K);
 
-	typedef std::pair<claim<S>*, claim<S>*> claim_pair;
-
-	std::map<claim_pair, UInt32> allocatedQueIds;
+	// heap ids are assigned in order of first encounter; the claim pair is keyed by both claim ids
+	std::unordered_map<UInt64, UInt32> allocatedQueIds;
+	allocatedQueIds.reserve(SizeT(htpInfo.m_Claims.size()) * K);
 
 	for (UInt32 ar = 0; ar != nrAtomicRegions; ++ar)
 	{
 		for (UInt32 j=0; j !=K; ++j)
 		{
 			claim<S>* claimJ = &htpInfo.GetClaim(ar, j);
+			UInt64 claimIdJ = claimJ - begin_ptr(htpInfo.m_Claims);
 			for (UInt32 jj=0; jj!=K; ++jj) 
 			{
 				if (jj == j)
@@ -1934,40 +1967,96 @@ void PrepareFacets(htp_info_t<S, AR, AT>& htpInfo)
 				else
 				{
 					claim<S>* claimJJ = &htpInfo.GetClaim(ar, jj);
-					claim_pair claimPair(claimJ, claimJJ);
-					if (allocatedQueIds.find(claimPair) == allocatedQueIds.end())
+					UInt64 claimIdJJ = claimJJ - begin_ptr(htpInfo.m_Claims);
+					auto [queIdPtr, isNew] = allocatedQueIds.try_emplace((claimIdJ << 32) | claimIdJJ, htpInfo.m_Facets.size());
+					if (isNew)
 					{
-						UInt32 heapID = htpInfo.m_Facets.size();
-						allocatedQueIds[claimPair] = heapID;
 						htpInfo.m_Facets.push_back(
 							priority_heap<S>(
-								heapID, 
+								queIdPtr->second,
 								claimJ, claimJJ, 
 								htpInfo.m_ggTypes[ j].m_Suitabilities.begin(), 
 								htpInfo.m_ggTypes[jj].m_Suitabilities.begin()
 							)
 						);
 					}
-					htpInfo.m_FacetIds.push_back(allocatedQueIds[claimPair]);
+					htpInfo.m_FacetIds.push_back(queIdPtr->second);
 				}
 			}
 		}
 	}
 }
 
+// determines the components of the graph of claims and facets, numbered in order of their smallest claim id
+template <typename S, typename AR, typename AT>
+void PrepareComponents(htp_info_t<S, AR, AT>& htpInfo)
+{
+	UInt32 nrClaims = htpInfo.GetNrNodes();
+
+	std::vector<UInt32> parent(nrClaims);
+	for (UInt32 c = 0; c != nrClaims; ++c)
+		parent[c] = c;
+	auto findRoot = [&parent](UInt32 c)
+		{
+			while (parent[c] != c)
+				c = parent[c] = parent[parent[c]];
+			return c;
+		};
+	for (UInt32 facetID = 0, nrFacets = htpInfo.GetNrLinks(); facetID != nrFacets; ++facetID)
+	{
+		UInt32 srcRoot = findRoot(htpInfo.GetSrcNode(facetID, dir_forward_tag()));
+		UInt32 dstRoot = findRoot(htpInfo.GetDstNode(facetID, dir_forward_tag()));
+		if (srcRoot < dstRoot)
+			parent[dstRoot] = srcRoot;
+		else
+			parent[srcRoot] = dstRoot;
+	}
+
+	htpInfo.m_ClaimComponent.resize(nrClaims);
+	htpInfo.m_NrComponents = 0;
+	std::vector<UInt32> componentSizes;
+	for (UInt32 c = 0; c != nrClaims; ++c)
+	{
+		UInt32 root = findRoot(c);
+		if (root == c) // roots are the smallest claim id of their component
+		{
+			htpInfo.m_ClaimComponent[c] = htpInfo.m_NrComponents++;
+			componentSizes.emplace_back(0);
+		}
+		else
+			htpInfo.m_ClaimComponent[c] = htpInfo.m_ClaimComponent[root];
+		++componentSizes[htpInfo.m_ClaimComponent[c]];
+	}
+
+	htpInfo.m_ComponentFirstClaim.assign(1, 0);
+	for (UInt32 size: componentSizes)
+		htpInfo.m_ComponentFirstClaim.emplace_back(htpInfo.m_ComponentFirstClaim.back() + size);
+	htpInfo.m_ComponentClaimIds.resize(nrClaims);
+	std::vector<UInt32> componentPos(htpInfo.m_ComponentFirstClaim.begin(), htpInfo.m_ComponentFirstClaim.end() - 1);
+	for (UInt32 c = 0; c != nrClaims; ++c)
+		htpInfo.m_ComponentClaimIds[componentPos[htpInfo.m_ClaimComponent[c]]++] = c;
+
+	// all claims of an atomic region are connected by its facets
+	UInt32 nrAtomicRegions = htpInfo.GetK() ? htpInfo.GetNrAtomicRegions() : 0;
+	htpInfo.m_AtomicRegionComponent.resize(nrAtomicRegions);
+	for (UInt32 ar = 0; ar != nrAtomicRegions; ++ar)
+		htpInfo.m_AtomicRegionComponent[ar] = htpInfo.m_ClaimComponent[&htpInfo.GetClaim(ar, 0) - begin_ptr(htpInfo.m_Claims)];
+}
+
 template <typename S, typename AR, typename AT>
 void PrepareReport(htp_info_t<S, AR, AT>& htpInfo)
 {
 	reportF(SeverityTypeID::ST_MajorTrace, "DiscrAlloc: Prepare created alloc structs for "
 		"%u cells, %u landuse types, %u (min-max) claims, %u unique partitionings, "
-		"%u atomic regions, %u unique regions, and %u priority queues",
+		"%u atomic regions, %u unique regions, %u priority queues, and %u independent components",
 		htpInfo.GetN(), 
 		htpInfo.GetK(), 
 		htpInfo.GetNrNodes(), 
 		htpInfo.GetNrPartitionings(), 
 		htpInfo.GetNrAtomicRegions(), 
 		htpInfo.GetNrUniqueRegions(), 
-		htpInfo.GetNrLinks()
+		htpInfo.GetNrLinks(),
+		htpInfo.m_NrComponents
 	);
 #if defined(MG_DEBUG)
 	UInt32 K  = htpInfo.GetK();
@@ -2018,6 +2107,7 @@ void RemoveLoserInResultAndCleanupQueues(htp_info_t<S, AR, AT>& htpInfo
 template <typename S, typename AR, typename AT>
 void InsertWinnerInResultAndReallocQueues(
 	htp_info_t<S, AR, AT>& htpInfo
+,	const htp_worker_t<S, AR, AT>& worker
 ,	typename htp_info_t<S, AR, AT>::atomic_region_proxy ar
 ,	land_unit_id i
 ,	AT winning_ggTypeID)
@@ -2026,8 +2116,8 @@ void InsertWinnerInResultAndReallocQueues(
 
 	UInt32 currNode = &(htpInfo.GetClaim(ar, winning_ggTypeID)) - begin_ptr( htpInfo.m_Claims );
 
-	dms_assert(!htpInfo.m_ClaimIdList.size()           // indicator for active MST => being called from UpdateSplitterDown or Up
-		||	htpInfo.m_TreeBuilder.is_flagged(currNode) // from UpdateSplitter, currNode is in the migration path; thus connection with source exists
+	dms_assert(!worker.m_ClaimIdList.size()           // indicator for active MST => being called from UpdateSplitterDown or Up
+		||	worker.m_TreeBuilder.is_flagged(currNode) // from UpdateSplitter, currNode is in the migration path; thus connection with source exists
 	);
 
 	UInt32 K = htpInfo.m_ggTypes.size();
@@ -2058,17 +2148,17 @@ void InsertWinnerInResultAndReallocQueues(
 			);
 			
 			std::vector<UInt32>::const_iterator
-				claimIdPtr = htpInfo.m_ClaimIdList.begin(),
-				claimIdEnd = htpInfo.m_ClaimIdList.end();
+				claimIdPtr = worker.m_ClaimIdList.begin(),
+				claimIdEnd = worker.m_ClaimIdList.end();
 			while (claimIdPtr != claimIdEnd)
 			{
-				UInt32 facetID = htpInfo.m_TreeBuilder.get_traceback(*claimIdPtr).Link();
+				UInt32 facetID = worker.m_TreeBuilder.get_traceback(*claimIdPtr).Link();
 				DBG_TRACE(("%s$%s, reached by Link[%u](%s,%s) was incremented by $%s",
 						htpInfo.GetClaimRangeStr(htpInfo.m_Claims[*claimIdPtr]).c_str(), AsString(htpInfo.m_Claims[*claimIdPtr].m_ShadowPrice).c_str(),
 						facetID,
 						htpInfo.GetClaimRangeStr(htpInfo.m_Claims[htpInfo.GetSrcNode(facetID, dir_forward_tag())]).c_str(),
 						htpInfo.GetClaimRangeStr(htpInfo.m_Claims[htpInfo.GetDstNode(facetID, dir_forward_tag())]).c_str(),
-						AsString(htpInfo.m_TreeBuilder.get_traceback(*claimIdPtr).Cost()).c_str()
+						AsString(worker.m_TreeBuilder.get_traceback(*claimIdPtr).Cost()).c_str()
 					)
 				);
 				dms_assert( htpInfo.m_Facets[facetID].empty() || htpInfo.CheckLink(facetID) );
@@ -2110,6 +2200,7 @@ void InsertWinnerInResultAndReallocQueues(
 template <typename S, typename AR, typename AT>
 UInt32 FindMstDown(
 	htp_info_t<S, AR, AT>&                     htpInfo, 
+	htp_worker_t<S, AR, AT>&                   worker,
 	UInt32                                     rootClaimID,
 	typename htp_info_t<S, AR, AT>::cost_type& minLinkCost //cost until dst of (free)link; thus including GetLinkCost(currLink)
 )
@@ -2118,10 +2209,10 @@ UInt32 FindMstDown(
 
 	UInt32 minLink = UNDEFINED_VALUE(UInt32); // corresponds with given minLinkCost if not INF.
 
-	htpInfo.m_TreeBuilder.init_tree(rootClaimID, dir_forward_tag() ); // calls fix_node and brings all outgoing links in queue
+	worker.m_TreeBuilder.init_tree(rootClaimID, dir_forward_tag() ); // calls fix_node and brings all outgoing links in queue
 
 #if defined(MG_DEBUG)
-	if (htpInfo.m_TreeBuilder.empty() && htpInfo.CanReportFindMstDown() )
+	if (worker.m_TreeBuilder.empty() && worker.CanReportFindMstDown() )
 	{
 		reportF(SeverityTypeID::ST_MajorTrace, "FindMstDown: no adjustments possible for %s",
 				htpInfo.GetClaimRangeStr( htpInfo.m_Claims[rootClaimID] ) .c_str()
@@ -2129,17 +2220,17 @@ UInt32 FindMstDown(
 	}
 #endif
 
-	dms_assert( htpInfo.m_ClaimIdList.empty());
+	dms_assert( worker.m_ClaimIdList.empty());
 
 	while (true)
 	{
-		if (!htpInfo.m_TreeBuilder.get_next( dir_forward_tag() ))
+		if (!worker.m_TreeBuilder.get_next( dir_forward_tag() ))
 		{
 			DBG_TRACE(("FindMstDown reached EndOfHeap without finding free claim"));
 			return UNDEFINED_VALUE(UInt32); // no free claim found
 		}
 
-		const directed_heap_elem<typename htp_info_t<S, AR, AT>::cost_type>& currElem = htpInfo.m_TreeBuilder.top(); 
+		const directed_heap_elem<typename htp_info_t<S, AR, AT>::cost_type>& currElem = worker.m_TreeBuilder.top(); 
 
 		UInt32 currLink = currElem.Link();
 		auto   linkCost = currElem.Cost(); //cost until dst of link; thus including GetLinkCost(currLink)
@@ -2170,15 +2261,15 @@ UInt32 FindMstDown(
 				currLink)
 			);
 
-			htpInfo.m_TreeBuilder.add_node(dstNode, currLink, linkCost ); 
-			htpInfo.m_ClaimIdList.push_back(dstNode); // maintain ordered built MST for splitter adjustments
+			worker.m_TreeBuilder.add_node(dstNode, currLink, linkCost ); 
+			worker.m_ClaimIdList.push_back(dstNode); // maintain ordered built MST for splitter adjustments
 			dms_assert( IsDefined(currLink) ); // we did check that feasible solution exists
 
 			minLinkCost = linkCost;
 			return currLink;
 		}
 
-		htpInfo.m_TreeBuilder.pop_node();
+		worker.m_TreeBuilder.pop_node();
 
 		dms_assert( htpInfo.CheckLink(currLink) );
 
@@ -2197,8 +2288,8 @@ UInt32 FindMstDown(
 		));
 		
 
-		htpInfo.m_TreeBuilder.fix_link(	currLink, linkCost, dir_forward_tag() );         // bring all links from the destination of currLink into queue for further processing
-		htpInfo.m_ClaimIdList.push_back( dstNode ); // maintain ordered built MST for splitter adjustments
+		worker.m_TreeBuilder.fix_link(	currLink, linkCost, dir_forward_tag() );         // bring all links from the destination of currLink into queue for further processing
+		worker.m_ClaimIdList.push_back( dstNode ); // maintain ordered built MST for splitter adjustments
 
 		dms_assert( htpInfo.CheckLink(currLink) );
 	}
@@ -2207,6 +2298,7 @@ UInt32 FindMstDown(
 template <typename S, typename AR, typename AT>
 UInt32 FindMstUp(
 	htp_info_t<S, AR, AT>&                     htpInfo, 
+	htp_worker_t<S, AR, AT>&                   worker,
 	UInt32                                     rootClaimID,
 	typename htp_info_t<S, AR, AT>::cost_type& minLinkCost //cost until dst of (free)link; thus including GetLinkCost(currLink)
 )
@@ -2215,10 +2307,10 @@ UInt32 FindMstUp(
 
 	UInt32 minLink = UNDEFINED_VALUE(UInt32); // corresponds with given minLinkCost if not INF.
 
-	htpInfo.m_TreeBuilder.init_tree(rootClaimID, dir_backward_tag() ); // calls fix_node and brings all outgoing links in queue
+	worker.m_TreeBuilder.init_tree(rootClaimID, dir_backward_tag() ); // calls fix_node and brings all outgoing links in queue
 
 #if defined(MG_DEBUG)
-	if (htpInfo.m_TreeBuilder.empty())
+	if (worker.m_TreeBuilder.empty())
 	{
 		reportF(SeverityTypeID::ST_MajorTrace, "FindMstUp: no adjustments possible for %s",
 				htpInfo.GetClaimRangeStr( htpInfo.m_Claims[rootClaimID] ).c_str()
@@ -2226,17 +2318,17 @@ UInt32 FindMstUp(
 	}
 #endif
 
-	dms_assert( htpInfo.m_ClaimIdList.empty());
+	dms_assert( worker.m_ClaimIdList.empty());
 
 	while ( true )
 	{
-		if (!htpInfo.m_TreeBuilder.get_next( dir_backward_tag() ))
+		if (!worker.m_TreeBuilder.get_next( dir_backward_tag() ))
 		{
 			DBG_TRACE(("FindMstUp reached EndOfHeap without finding free claim"));
 			return UNDEFINED_VALUE(UInt32); // no free claim found
 		}
 
-		const directed_heap_elem<typename htp_info_t<S, AR, AT>::cost_type>& currElem = htpInfo.m_TreeBuilder.top(); 
+		const directed_heap_elem<typename htp_info_t<S, AR, AT>::cost_type>& currElem = worker.m_TreeBuilder.top(); 
 
 		UInt32 currLink = currElem.Link();
 		auto   linkCost = currElem.Cost(); //cost until dst of link; thus including GetLinkCost(currLink)
@@ -2268,15 +2360,15 @@ UInt32 FindMstUp(
 				currLink)
 			);
 
-			htpInfo.m_TreeBuilder.add_node(srcNode, currLink, linkCost ); 
-			htpInfo.m_ClaimIdList.push_back(srcNode); // maintain ordered built MST for splitter adjustments
+			worker.m_TreeBuilder.add_node(srcNode, currLink, linkCost ); 
+			worker.m_ClaimIdList.push_back(srcNode); // maintain ordered built MST for splitter adjustments
 			dms_assert( IsDefined(currLink) ); // we did check that feasible solution exists
 
 			minLinkCost = linkCost;
 			return currLink;
 		}
 
-		htpInfo.m_TreeBuilder.pop_node();
+		worker.m_TreeBuilder.pop_node();
 
 		dms_assert( htpInfo.CheckLink(currLink) );
 
@@ -2296,16 +2388,16 @@ UInt32 FindMstUp(
 		));
 		
 
-		htpInfo.m_TreeBuilder.fix_link(	currLink, linkCost, dir_backward_tag() );         // bring all links from the destination of currLink into queue for further processing
+		worker.m_TreeBuilder.fix_link(	currLink, linkCost, dir_backward_tag() );         // bring all links from the destination of currLink into queue for further processing
 
-		htpInfo.m_ClaimIdList.push_back( srcNode ); // maintain ordered built MST for splitter adjustments
+		worker.m_ClaimIdList.push_back( srcNode ); // maintain ordered built MST for splitter adjustments
 
 		dms_assert( htpInfo.CheckLink(currLink) );
 	}
 }
 
 template <typename S, typename AR, typename AT>
-bool UpdateSplitterDown(htp_info_t<S, AR, AT>& htpInfo, claim<S>& root)
+bool UpdateSplitterDown(htp_info_t<S, AR, AT>& htpInfo, htp_worker_t<S, AR, AT>& worker, claim<S>& root)
 {
 	DBG_START("DiscrAllocCells", "UpdateSplitterDown", DMS_DEBUG_DISCRALLOC);
 
@@ -2330,7 +2422,7 @@ bool UpdateSplitterDown(htp_info_t<S, AR, AT>& htpInfo, claim<S>& root)
 		DBG_TRACE( ("SrcClaim is over lowerbound with positive price reduction possible") );
 	}
 
-	UInt32 freeLink = FindMstDown(htpInfo, rootClaimID, freeClaimCost);
+	UInt32 freeLink = FindMstDown(htpInfo, worker, rootClaimID, freeClaimCost);
 
 	if (freeClaimCost == MAX_VALUE(shadow_price<S>))
 		return false;
@@ -2345,10 +2437,10 @@ bool UpdateSplitterDown(htp_info_t<S, AR, AT>& htpInfo, claim<S>& root)
 	// laat schadowprijs van target stijgen op basis van (Ga - Gb) = (Qa - Qb)  
 	//	=>  Gb := Ga - (Qa - Qb) = Ga + c, want c = -(Qa - Qb)
 
-	for (auto claimIdPtr = htpInfo.m_ClaimIdList.begin(), claimIdEnd = htpInfo.m_ClaimIdList.end(); claimIdPtr != claimIdEnd; ++claimIdPtr)
+	for (auto claimIdPtr = worker.m_ClaimIdList.begin(), claimIdEnd = worker.m_ClaimIdList.end(); claimIdPtr != claimIdEnd; ++claimIdPtr)
 	{
 		const directed_heap_elem<shadow_price<S> >& traceBack = 
-			htpInfo.m_TreeBuilder.get_traceback(*claimIdPtr);
+			worker.m_TreeBuilder.get_traceback(*claimIdPtr);
 
 		priority_heap<S>& ph = htpInfo.m_Facets[traceBack.Link()];
 
@@ -2371,8 +2463,8 @@ bool UpdateSplitterDown(htp_info_t<S, AR, AT>& htpInfo, claim<S>& root)
 	
 #if defined(MG_DEBUG) // DEBUG BEGIN: check that all claimIds are still valid 
 	{
-		for (auto claimIdPtr = htpInfo.m_ClaimIdList.begin(), claimIdEnd = htpInfo.m_ClaimIdList.end(); claimIdPtr != claimIdEnd; ++claimIdPtr)
-			dms_assert( htpInfo.CheckLink(htpInfo.m_TreeBuilder.get_traceback(*claimIdPtr).Link()) );
+		for (auto claimIdPtr = worker.m_ClaimIdList.begin(), claimIdEnd = worker.m_ClaimIdList.end(); claimIdPtr != claimIdEnd; ++claimIdPtr)
+			dms_assert( htpInfo.CheckLink(worker.m_TreeBuilder.get_traceback(*claimIdPtr).Link()) );
 	}
 #endif	// DEBUG END
 
@@ -2397,14 +2489,14 @@ bool UpdateSplitterDown(htp_info_t<S, AR, AT>& htpInfo, claim<S>& root)
 
 		dms_assert(
 			std::find(
-				htpInfo.m_ClaimIdList.begin(), 
-				htpInfo.m_ClaimIdList.end(), 
+				worker.m_ClaimIdList.begin(), 
+				worker.m_ClaimIdList.end(), 
 				htpInfo.GetDstNode(freeLink, dir_forward_tag() )
-			) != htpInfo.m_ClaimIdList.end()
+			) != worker.m_ClaimIdList.end()
 		);
 
 		dms_assert(
-			htpInfo.m_TreeBuilder.get_traceback(
+			worker.m_TreeBuilder.get_traceback(
 				htpInfo.GetDstNode(freeLink, dir_forward_tag() ) 
 			).Link() 
 			== freeLink
@@ -2423,7 +2515,7 @@ bool UpdateSplitterDown(htp_info_t<S, AR, AT>& htpInfo, claim<S>& root)
 		assert(htpInfo.m_ResultArray[i] == ggTypeIdSrc); ph.m_SourceClaim->m_Count--;
 		auto ar = htpInfo.GetAtomicRegionID(i);
 		RemoveLoserInResultAndCleanupQueues <S, AR, AT>(htpInfo, ar, i, ggTypeIdSrc);
-		InsertWinnerInResultAndReallocQueues<S, AR, AT>(htpInfo, ar, i, ggTypeIdDst);
+		InsertWinnerInResultAndReallocQueues<S, AR, AT>(htpInfo, worker, ar, i, ggTypeIdDst);
 		assert(htpInfo.m_ResultArray[i] == ggTypeIdDst); ph.m_TargetClaim->m_Count++;
 		
 #if defined(MG_DEBUG)
@@ -2444,14 +2536,14 @@ bool UpdateSplitterDown(htp_info_t<S, AR, AT>& htpInfo, claim<S>& root)
 
 		dms_assert( ph.empty() || htpInfo.CheckLink(freeLink) ); 
 
-		freeLink = htpInfo.m_TreeBuilder.get_traceback(htpInfo.GetSrcNode(freeLink, dir_forward_tag() )).Link();
+		freeLink = worker.m_TreeBuilder.get_traceback(htpInfo.GetSrcNode(freeLink, dir_forward_tag() )).Link();
 	}
 
 	return true;
 }
 
 template <typename S, typename AR, typename AT>
-bool UpdateSplitterUp(htp_info_t<S, AR, AT>& htpInfo, claim<S>& root)
+bool UpdateSplitterUp(htp_info_t<S, AR, AT>& htpInfo, htp_worker_t<S, AR, AT>& worker, claim<S>& root)
 {
 	DBG_START("DiscrAllocMinClaims", "UpdateSplitterUp", DMS_DEBUG_DISCRALLOC);
 
@@ -2474,7 +2566,7 @@ bool UpdateSplitterUp(htp_info_t<S, AR, AT>& htpInfo, claim<S>& root)
 		DBG_TRACE( ("SrcClaim is over lowerbound with positive price reduction possible") );
 	}
 
-	UInt32 freeLink = FindMstUp(htpInfo, rootClaimID, freeClaimCost);
+	UInt32 freeLink = FindMstUp(htpInfo, worker, rootClaimID, freeClaimCost);
 
 	if (freeClaimCost == MAX_VALUE(shadow_price<S>))
 		return false;
@@ -2490,12 +2582,12 @@ bool UpdateSplitterUp(htp_info_t<S, AR, AT>& htpInfo, claim<S>& root)
 	//	=>  Gb := Ga - (Qa - Qb) = Ga + c, want c = -(Qa - Qb)
 
 	std::vector<UInt32>::const_iterator
-		claimIdPtr = htpInfo.m_ClaimIdList.begin(),
-		claimIdEnd = htpInfo.m_ClaimIdList.end();
+		claimIdPtr = worker.m_ClaimIdList.begin(),
+		claimIdEnd = worker.m_ClaimIdList.end();
 	while (claimIdPtr != claimIdEnd)
 	{
 		const directed_heap_elem<shadow_price<S> >& traceBack = 
-			htpInfo.m_TreeBuilder.get_traceback(*claimIdPtr++);
+			worker.m_TreeBuilder.get_traceback(*claimIdPtr++);
 
 		priority_heap<S>& ph = htpInfo.m_Facets[traceBack.Link()];
 
@@ -2519,8 +2611,8 @@ bool UpdateSplitterUp(htp_info_t<S, AR, AT>& htpInfo, claim<S>& root)
 
 #if defined(MG_DEBUG) // DEBUG BEGIN: check that all claimIds are still valid 
 	{
-		for (auto claimId: htpInfo.m_ClaimIdList)
-			dms_assert( htpInfo.CheckLink(htpInfo.m_TreeBuilder.get_traceback(claimId).Link()) );
+		for (auto claimId: worker.m_ClaimIdList)
+			dms_assert( htpInfo.CheckLink(worker.m_TreeBuilder.get_traceback(claimId).Link()) );
 	}
 #endif	// DEBUG END
 
@@ -2547,14 +2639,14 @@ bool UpdateSplitterUp(htp_info_t<S, AR, AT>& htpInfo, claim<S>& root)
 
 		dms_assert(
 			std::find(
-				htpInfo.m_ClaimIdList.begin(), 
-				htpInfo.m_ClaimIdList.end(), 
+				worker.m_ClaimIdList.begin(), 
+				worker.m_ClaimIdList.end(), 
 				htpInfo.GetDstNode(freeLink, dir_backward_tag() )
-			) != htpInfo.m_ClaimIdList.end()
+			) != worker.m_ClaimIdList.end()
 		); 
 
 		dms_assert(
-			htpInfo.m_TreeBuilder.get_traceback(
+			worker.m_TreeBuilder.get_traceback(
 				htpInfo.GetDstNode(freeLink, dir_backward_tag() ) 
 			).Link() 
 			== freeLink
@@ -2573,7 +2665,7 @@ bool UpdateSplitterUp(htp_info_t<S, AR, AT>& htpInfo, claim<S>& root)
 		assert(htpInfo.m_ResultArray[i] == ggTypeIdSrc); ph.m_SourceClaim->m_Count--;
 		auto ar = htpInfo.GetAtomicRegionID(i);
 		RemoveLoserInResultAndCleanupQueues <S, AR, AT>(htpInfo, ar, i, ggTypeIdSrc);
-		InsertWinnerInResultAndReallocQueues<S, AR, AT>(htpInfo, ar, i, ggTypeIdDst);
+		InsertWinnerInResultAndReallocQueues<S, AR, AT>(htpInfo, worker, ar, i, ggTypeIdDst);
 		assert(htpInfo.m_ResultArray[i] == ggTypeIdDst); ph.m_TargetClaim->m_Count++;
 		
 //		dms_assert(!ph.m_TargetClaim->Overflow()); target will be relaxed in next pull
@@ -2588,7 +2680,7 @@ bool UpdateSplitterUp(htp_info_t<S, AR, AT>& htpInfo, claim<S>& root)
 
 		assert( ph.empty() || htpInfo.CheckLink(freeLink) ); 
 
-		freeLink = htpInfo.m_TreeBuilder.get_traceback(htpInfo.GetSrcNode(freeLink, dir_backward_tag() )).Link();
+		freeLink = worker.m_TreeBuilder.get_traceback(htpInfo.GetSrcNode(freeLink, dir_backward_tag() )).Link();
 	}
 
 	return true;
@@ -2784,147 +2876,361 @@ void DiscrAllocEnd(htp_info_t<S, AR, AT>& htpInfo, UInt32 currI)
 	);
 }
 
+// returns the ggType with the highest bid for cell i at the current shadow prices, or UNDEFINED if all suitabilities are below the threshold
 template <typename S, typename AR, typename AT>
-void DiscrAllocCells(htp_info_t<S, AR, AT>& htpInfo, UInt32 currI, UInt32 nextI)
+UInt32 GetHighestBidder(const htp_info_t<S, AR, AT>& htpInfo, typename htp_info_t<S, AR, AT>::atomic_region_proxy ar, land_unit_id i)
 {
-	DiscrAllocCellsBegin(htpInfo, nextI);
+	UInt32 highestBidder = UNDEFINED_VALUE(UInt32);
+	shadow_price<S> highestBid = MIN_VALUE(shadow_price<S>);
 
-	land_unit_id N = htpInfo.m_N;
-	UInt32 K = htpInfo.GetK();
-	UInt32 rapFreq = 1000000, tmpK = K; while (tmpK > 3 && rapFreq > 100)  { rapFreq /= 10; tmpK /= 10; }
+	perturbation_type c = 0;
 
-	if constexpr (!std::is_same_v<AR, Void>)
+	for(UInt32 j=0, K = htpInfo.GetK(); j!=K; ++j, c += i)
 	{
-		assert(htpInfo.m_AtomicRegionMapData.size() == N);
-		assert(htpInfo.m_ResultArray.size() == N);
+		S s = htpInfo.m_ggTypes[j].m_Suitabilities[i];
+		if (s < htpInfo.m_Threshold) continue;
+		shadow_price<S> bid = htpInfo.GetClaim(ar, j).m_ShadowPrice;
+		                bid.first  += s;
+		                bid.second += c; // small pertubation (SoS) for making a difference between similar cells
+
+		if (highestBid < bid)
+		{
+			highestBid    = bid;
+			highestBidder = j;
+		}
+	}
+	return highestBidder;
+}
+
+// inserts cell i into the solution for highestBidder and moves if facing claim-restriction; 
+// returns true if the splitter was updated, which invalidates the bids of other cells as shadow prices changed
+template <typename S, typename AR, typename AT>
+bool AllocCell(htp_info_t<S, AR, AT>& htpInfo, htp_worker_t<S, AR, AT>& worker
+,	typename htp_info_t<S, AR, AT>::atomic_region_proxy ar
+,	land_unit_id i
+,	UInt32 highestBidder)
+{
+	if (highestBidder == UNDEFINED_VALUE(UInt32) )
+	{
+		if (++htpInfo.m_NrBelowThreshold <= NR_BELOW_THRESHOLD_NOTIFICATIONS)
+			reportF(SeverityTypeID::ST_MajorTrace, "DiscrAllocCells: all suitabilities of cell %u are below the threshold %d",
+				i, htpInfo.m_Threshold
+			); 
+		htpInfo.m_ResultArray[i] = UNDEFINED_VALUE(AT);
+		return false;
 	}
 
-	UInt32 d_nrSplits = 0;
+	InsertWinnerInResultAndReallocQueues<S, AR, AT>(htpInfo, worker, ar, i, highestBidder);
+
+	// Update total and move if facing claim-restriction
+	claim<S>& claim = htpInfo.GetClaim(ar, highestBidder);
+	++ claim.m_Count;
+	if (!claim.Overflow() )
+		return false;
 
-	for( ; currI < nextI; htpInfo.GetNextPermutationValue(), ++currI)
+	bool ok = UpdateSplitterDown(htpInfo, worker, claim);
+	worker.m_ClaimIdList.clear();
+	worker.m_NrSplits++;
+
+	if (!ok)
 	{
-		assert(htpInfo.m_CurrPI < htpInfo.m_N);
-		auto ar = htpInfo.GetAtomicRegionID( htpInfo.m_CurrPI );
-		assert(ar < htpInfo.GetNrAtomicRegions()); // guaranteed by IncrementAtomicRegionCount
-//		assert(!IsDefined(htpInfo.m_ResultArray[htpInfo.m_CurrPI]));
+		dms_assert(claim.m_Count > claim.m_ClaimRange.second);
+		SizeT excess = claim.m_Count - claim.m_ClaimRange.second;
+		if (PowerOf2(excess)) // only report power of 2 excess to limit quadratic behaviour of event log listbox and errors after 1000000 lines
+			reportF(SeverityTypeID::ST_MajorTrace,
+				"DiscrAlloc Warning: UpdateSplitterDown(%s) failed; now %u allocated",
+				htpInfo.GetClaimRangeStr( claim ).c_str(),
+				claim.m_Count
+		); 
+	}
+	#if defined(MG_DEBUG)
+		if (htpInfo.m_NrComponents <= 1 && worker.m_NrSplits % 20000 == 0) // other components can be in progress
+			CheckAllLinks(htpInfo);
+	#endif
+	return true;
+}
 
-		UInt32 highestBidder = UNDEFINED_VALUE(UInt32);
-		shadow_price<S> highestBid = MIN_VALUE(shadow_price<S>);
+const SizeT MIN_BID_BLOCK_SIZE = 1024;
+const SizeT MAX_BID_BLOCK_SIZE = 1 << 20;
+const SizeT BID_CHUNK_SIZE     = 16384;
+const UInt32 PROGRESS_BATCH_SIZE = 4096;
 
-		perturbation_type c = 0;
+// the number of cells between progress reports, fewer for more types as each cell takes longer
+UInt32 ProgressReportFrequency(UInt32 K)
+{
+	UInt32 rapFreq = 1000000, tmpK = K; while (tmpK > 3 && rapFreq > 100)  { rapFreq /= 10; tmpK /= 10; }
+	return rapFreq;
+}
 
-		for(UInt32 j=0; j!=K; ++j, c += htpInfo.m_CurrPI)
+// allocates the cells to their bidders in the given order up to the first cell that would cause a claim overflow and returns their number.
+// The counts of the claims are updated in that order; thereafter, the cells are inserted in the priority queues of their facets in parallel per winning type,
+// as the facets of the claims of a winning type, i.e. the queues that InsertWinnerInResultAndReallocQueues adds to, differ per winning type.
+// Each queue thus receives its cells in the same order as when the cells would be allocated one by one.
+template <typename S, typename AR, typename AT>
+SizeT AllocCellsBeforeOverflow(htp_info_t<S, AR, AT>& htpInfo, htp_worker_t<S, AR, AT>& worker, const land_unit_id* cells, const UInt32* bidders, SizeT nrCells)
+{
+	assert(worker.m_ClaimIdList.empty());
+	SizeT n = 0;
+	for (; n != nrCells; ++n)
+	{
+		land_unit_id i = cells[n];
+		if (bidders[n] == UNDEFINED_VALUE(UInt32))
 		{
-			S s = htpInfo.m_ggTypes[j].m_Suitabilities[htpInfo.m_CurrPI];
-			if (s < htpInfo.m_Threshold) continue;
-			shadow_price<S> bid = htpInfo.GetClaim(ar, j).m_ShadowPrice;
-			                bid.first  += s;
-			                bid.second += c; // small pertubation (SoS) for making a difference between similar cells
-
-			if (highestBid < bid)
-			{
-				highestBid    = bid;
-				highestBidder = j;
-			}
+			AllocCell(htpInfo, worker, htpInfo.GetAtomicRegionID(i), i, bidders[n]);
+			continue;
 		}
+		claim<S>& claim = htpInfo.GetClaim(htpInfo.GetAtomicRegionID(i), bidders[n]);
+		++claim.m_Count;
+		if (claim.Overflow())
+		{
+			--claim.m_Count; // left to AllocCell, which updates the splitter
+			break;
+		}
+	}
 
-		// insert highestBidder into solution and queues
-		if (highestBidder == UNDEFINED_VALUE(UInt32) )
+	parallel_for<UInt32>(htpInfo.GetK(), [&](UInt32 winner)
 		{
-			++htpInfo.m_NrBelowThreshold;
-			if (htpInfo.m_NrBelowThreshold <= NR_BELOW_THRESHOLD_NOTIFICATIONS)
-				reportF(SeverityTypeID::ST_MajorTrace, "DiscrAllocCells: all suitabilities of cell %u are below the threshold %d",
-					htpInfo.m_CurrPI, htpInfo.m_Threshold
-				); 
-			htpInfo.m_ResultArray[htpInfo.m_CurrPI] = UNDEFINED_VALUE(AT);
-			continue;
+			for (SizeT k = 0; k != n; ++k)
+				if (bidders[k] == winner)
+					InsertWinnerInResultAndReallocQueues<S, AR, AT>(htpInfo, worker, htpInfo.GetAtomicRegionID(cells[k]), cells[k], AT(winner));
 		}
+	);
+	return n;
+}
+
+// allocates the cells currI..nextI of the permutation in blocks. 
+// The bids of a block are determined in parallel at the shadow prices at the start of the block, 
+// which remain valid until the first splitter update; the bids of the remaining cells of that block are then redetermined one by one.
+// The block size adapts to the number of cells between splitter updates; results don't depend on it.
+template <typename S, typename AR, typename AT>
+void DiscrAllocCells(htp_info_t<S, AR, AT>& htpInfo, htp_worker_t<S, AR, AT>& worker, UInt32 currI, UInt32 nextI)
+{
+	land_unit_id N = htpInfo.m_N;
+	UInt32 rapFreq = ProgressReportFrequency(htpInfo.GetK());
 
-		InsertWinnerInResultAndReallocQueues<S, AR, AT>(htpInfo, ar, htpInfo.m_CurrPI, highestBidder);
+	if constexpr (!std::is_same_v<AR, Void>)
+	{
+		assert(htpInfo.m_AtomicRegionMapData.size() == N);
+		assert(htpInfo.m_ResultArray.size() == N);
+	}
 
-		// Update total and move if facing claim-restriction
-		claim<S>& claim = htpInfo.GetClaim(ar, highestBidder);
-		++ claim.m_Count;
-		if ( claim.Overflow() )
+	std::vector<land_unit_id> blockCells;
+	std::vector<UInt32>       blockBidders;
+	SizeT blockSize = MIN_BID_BLOCK_SIZE;
+	while (currI < nextI)
+	{
+		blockCells.clear();
+		for( ; currI < nextI && blockCells.size() < blockSize; htpInfo.GetNextPermutationValue(), ++currI)
+		{
+			assert(htpInfo.m_CurrPI < htpInfo.m_N);
+			blockCells.emplace_back(htpInfo.m_CurrPI);
+		}
+		SizeT blockCount = blockCells.size(), nrValidBids = 0;
+		if (blockCount >= 2 * BID_CHUNK_SIZE && IsMultiThreaded1())
 		{
-			bool ok = UpdateSplitterDown(htpInfo, claim);
-			htpInfo.m_ClaimIdList.clear();
-			d_nrSplits++;
+			blockBidders.resize(blockCount);
+			parallel_for<SizeT>((blockCount + BID_CHUNK_SIZE - 1) / BID_CHUNK_SIZE, [&](SizeT chunk)
+				{
+					for (SizeT b = chunk * BID_CHUNK_SIZE, be = std::min(b + BID_CHUNK_SIZE, blockCount); b != be; ++b)
+						blockBidders[b] = GetHighestBidder(htpInfo, htpInfo.GetAtomicRegionID(blockCells[b]), blockCells[b]);
+				}
+			);
+			nrValidBids = blockCount;
+		}
 
-			if (!ok)
-			{
-				dms_assert(claim.m_Count > claim.m_ClaimRange.second);
-				SizeT excess = claim.m_Count - claim.m_ClaimRange.second;
-				if (PowerOf2(excess)) // only report power of 2 excess to limit quadratic behaviour of event log listbox and errors after 1000000 lines
-					reportF(SeverityTypeID::ST_MajorTrace,
-						"DiscrAlloc Warning: UpdateSplitterDown(%s) failed; now %u allocated",
-						htpInfo.GetClaimRangeStr( claim ).c_str(),
-						claim.m_Count
+		UInt32 blockFirstI = currI - blockCount;
+		SizeT nrAllocatedBeforeSplit = blockCount;
+		SizeT b = 0;
+		if (nrValidBids)
+		{
+			// the cells before the first splitter update are inserted in the facet queues in parallel
+			b = AllocCellsBeforeOverflow(htpInfo, worker, blockCells.data(), blockBidders.data(), blockCount);
+			if ((blockFirstI + b) / rapFreq != blockFirstI / rapFreq)
+				reportF(SeverityTypeID::ST_MajorTrace,
+					"DiscrAllocCells %u: Progress %u/%u; %u calls to UpdateSplitterDown",
+					N, blockFirstI + b, nextI, worker.m_NrSplits
 				); 
+		}
+		for (; b != blockCount; ++b)
+		{
+			land_unit_id i = blockCells[b];
+			auto ar = htpInfo.GetAtomicRegionID(i);
+			assert(ar < htpInfo.GetNrAtomicRegions()); // guaranteed by IncrementAtomicRegionCount
+
+			UInt32 highestBidder = (b < nrValidBids) ? blockBidders[b] : GetHighestBidder(htpInfo, ar, i);
+			assert(b >= nrValidBids || highestBidder == GetHighestBidder(htpInfo, ar, i));
+			if (AllocCell(htpInfo, worker, ar, i, highestBidder))
+			{
+				MakeMin(nrValidBids, b + 1); // shadow prices changed
+				MakeMin(nrAllocatedBeforeSplit, b + 1);
 			}
-			#if defined(MG_DEBUG)
-				if (d_nrSplits % 20000 == 0)
-					CheckAllLinks(htpInfo);
-			#endif
+
+			if ((blockFirstI + b) % rapFreq==0) 
+				reportF(SeverityTypeID::ST_MajorTrace,
+					"DiscrAllocCells %u: Progress %u/%u; %u calls to UpdateSplitterDown",
+					N, blockFirstI + b, nextI, worker.m_NrSplits
+				); 
 		}
+		if (nrAllocatedBeforeSplit == blockCount)
+			blockSize = std::min(blockSize * 2, MAX_BID_BLOCK_SIZE);
+		else
+			blockSize = std::max(nrAllocatedBeforeSplit * 2, MIN_BID_BLOCK_SIZE);
+	}
+	dms_assert(htpInfo.m_CurrPI >= htpInfo.m_N);
+}
 
-		if (currI % rapFreq==0) 
+// progress of the allocation of the cells of all components, which are allocated by several workers
+struct component_progress
+{
+	std::atomic<UInt32> m_NrCellsDone = 0;
+	UInt32 m_NrCells = 0, m_NrComponents = 0, m_RapFreq = 1;
+
+	// adds the cells that a worker completed since its previous call and reports when a multiple of m_RapFreq is passed
+	void Add(UInt32 nrCells, UInt32 nrSplitsDown)
+	{
+		UInt32 prevDone = m_NrCellsDone.fetch_add(nrCells);
+		if ((prevDone + nrCells) / m_RapFreq != prevDone / m_RapFreq)
 			reportF(SeverityTypeID::ST_MajorTrace,
-				"DiscrAllocCells %u: Progress %u/%u; %u calls to UpdateSplitterDown",
-				N, currI, nextI, d_nrSplits
-			); 
+				"DiscrAllocCells: Progress %u/%u cells of %u components; %u calls to UpdateSplitterDown by the reporting worker",
+				prevDone + nrCells, m_NrCells, m_NrComponents, nrSplitsDown
+			);
 	}
-	dms_assert(htpInfo.m_CurrPI >= htpInfo.m_N);
-	reportF(SeverityTypeID::ST_MajorTrace,
-		"DiscrAllocCells %u: %u cells completed with %u calls to UpdateSplitterDown",
-		N, currI, d_nrSplits
-	); 
+};
+
+// allocates the given cells in the given order with one worker, as done for the cells of each component
+template <typename S, typename AR, typename AT>
+void DiscrAllocCellList(htp_info_t<S, AR, AT>& htpInfo, htp_worker_t<S, AR, AT>& worker, const land_unit_id* cellPtr, const land_unit_id* cellEnd, component_progress& progress)
+{
+	UInt32 nrUnreported = 0;
+	for (; cellPtr != cellEnd; ++cellPtr)
+	{
+		land_unit_id i = *cellPtr;
+		auto ar = htpInfo.GetAtomicRegionID(i);
+		AllocCell(htpInfo, worker, ar, i, GetHighestBidder(htpInfo, ar, i));
+		if (++nrUnreported == PROGRESS_BATCH_SIZE)
+		{
+			progress.Add(nrUnreported, worker.m_NrSplits);
+			nrUnreported = 0;
+		}
+	}
+	progress.Add(nrUnreported, worker.m_NrSplits);
 }
 
+// satisfies the minimum claims of the given claims in the given order
 template <typename S, typename AR, typename AT>
-void DiscrAllocMinClaims(htp_info_t<S, AR, AT>& htpInfo)
+void DiscrAllocMinClaims(htp_info_t<S, AR, AT>& htpInfo, htp_worker_t<S, AR, AT>& worker, const UInt32* claimIdPtr, const UInt32* claimIdEnd, UInt32& count)
 {
-	UInt32 count = 0;
-	auto
-		claimIter = htpInfo.m_Claims.begin(),
-		claimEnd  = htpInfo.m_Claims.end();
-	while (claimIter != claimEnd)
+	for (; claimIdPtr != claimIdEnd; ++claimIdPtr)
 	{
+		claim<S>& claim = htpInfo.m_Claims[*claimIdPtr];
 		bool ok = true;
-		while (ok && claimIter->Underflow())
+		while (ok && claim.Underflow())
 		{
-			ok = UpdateSplitterUp(htpInfo, *claimIter);
-			htpInfo.m_ClaimIdList.clear();
+			ok = UpdateSplitterUp(htpInfo, worker, claim);
+			worker.m_ClaimIdList.clear();
 			++count;
 		}
 		if (!ok)
 			reportF(SeverityTypeID::ST_MajorTrace,
 				"DiscrAlloc Warning: UpdateSplitterUp(%s) failed; only %u allocated",
-				htpInfo.GetClaimRangeStr( *claimIter ).c_str(),
-				claimIter->m_Count
+				htpInfo.GetClaimRangeStr( claim ).c_str(),
+				claim.m_Count
 			); 
-		++claimIter;
 	}
+}
+
+// Cells of different components never compete for the same claims and reallocations only follow facets within a component,
+// thus allocating each component separately in the order of the permutation gives the same result as the allocation of all cells in that order.
+template <typename S, typename AR, typename AT>
+void SolveComponents(htp_info_t<S, AR, AT>& htpInfo, UInt32 firstI, UInt32 lastI, UInt32& nrSplitsDown, UInt32& nrSplitsUp)
+{
+	UInt32 nrComponents = htpInfo.m_NrComponents;
+
+	// the cells of this scale level per component, in the order of the permutation
+	std::vector<land_unit_id> componentFirstCell(nrComponents + 1, 0);
+	cursor_type curr = htpInfo.GetCursor();
+	for (UInt32 currI = firstI; currI < lastI; htpInfo.GetNextPermutationValue(), ++currI)
+		++componentFirstCell[htpInfo.m_AtomicRegionComponent[htpInfo.GetAtomicRegionID(htpInfo.m_CurrPI)] + 1];
+	for (UInt32 c = 0; c != nrComponents; ++c)
+		componentFirstCell[c + 1] += componentFirstCell[c];
+
+	OwningPtrSizedArray<land_unit_id> componentCells(lastI - firstI, dont_initialize MG_DEBUG_ALLOCATOR_SRC("DiscrAlloc: componentCells"));
+	std::vector<land_unit_id> componentPos(componentFirstCell.begin(), componentFirstCell.end() - 1);
+	htpInfo.SetCursor(curr);
+	for (UInt32 currI = firstI; currI < lastI; htpInfo.GetNextPermutationValue(), ++currI)
+		componentCells[componentPos[htpInfo.m_AtomicRegionComponent[htpInfo.GetAtomicRegionID(htpInfo.m_CurrPI)]]++] = htpInfo.m_CurrPI;
+	dms_assert(htpInfo.m_CurrPI >= htpInfo.m_N);
+
+	component_progress progress;
+	progress.m_NrCells      = lastI - firstI;
+	progress.m_NrComponents = nrComponents;
+	progress.m_RapFreq      = ProgressReportFrequency(htpInfo.GetK());
 
-	reportF(SeverityTypeID::ST_MajorTrace,
-		"DiscrAllocMinClaims completed with %u calls to UpdateSplitterUp",
-		count
-	); 
+	// each task allocates components with its own worker until none are left
+	UInt32 nrTasks = std::min<UInt32>(nrComponents, MaxConcurrentTreads());
+	std::atomic<UInt32> nextComponent = 0, atomicNrSplitsUp = 0, atomicNrSplitsDown = 0;
+	parallel_for<UInt32>(nrTasks, [&](UInt32)
+		{
+			htp_worker_t<S, AR, AT> worker(htpInfo);
+			UInt32 nrSplitsUp = 0;
+			for (UInt32 c; (c = nextComponent++) < nrComponents; )
+			{
+				DiscrAllocCellList(htpInfo, worker, componentCells.begin() + componentFirstCell[c], componentCells.begin() + componentFirstCell[c + 1], progress);
+				DiscrAllocMinClaims(htpInfo, worker
+				,	begin_ptr(htpInfo.m_ComponentClaimIds) + htpInfo.m_ComponentFirstClaim[c]
+				,	begin_ptr(htpInfo.m_ComponentClaimIds) + htpInfo.m_ComponentFirstClaim[c + 1]
+				,	nrSplitsUp
+				);
+			}
+			atomicNrSplitsDown += worker.m_NrSplits;
+			atomicNrSplitsUp   += nrSplitsUp;
+		}
+	);
+	nrSplitsDown = atomicNrSplitsDown;
+	nrSplitsUp   = atomicNrSplitsUp;
 }
 
 template <typename S, typename AR, typename AT>
 void SolveRange(htp_info_t<S, AR, AT>& htpInfo, UInt32 firstI, UInt32 lastI)
 {
-	DiscrAllocCells(htpInfo, firstI, lastI);
-	#if defined(MG_DEBUG)
-		CheckAllLinks(htpInfo);
-	#endif
-	DiscrAllocMinClaims(htpInfo);
+	DiscrAllocCellsBegin(htpInfo, lastI);
 
-	#if defined(MG_DEBUG)
-		CheckAllLinks (htpInfo);
-		CheckAllClaims(htpInfo, nullptr);
-	#endif
+	UInt32 nrSplitsDown = 0, nrSplitsUp = 0;
+	if (htpInfo.m_NrComponents > 1 && IsMultiThreaded1())
+	{
+		SolveComponents(htpInfo, firstI, lastI, nrSplitsDown, nrSplitsUp);
+		reportF(SeverityTypeID::ST_MajorTrace,
+			"DiscrAllocCells %u: %u cells of %u components completed with %u calls to UpdateSplitterDown and %u calls to UpdateSplitterUp",
+			htpInfo.GetN(), lastI, htpInfo.m_NrComponents, nrSplitsDown, nrSplitsUp
+		);
+		#if defined(MG_DEBUG)
+			CheckAllLinks (htpInfo);
+			CheckAllClaims(htpInfo, nullptr);
+		#endif
+	}
+	else
+	{
+		htp_worker_t<S, AR, AT> worker(htpInfo);
+		DiscrAllocCells(htpInfo, worker, firstI, lastI);
+		reportF(SeverityTypeID::ST_MajorTrace,
+			"DiscrAllocCells %u: %u cells completed with %u calls to UpdateSplitterDown",
+			htpInfo.GetN(), lastI, worker.m_NrSplits
+		); 
+		#if defined(MG_DEBUG)
+			CheckAllLinks(htpInfo);
+		#endif
+
+		DiscrAllocMinClaims(htpInfo, worker, begin_ptr(htpInfo.m_ComponentClaimIds), end_ptr(htpInfo.m_ComponentClaimIds), nrSplitsUp);
+		reportF(SeverityTypeID::ST_MajorTrace,
+			"DiscrAllocMinClaims completed with %u calls to UpdateSplitterUp",
+			nrSplitsUp
+		); 
+
+		#if defined(MG_DEBUG)
+			CheckAllLinks (htpInfo);
+			CheckAllClaims(htpInfo, nullptr);
+		#endif
+	}
 
 	DiscrAllocEnd(htpInfo, lastI);
 }
@@ -3061,6 +3367,14 @@ void IncrementAtomicRegionCount<Void>(std::vector<claim_type>& atomicRegionCount
 	atomicRegionCount[0] += (e - i);
 }
 
+void ReportScaleLevelTime(SizeT stepSize, SizeT nrCells, std::chrono::steady_clock::time_point levelStart)
+{
+	reportF(SeverityTypeID::ST_MajorTrace, "DiscrAlloc: scale level per %u cells with %u cells took %.3f s"
+	,	stepSize, nrCells
+	,	std::chrono::duration<Float64>(std::chrono::steady_clock::now() - levelStart).count()
+	);
+}
+
 template <typename S, typename AR, typename AT>
 void Solve(htp_info_t<S, AR, AT>& htpInfo, S threshold, AbstrDataObject* resPrices)
 {
@@ -3084,6 +3398,7 @@ void Solve(htp_info_t<S, AR, AT>& htpInfo, S threshold, AbstrDataObject* resPric
 	while (htpInfo.m_StepSize > 1)
 	{
 		reportF(SeverityTypeID::ST_MajorTrace, "DiscrAlloc: SolveScaled per %u cells", htpInfo.m_StepSize);
+		auto levelStart = std::chrono::steady_clock::now();
 
 		UInt32 nextI = htpInfo.GetNrSteps();
 		
@@ -3094,6 +3409,7 @@ void Solve(htp_info_t<S, AR, AT>& htpInfo, S threshold, AbstrDataObject* resPric
 
 		htpInfo.SetCursor(curr);
 		SolveRange(htpInfo, currI, nextI);
+		ReportScaleLevelTime(htpInfo.m_StepSize, nextI, levelStart);
 
 		currI = nextI;
 
@@ -3101,6 +3417,7 @@ void Solve(htp_info_t<S, AR, AT>& htpInfo, S threshold, AbstrDataObject* resPric
 	}
 
 	// reset m_ClaimRanges to original values
+	auto levelStart = std::chrono::steady_clock::now();
 	cursor_type curr = htpInfo.GetCursor();
 
 	IncrementAtomicRegionCount(atomicRegionCount, htpInfo, currI, Na); // count per ar with stepSize
@@ -3109,6 +3426,7 @@ void Solve(htp_info_t<S, AR, AT>& htpInfo, S threshold, AbstrDataObject* resPric
 	htpInfo.SetCursor(curr);
 
 	SolveRange(htpInfo, currI, Na);
+	ReportScaleLevelTime(1, Na, levelStart);
 	StoreBidPricesCurrTile(htpInfo, resPrices, true);
 }
 
@@ -3399,6 +3717,7 @@ public:
 			{
 				DataReadLockSuitabilities(htpInfo);
 				PrepareFacets(htpInfo);
+				PrepareComponents(htpInfo);
 				PrepareReport(htpInfo);
 			}
 
@@ -3419,7 +3738,7 @@ public:
 				if (htpInfo.m_NrBelowThreshold > 0)
 				{
 					reportF(SeverityTypeID::ST_MajorTrace, "%d units%s with suitability for all categories below the threshold of %s and therefore unallocated"
-						, htpInfo.m_NrBelowThreshold
+						, land_unit_id(htpInfo.m_NrBelowThreshold)
 						, htpInfo.m_NrBelowThreshold > NR_BELOW_THRESHOLD_NOTIFICATIONS ? ", of which only the first 5 were reported," : ""
 						, AsString(threshold)
 					);
@@ -0,0 +1,228 @@
+// Copyright (C) 1998-2026 Object Vision b.v.
+// License: GNU GPL 3
+/////////////////////////////////////////////////////////////////////////////
+
+#include "GeoPCH.h"
+
+#if defined(CC_PRAGMAHDRSTOP)
+#pragma hdrstop
+#endif
+
+#include <cmath>
+
+#include "dbg/SeverityType.h"
+#include "geo/RangeIndex.h"
+
+#include "DataArray.h"
+#include "DataItemClass.h"
+#include "IndexAssigner.h"
+#include "ParallelTiles.h"
+#include "TreeItemClass.h"
+#include "UnitClass.h"
+
+// *****************************************************************************
+// distance_transform(startPoints: S->Grid, cellImp: Void->Imp): Grid->Imp { NearestStartPoint: Grid->S }
+//
+// Exact euclidean distance transform: the impedance of each cell is cellImp times the euclidean distance,
+// in rows and columns, to the nearest start point, which is the griddist impedance of cells in uniform cost grids
+// without the bias of the 8 directions of griddist. Unlike griddist, it doesn't support obstacles or varying costs.
+// Separable, as by Felzenszwalb and Huttenlocher: a pass along the columns determines the nearest start point in each column,
+// after which the lower envelope of the parabolas of each row gives the nearest start point in the plane.
+// Both passes are processed in parallel; the first over blocks of columns that are processed row by row.
+// *****************************************************************************
+
+template <typename Imp, typename Grid>
+class DistanceTransformOperator : public BinaryOperator
+{
+	using ImpType = Imp;
+	using GridType = Grid;
+	using ArgSpType = DataArray<GridType>; // S->Grid
+	using ArgCiType = DataArray<ImpType>;  // Void->Imp
+	using ResultType = DataArray<ImpType>; // Grid->Imp
+
+	static constexpr UInt32 COLUMN_BLOCK_SIZE = 256;
+
+public:
+	DistanceTransformOperator(AbstrOperGroup& og)
+		: BinaryOperator(&og, ResultType::GetStaticClass(), ArgSpType::GetStaticClass(), ArgCiType::GetStaticClass())
+	{}
+
+	// Override Operator
+	bool CreateResult(TreeItemDualRef& resultHolder, const ArgSeqType& args, bool mustCalc) const override
+	{
+		assert(args.size() == 2);
+
+		const AbstrDataItem* adiStartPointGrid = AsDataItem(args[0]);
+		const AbstrDataItem* adiCellImp        = AsDataItem(args[1]);
+		assert(adiStartPointGrid);
+		assert(adiCellImp);
+
+		const Unit<GridType>* gridSet = const_unit_cast<GridType>(adiStartPointGrid->GetAbstrValuesUnit());
+		const AbstrUnit*      impUnit = adiCellImp->GetAbstrValuesUnit();
+		const AbstrUnit*      startSet = adiStartPointGrid->GetAbstrDomainUnit();
+		assert(gridSet);
+
+		MG_USERCHECK2(adiCellImp->HasVoidDomainGuarantee(), "distance_transform: cell impedance parameter (2nd argument) must have void domain");
+
+		if (!resultHolder)
+			resultHolder = CreateCacheDataItem(gridSet, impUnit);
+
+		AbstrDataItem* res = AsDataItem(resultHolder.GetNew());
+		AbstrDataItem* resNearest = CreateDataItem(res, GetTokenID_mt("NearestStartPoint"), gridSet, startSet);
+		MG_PRECONDITION(resNearest);
+		resNearest->SetTSF(TSF_Categorical);
+
+		if (!mustCalc)
+			return true;
+
+		DataReadLock argSpLock(adiStartPointGrid);
+		DataReadLock argCiLock(adiCellImp);
+
+		ImpType cellImp = const_array_cast<ImpType>(adiCellImp)->GetTile(0)[0];
+
+		DataWriteLock resLock(res, dms_rw_mode::write_only_all);
+		DataWriteLock nearestLock(resNearest, dms_rw_mode::write_only_all);
+
+		Range<GridType> range = gridSet->GetRange();
+		UInt32 nrC = Width(range), nrR = Height(range);
+		SizeT nrV = Cardinality(range);
+		{
+			auto resultData = mutable_array_cast<ImpType>(resLock)->GetDataWrite(no_tile, dms_rw_mode::write_only_all);
+			IndexAssigner32 nearestAssigner(resNearest, nearestLock.get(), no_tile, 0, nrV);
+			MG_CHECK(resultData.size() == nrV);
+
+			if (!Calculate(const_array_cast<GridType>(adiStartPointGrid)->GetDataRead(), range, nrC, nrR, cellImp, resultData.begin(), nearestAssigner.m_Indices))
+				return false;
+			nearestAssigner.Store();
+		}
+		resLock.Commit();
+		nearestLock.Commit();
+		return true;
+	}
+
+private:
+	bool Calculate(typename ArgSpType::locked_cseq_t startPoints, Range<GridType> range, UInt32 nrC, UInt32 nrR, ImpType cellImp
+	,	ImpType* resultData, UInt32* nearestData) const
+	{
+		SizeT nrV = SizeT(nrC) * nrR;
+		if (!nrV) // an empty grid; the reverse row loop below requires nrR > 0
+			return true;
+
+		// the first start point of each cell
+		OwningPtrSizedArray<UInt32> startPointOfCell(nrV, Undefined() MG_DEBUG_ALLOCATOR_SRC("distance_transform: startPointOfCell"));
+		for (UInt32 s = 0, ns = startPoints.size(); s != ns; ++s)
+		{
+			SizeT index = Range_GetIndex_checked(range, startPoints[s]);
+			if (IsDefined(index) && !IsDefined(startPointOfCell[index]))
+				startPointOfCell[index] = s;
+		}
+
+		// the row of the nearest start cell in the same column, per cell
+		OwningPtrSizedArray<UInt32> nearestRow(nrV, dont_initialize MG_DEBUG_ALLOCATOR_SRC("distance_transform: nearestRow"));
+		parallel_for<UInt32>((nrC + COLUMN_BLOCK_SIZE - 1) / COLUMN_BLOCK_SIZE, [&](UInt32 b)
+			{
+				UInt32 cFirst = b * COLUMN_BLOCK_SIZE, cLast = std::min<UInt32>(cFirst + COLUMN_BLOCK_SIZE, nrC);
+				for (UInt32 r = 0; r != nrR; ++r)
+				{
+					SizeT rowStart = SizeT(r) * nrC;
+					for (UInt32 c = cFirst; c != cLast; ++c)
+						nearestRow[rowStart + c] = IsDefined(startPointOfCell[rowStart + c])
+							?	r
+							:	(r ? nearestRow[rowStart + c - nrC] : UNDEFINED_VALUE(UInt32));
+				}
+				for (UInt32 r = nrR - 1; r-- > 0; )
+				{
+					SizeT rowStart = SizeT(r) * nrC;
+					for (UInt32 c = cFirst; c != cLast; ++c)
+					{
+						UInt32 below = nearestRow[rowStart + c + nrC];
+						UInt32& curr = nearestRow[rowStart + c];
+						if (IsDefined(below) && (!IsDefined(curr) || (below > r && below - r < r - curr)))
+							curr = below;
+					}
+				}
+			}
+		);
+		if (CancelableFrame::CurrActiveCanceled())
+			return false;
+
+		// per row, the lower envelope of the parabolas (c - site)^2 + (r - nearestRow[site])^2 of the columns that have a nearest start cell
+		parallel_for<UInt32>(nrR, [&](UInt32 r)
+			{
+				SizeT rowStart = SizeT(r) * nrC;
+				auto sqrDistY = [&](UInt32 c) { Float64 dy = Float64(r) - Float64(nearestRow[rowStart + c]); return dy * dy; };
+
+				std::vector<UInt32> sites;   // the columns of the parabolas of the envelope
+				std::vector<Float64> bounds; // sites[k] is the lowest from bounds[k] to bounds[k+1]
+				for (UInt32 c = 0; c != nrC; ++c)
+				{
+					if (!IsDefined(nearestRow[rowStart + c]))
+						continue;
+					Float64 fc = sqrDistY(c) + Float64(c) * c;
+					while (!sites.empty())
+					{
+						UInt32 v = sites.back();
+						Float64 s = (fc - (sqrDistY(v) + Float64(v) * v)) / (2.0 * (Float64(c) - Float64(v)));
+						if (s > bounds.back())
+						{
+							bounds.emplace_back(s);
+							break;
+						}
+						sites.pop_back();
+						bounds.pop_back();
+					}
+					if (sites.empty())
+						bounds.emplace_back(-std::numeric_limits<Float64>::infinity());
+					sites.emplace_back(c);
+				}
+
+				if (sites.empty())
+				{
+					fast_undefine(resultData  + rowStart, resultData  + rowStart + nrC);
+					fast_undefine(nearestData + rowStart, nearestData + rowStart + nrC);
+					return;
+				}
+				bounds.emplace_back(std::numeric_limits<Float64>::infinity());
+
+				SizeT k = 0;
+				for (UInt32 c = 0; c != nrC; ++c)
+				{
+					while (bounds[k + 1] < c)
+						++k;
+					UInt32 site = sites[k];
+					Float64 dx = Float64(c) - Float64(site);
+					resultData [rowStart + c] = cellImp * std::sqrt(dx * dx + sqrDistY(site));
+					nearestData[rowStart + c] = startPointOfCell[SizeT(nearestRow[rowStart + site]) * nrC + site];
+				}
+			}
+		);
+		if (CancelableFrame::CurrActiveCanceled())
+			return false;
+
+		reportF(SeverityTypeID::ST_MajorTrace, "distance_transform completed for %d start points in %d rows and %d columns", startPoints.size(), nrR, nrC);
+		return true;
+	}
+};
+
+// *****************************************************************************
+//											INSTANTIATION
+// *****************************************************************************
+
+#include "RtcTypeLists.h"
+#include "utl/TypeListOper.h"
+
+namespace {
+	static CommonOperGroup cogDT("distance_transform", oper_policy::better_not_in_meta_scripting);
+
+	template <typename Imp>
+	struct DistanceTransformOperSet
+	{
+		DistanceTransformOperSet(AbstrOperGroup& og)
+			: m_Opers(og)
+		{}
+
+		tl_oper::inst_tuple<typelists::domain_points, tl::bind_placeholders<DistanceTransformOperator, Imp, ph::_1>> m_Opers;
+	};
+
+	tl_oper::inst_tuple_templ<typelists::floats, DistanceTransformOperSet> distanceTransformOperSets(cogDT);
+}
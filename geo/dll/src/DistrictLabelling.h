@@ -0,0 +1,291 @@
+// Copyright (C) 1998-2026 Object Vision b.v.
+// License: GNU GPL 3
+/////////////////////////////////////////////////////////////////////////////
+
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+File: DistrictLabelling.h
+Purpose:
+- Tile parallel connected component labelling for the district operators (see OperDistrict.cpp),
+  giving the same district ids as the flood fill of Districter (see SpatialAnalyzer.h): districts are numbered
+  in the raster order of their first cell, and undefined cells belong to no district.
+
+Summary:
+- LabelDistrictCells labels the cells of one tile with a raster scan and a union-find of provisional labels,
+  in which the smaller label is the root, such that each root is the label of the first cell of its component.
+  The local labels are numbered in the raster order of the first cell of each component.
+- district_labeller<T> combines the tiles in three passes:
+  1. LabelTile, concurrently for all tiles: labels a tile and keeps the labels and values of its border cells
+     and the grid position of the first cell of each local component;
+  2. Unite: unites the components of adjacent border cells of different tiles with equal values, keeping the component
+     with the first cell in the grid as root, and numbers the roots in the order of their first cell;
+  3. DistrictId, concurrently for all tiles: the district id of each local label.
+  Besides the labels of the tiles that are being processed, only the border cells and the first cells of all tiles are kept in memory.
+*/
+
+#if !defined(__GEO_DISTRICTLABELLING_H)
+#define __GEO_DISTRICTLABELLING_H
+
+#include <algorithm>
+#include <assert.h>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+const std::uint32_t no_district_label = std::numeric_limits<std::uint32_t>::max();
+
+// labels[i] receives the local label of cell i of the nrRows x nrCols tile, or no_district_label if !isDefined(data[i]);
+// firstCells receives the cell of each local label and the number of labels is returned
+template <typename T, typename ValueIter, typename IsDefinedFunc>
+std::uint32_t LabelDistrictCells(ValueIter data, std::size_t nrRows, std::size_t nrCols, bool rule8, IsDefinedFunc&& isDefined, std::uint32_t* labels, std::vector<std::size_t>& firstCells)
+{
+	std::vector<std::uint32_t> parents;
+	firstCells.clear();
+
+	auto find = [&parents](std::uint32_t label)
+		{
+			while (parents[label] != label)
+				label = parents[label] = parents[parents[label]];
+			return label;
+		};
+
+	for (std::size_t r = 0, i = 0; r != nrRows; ++r)
+		for (std::size_t c = 0; c != nrCols; ++c, ++i)
+		{
+			T value = data[i];
+			if (!isDefined(value))
+			{
+				labels[i] = no_district_label;
+				continue;
+			}
+			std::uint32_t label = no_district_label;
+			auto join = [&](std::size_t j)
+				{
+					if (labels[j] == no_district_label || !(data[j] == value))
+						return;
+					std::uint32_t root = find(labels[j]);
+					if (label == no_district_label)
+						label = root;
+					else if (root != label)
+					{
+						if (root < label)
+							std::swap(root, label);
+						parents[root] = label;
+					}
+				};
+			if (c)
+				join(i - 1);
+			if (r)
+			{
+				if (rule8 && c)
+					join(i - nrCols - 1);
+				join(i - nrCols);
+				if (rule8 && c + 1 < nrCols)
+					join(i - nrCols + 1);
+			}
+			if (label == no_district_label)
+			{
+				assert(parents.size() < no_district_label);
+				label = std::uint32_t(parents.size());
+				parents.push_back(label);
+				firstCells.push_back(i);
+			}
+			labels[i] = label;
+		}
+
+	// number the roots in the order of their labels; the parent of a label is smaller than the label itself
+	std::uint32_t nrLabels = 0;
+	for (std::uint32_t label = 0, n = std::uint32_t(parents.size()); label != n; ++label)
+	{
+		if (parents[label] == label)
+		{
+			firstCells[nrLabels] = firstCells[label];
+			parents[label] = nrLabels++;
+		}
+		else
+			parents[label] = parents[parents[label]];
+	}
+	firstCells.resize(nrLabels);
+
+	for (std::size_t i = 0, n = nrRows * nrCols; i != n; ++i)
+		if (labels[i] != no_district_label)
+			labels[i] = parents[labels[i]];
+	return nrLabels;
+}
+
+template <typename T>
+struct district_labeller
+{
+	district_labeller(std::size_t nrGridRows, std::size_t nrGridCols, std::size_t nrTiles, bool rule8)
+		: m_NrGridRows(nrGridRows), m_NrGridCols(nrGridCols), m_Rule8(rule8), m_Tiles(nrTiles)
+	{}
+
+	// pass 1; the tile starts at (top, left) in the grid and labels receives its local labels; returns the number of local labels
+	template <typename ValueIter, typename IsDefinedFunc>
+	std::uint32_t LabelTile(std::size_t t, std::size_t top, std::size_t left, std::size_t nrRows, std::size_t nrCols, ValueIter data, IsDefinedFunc&& isDefined, std::uint32_t* labels)
+	{
+		assert(t < m_Tiles.size());
+		tile_info& tile = m_Tiles[t];
+		tile.top = top; tile.left = left; tile.nrRows = nrRows; tile.nrCols = nrCols;
+
+		std::vector<std::size_t> firstCells;
+		auto nrLabels = LabelDistrictCells<T>(data, nrRows, nrCols, m_Rule8, isDefined, labels, firstCells);
+
+		tile.firstPos.resize(nrLabels);
+		for (std::uint32_t label = 0; label != nrLabels; ++label)
+			tile.firstPos[label] = GridPos(tile, firstCells[label] / nrCols, firstCells[label] % nrCols);
+
+		tile.borderLabels.assign(2 * (nrRows + nrCols), no_district_label);
+		tile.borderValues.resize(2 * (nrRows + nrCols));
+		ForEachBorderCell(tile, [&](std::size_t r, std::size_t c)
+			{
+				std::size_t b = BorderIndex(tile, r, c), i = r * nrCols + c;
+				tile.borderLabels[b] = labels[i];
+				tile.borderValues[b] = data[i];
+			}
+		);
+		return nrLabels;
+	}
+
+	// pass 2; findTile(row, col) returns the tile that contains a cell of the grid; returns the number of districts
+	template <typename FindTileFunc>
+	std::size_t Unite(FindTileFunc&& findTile)
+	{
+		std::size_t nrLabels = 0;
+		for (auto& tile : m_Tiles)
+		{
+			tile.offset = nrLabels;
+			nrLabels += tile.firstPos.size();
+		}
+		m_Parents.resize(nrLabels);
+		m_FirstPos.resize(nrLabels);
+		for (auto& tile : m_Tiles)
+		{
+			std::copy(tile.firstPos.begin(), tile.firstPos.end(), m_FirstPos.begin() + tile.offset);
+			std::vector<std::uint64_t>().swap(tile.firstPos);
+		}
+		for (std::size_t g = 0; g != nrLabels; ++g)
+			m_Parents[g] = g;
+
+		const int dirs[4][2] = { {0, 1}, {1, 0}, {1, -1}, {1, 1} }; // the neighbours after each cell in raster order
+		const int nrDirs = m_Rule8 ? 4 : 2;
+		for (const auto& tile : m_Tiles)
+			ForEachBorderCell(tile, [&](std::size_t r, std::size_t c)
+				{
+					std::size_t b = BorderIndex(tile, r, c);
+					std::uint32_t label = tile.borderLabels[b];
+					if (label == no_district_label)
+						return;
+					for (int d = 0; d != nrDirs; ++d)
+					{
+						std::ptrdiff_t tr = std::ptrdiff_t(r) + dirs[d][0], tc = std::ptrdiff_t(c) + dirs[d][1];
+						if (tr < std::ptrdiff_t(tile.nrRows) && tc >= 0 && tc < std::ptrdiff_t(tile.nrCols))
+							continue; // within the tile
+						std::ptrdiff_t gr = std::ptrdiff_t(tile.top) + tr, gc = std::ptrdiff_t(tile.left) + tc;
+						if (gr >= std::ptrdiff_t(m_NrGridRows) || gc < 0 || gc >= std::ptrdiff_t(m_NrGridCols))
+							continue; // outside the grid
+						const tile_info& other = m_Tiles[findTile(std::size_t(gr), std::size_t(gc))];
+						std::size_t ob = BorderIndex(other, gr - other.top, gc - other.left);
+						if (other.borderLabels[ob] != no_district_label && other.borderValues[ob] == tile.borderValues[b])
+							Union(tile.offset + label, other.offset + other.borderLabels[ob]);
+					}
+				}
+			);
+
+		// number the roots in the order of their first cell in the grid
+		std::vector<std::pair<std::uint64_t, std::size_t>> roots;
+		for (std::size_t g = 0; g != nrLabels; ++g)
+			if ((m_Parents[g] = Find(g)) == g)
+				roots.emplace_back(m_FirstPos[g], g);
+		std::sort(roots.begin(), roots.end());
+
+		std::vector<std::uint64_t>().swap(m_FirstPos);
+		std::vector<std::size_t> ids(nrLabels);
+		for (std::size_t id = 0, n = roots.size(); id != n; ++id)
+			ids[roots[id].second] = id;
+		for (std::size_t g = 0; g != nrLabels; ++g)
+			m_Parents[g] = ids[m_Parents[g]];
+		return roots.size();
+	}
+
+	// pass 3
+	std::size_t DistrictId(std::size_t t, std::uint32_t label) const
+	{
+		assert(label != no_district_label);
+		return m_Parents[m_Tiles[t].offset + label];
+	}
+
+private:
+	struct tile_info
+	{
+		std::size_t top = 0, left = 0, nrRows = 0, nrCols = 0;
+		std::size_t offset = 0;                  // of the local labels in m_Parents
+		std::vector<std::uint64_t> firstPos;     // per local label until Unite
+		std::vector<std::uint32_t> borderLabels; // top row, bottom row, left column, right column; see BorderIndex
+		std::vector<T>             borderValues;
+	};
+
+	std::uint64_t GridPos(const tile_info& tile, std::size_t r, std::size_t c) const
+	{
+		return std::uint64_t(tile.top + r) * m_NrGridCols + (tile.left + c);
+	}
+
+	static std::size_t BorderIndex(const tile_info& tile, std::size_t r, std::size_t c)
+	{
+		if (r == 0)               return c;
+		if (r + 1 == tile.nrRows) return tile.nrCols + c;
+		if (c == 0)               return 2 * tile.nrCols + r;
+		assert(c + 1 == tile.nrCols);
+		return 2 * tile.nrCols + tile.nrRows + r;
+	}
+
+	template <typename Func>
+	static void ForEachBorderCell(const tile_info& tile, Func&& func)
+	{
+		if (!tile.nrRows || !tile.nrCols)
+			return;
+		for (std::size_t c = 0; c != tile.nrCols; ++c)
+		{
+			func(0, c);
+			if (tile.nrRows > 1)
+				func(tile.nrRows - 1, c);
+		}
+		for (std::size_t r = 1; r + 1 < tile.nrRows; ++r)
+		{
+			func(r, 0);
+			if (tile.nrCols > 1)
+				func(r, tile.nrCols - 1);
+		}
+	}
+
+	std::size_t Find(std::size_t g)
+	{
+		while (m_Parents[g] != g)
+			g = m_Parents[g] = m_Parents[m_Parents[g]];
+		return g;
+	}
+
+	void Union(std::size_t a, std::size_t b)
+	{
+		a = Find(a);
+		b = Find(b);
+		if (a == b)
+			return;
+		if (m_FirstPos[b] < m_FirstPos[a])
+			std::swap(a, b);
+		m_Parents[b] = a;
+	}
+
+	std::size_t m_NrGridRows, m_NrGridCols;
+	bool        m_Rule8;
+	std::vector<tile_info>     m_Tiles;
+	std::vector<std::size_t>   m_Parents;  // until the end of Unite a union-find of the labels of all tiles, then the district id of each
+	std::vector<std::uint64_t> m_FirstPos; // grid position of the first cell of each label
+};
+
+#endif //!defined(__GEO_DISTRICTLABELLING_H)
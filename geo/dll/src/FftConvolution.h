@@ -0,0 +1,235 @@
+// Copyright (C) 1998-2026 Object Vision b.v.
+// License: GNU GPL 3
+/////////////////////////////////////////////////////////////////////////////
+
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+File: FftConvolution.h
+Purpose:
+- Full 2D convolution of data tiles by a fixed kernel with the Fast Fourier Transform,
+  for the PotentialFft backend of potential (see Potential.cpp), which doesn't depend on Intel IPP.
+
+Summary:
+- fft_plan: in-place iterative radix-2 transform of a power of 2 number of complex values with precomputed twiddle factors.
+- fft_kernel: the spectra of the blocks of the mirrored kernel, zero padded to power of 2 sizes that fit the full convolution with
+  the blocks of data tiles up to a given size; the inverse scaling is included. Immutable after construction and thus shared by threads.
+- fft_kernel::Convolve writes the (nrDataRows + kRows - 1) x (nrDataCols + kCols - 1) full convolution of a data tile,
+  laid out as CalculateClassic does for PotentialSlow: output[r][c] = sum_ij data[r + i - kRows + 1][c + j - kCols + 1] * kernel[i][j].
+  The circular convolution of the padded grids equals the linear one as the padded sizes cover the full output.
+- Rows that are known to be zero are not transformed: only the data rows in the forward and only the output rows in the inverse pass.
+- Columns are transformed in blocks of adjacent columns that are gathered row by row, which keeps memory access sequential.
+- The padded sizes are at most FFT_MAX_SIZE per dimension, which bounds the workspace of each thread to 2 x FFT_MAX_SIZE^2 complex values.
+  Larger data tiles and kernels are split into blocks; the full convolution of each data block by each kernel block is added to the output
+  at the sum of their offsets, as the convolution is linear in both.
+*/
+
+#if !defined(__GEO_FFTCONVOLUTION_H)
+#define __GEO_FFTCONVOLUTION_H
+
+#include <algorithm>
+#include <assert.h>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <numbers>
+#include <vector>
+
+// *****************************************************************************
+// fft_plan
+// *****************************************************************************
+
+template <typename F>
+struct fft_plan
+{
+	using complex_type = std::complex<F>;
+
+	explicit fft_plan(std::size_t n)
+		: m_Size(n)
+		, m_Twiddles(n / 2)
+	{
+		assert(n && !(n & (n - 1)));
+		for (std::size_t k = 0; k != n / 2; ++k)
+		{
+			F angle = -2 * std::numbers::pi_v<F> * F(k) / F(n);
+			m_Twiddles[k] = complex_type(std::cos(angle), std::sin(angle));
+		}
+	}
+
+	std::size_t size() const { return m_Size; }
+
+	// transforms size() values; the inverse transform is not scaled
+	void Transform(complex_type* data, bool inverse) const
+	{
+		std::size_t n = m_Size;
+		for (std::size_t i = 1, j = 0; i < n; ++i) // bit reversal permutation
+		{
+			std::size_t bit = n >> 1;
+			for (; j & bit; bit >>= 1)
+				j ^= bit;
+			j ^= bit;
+			if (i < j)
+				std::swap(data[i], data[j]);
+		}
+		for (std::size_t len = 2; len <= n; len <<= 1)
+		{
+			std::size_t half = len / 2, step = n / len;
+			for (std::size_t i = 0; i < n; i += len)
+				for (std::size_t k = 0; k != half; ++k)
+				{
+					// written out, as complex multiplication would also handle infinities and nans
+					F wr = m_Twiddles[k * step].real(), wi = inverse ? -m_Twiddles[k * step].imag() : m_Twiddles[k * step].imag();
+					complex_type u = data[i + k], b = data[i + k + half];
+					complex_type v(b.real() * wr - b.imag() * wi, b.real() * wi + b.imag() * wr);
+					data[i + k]        = u + v;
+					data[i + k + half] = u - v;
+				}
+		}
+	}
+
+private:
+	std::size_t               m_Size;
+	std::vector<complex_type> m_Twiddles; // exp(-2 pi i k / n) for k < n/2
+};
+
+inline std::size_t fft_size(std::size_t n)
+{
+	std::size_t result = 1;
+	while (result < n)
+		result <<= 1;
+	return result;
+}
+
+// the maximum number of rows and columns of the padded grids of fft_kernel
+constexpr std::size_t FFT_MAX_SIZE = 1024;
+
+// *****************************************************************************
+// fft_kernel
+// *****************************************************************************
+
+template <typename F>
+struct fft_kernel
+{
+	using complex_type = std::complex<F>;
+	static constexpr std::size_t COLUMN_BLOCK_SIZE = 8;
+
+	template <typename T>
+	fft_kernel(const T* kernel, std::size_t nrKernelRows, std::size_t nrKernelCols, std::size_t maxNrDataRows, std::size_t maxNrDataCols, std::size_t maxFftSize = FFT_MAX_SIZE)
+		: m_NrKernelRows(nrKernelRows)
+		, m_NrKernelCols(nrKernelCols)
+		, m_KernelBlockRows(std::min(nrKernelRows, maxFftSize / 2))
+		, m_KernelBlockCols(std::min(nrKernelCols, maxFftSize / 2))
+		, m_DataBlockRows(std::clamp<std::size_t>(maxNrDataRows, 1, maxFftSize + 1 - m_KernelBlockRows))
+		, m_DataBlockCols(std::clamp<std::size_t>(maxNrDataCols, 1, maxFftSize + 1 - m_KernelBlockCols))
+		, m_RowPlan(fft_size(m_DataBlockCols + m_KernelBlockCols - 1))
+		, m_ColPlan(fft_size(m_DataBlockRows + m_KernelBlockRows - 1))
+	{
+		assert(nrKernelRows && nrKernelCols && maxFftSize >= 2);
+		assert(NrRows() <= maxFftSize && NrCols() <= maxFftSize);
+		std::size_t nrRows = NrRows(), nrCols = NrCols(), gridSize = nrRows * nrCols;
+		F scale = F(1) / F(gridSize);
+
+		// the spectra of the blocks of the mirrored kernel, in row major order of the blocks
+		m_Spectra.assign(NrKernelBlocks() * gridSize, complex_type());
+		complex_type* spectrum = m_Spectra.data();
+		for (std::size_t br = 0; br < nrKernelRows; br += m_KernelBlockRows)
+			for (std::size_t bc = 0; bc < nrKernelCols; bc += m_KernelBlockCols, spectrum += gridSize)
+			{
+				std::size_t nrBlockRows = std::min(m_KernelBlockRows, nrKernelRows - br), nrBlockCols = std::min(m_KernelBlockCols, nrKernelCols - bc);
+				for (std::size_t r = 0; r != nrBlockRows; ++r)
+					for (std::size_t c = 0; c != nrBlockCols; ++c)
+						spectrum[r * nrCols + c] = F(kernel[(nrKernelRows - 1 - br - r) * nrKernelCols + (nrKernelCols - 1 - bc - c)]);
+				Transform(spectrum, nrBlockRows, nrRows, false);
+				for (std::size_t i = 0; i != gridSize; ++i)
+					spectrum[i] *= scale;
+			}
+	}
+
+	std::size_t NrRows() const { return m_ColPlan.size(); }
+	std::size_t NrCols() const { return m_RowPlan.size(); }
+	std::size_t NrKernelBlocks() const { return ((m_NrKernelRows - 1) / m_KernelBlockRows + 1) * ((m_NrKernelCols - 1) / m_KernelBlockCols + 1); }
+
+	template <typename T, typename A>
+	void Convolve(const T* data, std::size_t nrDataRows, std::size_t nrDataCols, A* output, std::vector<complex_type>& workspace) const
+	{
+		std::size_t nrOutputRows = nrDataRows + m_NrKernelRows - 1, nrOutputCols = nrDataCols + m_NrKernelCols - 1;
+		std::size_t nrCols = NrCols(), gridSize = NrRows() * nrCols;
+		bool hasKernelBlocks = NrKernelBlocks() > 1;
+		std::fill(output, output + nrOutputRows * nrOutputCols, A());
+
+		// the spectrum of a data block and, with several kernel blocks, its product with the spectrum of a kernel block
+		workspace.resize(hasKernelBlocks ? 2 * gridSize : gridSize);
+		complex_type* dataSpectrum = workspace.data();
+		complex_type* product = hasKernelBlocks ? dataSpectrum + gridSize : dataSpectrum;
+
+		for (std::size_t dr = 0; dr < nrDataRows; dr += m_DataBlockRows)
+			for (std::size_t dc = 0; dc < nrDataCols; dc += m_DataBlockCols)
+			{
+				std::size_t nrBlockRows = std::min(m_DataBlockRows, nrDataRows - dr), nrBlockCols = std::min(m_DataBlockCols, nrDataCols - dc);
+				std::fill(dataSpectrum, dataSpectrum + gridSize, complex_type());
+				for (std::size_t r = 0; r != nrBlockRows; ++r)
+					std::copy(data + (dr + r) * nrDataCols + dc, data + (dr + r) * nrDataCols + dc + nrBlockCols, dataSpectrum + r * nrCols);
+				Transform(dataSpectrum, nrBlockRows, 0, false);
+
+				const complex_type* spectrum = m_Spectra.data();
+				for (std::size_t kr = 0; kr < m_NrKernelRows; kr += m_KernelBlockRows)
+					for (std::size_t kc = 0; kc < m_NrKernelCols; kc += m_KernelBlockCols, spectrum += gridSize)
+					{
+						std::size_t nrProductRows = nrBlockRows + std::min(m_KernelBlockRows, m_NrKernelRows - kr) - 1;
+						std::size_t nrProductCols = nrBlockCols + std::min(m_KernelBlockCols, m_NrKernelCols - kc) - 1;
+						for (std::size_t i = 0; i != gridSize; ++i)
+						{
+							complex_type a = dataSpectrum[i], b = spectrum[i];
+							product[i] = complex_type(a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real());
+						}
+						Transform(product, NrRows(), nrProductRows, true);
+
+						// the product is the convolution of the data block by the kernel block, which starts at the sum of their offsets
+						A* outputPtr = output + (dr + kr) * nrOutputCols + dc + kc;
+						for (std::size_t r = 0; r != nrProductRows; ++r, outputPtr += nrOutputCols)
+						{
+							const complex_type* rowPtr = product + r * nrCols;
+							for (std::size_t c = 0; c != nrProductCols; ++c)
+								outputPtr[c] += A(rowPtr[c].real());
+						}
+					}
+			}
+	}
+
+private:
+	// forward: rows [0, nrInputRows) may be non zero; inverse: only rows [0, nrOutputRows) are needed
+	void Transform(complex_type* grid, std::size_t nrInputRows, std::size_t nrOutputRows, bool inverse) const
+	{
+		std::size_t nrRows = NrRows(), nrCols = NrCols();
+		if (!inverse)
+			for (std::size_t r = 0; r != nrInputRows; ++r)
+				m_RowPlan.Transform(grid + r * nrCols, false);
+
+		std::vector<complex_type> columns(COLUMN_BLOCK_SIZE * nrRows);
+		for (std::size_t c = 0; c < nrCols; c += COLUMN_BLOCK_SIZE)
+		{
+			std::size_t nrBlockCols = std::min(COLUMN_BLOCK_SIZE, nrCols - c);
+			for (std::size_t r = 0; r != nrRows; ++r)
+				for (std::size_t b = 0; b != nrBlockCols; ++b)
+					columns[b * nrRows + r] = grid[r * nrCols + c + b];
+			for (std::size_t b = 0; b != nrBlockCols; ++b)
+				m_ColPlan.Transform(columns.data() + b * nrRows, inverse);
+			for (std::size_t r = 0; r != nrRows; ++r)
+				for (std::size_t b = 0; b != nrBlockCols; ++b)
+					grid[r * nrCols + c + b] = columns[b * nrRows + r];
+		}
+
+		if (inverse)
+			for (std::size_t r = 0; r != nrOutputRows; ++r)
+				m_RowPlan.Transform(grid + r * nrCols, true);
+	}
+
+	std::size_t               m_NrKernelRows, m_NrKernelCols;
+	std::size_t               m_KernelBlockRows, m_KernelBlockCols, m_DataBlockRows, m_DataBlockCols;
+	fft_plan<F>               m_RowPlan, m_ColPlan;
+	std::vector<complex_type> m_Spectra; // NrKernelBlocks() x NrRows() x NrCols()
+};
+
+#endif //!defined(__GEO_FFTCONVOLUTION_H)
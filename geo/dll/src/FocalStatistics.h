@@ -0,0 +1,609 @@
+// Copyright (C) 1998-2026 Object Vision b.v.
+// License: GNU GPL 3
+/////////////////////////////////////////////////////////////////////////////
+
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+File: FocalStatistics.h
+Purpose:
+- Focal statistics of a grid over square or circular windows, for the focal_* operators (see OperFocal.cpp).
+  Each function processes a focal_block of output cells of a row-major nrRows x nrCols grid, such that
+  the tiles of a grid can be processed concurrently, each with a copy of the cells within the radius around it.
+  Windows are clipped by the grid; undefined cells are skipped.
+
+Summary:
+- focal_window: the half width of each row of a window; a circle with radius r contains the cells with dx^2 + dy^2 <= r^2,
+  as TForm for diversity (see SpatialAnalyzer.h).
+- FocalSums: the sum and the number of defined values per window; for square windows with running column and row sums
+  in constant time per cell, for circles with row prefix sums in time proportional to the radius.
+- FocalExtremes: the minimum or maximum per window with the van Herk/Gil-Werman algorithm, which takes a fixed number of
+  comparisons per cell for any window width; square windows as a vertical and a horizontal pass,
+  circles as a horizontal pass per pair of window rows at the same distance, which have the same width.
+- FocalHistogram: a histogram of the classes in the window that is updated incrementally along a snake path through the block,
+  adding and removing the cells of the window borders only, as DiversityCalculator does; for square windows with
+  few classes compared to the radius, it adds and removes histograms of the window columns instead, as the median filter
+  of Perreault and Hebert, in time proportional to the number of classes per cell for any radius;
+  focal_majority_histogram and focal_percentile_histogram give the most frequent class and the class at a percentile.
+*/
+
+#if !defined(__GEO_FOCALSTATISTICS_H)
+#define __GEO_FOCALSTATISTICS_H
+
+#include <algorithm>
+#include <assert.h>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// *****************************************************************************
+// focal_window
+// *****************************************************************************
+
+struct focal_window
+{
+	focal_window(std::size_t radius, bool isCircle)
+		: m_HalfWidths(radius + 1, radius)
+	{
+		if (isCircle)
+			for (std::size_t d = 0; d <= radius; ++d)
+			{
+				std::size_t w = std::size_t(std::sqrt(double(radius * radius - d * d)));
+				while (w * w + d * d > radius * radius) --w;
+				while ((w + 1) * (w + 1) + d * d <= radius * radius) ++w;
+				m_HalfWidths[d] = w;
+			}
+	}
+
+	std::size_t Radius() const { return m_HalfWidths.size() - 1; }
+	std::size_t HalfWidth(std::ptrdiff_t d) const { return m_HalfWidths[std::size_t(d < 0 ? -d : d)]; } // of the row at offset d, and of the column at offset d
+	bool IsSquare() const { return m_HalfWidths.front() == m_HalfWidths.back(); }
+
+private:
+	std::vector<std::size_t> m_HalfWidths;
+};
+
+// the output cells [rowBegin, rowEnd) x [colBegin, colEnd) of a grid
+struct focal_block
+{
+	std::size_t rowBegin, rowEnd, colBegin, colEnd;
+};
+
+// the first and last + 1 column of a grid with nrCols columns that the windows of block cover
+inline std::pair<std::ptrdiff_t, std::ptrdiff_t> FocalColumns(std::size_t nrCols, const focal_window& window, const focal_block& block)
+{
+	std::ptrdiff_t r = window.Radius();
+	return { std::max<std::ptrdiff_t>(std::ptrdiff_t(block.colBegin) - r, 0), std::min<std::ptrdiff_t>(std::ptrdiff_t(block.colEnd) + r, nrCols) };
+}
+
+// *****************************************************************************
+// FocalSums
+// *****************************************************************************
+
+// calls func(row, col, sum, count) for each output cell of block
+template <typename ValueIter, typename IsDefinedFunc, typename Func>
+void FocalSums(ValueIter data, std::size_t nrRows, std::size_t nrCols, const focal_window& window, const focal_block& block, IsDefinedFunc&& isDefined, Func&& func)
+{
+	std::ptrdiff_t r = window.Radius();
+	std::ptrdiff_t nR = nrRows;
+	auto [c0, c1] = FocalColumns(nrCols, window, block);
+	auto value = [&](std::size_t i, double& sum, std::size_t& count)
+		{
+			auto v = data[i];
+			if (isDefined(v))
+			{
+				sum += double(v);
+				++count;
+			}
+		};
+
+	if (window.IsSquare())
+	{
+		// column sums over the window rows of the current row, of the columns [c0, c1)
+		std::vector<double> colSums(c1 - c0);
+		std::vector<std::ptrdiff_t> colCounts(c1 - c0);
+		auto addRow = [&](std::ptrdiff_t y, int sign)
+			{
+				if (y < 0 || y >= nR)
+					return;
+				for (std::ptrdiff_t c = c0; c != c1; ++c)
+				{
+					double s = 0; std::size_t n = 0;
+					value(y * nrCols + c, s, n);
+					colSums[c - c0] += sign * s;
+					colCounts[c - c0] += sign * std::ptrdiff_t(n);
+				}
+			};
+		for (std::ptrdiff_t y = std::ptrdiff_t(block.rowBegin) - r; y < std::ptrdiff_t(block.rowBegin) + r; ++y)
+			addRow(y, 1);
+		for (std::ptrdiff_t y = block.rowBegin; y != std::ptrdiff_t(block.rowEnd); ++y)
+		{
+			addRow(y + r, 1);
+			double sum = 0; std::size_t count = 0;
+			for (std::ptrdiff_t c = c0; c < std::min<std::ptrdiff_t>(block.colBegin + r, c1); ++c)
+			{
+				sum += colSums[c - c0];
+				count += colCounts[c - c0];
+			}
+			for (std::ptrdiff_t x = block.colBegin; x != std::ptrdiff_t(block.colEnd); ++x)
+			{
+				if (x + r < c1)
+				{
+					sum += colSums[x + r - c0];
+					count += colCounts[x + r - c0];
+				}
+				func(y, x, (count ? sum : 0.0), count);
+				if (x - r >= c0)
+				{
+					sum -= colSums[x - r - c0];
+					count -= colCounts[x - r - c0];
+				}
+			}
+			addRow(y - r, -1);
+		}
+		return;
+	}
+
+	// circles: prefix sums of the columns [c0, c1) of the rows of the block and the window rows around it
+	std::ptrdiff_t firstRow = std::max<std::ptrdiff_t>(std::ptrdiff_t(block.rowBegin) - r, 0), lastRow = std::min<std::ptrdiff_t>(std::ptrdiff_t(block.rowEnd) + r, nR);
+	std::size_t stride = c1 - c0 + 1;
+	std::vector<double> prefixSums((lastRow - firstRow) * stride);
+	std::vector<std::size_t> prefixCounts((lastRow - firstRow) * stride);
+	for (std::ptrdiff_t y = firstRow; y != lastRow; ++y)
+	{
+		double* ps = prefixSums.data() + (y - firstRow) * stride;
+		std::size_t* pc = prefixCounts.data() + (y - firstRow) * stride;
+		for (std::ptrdiff_t c = c0; c != c1; ++c)
+		{
+			double s = 0; std::size_t n = 0;
+			value(y * nrCols + c, s, n);
+			ps[c - c0 + 1] = ps[c - c0] + s;
+			pc[c - c0 + 1] = pc[c - c0] + n;
+		}
+	}
+	for (std::ptrdiff_t y = block.rowBegin; y != std::ptrdiff_t(block.rowEnd); ++y)
+		for (std::ptrdiff_t x = block.colBegin; x != std::ptrdiff_t(block.colEnd); ++x)
+		{
+			double sum = 0; std::size_t count = 0;
+			for (std::ptrdiff_t dy = -r; dy <= r; ++dy)
+			{
+				std::ptrdiff_t wy = y + dy;
+				if (wy < firstRow || wy >= lastRow)
+					continue;
+				std::ptrdiff_t w = window.HalfWidth(dy);
+				std::size_t begin = std::max<std::ptrdiff_t>(x - w, c0) - c0, end = std::min<std::ptrdiff_t>(x + w + 1, c1) - c0;
+				std::size_t offset = (wy - firstRow) * stride;
+				sum   += prefixSums  [offset + end] - prefixSums  [offset + begin];
+				count += prefixCounts[offset + end] - prefixCounts[offset + begin];
+			}
+			func(y, x, (count ? sum : 0.0), count);
+		}
+}
+
+// *****************************************************************************
+// FocalExtremes
+// *****************************************************************************
+
+template <typename T>
+struct focal_extreme
+{
+	T    value   = T();
+	bool defined = false;
+};
+
+template <typename T, typename Better>
+focal_extreme<T> CombineExtremes(const focal_extreme<T>& a, const focal_extreme<T>& b, const Better& better)
+{
+	if (!b.defined) return a;
+	if (!a.defined) return b;
+	return better(b.value, a.value) ? b : a;
+}
+
+// result[i] = best of input[i - w .. i + w], clipped to [0, n), with the van Herk/Gil-Werman algorithm:
+// within blocks of 2w+1 elements, prefix and suffix extremes combine to the extreme of any window of that width;
+// workspace receives both for the padded input.
+template <typename T, typename Better>
+void SlidingExtreme(const focal_extreme<T>* input, std::size_t n, std::size_t w, Better better, focal_extreme<T>* result, std::vector<focal_extreme<T>>& workspace)
+{
+	auto combine = [&better](const focal_extreme<T>& a, const focal_extreme<T>& b) { return CombineExtremes(a, b, better); };
+	std::size_t k = 2 * w + 1;
+	std::size_t paddedSize = ((n + 2 * w + k - 1) / k) * k;
+	workspace.assign(2 * paddedSize, focal_extreme<T>());
+	focal_extreme<T>* g = workspace.data();
+	focal_extreme<T>* h = g + paddedSize;
+	std::copy(input, input + n, g + w);
+	std::copy(input, input + n, h + w);
+	for (std::size_t blockBegin = 0; blockBegin != paddedSize; blockBegin += k)
+	{
+		for (std::size_t i = blockBegin + 1; i != blockBegin + k; ++i)
+			g[i] = combine(g[i - 1], g[i]);
+		for (std::size_t i = blockBegin + k - 1; i-- != blockBegin; )
+			h[i] = combine(h[i + 1], h[i]);
+	}
+	// the window of padded positions [i, i + 2w] for result i
+	for (std::size_t i = 0; i != n; ++i)
+		result[i] = combine(h[i], g[i + 2 * w]);
+}
+
+// calls func(row, col, extreme) for each output cell of block; better(a, b) is true if a must be preferred over b, such as a < b for the minimum
+template <typename T, typename ValueIter, typename IsDefinedFunc, typename Better, typename Func>
+void FocalExtremes(ValueIter data, std::size_t nrRows, std::size_t nrCols, const focal_window& window, const focal_block& block, IsDefinedFunc&& isDefined, Better better, Func&& func)
+{
+	std::ptrdiff_t r = window.Radius();
+	std::ptrdiff_t nR = nrRows;
+	std::ptrdiff_t firstRow = std::max<std::ptrdiff_t>(std::ptrdiff_t(block.rowBegin) - r, 0), lastRow = std::min<std::ptrdiff_t>(std::ptrdiff_t(block.rowEnd) + r, nR);
+	auto [c0, c1] = FocalColumns(nrCols, window, block);
+	std::size_t width = c1 - c0;
+
+	auto cell = [&](std::size_t i)
+		{
+			focal_extreme<T> result;
+			T v = data[i];
+			if (isDefined(v))
+			{
+				result.value = v;
+				result.defined = true;
+			}
+			return result;
+		};
+
+	std::vector<focal_extreme<T>> workspace, line, lineResult;
+	if (window.IsSquare())
+	{
+		// vertical pass per column of [c0, c1) into band, then a horizontal pass per row
+		std::size_t nrBandRows = block.rowEnd - block.rowBegin;
+		std::vector<focal_extreme<T>> band(nrBandRows * width);
+		line.resize(lastRow - firstRow);
+		lineResult.resize(lastRow - firstRow);
+		for (std::ptrdiff_t c = c0; c != c1; ++c)
+		{
+			for (std::ptrdiff_t y = firstRow; y != lastRow; ++y)
+				line[y - firstRow] = cell(y * nrCols + c);
+			SlidingExtreme(line.data(), line.size(), r, better, lineResult.data(), workspace);
+			for (std::size_t y = block.rowBegin; y != block.rowEnd; ++y)
+				band[(y - block.rowBegin) * width + (c - c0)] = lineResult[y - firstRow];
+		}
+		lineResult.resize(width);
+		for (std::size_t y = block.rowBegin; y != block.rowEnd; ++y)
+		{
+			SlidingExtreme(band.data() + (y - block.rowBegin) * width, width, r, better, lineResult.data(), workspace);
+			for (std::size_t x = block.colBegin; x != block.colEnd; ++x)
+				func(y, x, lineResult[x - c0]);
+		}
+		return;
+	}
+
+	// circles: each pair of window rows at offsets -dy and dy has its own width and is combined before a horizontal pass
+	std::vector<focal_extreme<T>> rows((lastRow - firstRow) * width);
+	for (std::ptrdiff_t y = firstRow; y != lastRow; ++y)
+		for (std::ptrdiff_t x = c0; x != c1; ++x)
+			rows[(y - firstRow) * width + (x - c0)] = cell(y * nrCols + x);
+	auto row = [&](std::ptrdiff_t y) { return (y < firstRow || y >= lastRow) ? nullptr : rows.data() + (y - firstRow) * width; };
+
+	std::vector<focal_extreme<T>> acc(width);
+	line.resize(width);
+	lineResult.resize(width);
+	for (std::ptrdiff_t y = block.rowBegin; y != std::ptrdiff_t(block.rowEnd); ++y)
+	{
+		std::fill(acc.begin(), acc.end(), focal_extreme<T>());
+		for (std::ptrdiff_t dy = 0; dy <= r; ++dy)
+		{
+			const focal_extreme<T>* above = row(y - dy);
+			const focal_extreme<T>* below = dy ? row(y + dy) : nullptr;
+			if (!above && !below)
+				continue;
+			if (above && below)
+				for (std::size_t x = 0; x != width; ++x)
+					line[x] = CombineExtremes(above[x], below[x], better);
+			else
+				std::copy(above ? above : below, (above ? above : below) + width, line.begin());
+			SlidingExtreme(line.data(), width, window.HalfWidth(dy), better, lineResult.data(), workspace);
+			for (std::size_t x = 0; x != width; ++x)
+				acc[x] = CombineExtremes(acc[x], lineResult[x], better);
+		}
+		for (std::size_t x = block.colBegin; x != block.colEnd; ++x)
+			func(y, x, acc[x - c0]);
+	}
+}
+
+// *****************************************************************************
+// FocalHistogram
+// *****************************************************************************
+
+// the classes of a window as counts per class, in the leaves of a tree of which each node has the highest count of its two children,
+// such that adding or removing a class and finding the most frequent class take time logarithmic in the number of classes;
+// the smallest class is taken if several have the highest count
+struct focal_majority_histogram
+{
+	explicit focal_majority_histogram(std::size_t nrClasses)
+		: m_NrClasses(nrClasses)
+	{
+		while (m_NrLeaves < nrClasses)
+			m_NrLeaves *= 2;
+		m_Tree.resize(2 * m_NrLeaves);
+	}
+
+	std::size_t NrClasses() const { return m_NrClasses; }
+	std::size_t Total() const { return m_Total; }
+
+	void Add(std::size_t c)
+	{
+		assert(c < m_NrClasses);
+		++m_Total;
+		std::size_t i = m_NrLeaves + c;
+		auto n = ++m_Tree[i];
+		if (m_IsStale)
+			return;
+		for (i /= 2; i && m_Tree[i] < n; i /= 2)
+			m_Tree[i] = n;
+	}
+	void Remove(std::size_t c)
+	{
+		std::size_t i = m_NrLeaves + c;
+		assert(m_Tree[i]);
+		--m_Tree[i];
+		--m_Total;
+		if (m_IsStale)
+			return;
+		for (i /= 2; i; i /= 2)
+		{
+			auto n = std::max(m_Tree[2 * i], m_Tree[2 * i + 1]);
+			if (m_Tree[i] == n)
+				break;
+			m_Tree[i] = n;
+		}
+	}
+
+	// adds or removes the counts per class of a column of the window; the tree is rebuilt by the next Majority()
+	void AddCounts(const std::uint32_t* counts)
+	{
+		for (std::size_t c = 0; c != m_NrClasses; ++c)
+		{
+			m_Tree[m_NrLeaves + c] += counts[c];
+			m_Total += counts[c];
+		}
+		m_IsStale = true;
+	}
+	void RemoveCounts(const std::uint32_t* counts)
+	{
+		for (std::size_t c = 0; c != m_NrClasses; ++c)
+		{
+			assert(m_Tree[m_NrLeaves + c] >= counts[c]);
+			m_Tree[m_NrLeaves + c] -= counts[c];
+			m_Total -= counts[c];
+		}
+		m_IsStale = true;
+	}
+
+	// Total() must be positive
+	std::size_t Majority()
+	{
+		assert(m_Total);
+		if (m_IsStale)
+		{
+			for (std::size_t i = m_NrLeaves; --i; )
+				m_Tree[i] = std::max(m_Tree[2 * i], m_Tree[2 * i + 1]);
+			m_IsStale = false;
+		}
+		std::size_t i = 1;
+		while (i < m_NrLeaves)
+			i = (m_Tree[2 * i] == m_Tree[i]) ? 2 * i : 2 * i + 1;
+		return i - m_NrLeaves;
+	}
+
+private:
+	std::size_t m_NrClasses, m_NrLeaves = 1, m_Total = 0;
+	std::vector<std::uint32_t> m_Tree; // node i has children 2i and 2i+1; the count of class c is at m_NrLeaves + c
+	bool m_IsStale = false;
+};
+
+// the classes of a window as counts per class, and a class with the number of window cells of lower classes,
+// which moves to the requested rank, as the median filter of Huang, Yang and Tang
+struct focal_percentile_histogram
+{
+	explicit focal_percentile_histogram(std::size_t nrClasses) : m_Counts(nrClasses) {}
+
+	std::size_t NrClasses() const { return m_Counts.size(); }
+	std::size_t Total() const { return m_Total; }
+
+	void Add(std::size_t c)
+	{
+		++m_Counts[c];
+		++m_Total;
+		if (c < m_Class)
+			++m_NrBelow;
+	}
+	void Remove(std::size_t c)
+	{
+		assert(m_Counts[c]);
+		--m_Counts[c];
+		--m_Total;
+		if (c < m_Class)
+			--m_NrBelow;
+	}
+
+	// adds or removes the counts per class of a column of the window
+	void AddCounts(const std::uint32_t* counts)
+	{
+		for (std::size_t c = 0, n = m_Counts.size(); c != n; ++c)
+		{
+			m_Counts[c] += counts[c];
+			m_Total += counts[c];
+			if (c < m_Class)
+				m_NrBelow += counts[c];
+		}
+	}
+	void RemoveCounts(const std::uint32_t* counts)
+	{
+		for (std::size_t c = 0, n = m_Counts.size(); c != n; ++c)
+		{
+			assert(m_Counts[c] >= counts[c]);
+			m_Counts[c] -= counts[c];
+			m_Total -= counts[c];
+			if (c < m_Class)
+				m_NrBelow -= counts[c];
+		}
+	}
+
+	// the class of the value with rank ceil(percentage / 100 * Total()), but at least 1, in the sorted window; Total() must be positive
+	std::size_t Percentile(double percentage)
+	{
+		assert(m_Total);
+		std::size_t rank = std::size_t(std::ceil(percentage / 100.0 * double(m_Total)));
+		rank = std::clamp<std::size_t>(rank, 1, m_Total);
+		while (m_NrBelow >= rank)
+			m_NrBelow -= m_Counts[--m_Class];
+		while (m_NrBelow + m_Counts[m_Class] < rank)
+			m_NrBelow += m_Counts[m_Class++];
+		return m_Class;
+	}
+
+private:
+	std::vector<std::uint32_t> m_Counts;
+	std::size_t m_Total = 0, m_Class = 0, m_NrBelow = 0;
+};
+
+// the maximum number of classes for which FocalHistogram uses column histograms, which take nrClasses counts per column
+const std::size_t focal_max_column_histogram_classes = 256;
+
+// FocalHistogram for square windows with histograms of the classes of each column of [c0, c1) over the window rows of the current row,
+// as Perreault and Hebert: a horizontal move adds the histogram of the column that enters the window and removes the one that leaves,
+// and a move down updates the histogram of each column with the cells of the rows that enter and leave, and the window with those in it.
+template <typename ValueIter, typename IsDefinedFunc, typename ClassFunc, typename Histogram, typename Func>
+void FocalColumnHistograms(ValueIter data, std::size_t nrRows, std::size_t nrCols, const focal_window& window, const focal_block& block, IsDefinedFunc&& isDefined, ClassFunc&& classOf, Histogram& histogram, Func&& func)
+{
+	assert(window.IsSquare());
+	std::ptrdiff_t r = window.Radius();
+	std::ptrdiff_t nR = nrRows;
+	std::size_t nrClasses = histogram.NrClasses();
+	auto [c0, c1] = FocalColumns(nrCols, window, block);
+	std::vector<std::uint32_t> columnCounts((c1 - c0) * nrClasses);
+	auto column = [&](std::ptrdiff_t c) { return columnCounts.data() + (c - c0) * nrClasses; };
+
+	// adds or removes the cells of row y to the column histograms, and to histogram for the window columns around x
+	auto updateRow = [&](std::ptrdiff_t y, std::ptrdiff_t x, bool add)
+		{
+			if (y < 0 || y >= nR)
+				return;
+			for (std::ptrdiff_t c = c0; c != c1; ++c)
+			{
+				auto v = data[y * nrCols + c];
+				if (!isDefined(v))
+					continue;
+				std::size_t k = classOf(v);
+				bool isInWindow = (c >= x - r && c <= x + r);
+				if (add)
+				{
+					++column(c)[k];
+					if (isInWindow)
+						histogram.Add(k);
+				}
+				else
+				{
+					assert(column(c)[k]);
+					--column(c)[k];
+					if (isInWindow)
+						histogram.Remove(k);
+				}
+			}
+		};
+
+	std::ptrdiff_t y = block.rowBegin, x = block.colBegin;
+	for (std::ptrdiff_t dy = -r; dy <= r; ++dy)
+		updateRow(y + dy, x, true);
+	std::ptrdiff_t step = 1;
+	while (true)
+	{
+		func(y, x, histogram);
+		if (x + step >= std::ptrdiff_t(block.colBegin) && x + step < std::ptrdiff_t(block.colEnd))
+		{
+			std::ptrdiff_t leaving = x - step * r, entering = x + step * (r + 1);
+			if (leaving >= c0 && leaving < c1)
+				histogram.RemoveCounts(column(leaving));
+			if (entering >= c0 && entering < c1)
+				histogram.AddCounts(column(entering));
+			x += step;
+			continue;
+		}
+		if (y + 1 == std::ptrdiff_t(block.rowEnd))
+			break;
+		updateRow(y - r, x, false);
+		updateRow(y + r + 1, x, true);
+		++y;
+		step = -step;
+	}
+}
+
+// calls func(row, col, histogram) for each output cell of block after histogram contains the classes classOf(v) of the defined values v in its window.
+// The window moves along the rows of the block from left to right and back, and one row down at each end,
+// such that each move adds and removes one window border.
+template <typename ValueIter, typename IsDefinedFunc, typename ClassFunc, typename Histogram, typename Func>
+void FocalHistogram(ValueIter data, std::size_t nrRows, std::size_t nrCols, const focal_window& window, const focal_block& block, IsDefinedFunc&& isDefined, ClassFunc&& classOf, Histogram& histogram, Func&& func)
+{
+	if (block.rowBegin == block.rowEnd || block.colBegin == block.colEnd)
+		return;
+	std::size_t nrClasses = histogram.NrClasses();
+	if (window.IsSquare() && nrClasses <= window.Radius() && nrClasses <= focal_max_column_histogram_classes)
+	{
+		FocalColumnHistograms(data, nrRows, nrCols, window, block, isDefined, classOf, histogram, func);
+		return;
+	}
+
+	std::ptrdiff_t r = window.Radius();
+	std::ptrdiff_t nR = nrRows, nC = nrCols;
+
+	auto update = [&](std::ptrdiff_t y, std::ptrdiff_t x, bool add)
+		{
+			if (y < 0 || y >= nR || x < 0 || x >= nC)
+				return;
+			auto v = data[y * nrCols + x];
+			if (!isDefined(v))
+				return;
+			if (add)
+				histogram.Add(classOf(v));
+			else
+				histogram.Remove(classOf(v));
+		};
+
+	std::ptrdiff_t y = block.rowBegin, x = block.colBegin;
+	for (std::ptrdiff_t dy = -r; dy <= r; ++dy)
+	{
+		std::ptrdiff_t w = window.HalfWidth(dy);
+		for (std::ptrdiff_t dx = -w; dx <= w; ++dx)
+			update(y + dy, x + dx, true);
+	}
+	std::ptrdiff_t step = 1;
+	while (true)
+	{
+		func(y, x, histogram);
+		if (x + step >= std::ptrdiff_t(block.colBegin) && x + step < std::ptrdiff_t(block.colEnd))
+		{
+			// the cells at the row ends of the window leave at the back and enter at the front
+			for (std::ptrdiff_t dy = -r; dy <= r; ++dy)
+			{
+				std::ptrdiff_t w = window.HalfWidth(dy);
+				update(y + dy, x - step * w, false);
+				update(y + dy, x + step * (w + 1), true);
+			}
+			x += step;
+			continue;
+		}
+		if (y + 1 == std::ptrdiff_t(block.rowEnd))
+			break;
+		// the cells at the column ends of the window leave at the top and enter at the bottom
+		for (std::ptrdiff_t dx = -r; dx <= r; ++dx)
+		{
+			std::ptrdiff_t h = window.HalfWidth(dx);
+			update(y - h, x + dx, false);
+			update(y + h + 1, x + dx, true);
+		}
+		++y;
+		step = -step;
+	}
+}
+
+#endif //!defined(__GEO_FOCALSTATISTICS_H)
@@ -8,6 +8,7 @@
 #pragma hdrstop
 #endif
 
+#include <array>
 #include <numbers> // std::numbers
 
 #include "gdal/gdal_base.h" 
@@ -16,6 +17,7 @@
 #include <ogr_spatialref.h>
 
 #include "Dijkstra.h"
+#include "ParallelTiles.h"
 
 #include "dbg/SeverityType.h"
 #include "CheckedDomain.h"
@@ -72,6 +74,9 @@ DisplacementInfo displacement_info[9] =
 	{ 1,  1, Directions(D_South|D_East), Directions(D_North|D_West), 0.5 * std::numbers::sqrt2_v<Float64>},
 };
 
+// the maximum number of pairs of raster sweeps per visit of a tile by griddist_sweep before it continues with Dijkstra
+constexpr SizeT GRIDDIST_MAX_SWEEP_PAIRS = 4;
+
 enum class GridDistFlags
 {
 	NoFlags = 0,
@@ -80,6 +85,7 @@ enum class GridDistFlags
 	UseShadowTile = 4,
 	HasLatitudeFactor = 8,
 	HasZonalBoundaryImpedance = 16,
+	UseSweeping = 32,
 
 	HasBothParamters = HasLimitParameter | HasInitialImpedance,
 	HasLimitParameterAndUseShadowTile = HasLimitParameter | UseShadowTile,
@@ -376,19 +382,17 @@ public:
 		bool useShadowTile = m_Flags & GridDistFlags::UseShadowTile;
 		bool useLatFactor  = m_Flags & GridDistFlags::HasLatitudeFactor;
 
+		bool useSweeping   = m_Flags & GridDistFlags::UseSweeping;
+		std::atomic<SizeT> nrSweepPairs = 0, nrSweepFallbacks = 0;
+
 		tile_id tn = useShadowTile ? 1 : adiGridImp->GetAbstrDomainUnit()->GetNrTiles();
 		intertile_map itMap(useShadowTile ? 0 : tn);
-		tile_id nrTilesRemaining = tn;
-
-		int offsets[9] = {}; // TODO OPTIMIZE: memoize the offsets for the previous used nrC
-		NodeType nrUsedC_for_offsets_memoization = 0;
-		ZoneID zonalID = 0;
 
-		SizeT nrIterations = 0, nrPrevBorderCases = 0;
-		while (nrTilesRemaining)
-		{ 
-			// iterate through the set of tiles
-			for (tile_id t = 0; t!=tn; ++t) if (useShadowTile || !itMap[t].m_IsDone)
+		// Dijkstra within tile t from the start points and the border cases of itMap[t];
+		// it only writes to the results of tile t and to itMap[t], thus different tiles are processed concurrently.
+		// With UseSweeping, at most GRIDDIST_MAX_SWEEP_PAIRS pairs of raster sweeps relax the tile first;
+		// if they don't converge, as with obstacles, the Dijkstra loop continues from the impedances found by the sweeps.
+		auto processTile = [&](tile_id t)
 			{
 				auto pseudoTile = useShadowTile ? no_tile : t;
 				auto costData  = diGridImp->GetDataRead(pseudoTile);
@@ -404,11 +408,9 @@ public:
 					dh.m_MaxImp = maxImp;
 
 				NodeType nrC = Width(range);
-				if (nrC != nrUsedC_for_offsets_memoization)
-				{
-					for (UInt32 i = 1; i != 9; ++i) offsets[i] = displacement_info[i].dx + displacement_info[i].dy * nrC;
-					nrUsedC_for_offsets_memoization = nrC;
-				}
+				int offsets[9] = {};
+				for (UInt32 i = 1; i != 9; ++i) offsets[i] = displacement_info[i].dx + displacement_info[i].dy * nrC;
+				ZoneID zonalID = 0;
 				assert(costData.size() == nrV); typename sequence_traits<ImpType>::cseq_t::const_iterator costDataPtr = costData.begin();
 
 				assert(resultData   .size() == nrV); dh.m_ResultDataPtr    = resultData.begin();
@@ -454,6 +456,25 @@ public:
 						dh.InsertNode(*first, *firstDist, *firstEdge);
 				}
 
+				if (useSweeping)
+				{
+					UInt32 firstLatFactorRow = useLatFactor ? Range_GetIndex_checked(yRange, range.first.Y()) : 0;
+					SizeT nrPairs = 0;
+					bool isConverged = CalcBySweeping(costData.begin(), diZonalGrid ? zonalData.begin() : nullptr, resultData.begin(), traceBackData.begin()
+					,	nrC, Height(range), dh.m_MaxImp, boundaryFactor, useLatFactor, latFactors, firstLatFactorRow, GRIDDIST_MAX_SWEEP_PAIRS, nrPairs
+					);
+					nrSweepPairs += nrPairs;
+					if (isConverged)
+						dh.Clear();
+					else
+					{
+						// all impedances below m_MaxImp are reachable, thus continuing from them gives the same result as from the start
+						++nrSweepFallbacks;
+						for (NodeType v = 0; v != nrV; ++v)
+							dh.PushTentative(v);
+					}
+				}
+
 				// iterate through buffer until all destinations in the current tile are processed.
 				while (!dh.Empty())
 				{
@@ -509,139 +530,275 @@ public:
 				for (auto& x : resultData)
 					if (x >= dh.m_MaxImp)
 						x = UNDEFINED_VALUE(ImpType);
-			}
-			
+			};
 
-			if (useShadowTile)
-				break;
-
-			nrTilesRemaining = 0;
-
-			// Store the border cases to other tiles for next iterations
-			typename Arg1Type::locked_cseq_t costData1, costData2; // be lazy in locking and unlocking tiles
-			typename DataArray<ZoneID>::locked_cseq_t zonalData1, zonalData2;
+		// the tiles that share a border or a corner with tile t, in increasing order
+		std::vector<std::vector<tile_id>> tileNeighbours(itMap.size());
+		parallel_for<tile_id>(itMap.size(), [&](tile_id t)
+			{
+				Range<Grid> range_inflated = Inflate(gridSet->GetTileRange(t), Grid(1, 1));
+				auto& neighbours = tileNeighbours[t];
+				auto addIfAdjacent = [&](tile_id u)
+					{
+						if (u != t && !(range_inflated & gridSet->GetTileRange(u)).empty())
+							neighbours.emplace_back(u);
+					};
+				if (gridSet->IsCovered()) // regular and default tilings only
+				{
+					// only t-1, t+1 and t-nrTC-1 ... t-nrTC+1, t+nrTC-1 ... t+nrTC+1 can intersect with range_inflated,
+					// where nrTC is the number of tiles in a row, i.e.:RegularAdapter<Base>::tiling_extent()
+					Int64 nrTilesInRow = gridSet->GetCurrSegmInfo()->GetTilingExtent().Col();
+					for (Int64 dRow = -1; dRow <= 1; ++dRow)
+						for (Int64 dCol = -1; dCol <= 1; ++dCol)
+						{
+							Int64 u = Int64(t) + dRow * nrTilesInRow + dCol;
+							if (u >= 0 && u < Int64(tn))
+								addIfAdjacent(u);
+						}
+					std::sort(neighbours.begin(), neighbours.end());
+					neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+				}
+				else // for irregular tilings, the number of tiles in a row is not known, so all tiles have to be enumerated
+					for (tile_id u = 0; u != tn; ++u)
+						addIfAdjacent(u);
+			}
+		);
 
-			for (tile_id t1=0; t1!=tn; ++t1)
+		// adds the border cases of the adjacent cells of tiles t1 < t2 to itMap[target] for target t1 or t2;
+		// only reads the results of both tiles. Returns true if a border case was added.
+		auto addBorderCases = [&](tile_id t1, tile_id t2, tile_id target) -> bool
 			{
+				assert(t1 < t2 && (target == t1 || target == t2));
 				Range<Grid> range1 = gridSet->GetTileRange(t1);
 				Range<Grid> range1_inflated = Inflate(range1, Grid(1,1));
+				Range<Grid> range2 = gridSet->GetTileRange(t2);
+				Range<Grid> intersect = (range1_inflated &  range2);
+				if (intersect.empty())
+					return false;
 
-				for (tile_id t2=t1+1; t2!=tn; ++t2)
+				auto costData1 = diGridImp->GetTile(t1);
+				auto costData2 = diGridImp->GetTile(t2);
+
+				typename DataArray<ZoneID>::locked_cseq_t zonalData1, zonalData2;
+				if (diZonalGrid)
 				{
-					if (gridSet->IsCovered()) // regular and default tilings only
-					{
-						// limit the number of candidate tiles that could intersect with range1_inflated
-						// enumerate the 4: t1+1, t1+nrTC - 1 ... t1+nrTC + 1
-						// where nrTC is the number of tiles in a row, i.e.:RegularAdapter<Base>::tiling_extent()
-						// for irregular tilings, the number of tiles in a row is not known, so all tiles have to be enumerated
-						auto nrTilesInRow = gridSet->GetCurrSegmInfo()->GetTilingExtent().Col();
-
-						if (t2 == t1 + 2)
-							MakeMax(t2, t1 + nrTilesInRow - 1); // jump to previous column in the next row, if that is beyond t1+2
-						else if (t2 == t1 + nrTilesInRow + 2)
-							break; // exit processing t2's as they are beyond (+1, +1)
-						if (t2 >= tn)
-							break; // exit processing t2's as they are beyond the last tile
-					}
+					zonalData1 = diZonalGrid->GetTile(t1);
+					zonalData2 = diZonalGrid->GetTile(t2);
+				}
 
-					Range<Grid> range2 = gridSet->GetTileRange(t2);
-					Range<Grid> intersect = (range1_inflated &  range2);
-					if (intersect.empty()) 
-						continue;
+				auto resultData1 = result->GetTile(t1);
+				auto resultData2 = result->GetTile(t2);
 
-					costData1 = diGridImp->GetTile(t1);
-					costData2 = diGridImp->GetTile(t2);
+				bool isAdded = false;
+				SizeT intersectCount = Cardinality(intersect);
+				for (SizeT ii=0; ii!=intersectCount; ++ii)
+				{
+					Grid p = Range_GetValue_naked(intersect, ii);
+					SizeT i2 = Range_GetIndex_naked(range2, p);
+					ImpType
+						oldResData2 = resultData2[i2],
+						deltaCost2 = costData2[i2];
+					if (!IsDefined(deltaCost2))
+						continue;
+					MakeMax<ImpType>(deltaCost2, ImpType()); // raise negative values to zero.
 
+					ZoneID zoneID = 0;
 					if (diZonalGrid)
-					{
-						zonalData1 = diZonalGrid->GetTile(t1);
-						zonalData2 = diZonalGrid->GetTile(t2);
-					}
-
-					auto resultData1 = result->GetWritableTile(t1, dms_rw_mode::read_write);
-					auto resultData2 = result->GetWritableTile(t2, dms_rw_mode::read_write);
+						zoneID = zonalData2[i2];
 
-					SizeT intersectCount = Cardinality(intersect);
-					for (SizeT ii=0; ii!=intersectCount; ++ii)
+					UInt32 row = 0;
+					if (useLatFactor)
+						row = Range_GetIndex_checked(yRange, p.Y());
+					for (UInt32 i=1; i!=9; ++i)
 					{
-						Grid p = Range_GetValue_naked(intersect, ii);
-						SizeT i2 = Range_GetIndex_naked(range2, p);
-						ImpType
-							oldResData2 = resultData2[i2],
-							deltaCost2 = costData2[i2];
-						if (!IsDefined(deltaCost2))
+						Grid q = p + shp2dms_order(Grid(displacement_info[i].dx, displacement_info[i].dy));
+						if (!IsIncluding(range1, q))
+							continue;
+						SizeT i1 = Range_GetIndex_naked(range1, q);
+						ImpType oldResData1 = resultData1[i1];
+						if (!IsDefined(oldResData1) || oldResData1 >= maxImp)
+							if (!IsDefined(oldResData2) || oldResData2 >= maxImp)
+								continue;
+
+						ImpType deltaCost = costData1[i1];
+						if (!IsDefined(deltaCost))
 							continue;
-						MakeMax<ImpType>(deltaCost2, ImpType()); // raise negative values to zero.
+						MakeMax<ImpType>(deltaCost, ImpType()); // raise negative values to zero.
+						deltaCost +=  deltaCost2;
+						deltaCost *= displacement_info[i].getFactor(useLatFactor, latFactors, row);
 
-						ZoneID zoneID = 0;
-						if (diZonalGrid)
-							zoneID = zonalData2[i2];
+						if (diZonalGrid && zoneID != zonalData1[i1])
+							deltaCost += boundaryFactor;
+
+						assert(deltaCost >= 0);
+						if (deltaCost >= maxImp)
+							continue;
 
-						UInt32 row = 0;
-						if (useLatFactor)
-							row = Range_GetIndex_checked(yRange, p.Y());
-						for (UInt32 i=1; i!=9; ++i)
+						if (target == t1 && IsDefined(oldResData2))
 						{
-							Grid q = p + shp2dms_order(Grid(displacement_info[i].dx, displacement_info[i].dy));
-							if (!IsIncluding(range1, q))
-								continue;
-							SizeT i1 = Range_GetIndex_naked(range1, q);
-							ImpType oldResData1 = resultData1[i1];
-							if (!IsDefined(oldResData1) || oldResData1 >= maxImp)
-								if (!IsDefined(oldResData2) || oldResData2 >= maxImp)
-									continue;
-
-							ImpType deltaCost = costData1[i1];
-							if (!IsDefined(deltaCost))
-								continue;
-							MakeMax<ImpType>(deltaCost, ImpType()); // raise negative values to zero.
-							deltaCost +=  deltaCost2;
-							deltaCost *= displacement_info[i].getFactor(useLatFactor, latFactors, row);
+							ImpType newResData1 = oldResData2 + deltaCost;
+							if (newResData1 < maxImp && itMap[t1].AddBorderCase(i1, oldResData1, newResData1, displacement_info[i].d))
+								isAdded = true;
+						}
+						if (target == t2 && IsDefined(oldResData1))
+						{
+							ImpType newResData2 = oldResData1 + deltaCost;
+							if (newResData2 < maxImp && itMap[t2].AddBorderCase(i2, oldResData2, newResData2, displacement_info[i].r))
+								isAdded = true;
+						}
+					}	// next direction
+				}	// next boundary
+				return isAdded;
+			};
 
-							if (diZonalGrid && zoneID != zonalData1[i1])
-								deltaCost += boundaryFactor;
+		if (useShadowTile)
+			processTile(no_tile);
 
-							assert(deltaCost >= 0);
-							if (deltaCost >= maxImp)
-								continue;
+		std::vector<tile_id> pendingTiles;
+		std::vector<bool> isProcessed(itMap.size());
+		SizeT nrIterations = 0, nrPrevBorderCases = 0;
+		while (!useShadowTile)
+		{
+			pendingTiles.clear();
+			for (tile_id t = 0; t!=tn; ++t)
+			{
+				isProcessed[t] = !itMap[t].m_IsDone;
+				if (isProcessed[t])
+					pendingTiles.emplace_back(t);
+			}
+			if (pendingTiles.empty())
+				break;
 
-							if (IsDefined(oldResData2))
-							{
-								ImpType newResData1 = oldResData2 + deltaCost;
-								if (newResData1 < maxImp && itMap[t1].AddBorderCase(i1, oldResData1, newResData1, displacement_info[i].d))
-								if (itMap[t1].m_IsDone)
-								{
-									itMap[t1].m_IsDone = false;
-									++nrTilesRemaining;
-								}
-							}
-							if (IsDefined(oldResData1))
-							{
-								ImpType newResData2 = oldResData1 + deltaCost;
-								if (newResData2 < maxImp && itMap[t2].AddBorderCase(i2, oldResData2, newResData2, displacement_info[i].r))
-								if (itMap[t2].m_IsDone)
-								{
-									itMap[t2].m_IsDone = false;
-									++nrTilesRemaining;
-								}
-							}
-						}	// next direction
-					}	// next boundary
-				}	// next t2
-			}	// next t1
+			// iterate through the set of tiles that are not done
+			parallel_for<tile_id>(pendingTiles.size(), [&](tile_id i) { processTile(pendingTiles[i]); });
+
+			// Store the border cases to other tiles for next iterations; the task of each tile t only adds to itMap[t].
+			// Visiting the neighbours in increasing order adds the border cases of t in the same order as a serial pass over all pairs of tiles would,
+			// thus results don't depend on the scheduling. Pairs of tiles that were both left unchanged in this iteration cannot add border cases.
+			std::atomic<tile_id> nrTilesRemaining = 0;
+			parallel_for<tile_id>(tn, [&](tile_id t)
+				{
+					bool isAdded = false;
+					for (tile_id u : tileNeighbours[t])
+						if (isProcessed[t] || isProcessed[u])
+							if (u < t ? addBorderCases(u, t, t) : addBorderCases(t, u, t))
+								isAdded = true;
+					if (isAdded)
+					{
+						itMap[t].m_IsDone = false;
+						++nrTilesRemaining;
+					}
+				}
+			);
 
 			SizeT numBorderCases = 0;
 			for (auto i=itMap.begin(), e=itMap.end(); i!=e; ++i)
 				numBorderCases += i->m_NumBorderCases;
 
-			reportF(SeverityTypeID::ST_MajorTrace, "GridDist completed iteration %d; %d of the %d tiles need reprocessing for %d border cases (%d extra)", ++nrIterations, nrTilesRemaining, tn, numBorderCases, numBorderCases - nrPrevBorderCases);
+			reportF(SeverityTypeID::ST_MajorTrace, "GridDist completed iteration %d; %d of the %d tiles need reprocessing for %d border cases (%d extra)", ++nrIterations, tile_id(nrTilesRemaining), tn, numBorderCases, numBorderCases - nrPrevBorderCases);
 			nrPrevBorderCases = numBorderCases;
-		}	// next iteration 
+		}	// next iteration
+		if (useSweeping)
+			reportF(SeverityTypeID::ST_MajorTrace, "%s completed %d pairs of sweeps; %d tile visits did not converge within %d pairs and were completed by Dijkstra"
+			,	SharedStr(GetGroup()->GetNameID()).c_str(), SizeT(nrSweepPairs), SizeT(nrSweepFallbacks), GRIDDIST_MAX_SWEEP_PAIRS
+			);
 		resLock.Commit();
 		tbLock.Commit();
 
 		return true;
 	}
+
+private:
+	// Determines the same impedances as the Dijkstra loop in CreateResult within one tile, i.e. the smallest solution of
+	// d[q] = min(start[q], min over the 8 neighbours p of q: d[p] + (cost[p] + cost[q]) * factor(p, q) [+ boundary impedance]),
+	// by relaxing all cells in alternating downward and upward raster sweeps until no impedance decreases; no heap is used.
+	// A sweep first relaxes each row from its preceding row, which is independent per cell,
+	// and then from left to right and from right to left within the row.
+	// Uniform impedances converge after one or two pairs of sweeps; each turn back around an obstacle requires another pair,
+	// therefore at most maxNrSweepPairs pairs are done. Of paths with equal impedance, the traceback can select another one than the Dijkstra loop.
+	// Returns true if the last pair of sweeps decreased no impedance; nrSweepPairs is set to the number of pairs done.
+	// Row r of the tile uses the latitude factors of latFactors[firstLatFactorRow + r].
+	bool CalcBySweeping(const ImpType* costData, const ZoneID* zonalData, ImpType* resultData, LinkType* traceBackData
+	,	NodeType nrC, NodeType nrR, ImpType maxImp, ImpType boundaryFactor, bool useLatFactor, const std::vector<Couple<Float64>>& latFactors, UInt32 firstLatFactorRow
+	,	SizeT maxNrSweepPairs, SizeT& nrSweepPairs) const
+	{
+		nrSweepPairs = 0;
+		if (!nrC || !nrR)
+			return true;
+
+		// the factors of the displacements from the cells of each row; as getFactor, but without its checks in the inner loops
+		std::vector<std::array<Float64, 9>> rowFactors(useLatFactor ? nrR : 1);
+		for (UInt32 row = 0; row != rowFactors.size(); ++row)
+			for (UInt32 i = 1; i != 9; ++i)
+				rowFactors[row][i] = displacement_info[i].getFactor(useLatFactor, latFactors, firstLatFactorRow + row);
+		auto factorsOf = [&](NodeType row) -> const Float64* { return rowFactors[useLatFactor ? row : 0].data(); };
+
+		// relaxes q from p in direction i, as the Dijkstra loop calculates newImp
+		auto relax = [=](SizeT p, SizeT q, UInt32 i, const Float64* factors) -> bool
+			{
+				ImpType currImp = resultData[p];
+				if (!(currImp < maxImp))
+					return false;
+				ImpType cellDist = costData[p];
+				ImpType deltaCost = costData[q];
+				if (!IsDefined(cellDist) || !IsDefined(deltaCost))
+					return false;
+				MakeMax<ImpType>(cellDist, ImpType()); // raise negative values to zero.
+				MakeMax<ImpType>(deltaCost, ImpType());
+				deltaCost += cellDist;
+				deltaCost *= factors[i];
+				if (zonalData && zonalData[p] != zonalData[q])
+					deltaCost += boundaryFactor;
+
+				auto newImp = currImp + deltaCost;
+				if (!(newImp < resultData[q]))
+					return false;
+				resultData[q] = newImp;
+				traceBackData[q] = displacement_info[i].d;
+				return true;
+			};
+
+		// relaxes row from the preceding row in sweep direction dy and then within row
+		auto sweepRow = [&](NodeType row, int dy) -> bool
+			{
+				bool isChanged = false;
+				SizeT rowStart = SizeT(row) * nrC;
+				if (row != (dy > 0 ? 0 : nrR - 1))
+				{
+					NodeType prevRow = row - dy;
+					SizeT prevRowStart = SizeT(prevRow) * nrC;
+					const Float64* factors = factorsOf(prevRow);
+					// the displacements (-1, dy), (0, dy) and (+1, dy) from the preceding row, see displacement_info
+					UInt32 iFromLeft = dy > 0 ? 8 : 3, iFromAbove = dy > 0 ? 7 : 2, iFromRight = dy > 0 ? 6 : 1;
+					for (NodeType c = 0; c != nrC; ++c)
+					{
+						if (c)
+							isChanged |= relax(prevRowStart + c - 1, rowStart + c, iFromLeft, factors);
+						isChanged |= relax(prevRowStart + c, rowStart + c, iFromAbove, factors);
+						if (c + 1 != nrC)
+							isChanged |= relax(prevRowStart + c + 1, rowStart + c, iFromRight, factors);
+					}
+				}
+				const Float64* factors = factorsOf(row);
+				for (NodeType c = 1; c < nrC; ++c)
+					isChanged |= relax(rowStart + c - 1, rowStart + c, 5, factors);
+				for (NodeType c = nrC; c-- > 1; )
+					isChanged |= relax(rowStart + c, rowStart + c - 1, 4, factors);
+				return isChanged;
+			};
+
+		bool isChanged = true;
+		while (isChanged && nrSweepPairs != maxNrSweepPairs)
+		{
+			isChanged = false;
+			for (NodeType row = 0; row != nrR; ++row)
+				isChanged |= sweepRow(row, 1);
+			for (NodeType row = nrR; row--; )
+				isChanged |= sweepRow(row, -1);
+			++nrSweepPairs;
+		}
+		return !isChanged;
+	}
 };
 
 // *****************************************************************************
@@ -670,6 +827,15 @@ namespace {
 	static CommonOperGroup cogGD_ULFZ("griddist_zonal_untiled_latitude_specific", oper_policy::better_not_in_meta_scripting);
 	static CommonOperGroup cogGDMULFZ("griddist_zonal_maximp_untiled_latitude_specific", oper_policy::better_not_in_meta_scripting);
 
+	static CommonOperGroup cogGDS__  ("griddist_sweep", oper_policy::better_not_in_meta_scripting);
+	static CommonOperGroup cogGDSM_  ("griddist_sweep_maximp", oper_policy::better_not_in_meta_scripting);
+	static CommonOperGroup cogGDS__LF("griddist_sweep_latitude_specific", oper_policy::better_not_in_meta_scripting);
+	static CommonOperGroup cogGDSM_LF("griddist_sweep_maximp_latitude_specific", oper_policy::better_not_in_meta_scripting);
+	static CommonOperGroup cogGDS__Z ("griddist_sweep_zonal", oper_policy::better_not_in_meta_scripting);
+	static CommonOperGroup cogGDSM_Z ("griddist_sweep_zonal_maximp", oper_policy::better_not_in_meta_scripting);
+	static CommonOperGroup cogGDS__LFZ("griddist_sweep_zonal_latitude_specific", oper_policy::better_not_in_meta_scripting);
+	static CommonOperGroup cogGDSM_LFZ("griddist_sweep_zonal_maximp_latitude_specific", oper_policy::better_not_in_meta_scripting);
+
 	template <typename Imp>
 	struct GridDistOperSet
 	{
@@ -703,4 +869,14 @@ namespace {
 	tl_oper::inst_tuple_templ<typelists::floats, GridDistOperSet> gridDistOperSets_ULFZ(cogGD_ULFZ, GridDistFlags::UseShadowTile | GridDistFlags::HasLatitudeFactor| GridDistFlags::HasZonalBoundaryImpedance);
 	tl_oper::inst_tuple_templ<typelists::floats, GridDistOperSet> gridDistOperSetsMULFZ(cogGDMULFZ, GridDistFlags::HasLimitParameterAndUseShadowTile | GridDistFlags::HasLatitudeFactor| GridDistFlags::HasZonalBoundaryImpedance);
 
+	// griddist_sweep variants: same arguments and results, calculated by raster sweeps over the whole grid
+	tl_oper::inst_tuple_templ<typelists::floats, GridDistOperSet> gridDistSweepOperSets__(cogGDS__, GridDistFlags::UseSweeping);
+	tl_oper::inst_tuple_templ<typelists::floats, GridDistOperSet> gridDistSweepOperSetsM_(cogGDSM_, GridDistFlags::UseSweeping | GridDistFlags::HasLimitParameter);
+	tl_oper::inst_tuple_templ<typelists::floats, GridDistOperSet> gridDistSweepOperSets__LF(cogGDS__LF, GridDistFlags::UseSweeping | GridDistFlags::HasLatitudeFactor);
+	tl_oper::inst_tuple_templ<typelists::floats, GridDistOperSet> gridDistSweepOperSetsM_LF(cogGDSM_LF, GridDistFlags::UseSweeping | GridDistFlags::HasLimitParameter | GridDistFlags::HasLatitudeFactor);
+	tl_oper::inst_tuple_templ<typelists::floats, GridDistOperSet> gridDistSweepOperSets__Z(cogGDS__Z, GridDistFlags::UseSweeping | GridDistFlags::HasZonalBoundaryImpedance);
+	tl_oper::inst_tuple_templ<typelists::floats, GridDistOperSet> gridDistSweepOperSetsM_Z(cogGDSM_Z, GridDistFlags::UseSweeping | GridDistFlags::HasLimitParameter | GridDistFlags::HasZonalBoundaryImpedance);
+	tl_oper::inst_tuple_templ<typelists::floats, GridDistOperSet> gridDistSweepOperSets__LFZ(cogGDS__LFZ, GridDistFlags::UseSweeping | GridDistFlags::HasLatitudeFactor | GridDistFlags::HasZonalBoundaryImpedance);
+	tl_oper::inst_tuple_templ<typelists::floats, GridDistOperSet> gridDistSweepOperSetsM_LFZ(cogGDSM_LFZ, GridDistFlags::UseSweeping | GridDistFlags::HasLimitParameter | GridDistFlags::HasLatitudeFactor | GridDistFlags::HasZonalBoundaryImpedance);
+
 }
@@ -8,6 +8,7 @@
 #pragma hdrstop
 #endif
 
+#include "DistrictLabelling.h"
 #include "SpatialAnalyzer.h"
 
 #include "dbg/debug.h"
@@ -20,6 +21,7 @@
 #include "Param.h"
 #include "DataItemClass.h"
 #include "DataArray.h"
+#include "ParallelTiles.h"
 #include "Unit.h"
 #include "UnitClass.h"
 
@@ -27,6 +29,9 @@
 //											DistrictOperator
 // *****************************************************************************
 
+// The districts are labelled per tile in parallel and united over the tile borders (see DistrictLabelling.h),
+// with the same ids as Districting, without reading or writing the whole grid at once.
+
 static TokenID s_Districts = GetTokenID_st("Districts");
 
 template <typename T, typename R = UInt32>
@@ -78,21 +83,70 @@ struct DistrictOperator : public UnaryOperator
 
 			district_type nrDistricts = 0;
 
-			auto inputVec  = inputGrid->GetDataRead();
-			auto outputVec = resLock->GetDataWrite(no_tile, dms_rw_mode::write_only_mustzero);
-
 			IRect rect = domain->GetRangeAsIRect();
 			if (!rect.empty())
 			{
 				assert(Left(rect) < Right(rect));
 				assert(Top(rect) < Bottom(rect));
-				assert(inputVec.size() == Cardinality(rect));
-				assert(outputVec.size() == Cardinality(rect));
 
-				UGrid<const ArgType::value_type> input(Size(rect), inputVec.begin());
-				UGrid<ResultSubType::value_type> output(input.GetSize(), outputVec.begin());
+				SizeT nrRows = Height(rect), nrCols = Width(rect);
+				tile_id tn = domain->GetNrTiles();
+				district_labeller<T> labeller(nrRows, nrCols, tn, this->m_Use8Neighbours);
+				auto isDefined = [](T v) { return IsDefined(v); };
+
+				// UInt32 results can hold the local labels until they are replaced by the district ids; others label each tile twice
+				constexpr bool keepsLabels = std::is_same_v<district_type, UInt32>;
+
+				parallel_tileloop(tn, [&](tile_id t)
+					{
+						IRect tileRect = domain->GetTileRangeAsIRect(t);
+						auto inputTile = inputGrid->GetTile(t);
+						MG_CHECK(inputTile.size() == Cardinality(tileRect));
+						MG_CHECK(inputTile.size() < no_district_label);
+
+						typename ResultSubType::locked_seq_t outputTile;
+						std::vector<UInt32> labelBuffer;
+						UInt32* labels;
+						if constexpr (keepsLabels)
+						{
+							outputTile = resLock->GetWritableTile(t, dms_rw_mode::write_only_all);
+							labels = outputTile.begin();
+						}
+						else
+						{
+							labelBuffer.resize(inputTile.size());
+							labels = labelBuffer.data();
+						}
+						labeller.LabelTile(t, Top(tileRect) - Top(rect), Left(tileRect) - Left(rect), Height(tileRect), Width(tileRect), inputTile.begin(), isDefined, labels);
+					}
+				);
 
-				nrDistricts = Districting(input, output, this->m_Use8Neighbours);
+				SizeT nrFoundDistricts = labeller.Unite([inputGrid, nrCols](SizeT row, SizeT col) { return inputGrid->GetTiledLocation(row * nrCols + col).first; });
+				if (nrFoundDistricts && nrFoundDistricts - 1 > MAX_VALUE(district_type))
+					throwErrorF("district", "number of found districts exceeds the maximum of the chosen district operator that stores only %d bytes per cell", sizeof(district_type));
+				nrDistricts = district_type(nrFoundDistricts);
+
+				parallel_tileloop(tn, [&](tile_id t)
+					{
+						auto outputTile = resLock->GetWritableTile(t, keepsLabels ? dms_rw_mode::read_write : dms_rw_mode::write_only_all);
+
+						std::vector<UInt32> labelBuffer;
+						const UInt32* labels;
+						if constexpr (keepsLabels)
+							labels = outputTile.begin();
+						else
+						{
+							IRect tileRect = domain->GetTileRangeAsIRect(t);
+							auto inputTile = inputGrid->GetTile(t);
+							std::vector<SizeT> firstCells;
+							labelBuffer.resize(inputTile.size());
+							LabelDistrictCells<T>(inputTile.begin(), Height(tileRect), Width(tileRect), this->m_Use8Neighbours, isDefined, labelBuffer.data(), firstCells);
+							labels = labelBuffer.data();
+						}
+						for (SizeT i = 0, n = outputTile.size(); i != n; ++i)
+							outputTile[i] = (labels[i] == no_district_label) ? UNDEFINED_VALUE(district_type) : district_type(labeller.DistrictId(t, labels[i]));
+					}
+				);
 			}
 			auto resultUnit = debug_cast<ResultUnitType*>(std::move(resUnit));
 			assert(resultUnit);
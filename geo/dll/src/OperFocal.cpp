@@ -0,0 +1,344 @@
+// Copyright (C) 1998-2026 Object Vision b.v.
+// License: GNU GPL 3
+/////////////////////////////////////////////////////////////////////////////
+
+#include "GeoPCH.h"
+
+#if defined(_MSC_VER)
+#pragma hdrstop
+#endif
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+#include "FocalStatistics.h"
+
+#include "dbg/debug.h"
+#include "geo/Conversions.h"
+#include "geo/MinMax.h"
+#include "geo/Point.h"
+#include "mci/CompositeCast.h"
+#include "utl/TypeListOper.h"
+
+#include "CheckedDomain.h"
+#include "DataArray.h"
+#include "DataItemClass.h"
+#include "ParallelTiles.h"
+#include "Unit.h"
+#include "UnitClass.h"
+
+// *****************************************************************************
+//											FocalOperator
+// *****************************************************************************
+//
+// focal_sum, focal_mean, focal_min, focal_max, focal_majority(grid, radius, isCircle)
+// focal_percentile(grid, radius, isCircle, percentage)
+//
+// The statistic of the defined values in a square window of (2 * radius + 1)^2 cells around each cell, or in a circle with the given radius
+// if isCircle is non-zero, as diversity. Cells with no defined values in their window are undefined.
+// focal_sum and focal_mean result in Float64 values; the other statistics in values of the grid.
+// focal_majority and focal_percentile are provided for integer grids; ties of focal_majority result in the lowest value.
+// The tiles of the grid are processed concurrently, each with a copy of the input cells within the radius around it;
+// see FocalStatistics.h for the algorithms.
+
+namespace focal
+{
+	enum class stat { sum, mean, min, max, majority, percentile };
+
+	bool HasFloat64Result(stat s) { return s == stat::sum || s == stat::mean; }
+
+	// the maximum number of classes of focal_majority and focal_percentile as offsets from the minimum value and as distinct values
+	const SizeT MAX_NR_OFFSET_CLASSES = 1 << 16;
+	const SizeT MAX_NR_CLASSES = 1 << 20;
+}
+
+CommonOperGroup cogFocalSum       ("focal_sum");
+CommonOperGroup cogFocalMean      ("focal_mean");
+CommonOperGroup cogFocalMin       ("focal_min");
+CommonOperGroup cogFocalMax       ("focal_max");
+CommonOperGroup cogFocalMajority  ("focal_majority");
+CommonOperGroup cogFocalPercentile("focal_percentile");
+
+template <typename T>
+class FocalOperator : public VariadicOperator
+{
+	typedef DataArray<T>       Arg1Type; // inputGrid  (SPoint)
+	typedef DataArray<UInt16>  Arg2Type; // radius     (void)
+	typedef DataArray<UInt16>  Arg3Type; // isCircle   (void)
+	typedef DataArray<Float64> Arg4Type; // percentage (void), only for focal_percentile
+
+public:
+	FocalOperator(AbstrOperGroup& og, focal::stat s)
+		:	VariadicOperator(&og
+			,	focal::HasFloat64Result(s) ? DataArray<Float64>::GetStaticClass() : DataArray<T>::GetStaticClass()
+			,	(s == focal::stat::percentile) ? 4 : 3
+			)
+		,	m_Stat(s)
+	{
+		ClassCPtr* argClsIter = m_ArgClasses.get();
+		*argClsIter++ = Arg1Type::GetStaticClass();
+		*argClsIter++ = Arg2Type::GetStaticClass();
+		*argClsIter++ = Arg3Type::GetStaticClass();
+		if (s == focal::stat::percentile)
+			*argClsIter++ = Arg4Type::GetStaticClass();
+		assert(m_ArgClassesEnd == argClsIter);
+	}
+
+	// Override Operator
+	bool CreateResult(TreeItemDualRef& resultHolder, const ArgSeqType& args, bool mustCalc) const override
+	{
+		dms_assert(args.size() == 3 || args.size() == 4);
+
+		const AbstrDataItem* inputGridA   = debug_cast<const AbstrDataItem*>(args[0]);
+		const AbstrDataItem* radiusA      = debug_cast<const AbstrDataItem*>(args[1]);
+		const AbstrDataItem* isCircleA    = debug_cast<const AbstrDataItem*>(args[2]);
+		const AbstrDataItem* percentageA  = (args.size() == 4) ? debug_cast<const AbstrDataItem*>(args[3]) : nullptr;
+
+		const AbstrUnit* domain = inputGridA->GetAbstrDomainUnit();
+		const AbstrUnit* values = inputGridA->GetAbstrValuesUnit();
+		dms_assert(domain);
+		dms_assert(values);
+
+		checked_domain<Void>(radiusA, "a2");
+		checked_domain<Void>(isCircleA, "a3");
+		if (percentageA)
+			checked_domain<Void>(percentageA, "a4");
+
+		if (!resultHolder)
+			resultHolder = CreateCacheDataItem(domain
+			,	focal::HasFloat64Result(m_Stat) ? Unit<Float64>::GetStaticClass()->CreateDefault() : values
+			);
+
+		if (mustCalc)
+		{
+			const Arg1Type* inputGrid = debug_cast<const Arg1Type*>(inputGridA->GetCurrRefObj().get());
+			assert(inputGrid);
+
+			DataReadLock arg1Lock(inputGridA);
+
+			AbstrDataItem* res = AsDataItem(resultHolder.GetNew());
+			DataWriteLock resLock(res);
+
+			focal_window window(GetCurrValue<Arg2Type::value_type>(radiusA, 0), GetCurrValue<Arg3Type::value_type>(isCircleA, 0) != 0);
+			Float64 percentage = percentageA ? GetCurrValue<Arg4Type::value_type>(percentageA, 0) : 0.0;
+
+			if (focal::HasFloat64Result(m_Stat))
+				CalcSums(domain, inputGrid, window, mutable_array_cast<Float64>(resLock));
+			else
+				CalcValues(domain, inputGrid, window, percentage, mutable_array_cast<T>(resLock));
+			resLock.Commit();
+		}
+		return true;
+	}
+
+private:
+	using const_ptr = const T*;
+
+	// calls func(data, nrRows, nrCols, block, outputAt) concurrently for each tile of the domain, with a copy of the cells of the input tiles
+	// within the radius around the tile as the nrRows x nrCols grid data, the cells of the tile as its block,
+	// and outputAt(row, col) for the result of a cell of the block in its tile of result
+	template <typename V, typename Func>
+	static void ForEachTile(const AbstrUnit* domain, const Arg1Type* inputGrid, const focal_window& window, DataArray<V>* result, Func&& func)
+	{
+		IRect rect = domain->GetRangeAsIRect();
+		tile_id tn = domain->GetNrTiles();
+		Int32 r = window.Radius();
+		parallel_tileloop(tn, [&](tile_id t)
+			{
+				IRect tileRect = domain->GetTileRangeAsIRect(t);
+				if (tileRect.empty())
+					return;
+				IRect bufferRect = Inflate(tileRect, IPoint(r, r)) & rect;
+				SizeT nrCols = Width(bufferRect);
+				std::vector<T> buffer(Cardinality(bufferRect));
+				for (tile_id u = 0; u != tn; ++u)
+				{
+					IRect inputRect = domain->GetTileRangeAsIRect(u);
+					IRect overlap = inputRect & bufferRect;
+					if (overlap.empty())
+						continue;
+					auto inputTile = inputGrid->GetTile(u);
+					assert(inputTile.size() == Cardinality(inputRect));
+					for (Int32 row = Top(overlap); row != Bottom(overlap); ++row)
+					{
+						auto inputRow = inputTile.begin() + SizeT(row - Top(inputRect)) * Width(inputRect) + (Left(overlap) - Left(inputRect));
+						fast_copy(inputRow, inputRow + Width(overlap), buffer.data() + SizeT(row - Top(bufferRect)) * nrCols + (Left(overlap) - Left(bufferRect)));
+					}
+				}
+
+				auto output = result->GetDataWrite(t, dms_rw_mode::write_only_all);
+				assert(output.size() == Cardinality(tileRect));
+				focal_block block{ SizeT(Top(tileRect) - Top(bufferRect)), SizeT(Bottom(tileRect) - Top(bufferRect)), SizeT(Left(tileRect) - Left(bufferRect)), SizeT(Right(tileRect) - Left(bufferRect)) };
+				SizeT tileWidth = Width(tileRect);
+				func(const_ptr(buffer.data()), SizeT(Height(bufferRect)), nrCols, block, [&output, &block, tileWidth](SizeT row, SizeT col) -> V&
+					{
+						return output[(row - block.rowBegin) * tileWidth + (col - block.colBegin)];
+					}
+				);
+			}
+		);
+	}
+
+	static bool IsDefinedValue(T v) { return IsDefined(v); }
+
+	void CalcSums(const AbstrUnit* domain, const Arg1Type* inputGrid, const focal_window& window, DataArray<Float64>* result) const
+	{
+		bool isMean = (m_Stat == focal::stat::mean);
+		ForEachTile(domain, inputGrid, window, result, [isMean, &window](const_ptr data, SizeT nrRows, SizeT nrCols, const focal_block& block, auto&& outputAt)
+			{
+				FocalSums(data, nrRows, nrCols, window, block, IsDefinedValue, [isMean, &outputAt](SizeT row, SizeT col, Float64 sum, SizeT count)
+					{
+						outputAt(row, col) = count ? (isMean ? sum / count : sum) : UNDEFINED_VALUE(Float64);
+					}
+				);
+			}
+		);
+	}
+
+	void CalcValues(const AbstrUnit* domain, const Arg1Type* inputGrid, const focal_window& window, Float64 percentage, DataArray<T>* result) const
+	{
+		switch (m_Stat)
+		{
+		case focal::stat::min: CalcExtremes(domain, inputGrid, window, std::less<T>(), result); return;
+		case focal::stat::max: CalcExtremes(domain, inputGrid, window, std::greater<T>(), result); return;
+		default:
+			if constexpr (std::is_integral_v<T>)
+			{
+				if (m_Stat == focal::stat::majority)
+					CalcHistogram<focal_majority_histogram>(domain, inputGrid, window, result, [](focal_majority_histogram& h) { return h.Majority(); });
+				else
+					CalcHistogram<focal_percentile_histogram>(domain, inputGrid, window, result, [percentage](focal_percentile_histogram& h) { return h.Percentile(percentage); });
+			}
+			else
+				dms_assert(false);
+		}
+	}
+
+	template <typename Better>
+	static void CalcExtremes(const AbstrUnit* domain, const Arg1Type* inputGrid, const focal_window& window, Better better, DataArray<T>* result)
+	{
+		ForEachTile(domain, inputGrid, window, result, [&window, better](const_ptr data, SizeT nrRows, SizeT nrCols, const focal_block& block, auto&& outputAt)
+			{
+				FocalExtremes<T>(data, nrRows, nrCols, window, block, IsDefinedValue, better, [&outputAt](SizeT row, SizeT col, const focal_extreme<T>& e)
+					{
+						outputAt(row, col) = e.defined ? e.value : UNDEFINED_VALUE(T);
+					}
+				);
+			}
+		);
+	}
+
+	// the classes of the histogram are the offsets of the values from the minimum defined value of the grid if their range is small,
+	// and otherwise the ranks of the distinct defined values of the grid, which are found by binary search;
+	// both are bounded, such that each tile allocates at most a few MB for its histogram
+	template <typename Histogram, typename ResultFunc>
+	void CalcHistogram(const AbstrUnit* domain, const Arg1Type* inputGrid, const focal_window& window, DataArray<T>* result, ResultFunc&& resultOf) const
+	{
+		tile_id tn = domain->GetNrTiles();
+		std::vector<T> minValues(tn, MAX_VALUE(T)), maxValues(tn, MIN_VALUE(T));
+		parallel_tileloop(tn, [&](tile_id t)
+			{
+				for (T v : inputGrid->GetTile(t))
+					if (IsDefined(v))
+					{
+						MakeMin(minValues[t], v);
+						MakeMax(maxValues[t], v);
+					}
+			}
+		);
+		T minValue = MAX_VALUE(T), maxValue = MIN_VALUE(T);
+		for (tile_id t = 0; t != tn; ++t)
+		{
+			MakeMin(minValue, minValues[t]);
+			MakeMax(maxValue, maxValues[t]);
+		}
+		if (minValue > maxValue)
+		{
+			parallel_tileloop(tn, [result](tile_id t)
+				{
+					auto output = result->GetDataWrite(t, dms_rw_mode::write_only_all);
+					fast_fill(output.begin(), output.end(), UNDEFINED_VALUE(T));
+				}
+			);
+			return;
+		}
+		// unsigned differences, which are also exact for signed values
+		SizeT maxOffset = SizeT(maxValue) - SizeT(minValue);
+		if (maxOffset < focal::MAX_NR_OFFSET_CLASSES)
+		{
+			CalcClassHistogram<Histogram>(domain, inputGrid, window, result, maxOffset + 1
+			,	[minValue](T v) { return SizeT(v) - SizeT(minValue); }
+			,	[minValue](SizeT c) { return T(SizeT(minValue) + c); }
+			,	resultOf
+			);
+			return;
+		}
+
+		// the distinct values, which are sorted and made unique whenever the collected values of the tiles exceed twice the maximum number of classes
+		std::vector<T> classValues;
+		auto makeUnique = [&classValues, this]()
+			{
+				std::sort(classValues.begin(), classValues.end());
+				classValues.erase(std::unique(classValues.begin(), classValues.end()), classValues.end());
+				if (classValues.size() > focal::MAX_NR_CLASSES)
+					throwErrorF(GetGroup()->GetNameStr(), "the grid has more than %u distinct values, which is too many classes for a histogram", UInt32(focal::MAX_NR_CLASSES));
+			};
+		for (tile_id t = 0; t != tn; ++t)
+		{
+			for (T v : inputGrid->GetTile(t))
+				if (IsDefined(v))
+					classValues.push_back(v);
+			if (classValues.size() > 2 * focal::MAX_NR_CLASSES)
+				makeUnique();
+		}
+		makeUnique();
+		CalcClassHistogram<Histogram>(domain, inputGrid, window, result, classValues.size()
+		,	[&classValues](T v) { return SizeT(std::lower_bound(classValues.begin(), classValues.end(), v) - classValues.begin()); }
+		,	[&classValues](SizeT c) { return classValues[c]; }
+		,	resultOf
+		);
+	}
+
+	template <typename Histogram, typename ClassFunc, typename ValueFunc, typename ResultFunc>
+	static void CalcClassHistogram(const AbstrUnit* domain, const Arg1Type* inputGrid, const focal_window& window, DataArray<T>* result, SizeT nrClasses, ClassFunc&& classOf, ValueFunc&& valueOf, ResultFunc&& resultOf)
+	{
+		ForEachTile(domain, inputGrid, window, result, [&](const_ptr data, SizeT nrRows, SizeT nrCols, const focal_block& block, auto&& outputAt)
+			{
+				Histogram histogram(nrClasses);
+				FocalHistogram(data, nrRows, nrCols, window, block, IsDefinedValue, classOf, histogram, [&outputAt, &valueOf, &resultOf](SizeT row, SizeT col, Histogram& h)
+					{
+						outputAt(row, col) = h.Total() ? valueOf(resultOf(h)) : UNDEFINED_VALUE(T);
+					}
+				);
+			}
+		);
+	}
+
+	focal::stat m_Stat;
+};
+
+// *****************************************************************************
+//											INSTANTIATION
+// *****************************************************************************
+
+namespace
+{
+	template <typename T>
+	struct FocalOperators
+	{
+		FocalOperator<T> m_Sum{ cogFocalSum, focal::stat::sum }, m_Mean{ cogFocalMean, focal::stat::mean };
+		FocalOperator<T> m_Min{ cogFocalMin, focal::stat::min }, m_Max{ cogFocalMax, focal::stat::max };
+	};
+
+	template <typename T>
+	struct FocalClassOperators
+	{
+		FocalOperator<T> m_Majority{ cogFocalMajority, focal::stat::majority }, m_Percentile{ cogFocalPercentile, focal::stat::percentile };
+	};
+
+	tl_oper::inst_tuple_templ<typelists::num_objects, FocalOperators> focalOperators;
+	tl_oper::inst_tuple_templ<typelists::ints, FocalClassOperators> focalClassOperators;
+}
+
+/******************************************************************************/
@@ -941,6 +941,8 @@ public:
 #include "UnitProcessor.h"
 #include "geo/SpatialIndex.h"
 
+#include "SpatialIndexItem.h"
+
 template <typename E, typename ResSequence, typename PointArray, typename PolyArray, typename SpatialIndexType>
 void point_in_polygon(
 		      ResSequence resData,
@@ -993,28 +995,37 @@ void point_in_polygon(
 
 CommonOperGroup cogPP("point_in_polygon", oper_policy::dynamic_result_class | oper_policy::better_not_in_meta_scripting);
 
-class AbstrPointInPolygonOperator : public BinaryOperator
+// point_in_polygon(points, polygons [, spatial_index(polygons)]): with the third argument, the polygons are looked up in the PackedRTree
+// that the result of spatial_index (see Connect.cpp and SpatialIndexItem.h) keeps, instead of in a SpatialIndex that is built for each call.
+class AbstrPointInPolygonOperator : public VariadicOperator
 {
 protected:
-	AbstrPointInPolygonOperator(const DataItemClass* pointAttrClass, const DataItemClass* polyAttrClass)
-		:	BinaryOperator(&cogPP, AbstrDataItem::GetStaticClass()
-			,	pointAttrClass
-			,	polyAttrClass
-			)
-	{}
+	AbstrPointInPolygonOperator(const DataItemClass* pointAttrClass, const DataItemClass* polyAttrClass, bool withIndex)
+		:	VariadicOperator(&cogPP, AbstrDataItem::GetStaticClass(), withIndex ? 3 : 2)
+	{
+		ClassCPtr* argClsIter = m_ArgClasses.get();
+		*argClsIter++ = pointAttrClass;
+		*argClsIter++ = polyAttrClass;
+		if (withIndex)
+			*argClsIter++ = Unit<UInt32>::GetStaticClass();
+		assert(m_ArgClassesEnd == argClsIter);
+	}
 
 	bool CreateResult(TreeItemDualRef& resultHolder, const ArgSeqType& args, bool mustCalc) const override
 	{
-		dms_assert(args.size() == 2);
+		dms_assert(args.size() == 2 || args.size() == 3);
 
 		const AbstrDataItem* arg1A = AsDataItem(args[0]);
 		const AbstrDataItem* arg2A = AsDataItem(args[1]);
+		const AbstrUnit*     arg3U = (args.size() == 3) ? AsUnit(args[2]) : nullptr;
 		dms_assert(arg1A);
 		dms_assert(arg2A);
 
 		const AbstrUnit* domainUnit = arg1A->GetAbstrDomainUnit();
 		const AbstrUnit* valuesUnit = arg2A->GetAbstrDomainUnit();
 		arg1A->GetAbstrValuesUnit()->UnifyValues(arg2A->GetAbstrValuesUnit(), "v1", "v2", UM_Throw);
+		if (arg3U)
+			CheckSpatialIndexItem(arg3U, valuesUnit, arg2A->GetAbstrValuesUnit(), true);
 
 		bool isOnePolygon = arg2A->HasVoidDomainGuarantee();
 		if (isOnePolygon)
@@ -1050,7 +1061,7 @@ protected:
 				auto u = no_tile;
 //				ReadableTileLock readPolyLock (arg2A->GetCurrRefObj(), u);
 				ResourceHandle spIndexHandle, polyTileHandle;
-				CreatePolyHandle(arg2A, u, spIndexHandle, polyTileHandle);
+				CreatePolyHandle(arg2A, arg3U, u, spIndexHandle, polyTileHandle);
 
 				// each point tile
 				parallel_tileloop(te, [this, resObj = resLock.get(), res, arg1A, arg2A, u, &pointBoxDataHandle, &polyTileCounters, &spIndexHandle, &polyTileHandle](tile_id t)->void
@@ -1073,14 +1084,14 @@ protected:
 		}
 		return true;
 	}
-	virtual void CreatePolyHandle(const AbstrDataItem* polyDataA, tile_id u, ResourceHandle& spIndexHandle, ResourceHandle& polyTileHandle) const =0;
+	virtual void CreatePolyHandle(const AbstrDataItem* polyDataA, const AbstrUnit* indexUnit, tile_id u, ResourceHandle& spIndexHandle, ResourceHandle& polyTileHandle) const =0;
 	virtual void CreatePointHandle(const AbstrDataItem* pointDataA, tile_id t, ResourceHandle& pointBoxDataHandle) const =0;
 	virtual bool IsIntersecting(tile_id t, tile_id u, ResourceHandle& pointBoxDataHandle, ResourceHandle& polyInfoHandle) const=0;
 	virtual void Calculate(AbstrDataObject* res, const AbstrUnit* resVU, const AbstrDataItem* pointDataA, const AbstrDataItem* polyDataA, tile_id t, tile_id u, 
 		bool mustInitPointTile, const ResourceHandle& pointBoxDataHandle, const ResourceHandle& spIndexHandle, const ResourceHandle& polyTileHandle) const=0;
 };
 
-template <typename P>
+template <typename P, bool HasIndex = false>
 class PointInPolygonOperator : public AbstrPointInPolygonOperator
 {
 	using PointType = P;
@@ -1093,7 +1104,21 @@ class PointInPolygonOperator : public AbstrPointInPolygonOperator
 	using BoxArrayType = std::vector<BoxType>;
 
 	typedef scalar_of_t<PointType>  ScalarType;
-	using SpatialIndexType = SpatialIndex<ScalarType, typename Arg2Type::const_iterator>;
+	using SpatialIndexType = std::conditional_t<HasIndex
+	,	PackedRTree <ScalarType, typename Arg2Type::const_iterator>
+	,	SpatialIndex<ScalarType, typename Arg2Type::const_iterator>
+	>;
+	// the resource that spIndexHandle holds: a view on the result of spatial_index that keeps its attributes locked, or a built SpatialIndex
+	using SpatialIndexHolderType = std::conditional_t<HasIndex, SpatialIndexItemView<SpatialIndexType>, SpatialIndexType>;
+
+	static const SpatialIndexType* GetSpatialIndex(const ResourceHandle& spIndexHandle)
+	{
+		const SpatialIndexHolderType* holder = GetOptional<SpatialIndexHolderType>(spIndexHandle);
+		if constexpr (HasIndex)
+			return holder ? &holder->GetTree() : nullptr;
+		else
+			return holder;
+	}
 
 	using ResourceType = std::pair<SpatialIndexType, typename Arg2Type::locked_cseq_t>;
 
@@ -1175,18 +1200,24 @@ class PointInPolygonOperator : public AbstrPointInPolygonOperator
 
 public:
 	PointInPolygonOperator()
-		:	AbstrPointInPolygonOperator(Arg1Type::GetStaticClass(), Arg2Type::GetStaticClass())
+		:	AbstrPointInPolygonOperator(Arg1Type::GetStaticClass(), Arg2Type::GetStaticClass(), HasIndex)
 	{}
 
 	// Override Operator
-	void CreatePolyHandle(const AbstrDataItem* polyDataA, tile_id u, ResourceHandle& spIndexHandle, ResourceHandle& polyTileHandle) const override
+	void CreatePolyHandle(const AbstrDataItem* polyDataA, const AbstrUnit* indexUnit, tile_id u, ResourceHandle& spIndexHandle, ResourceHandle& polyTileHandle) const override
 	{
 		const Arg2Type* polyData  = const_array_cast<PolygonType>(polyDataA);
 		dms_assert(polyData); 
 
 		auto polyTile = polyData->GetDataRead(u);
 
-		spIndexHandle  = makeResource<SpatialIndexType>(polyTile.begin(), polyTile.end(), 0);
+		if constexpr (HasIndex)
+		{
+			assert(u == no_tile); // feature_rel refers to positions in the whole polygon array
+			spIndexHandle = makeResource<SpatialIndexHolderType>(indexUnit, polyTile.begin(), polyTile.size());
+		}
+		else
+			spIndexHandle = makeResource<SpatialIndexType>(polyTile.begin(), polyTile.end(), 0);
 		polyTileHandle = makeResource<typename Arg2Type::locked_cseq_t>(std::move(polyTile));
 	}
 
@@ -1206,10 +1237,11 @@ public:
 
 	bool IsIntersecting(tile_id t, tile_id u, ResourceHandle& pointBoxDataHandle, ResourceHandle& spIndexHandle) const override
 	{
-		BoxArrayType&     boxArray = GetAs<BoxArrayType>(pointBoxDataHandle);
-		SpatialIndexType& spIndex  = GetAs<SpatialIndexType>(spIndexHandle);
+		BoxArrayType&           boxArray   = GetAs<BoxArrayType>(pointBoxDataHandle);
+		const SpatialIndexType* spIndexPtr = GetSpatialIndex(spIndexHandle);
+		assert(spIndexPtr);
 
-		return ::IsIntersecting(spIndex.GetBoundingBox(), boxArray[t]);
+		return ::IsIntersecting(spIndexPtr->GetBoundingBox(), boxArray[t]);
 	}
 
 	void Calculate(AbstrDataObject* res, const AbstrUnit* resVU, const AbstrDataItem* pointDataA, const AbstrDataItem* polyDataA, tile_id t, tile_id u, 
@@ -1221,7 +1253,7 @@ public:
 		dms_assert(polyData); 
 
 		const BoxArrayType    & boxArray    = GetAs<BoxArrayType>(pointBoxDataHandle);
-		const SpatialIndexType* spIndexPtr  = GetOptional<SpatialIndexType>(spIndexHandle);
+		const SpatialIndexType* spIndexPtr  = GetSpatialIndex(spIndexHandle);
 
 		DispatcherData data(res, pointData, polyData, t, u, mustInitPointTile, spIndexPtr, GetAs<typename Arg2Type::locked_cseq_t>(polyTileHandle));
 		
@@ -1938,6 +1970,7 @@ namespace
 		CastedUnaryAttrSpecialFuncOperator<AreaFunc     <P> > area;
 
 		PointInPolygonOperator<P> pip;
+		PointInPolygonOperator<P, true> pipIndexed;
 		PointInRankedPolygonOperator<P, UInt8> pirpu8;
 		PointInRankedPolygonOperator<P, UInt32> pirpu32;
 		PointInRankedPolygonOperator<P, Int32>  pirpi32;
@@ -6,8 +6,9 @@
 // Purpose:
 //   Implements tile-based "potential" (convolution-like) computations and
 //   proximity analysis over gridded data. The implementation supports multiple
-//   algorithm variants (IPP accelerated, packed, raw, slow fallback, proximity)
-//   selected via AnalysisType. It performs kernel preparation once, then
+//   algorithm variants (IPP accelerated, packed, raw, FFT, slow fallback, proximity)
+//   selected via AnalysisType; without IPP, potential picks box sums or separable passes if the kernel allows, else FFT or slow by kernel size.
+//   It performs kernel preparation once, then
 //   processes each data tile in parallel, accumulating overlapping contributions
 //   into result tiles with strict ordering to guarantee deterministic results.
 //
@@ -18,8 +19,8 @@
 // 3. Lock inputs for read, create write handle for result (zero-initialized).
 // 4. Determine full domain rectangle and weight rectangle (kernel footprint).
 // 5. Gather tile count (te) and max tile size for buffer planning.
-// 6. Prepare kernel_info:
-//      - Stores original kernel size
+// 6. Prepare kernel_info and resolve PotentialAuto by the kernel shape and size (SelectAnalysisType):
+//      - Stores original kernel size and, if needed, its shape (box, separable)
 //      - Computes maximum convolution output size for overlap
 //      - Prepares expanded kernel buffers (possibly one per padding width)
 // 7. For every result tile, register its column count into kernel_info
@@ -206,11 +207,12 @@ struct AbstrDirectPotentialOperator : public BinaryOperator
 
             OwningPtrSizedArray<result_tile_protector> resTileAddition(te, value_construct MG_DEBUG_ALLOCATOR_SRC("OperPot: resTileAddition"));
 
-            // Precompute kernel info once
-            auto kernelInfo = CreateKernelInfo(weightGridA, Size(weightRect), maxDataTileSize);
+            // Precompute kernel info once and resolve PotentialAuto by the kernel shape and size
+            auto kernelInfo = CreateKernelInfo(m_AnalysisType, weightGridA, Size(weightRect), maxDataTileSize);
+            AnalysisType at = SelectAnalysisType(m_AnalysisType, kernelInfo);
             // Register per-column kernel expansions (if backend uses them)
             for (tile_id ti = 0; ti != te; ++ti)
-                AddKernel(kernelInfo, Size(resDomainUnit->GetTileRangeAsIRect(ti)).Col());
+                AddKernel(at, kernelInfo, Size(resDomainUnit->GetTileRangeAsIRect(ti)).Col());
 
             // Thread-local working buffers to avoid reallocation
             concurrency::combinable< potential_contexts > workingBuffers;
@@ -240,7 +242,7 @@ struct AbstrDirectPotentialOperator : public BinaryOperator
 
                             // Read data tile for computation
                             ReadableTileLock readLock(dataGridA->GetCurrRefObj().get(), ti);
-                            Calculate(workingBuffer, kernelInfo, dataGridA, af, ti, Size(dataTileRect), overlapTileRect);
+                            Calculate(at, workingBuffer, kernelInfo, dataGridA, af, ti, Size(dataTileRect), overlapTileRect);
 
                             // Deterministic accumulation across all result tiles
                             for (tile_id tr = 0; tr != te; ++tr)
@@ -256,7 +258,7 @@ struct AbstrDirectPotentialOperator : public BinaryOperator
                                 if (IsIntersecting(resTileRect, overlapTileRect))
                                 {
                                     // Accumulate or initialize tile portion
-                                    Store(resDataHandle.get(), tr, resTileRect, resTileInfo.m_WasInitialized, overlapTileRect, workingBuffer);
+                                    Store(at, resDataHandle.get(), tr, resTileRect, resTileInfo.m_WasInitialized, overlapTileRect, workingBuffer);
                                     resTileInfo.m_WasInitialized = true;
                                 }
                                 dms_assert(resTileInfo.m_NrAddedTiles == ti);
@@ -292,11 +294,12 @@ struct AbstrDirectPotentialOperator : public BinaryOperator
     }
 
     // Backend hooks (implemented by templated subclass):
-    virtual kernel_info CreateKernelInfo(const AbstrDataItem* weightGridA, UPoint weightSize, UPoint maxDataTileSize) const = 0;
-    virtual void        AddKernel     (kernel_info& self, SideSize nrDataCols) const = 0;
-    virtual void        Calculate     (potential_contexts& workingBuffer, const kernel_info& info, const AbstrDataItem* dataGridA,
+    // 'at' is m_AnalysisType with PotentialAuto resolved.
+    virtual kernel_info CreateKernelInfo(AnalysisType at, const AbstrDataItem* weightGridA, UPoint weightSize, UPoint maxDataTileSize) const = 0;
+    virtual void        AddKernel     (AnalysisType at, kernel_info& self, SideSize nrDataCols) const = 0;
+    virtual void        Calculate     (AnalysisType at, potential_contexts& workingBuffer, const kernel_info& info, const AbstrDataItem* dataGridA,
                                        ArgFlags af, tile_id t, UPoint dataTileSize, IRect overlapTileRect) const = 0;
-    virtual void        Store         (AbstrDataObject* res, tile_id tr, IRect resTileRect, bool doInit,
+    virtual void        Store         (AnalysisType at, AbstrDataObject* res, tile_id tr, IRect resTileRect, bool doInit,
                                        IRect overlapTileRect, const potential_contexts& data) const = 0;
 protected:
     AnalysisType m_AnalysisType;
@@ -326,26 +329,26 @@ public:
     };
 
     // Create and initialize kernel_info (called once before parallel phase)
-    kernel_info CreateKernelInfo(const AbstrDataItem* weightGridA, UPoint weightSize, UPoint maxDataTileSize) const override
+    kernel_info CreateKernelInfo(AnalysisType at, const AbstrDataItem* weightGridA, UPoint weightSize, UPoint maxDataTileSize) const override
     {
         const Arg2Type* weightGrid = const_array_cast<T>(weightGridA);
         dms_assert(weightGrid);
 
         auto weightShadowTile = weightGrid->GetDataRead(); // Single-tile assumption for kernel
-        return PrepareConvolutionKernel<T>(m_AnalysisType,
+        return PrepareConvolutionKernel<T>(at,
                                            weightShadowTile.m_TileHolder,
                                            UGrid<const T>(weightSize, weightShadowTile.begin()),
                                            maxDataTileSize);
     }
 
     // Allow backend to append specialized kernel representations per data column width
-    void AddKernel(kernel_info& self, SideSize nrDataCols) const override
+    void AddKernel(AnalysisType at, kernel_info& self, SideSize nrDataCols) const override
     {
-        AddConvolutionKernel<T>(self, m_AnalysisType, nrDataCols);
+        AddConvolutionKernel<T>(self, at, nrDataCols);
     }
 
     // Perform per-tile convolution / potential computation, producing overlapping output
-    void Calculate(potential_contexts& workingBuffer, const kernel_info& info, const AbstrDataItem* dataGridA,
+    void Calculate(AnalysisType at, potential_contexts& workingBuffer, const kernel_info& info, const AbstrDataItem* dataGridA,
                    ArgFlags af, tile_id t, UPoint dataTileSize, IRect resultRect) const override
     {
         const Arg1Type* dataGrid = const_array_cast<T>(dataGridA);
@@ -372,38 +375,41 @@ public:
             std::for_each(ddgcI, ddgcE, [](T& v) { if (!IsDefined(v)) v = T(); });
 
             // Execute potential using cleansed buffer
-            Potential(m_AnalysisType, workingBuffer, info, data);
+            Potential(at, workingBuffer, info, data);
         }
         else
         {
             // Direct potential
-            Potential(m_AnalysisType, workingBuffer, info, data);
+            Potential(at, workingBuffer, info, data);
         }
     }
 
     // Merge the overlapping output region into the target result tile
-    void Store(AbstrDataObject* resObj, tile_id tr, IRect resTileRect, bool incremental,
+    void Store(AnalysisType at, AbstrDataObject* resObj, tile_id tr, IRect resTileRect, bool incremental,
                IRect overlapTileRect, const potential_contexts& workingBuffer) const override
     {
-        switch (m_AnalysisType) {
+        switch (at) {
             case AnalysisType::PotentialIpps64:
             case AnalysisType::PotentialRawIpps64:
                 // These backends compute Float64 outputs even if T != Float64
-                StoreImpl<Float64>(resObj, tr, resTileRect, incremental, overlapTileRect, workingBuffer.F64);
+                StoreImpl<Float64>(at, resObj, tr, resTileRect, incremental, overlapTileRect, workingBuffer.F64);
                 break;
             case AnalysisType::PotentialIppsPacked:
             case AnalysisType::PotentialRawIppsPacked:
             case AnalysisType::PotentialSlow:
+            case AnalysisType::PotentialFft:
+            case AnalysisType::PotentialSeparable:
+            case AnalysisType::PotentialBox:
             case AnalysisType::Proximity:
                 // Native type result accumulation
-                StoreImpl<T>(resObj, tr, resTileRect, incremental, overlapTileRect, *workingBuffer.F<T>());
+                StoreImpl<T>(at, resObj, tr, resTileRect, incremental, overlapTileRect, *workingBuffer.F<T>());
                 break;
         }
     }
 
     // Generic storage merger: either assign / copy or accumulate / max depending on mode
     template <typename A>
-    void StoreImpl(AbstrDataObject* resObj, tile_id tr, IRect resTileRect, bool incremental,
+    void StoreImpl(AnalysisType at, AbstrDataObject* resObj, tile_id tr, IRect resTileRect, bool incremental,
                    IRect overlapTileRect, const potential_context<A>& workingBuffer) const
     {
         ResultType* result = mutable_array_cast<T>(resObj);
@@ -419,7 +425,7 @@ public:
         // Compute offset of target rectangle inside overlapped data
         if (incremental)
         {
-            if (m_AnalysisType == AnalysisType::Proximity)
+            if (at == AnalysisType::Proximity)
                 // For Proximity analysis take maximum influence
                 RectOper<T, A, SideSize, row_assigner<unary_assign_max<T, A>>>(resultTile, overlappedResult, resTileRect.first - overlapTileRect.first);
             else
@@ -461,6 +467,9 @@ namespace
     CommonOperGroup potentialSlow     ("potentialSlow",     oper_policy::better_not_in_meta_scripting);
     CommonOperGroup potentialPacked   ("potentialPacked",   oper_policy::better_not_in_meta_scripting);
     CommonOperGroup potentialRawPacked("potentialRawPacked",oper_policy::better_not_in_meta_scripting);
+    CommonOperGroup potentialFft      ("potentialFft",      oper_policy::better_not_in_meta_scripting);
+    CommonOperGroup potentialSeparable("potentialSeparable",oper_policy::better_not_in_meta_scripting);
+    CommonOperGroup potentialBox      ("potentialBox",      oper_policy::better_not_in_meta_scripting);
 
     // Float32 variants
     DirectPotentialOperator<Float32> potDF32Def  (&potentialDefault , AnalysisType::PotentialDefault);
@@ -469,6 +478,9 @@ namespace
     DirectPotentialOperator<Float32> potDF32Slow (&potentialSlow    , AnalysisType::PotentialSlow);
     DirectPotentialOperator<Float32> potDF32P    (&potentialPacked  , AnalysisType::PotentialIppsPacked);
     DirectPotentialOperator<Float32> potDF32RP   (&potentialRawPacked, AnalysisType::PotentialRawIppsPacked);
+    DirectPotentialOperator<Float32> potDF32Fft  (&potentialFft     , AnalysisType::PotentialFft);
+    DirectPotentialOperator<Float32> potDF32Sep  (&potentialSeparable, AnalysisType::PotentialSeparable);
+    DirectPotentialOperator<Float32> potDF32Box  (&potentialBox     , AnalysisType::PotentialBox);
 
 #if defined(DMS_USE_INTEL_IPPI)
     DirectPotentialOperator<Float32> potDF32Ippi (&potentialIppi32  , AnalysisType::PotentialIppi);
@@ -479,6 +491,9 @@ namespace
     DirectPotentialOperator<Float64> potDF64Ipps (&potentialIpps64  , AnalysisType::PotentialIpps64);
     DirectPotentialOperator<Float64> potDF64IppsR(&potentialRaw64   , AnalysisType::PotentialRawIpps64);
     DirectPotentialOperator<Float64> potDF64Slow (&potentialSlow    , AnalysisType::PotentialSlow);
+    DirectPotentialOperator<Float64> potDF64Fft  (&potentialFft     , AnalysisType::PotentialFft);
+    DirectPotentialOperator<Float64> potDF64Sep  (&potentialSeparable, AnalysisType::PotentialSeparable);
+    DirectPotentialOperator<Float64> potDF64Box  (&potentialBox     , AnalysisType::PotentialBox);
 
 #if defined(DMS_POTENTIAL_I16)
     // Int16 variants (mapped onto packed / raw / ipps64 backends)
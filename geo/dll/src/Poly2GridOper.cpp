@@ -11,14 +11,19 @@
 //   - Handles polygons with multiple parts (rings) and edges outside the viewport
 //     using left/right "toggle" sentinels to keep winding parity correct.
 //   - Re-usable, pre-allocated resources to minimize per-scanline allocations.
-//   - Two main flows:
+//   - Three main flows:
 //       1) poly2grid: writes span-filled raster lines into a tile buffer.
 //       2) poly2allgrids: produces RLE spans per polygon per tile.
+//       3) poly2grid_coverage: adds the covered fraction of each cell per polygon (anti-aliased, see PolygonCoverage.h).
+//       4) poly2grid_zonal_sum/count/mean and poly2grid_class_area: statistics of grid cells per polygon,
+//          weighted by the covered fractions, without a raster of the polygons.
 //
 // Threading:
 //   - Rasterization resources (IFP_resouces) are allocated per call-site/
 //     per-thread and re-used within a scan to avoid frequent allocations.
 //   - Operators support parallel tile loops.
+//   - For tiled grids, polygons are binned to the raster tiles that their bounding box intersects once (BinPolygons),
+//     after which each raster tile only visits its own polygons, instead of rejecting all polygon blocks per raster tile.
 //
 // Important invariants:
 //   - A pixel is considered inside the polygon if its center lies inside.
@@ -34,10 +39,14 @@
 #pragma hdrstop
 #endif
 
+#include <numeric>
+#include <optional>
+
 #include "act/UpdateMark.h"
 #include "dbg/SeverityType.h"
 #include "geo/Conversions.h"
 #include "geo/RangeIndex.h"
+#include "geo/SpatialIndex.h"
 #include "mth/Mathlib.h"
 #include "xct/DmsException.h"
 
@@ -53,6 +62,7 @@
 #include "Operator.h"
 
 #include "ViewPortInfoEx.h"
+#include "PolygonCoverage.h"
 #include "RemoveAdjacentsAndSpikes.h"
 
 /************************************************************************/
@@ -510,6 +520,88 @@ namespace poly2grid
 		);
 	}
 
+	// Reference to a polygon by its polygon tile and its offset in that tile.
+	struct poly_ref
+	{
+		tile_id     m_Tile;
+		tile_offset m_Offset;
+	};
+
+	// The polygons whose bounding box intersects each raster tile, in polygon order, which keeps the burning order
+	// and thus the result where polygons overlap.
+	struct tile_bins
+	{
+		std::vector<SizeT>    m_TileStarts; // the refs of raster tile t are m_Refs[m_TileStarts[t]] .. m_Refs[m_TileStarts[t+1]]
+		std::vector<poly_ref> m_Refs;
+
+		const poly_ref* begin(tile_id t) const { return begin_ptr(m_Refs) + m_TileStarts[t]; }
+		const poly_ref* end  (tile_id t) const { return begin_ptr(m_Refs) + m_TileStarts[t + 1]; }
+	};
+
+	// Bins all polygons once to the raster tiles that their bounding box intersects, with a spatial index of the raster tile extents.
+	tile_bins BinPolygons(const AbstrUnit* resDomain, const AbstrDataItem* polyAttr, const AbstrBoundingBoxCache* boxesArray)
+	{
+		const AbstrUnit* polyDomain = polyAttr->GetAbstrDomainUnit();
+		tile_id tn = resDomain->GetNrTiles(), tpn = polyDomain->GetNrTiles();
+
+		// the extents of the raster tiles in the coordinates of the polygons
+		std::vector<DRect> tileClipRects(tn);
+		parallel_for<tile_id>(tn, [&](tile_id tg)
+			{
+				ViewPortInfoEx<Int32> viewPortInfo(polyAttr, resDomain, tg, AsUnit(polyAttr->GetAbstrValuesUnit()->GetCurrRangeItem()), no_tile, nullptr, false, false, countcolor_t(-1), false);
+				tileClipRects[tg] = viewPortInfo.GetViewPortInGrid();
+			}
+		);
+		using TileIndexType = SpatialIndex<Float64, const DRect*>;
+		TileIndexType tileIndex(begin_ptr(tileClipRects), end_ptr(tileClipRects));
+		DRect rasterBounds = tileIndex.GetBoundingBox();
+
+		// per polygon tile: the raster tile and offset of each polygon in polygon order
+		std::vector<std::vector<std::pair<tile_id, tile_offset>>> polyTileBins(tpn);
+		parallel_for<tile_id>(tpn, [&](tile_id tp)
+			{
+				if (!IsIntersecting(rasterBounds, boxesArray->GetTileBounds(tp)))
+					return;
+				auto& polyTileBin = polyTileBins[tp];
+				for (tile_offset i = 0, e = polyDomain->GetTileCount(tp); i < e; ++i)
+				{
+					if (!(i % AbstrBoundingBoxCache::c_BlockSize) && !IsIntersecting(rasterBounds, boxesArray->GetBlockBounds(tp, i / AbstrBoundingBoxCache::c_BlockSize)))
+					{
+						i += AbstrBoundingBoxCache::c_BlockSize - 1;
+						continue;
+					}
+					DRect bounds = boxesArray->GetBounds(tp, i);
+					for (auto iter = tileIndex.begin(bounds); iter; ++iter)
+					{
+						const DRect* tileClipRectPtr = (*iter)->get_ptr();
+						if (IsIntersecting(*tileClipRectPtr, bounds))
+							polyTileBin.emplace_back(tileClipRectPtr - begin_ptr(tileClipRects), i);
+					}
+				}
+			}
+		);
+
+		// counting sort by raster tile, which keeps the polygon order per raster tile
+		tile_bins result;
+		result.m_TileStarts.assign(tn + 1, 0);
+		for (const auto& polyTileBin : polyTileBins)
+			for (const auto& tileAndOffset : polyTileBin)
+				++result.m_TileStarts[tileAndOffset.first + 1];
+		std::partial_sum(result.m_TileStarts.begin(), result.m_TileStarts.end(), result.m_TileStarts.begin());
+
+		result.m_Refs.resize(result.m_TileStarts.back());
+		std::vector<SizeT> nextRef(result.m_TileStarts.begin(), result.m_TileStarts.end() - 1);
+		for (tile_id tp = 0; tp != tpn; ++tp)
+		{
+			for (const auto& tileAndOffset : polyTileBins[tp])
+				result.m_Refs[nextRef[tileAndOffset.first]++] = poly_ref{ tp, tileAndOffset.second };
+			vector_clear(polyTileBins[tp]);
+		}
+
+		reportF(SeverityTypeID::ST_MinorTrace, "%s binned %d polygon references to %d raster tiles", polyAttr->GetName().c_str(), result.m_Refs.size(), tn);
+		return result;
+	}
+
 	// Dispatcher per raster tile: transforms polygon coordinates into tile-local
 	// grid space and burns polygons into the result buffer.
 	struct p2g_DispatcherTileData
@@ -535,96 +627,182 @@ namespace poly2grid
 		tile_id                        m_RasterTileId;
 		std::unique_ptr<AbstrSequenceGetter> m_SequenceGetter;
 
-		// Template over domain E: map polygon domain indices to burn values and write into raster tile.
-		template <typename E>
-		void GetBitmap(typename Unit<E>::range_t indexRange) // corresponding with the indices of m_PolyData
+		// Calls func(tp, i, dPoints) for each polygon whose bounds intersect the raster tile, with its points in tile-local grid coords.
+		// With bins, only the polygons binned to this raster tile are visited; else all polygon tiles and blocks are scanned.
+		template <typename Func>
+		void ForEachPolygon(const tile_bins* bins, CharPtr operName, Func&& func)
 		{
-			RasterSizeType size = m_ViewPortInfo.GetViewPortSize();
-			IPoint base = m_ViewPortInfo.GetViewPortOrigin();
-
 			const AbstrDataItem* polyAttr = m_PolyAttr;
 			const AbstrDataObject* polyData = polyAttr->GetCurrRefObj().get();
 			const AbstrUnit* abstrPolyDomain = polyAttr->GetAbstrDomainUnit(); // could be void domain.
 			assert(abstrPolyDomain);
-			const Unit<E>* polyDomain = dynamic_cast<const Unit<E>*>(abstrPolyDomain); // could be nullptr
 
 			DRect clipRect = m_ViewPortInfo.GetViewPortInGrid();
 
 			// Create transform from layer/world coords to tile-local grid coords.
 			CrdTransformation transForm = m_ViewPortInfo.Inverse();
-			transForm -= base;
+			transForm -= m_ViewPortInfo.GetViewPortOrigin();
 			std::vector<DPoint> dPoints;
-			IFP_resouces ifpResources; // per-call scratch
-
-			// Acquire write buffer for tile and wrap as RasterizeInfo sink.
-			auto res = mutable_array_cast<E>(m_ResObj)->GetDataWrite(m_RasterTileId, dms_rw_mode::write_only_all);
-			MG_CHECK(res.size() == Cardinality(size)); // or at least at least
-			auto rasterInfo = RasterizeInfo<E>(Convert<RasterSizeType>(size), res.begin());
 
 			assert(m_BoxesArrays);
+			AbstrSequenceGetter* sg = m_SequenceGetter.get();
+			assert(sg);
 
-			// Iterate polygon tiles and features, reject with tile/block/feature bounds.
-			for (tile_id tp = 0, te = abstrPolyDomain->GetNrTiles(); tp!=te; ++tp)
-			{
-				typename Unit<E>::range_t tileIndexRange = polyDomain ? polyDomain->GetTileRange(tp) : indexRange;
-
-				if (!IsIntersecting(clipRect, m_BoxesArrays->GetTileBounds(tp)))
-					continue;
-
-				AbstrSequenceGetter* sg = m_SequenceGetter.get();
-				assert(sg);
-				sg->OpenTile(polyData, tp);
-
-				for (tile_offset i = 0, e = abstrPolyDomain->GetTileCount(tp); i != e; ++i)
+			auto visitPolygon = [&](tile_id tp, tile_offset i)
 				{
 					try
 					{
-						// Skip whole blocks when not intersecting clipRect.
-						if (!(i % AbstrBoundingBoxCache::c_BlockSize))
-							while (!IsIntersecting(clipRect, m_BoxesArrays->GetBlockBounds(tp, i / AbstrBoundingBoxCache::c_BlockSize)))
-							{
-								i += AbstrBoundingBoxCache::c_BlockSize;
-								if (!(i < e))
-									goto end_of_tile_loop;
-							}
-
-						// Fine-grained feature rejection.
-						if (!IsIntersecting(clipRect, m_BoxesArrays->GetBounds(tp, i)))
-							continue;
 						sg->GetValue(i, dPoints);
 
 						// Clean degenerate vertices (adjacent duplicates/spikes).
 						remove_adjacents_and_spikes(dPoints);
 						if (dPoints.size() < 3)
-							continue;
+							return;
 
 						// Transform to tile-local grid coords.
 						for (auto pi = dPoints.begin(), pe = dPoints.end(); pi != pe; ++pi)
 							transForm.InplApply(*pi);
 
-						// Compute burn value per-feature (domain dependent).
-						BurnValueVariant eBurnValueSource = Range_GetValue_naked(tileIndexRange, i);
-
-						// Rasterize polygon to tile buffer.
-						rasterize_one_shape(&rasterInfo, dPoints, eBurnValueSource, ifpResources);
+						func(tp, i, dPoints);
 					}
 					catch (DmsException& x)
 					{
-						x.AsErrMsg()->TellExtraF("\nin poly2grid at tile %d and index %d", tp, i);
+						x.AsErrMsg()->TellExtraF("\nin %s at tile %d and index %d", operName, tp, i);
 						throw;
 					}
+				};
+
+			if (bins)
+			{
+				tile_id openTile = no_tile;
+				for (const poly_ref* refPtr = bins->begin(m_RasterTileId), *refEnd = bins->end(m_RasterTileId); refPtr != refEnd; ++refPtr)
+				{
+					if (refPtr->m_Tile != openTile)
+					{
+						openTile = refPtr->m_Tile;
+						sg->OpenTile(polyData, openTile);
+					}
+					visitPolygon(refPtr->m_Tile, refPtr->m_Offset);
+				}
+				return;
+			}
+
+			// Iterate polygon tiles and features, reject with tile/block/feature bounds.
+			for (tile_id tp = 0, te = abstrPolyDomain->GetNrTiles(); tp!=te; ++tp)
+			{
+				if (!IsIntersecting(clipRect, m_BoxesArrays->GetTileBounds(tp)))
+					continue;
+
+				sg->OpenTile(polyData, tp);
+
+				for (tile_offset i = 0, e = abstrPolyDomain->GetTileCount(tp); i != e; ++i)
+				{
+					// Skip whole blocks when not intersecting clipRect.
+					if (!(i % AbstrBoundingBoxCache::c_BlockSize))
+						while (!IsIntersecting(clipRect, m_BoxesArrays->GetBlockBounds(tp, i / AbstrBoundingBoxCache::c_BlockSize)))
+						{
+							i += AbstrBoundingBoxCache::c_BlockSize;
+							if (!(i < e))
+								goto end_of_tile_loop;
+						}
+
+					// Fine-grained feature rejection.
+					if (!IsIntersecting(clipRect, m_BoxesArrays->GetBounds(tp, i)))
+						continue;
+					visitPolygon(tp, i);
 				}
 			end_of_tile_loop: ;
 			}
 		}
 
+		// Template over domain E: map polygon domain indices to burn values and write into raster tile.
+		template <typename E>
+		void GetBitmap(typename Unit<E>::range_t indexRange, const tile_bins* bins) // corresponding with the indices of m_PolyData
+		{
+			RasterSizeType size = m_ViewPortInfo.GetViewPortSize();
+
+			const AbstrUnit* abstrPolyDomain = m_PolyAttr->GetAbstrDomainUnit(); // could be void domain.
+			assert(abstrPolyDomain);
+			const Unit<E>* polyDomain = dynamic_cast<const Unit<E>*>(abstrPolyDomain); // could be nullptr
+
+			IFP_resouces ifpResources; // per-call scratch
+
+			// Acquire write buffer for tile and wrap as RasterizeInfo sink.
+			auto res = mutable_array_cast<E>(m_ResObj)->GetDataWrite(m_RasterTileId, dms_rw_mode::write_only_all);
+			MG_CHECK(res.size() == Cardinality(size)); // or at least at least
+			auto rasterInfo = RasterizeInfo<E>(Convert<RasterSizeType>(size), res.begin());
+
+			tile_id indexRangeTile = no_tile;
+			typename Unit<E>::range_t tileIndexRange = indexRange;
+			ForEachPolygon(bins, "poly2grid", [&](tile_id tp, tile_offset i, std::vector<DPoint>& dPoints)
+				{
+					if (polyDomain && tp != indexRangeTile)
+					{
+						tileIndexRange = polyDomain->GetTileRange(tp);
+						indexRangeTile = tp;
+					}
+
+					// Compute burn value per-feature (domain dependent).
+					BurnValueVariant eBurnValueSource = Range_GetValue_naked(tileIndexRange, i);
+
+					// Rasterize polygon to tile buffer.
+					rasterize_one_shape(&rasterInfo, dPoints, eBurnValueSource, ifpResources);
+				}
+			);
+		}
+
 		// Specialization for Void domain: map to Bool domain with trivial range.
 		template <>
-		void GetBitmap<Void>(typename Unit<Void>::range_t /*indexRange*/)
+		void GetBitmap<Void>(typename Unit<Void>::range_t /*indexRange*/, const tile_bins* bins)
+		{
+			GetBitmap<Bool>(Unit<Bool>::range_t(1, 2), bins);
+		}
+
+		// Calls cellFunc(tp, i, cellIndex, fraction) for each cell of the raster tile that polygon (tp, i) covers partly or completely,
+		// polygon by polygon; only the cells within the bounding box of a polygon are accumulated.
+		template <typename Func>
+		void ForEachCoveredCell(const tile_bins* bins, CharPtr operName, Func&& cellFunc)
 		{
-			GetBitmap<Bool>(Unit<Bool>::range_t(1, 2));
+			RasterSizeType size = m_ViewPortInfo.GetViewPortSize();
+
+			coverage_accumulator accumulator;
+			ForEachPolygon(bins, operName, [&](tile_id tp, tile_offset i, std::vector<DPoint>& dPoints)
+				{
+					auto polyBounds = DRect(dPoints.begin(), dPoints.end(), false, false);
+					auto clampCol = [&size](Float64 x) { return rowcol_t(Max<Float64>(Min<Float64>(x, size.X()), 0.0)); };
+					auto clampRow = [&size](Float64 y) { return rowcol_t(Max<Float64>(Min<Float64>(y, size.Y()), 0.0)); };
+					rowcol_t firstCol = clampCol(std::floor(polyBounds.first .X())), lastCol = clampCol(std::ceil(polyBounds.second.X()));
+					rowcol_t firstRow = clampRow(std::floor(polyBounds.first .Y())), lastRow = clampRow(std::ceil(polyBounds.second.Y()));
+					if (firstCol >= lastCol || firstRow >= lastRow)
+						return;
+
+					accumulator.Reset(lastCol - firstCol, lastRow - firstRow);
+					accumulator.AddRing(begin_ptr(dPoints), end_ptr(dPoints), firstCol, firstRow);
+					accumulator.ForEachCoverage([&](SizeT r, SizeT c, Float64 fraction)
+						{
+							cellFunc(tp, i, (firstRow + r) * size.X() + (firstCol + c), fraction);
+						}
+					);
+				}
+			);
 		}
 
+		// Adds the fraction of each cell that each polygon covers into a Float32 raster tile.
+		void GetCoverage(const tile_bins* bins)
+		{
+			RasterSizeType size = m_ViewPortInfo.GetViewPortSize();
+
+			auto res = mutable_array_cast<Float32>(m_ResObj)->GetDataWrite(m_RasterTileId, dms_rw_mode::write_only_all);
+			MG_CHECK(res.size() == Cardinality(size));
+			fast_zero(res.begin(), res.end());
+
+			auto resData = res.begin();
+			ForEachCoveredCell(bins, "poly2grid_coverage", [resData](tile_id, tile_offset, SizeT cellIndex, Float64 fraction)
+				{
+					resData[cellIndex] += fraction;
+				}
+			);
+		}
 	};
 
 	// Dispatcher producing RLE results instead of direct raster writes.
@@ -779,15 +957,21 @@ struct Poly2GridOperator : public BinaryOperator
 		// TODO G8: Avoid double work for polygons that intersect multiple tiles:
 		//          e.g. with an ordered heap processing neighboring tiles together.
 
-		auto poly2gridFunctor = [resObj, resDomain, polyAttr, boxesArray](tile_id tg)
+		// Bin the polygons to the raster tiles once when there are several
+		std::optional<poly2grid::tile_bins> bins;
+		tile_id tn = resObj->GetTiledRangeData()->GetNrTiles();
+		if (!doUntiled && tn > 1)
+			bins = poly2grid::BinPolygons(resDomain, polyAttr, boxesArray);
+
+		auto poly2gridFunctor = [resObj, resDomain, polyAttr, boxesArray, binsPtr = bins ? &*bins : nullptr](tile_id tg)
 		{
 			poly2grid::p2g_DispatcherTileData dispatcherTileData(resObj, resDomain, polyAttr, boxesArray, tg);
 
 			// Dispatch on polygon domain type to get proper index range mapping.
 			visit<typelists::domain_int_types>(polyAttr->GetAbstrDomainUnit(),
-				[&dispatcherTileData]<typename E>(const Unit<E>* polyDomain)
+				[&dispatcherTileData, binsPtr]<typename E>(const Unit<E>* polyDomain)
 				{
-					dispatcherTileData.GetBitmap<E>(polyDomain->GetRange());
+					dispatcherTileData.GetBitmap<E>(polyDomain->GetRange(), binsPtr);
 				}
 			);
 		};
@@ -796,7 +980,72 @@ struct Poly2GridOperator : public BinaryOperator
 		if (doUntiled)
 			poly2gridFunctor(no_tile);
 		else
-			parallel_tileloop(resObj->GetTiledRangeData()->GetNrTiles(), poly2gridFunctor);
+			parallel_tileloop(tn, poly2gridFunctor);
+	}
+};
+
+// *****************************************************************************
+//									Poly2GridCoverageOperator (PolygonAttr, GridSet)
+// *****************************************************************************
+//
+// Anti-aliased poly2grid: the result is the sum over all polygons of the fraction of each cell that they cover,
+// which is the covered fraction of the cell if the polygons don't overlap.
+//
+CommonOperGroup cog_poly2grid_coverage("poly2grid_coverage", oper_policy::better_not_in_meta_scripting);
+
+struct Poly2GridCoverageOperator : public BinaryOperator
+{
+	Poly2GridCoverageOperator(const DataItemClass* polyAttrClass, const UnitClass* gridSetType)
+		: BinaryOperator(&cog_poly2grid_coverage, DataArray<Float32>::GetStaticClass()
+			, polyAttrClass
+			, gridSetType
+		)
+	{}
+
+	bool CreateResult(TreeItemDualRef& resultHolder, const ArgSeqType& args, bool mustCalc) const override
+	{
+		assert(args.size() == 2);
+		const AbstrDataItem* polyAttr = AsDataItem(args[0]); // can be segmented
+		const AbstrUnit* gridDomainUnit = AsUnit(args[1]); // can be tiled
+
+		assert(polyAttr);
+		assert(gridDomainUnit);
+
+		if (!resultHolder)
+			resultHolder = CreateCacheDataItem(gridDomainUnit, Unit<Float32>::GetStaticClass()->CreateDefault());
+
+		if (!mustCalc)
+		{
+			// Validate transform compatibility early (no execution).
+			ViewPortInfoEx<Int32> viewPortInfoCheck(polyAttr, gridDomainUnit, no_tile, AsUnit(polyAttr->GetAbstrValuesUnit()->GetCurrRangeItem()), no_tile, nullptr, false, true, countcolor_t(-1), false);
+		}
+		else
+		{
+			AbstrDataItem* res = AsDataItem(resultHolder.GetNew());
+
+			DataReadLock arg1Lock(polyAttr);
+
+			auto bounds = GetSequenceBounds(polyAttr, false);
+
+			DataWriteLock resLock(res, dms_rw_mode::write_only_mustzero);
+
+			AbstrDataObject* resObj = resLock.get();
+			const AbstrUnit* resDomain = res->GetAbstrDomainUnit();
+			tile_id tn = resObj->GetTiledRangeData()->GetNrTiles();
+			std::optional<poly2grid::tile_bins> bins;
+			if (tn > 1)
+				bins = poly2grid::BinPolygons(resDomain, polyAttr, bounds.get());
+
+			parallel_tileloop(tn, [resObj, resDomain, polyAttr, boxesArray = bounds.get(), binsPtr = bins ? &*bins : nullptr](tile_id tg)
+				{
+					poly2grid::p2g_DispatcherTileData dispatcherTileData(resObj, resDomain, polyAttr, boxesArray, tg);
+					dispatcherTileData.GetCoverage(binsPtr);
+				}
+			);
+
+			resLock.Commit();
+		}
+		return true;
 	}
 };
 
@@ -940,6 +1189,333 @@ struct Poly2AllGridsOperator : public BinaryOperator
 	}
 };
 
+// *****************************************************************************
+//								Zonal statistics (PolygonAttr, GridAttr)
+// *****************************************************************************
+//
+// Statistics of the cells of a grid attribute per polygon, weighted by the fraction of each cell that the polygon covers:
+//  - poly2grid_zonal_sum:   the sum of the weighted defined cell values
+//  - poly2grid_zonal_count: the sum of the covered fractions of the cells with a defined value
+//  - poly2grid_zonal_mean:  their ratio, undefined for polygons that cover no defined cells
+//  - poly2grid_class_area:  a new domain with a row per polygon and class value of a class grid that the polygon covers,
+//                           with subitems polygon_rel, class_rel and area, in the squared units of the polygon coordinates
+// The covered fractions are streamed per raster tile (see ForEachCoveredCell) and merged per polygon in raster tile order,
+// without allocating a raster for the polygons.
+//
+CommonOperGroup cog_poly2grid_zonal_sum  ("poly2grid_zonal_sum",   oper_policy::better_not_in_meta_scripting);
+CommonOperGroup cog_poly2grid_zonal_count("poly2grid_zonal_count", oper_policy::better_not_in_meta_scripting);
+CommonOperGroup cog_poly2grid_zonal_mean ("poly2grid_zonal_mean",  oper_policy::better_not_in_meta_scripting);
+CommonOperGroup cog_poly2grid_class_area ("poly2grid_class_area",  oper_policy::better_not_in_meta_scripting);
+
+static TokenID s_ClassRelTokenID = GetTokenID_st("class_rel");
+static TokenID s_AreaTokenID     = GetTokenID_st("area");
+
+namespace poly2grid
+{
+	enum class zonal_stat { sum, count, mean };
+
+	// the weighted sum and the weight of the cells of one raster tile that a polygon covers
+	struct zonal_partial
+	{
+		tile_id     m_Tile;
+		tile_offset m_Offset;
+		Float64     m_WeightedSum, m_Weight;
+	};
+
+	// the area of the cells of one class that a polygon covers
+	template <typename V>
+	struct class_partial
+	{
+		tile_id     m_Tile;
+		tile_offset m_Offset;
+		V           m_Class;
+		Float64     m_Area;
+
+		bool HasSameKey(const class_partial& rhs) const { return m_Tile == rhs.m_Tile && m_Offset == rhs.m_Offset && m_Class == rhs.m_Class; }
+		bool operator <(const class_partial& rhs) const
+		{
+			if (m_Tile   != rhs.m_Tile  ) return m_Tile   < rhs.m_Tile;
+			if (m_Offset != rhs.m_Offset) return m_Offset < rhs.m_Offset;
+			return m_Class < rhs.m_Class;
+		}
+	};
+
+	// Calls tileFunc(dispatcherTileData, gridTileData, bins) in parallel for each tile of the domain of gridAttr.
+	template <typename V, typename Func>
+	void ForEachGridTile(const AbstrDataItem* polyAttr, const AbstrDataItem* gridAttr, const AbstrBoundingBoxCache* boxesArray, Func&& tileFunc)
+	{
+		const AbstrUnit* gridDomain = gridAttr->GetAbstrDomainUnit();
+		tile_id tn = gridDomain->GetNrTiles();
+		std::optional<tile_bins> bins;
+		if (tn > 1)
+			bins = BinPolygons(gridDomain, polyAttr, boxesArray);
+
+		parallel_tileloop(tn, [&, binsPtr = bins ? &*bins : nullptr](tile_id tg)
+			{
+				p2g_DispatcherTileData dispatcherTileData(nullptr, gridDomain, polyAttr, boxesArray, tg);
+				auto gridTileData = const_array_cast<V>(gridAttr)->GetTile(tg);
+				MG_CHECK(gridTileData.size() == Cardinality(dispatcherTileData.m_ViewPortInfo.GetViewPortSize()));
+				tileFunc(dispatcherTileData, gridTileData, binsPtr);
+			}
+		);
+	}
+}
+
+struct AbstrPoly2GridZonalOperator : public BinaryOperator
+{
+	AbstrPoly2GridZonalOperator(AbstrOperGroup& aog, ClassCPtr resultClass, const DataItemClass* polyAttrClass, const DataItemClass* gridAttrClass)
+		: BinaryOperator(&aog, resultClass
+			, polyAttrClass
+			, gridAttrClass
+		)
+	{}
+
+	void CheckGrid(TreeItemDualRef& resultHolder, const AbstrDataItem* polyAttr, const AbstrDataItem* gridAttr) const
+	{
+		const AbstrUnit* gridDomainUnit = gridAttr->GetAbstrDomainUnit();
+		if (gridDomainUnit->GetNrDimensions() != 2)
+			resultHolder.throwItemError("Raster data expected as second argument");
+
+		// Validate transform compatibility early (no execution).
+		ViewPortInfoEx<Int32> viewPortInfoCheck(polyAttr, gridDomainUnit, no_tile, AsUnit(polyAttr->GetAbstrValuesUnit()->GetCurrRangeItem()), no_tile, nullptr, false, true, countcolor_t(-1), false);
+	}
+};
+
+template <typename V>
+struct Poly2GridZonalOperator : public AbstrPoly2GridZonalOperator
+{
+	poly2grid::zonal_stat m_Stat;
+
+	Poly2GridZonalOperator(AbstrOperGroup& aog, poly2grid::zonal_stat stat, const DataItemClass* polyAttrClass)
+		: AbstrPoly2GridZonalOperator(aog, DataArray<Float64>::GetStaticClass(), polyAttrClass, DataArray<V>::GetStaticClass())
+		, m_Stat(stat)
+	{}
+
+	bool CreateResult(TreeItemDualRef& resultHolder, const ArgSeqType& args, bool mustCalc) const override
+	{
+		assert(args.size() == 2);
+		const AbstrDataItem* polyAttr = AsDataItem(args[0]); // can be segmented
+		const AbstrDataItem* gridAttr = AsDataItem(args[1]); // can be tiled
+
+		assert(polyAttr);
+		assert(gridAttr);
+
+		if (!resultHolder)
+			resultHolder = CreateCacheDataItem(polyAttr->GetAbstrDomainUnit(), Unit<Float64>::GetStaticClass()->CreateDefault());
+
+		if (!mustCalc)
+			CheckGrid(resultHolder, polyAttr, gridAttr);
+		else
+		{
+			AbstrDataItem* res = AsDataItem(resultHolder.GetNew());
+
+			DataReadLock arg1Lock(polyAttr);
+			DataReadLock arg2Lock(gridAttr);
+
+			auto bounds = GetSequenceBounds(polyAttr, false);
+
+			DataWriteLock resLock(res);
+			Calculate(resLock.get(), polyAttr, gridAttr, bounds.get());
+			resLock.Commit();
+		}
+		return true;
+	}
+
+	void Calculate(AbstrDataObject* resObj, const AbstrDataItem* polyAttr, const AbstrDataItem* gridAttr, const AbstrBoundingBoxCache* boxesArray) const
+	{
+		const AbstrUnit* polyDomain = polyAttr->GetAbstrDomainUnit();
+		tile_id tn = gridAttr->GetAbstrDomainUnit()->GetNrTiles(), tpn = polyDomain->GetNrTiles();
+
+		std::vector<std::vector<poly2grid::zonal_partial>> tilePartials(tn);
+		poly2grid::ForEachGridTile<V>(polyAttr, gridAttr, boxesArray, [this, &tilePartials](poly2grid::p2g_DispatcherTileData& dispatcherTileData, const auto& gridTileData, const poly2grid::tile_bins* bins)
+			{
+				auto& partials = tilePartials[dispatcherTileData.m_RasterTileId];
+				dispatcherTileData.ForEachCoveredCell(bins, GetGroup()->GetNameStr(), [&partials, gridData = gridTileData.begin()](tile_id tp, tile_offset i, SizeT cellIndex, Float64 fraction)
+					{
+						V v = gridData[cellIndex];
+						if (!IsDefined(v))
+							return;
+						if (partials.empty() || partials.back().m_Tile != tp || partials.back().m_Offset != i)
+							partials.emplace_back(poly2grid::zonal_partial{ tp, i, 0.0, 0.0 });
+						partials.back().m_WeightedSum += fraction * Float64(v);
+						partials.back().m_Weight      += fraction;
+					}
+				);
+			}
+		);
+
+		// merge the partial results of polygons that intersect several raster tiles, in raster tile order
+		std::vector<std::vector<Float64>> weightedSums(tpn), weights(tpn);
+		for (tile_id tp = 0; tp != tpn; ++tp)
+		{
+			weightedSums[tp].resize(polyDomain->GetTileCount(tp));
+			weights     [tp].resize(polyDomain->GetTileCount(tp));
+		}
+		for (auto& partials : tilePartials)
+		{
+			for (const auto& partial : partials)
+			{
+				weightedSums[partial.m_Tile][partial.m_Offset] += partial.m_WeightedSum;
+				weights     [partial.m_Tile][partial.m_Offset] += partial.m_Weight;
+			}
+			vector_clear(partials);
+		}
+
+		auto resArray = mutable_array_cast<Float64>(resObj);
+		parallel_tileloop(tpn, [this, resArray, &weightedSums, &weights](tile_id tp)
+			{
+				auto resData = resArray->GetDataWrite(tp, dms_rw_mode::write_only_all);
+				MG_CHECK(resData.size() == weights[tp].size());
+				for (SizeT i = 0, n = resData.size(); i != n; ++i)
+				{
+					switch (m_Stat)
+					{
+						case poly2grid::zonal_stat::sum:   resData[i] = weightedSums[tp][i]; break;
+						case poly2grid::zonal_stat::count: resData[i] = weights[tp][i]; break;
+						case poly2grid::zonal_stat::mean:  resData[i] = (weights[tp][i] > 0) ? weightedSums[tp][i] / weights[tp][i] : UNDEFINED_VALUE(Float64); break;
+					}
+				}
+			}
+		);
+	}
+};
+
+template <typename V>
+struct Poly2GridClassAreaOperator : public AbstrPoly2GridZonalOperator
+{
+	Poly2GridClassAreaOperator(const DataItemClass* polyAttrClass)
+		: AbstrPoly2GridZonalOperator(cog_poly2grid_class_area, Unit<UInt32>::GetStaticClass(), polyAttrClass, DataArray<V>::GetStaticClass())
+	{}
+
+	bool CreateResult(TreeItemDualRef& resultHolder, const ArgSeqType& args, bool mustCalc) const override
+	{
+		assert(args.size() == 2);
+		const AbstrDataItem* polyAttr = AsDataItem(args[0]); // can be segmented
+		const AbstrDataItem* gridAttr = AsDataItem(args[1]); // can be tiled
+
+		assert(polyAttr);
+		assert(gridAttr);
+
+		const AbstrUnit* polyDomainUnit = polyAttr->GetAbstrDomainUnit();
+		assert(polyDomainUnit);
+
+		// Setup synthetic domain and result attributes.
+		resultHolder = Unit<UInt32>::GetStaticClass()->CreateResultUnit(resultHolder).release();
+		auto resDomain = AsUnit(resultHolder.GetNew()); assert(resDomain);
+		AbstrDataItem* resPolyRelAttr = nullptr;
+		if (polyDomainUnit->GetValueType() != ValueWrap<Void>::GetStaticClass())
+			resPolyRelAttr = CreateDataItem(resDomain, s_PolygonRelTokenID, resDomain, polyDomainUnit, ValueComposition::Single);
+		AbstrDataItem* resClassRelAttr = CreateDataItem(resDomain, s_ClassRelTokenID, resDomain, gridAttr->GetAbstrValuesUnit(), ValueComposition::Single);
+		AbstrDataItem* resAreaAttr = CreateDataItem(resDomain, s_AreaTokenID, resDomain, Unit<Float64>::GetStaticClass()->CreateDefault(), ValueComposition::Single);
+
+		if (!mustCalc)
+			CheckGrid(resultHolder, polyAttr, gridAttr);
+		else
+		{
+			DataReadLock arg1Lock(polyAttr);
+			DataReadLock arg2Lock(gridAttr);
+
+			auto bounds = GetSequenceBounds(polyAttr, false);
+
+			Calculate(resDomain, resPolyRelAttr, resClassRelAttr, resAreaAttr, polyAttr, gridAttr, bounds.get());
+		}
+		return true;
+	}
+
+	void Calculate(AbstrUnit* resDomain, AbstrDataItem* resPolyRelAttr, AbstrDataItem* resClassRelAttr, AbstrDataItem* resAreaAttr
+		, const AbstrDataItem* polyAttr, const AbstrDataItem* gridAttr, const AbstrBoundingBoxCache* boxesArray) const
+	{
+		using partial_t = poly2grid::class_partial<V>;
+
+		tile_id tn = gridAttr->GetAbstrDomainUnit()->GetNrTiles();
+		std::vector<std::vector<partial_t>> tilePartials(tn);
+		poly2grid::ForEachGridTile<V>(polyAttr, gridAttr, boxesArray, [this, &tilePartials](poly2grid::p2g_DispatcherTileData& dispatcherTileData, const auto& gridTileData, const poly2grid::tile_bins* bins)
+			{
+				auto factor = dispatcherTileData.m_ViewPortInfo.Factor();
+				Float64 cellArea = std::abs(factor.X() * factor.Y());
+
+				// the covered fractions per class of the current polygon, which are reduced when the next polygon starts
+				auto& partials = tilePartials[dispatcherTileData.m_RasterTileId];
+				SizeT polygonStart = 0;
+				auto reducePolygon = [&partials, &polygonStart, cellArea]()
+					{
+						std::sort(partials.begin() + polygonStart, partials.end());
+						auto resultEnd = partials.begin() + polygonStart;
+						for (auto pi = resultEnd, pe = partials.end(); pi != pe; ++pi)
+						{
+							if (resultEnd != partials.begin() + polygonStart && resultEnd[-1].HasSameKey(*pi))
+								resultEnd[-1].m_Area += pi->m_Area;
+							else
+								*resultEnd++ = *pi;
+						}
+						partials.erase(resultEnd, partials.end());
+						for (auto pi = partials.begin() + polygonStart, pe = partials.end(); pi != pe; ++pi)
+							pi->m_Area *= cellArea;
+						polygonStart = partials.size();
+					};
+
+				dispatcherTileData.ForEachCoveredCell(bins, GetGroup()->GetNameStr(), [&partials, &polygonStart, &reducePolygon, gridData = gridTileData.begin()](tile_id tp, tile_offset i, SizeT cellIndex, Float64 fraction)
+					{
+						V v = gridData[cellIndex];
+						if (!IsDefined(v))
+							return;
+						if (polygonStart != partials.size() && (partials.back().m_Tile != tp || partials.back().m_Offset != i))
+							reducePolygon();
+						partials.emplace_back(partial_t{ tp, i, v, fraction });
+					}
+				);
+				reducePolygon();
+			}
+		);
+
+		// merge the partial results of polygons that intersect several raster tiles
+		std::vector<partial_t> partials;
+		for (auto& tilePartial : tilePartials)
+		{
+			partials.insert(partials.end(), tilePartial.begin(), tilePartial.end());
+			vector_clear(tilePartial);
+		}
+		std::sort(partials.begin(), partials.end());
+		auto resultEnd = partials.begin();
+		for (auto pi = partials.begin(), pe = partials.end(); pi != pe; ++pi)
+		{
+			if (resultEnd != partials.begin() && resultEnd[-1].HasSameKey(*pi))
+				resultEnd[-1].m_Area += pi->m_Area;
+			else
+				*resultEnd++ = *pi;
+		}
+		partials.erase(resultEnd, partials.end());
+
+		resDomain->SetCount(partials.size());
+
+		// Write polygon_rel if polygon domain is not Void.
+		visit<typelists::domain_types>(polyAttr->GetAbstrDomainUnit(), [resPolyRelAttr, &partials]<typename E>(const Unit<E>* domain)
+		{
+			if constexpr (!std::is_same_v<E, Void>)
+			{
+				assert(resPolyRelAttr);
+				auto resPolyRelLock = DataWriteLock(resPolyRelAttr, dms_rw_mode::write_only_all);
+				auto resPolyRelWriter = tile_write_channel<E>(mutable_array_cast<E>(resPolyRelLock.get()));
+				for (const auto& partial : partials)
+					resPolyRelWriter.Write(Range_GetValue_naked(domain->GetTileRange(partial.m_Tile), partial.m_Offset));
+				resPolyRelLock.Commit();
+			}
+		});
+
+		auto resClassRelLock = DataWriteLock(resClassRelAttr, dms_rw_mode::write_only_all);
+		auto resClassRelWriter = tile_write_channel<V>(mutable_array_cast<V>(resClassRelLock.get()));
+		for (const auto& partial : partials)
+			resClassRelWriter.Write(partial.m_Class);
+		resClassRelLock.Commit();
+
+		auto resAreaLock = DataWriteLock(resAreaAttr, dms_rw_mode::write_only_all);
+		auto resAreaWriter = tile_write_channel<Float64>(mutable_array_cast<Float64>(resAreaLock.get()));
+		for (const auto& partial : partials)
+			resAreaWriter.Write(partial.m_Area);
+		resAreaLock.Commit();
+	}
+};
+
 // *****************************************************************************
 //											INSTANTIATION
 // *****************************************************************************
@@ -953,17 +1529,41 @@ struct Poly2AllGridsOperator : public BinaryOperator
 		using DomainUnitType = Unit<DomPoint>;
 
 		Poly2GridOperator m_TiledOper, m_UntiledOper;
+		Poly2GridCoverageOperator m_CoverageOper;
 		Poly2AllGridsOperator<UInt32> m_P2AG32;
 		Poly2AllGridsOperator<UInt64> m_P2AG64;
 
 		DomainInst(const DataItemClass* polygonDataClass)
 			: m_TiledOper  (polygonDataClass, DomainUnitType::GetStaticClass(), false)
 			, m_UntiledOper(polygonDataClass, DomainUnitType::GetStaticClass(), true)
+			, m_CoverageOper(polygonDataClass, DomainUnitType::GetStaticClass())
 			, m_P2AG32(cog_poly2grid32, polygonDataClass, DomainUnitType::GetStaticClass())
 			, m_P2AG64(cog_poly2grid64, polygonDataClass, DomainUnitType::GetStaticClass())
 		{}
 	};
 
+	template <typename V>
+	struct ZonalInst
+	{
+		Poly2GridZonalOperator<V> m_SumOper, m_CountOper, m_MeanOper;
+
+		ZonalInst(const DataItemClass* polygonDataClass)
+			: m_SumOper  (cog_poly2grid_zonal_sum,   poly2grid::zonal_stat::sum,   polygonDataClass)
+			, m_CountOper(cog_poly2grid_zonal_count, poly2grid::zonal_stat::count, polygonDataClass)
+			, m_MeanOper (cog_poly2grid_zonal_mean,  poly2grid::zonal_stat::mean,  polygonDataClass)
+		{}
+	};
+
+	template <typename V>
+	struct ClassInst
+	{
+		Poly2GridClassAreaOperator<V> m_ClassAreaOper;
+
+		ClassInst(const DataItemClass* polygonDataClass)
+			: m_ClassAreaOper(polygonDataClass)
+		{}
+	};
+
 	template <typename CrdPoint>
 	struct Poly2gridOperators
 	{
@@ -972,6 +1572,8 @@ struct Poly2AllGridsOperator : public BinaryOperator
 		using PolygonDataType = DataArray<PolygonType>;
 
 		tl_oper::inst_tuple_templ<typelists::domain_points, DomainInst> m_AllDomainsInst = PolygonDataType::GetStaticClass();
+		tl_oper::inst_tuple_templ<typelists::num_objects, ZonalInst> m_ZonalInst = PolygonDataType::GetStaticClass();
+		tl_oper::inst_tuple_templ<typelists::domain_int_objects, ClassInst> m_ClassInst = PolygonDataType::GetStaticClass();
 	};
 
 namespace
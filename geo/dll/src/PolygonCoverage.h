@@ -0,0 +1,176 @@
+// Copyright (C) 1998-2026 Object Vision b.v.
+// License: GNU GPL 3
+/////////////////////////////////////////////////////////////////////////////
+
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+File: PolygonCoverage.h
+Purpose:
+- Anti-aliased rasterization of polygons: the fraction of the area of each cell that a polygon covers,
+  for poly2grid_coverage (see Poly2GridOper.cpp).
+
+Summary:
+- coverage_accumulator: a buffer of nrRows x (nrCols + 2) signed area contributions.
+  AddEdge adds the contribution of a directed edge in cell coordinates (x: column, y: row) to each cell that it crosses
+  and to the next cell of each row, such that the running sum along a row is the signed area of the cells to the right of the edges.
+  After all edges of a ring are added, ForEachCoverage visits the absolute running sums, limited to 1, and clears the buffer;
+  AddCoverageTo adds them to an output grid (poly2grid_coverage) and the zonal operators weight the cell values with them.
+- Edges are clipped to the rows [0, nrRows); parts left or right of the columns [0, nrCols) are projected on the left or right border,
+  which keeps the running sums of the cells within the columns.
+- The accumulation follows the signed area rasterizers of font renderers; the contribution of an edge within a row
+  is exact for the trapezoids it splits each cell into.
+*/
+
+#if !defined(__GEO_POLYGONCOVERAGE_H)
+#define __GEO_POLYGONCOVERAGE_H
+
+#include <algorithm>
+#include <assert.h>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+struct coverage_accumulator
+{
+	void Reset(std::size_t nrCols, std::size_t nrRows)
+	{
+		m_NrCols = nrCols;
+		m_NrRows = nrRows;
+		m_Buffer.assign(nrRows * RowSize(), 0.0);
+	}
+
+	std::size_t NrCols() const { return m_NrCols; }
+	std::size_t NrRows() const { return m_NrRows; }
+
+	// adds the edges between consecutive points of a closed ring, relative to the cell (originX, originY);
+	// the ring doesn't need to repeat its first point
+	template <typename P>
+	void AddRing(const P* first, const P* last, double originX = 0, double originY = 0)
+	{
+		if (first == last)
+			return;
+		for (const P* prev = last - 1; first != last; prev = first++)
+			AddEdge(prev->X() - originX, prev->Y() - originY, first->X() - originX, first->Y() - originY);
+	}
+
+	void AddEdge(double x0, double y0, double x1, double y1)
+	{
+		double w = double(m_NrCols);
+		// split at the borders that the edge strictly crosses, such that each part can be clamped to the columns
+		if ((x0 < 0 && x1 > 0) || (x0 > 0 && x1 < 0))
+		{
+			double ym = y0 + (0 - x0) * (y1 - y0) / (x1 - x0);
+			AddEdge(x0, y0, 0, ym);
+			AddEdge(0, ym, x1, y1);
+			return;
+		}
+		if ((x0 < w && x1 > w) || (x0 > w && x1 < w))
+		{
+			double ym = y0 + (w - x0) * (y1 - y0) / (x1 - x0);
+			AddEdge(x0, y0, w, ym);
+			AddEdge(w, ym, x1, y1);
+			return;
+		}
+		AddClampedEdge(std::clamp(x0, 0.0, w), y0, std::clamp(x1, 0.0, w), y1);
+	}
+
+	// calls func(row, col, coverage) with coverage = min(1, |running sum|) for each cell with a positive coverage, row by row, and clears the buffer
+	template <typename Func>
+	void ForEachCoverage(Func&& func)
+	{
+		for (std::size_t r = 0; r != m_NrRows; ++r)
+		{
+			double* row = m_Buffer.data() + r * RowSize();
+			double sum = 0;
+			for (std::size_t c = 0; c != m_NrCols; ++c)
+			{
+				sum += row[c];
+				double coverage = std::min(std::abs(sum), 1.0);
+				if (coverage > 0)
+					func(r, c, coverage);
+			}
+			std::fill(row, row + RowSize(), 0.0);
+		}
+	}
+
+	// adds the coverage of each cell to output[row * outputRowStride + col] and clears the buffer
+	template <typename A>
+	void AddCoverageTo(A* output, std::size_t outputRowStride)
+	{
+		ForEachCoverage([output, outputRowStride](std::size_t r, std::size_t c, double coverage) { output[r * outputRowStride + c] += A(coverage); });
+	}
+
+private:
+	std::size_t RowSize() const { return m_NrCols + 2; }
+
+	// x0 and x1 are within [0, nrCols]
+	void AddClampedEdge(double x0, double y0, double x1, double y1)
+	{
+		if (y0 == y1)
+			return;
+		double dir = 1;
+		if (y0 > y1)
+		{
+			std::swap(x0, x1);
+			std::swap(y0, y1);
+			dir = -1;
+		}
+		if (y1 <= 0 || y0 >= double(m_NrRows))
+			return;
+
+		double w = double(m_NrCols);
+		double dxdy = (x1 - x0) / (y1 - y0);
+		double x = x0;
+		if (y0 < 0)
+			x -= y0 * dxdy;
+		std::size_t rowFirst = (y0 < 0) ? 0 : std::size_t(y0);
+		std::size_t rowLast  = std::min(m_NrRows, std::size_t(std::ceil(y1)));
+		for (std::size_t y = rowFirst; y < rowLast; ++y)
+		{
+			double dy = std::min(double(y + 1), y1) - std::max(double(y), y0);
+			double xNext = x + dxdy * dy;
+			double d = dy * dir;
+			double xa = std::clamp(std::min(x, xNext), 0.0, w);
+			double xb = std::clamp(std::max(x, xNext), 0.0, w);
+			double xaFloor = std::floor(xa), xbCeil = std::ceil(xb);
+			std::size_t xai = std::size_t(xaFloor), xbi = std::size_t(xbCeil);
+			double* row = m_Buffer.data() + y * RowSize();
+			if (xbi <= xai + 1) // within one cell: the trapezoid right of the edge
+			{
+				double xmf = 0.5 * (xa + xb) - xaFloor;
+				row[xai]     += d - d * xmf;
+				row[xai + 1] += d * xmf;
+			}
+			else // a triangle in the first cell, a fixed share per crossed cell and the complement of a triangle in the last cell
+			{
+				double s = 1 / (xb - xa);
+				double xaf = xa - xaFloor;
+				double a0 = 0.5 * s * (1 - xaf) * (1 - xaf);
+				double xbf = xb - xbCeil + 1;
+				double am = 0.5 * s * xbf * xbf;
+				row[xai] += d * a0;
+				if (xbi == xai + 2)
+					row[xai + 1] += d * (1 - a0 - am);
+				else
+				{
+					double a1 = s * (1.5 - xaf);
+					row[xai + 1] += d * (a1 - a0);
+					for (std::size_t xi = xai + 2; xi < xbi - 1; ++xi)
+						row[xi] += d * s;
+					double a2 = a1 + double(xbi - xai - 3) * s;
+					row[xbi - 1] += d * (1 - a2 - am);
+				}
+				row[xbi] += d * am;
+			}
+			x = xNext;
+		}
+	}
+
+	std::size_t m_NrCols = 0, m_NrRows = 0;
+	std::vector<double> m_Buffer;
+};
+
+#endif //!defined(__GEO_POLYGONCOVERAGE_H)
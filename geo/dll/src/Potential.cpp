@@ -3,7 +3,7 @@
 /////////////////////////////////////////////////////////////////////////////
 // Potential.cpp
 // Implements various convolution and potential analysis functions for grid data.
-// Supports multiple backends: classic, Intel IPP (ippi, ipps), and custom implementations.
+// Supports multiple backends: classic, Intel IPP (ippi, ipps), FFT, and custom implementations.
 // Handles memory alignment, buffer management, and kernel preparation for efficient computation.
 // Main entry points: Potential(), AddConvolutionKernel(), and MDL_Potential32/64.
 // See Potential.h for API and type definitions.
@@ -443,15 +443,11 @@ TileSize PotentialIppsRaw(potential_context<A>& context, UPoint& zeroInfo, const
 // Helper for squaring Float64 values.
 inline Float64 Sqr64(Float64 v) { return v*v; }
 
-// Performs convolution and then smooths small values to zero.
-template <typename A, typename T>
-TileSize PotentialIppsSmooth(potential_context<A>& context, UPoint& zeroInfo, const kernel_info& kernelInfo, const UGrid<const T>& dataOrg)
+// Sets values that are negligible relative to the norm of the output to zero, as transforms leave round-off noise where the exact result is zero.
+template <typename A>
+void SmoothNearZero(A* firstOutput, A* lastOutput)
 {
-	auto outputSize = PotentialIppsRaw<A, T>(context, zeroInfo, kernelInfo, dataOrg);
-
 	Float64 sumSqrData = 0; 
-	auto firstOutput = context.overlappingOutput.begin();
-	auto lastOutput = context.overlappingOutput.begin() + outputSize;
 	for (auto ptr = firstOutput, end = lastOutput; ptr !=end ; ++ptr)
 		sumSqrData += Sqr64(*ptr);
 
@@ -460,10 +456,85 @@ TileSize PotentialIppsSmooth(potential_context<A>& context, UPoint& zeroInfo, co
 	for (auto ptr = firstOutput, end = lastOutput; ptr != end; ++ptr)
 		if (*ptr < errThreshold && errThresholdNeg < *ptr)
 			*ptr = 0.0;
+}
+
+// Performs convolution and then smooths small values to zero.
+template <typename A, typename T>
+TileSize PotentialIppsSmooth(potential_context<A>& context, UPoint& zeroInfo, const kernel_info& kernelInfo, const UGrid<const T>& dataOrg)
+{
+	auto outputSize = PotentialIppsRaw<A, T>(context, zeroInfo, kernelInfo, dataOrg);
+
+	SmoothNearZero(context.overlappingOutput.begin(), context.overlappingOutput.begin() + outputSize);
 
 	return outputSize;
 }
 
+// *****************************************************************************
+//	PotentialFft
+// *****************************************************************************
+
+// Portable FFT convolution: the full convolution of a data tile by the kernel spectrum for its number of columns;
+// the tiles of the potential operator then add up their overlapping outputs (overlap-add).
+template <typename T>
+bool PotentialFft(potential_context<T>& context, const kernel_info& kernelInfo, const UGrid<const T>& dataOrg)
+{
+	DBG_START("Potential", "Fft", MG_DEBUG_POTENTIAL);
+
+	if (!context.WasInitialized())
+		context.overlappingOutput.reserve(Cardinality(kernelInfo.maxColvolvedSize));
+
+	UPoint dataSize = dataOrg.GetSize();
+	UPoint outputSize = dataSize + kernelInfo.orgWeightSize - UPoint(1, 1);
+	dms_assert(Cardinality(outputSize) <= context.overlappingOutput.capacity());
+
+	kernelInfo.fftKernels.at(dataSize.Col()).Convolve(dataOrg.begin(), dataSize.Row(), dataSize.Col(), context.overlappingOutput.begin(), context.fftBuffer);
+
+	SmoothNearZero(context.overlappingOutput.begin(), context.overlappingOutput.begin() + Cardinality(outputSize));
+	return true;
+}
+
+// *****************************************************************************
+//	PotentialSeparable and PotentialBox
+// *****************************************************************************
+
+// Two 1D passes with the row and column factors of a kernel of rank 1.
+template <typename T>
+bool PotentialSeparable(potential_context<T>& context, const kernel_info& kernelInfo, const UGrid<const T>& dataOrg)
+{
+	DBG_START("Potential", "Separable", MG_DEBUG_POTENTIAL);
+
+	if (!context.WasInitialized())
+		context.overlappingOutput.reserve(Cardinality(kernelInfo.maxColvolvedSize));
+
+	UPoint dataSize = dataOrg.GetSize();
+	dms_assert(Cardinality(dataSize + kernelInfo.orgWeightSize - UPoint(1, 1)) <= context.overlappingOutput.capacity());
+
+	ConvolveSeparable(kernelInfo.shape, dataOrg.begin(), dataSize.Row(), dataSize.Col(), context.overlappingOutput.begin(), context.sumBuffer);
+	return true;
+}
+
+// Box sums from the summed-area table of the data tile for a kernel with equal weights; the cost per cell doesn't depend on the kernel size.
+template <typename T>
+bool PotentialBox(potential_context<T>& context, const kernel_info& kernelInfo, const UGrid<const T>& dataOrg)
+{
+	DBG_START("Potential", "Box", MG_DEBUG_POTENTIAL);
+
+	if (!context.WasInitialized())
+		context.overlappingOutput.reserve(Cardinality(kernelInfo.maxColvolvedSize));
+
+	UPoint dataSize = dataOrg.GetSize();
+	UPoint outputSize = dataSize + kernelInfo.orgWeightSize - UPoint(1, 1);
+	dms_assert(Cardinality(outputSize) <= context.overlappingOutput.capacity());
+
+	ConvolveBox(kernelInfo.shape, kernelInfo.orgWeightSize.Row(), kernelInfo.orgWeightSize.Col(),
+		dataOrg.begin(), dataSize.Row(), dataSize.Col(), context.overlappingOutput.begin(), context.sumBuffer
+	);
+
+	// differences of the summed-area table leave round-off where the box sum is zero
+	SmoothNearZero(context.overlappingOutput.begin(), context.overlappingOutput.begin() + Cardinality(outputSize));
+	return true;
+}
+
 // *****************************************************************************
 //	CalculateClassic
 // *****************************************************************************
@@ -576,6 +647,31 @@ bool Potential(AnalysisType at, potential_contexts& context, const kernel_info&
 }
 #endif //defined(DMS_POTENTIAL_I16)
 
+// Resolves PotentialAuto: box sums and separable passes are cheapest if the kernel allows; else FFT convolution pays off for large kernels only.
+AnalysisType SelectAnalysisType(AnalysisType at, const kernel_info& kernelInfo)
+{
+	switch (at) {
+		case AnalysisType::PotentialBox:
+			if (!kernelInfo.shape.IsBox())
+				throwErrorD("potentialBox", "the weights of the kernel must all be equal");
+			return at;
+		case AnalysisType::PotentialSeparable:
+			if (!kernelInfo.shape.IsSeparable())
+				throwErrorD("potentialSeparable", "the kernel must be separable: the product of a column of row factors and a row of column factors");
+			return at;
+		case AnalysisType::PotentialAuto:
+			if (kernelInfo.shape.IsBox())
+				return AnalysisType::PotentialBox;
+			if (kernelInfo.shape.IsSeparable())
+				return AnalysisType::PotentialSeparable;
+			return Cardinality(kernelInfo.orgWeightSize) >= FFT_MIN_KERNEL_CARDINALITY
+				?	AnalysisType::PotentialFft
+				:	AnalysisType::PotentialSlow;
+		default:
+			return at;
+	}
+}
+
 // Adds a convolution kernel to the kernel_info for a given data type and analysis type.
 template < typename T>
 MDL_CALL void AddConvolutionKernel(kernel_info& self, AnalysisType at, SideSize nrDataCols)
@@ -588,7 +684,12 @@ MDL_CALL void AddConvolutionKernel(kernel_info& self, AnalysisType at, SideSize
 	//	dms_assert(dataOrg.GetSize() == outputOrg.GetSize());
 	const UGrid<const T>& weightOrg = *std::any_cast<UGrid<const T>>(&self.orgWeightGrid);
 	SizeT weightBufferSize = weightOrg.size() + Cardinality(UPoint(nrDataCols - 1, weightOrg.GetSize().Row() - 1));
-	if (at == AnalysisType::PotentialIpps64 || at == AnalysisType::PotentialRawIpps64)
+	if (at == AnalysisType::PotentialFft)
+	{
+		if (!self.fftKernels.contains(nrDataCols))
+			self.fftKernels.try_emplace(nrDataCols, weightOrg.begin(), weightOrg.GetSize().Row(), weightOrg.GetSize().Col(), self.maxDataSize.Row(), nrDataCols);
+	}
+	else if (at == AnalysisType::PotentialIpps64 || at == AnalysisType::PotentialRawIpps64)
 		potential::impl::IppsArray_InitReversed(self.weightBuffer<Float64>(nrDataCols), weightOrg, nrDataCols);
 	else if (at == AnalysisType::PotentialIppsPacked || at == AnalysisType::PotentialRawIppsPacked)
 		potential::impl::IppsArray_InitReversed(self.weightBuffer<T>(nrDataCols), weightOrg, nrDataCols);
@@ -609,6 +710,15 @@ bool Potential(AnalysisType at, potential_contexts& context, const kernel_info&
 				kernelInfo, context.F32.overlappingOutput
 			);
 
+		case AnalysisType::PotentialFft:
+			return potential::impl::PotentialFft<Float32>(context.F32, kernelInfo, dataOrg);
+
+		case AnalysisType::PotentialSeparable:
+			return potential::impl::PotentialSeparable<Float32>(context.F32, kernelInfo, dataOrg);
+
+		case AnalysisType::PotentialBox:
+			return potential::impl::PotentialBox<Float32>(context.F32, kernelInfo, dataOrg);
+
 #if defined(DMS_USE_INTEL_IPPI)
 		case AnalysisType::PotentialIppi:
 			return potential::impl::PotentialIppi32f(data, output, weight);
@@ -651,6 +761,15 @@ bool Potential(AnalysisType at, potential_contexts& context, const kernel_info&
 				kernelInfo, context.F64.overlappingOutput
 			);
 
+		case AnalysisType::PotentialFft:
+			return potential::impl::PotentialFft<Float64>(context.F64, kernelInfo, dataOrg);
+
+		case AnalysisType::PotentialSeparable:
+			return potential::impl::PotentialSeparable<Float64>(context.F64, kernelInfo, dataOrg);
+
+		case AnalysisType::PotentialBox:
+			return potential::impl::PotentialBox<Float64>(context.F64, kernelInfo, dataOrg);
+
 #if defined(DMS_USE_INTEL_IPPS)
 		case AnalysisType::PotentialRawIpps64:
 			return potential::impl::PotentialIppsRaw   <Float64>(context.F64, context.zeroInfo, kernelInfo, dataOrg);
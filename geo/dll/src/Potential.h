@@ -21,6 +21,8 @@
 
 #include "GeoBase.h"
 #include "mem/Grid.h"
+#include "FftConvolution.h"
+#include "SeparableConvolution.h"
 #include "IppBase.h"
 
 //#define DMS_POTENTIAL_I16
@@ -40,6 +42,10 @@ using TileSize = SizeT;   // Represents buffer element counts (potentially large
 //  - Proximity -> distance/proximity specific computation (non-convolution path)
 //  - PotentialSlow -> reference / fallback (no IPP)
 //  - PotentialIppi -> (conditional) IPP Image Processing route
+//  - PotentialFft -> portable FFT convolution (see FftConvolution.h)
+//  - PotentialSeparable -> a pass along the rows and one along the columns for kernels of rank 1 (see SeparableConvolution.h)
+//  - PotentialBox -> summed-area table for kernels with equal weights (see SeparableConvolution.h)
+//  - PotentialAuto -> PotentialBox or PotentialSeparable if the kernel allows, else PotentialFft for large kernels or PotentialSlow; resolved by SelectAnalysisType
 // PotentialDefault resolves to fastest available depending on build defines.
 enum class AnalysisType {
 	PotentialIpps64 = 0, 
@@ -51,14 +57,33 @@ enum class AnalysisType {
 	PotentialIppi = 5,
 #endif //defined(DMS_USE_INTEL_IPPI)
 	PotentialSlow = 6,
+	PotentialFft = 7,
+	PotentialAuto = 8,
+	PotentialSeparable = 9,
+	PotentialBox = 10,
 
 #if defined(DMS_USE_INTEL_IPPS)
 	PotentialDefault = PotentialIpps64
 #else
-	AT_PotentialDefault = PotentialSlow
+	PotentialDefault = PotentialAuto
 #endif
 };
 
+// Kernels with at least this number of cells are convolved by FFT when PotentialAuto is requested;
+// direct convolution costs a multiply-add per kernel cell per output cell, the transforms a few hundred operations per output cell.
+const SizeT FFT_MIN_KERNEL_CARDINALITY = 1024;
+
+struct kernel_info;
+
+// Resolves PotentialAuto by the shape and size of the kernel; throws if PotentialSeparable or PotentialBox are requested for a kernel that isn't.
+AnalysisType SelectAnalysisType(AnalysisType at, const kernel_info& kernelInfo);
+
+// Shape detection is only needed for the analysis types that depend on it.
+inline bool RequiresKernelShape(AnalysisType at)
+{
+	return at == AnalysisType::PotentialAuto || at == AnalysisType::PotentialSeparable || at == AnalysisType::PotentialBox;
+}
+
 // *****************************************************************************
 //	INTERFACE FUNCTIONS: Potential
 // *****************************************************************************
@@ -158,6 +183,9 @@ bool Potential(AnalysisType at,
 //        = maxDataSize + orgWeightSize - (1,1)
 //  - weightBuffers32 / weightBuffers64: Pre-expanded weight buffers keyed by padding
 //        (paddingSize == number of data columns); formula documented inline below.
+//  - fftKernels: kernel spectra for PotentialFft keyed by the number of data columns; rows are padded for maxDataSize,
+//        and tiles and kernels that would need more than FFT_MAX_SIZE rows or columns are split into blocks.
+//  - shape: box weight or row and column factors of the kernel, for PotentialBox and PotentialSeparable.
 //  - orgWeightGrid: Stored original weight grid for slow / proximity algorithms.
 //  - weightShadowTile: Reference to weight tile metadata (tiling system).
 // Buffer sizing formulas (comments from code):
@@ -174,6 +202,8 @@ struct kernel_info
 	// Weight buffers reused across tiles (avoid recomputation).
 	std::map<SideSize, IppsArray<Float32>> weightBuffers32; // Float32 kernel expansions.
 	std::map<SideSize, IppsArray<Float64>> weightBuffers64; // Float64 kernel expansions.
+	std::map<SideSize, fft_kernel<Float64>> fftKernels;     // Kernel spectra for PotentialFft.
+	kernel_shape shape;                                     // Detected for the analysis types that RequiresKernelShape.
 
 	std::any orgWeightGrid;            // Holds UGrid<const T> (erased); used by slow/proximity paths.
 	TileCRef weightShadowTile;         // Original tile reference for weight grid.
@@ -200,6 +230,7 @@ struct kernel_info
 //  - Records maximum data size (for later buffer allocations)
 //  - Pre-computes max overlapped convolution size (used by algorithms)
 //  - Stores original weight grid into std::any for algorithms that need original layout
+//  - Detects the kernel shape if the analysis type (still) depends on it
 //  - Does NOT allocate expanded weight buffers (lazy: via AddConvolutionKernel).
 template < typename T>
 MDL_CALL kernel_info PrepareConvolutionKernel(AnalysisType at, TileCRef weightShadowTile, const UGrid<const T>& weightOrg, UPoint maxDataTileSize)
@@ -219,6 +250,8 @@ MDL_CALL kernel_info PrepareConvolutionKernel(AnalysisType at, TileCRef weightSh
 	}
 	result.weightShadowTile = weightShadowTile;
 	result.orgWeightGrid = weightOrg;
+	if (RequiresKernelShape(at))
+		result.shape = DetectKernelShape(weightOrg.begin(), weightOrg.GetSize().Row(), weightOrg.GetSize().Col());
 	return result;
 }
 
@@ -235,6 +268,8 @@ MDL_CALL void AddConvolutionKernel(kernel_info& self, AnalysisType at, SideSize
 //  - overlappingOutput: Temporary buffer holding the full overlapped convolution result
 //                       (before trimming to actual output region).
 //  - ippsBuffer: Workspace required by specific IPP convolution kernels (library provided size).
+//  - fftBuffer: Padded grid that PotentialFft transforms.
+//  - sumBuffer: Row pass of PotentialSeparable or summed-area table of PotentialBox.
 //  - WasInitialized(): indicates that required buffers have been allocated.
 template <typename A>
 struct potential_context
@@ -245,6 +280,8 @@ struct potential_context
 	IppsArray<A> paddedInput;       // size: (nx+kx-1)*(ny-1)+nx = nx*ny + (kx-1)*(ny-1); not used for PotentialSlow and Proximity
 	IppsArray<A> overlappingOutput; // size: (nx+kx-1)*(ny+ky-1)
 	IppsArray<UInt8> ippsBuffer;    // Auxiliary algorithm-specific scratch space.
+	std::vector<std::complex<Float64>> fftBuffer; // size: (1 or 2) x NrRows() x NrCols() of the fft_kernel, at most 2 x FFT_MAX_SIZE^2
+	std::vector<Float64> sumBuffer;               // size: (ny+1)*(nx+kx-1) for PotentialSeparable, (ny+1)*(nx+1) for PotentialBox
 
 	bool WasInitialized() const { return overlappingOutput.WasInitialized(); }
 };
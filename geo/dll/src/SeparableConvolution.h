@@ -0,0 +1,187 @@
+// Copyright (C) 1998-2026 Object Vision b.v.
+// License: GNU GPL 3
+/////////////////////////////////////////////////////////////////////////////
+
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+File: SeparableConvolution.h
+Purpose:
+- Full 2D convolution of data tiles by kernels of a special shape, for the PotentialSeparable and PotentialBox backends
+  of potential (see Potential.cpp), whose costs per output cell don't depend on the kernel area.
+
+Summary:
+- kernel_shape: the result of DetectKernelShape, which tests whether a kernel is a box (all cells have the same weight)
+  and whether it is separable (of rank 1: kernel[i][j] == rowFactors[i] * colFactors[j]), as are the products of
+  distance decay functions of the row and column offset, such as Gaussian weights on a square. Gaussian weights within a radius
+  or on a disc are not separable, as the cut off isn't.
+- ConvolveSeparable: a pass along the rows with the column factors and a pass along the columns with the row factors;
+  costs nrKernelRows + nrKernelCols multiply-adds per output cell.
+- ConvolveBox: the box sum of each output cell from a summed-area table of the data tile; costs 4 look-ups per output cell,
+  regardless of the kernel size.
+- Both write the (nrDataRows + kRows - 1) x (nrDataCols + kCols - 1) full convolution of a data tile,
+  laid out as CalculateClassic does for PotentialSlow: output[r][c] = sum_ij data[r + i - kRows + 1][c + j - kCols + 1] * kernel[i][j],
+  and accumulate in double precision.
+*/
+
+#if !defined(__GEO_SEPARABLECONVOLUTION_H)
+#define __GEO_SEPARABLECONVOLUTION_H
+
+#include <algorithm>
+#include <assert.h>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+// *****************************************************************************
+// kernel_shape
+// *****************************************************************************
+
+struct kernel_shape
+{
+	std::vector<double> rowFactors, colFactors; // kernel[i][j] == rowFactors[i] * colFactors[j] if separable; empty otherwise
+	bool   isBox     = false;                    // all kernel cells have weight boxWeight
+	double boxWeight = 0;
+
+	bool IsSeparable() const { return !rowFactors.empty(); }
+	bool IsBox() const { return isBox; }
+};
+
+// Kernels are considered separable if the largest deviation of the factorisation doesn't exceed
+// a few units of the precision of T relative to the largest kernel weight.
+template <typename T>
+kernel_shape DetectKernelShape(const T* kernel, std::size_t nrKernelRows, std::size_t nrKernelCols)
+{
+	kernel_shape result;
+	std::size_t n = nrKernelRows * nrKernelCols;
+	if (!n) // trivially a box, but never convolved
+	{
+		result.isBox = true;
+		return result;
+	}
+
+	result.isBox = std::all_of(kernel, kernel + n, [w = kernel[0]](T v) { return v == w; });
+	if (result.isBox)
+		result.boxWeight = kernel[0];
+
+	// factorise by the row and the column of the largest absolute weight
+	std::size_t pivot = 0;
+	for (std::size_t i = 1; i != n; ++i)
+		if (std::abs(double(kernel[i])) > std::abs(double(kernel[pivot])))
+			pivot = i;
+	double pivotWeight = kernel[pivot];
+	if (!pivotWeight) // all zero, which is a box
+		return result;
+
+	std::size_t pivotRow = pivot / nrKernelCols, pivotCol = pivot % nrKernelCols;
+	std::vector<double> rowFactors(nrKernelRows), colFactors(nrKernelCols);
+	for (std::size_t i = 0; i != nrKernelRows; ++i)
+		rowFactors[i] = double(kernel[i * nrKernelCols + pivotCol]) / pivotWeight;
+	for (std::size_t j = 0; j != nrKernelCols; ++j)
+		colFactors[j] = kernel[pivotRow * nrKernelCols + j];
+
+	double tolerance = std::abs(pivotWeight) * 4 * std::numeric_limits<T>::epsilon();
+	for (std::size_t i = 0; i != nrKernelRows; ++i)
+		for (std::size_t j = 0; j != nrKernelCols; ++j)
+			if (std::abs(double(kernel[i * nrKernelCols + j]) - rowFactors[i] * colFactors[j]) > tolerance)
+				return result;
+
+	result.rowFactors = std::move(rowFactors);
+	result.colFactors = std::move(colFactors);
+	return result;
+}
+
+// *****************************************************************************
+// ConvolveSeparable
+// *****************************************************************************
+
+// workspace receives the result of the pass along the rows: nrDataRows x nrOutputCols values, followed by an output row.
+template <typename T, typename A>
+void ConvolveSeparable(const kernel_shape& shape, const T* data, std::size_t nrDataRows, std::size_t nrDataCols, A* output, std::vector<double>& workspace)
+{
+	assert(shape.IsSeparable());
+	std::size_t nrKernelRows = shape.rowFactors.size(), nrKernelCols = shape.colFactors.size();
+	std::size_t nrOutputRows = nrDataRows + nrKernelRows - 1, nrOutputCols = nrDataCols + nrKernelCols - 1;
+
+	workspace.assign((nrDataRows + 1) * nrOutputCols, 0.0);
+	double* rowPass   = workspace.data();
+	double* outputRow = rowPass + nrDataRows * nrOutputCols;
+
+	// rowPass[r][c] = sum_j data[r][c + j - kCols + 1] * colFactors[j]; zero data cells are skipped
+	for (std::size_t r = 0; r != nrDataRows; ++r)
+	{
+		const T* dataRow = data + r * nrDataCols;
+		double* rowPassRow = rowPass + r * nrOutputCols + nrKernelCols - 1;
+		for (std::size_t c = 0; c != nrDataCols; ++c)
+		{
+			double v = dataRow[c];
+			if (!v)
+				continue;
+			double* dst = rowPassRow + c;
+			for (std::size_t j = 0; j != nrKernelCols; ++j)
+				dst[-std::ptrdiff_t(j)] += v * shape.colFactors[j];
+		}
+	}
+
+	// output[r][c] = sum_i rowPass[r + i - kRows + 1][c] * rowFactors[i]
+	for (std::size_t r = 0; r != nrOutputRows; ++r)
+	{
+		std::fill(outputRow, outputRow + nrOutputCols, 0.0);
+		std::size_t firstDataRow = (r + 1 > nrKernelRows) ? r + 1 - nrKernelRows : 0;
+		std::size_t lastDataRow  = std::min(r + 1, nrDataRows);
+		for (std::size_t dr = firstDataRow; dr != lastDataRow; ++dr)
+		{
+			double factor = shape.rowFactors[dr + nrKernelRows - 1 - r];
+			const double* src = rowPass + dr * nrOutputCols;
+			for (std::size_t c = 0; c != nrOutputCols; ++c)
+				outputRow[c] += src[c] * factor;
+		}
+		output = std::transform(outputRow, outputRow + nrOutputCols, output, [](double v) { return A(v); });
+	}
+}
+
+// *****************************************************************************
+// ConvolveBox
+// *****************************************************************************
+
+// workspace receives the summed-area table of the data: sat[r][c] is the sum of data[0..r)[0..c), for r <= nrDataRows and c <= nrDataCols.
+template <typename T, typename A>
+void ConvolveBox(const kernel_shape& shape, std::size_t nrKernelRows, std::size_t nrKernelCols, const T* data, std::size_t nrDataRows, std::size_t nrDataCols, A* output, std::vector<double>& workspace)
+{
+	assert(shape.IsBox());
+	std::size_t nrOutputRows = nrDataRows + nrKernelRows - 1, nrOutputCols = nrDataCols + nrKernelCols - 1;
+	std::size_t satCols = nrDataCols + 1;
+
+	workspace.assign((nrDataRows + 1) * satCols, 0.0);
+	double* sat = workspace.data();
+	for (std::size_t r = 0; r != nrDataRows; ++r)
+	{
+		const T* dataRow = data + r * nrDataCols;
+		const double* prevSatRow = sat + r * satCols;
+		double* satRow = sat + (r + 1) * satCols;
+		double rowSum = 0;
+		for (std::size_t c = 0; c != nrDataCols; ++c)
+		{
+			rowSum += dataRow[c];
+			satRow[c + 1] = prevSatRow[c + 1] + rowSum;
+		}
+	}
+
+	// output[r][c] is the box sum of data rows [r - kRows + 1, r] and data columns [c - kCols + 1, c], clipped to the tile
+	for (std::size_t r = 0; r != nrOutputRows; ++r)
+	{
+		const double* satRow0 = sat + ((r + 1 > nrKernelRows) ? r + 1 - nrKernelRows : 0) * satCols;
+		const double* satRow1 = sat + std::min(r + 1, nrDataRows) * satCols;
+		for (std::size_t c = 0; c != nrOutputCols; ++c)
+		{
+			std::size_t c0 = (c + 1 > nrKernelCols) ? c + 1 - nrKernelCols : 0;
+			std::size_t c1 = std::min(c + 1, nrDataCols);
+			*output++ = A(shape.boxWeight * ((satRow1[c1] - satRow1[c0]) - (satRow0[c1] - satRow0[c0])));
+		}
+	}
+}
+
+#endif //!defined(__GEO_SEPARABLECONVOLUTION_H)
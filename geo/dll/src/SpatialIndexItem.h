@@ -0,0 +1,127 @@
+// Copyright (C) 1998-2026 Object Vision b.v.
+// License: GNU GPL 3
+/////////////////////////////////////////////////////////////////////////////
+
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+File: SpatialIndexItem.h
+Purpose:
+- The items that keep a PackedRTree (see rtc geo/PackedRTree.h) as the result of spatial_index(features) (see Connect.cpp),
+  and the view on them that connect_info, dist_info and point_in_polygon query, such that the tree is built once.
+
+Summary:
+- The result of spatial_index is the unit of the leaves of the tree in packing order, with the attributes
+  feature_rel: the indexed feature of each leaf, of the zero-based uint32 domain of the features, and,
+  for arcs and polygons only, lower and upper: the extents of each leaf, of the values unit of the features;
+  and the sub-unit node of the nodes of all levels, bottom-up, with the attributes lower and upper of their boxes.
+- CheckSpatialIndexItem unifies these attributes with the features that the tree is queried for.
+- SpatialIndexItemView locks them and provides a PackedRTree view that refers to their data, which is O(log n) to construct.
+*/
+
+#if !defined(__GEO_SPATIALINDEXITEM_H)
+#define __GEO_SPATIALINDEXITEM_H
+
+#include "geo/PackedRTree.h"
+
+#include "DataArray.h"
+#include "DataLocks.h"
+#include "Unit.h"
+#include "UnitClass.h"
+
+inline TokenID SpatialIndexFeatureRelID() { return GetTokenID_mt("feature_rel"); }
+inline TokenID SpatialIndexLowerID     () { return GetTokenID_mt("lower"); }
+inline TokenID SpatialIndexUpperID     () { return GetTokenID_mt("upper"); }
+inline TokenID SpatialIndexNodeID      () { return GetTokenID_mt("node"); }
+
+inline const AbstrUnit* GetSpatialIndexNodeUnit(const AbstrUnit* indexUnit)
+{
+	auto nodeItem = indexUnit->GetConstSubTreeItemByID(SpatialIndexNodeID());
+	if (!nodeItem || !IsUnit(nodeItem.get()))
+		indexUnit->throwItemError("spatial_index expected, but the sub-unit node is missing");
+	return AsUnit(nodeItem.get());
+}
+
+inline const AbstrDataItem* GetSpatialIndexAttr(const AbstrUnit* unit, TokenID nameID)
+{
+	auto attr = unit->GetConstSubTreeItemByID(nameID);
+	if (!attr || !IsDataItem(attr.get()))
+		unit->throwItemErrorF("spatial_index expected, but the attribute %s is missing", nameID.GetStr().c_str());
+	return AsDataItem(attr.get());
+}
+
+// unifies the attributes of the result of spatial_index with the domain and values unit of the features that it is to index
+inline void CheckSpatialIndexItem(const AbstrUnit* indexUnit, const AbstrUnit* featureEntity, const AbstrUnit* featureValuesUnit, bool hasLeafBoxes)
+{
+	const AbstrDataItem* featureRelA = GetSpatialIndexAttr(indexUnit, SpatialIndexFeatureRelID());
+	indexUnit->UnifyDomain(featureRelA->GetAbstrDomainUnit(), "spatial_index", "Domain of spatial_index/feature_rel", UM_Throw);
+	featureEntity->UnifyDomain(featureRelA->GetAbstrValuesUnit(), "Domain of the features", "Values of spatial_index/feature_rel", UM_Throw);
+
+	auto checkBoxes = [featureValuesUnit](const AbstrUnit* unit)
+		{
+			for (TokenID nameID : { SpatialIndexLowerID(), SpatialIndexUpperID() })
+			{
+				const AbstrDataItem* boxA = GetSpatialIndexAttr(unit, nameID);
+				unit->UnifyDomain(boxA->GetAbstrDomainUnit(), "spatial_index", "Domain of the box attribute of spatial_index", UM_Throw);
+				featureValuesUnit->UnifyValues(boxA->GetAbstrValuesUnit(), "Values of the features", "Values of the box attribute of spatial_index", UM_Throw);
+			}
+		};
+	if (hasLeafBoxes)
+		checkBoxes(indexUnit);
+	checkBoxes(GetSpatialIndexNodeUnit(indexUnit));
+}
+
+// the locked attributes of the result of spatial_index and the view of the tree on the features [first, first + nrObjects);
+// the features must have been checked with CheckSpatialIndexItem
+template <typename PackedRTreeType>
+struct SpatialIndexItemView
+{
+	using PointType     = typename PackedRTreeType::PointType;
+	using ObjectPtrType = typename PackedRTreeType::ObjectPtrType;
+
+	SpatialIndexItemView(const AbstrUnit* indexUnit, ObjectPtrType first, SizeT nrObjects)
+		: m_FeatureRelLock(GetSpatialIndexAttr(indexUnit, SpatialIndexFeatureRelID()), "spatial_index")
+		, m_LeafLowerLock(GetLeafBoxAttr(indexUnit, SpatialIndexLowerID()), "spatial_index")
+		, m_LeafUpperLock(GetLeafBoxAttr(indexUnit, SpatialIndexUpperID()), "spatial_index")
+		, m_NodeLowerLock(GetSpatialIndexAttr(GetSpatialIndexNodeUnit(indexUnit), SpatialIndexLowerID()), "spatial_index")
+		, m_NodeUpperLock(GetSpatialIndexAttr(GetSpatialIndexNodeUnit(indexUnit), SpatialIndexUpperID()), "spatial_index")
+		, m_FeatureRel(GetData<UInt32>(m_FeatureRelLock))
+		, m_LeafLower (GetData<PointType>(m_LeafLowerLock))
+		, m_LeafUpper (GetData<PointType>(m_LeafUpperLock))
+		, m_NodeLower (GetData<PointType>(m_NodeLowerLock))
+		, m_NodeUpper (GetData<PointType>(m_NodeUpperLock))
+		, m_Tree(first, nrObjects, m_FeatureRel.begin(), m_FeatureRel.size()
+			, PackedRTreeType::c_HasLeafBoxes ? m_LeafLower.begin() : nullptr
+			, PackedRTreeType::c_HasLeafBoxes ? m_LeafUpper.begin() : nullptr
+			, m_NodeLower.begin(), m_NodeUpper.begin(), m_NodeLower.size()
+		)
+	{
+		MG_CHECK(m_NodeUpper.size() == m_NodeLower.size());
+		if constexpr (PackedRTreeType::c_HasLeafBoxes)
+			MG_CHECK(m_LeafLower.size() == m_FeatureRel.size() && m_LeafUpper.size() == m_FeatureRel.size());
+	}
+
+	const PackedRTreeType& GetTree() const { return m_Tree; }
+
+private:
+	static const AbstrDataItem* GetLeafBoxAttr(const AbstrUnit* indexUnit, TokenID nameID)
+	{
+		return PackedRTreeType::c_HasLeafBoxes ? GetSpatialIndexAttr(indexUnit, nameID) : nullptr;
+	}
+	template <typename V>
+	static auto GetData(const DataReadLock& lock) -> typename DataArray<V>::locked_cseq_t
+	{
+		if (!lock)
+			return {};
+		return const_array_cast<V>(lock)->GetDataRead();
+	}
+
+	PreparedDataReadLock m_FeatureRelLock, m_LeafLowerLock, m_LeafUpperLock, m_NodeLowerLock, m_NodeUpperLock;
+	typename DataArray<UInt32   >::locked_cseq_t m_FeatureRel;
+	typename DataArray<PointType>::locked_cseq_t m_LeafLower, m_LeafUpper, m_NodeLower, m_NodeUpper;
+	PackedRTreeType m_Tree;
+};
+
+#endif //!defined(__GEO_SPATIALINDEXITEM_H)
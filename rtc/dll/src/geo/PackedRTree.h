@@ -0,0 +1,390 @@
+// Copyright (C) 1998-2026 Object Vision b.v.
+// License: GNU GPL 3
+/////////////////////////////////////////////////////////////////////////////
+
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+
+#ifndef __RTC_GEO_PACKEDRTREE_H
+#define __RTC_GEO_PACKEDRTREE_H
+
+#include "geo/SpatialIndex.h"
+
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+#include <vector>
+
+// *****************************************************************************
+//									PackedRTree
+// *****************************************************************************
+//
+// A static R-tree, bulk loaded with Sort-Tile-Recursive (STR) packing: the leaves are sorted on the x of their centers,
+// cut into ceil(sqrt(n/B)) vertical slices that are sorted on the y of their centers, after which each B consecutive leaves form a node
+// and each B consecutive nodes of a level form a node of the next level, up to a single root.
+// All nodes but the last of each level are full, thus the tree is stored without pointers as arrays that follow the packing order:
+// the object index of each leaf, the lower and upper corner of the extents of each leaf (not for points, which are their own extents)
+// and of each node of all levels, bottom-up, whereas the start of each level follows from the number of leaves.
+//
+// A tree either owns these arrays, when built in O(n log n) from the objects, or is a view on arrays that are kept elsewhere,
+// such as the subitems of the result of spatial_index (see Connect.cpp), which makes the construction O(log n).
+//
+// The query interface is that of SpatialIndex: begin(point or rect) returns an iterator over the leaves whose extents intersect it,
+// GetSqrProximityUpperBound provides an initial search radius for nearest neighbour searches, such that algorithms such as
+// IndexedArcProjectionHandle can use either. Unlike SpatialIndex, objects cannot be added after construction.
+// Queries are const and can run concurrently.
+//
+
+template <typename T, typename ObjectPtr>
+struct PackedRTree
+{
+	using ObjectPtrType = ObjectPtr;
+	using DistType      = T;
+
+	using PointType     = Point<T>;
+	using RangeType     = Range<PointType>;
+
+	using LeafType      = SpatialIndexImpl::LeafTypeGetter_t<PointType, ObjectPtrType>;
+	using extents_type  = typename LeafType::extents_type;
+
+	static const SizeT  c_NodeCapacity = 16;
+	static const UInt32 c_MaxNrLevels  = 16; // 16^16 leaves
+	static constexpr bool c_HasLeafBoxes = !std::is_same_v<extents_type, PointType>;
+
+	// the object of a leaf and its extents, as dereferenced iterators provide them, such that (*iter)->get_ptr() works as for SpatialIndex
+	struct leaf_ref
+	{
+		ObjectPtr    m_ObjectPtr;
+		extents_type m_Extents;
+
+		ObjectPtr get_ptr() const { return m_ObjectPtr; }
+		const extents_type& GetExtents() const { return m_Extents; }
+		const leaf_ref* operator ->() const { return this; }
+	};
+
+	template <typename SelType>
+	struct iterator
+	{
+		iterator() {}
+		explicit operator bool () const { return m_Tree; }
+
+		void operator ++()
+		{
+			assert(m_Tree && m_InLeafs);
+			++m_LeafPos;
+			FindNext();
+		}
+		leaf_ref operator *() const
+		{
+			assert(m_Tree && m_InLeafs);
+			return m_Tree->GetLeaf(m_LeafPos);
+		}
+
+		iterator(SelType searchObj, const PackedRTree* tree)
+			: m_SearchObj(std::move(searchObj))
+		{
+			if (!tree->NrLevels())
+				return;
+			m_Tree  = tree;
+			m_Level = tree->NrLevels() - 1;
+			m_Pos[m_Level] = 0;
+			m_End[m_Level] = 1;
+			FindNext();
+		}
+		void RefineSearch(SelType newSearchObj)
+		{
+			assert(IsIncluding(m_SearchObj, newSearchObj));
+			m_SearchObj = newSearchObj;
+		}
+
+	private:
+		// depth first to the next leaf that intersects m_SearchObj, skipping nodes that don't touch it
+		void FindNext()
+		{
+			while (true)
+			{
+				if (m_InLeafs)
+				{
+					for (; m_LeafPos != m_LeafEnd; ++m_LeafPos)
+						if (IsIntersecting(m_SearchObj, m_Tree->GetLeafExtents(m_LeafPos)))
+							return;
+					m_InLeafs = false;
+					assert(m_Level == 0);
+					++m_Pos[0];
+				}
+				if (m_Pos[m_Level] == m_End[m_Level])
+				{
+					if (++m_Level == m_Tree->NrLevels())
+					{
+						m_Tree = nullptr;
+						return;
+					}
+					++m_Pos[m_Level];
+					continue;
+				}
+				SizeT node = m_Pos[m_Level];
+				if (!IsTouching(m_Tree->GetNodeBox(m_Level, node), m_SearchObj))
+				{
+					++m_Pos[m_Level];
+					continue;
+				}
+				SizeT childBegin = node * c_NodeCapacity;
+				if (m_Level)
+				{
+					--m_Level;
+					m_Pos[m_Level] = childBegin;
+					m_End[m_Level] = Min<SizeT>(childBegin + c_NodeCapacity, m_Tree->GetLevelSize(m_Level));
+				}
+				else
+				{
+					m_InLeafs = true;
+					m_LeafPos = childBegin;
+					m_LeafEnd = Min<SizeT>(childBegin + c_NodeCapacity, m_Tree->m_NrLeafs);
+				}
+			}
+		}
+
+		SelType            m_SearchObj;
+		const PackedRTree* m_Tree = nullptr;
+		UInt32             m_Level = 0;
+		bool               m_InLeafs = false;
+		SizeT              m_LeafPos = 0, m_LeafEnd = 0;
+		SizeT              m_Pos[c_MaxNrLevels], m_End[c_MaxNrLevels];
+	};
+
+	// STR packs the objects in [first, last) with defined and non-empty extents
+	PackedRTree(ObjectPtr first, ObjectPtr last)
+		: m_First(first)
+		, m_NrObjects(last - first)
+	{
+		MG_CHECK(m_NrObjects < MAX_VALUE(UInt32));
+
+		std::vector<LeafType> leafs;
+		leafs.reserve(m_NrObjects);
+		for (; first != last; ++first)
+		{
+			leafs.emplace_back(first);
+			if (!leafs.back().IsDefined())
+				leafs.pop_back();
+		}
+
+		auto centerLess = [](bool onX)
+			{
+				return [onX](const LeafType& a, const LeafType& b) { return CenterCrd(a.GetExtents(), onX) < CenterCrd(b.GetExtents(), onX); };
+			};
+		std::sort(leafs.begin(), leafs.end(), centerLess(true));
+
+		SizeT nrLeafNodes = (leafs.size() + c_NodeCapacity - 1) / c_NodeCapacity;
+		SizeT nrSlices = SizeT(std::ceil(std::sqrt(Float64(nrLeafNodes))));
+		SizeT sliceSize = nrSlices ? ((nrLeafNodes + nrSlices - 1) / nrSlices) * c_NodeCapacity : 0;
+		for (auto sliceBegin = leafs.begin(), leafEnd = leafs.end(); sliceBegin != leafEnd; )
+		{
+			auto sliceEnd = (SizeT(leafEnd - sliceBegin) > sliceSize) ? sliceBegin + sliceSize : leafEnd;
+			std::sort(sliceBegin, sliceEnd, centerLess(false));
+			sliceBegin = sliceEnd;
+		}
+
+		m_NrLeafs = leafs.size();
+		m_LevelStarts = GetLevelStarts(m_NrLeafs);
+		m_OrderData.reserve(m_NrLeafs);
+		for (const auto& lf : leafs)
+			m_OrderData.emplace_back(lf.get_ptr() - m_First);
+		if constexpr (c_HasLeafBoxes)
+		{
+			m_LeafLowerData.reserve(m_NrLeafs); m_LeafUpperData.reserve(m_NrLeafs);
+			for (const auto& lf : leafs)
+			{
+				m_LeafLowerData.emplace_back(lf.GetExtents().first);
+				m_LeafUpperData.emplace_back(lf.GetExtents().second);
+			}
+		}
+		m_Order = m_OrderData.data();
+		m_LeafLower = m_LeafLowerData.data();
+		m_LeafUpper = m_LeafUpperData.data();
+		BuildNodes();
+	}
+
+	// a view on the arrays of a packed tree of nrLeafs leaves of the nrObjects objects starting at first, as provided by
+	// GetOrder, GetLeafLower, GetLeafUpper, GetNodeLower and GetNodeUpper of a built tree; the arrays must outlive the view
+	PackedRTree(ObjectPtr first, SizeT nrObjects, const UInt32* order, SizeT nrLeafs
+	,	const PointType* leafLower, const PointType* leafUpper, const PointType* nodeLower, const PointType* nodeUpper, SizeT nrNodes
+	)
+		: m_First(first)
+		, m_NrObjects(nrObjects)
+		, m_NrLeafs(nrLeafs)
+		, m_Order(order)
+		, m_LeafLower(leafLower), m_LeafUpper(leafUpper)
+		, m_NodeLower(nodeLower), m_NodeUpper(nodeUpper)
+		, m_LevelStarts(GetLevelStarts(nrLeafs))
+	{
+		if (nrLeafs > nrObjects || NrNodes() != nrNodes)
+			throwErrorF("PackedRTree", "a packed tree of %u leaves of %u objects must have %u nodes instead of %u", nrLeafs, nrObjects, NrNodes(), nrNodes);
+		MG_CHECK(!nrLeafs || (order && (!c_HasLeafBoxes || (leafLower && leafUpper)) && nodeLower && nodeUpper));
+		MG_CHECK(NrLevels() <= c_MaxNrLevels);
+	}
+
+	PackedRTree(PackedRTree&& rhs) = default; // moving the owned vectors keeps their buffers, thus the pointers remain valid
+
+	SizeT size() const { return m_NrObjects; }
+	SizeT NrLeafs() const { return m_NrLeafs; }
+	SizeT NrNodes() const { return m_LevelStarts.size() ? m_LevelStarts.back() : 0; }
+	UInt32 NrLevels() const { return m_LevelStarts.size() ? m_LevelStarts.size() - 1 : 0; }
+	SizeT GetLevelSize(UInt32 level) const { return m_LevelStarts[level + 1] - m_LevelStarts[level]; }
+	RangeType GetNodeBox(UInt32 level, SizeT node) const { SizeT i = m_LevelStarts[level] + node; return RangeType(m_NodeLower[i], m_NodeUpper[i]); }
+
+	RangeType GetBoundingBox() const { return NrLevels() ? GetNodeBox(NrLevels() - 1, 0) : RangeType(); }
+
+	// the arrays in packing order, to be kept for a view; the leaf boxes are null for points
+	const UInt32*    GetOrder()     const { return m_Order; }
+	const PointType* GetLeafLower() const { return m_LeafLower; }
+	const PointType* GetLeafUpper() const { return m_LeafUpper; }
+	const PointType* GetNodeLower() const { return m_NodeLower; }
+	const PointType* GetNodeUpper() const { return m_NodeUpper; }
+
+	extents_type GetLeafExtents(SizeT pos) const
+	{
+		assert(pos < m_NrLeafs);
+		if constexpr (c_HasLeafBoxes)
+			return RangeType(m_LeafLower[pos], m_LeafUpper[pos]);
+		else
+			return *GetLeafObject(pos);
+	}
+	leaf_ref GetLeaf(SizeT pos) const { return leaf_ref{ GetLeafObject(pos), GetLeafExtents(pos) }; }
+
+	// as SpatialIndex::GetSqrProximityUpperBound: the squared distance within which p has at least one object of the node
+	// that it descends to, going to the nearest child at each level, but not deeper than maxDepth, which is set to the depth above it
+	template <typename SqrDistType>
+	SqrDistType GetSqrProximityUpperBound(const PointType& p, UInt32& maxDepth, const SqrDistType* sqrDist) const
+	{
+		assert(maxDepth);
+		if (!NrLevels()) // no object with defined extents
+		{
+			maxDepth = 0;
+			return sqrDist ? *sqrDist : MAX_VALUE(SqrDistType);
+		}
+		UInt32 level = NrLevels() - 1;
+		SizeT node = 0;
+
+		UInt32 depth = 0;
+		while (++depth < maxDepth && level)
+		{
+			SizeT childBegin = node * c_NodeCapacity, childEnd = Min<SizeT>(childBegin + c_NodeCapacity, GetLevelSize(level - 1));
+			--level;
+			node = childBegin;
+			Float64 nodeSqrDist = MinSqrDist(GetNodeBox(level, node), p);
+			for (SizeT child = childBegin + 1; child < childEnd && nodeSqrDist; ++child)
+			{
+				Float64 childSqrDist = MinSqrDist(GetNodeBox(level, child), p);
+				if (childSqrDist < nodeSqrDist)
+				{
+					node = child;
+					nodeSqrDist = childSqrDist;
+				}
+			}
+		}
+		maxDepth = depth - 1;
+
+		// all objects of the node are within its box
+		RangeType box = GetNodeBox(level, node);
+		SqrDistType result = Norm<SqrDistType>(
+			PointType(
+				Max<DistType>(p.first  - box.first.first , box.second.first  - p.first),
+				Max<DistType>(p.second - box.first.second, box.second.second - p.second)
+			)
+		);
+		if (sqrDist)
+			MakeMin(result, *sqrDist);
+		return result;
+	}
+
+	iterator<RangeType> begin(const RangeType& searchBox) const { return iterator<RangeType>(searchBox, this); }
+	iterator<PointType> begin(const PointType& searchPnt) const { return iterator<PointType>(searchPnt, this); }
+
+private:
+	PackedRTree(const PackedRTree&) = delete;
+
+	// checked, as the order of a view can stem from another set of objects
+	ObjectPtr GetLeafObject(SizeT pos) const
+	{
+		UInt32 index = m_Order[pos];
+		MG_CHECK(index < m_NrObjects);
+		return m_First + index;
+	}
+
+	static Float64 CenterCrd(const PointType& p, bool onX) { return onX ? p.X() : p.Y(); }
+	static Float64 CenterCrd(const RangeType& r, bool onX) { return onX ? (Float64(r.first.X()) + Float64(r.second.X())) / 2 : (Float64(r.first.Y()) + Float64(r.second.Y())) / 2; }
+
+	static Float64 MinSqrDist(const RangeType& box, const PointType& p)
+	{
+		Float64 d0 = Max<Float64>(Max<Float64>(Float64(box.first.first) - Float64(p.first), Float64(p.first) - Float64(box.second.first)), 0);
+		Float64 d1 = Max<Float64>(Max<Float64>(Float64(box.first.second) - Float64(p.second), Float64(p.second) - Float64(box.second.second)), 0);
+		return d0 * d0 + d1 * d1;
+	}
+
+	// the offsets of the levels of the nodes of nrLeafs leaves, bottom-up; empty without leaves
+	static std::vector<SizeT> GetLevelStarts(SizeT nrLeafs)
+	{
+		std::vector<SizeT> result;
+		if (!nrLeafs)
+			return result;
+		result.push_back(0);
+		SizeT levelSize = nrLeafs;
+		do
+		{
+			levelSize = (levelSize + c_NodeCapacity - 1) / c_NodeCapacity;
+			result.push_back(result.back() + levelSize);
+		} while (levelSize > 1);
+		return result;
+	}
+
+	// bottom-up: the boxes of each c_NodeCapacity consecutive leafs, then of each c_NodeCapacity consecutive nodes, up to the root
+	void BuildNodes()
+	{
+		MG_CHECK(NrLevels() <= c_MaxNrLevels);
+		std::vector<RangeType> nodeBoxes;
+		nodeBoxes.reserve(NrNodes());
+		for (SizeT leafBegin = 0; leafBegin < m_NrLeafs; leafBegin += c_NodeCapacity)
+		{
+			RangeType box;
+			for (SizeT i = leafBegin, e = Min<SizeT>(leafBegin + c_NodeCapacity, m_NrLeafs); i != e; ++i)
+				box |= GetLeafExtents(i);
+			nodeBoxes.push_back(box);
+		}
+		for (UInt32 level = 1; level < NrLevels(); ++level)
+		{
+			SizeT childLevelBegin = m_LevelStarts[level - 1], childLevelEnd = m_LevelStarts[level];
+			for (SizeT childBegin = childLevelBegin; childBegin < childLevelEnd; childBegin += c_NodeCapacity)
+			{
+				RangeType box;
+				for (SizeT i = childBegin, e = Min<SizeT>(childBegin + c_NodeCapacity, childLevelEnd); i != e; ++i)
+					box |= nodeBoxes[i];
+				nodeBoxes.push_back(box);
+			}
+		}
+		assert(nodeBoxes.size() == NrNodes());
+
+		m_NodeLowerData.reserve(nodeBoxes.size()); m_NodeUpperData.reserve(nodeBoxes.size());
+		for (const auto& box : nodeBoxes)
+		{
+			m_NodeLowerData.emplace_back(box.first);
+			m_NodeUpperData.emplace_back(box.second);
+		}
+		m_NodeLower = m_NodeLowerData.data();
+		m_NodeUpper = m_NodeUpperData.data();
+	}
+
+	ObjectPtr          m_First = {};
+	SizeT              m_NrObjects = 0, m_NrLeafs = 0;
+	const UInt32*      m_Order = nullptr;                                       // the object index of each leaf
+	const PointType*   m_LeafLower = nullptr, *m_LeafUpper = nullptr;           // the extents of each leaf, unless these are points
+	const PointType*   m_NodeLower = nullptr, *m_NodeUpper = nullptr;           // per level, starting with the nodes of the leafs and ending with the root
+	std::vector<SizeT> m_LevelStarts;                                           // NrLevels() + 1 offsets in the node arrays
+
+	// the arrays of a built tree; empty for a view
+	std::vector<UInt32>    m_OrderData;
+	std::vector<PointType> m_LeafLowerData, m_LeafUpperData, m_NodeLowerData, m_NodeUpperData;
+};
+
+#endif // __RTC_GEO_PACKEDRTREE_H
@@ -628,6 +628,7 @@ void* AllocateFromStock(size_t objectSize MG_DEBUG_ALLOCATOR_SRC_ARG)
 		return nullptr;
 
 	auto result = AllocateFromStock_impl(objectSize);
+	AddCommittedBytes(objectSize);
 
 #if defined(MG_CACHE_ALLOC)
 
@@ -648,6 +649,7 @@ void LeaveToStock(void* objectPtr, size_t objectSize) {
 		dms_assert(objectPtr == nullptr);
 		return;
 	}
+	SubCommittedBytes(objectSize);
 #if defined(MG_CACHE_ALLOC)
 
 #if defined(MG_DEBUG_ALLOCATOR)
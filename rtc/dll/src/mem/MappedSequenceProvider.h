@@ -101,7 +101,7 @@ public:
 		*/
 	}
 
-	void Lock  (alloc_t& seq, dms_rw_mode rwMode) override { m_FileView.MapView(rwMode != dms_rw_mode::read_only); assert(  m_FileView.IsUsable() ); GetSeq(seq);}
+	void Lock  (alloc_t& seq, dms_rw_mode rwMode) override { m_FileView.MapView(rwMode != dms_rw_mode::read_only, m_FileView.m_TileID); assert(  m_FileView.IsUsable() ); GetSeq(seq);}
 	void UnLock(alloc_t& seq)                     override 
 	{ 
 //		m_FileView.resize(seq.size()); 
@@ -173,7 +173,7 @@ struct mappable_const_sequence : abstr_sequence_provider<V>
 	{
 		throwIllegalAbstract(MG_POS, "mappable_const_sequence.CloneForSeqs");
 	}
-	void Lock  (alloc_t& seq, dms_rw_mode rwMode) override { assert(rwMode == dms_rw_mode::read_only); m_FileView.MapView(); assert( m_FileView.IsUsable()); GetSeq(seq); }
+	void Lock  (alloc_t& seq, dms_rw_mode rwMode) override { assert(rwMode == dms_rw_mode::read_only); m_FileView.MapView(m_FileView.m_TileID); assert( m_FileView.IsUsable()); GetSeq(seq); }
 	void UnLock(alloc_t& seq)                     override { m_FileView.UnmapView(); seq = alloc_t(); }
 
 	SharedStr GetFileName() const override { return m_FileView.GetMappedFile()->GetFileName(); }
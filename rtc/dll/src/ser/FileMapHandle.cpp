@@ -22,11 +22,26 @@
 
 #if defined(WIN32)
 #include <windows.h>
+#else //defined(WIN32)
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// protection flags of mmap, used as desiredAccess of ViewData
+constexpr DWORD FILE_MAP_READ  = PROT_READ;
+constexpr DWORD FILE_MAP_WRITE = PROT_READ | PROT_WRITE;
+#endif //defined(WIN32)
 
 MG_DEBUGCODE(
 	const UInt64 sd_MaxFileSize = 0x4000000000; // 40 x 4Gb = 160Gb
 )
 
+#if defined(WIN32)
+
 inline DWORD HiDWORD(UInt64 qWord) { return qWord >> 32; }
 inline DWORD LoDWORD(UInt64 qWord) { return qWord; } // truncate
 inline DWORD HiDWORD(UInt32 dWord) { return 0; }
@@ -39,6 +54,28 @@ static UInt32 GetAllocationGrannularityImpl()
 	return info.dwAllocationGranularity;
 }
 
+static UInt32 GetMemPageSizeImpl()
+{
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return info.dwPageSize;
+}
+
+#else //defined(WIN32)
+
+static UInt32 GetAllocationGrannularityImpl()
+{
+	// mmap offsets must be aligned to the page size
+	return sysconf(_SC_PAGESIZE);
+}
+
+static UInt32 GetMemPageSizeImpl()
+{
+	return sysconf(_SC_PAGESIZE);
+}
+
+#endif //defined(WIN32)
+
 SizeT GetAllocationGrannularity()
 {
 	static UInt32 allocGrannularity = GetAllocationGrannularityImpl();
@@ -73,13 +110,6 @@ UInt8 GetLog2AllocationGrannularity()
 	return result;
 }
 
-static UInt32 GetMemPageSizeImpl()
-{
-	SYSTEM_INFO info;
-	GetSystemInfo(&info);
-	return info.dwPageSize;
-}
-
 UInt32 GetMemPageSize()
 {
 	static UInt32 pageSize = GetMemPageSizeImpl();
@@ -105,6 +135,20 @@ UInt8 GetLog2MemPageSize()
 
 //  -----------------------------------------------------------------------
 
+FileHandle::~FileHandle()
+{
+//	assert(!IsOpen());
+	// REMOVE IF ASSERTION IS PROVEN
+	if (IsOpen())
+		CloseFile(); 
+}
+
+void AdviseTileAccess(MappedFileHandle* mappedFile, void* viewPtr, FileChunkSpec viewSpec, tile_id t, bool alsoWrite);
+
+#if defined(WIN32)
+
+//  -----------------------------------------------------------------------
+
 DWORD GetCreationDisposition(FileCreationMode fcm)
 {
 	switch (fcm) {
@@ -159,14 +203,6 @@ WinHandle::~WinHandle()
 
 //  -----------------------------------------------------------------------
 
-FileHandle::~FileHandle()
-{
-//	assert(!IsOpen());
-	// REMOVE IF ASSERTION IS PROVEN
-	if (IsOpen())
-		CloseFile(); 
-}
-
 void FileHandle::OpenRw(WeakStr fileName, dms::filesize_t requiredNrBytes, dms_rw_mode rwMode, bool isTmp, bool doRetry, bool deleteOnClose)
 {
 	assert(!IsOpen());
@@ -271,6 +307,386 @@ void FileHandle::ReadFileSize(CharPtr handleName)
 	dbg_assert(m_FileSize <= sd_MaxFileSize);
 }
 
+//  -----------------------------------------------------------------------
+
+void MappedFileHandle::MapFile(bool alsoWrite)
+{
+	m_hFileMapping = WinHandle();
+	if (!m_hFile)
+		throwErrorF("CreateFileMapping", "%s('%s') failed"
+			, alsoWrite ? "CreateFile" : "OpenFile", m_FileName);
+
+	if (m_FileSize == UNDEFINED_FILE_SIZE)
+		throwErrorF("CreateFileMapping", "%s('%s') failed because MappingSize is undefined"
+			, alsoWrite ? "CreateFile" : "OpenFile", m_FileName);
+
+	WinHandle fileMapping =
+		CreateFileMapping(
+			m_hFile,                           // Current file handle. 
+			nullptr,                           // Default security. 
+			alsoWrite ? PAGE_READWRITE : PAGE_READONLY,
+			HiDWORD(m_FileSize), LoDWORD(m_FileSize),
+			nullptr                            // Name of mapping object. 
+		);
+	if (fileMapping == nullptr)
+		throwLastSystemError("FileMapHandle('%s').CreateFileMapping(%I64u)", m_FileName.c_str(), (UInt64)m_FileSize);
+
+	m_hFileMapping = std::move(fileMapping);
+}
+
+//  -----------------------------------------------------------------------
+
+ViewData::ViewData(MappedFileHandle* mappedFile, DWORD desiredAccess, dms::filesize_t viewOffset, dms::filesize_t viewCapacity)
+{
+	auto pageBase = viewOffset & GetAllocationMajorMask();
+	assert((pageBase & GetAllocationMinorMask()) == 0);
+	auto pageOffset = viewOffset & GetAllocationMinorMask();
+
+	while (true) {
+		m_Ptr =
+			MapViewOfFile(mappedFile->m_hFileMapping, // Handle to mapping object. 
+				desiredAccess,
+				HiDWORD(pageBase),
+				LoDWORD(pageBase),
+				viewCapacity + pageOffset
+			);
+		if (m_Ptr)
+		{
+			m_Ptr = reinterpret_cast<BYTE*>(m_Ptr) + pageOffset;
+			break;
+		}
+
+
+		DWORD lastErr = GetLastError();
+		if (lastErr != ERROR_NOT_ENOUGH_MEMORY || !DMS_CoalesceHeap(viewCapacity))
+			throwSystemError(lastErr, "FileMapHandle('%s').MapViewOfFile(%I64u)", mappedFile->GetFileName().c_str(), (UInt64)viewCapacity);
+	};
+}
+
+ViewData::~ViewData()
+{
+	if (has_ptr())
+	{
+		auto pageBase = reinterpret_cast<UInt64>(get_ptr()) & GetAllocationMajorMask();
+
+		UnmapViewOfFile(reinterpret_cast<void*>(pageBase));
+	}
+}
+
+//  -----------------------------------------------------------------------
+
+// the Windows memory manager already clusters the page faults of mapped views and the .mmd chunks of a tile are contiguous
+void AdviseTileAccess(MappedFileHandle* mappedFile, void* viewPtr, FileChunkSpec viewSpec, tile_id t, bool alsoWrite)
+{}
+
+#else //defined(WIN32)
+
+//  -----------------------------------------------------------------------
+//  POSIX implementation: the file is mapped by mmap per view with the same view granularity as on Windows;
+//  there is no separate file mapping object, MapFile only grows the file to cover all views.
+//  -----------------------------------------------------------------------
+
+template<typename ...Args>
+[[noreturn]] void throwPosixError(int err, CharPtr format, Args&&... args)
+{
+	throwErrorF("PosixSystem", "%s:\nErrorCode %d: %s"
+	,	mgFormat2string<Args...>(format, std::forward<Args>(args)...).c_str()
+	,	err
+	,	std::strerror(err)
+	);
+}
+
+// equivalent of ManageSystemError: returns true if the failed call should be retried
+static bool ManagePosixError(int err, UInt32& retryCounter, CharPtr format, CharPtr fileName, bool throwOnError, bool doRetry)
+{
+	switch (err)
+	{
+		case EINTR:
+			return true;
+		case EACCES:
+		case EBUSY:
+		case ETXTBSY:
+			if (!doRetry)
+				break;
+			if (++retryCounter > 10)
+				break;
+			UInt32 nrWaitSecs = (1 << retryCounter);
+			reportF(SeverityTypeID::ST_MajorTrace,
+				"PosixSystem Error %s:\nErrorCode %d: %s\nWaiting %d seconds before retry #%d",
+				mySSPrintF(format, fileName).c_str(),
+				err,
+				std::strerror(err),
+				nrWaitSecs,
+				retryCounter
+			);
+			Wait(1000 * nrWaitSecs);
+			return true;
+	}
+	if (throwOnError)
+		throwPosixError(err, format, fileName);
+	return false;
+}
+
+int GetOpenFlags(FileCreationMode fcm)
+{
+	switch (fcm) {
+		case FCM_CreateNew:      return O_RDWR | O_CREAT | O_EXCL;
+		case FCM_CreateAlways:   return O_RDWR | O_CREAT | O_TRUNC;
+		case FCM_OpenRwGrowable: return O_RDWR | O_CREAT;
+		case FCM_OpenRwFixed:    return O_RDWR;
+		case FCM_OpenReadOnly:   return O_RDONLY;
+	}
+	return 0;
+}
+
+int CreateFileHandleForRwView(WeakStr fileName, FileCreationMode fcm, bool isTmp, bool doRetry, bool deleteOnClose)
+{
+	assert(IsWritable(fcm));
+	GetWritePermission(fileName);
+	int fd;
+	UInt32 retryCounter = 0;
+
+	auto nativeFileName = ConvertDmsFileName(fileName);
+
+	do {
+		fd = open(nativeFileName.c_str(), GetOpenFlags(fcm) | O_CLOEXEC, 0666);
+	}	while (fd == -1 && ManagePosixError(errno, retryCounter, "CreateFileHandleForRwView(%s)", fileName.c_str(), true, doRetry));
+
+	// the file remains accessible through fd until it is closed, as with FILE_FLAG_DELETE_ON_CLOSE
+	if (deleteOnClose)
+		unlink(nativeFileName.c_str());
+	return fd;
+}
+
+//  -----------------------------------------------------------------------
+
+FileDescriptor::~FileDescriptor()
+{
+	if (m_Fd == -1)
+		return;
+	close(m_Fd);
+}
+
+//  -----------------------------------------------------------------------
+
+void FileHandle::OpenRw(WeakStr fileName, dms::filesize_t requiredNrBytes, dms_rw_mode rwMode, bool isTmp, bool doRetry, bool deleteOnClose)
+{
+	assert(!IsOpen());
+	assert(rwMode != dms_rw_mode::unspecified);
+	assert(rwMode >= dms_rw_mode::read_write);
+	m_IsTmp     = isTmp;
+	bool readData  = (rwMode < dms_rw_mode::write_only_mustzero);
+
+	FileCreationMode fcm = readData ? FCM_OpenRwGrowable : FCM_CreateAlways;
+	m_hFile = FileDescriptor(
+		CreateFileHandleForRwView(fileName, fcm, isTmp, doRetry, deleteOnClose)
+	); // returns a valid descriptor or throws a system error
+	m_FileName = fileName;
+
+	assert(IsOpen());
+	MG_DEBUG_DATA_CODE(m_FCM = fcm; )
+
+	if (IsDefined(requiredNrBytes))
+		SetFileSize(requiredNrBytes);
+	else
+		if (readData)
+			ReadFileSize(fileName.c_str());
+		else
+			m_FileSize = 0;
+	assert(m_FileSize != UNDEFINED_FILE_SIZE);
+	dbg_assert(m_FileSize <= sd_MaxFileSize);
+}
+
+// as on Windows, the file itself is only extended when it is mapped for writing, see MappedFileHandle::MapFile
+void FileHandle::SetFileSize(dms::filesize_t requiredNrBytes)
+{
+	m_FileSize = requiredNrBytes;
+}
+
+void FileHandle::OpenForRead(WeakStr fileName, bool throwOnError, bool doRetry, bool mayBeEmpty)
+{
+	assert(!IsOpen());
+
+	int fd;
+	UInt32 retryCounter = 0;
+
+	auto nativeFileName = ConvertDmsFileName(fileName);
+
+	do {
+		fd = open(nativeFileName.c_str(), (mayBeEmpty ? O_RDONLY | O_CREAT : O_RDONLY) | O_CLOEXEC, 0666);
+	}	while (fd == -1 && ManagePosixError(errno, retryCounter, "FileMapHandle(%s).OpenForRead", fileName.c_str(), throwOnError, doRetry));
+
+	assert(fd != -1 || !throwOnError);
+
+	m_hFile = FileDescriptor(fd);
+	m_FileName = fileName;
+
+	assert(IsOpen() || !throwOnError);
+	MG_DEBUG_DATA_CODE( m_FCM = FCM_OpenReadOnly; )
+
+	if (IsOpen())
+		ReadFileSize(fileName.c_str());
+	else
+		m_FileSize = UNDEFINED_FILE_SIZE;
+
+	dbg_assert(m_FileSize <= sd_MaxFileSize || m_FileSize == UNDEFINED_FILE_SIZE);
+}
+
+void FileHandle::CloseFile()
+{
+	assert(m_hFile);
+	m_hFile = FileDescriptor();
+}
+
+void FileHandle::ReadFileSize(CharPtr handleName)
+{
+	struct stat fileStat;
+	if (fstat(m_hFile.get(), &fileStat) == -1)
+		throwPosixError(errno, "GetFileSize(%s)", handleName);
+	m_FileSize = fileStat.st_size;
+	dbg_assert(m_FileSize <= sd_MaxFileSize);
+}
+
+//  -----------------------------------------------------------------------
+
+void MappedFileHandle::MapFile(bool alsoWrite)
+{
+	if (!m_hFile)
+		throwErrorF("CreateFileMapping", "%s('%s') failed"
+			, alsoWrite ? "CreateFile" : "OpenFile", m_FileName);
+
+	if (m_FileSize == UNDEFINED_FILE_SIZE)
+		throwErrorF("CreateFileMapping", "%s('%s') failed because MappingSize is undefined"
+			, alsoWrite ? "CreateFile" : "OpenFile", m_FileName);
+
+	m_MappedForWrite = alsoWrite;
+	if (!alsoWrite)
+		return;
+
+	// pages of a MAP_SHARED view beyond the end of the file cannot be accessed, so grow the file as CreateFileMapping does
+	struct stat fileStat;
+	if (fstat(m_hFile.get(), &fileStat) == -1)
+		throwPosixError(errno, "FileMapHandle('%s').fstat", m_FileName.c_str());
+	if (dms::filesize_t(fileStat.st_size) >= m_FileSize)
+		return;
+
+	int result;
+	while ((result = ftruncate(m_hFile.get(), m_FileSize)) == -1 && errno == EINTR)
+		;
+	if (result == -1)
+		throwPosixError(errno, "FileMapHandle('%s').ftruncate(%u)", m_FileName.c_str(), (UInt64)m_FileSize);
+}
+
+//  -----------------------------------------------------------------------
+
+ViewData::ViewData(MappedFileHandle* mappedFile, DWORD desiredAccess, dms::filesize_t viewOffset, dms::filesize_t viewCapacity)
+{
+	auto pageBase = viewOffset & GetAllocationMajorMask();
+	assert((pageBase & GetAllocationMinorMask()) == 0);
+	auto pageOffset = viewOffset & GetAllocationMinorMask();
+
+	m_AlsoWrite = (desiredAccess & PROT_WRITE);
+	while (true) {
+		void* viewPtr = mmap(nullptr, viewCapacity + pageOffset, int(desiredAccess), MAP_SHARED, mappedFile->m_hFile.get(), pageBase);
+		if (viewPtr != MAP_FAILED)
+		{
+			m_Ptr = reinterpret_cast<char*>(viewPtr) + pageOffset;
+			m_MappedSize = viewCapacity + pageOffset;
+			break;
+		}
+
+		int lastErr = errno;
+		if (lastErr != ENOMEM || !DMS_CoalesceHeap(viewCapacity))
+			throwPosixError(lastErr, "FileMapHandle('%s').mmap(%u)", mappedFile->GetFileName().c_str(), (UInt64)viewCapacity);
+	};
+}
+
+ViewData::~ViewData()
+{
+	if (has_ptr())
+	{
+		auto pageBase = reinterpret_cast<void*>(reinterpret_cast<UInt64>(get_ptr()) & GetAllocationMajorMask());
+
+		// start writing back dirty pages, as the unmapped views of Windows are lazily flushed
+		if (m_AlsoWrite)
+			msync(pageBase, m_MappedSize, MS_ASYNC);
+		munmap(pageBase, m_MappedSize);
+	}
+}
+
+//  -----------------------------------------------------------------------
+
+static SizeT GetHugePageSizeImpl()
+{
+	SizeT hugePageSize = 0;
+	if (FILE* f = fopen("/sys/kernel/mm/transparent_hugepage/hpage_pmd_size", "r"))
+	{
+		unsigned long long size = 0;
+		if (fscanf(f, "%llu", &size) == 1)
+			hugePageSize = size;
+		fclose(f);
+	}
+	return hugePageSize ? hugePageSize : SizeT(2) << 20;
+}
+
+SizeT GetHugePageSize()
+{
+	static SizeT hugePageSize = GetHugePageSizeImpl();
+	return hugePageSize;
+}
+
+// views of read-only data up to this size are prefetched completely when mapped
+constexpr SizeT MAX_WILLNEED_VIEW_SIZE = SizeT(64) << 20;
+
+// Gives access hints for a newly mapped view of tile t (or no_tile for a view of a whole file):
+// - MADV_HUGEPAGE for views of at least one huge page, which reduces TLB misses where transparent huge pages of the page cache are supported;
+// - MADV_WILLNEED for moderately sized read-only views, which are usually read completely;
+// - MADV_SEQUENTIAL when the tiles of a file are mapped in increasing order, which also starts reading the next tile of a read-only file;
+//   that is the chunk registered in the mempage_table of a .seq file, or else the equally sized range that follows, as tiles of fixed size elements are allocated consecutively.
+void AdviseTileAccess(MappedFileHandle* mappedFile, void* viewPtr, FileChunkSpec viewSpec, tile_id t, bool alsoWrite)
+{
+	auto viewBegin = reinterpret_cast<UInt64>(viewPtr);
+	auto pageBase = viewBegin & GetAllocationMajorMask();
+	auto pageEnd  = (viewBegin + viewSpec.capacity + GetAllocationMinorMask()) & GetAllocationMajorMask();
+	auto viewAddr = reinterpret_cast<void*>(pageBase);
+	SizeT viewLen = pageEnd - pageBase;
+
+	// hints are optional; errors, such as EINVAL for kernels without the required support, are ignored
+	if (viewLen >= GetHugePageSize())
+		madvise(viewAddr, viewLen, MADV_HUGEPAGE);
+
+	if (!alsoWrite && viewLen <= MAX_WILLNEED_VIEW_SIZE)
+		madvise(viewAddr, viewLen, MADV_WILLNEED);
+
+	if (t == no_tile)
+		return;
+	tile_id prevTile = mappedFile->m_LastMappedTile.exchange(t, std::memory_order_relaxed);
+	if (prevTile == no_tile || prevTile + 1 != t)
+		return;
+
+	madvise(viewAddr, viewLen, MADV_SEQUENTIAL);
+
+	// the chunks of read-only files don't move, so the next tile can be read ahead without locking m_ResizeMutex
+	if (alsoWrite || mappedFile->m_MappedForWrite)
+		return;
+	FileChunkSpec nextChunk = { viewSpec.offset + viewSpec.capacity, viewSpec.capacity, viewSpec.capacity };
+	if (auto memPageAllocTable = mappedFile->m_MemPageAllocTable.get())
+	{
+		if (t + 1 >= memPageAllocTable->filed_size())
+			return;
+		nextChunk = (*memPageAllocTable)[t + 1];
+	}
+	if (nextChunk.offset >= mappedFile->GetFileSize())
+		return;
+	MakeMin(nextChunk.size, mappedFile->GetFileSize() - nextChunk.offset);
+	if (nextChunk.size)
+		posix_fadvise(mappedFile->m_hFile.get(), nextChunk.offset, nextChunk.size, POSIX_FADV_WILLNEED);
+}
+
+#endif //defined(WIN32)
+
+//  -----------------------------------------------------------------------
+
 #if defined(MG_DEBUG)
 void CheckMemPage(const mempage_table* memPageAllocTable, FreeChunk newChunk)
 {
@@ -377,38 +793,14 @@ MappedFileHandle::MappedFileHandle()
 MappedFileHandle::~MappedFileHandle()
 {}
 
-
-void MappedFileHandle::MapFile(bool alsoWrite)
-{
-	m_hFileMapping = WinHandle();
-	if (!m_hFile)
-		throwErrorF("CreateFileMapping", "%s('%s') failed"
-			, alsoWrite ? "CreateFile" : "OpenFile", m_FileName);
-
-	if (m_FileSize == UNDEFINED_FILE_SIZE)
-		throwErrorF("CreateFileMapping", "%s('%s') failed because MappingSize is undefined"
-			, alsoWrite ? "CreateFile" : "OpenFile", m_FileName);
-
-	WinHandle fileMapping =
-		CreateFileMapping(
-			m_hFile,                           // Current file handle. 
-			nullptr,                           // Default security. 
-			alsoWrite ? PAGE_READWRITE : PAGE_READONLY,
-			HiDWORD(m_FileSize), LoDWORD(m_FileSize),
-			nullptr                            // Name of mapping object. 
-		);
-	if (fileMapping == nullptr)
-		throwLastSystemError("FileMapHandle('%s').CreateFileMapping(%I64u)", m_FileName.c_str(), (UInt64)m_FileSize);
-
-	m_hFileMapping = std::move(fileMapping);
-}
-
 void MappedFileHandle::OpenRw(WeakStr fileName, dms::filesize_t requiredNrBytes, dms_rw_mode rwMode, bool isTmp)
 {
 	FileHandle::OpenRw(fileName, requiredNrBytes, rwMode, isTmp);
 	if (m_FileSize == 0)
 	{
+#if defined(WIN32)
 		m_hFileMapping = WinHandle();
+#endif //defined(WIN32)
 		return;
 	}
 	MapFile(true);
@@ -439,45 +831,6 @@ void CreateMemPageAllocTable(std::shared_ptr<MappedFileHandle> self, bool readOn
 
 //  -----------------------------------------------------------------------
 
-ViewData::ViewData(MappedFileHandle* mappedFile, DWORD desiredAccess, dms::filesize_t viewOffset, dms::filesize_t viewCapacity)
-{
-	auto pageBase = viewOffset & GetAllocationMajorMask();
-	assert((pageBase & GetAllocationMinorMask()) == 0);
-	auto pageOffset = viewOffset & GetAllocationMinorMask();
-
-	while (true) {
-		m_Ptr =
-			MapViewOfFile(mappedFile->m_hFileMapping, // Handle to mapping object. 
-				desiredAccess,
-				HiDWORD(pageBase),
-				LoDWORD(pageBase),
-				viewCapacity + pageOffset
-			);
-		if (m_Ptr)
-		{
-			m_Ptr = reinterpret_cast<BYTE*>(m_Ptr) + pageOffset;
-			break;
-		}
-
-
-		DWORD lastErr = GetLastError();
-		if (lastErr != ERROR_NOT_ENOUGH_MEMORY || !DMS_CoalesceHeap(viewCapacity))
-			throwSystemError(lastErr, "FileMapHandle('%s').MapViewOfFile(%I64u)", mappedFile->GetFileName().c_str(), (UInt64)viewCapacity);
-	};
-}
-
-ViewData::~ViewData()
-{
-	if (has_ptr())
-	{
-		auto pageBase = reinterpret_cast<UInt64>(get_ptr()) & GetAllocationMajorMask();
-
-		UnmapViewOfFile(reinterpret_cast<void*>(pageBase));
-	}
-}
-
-//  -----------------------------------------------------------------------
-
 FileViewHandle::FileViewHandle(std::shared_ptr<MappedFileHandle> mfh, dms::filesize_t viewOffset, dms::filesize_t viewSize, dms::filesize_t viewCapacity)
 	: m_MappedFile(mfh)
 {
@@ -531,7 +884,7 @@ void ConstFileViewHandle::operator =(ConstFileViewHandle&& rhs) noexcept
 	assert(m_ViewSpec.size <= m_ViewSpec.capacity);
 }
 
-void FileViewHandle::MapView(bool alsoWrite)
+void FileViewHandle::MapView(bool alsoWrite, tile_id t)
 {
 	MG_CHECK(m_MappedFile); // precondition
 
@@ -543,9 +896,10 @@ void FileViewHandle::MapView(bool alsoWrite)
 	m_AlsoWrite = alsoWrite;
 	
 	m_ViewData = ViewData(m_MappedFile.get(), alsoWrite ? FILE_MAP_WRITE : FILE_MAP_READ, m_ViewSpec.offset, m_ViewSpec.capacity);
+	AdviseTileAccess(m_MappedFile.get(), m_ViewData.get_ptr(), m_ViewSpec, t, alsoWrite);
 }
 
-void ConstFileViewHandle::MapView()
+void ConstFileViewHandle::MapView(tile_id t)
 {
 	MG_CHECK(m_MappedFile); // precondition
 
@@ -556,6 +910,7 @@ void ConstFileViewHandle::MapView()
 		return;
 
 	m_ViewData = ViewData(m_MappedFile.get(), FILE_MAP_READ, m_ViewSpec.offset, m_ViewSpec.capacity);
+	AdviseTileAccess(m_MappedFile.get(), m_ViewData.get_ptr(), m_ViewSpec, t, false);
 }
 
 void FileViewHandle::allocAndMapChunk(dms::filesize_t capacity, tile_id t)
@@ -786,11 +1141,3 @@ FreeChunk mempage_table::ReallocChunk(FreeChunk currChunk, dms::filesize_t newSi
 
 	return newChunk;
 }
-
-
-#else //defined(WIN32)
-
-// GNU TODO
-
-#endif //defined(WIN32)
-
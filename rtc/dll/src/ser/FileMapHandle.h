@@ -9,6 +9,8 @@
 #if !defined(__RTC_SER_FILEMAPHANDLE_H)
 #define __RTC_SER_FILEMAPHANDLE_H
 
+#include <atomic>
+
 #include "cpc/Types.h"
 #include "geo/IndexRange.h"
 #include "ser/FileCreationMode.h"
@@ -34,6 +36,8 @@ inline SizeT NrMemPages(SizeT nrBytes)
 
 //  -----------------------------------------------------------------------
 
+#if defined(WIN32)
+
 struct WinHandle
 {
 	WinHandle(HANDLE hnd = nullptr)
@@ -60,6 +64,42 @@ private:
 	HANDLE m_Hnd = nullptr;
 };
 
+using OsFileHandle = WinHandle;
+
+#else //defined(WIN32)
+
+// owner of a POSIX file descriptor; -1 indicates that no file is open
+struct FileDescriptor
+{
+	explicit FileDescriptor(int fd = -1)
+		: m_Fd(fd)
+	{}
+
+	FileDescriptor(FileDescriptor&& rhs) noexcept
+	{
+		operator =(std::move(rhs));
+	}
+	void operator = (FileDescriptor&& rhs) noexcept
+	{
+		std::swap(m_Fd, rhs.m_Fd);
+	}
+
+	FileDescriptor(const FileDescriptor& rhs) = delete;
+	void operator = (const FileDescriptor&) = delete;
+
+	RTC_CALL ~FileDescriptor(); // close(m_Fd)
+
+	int get() const { return m_Fd; }
+	explicit operator bool() const { return m_Fd != -1; }
+
+private:
+	int m_Fd = -1;
+};
+
+using OsFileHandle = FileDescriptor;
+
+#endif //defined(WIN32)
+
 //  -----------------------------------------------------------------------
 
 struct FileChunkSpec {
@@ -77,7 +117,7 @@ struct FileHandle
 	RTC_CALL void CloseFile();
 	RTC_CALL void DropFile (WeakStr fileName);
 
-	bool IsOpen  () const { return m_hFile; }
+	bool IsOpen  () const { return bool(m_hFile); }
 
 	dms::filesize_t GetFileSize() const { return m_FileSize; }
 	void  SetFileSize(dms::filesize_t requiredNrBytes);
@@ -87,7 +127,7 @@ struct FileHandle
 protected:
 	void ReadFileSize(CharPtr handleName);
 
-	WinHandle        m_hFile = nullptr;
+	OsFileHandle     m_hFile;
 	dms::filesize_t  m_FileSize = UNDEFINED_FILE_SIZE;
 	SharedStr        m_FileName;
 
@@ -111,8 +151,13 @@ struct MappedFileHandle : FileHandle
 
 	RTC_CALL void MapFile(bool alsoWrite);
 
+#if defined(WIN32)
 	WinHandle m_hFileMapping;
+#else
+	bool m_MappedForWrite = false;
+#endif
 	std::shared_mutex m_ResizeMutex;
+	std::atomic<tile_id> m_LastMappedTile = no_tile; // drives the sequential access hints given to the OS, see AdviseTileAccess
 
 	std::unique_ptr< mempage_table > m_MemPageAllocTable;
 	dms::filesize_t m_AllocatedSize = 0;
@@ -149,7 +194,17 @@ struct ViewData : ptr_base<void, movable>
 	void operator=(ViewData&& rhs) noexcept
 	{
 		ptr_base<void, movable >::swap(rhs);
+#if !defined(WIN32)
+		std::swap(m_MappedSize, rhs.m_MappedSize);
+		std::swap(m_AlsoWrite, rhs.m_AlsoWrite);
+#endif
 	}
+
+#if !defined(WIN32)
+private:
+	SizeT m_MappedSize = 0; // munmap requires the length of the mapping, which starts at the page base below m_Ptr
+	bool  m_AlsoWrite = false;
+#endif
 };
 
 struct FileViewHandle
@@ -174,7 +229,7 @@ struct FileViewHandle
 
 	bool IsUsable() const { return m_ViewData.has_ptr() || GetViewCapacity() == 0; }
 
-	RTC_CALL void MapView(bool alsoWrite);
+	RTC_CALL void MapView(bool alsoWrite, tile_id t = no_tile);
 	void UnmapView() { m_ViewData = ViewData(); }
 
 	char*   DataBegin()       { assert(IsUsable()); return reinterpret_cast<char*  >(m_ViewData.get_ptr()); }
@@ -216,7 +271,7 @@ struct ConstFileViewHandle
 
 	bool IsUsable() const { return m_ViewData.has_ptr() || GetViewCapacity() == 0; }
 
-	RTC_CALL void MapView();
+	RTC_CALL void MapView(tile_id t = no_tile);
 	void UnmapView() { m_ViewData = ViewData(); }
 
 	CharPtr DataBegin() const { assert(IsUsable()); return reinterpret_cast<CharPtr>(m_ViewData.get_ptr()); }
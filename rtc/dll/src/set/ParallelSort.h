@@ -0,0 +1,337 @@
+// Copyright (C) 1998-2026 Object Vision b.v.
+// License: GNU GPL 3
+/////////////////////////////////////////////////////////////////////////////
+
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+File: ParallelSort.h
+Purpose:
+- Multi-threaded sorting of values and of index sequences (argsort) for large arrays.
+
+Summary:
+- Integral and floating point values are sorted by a stable least significant digit radix sort on 8 bit digits;
+  each pass counts digits per chunk and scatters the chunks concurrently. Passes in which all keys have the same digit are skipped.
+- radix_key maps values to unsigned keys in the order of DataLessThanCompare, thus with null first:
+  unsigned null (max) wraps to 0, signed null (min) maps to 0 and NaN maps to 0; -0.0 and +0.0 get the same key.
+- Other value types are sorted by a parallel merge sort: chunks are stable_sorted concurrently and then merged pairwise,
+  where each merge is split at co-ranks into concurrently merged parts.
+- All sorts are stable, so the order of equal (and null) values in an index doesn't depend on the number of threads.
+- The algorithms are parameterized by an executor that provides nrThreads and operator ()(n, func) that calls func(i) for all i < n,
+  possibly concurrently; see tile_task_executor in ParallelTiles.h.
+*/
+
+#if !defined(__RTC_SET_PARALLELSORT_H)
+#define __RTC_SET_PARALLELSORT_H
+
+#include <algorithm>
+#include <array>
+#include <assert.h>
+#include <bit>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace parallel_sort {
+
+	constexpr std::size_t MIN_CHUNK_SIZE = 1 << 16;
+	constexpr std::size_t RADIX_BITS = 8;
+	constexpr std::size_t RADIX_SIZE = 1 << RADIX_BITS;
+
+	// *****************************************************************************
+	//	radix keys
+	// *****************************************************************************
+
+	template <typename V> constexpr bool has_radix_key_v =
+			(std::is_integral_v<V> && !std::is_same_v<V, bool>)
+		||	(std::is_floating_point_v<V> && (sizeof(V) == 4 || sizeof(V) == 8));
+
+	template <typename V, bool IsFloat = std::is_floating_point_v<V>> struct radix_key_type { using type = std::make_unsigned_t<V>; };
+	template <typename V> struct radix_key_type<V, true> { using type = std::conditional_t<sizeof(V) == 4, std::uint32_t, std::uint64_t>; };
+
+	template <typename V> using radix_key_t = typename radix_key_type<V>::type;
+
+	template <typename V>
+	auto radix_key(V v) -> radix_key_t<V>
+	{
+		static_assert(has_radix_key_v<V>);
+		using key_t = radix_key_t<V>;
+		constexpr key_t signBit = key_t(1) << (sizeof(key_t) * 8 - 1);
+
+		if constexpr (std::is_floating_point_v<V>)
+		{
+			if (v != v)
+				return 0; // null
+			if (v == 0)
+				v = 0; // -0.0 == +0.0
+			auto bits = std::bit_cast<key_t>(v);
+			return (bits & signBit) ? key_t(~bits) : key_t(bits | signBit);
+		}
+		else if constexpr (std::is_signed_v<V>)
+			return key_t(v) ^ signBit; // null (min) maps to 0
+		else
+			return key_t(v + 1); // null (max) wraps to 0
+	}
+
+	// *****************************************************************************
+	//	chunking
+	// *****************************************************************************
+
+	inline auto GetNrChunks(std::size_t n, std::size_t nrThreads) -> std::size_t
+	{
+		return std::max<std::size_t>(1, std::min<std::size_t>(nrThreads, n / MIN_CHUNK_SIZE));
+	}
+
+	struct chunking
+	{
+		chunking(std::size_t n, std::size_t nrChunks)
+			: m_Size(n), m_NrChunks(nrChunks), m_ChunkSize((n + nrChunks - 1) / nrChunks)
+		{}
+
+		std::size_t begin(std::size_t c) const { return std::min(c * m_ChunkSize, m_Size); }
+		std::size_t end  (std::size_t c) const { return begin(c + 1); }
+
+		std::size_t m_Size, m_NrChunks, m_ChunkSize;
+	};
+
+	template <typename T, typename Executor>
+	void parallel_copy(const T* src, T* dst, std::size_t n, const Executor& exec)
+	{
+		chunking chunks(n, GetNrChunks(n, exec.nrThreads));
+		exec(chunks.m_NrChunks, [&](std::size_t c)
+			{
+				std::copy(src + chunks.begin(c), src + chunks.end(c), dst + chunks.begin(c));
+			}
+		);
+	}
+
+	// *****************************************************************************
+	//	radix_sort
+	// *****************************************************************************
+
+	// stable sort of data[0..n) on keyFunc(data[i]); buffer must have room for n elements
+	template <typename T, typename KeyFunc, typename Executor>
+	void radix_sort(T* data, T* buffer, std::size_t n, KeyFunc keyFunc, const Executor& exec)
+	{
+		using key_t = decltype(keyFunc(*data));
+		static_assert(std::is_unsigned_v<key_t>);
+		constexpr std::size_t nrPasses = sizeof(key_t) * 8 / RADIX_BITS;
+		using histogram = std::array<std::size_t, RADIX_SIZE>;
+
+		chunking chunks(n, GetNrChunks(n, exec.nrThreads));
+		auto nrChunks = chunks.m_NrChunks;
+
+		// count the digits of all passes at once to find the passes in which all keys have the same digit
+		std::vector<histogram> counts(nrChunks * nrPasses);
+		exec(nrChunks, [&](std::size_t c)
+			{
+				auto* chunkCounts = &counts[c * nrPasses];
+				for (std::size_t i = chunks.begin(c), e = chunks.end(c); i != e; ++i)
+				{
+					key_t key = keyFunc(data[i]);
+					for (std::size_t p = 0; p != nrPasses; ++p, key >>= RADIX_BITS)
+						++chunkCounts[p][key & (RADIX_SIZE - 1)];
+				}
+			}
+		);
+
+		T* src = data;
+		T* dst = buffer;
+		bool countsAreCurrent = true;
+		std::vector<histogram> offsets(nrChunks);
+		for (std::size_t p = 0; p != nrPasses; ++p)
+		{
+			histogram totals = {};
+			for (std::size_t c = 0; c != nrChunks; ++c)
+				for (std::size_t d = 0; d != RADIX_SIZE; ++d)
+					totals[d] += counts[c * nrPasses + p][d];
+			if (std::find(totals.begin(), totals.end(), n) != totals.end())
+				continue;
+
+			auto shift = p * RADIX_BITS;
+			if (!countsAreCurrent) // the chunks have been permuted by a previous pass
+			{
+				exec(nrChunks, [&](std::size_t c)
+					{
+						auto& chunkCounts = counts[c * nrPasses + p];
+						chunkCounts = {};
+						for (std::size_t i = chunks.begin(c), e = chunks.end(c); i != e; ++i)
+							++chunkCounts[(keyFunc(src[i]) >> shift) & (RADIX_SIZE - 1)];
+					}
+				);
+			}
+			countsAreCurrent = false;
+
+			// equal digits are placed in chunk order, which keeps the sort stable
+			std::size_t offset = 0;
+			for (std::size_t d = 0; d != RADIX_SIZE; ++d)
+				for (std::size_t c = 0; c != nrChunks; ++c)
+				{
+					offsets[c][d] = offset;
+					offset += counts[c * nrPasses + p][d];
+				}
+			assert(offset == n);
+
+			exec(nrChunks, [&](std::size_t c)
+				{
+					auto& chunkOffsets = offsets[c];
+					for (std::size_t i = chunks.begin(c), e = chunks.end(c); i != e; ++i)
+						dst[chunkOffsets[(keyFunc(src[i]) >> shift) & (RADIX_SIZE - 1)]++] = src[i];
+				}
+			);
+			std::swap(src, dst);
+		}
+		if (src != data)
+			parallel_copy(src, data, n, exec);
+	}
+
+	// *****************************************************************************
+	//	merge_sort
+	// *****************************************************************************
+
+	// returns the number of elements of a[0..m) among the first k elements of the stable merge of a[0..m) and b[0..n)
+	template <typename T, typename Comp>
+	auto co_rank(std::size_t k, const T* a, std::size_t m, const T* b, std::size_t n, Comp& comp) -> std::size_t
+	{
+		std::size_t lo = (k > n) ? k - n : 0;
+		std::size_t hi = std::min(k, m);
+		while (lo < hi)
+		{
+			std::size_t i = (lo + hi + 1) / 2;
+			if (!comp(b[k - i], a[i - 1])) // a[i-1] precedes b[k-i]
+				lo = i;
+			else
+				hi = i - 1;
+		}
+		return lo;
+	}
+
+	template <typename T, typename Comp, typename Executor>
+	void merge_sort(T* data, std::size_t n, Comp comp, const Executor& exec)
+	{
+		auto nrChunks = GetNrChunks(n, exec.nrThreads);
+		if (nrChunks <= 1)
+		{
+			std::stable_sort(data, data + n, comp);
+			return;
+		}
+
+		chunking chunks(n, nrChunks);
+		exec(nrChunks, [&](std::size_t c)
+			{
+				std::stable_sort(data + chunks.begin(c), data + chunks.end(c), comp);
+			}
+		);
+
+		std::vector<std::size_t> runs;
+		for (std::size_t c = 0; c <= nrChunks; ++c)
+			runs.emplace_back(chunks.begin(c));
+
+		auto buffer = std::make_unique_for_overwrite<T[]>(n);
+		T* src = data;
+		T* dst = buffer.get();
+		std::size_t partSize = std::max<std::size_t>(MIN_CHUNK_SIZE, n / exec.nrThreads);
+
+		struct merge_part { std::size_t first, mid, last, kBegin, kEnd; };
+		std::vector<merge_part> parts;
+		while (runs.size() > 2)
+		{
+			parts.clear();
+			std::vector<std::size_t> mergedRuns;
+			for (std::size_t r = 0; r + 1 < runs.size(); r += 2)
+			{
+				std::size_t first = runs[r], mid = runs[r + 1], last = (r + 2 < runs.size()) ? runs[r + 2] : mid;
+				mergedRuns.emplace_back(first);
+				for (std::size_t k = 0; k < last - first; k += partSize)
+					parts.emplace_back(merge_part{ first, mid, last, k, std::min(k + partSize, last - first) });
+			}
+			mergedRuns.emplace_back(n);
+
+			exec(parts.size(), [&](std::size_t i)
+				{
+					const auto& part = parts[i];
+					const T* a = src + part.first; std::size_t m = part.mid - part.first;
+					const T* b = src + part.mid;   std::size_t bn = part.last - part.mid;
+					std::size_t ia = co_rank(part.kBegin, a, m, b, bn, comp);
+					std::size_t ie = co_rank(part.kEnd, a, m, b, bn, comp);
+					std::merge(a + ia, a + ie, b + (part.kBegin - ia), b + (part.kEnd - ie), dst + part.first + part.kBegin, comp);
+				}
+			);
+			runs = std::move(mergedRuns);
+			std::swap(src, dst);
+		}
+		if (src != data)
+			parallel_copy(src, data, n, exec);
+	}
+
+	// *****************************************************************************
+	//	interface
+	// *****************************************************************************
+
+	// sorts [first, last) of a contiguous sequence; comp must order as DataLessThanCompare for values with radix keys
+	template <typename Iter, typename Comp, typename Executor>
+	void sort(Iter first, Iter last, Comp comp, const Executor& exec)
+	{
+		using value_type = typename std::iterator_traits<Iter>::value_type;
+		std::size_t n = last - first;
+		if (n < MIN_CHUNK_SIZE)
+		{
+			std::stable_sort(first, last, comp);
+			return;
+		}
+		value_type* data = &*first;
+		if constexpr (has_radix_key_v<value_type>)
+		{
+			auto buffer = std::make_unique_for_overwrite<value_type[]>(n);
+			radix_sort(data, buffer.get(), n, [](value_type v) { return radix_key(v); }, exec);
+		}
+		else
+			merge_sort(data, n, comp, exec);
+	}
+
+	// stably sorts the indices in [first, last) of a contiguous sequence on the values they refer to in data
+	// indexComp compares indices; it must order as DataLessThanCompare on the referred values for values with radix keys
+	template <typename IndexIter, typename ConstDataIter, typename IndexComp, typename Executor>
+	void index_sort(IndexIter first, IndexIter last, ConstDataIter data, IndexComp indexComp, const Executor& exec)
+	{
+		using index_type = typename std::iterator_traits<IndexIter>::value_type;
+		using value_type = typename std::iterator_traits<ConstDataIter>::value_type;
+		std::size_t n = last - first;
+		if (n < MIN_CHUNK_SIZE)
+		{
+			std::stable_sort(first, last, indexComp);
+			return;
+		}
+		index_type* indices = &*first;
+		if constexpr (has_radix_key_v<value_type>)
+		{
+			struct keyed_index { radix_key_t<value_type> key; index_type index; };
+			auto keyed  = std::make_unique_for_overwrite<keyed_index[]>(n);
+			auto buffer = std::make_unique_for_overwrite<keyed_index[]>(n);
+
+			chunking chunks(n, GetNrChunks(n, exec.nrThreads));
+			exec(chunks.m_NrChunks, [&](std::size_t c)
+				{
+					for (std::size_t i = chunks.begin(c), e = chunks.end(c); i != e; ++i)
+						keyed[i] = keyed_index{ radix_key<value_type>(data[indices[i]]), indices[i] };
+				}
+			);
+			radix_sort(keyed.get(), buffer.get(), n, [](const keyed_index& ki) { return ki.key; }, exec);
+			exec(chunks.m_NrChunks, [&](std::size_t c)
+				{
+					for (std::size_t i = chunks.begin(c), e = chunks.end(c); i != e; ++i)
+						indices[i] = keyed[i].index;
+				}
+			);
+		}
+		else
+			merge_sort(indices, n, indexComp, exec);
+	}
+
+} // namespace parallel_sort
+
+#endif // __RTC_SET_PARALLELSORT_H
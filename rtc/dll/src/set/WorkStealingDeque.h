@@ -0,0 +1,143 @@
+// Copyright (C) 1998-2026 Object Vision b.v.
+// License: GNU GPL 3
+/////////////////////////////////////////////////////////////////////////////
+
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+File: WorkStealingDeque.h
+Purpose:
+- Lock-free single-owner / multi-thief deque (Chase & Lev, 2005; with the C11 memory orderings of Le, Pop, Cohen & Zappa Nardelli, 2013).
+
+Summary:
+- The owning thread pushes and pops at the bottom (LIFO); any other thread can steal from the top (FIFO).
+- Only the owner may call push and pop; steal can be called concurrently from any thread.
+- The ring buffer grows when full; retired buffers are kept until destruction since thieves may still read from them.
+- Elements must be trivially copyable and default constructible; a default constructed T signals an empty deque.
+*/
+
+#if !defined(__RTC_SET_WORKSTEALINGDEQUE_H)
+#define __RTC_SET_WORKSTEALINGDEQUE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+template <typename T>
+struct work_stealing_deque
+{
+	static_assert(std::is_trivially_copyable_v<T>);
+
+	using index_t = std::int64_t;
+
+	explicit work_stealing_deque(index_t initialCapacity = 64)
+	{
+		auto capacity = index_t(1);
+		while (capacity < initialCapacity)
+			capacity <<= 1;
+		m_Rings.emplace_back(std::make_unique<ring>(capacity));
+		m_Ring.store(m_Rings.back().get(), std::memory_order_relaxed);
+	}
+
+	work_stealing_deque(const work_stealing_deque&) = delete;
+	work_stealing_deque& operator =(const work_stealing_deque&) = delete;
+
+	// owner only
+	void push(T item)
+	{
+		index_t b = m_Bottom.load(std::memory_order_relaxed);
+		index_t t = m_Top.load(std::memory_order_acquire);
+		ring* r = m_Ring.load(std::memory_order_relaxed);
+		if (b - t > r->mask)
+			r = grow(r, t, b);
+		r->put(b, item);
+		std::atomic_thread_fence(std::memory_order_release);
+		m_Bottom.store(b + 1, std::memory_order_relaxed);
+	}
+
+	// owner only; returns the most recently pushed item or T() when empty
+	T pop()
+	{
+		index_t b = m_Bottom.load(std::memory_order_relaxed) - 1;
+		ring* r = m_Ring.load(std::memory_order_relaxed);
+		m_Bottom.store(b, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		index_t t = m_Top.load(std::memory_order_relaxed);
+		if (t > b)
+		{
+			m_Bottom.store(b + 1, std::memory_order_relaxed);
+			return T();
+		}
+		T item = r->get(b);
+		if (t == b)
+		{
+			// last item: race against thieves
+			if (!m_Top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+				item = T();
+			m_Bottom.store(b + 1, std::memory_order_relaxed);
+		}
+		return item;
+	}
+
+	// any thread; returns the least recently pushed item or T() when empty
+	T steal()
+	{
+		index_t t = m_Top.load(std::memory_order_acquire);
+		while (true)
+		{
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			index_t b = m_Bottom.load(std::memory_order_acquire);
+			if (t >= b)
+				return T();
+			ring* r = m_Ring.load(std::memory_order_acquire);
+			T item = r->get(t);
+			if (m_Top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+				return item;
+			// lost the race with another thief or the owner; t now holds the current top
+		}
+	}
+
+	bool empty() const
+	{
+		index_t b = m_Bottom.load(std::memory_order_relaxed);
+		index_t t = m_Top.load(std::memory_order_relaxed);
+		return b <= t;
+	}
+
+private:
+	struct ring
+	{
+		explicit ring(index_t capacity)
+			: mask(capacity - 1)
+			, items(new std::atomic<T>[capacity])
+		{}
+
+		T    get(index_t i) const { return items[i & mask].load(std::memory_order_relaxed); }
+		void put(index_t i, T item) { items[i & mask].store(item, std::memory_order_relaxed); }
+
+		index_t mask;
+		std::unique_ptr<std::atomic<T>[]> items;
+	};
+
+	ring* grow(ring* r, index_t t, index_t b)
+	{
+		auto newRing = std::make_unique<ring>(2 * (r->mask + 1));
+		for (index_t i = t; i != b; ++i)
+			newRing->put(i, r->get(i));
+		r = newRing.get();
+		m_Rings.emplace_back(std::move(newRing)); // keep retired rings alive for thieves that still read from them
+		m_Ring.store(r, std::memory_order_release);
+		return r;
+	}
+
+	alignas(64) std::atomic<index_t> m_Top = 0;
+	alignas(64) std::atomic<index_t> m_Bottom = 0;
+	alignas(64) std::atomic<ring*>   m_Ring = nullptr;
+	std::vector<std::unique_ptr<ring>> m_Rings; // owner only
+};
+
+#endif // __RTC_SET_WORKSTEALINGDEQUE_H
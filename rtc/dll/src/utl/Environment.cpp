@@ -552,7 +552,9 @@ RegDWordAttr s_RegDWordAttrs[] =
 	{ "MemoryFlushThreshold", 80, false},
 	{ "SwapFileMinSize", 0, false },
     { "DrawingSizeInPixels", 0, false },
-	{ "MemoryMaxRAM_GB", 64, false }
+	{ "MemoryMaxRAM_GB", 64, false },
+	{ "CalcCacheMaxSize_GB", 0, false },
+	{ "CalcCacheMinSize_KB", 64, false }
 };
 
 extern "C" RTC_CALL DWORD RTC_GetRegDWord(RegDWordEnum i)
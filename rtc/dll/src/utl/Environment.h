@@ -136,6 +136,8 @@ enum class RegDWordEnum
 	SwapFileMinSize = 1,
 	DrawingSizeInPixels = 2,
 	MemoryRAM_MAX_GB = 3, 
+	CalcCacheMaxSize_GB = 4, // 0 disables the persistent CalcCache
+	CalcCacheMinSize_KB = 5, // smaller results are recalculated rather than restored from the CalcCache, unless they have the StoreData property
 };
 
 extern "C" RTC_CALL DWORD DMS_CONV RTC_GetRegDWord(RegDWordEnum i);
@@ -10,41 +10,87 @@
 
 #include "act/MainThread.h"
 #include "dbg/SeverityType.h"
+#include "geo/MinMax.h"
 #include "mem/FixedAlloc.h"
 #include "utl/MemGuard.h"
 #include "utl/Environment.h"
 
+#include <atomic>
+#include <chrono>
+
 #if defined(WIN32)
 
 #include <windows.h>
 #include <psapi.h>
 
-#endif
+#else //defined(WIN32)
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif //defined(__GLIBC__)
+
+#endif //defined(WIN32)
 
 using percentage_type = UInt32;
 
-#if defined(WIN32)
+//  -----------------------------------------------------------------------
+//  committed bytes
+//  -----------------------------------------------------------------------
+
+// each thread accumulates its allocations and deallocations and only adds them to the shared count per COMMIT_BATCH_SIZE bytes,
+// such that allocations don't contend on a shared atomic; the shared count can lag behind by COMMIT_BATCH_SIZE bytes per thread.
+constexpr Int64 COMMIT_BATCH_SIZE = 1 << 20;
+
+static std::atomic<Int64> s_CommittedBytes = 0;
+static thread_local Int64 t_UncountedCommittedBytes = 0;
+
+static void CountCommittedBytes(Int64 delta)
+{
+	t_UncountedCommittedBytes += delta;
+	if (t_UncountedCommittedBytes >= COMMIT_BATCH_SIZE || t_UncountedCommittedBytes <= -COMMIT_BATCH_SIZE)
+	{
+		s_CommittedBytes.fetch_add(t_UncountedCommittedBytes, std::memory_order_relaxed);
+		t_UncountedCommittedBytes = 0;
+	}
+}
+
+void AddCommittedBytes(SizeT sz) { CountCommittedBytes(Int64(sz)); }
+void SubCommittedBytes(SizeT sz) { CountCommittedBytes(-Int64(sz)); }
+
+// memory can be freed by another thread than the one that allocated it, which can make the shared count temporarily negative
+static Int64 GetCommittedBytesImpl() { return s_CommittedBytes.load(std::memory_order_relaxed); }
+SizeT GetCommittedBytes() { return Max<Int64>(GetCommittedBytesImpl(), 0); }
+
+//  -----------------------------------------------------------------------
+//  memory_info
+//  -----------------------------------------------------------------------
+
 struct memory_info {
-	memory_info() {
-		memStat.dwLength = sizeof(MEMORYSTATUSEX);
-		if (!GlobalMemoryStatusEx(&memStat))
-			throwLastSystemError("GlobalMemoryStatusEx");
-
-		SizeT max_phycical_memory = RTC_GetRegDWord(RegDWordEnum::MemoryRAM_MAX_GB);
-		max_phycical_memory *= (1024 * 1024 * 1024); // GB -> # bytes
-		if (memStat.ullTotalPhys > max_phycical_memory)
+	UInt64 totalPhys = 0; // the memory budget
+	UInt64 availPhys = 0; // the part of the budget that is available
+
+	static memory_info Sample();
+
+	// reduces the budget to MemoryRAM_MAX_GB or another limit, such as the memory.max of a cgroup
+	void Restrict(UInt64 maxPhys, UInt64 availWithinMax)
+	{
+		if (totalPhys > maxPhys)
 		{
-			auto reduction = memStat.ullTotalPhys - max_phycical_memory;
-			memStat.ullTotalPhys -= reduction;
-			memStat.ullAvailPhys -= reduction;
+			auto reduction = totalPhys - maxPhys;
+			totalPhys = maxPhys;
+			availPhys = (availPhys > reduction) ? availPhys - reduction : 0;
 		}
+		MakeMin(availPhys, availWithinMax);
 	}
 
 	percentage_type ExpectedMemoryLoad(std::size_t requestedSize) const
 	{
-		if (requestedSize > memStat.ullTotalPhys)
+		if (requestedSize > totalPhys || totalPhys < 100)
 			return percentage_type(-1);
-		return (requestedSize + memStat.ullTotalPhys - memStat.ullAvailPhys) / (memStat.ullTotalPhys / 100);
+		return (requestedSize + totalPhys - availPhys) / (totalPhys / 100);
 	}
 	percentage_type CurrMemoryLoad() const
 	{
@@ -65,55 +111,259 @@ struct memory_info {
 	bool IsLowOnFreeRAM() const
 	{
 		return !SufficientFreeSpace(0);
-//		return memStat.ullAvailPhys / (memStat.ullTotalPhys / 256) < (256 / 8);
 	}
+};
 
+#if defined(WIN32)
+
+memory_info memory_info::Sample()
+{
 	MEMORYSTATUSEX memStat;
-};
+	memStat.dwLength = sizeof(MEMORYSTATUSEX);
+	if (!GlobalMemoryStatusEx(&memStat))
+		throwLastSystemError("GlobalMemoryStatusEx");
+
+	memory_info result;
+	result.totalPhys = memStat.ullTotalPhys;
+	result.availPhys = memStat.ullAvailPhys;
+	return result;
+}
+
+#else //defined(WIN32)
+
+constexpr UInt64 UNLIMITED_MEMORY = UInt64(-1);
+
+// reads MemTotal and MemAvailable, which includes reclaimable page cache
+static void ReadProcMemInfo(memory_info& info)
+{
+	FILE* f = fopen("/proc/meminfo", "r");
+	if (!f)
+		return;
+	char key[64];
+	unsigned long long valueKB;
+	while (fscanf(f, "%63s %llu kB\n", key, &valueKB) == 2)
+	{
+		if (!strcmp(key, "MemTotal:"))
+			info.totalPhys = UInt64(valueKB) * 1024;
+		else if (!strcmp(key, "MemAvailable:"))
+			info.availPhys = UInt64(valueKB) * 1024;
+	}
+	fclose(f);
+}
+
+static UInt64 ReadCGroupValue(const std::string& fileName)
+{
+	UInt64 result = UNLIMITED_MEMORY;
+	if (FILE* f = fopen(fileName.c_str(), "r"))
+	{
+		unsigned long long value;
+		if (fscanf(f, "%llu", &value) == 1) // "max" indicates no limit
+			result = value;
+		fclose(f);
+	}
+	return result;
+}
+
+static UInt64 ReadCGroupInactiveFile(const std::string& dir)
+{
+	UInt64 result = 0;
+	if (FILE* f = fopen((dir + "/memory.stat").c_str(), "r"))
+	{
+		char key[64];
+		unsigned long long value;
+		while (fscanf(f, "%63s %llu\n", key, &value) == 2)
+			if (!strcmp(key, "inactive_file"))
+			{
+				result = value;
+				break;
+			}
+		fclose(f);
+	}
+	return result;
+}
+
+// the cgroup v2 directory of this process, from the "0::<path>" line of /proc/self/cgroup
+static std::string GetCGroupDirImpl()
+{
+	std::string result;
+	if (FILE* f = fopen("/proc/self/cgroup", "r"))
+	{
+		char line[4096];
+		while (fgets(line, sizeof(line), f))
+			if (!strncmp(line, "0::", 3))
+			{
+				result = line + 3;
+				while (!result.empty() && (result.back() == '\n' || result.back() == '/'))
+					result.pop_back();
+				result = "/sys/fs/cgroup" + result;
+				break;
+			}
+		fclose(f);
+	}
+	return result;
+}
+
+static const std::string& GetCGroupDir()
+{
+	static std::string cgroupDir = GetCGroupDirImpl();
+	return cgroupDir;
+}
+
+// restricts info to the tightest memory.max of the cgroup of this process and its ancestors;
+// used memory excludes the inactive page cache, as the kernel reclaims that before invoking the OOM killer
+static void RestrictToCGroup(memory_info& info)
+{
+	std::string dir = GetCGroupDir();
+	if (dir.empty())
+		return;
+	while (true)
+	{
+		UInt64 maxMem = ReadCGroupValue(dir + "/memory.max");
+		if (maxMem != UNLIMITED_MEMORY)
+		{
+			UInt64 currMem = ReadCGroupValue(dir + "/memory.current");
+			if (currMem == UNLIMITED_MEMORY)
+				currMem = 0;
+			UInt64 inactiveFile = ReadCGroupInactiveFile(dir);
+			UInt64 usedMem = (currMem > inactiveFile) ? currMem - inactiveFile : 0;
+			info.Restrict(maxMem, (maxMem > usedMem) ? maxMem - usedMem : 0);
+		}
+		if (dir.size() <= std::strlen("/sys/fs/cgroup")) // with a cgroup namespace, as in containers, this is the cgroup of the container
+			break;
+		dir.resize(dir.rfind('/'));
+	}
+}
+
+memory_info memory_info::Sample()
+{
+	memory_info result;
+	ReadProcMemInfo(result);
+	RestrictToCGroup(result);
+	return result;
+}
+
+#endif //defined(WIN32)
+
+//  -----------------------------------------------------------------------
+//  sampling of the memory state
+//  -----------------------------------------------------------------------
+
+// IsLowOnFreeRAM is called after each tile task, so it only reads a snapshot of the memory state,
+// which the first caller after each interval refreshes; allocations after the last sample are accounted for by the change in committed bytes.
+constexpr auto MEMORY_SAMPLE_INTERVAL = std::chrono::milliseconds(50);
+
+static std::atomic<std::chrono::steady_clock::rep> s_NextSampleTime = 0;
+
+static std::atomic<UInt64> s_SampledTotalPhys = 0;
+static std::atomic<Int64>  s_SampledAvailPlusCommitted = 0; // availPhys of the last sample + the committed bytes at that time
+
+static void SampleMemoryInfo()
+{
+	memory_info sample = memory_info::Sample();
+	UInt64 maxPhysicalMemory = RTC_GetRegDWord(RegDWordEnum::MemoryRAM_MAX_GB);
+	maxPhysicalMemory *= (1024 * 1024 * 1024); // GB -> # bytes
+	if (maxPhysicalMemory)
+		sample.Restrict(maxPhysicalMemory, sample.availPhys);
+
+	s_SampledAvailPlusCommitted.store(Int64(sample.availPhys) + GetCommittedBytesImpl(), std::memory_order_relaxed);
+	s_SampledTotalPhys.store(sample.totalPhys, std::memory_order_relaxed);
+}
+
+#if defined(__GLIBC__)
+
+// returns the free pages at the top of the heap and of the arenas of all threads to the system when low on memory,
+// at most once per TRIM_INTERVAL_SIZE bytes of net allocation, as malloc_trim locks all arenas.
+constexpr Int64 TRIM_INTERVAL_SIZE = 100000000;
+
+static void ConsiderTrimmingHeap()
+{
+	static std::atomic<Int64> s_CommittedBytesAtLastTrim = 0;
+
+	auto committedBytes = GetCommittedBytesImpl();
+	auto committedBytesAtLastTrim = s_CommittedBytesAtLastTrim.load(std::memory_order_relaxed);
+	if (committedBytes < committedBytesAtLastTrim + TRIM_INTERVAL_SIZE && committedBytes > committedBytesAtLastTrim - TRIM_INTERVAL_SIZE)
+		return;
+	s_CommittedBytesAtLastTrim.store(committedBytes, std::memory_order_relaxed);
+	if (!IsLowOnFreeRAM())
+		return;
+
+	malloc_trim(0);
+	SendMainThreadOper([]
+		{
+			reportD(SeverityTypeID::ST_MinorTrace, "Low on memory: released free heap pages to the system.");
+		}
+	);
+}
+
+#endif //defined(__GLIBC__)
+
+// only the caller that advances s_NextSampleTime takes the sample; the others continue with the previous one
+static void ConsiderSamplingMemoryInfo()
+{
+	auto now = std::chrono::steady_clock::now().time_since_epoch().count();
+	auto nextSampleTime = s_NextSampleTime.load(std::memory_order_relaxed);
+	if (now < nextSampleTime)
+		return;
+	if (!s_NextSampleTime.compare_exchange_strong(nextSampleTime, now + std::chrono::duration_cast<std::chrono::steady_clock::duration>(MEMORY_SAMPLE_INTERVAL).count(), std::memory_order_relaxed))
+		return;
+	try {
+		SampleMemoryInfo();
+#if defined(__GLIBC__)
+		ConsiderTrimmingHeap();
+#endif //defined(__GLIBC__)
+	}
+	catch (...) {} // keep the last sample
+}
+
+memory_info CurrMemoryInfo()
+{
+	static bool s_FirstSampleTaken = (SampleMemoryInfo(), true); // other threads don't continue with an empty sample
+	ConsiderSamplingMemoryInfo();
+
+	memory_info result;
+	result.totalPhys = s_SampledTotalPhys.load(std::memory_order_relaxed);
+	auto availPhys = s_SampledAvailPlusCommitted.load(std::memory_order_relaxed) - GetCommittedBytesImpl();
+	result.availPhys = (availPhys > 0) ? availPhys : 0;
+	return result;
+}
 
 bool SufficientFreeSpace(std::size_t requestedSize) {
-	memory_info info;
-	return info.SufficientFreeSpace(requestedSize);
+	return CurrMemoryInfo().SufficientFreeSpace(requestedSize);
 }
 
 bool IsLowOnFreeRAM() {
-	memory_info info;
-	return info.IsLowOnFreeRAM();
+	return CurrMemoryInfo().IsLowOnFreeRAM();
 }
 
 std::atomic<SizeT> s_CumulativeMemoryAllocCount = 0;
 
-#endif //defined(WIN32)
-
 void ConsiderMakingFreeSpace(SizeT sz)
 {
-#if defined(WIN32)
 	s_CumulativeMemoryAllocCount += sz;
-	if (s_CumulativeMemoryAllocCount >= 100000000) // only check for clean-up after 100MB of cumulative allocation
-	{
-		s_CumulativeMemoryAllocCount = 0;
+	if (s_CumulativeMemoryAllocCount < 100000000) // only check for clean-up after 100MB of cumulative allocation
+		return;
+	s_CumulativeMemoryAllocCount = 0;
+
+	if (SufficientFreeSpace(sz))
+		return;
+
+#if defined(WIN32)
+	// TODO, SEE FROM http://msdn.microsoft.com/query/dev10.query?appId=Dev10IDEF1&l=EN-US&k=k(EMPTYWORKINGSET);k(DevLang-%22C%2B%2B%22);k(TargetOS-WINDOWS)&rd=true
+	// Programs that must run on earlier versions of Windows as well as Windows 7 and later versions should always call this function as K32EmptyWorkingSet. 
+	// To ensure correct resolution of symbols, add Psapi.lib to the TARGETLIBS macro and compile the program with -DPSAPI_VERSION=1. To use run-time dynamic linking, load Psapi.dll.
 
-		if (!SufficientFreeSpace(sz))
+	K32EmptyWorkingSet(GetCurrentProcess());
+	SendMainThreadOper([] 
 		{
-			// TODO, SEE FROM http://msdn.microsoft.com/query/dev10.query?appId=Dev10IDEF1&l=EN-US&k=k(EMPTYWORKINGSET);k(DevLang-%22C%2B%2B%22);k(TargetOS-WINDOWS)&rd=true
-			// Programs that must run on earlier versions of Windows as well as Windows 7 and later versions should always call this function as K32EmptyWorkingSet. 
-			// To ensure correct resolution of symbols, add Psapi.lib to the TARGETLIBS macro and compile the program with -DPSAPI_VERSION=1. To use run-time dynamic linking, load Psapi.dll.
-
-			K32EmptyWorkingSet(GetCurrentProcess());
-			SendMainThreadOper([] 
-				{
-					reportD(SeverityTypeID::ST_MinorTrace, "Calling EmptyWorkingSet to release used pages to the standby status.");
-//					DBG_DebugReport();
-				}
-			);
+			reportD(SeverityTypeID::ST_MinorTrace, "Calling EmptyWorkingSet to release used pages to the standby status.");
+//			DBG_DebugReport();
 		}
-	}
+	);
 #else //defined(WIN32)
 
-	// GNU TODO
+	// on Linux, the sampling of the memory state trims the heap when low on memory, see ConsiderTrimmingHeap
 
 #endif //defined(WIN32)
-
 }
 
 const UInt32 minWaitTime   =  100; // milliseconds
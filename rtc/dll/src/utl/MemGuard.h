@@ -33,10 +33,20 @@ granted by an additional written contract for support, assistance and/or develop
 
 #include "RtcBase.h"
 
+// called by the chunk and page allocators of FixedAlloc.cpp (MG_CACHE_ALLOC); it doesn't wait, but considers making free space
 void WaitForAvailableMemory(std::size_t requestedSize = 0);
 void ConsiderMakingFreeSpace(SizeT sz);
 
+// The memory budget is the minimum of the physical memory, MemoryRAM_MAX_GB and, on Linux, the memory.max of the cgroup (v2) of this process.
+// Memory is low when the budget is loaded beyond MemoryFlushThreshold percent.
 RTC_CALL bool IsLowOnFreeRAM();
+RTC_CALL bool SufficientFreeSpace(std::size_t requestedSize);
+
+// bytes allocated with AllocateFromStock and not yet returned, counted per thread in batches;
+// used to account for allocations since the last sample of the memory state
+void AddCommittedBytes(SizeT sz);
+void SubCommittedBytes(SizeT sz);
+RTC_CALL SizeT GetCommittedBytes();
 
 
 #endif // __RTC_UTL_MEMGUARD_H
@@ -145,6 +145,9 @@ namespace Grid {
 			txr(bufStart.X(), bufSize.X(), tileSize.X()),
 			tyr(bufStart.Y(), bufSize.Y(), tileSize.Y());
 
+		if constexpr (requires { imp.PrepareTiles(txr, tyr); })
+			imp.PrepareTiles(txr, tyr); // implementations may decode the blocks of the tiles/strips together before they are read one by one
+
 		UInt32 tile_wh = tw_aligned*tileSize.Y();
 		UInt32 scanlineSize = imp.GetTileByteWidth();
 
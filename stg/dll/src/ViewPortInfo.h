@@ -41,6 +41,8 @@ granted by an additional written contract for support, assistance and/or develop
 #include "geo/Transform.h"
 #include "geo/Geometry.h"
 
+#include <vector>
+
 typedef long countcolor_t;
 
 template<typename SignedType>
@@ -70,4 +72,44 @@ protected:
 using StgViewPortInfo = ViewPortInfo<Int32>;
 using ClcViewPortInfo = ViewPortInfo<Int64>;
 
+// *****************************************************************************
+// reduced resolution levels, such as GDAL overviews and TIFF pyramids
+// *****************************************************************************
+
+// the index of the coarsest level, given the downsampling factor (in grid cells per level cell) of each level, that still has at least one cell per viewport cell,
+// or -1 if no level is coarser than the grid
+template<typename SignedType>
+SizeT SelectReducedResolutionLevel(const ViewPortInfo<SignedType>& vpi, const std::vector<DPoint>& levelFactors)
+{
+	const Float64 tolerance = 1.0 + 1e-9;
+	DPoint vpiFactor(Abs(vpi.Factor().first), Abs(vpi.Factor().second));
+	SizeT result = -1;
+	Float64 resultFactor = 1.0;
+	for (SizeT i = 0, n = levelFactors.size(); i != n; ++i)
+	{
+		const DPoint& levelFactor = levelFactors[i];
+		if (levelFactor.first <= vpiFactor.first * tolerance && levelFactor.second <= vpiFactor.second * tolerance && levelFactor.first * levelFactor.second > resultFactor)
+		{
+			result = i;
+			resultFactor = levelFactor.first * levelFactor.second;
+		}
+	}
+	return result;
+}
+
+// the viewport info that maps the viewport on the cells of a reduced resolution level with the given downsampling factor instead of on the grid
+template<typename SignedType>
+ViewPortInfo<SignedType> ReducedResolutionViewPort(const ViewPortInfo<SignedType>& vpi, DPoint levelFactor)
+{
+	DPoint factor = vpi.Factor() / levelFactor;
+	DPoint offset = vpi.Offset() / levelFactor;
+	// a level with the exact factor of the viewport is read without scaling
+	if (Abs(factor.first  - 1.0) < 1e-9) factor.first  = 1.0;
+	if (Abs(factor.second - 1.0) < 1e-9) factor.second = 1.0;
+
+	ViewPortInfo<SignedType> result = vpi;
+	static_cast<CrdTransformation&>(result) = CrdTransformation(offset, factor);
+	return result;
+}
+
 #endif // __STGIMPL_VIEWPORTINFO_H
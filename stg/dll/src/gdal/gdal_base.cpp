@@ -29,9 +29,11 @@
 #include "mci/ValueClassID.h"
 #include "utl/Environment.h"
 #include "utl/mySPrintF.h"
+#include "utl/scoped_exit.h"
 #include "utl/splitPath.h"
 
 #include "LockLevels.h"
+#include "Parallel.h"
 
 #include "AbstrDataItem.h"
 #include "DataArray.h"
@@ -1457,6 +1459,7 @@ GDALDatasetHandle Gdal_DoOpenStorage(const StorageMetaInfo& smi, dms_rw_mode rwM
 		value_composition = smi.CurrRD()->GetValueComposition();
 	}
 
+	bool writesCog = rwMode != dms_rw_mode::read_only && (gdalOpenFlags & GDAL_OF_RASTER) && Gdal_WritesCog(gmi);
 	if (rwMode != dms_rw_mode::read_only && (gdalOpenFlags & GDAL_OF_RASTER) && IsDataItem(smi.CurrRI())) // not a container without a domain
 	{
 		auto domainUnit = AsDynamicUnit(smi.StorageHolder());
@@ -1478,15 +1481,19 @@ GDALDatasetHandle Gdal_DoOpenStorage(const StorageMetaInfo& smi, dms_rw_mode rwM
 			nBands = 1;
 
 			eType = gdalRasterDataType(valuesTypeID);
+			if (writesCog)
+				option_array.Clear(); // the user options are for the COG driver; the intermediate GTiff is written uncompressed
 			if (valuesTypeID == ValueClassID::VT_Bool) option_array.AddString("NBITS=1"); // overruling of gdal options
 			if (valuesTypeID == ValueClassID::VT_UInt2) option_array.AddString("NBITS=2");
 			if (valuesTypeID == ValueClassID::VT_UInt4) option_array.AddString("NBITS=3");
-			option_array.AddString("COMPRESS=LZW");
+			option_array.AddString(writesCog ? "COMPRESS=NONE" : "COMPRESS=LZW");
 			option_array.AddString("BIGTIFF=IF_SAFER");
-			option_array.AddString("TFW=YES");
+			if (!writesCog)
+				option_array.AddString("TFW=YES");
 			option_array.AddString("TILED=YES");
 			option_array.AddString("BLOCKXSIZE=256");
 			option_array.AddString("BLOCKYSIZE=256");
+			option_array.AddString(Gdal_NumThreadsOption().c_str()); // compress the written blocks in worker threads
 		}
 	}
 
@@ -1543,6 +1550,11 @@ GDALDatasetHandle Gdal_DoOpenStorage(const StorageMetaInfo& smi, dms_rw_mode rwM
 		throwErrorF("GDAL", "Unable to create directories: %s", path);
 
 	auto driver_short_name = GetDriverShortNameFromDataSourceNameOrDriverArray(data_source_name.c_str(), driver_array);
+	if (writesCog)
+	{
+		driver_short_name = "GTiff";
+		data_source_name = Gdal_CogIntermediateName(data_source_name.c_str());
+	}
 	GDALRegisterTrustedDriverFromKnownDriverShortName(driver_short_name);
 	GDALDriver* driver = nullptr;
 	{
@@ -1617,6 +1629,64 @@ GDALDatasetHandle Gdal_DoOpenStorage(const StorageMetaInfo& smi, dms_rw_mode rwM
 	return result;
 }
 
+// *****************************************************************************
+// Cloud Optimized GeoTIFF
+// *****************************************************************************
+
+bool Gdal_WritesCog(const GdalMetaInfo& gmi)
+{
+	if (!stricmp(gmi.m_Driver.c_str(), "COG"))
+		return true;
+	return GetOptionArray(gmi.m_DriverItem).FindString("COG") != -1;
+}
+
+bool Gdal_UsesOverviews(const GdalMetaInfo& gmi)
+{
+	return CPLTestBool(GetOptionArray(gmi.m_ConfigurationOptions).FetchNameValueDef("GEODMS_USE_OVERVIEWS", "NO"));
+}
+
+auto Gdal_CogIntermediateName(CharPtr dataSourceName) -> SharedStr
+{
+	return SharedStr(dataSourceName) + ".tmp.tif";
+}
+
+auto Gdal_NumThreadsOption() -> SharedStr
+{
+	return mySSPrintF("NUM_THREADS=%u", IsMultiThreaded1() ? MaxConcurrentTreads() : 1);
+}
+
+void Gdal_CopyToCog(GDALDataset* source, CharPtr dataSourceName, CPLStringList creationOptions, const CPLStringList& configurationOptions)
+{
+	assert(source);
+
+	GDAL_ErrorFrame gdal_error_frame;
+	GDAL_ConfigurationOptionsFrame config_frame(configurationOptions);
+
+	GDALRegisterTrustedDriverFromKnownDriverShortName("COG");
+	GDALDriver* cogDriver = nullptr;
+	{
+		leveled_critical_section::scoped_lock lock(gdalComponentImpl::gdalSection);
+		cogDriver = GetGDALDriverManager()->GetDriverByName("COG");
+	}
+	if (!cogDriver)
+		throwErrorF("GDAL", "Cannot find driver COG for %s", dataSourceName);
+
+	if (!creationOptions.FetchNameValue("NUM_THREADS"))
+		creationOptions.AddString(Gdal_NumThreadsOption().c_str());
+	if (!creationOptions.FetchNameValue("RESAMPLING"))
+		if (CharPtr resampling = configurationOptions.FetchNameValue("GEODMS_BUILD_OVERVIEWS"))
+			creationOptions.SetNameValue("RESAMPLING", resampling);
+
+	reportF(SeverityTypeID::ST_MajorTrace, "gdal.grid: writing cloud optimized GeoTIFF %s", dataSourceName);
+	source->FlushCache();
+	GDALDatasetHandle result = cogDriver->CreateCopy(dataSourceName, source, false, creationOptions, GDALDummyProgress, nullptr);
+	if (!result || gdal_error_frame.HasError())
+		throwErrorF("GDAL", "cannot write cloud optimized GeoTIFF %s\n%s"
+			, dataSourceName
+			, gdal_error_frame.GetMsgAndReleaseError().c_str()
+		);
+}
+
 // *****************************************************************************
 
 CrdTransformation GetTransformation(gdal_transform gdalTr)
@@ -233,6 +233,15 @@ private:
 // *****************************************************************************
 GDALDatasetHandle Gdal_DoOpenStorage(const StorageMetaInfo& smi, dms_rw_mode rwMode, UInt32 gdalOpenFlags, bool continueWrite);
 
+// the COG driver can only CreateCopy; a raster written to it is created as an intermediate GTiff that Gdal_CopyToCog copies from its open dataset
+bool Gdal_WritesCog(const GdalMetaInfo& gmi);
+auto Gdal_CogIntermediateName(CharPtr dataSourceName) -> SharedStr;
+auto Gdal_NumThreadsOption() -> SharedStr;
+void Gdal_CopyToCog(GDALDataset* source, CharPtr dataSourceName, CPLStringList creationOptions, const CPLStringList& configurationOptions);
+
+// the gdal.grid overviews and the tif pyramids are only read for viewports coarser than the grid with the configuration option GEODMS_USE_OVERVIEWS=YES
+bool Gdal_UsesOverviews(const GdalMetaInfo& gmi);
+
 
 using gdal_transform = double[6];
 
@@ -27,6 +27,8 @@
 #include "geo/Conversions.h"
 #include "geo/PointOrder.h"
 #include "geo/Round.h"
+#include "utl/MemGuard.h"
+#include "utl/scoped_exit.h"
 #include "xct/DmsException.h"
 #include "cpc/EndianConversions.h"
 
@@ -43,7 +45,221 @@
 #include "mci/ValueClassID.h"
 #include "stg/StorageClass.h"
 
+#include <atomic>
+#include <condition_variable>
+#include <filesystem>
+#include <list>
+#include <map>
+#include <mutex>
+#include <set>
 #include <sstream>
+#include <tuple>
+
+// ------------------------------------------------------------------------
+// gdalGridImpl::BlockReader
+// ------------------------------------------------------------------------
+//
+// The decoded blocks of a raster file, such that a (compressed) block that overlaps with several GeoDMS tiles is decoded once.
+// The tiles of a tiled data item are read concurrently by reader clones of its storage manager (see reader_clone_farm in AbstrDataItem.cpp),
+// which all get the BlockReader of the file from SharedBlockReader; each clone decodes the missing blocks of its tile with its own dataset handle,
+// and waits for the blocks that another clone is decoding.
+// The blocks of all BlockReaders share one budget. A BlockReader is kept by its storage managers between storage handles, as its blocks stay valid
+// as long as the file time doesn't change, and releases its blocks when memory is low, after which the tiles are read directly.
+
+namespace gdalGridImpl {
+
+	const SizeT BLOCK_CACHE_SIZE = SizeT(256) << 20; // in bytes, for the blocks of all BlockReaders together; the least recently used blocks of a reader are released beyond this
+
+	std::atomic<SizeT> s_CachedBlockBytes = 0; // of all BlockReaders
+
+	struct block_key
+	{
+		int          band;  // 0 for the interleaved bands of UInt32 colors
+		int          level; // of the overview, or -1 for the full resolution
+		GDALDataType type;
+		UInt32       x, y;  // position of the block, in blocks
+
+		bool operator < (const block_key& rhs) const { return std::tie(band, level, type, x, y) <  std::tie(rhs.band, rhs.level, rhs.type, rhs.x, rhs.y); }
+		bool operator ==(const block_key& rhs) const { return std::tie(band, level, type, x, y) == std::tie(rhs.band, rhs.level, rhs.type, rhs.x, rhs.y); }
+	};
+
+	struct BlockReader
+	{
+		explicit BlockReader(FileDateTime fileTime)
+			: m_FileTime(fileTime)
+		{}
+
+		~BlockReader()
+		{
+			s_CachedBlockBytes -= m_CachedSize;
+		}
+
+		bool IsFor(FileDateTime fileTime) const { return m_FileTime == fileTime; }
+
+		// copies a decoded block of byteSize bytes; returns false if it isn't available
+		bool CopyBlock(const block_key& key, void* buff, SizeT byteSize)
+		{
+			std::lock_guard lock(m_Mutex);
+			auto blockPtr = m_Blocks.find(key);
+			if (blockPtr == m_Blocks.end() || blockPtr->second.data.size() != byteSize)
+				return false;
+			std::memcpy(buff, blockPtr->second.data.data(), byteSize);
+			m_LruKeys.splice(m_LruKeys.begin(), m_LruKeys, blockPtr->second.lruPtr);
+			return true;
+		}
+
+		// decodes the blocks that are neither available nor being decoded by another reader with readBlock(buff, key) in the calling thread,
+		// and then waits for the blocks that are being decoded by other readers; a block that readBlock fails to read is not inserted and its error is thrown.
+		// When memory is low, it releases all blocks and decodes nothing.
+		template <typename ReadBlockFunc>
+		void Decode(std::vector<block_key> keys, SizeT byteSize, CharPtr fileName, ReadBlockFunc&& readBlock)
+		{
+			if (IsLowOnFreeRAM())
+			{
+				Release();
+				return;
+			}
+			std::sort(keys.begin(), keys.end());
+			keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+			std::vector<block_key> awaitedKeys;
+			{
+				std::lock_guard lock(m_Mutex);
+				std::erase_if(keys, [this, &awaitedKeys](const block_key& key)
+					{
+						if (m_Blocks.contains(key))
+							return true;
+						if (m_DecodingKeys.contains(key))
+						{
+							awaitedKeys.emplace_back(key);
+							return true;
+						}
+						m_DecodingKeys.insert(key);
+						return false;
+					}
+				);
+			}
+			{
+				auto releaseDecodingKeys = make_scoped_exit([this, &keys]()
+					{
+						{
+							std::lock_guard lock(m_Mutex);
+							for (const auto& key : keys)
+								m_DecodingKeys.erase(key);
+						}
+						m_DecodedCV.notify_all();
+					}
+				);
+				for (const auto& key : keys)
+				{
+					std::vector<char> data(byteSize);
+					if (readBlock(data.data(), key) != CE_None)
+						throwErrorF("gdal.grid", "Cannot read block (%u, %u) of %s", key.x, key.y, fileName);
+					Insert(key, std::move(data));
+				}
+			}
+
+			// each reader has decoded its own blocks before it waits, so readers don't wait for each other in a cycle
+			std::unique_lock lock(m_Mutex);
+			m_DecodedCV.wait(lock, [this, &awaitedKeys]()
+				{
+					return std::none_of(awaitedKeys.begin(), awaitedKeys.end(), [this](const block_key& key) { return m_DecodingKeys.contains(key); });
+				}
+			);
+		}
+
+		// releases the decoded blocks
+		void Release()
+		{
+			std::lock_guard lock(m_Mutex);
+			s_CachedBlockBytes -= m_CachedSize;
+			m_CachedSize = 0;
+			m_Blocks.clear();
+			m_LruKeys.clear();
+		}
+
+	private:
+		struct decoded_block
+		{
+			std::vector<char>                data;
+			std::list<block_key>::iterator   lruPtr; // into m_LruKeys
+		};
+
+		// inserts a block as the most recently used one after releasing the least recently used blocks of this that don't fit in the shared budget;
+		// the block isn't kept if it doesn't fit in the budget that the other BlockReaders leave or if memory is low
+		void Insert(const block_key& key, std::vector<char> data)
+		{
+			std::lock_guard lock(m_Mutex);
+			if (m_Blocks.contains(key))
+				return;
+			while (!m_LruKeys.empty() && s_CachedBlockBytes + data.size() > BLOCK_CACHE_SIZE)
+			{
+				auto lruPtr = m_Blocks.find(m_LruKeys.back());
+				assert(lruPtr != m_Blocks.end());
+				m_CachedSize -= lruPtr->second.data.size();
+				s_CachedBlockBytes -= lruPtr->second.data.size();
+				m_Blocks.erase(lruPtr);
+				m_LruKeys.pop_back();
+			}
+			if (s_CachedBlockBytes + data.size() > BLOCK_CACHE_SIZE || !SufficientFreeSpace(data.size()))
+				return;
+
+			m_CachedSize += data.size();
+			s_CachedBlockBytes += data.size();
+			m_LruKeys.emplace_front(key);
+			m_Blocks.emplace(key, decoded_block{ std::move(data), m_LruKeys.begin() });
+		}
+
+		FileDateTime                         m_FileTime;
+		std::mutex                           m_Mutex;
+		std::condition_variable              m_DecodedCV; // notified when blocks are no longer being decoded
+		std::map<block_key, decoded_block>   m_Blocks;
+		std::list<block_key>                 m_LruKeys; // most recently used first
+		std::set<block_key>                  m_DecodingKeys; // by any reader
+		SizeT                                m_CachedSize = 0;
+	};
+
+	std::mutex s_BlockReadersMutex;
+	std::map<SharedStr, std::weak_ptr<BlockReader>> s_BlockReaders; // per file name, of the file time of its last read
+
+	// the BlockReader of the file with the given name and time, shared by all storage managers that read it;
+	// a BlockReader of another file time is replaced
+	auto SharedBlockReader(SharedStr fileName, FileDateTime fileTime) -> std::shared_ptr<BlockReader>
+	{
+		std::lock_guard lock(s_BlockReadersMutex);
+		std::erase_if(s_BlockReaders, [](const auto& entry) { return entry.second.expired(); });
+
+		auto& readerPtr = s_BlockReaders[fileName];
+		auto result = readerPtr.lock();
+		if (!result || !result->IsFor(fileTime))
+		{
+			result = std::make_shared<BlockReader>(fileTime);
+			readerPtr = result;
+		}
+		return result;
+	}
+
+	// builds the power of 2 overview levels of all bands, as a COG has them, until a level fits in one block
+	void BuildInternalOverviews(GDALDataset* hDS, CharPtr resampling)
+	{
+		int blockWidth = 0, blockHeight = 0;
+		hDS->GetRasterBand(1)->GetBlockSize(&blockWidth, &blockHeight);
+		int width = hDS->GetRasterXSize(), height = hDS->GetRasterYSize();
+
+		std::vector<int> levels;
+		for (int level = 2; width > blockWidth * (level / 2) || height > blockHeight * (level / 2); level *= 2)
+			levels.emplace_back(level);
+		if (levels.empty())
+			return;
+
+		reportF(SeverityTypeID::ST_MajorTrace, "gdal.grid: building %d overview levels with %s resampling for %s", levels.size(), resampling, hDS->GetDescription());
+		GDAL_ErrorFrame x;
+		auto resultCode = hDS->BuildOverviews(resampling, int(levels.size()), levels.data(), 0, nullptr, GDALDummyProgress, nullptr);
+		if (resultCode != CE_None || x.HasError())
+			throwErrorF("gdal.grid", "cannot build the overviews of %s\n%s", hDS->GetDescription(), x.GetMsgAndReleaseError().c_str());
+	}
+
+} // namespace gdalGridImpl
 
 // ------------------------------------------------------------------------
 // Implementation of the abstact storagemanager interface
@@ -63,6 +279,19 @@ void GdalGridSM::DoOpenStorage(const StorageMetaInfo& smi, dms_rw_mode rwMode) c
 			, smi.StorageManager()->GetFullName().c_str()
 			, smi.StorageManager()->GetClsName().c_str()
 		);
+	m_IsWriting = (rwMode != dms_rw_mode::read_only);
+	if (m_IsWriting)
+	{
+		const auto& gmi = dynamic_cast<const GdalMetaInfo&>(smi);
+		m_WriteConfigurationOptions = GetOptionArray(gmi.m_ConfigurationOptions);
+		m_WritesCog = Gdal_WritesCog(gmi);
+		if (m_WritesCog)
+		{
+			m_CogCreationOptions = GetOptionArray(gmi.m_OptionsItem);
+			if (!gmi.m_Options.empty())
+				m_CogCreationOptions.AddString(gmi.m_Options.c_str());
+		}
+	}
 	m_hDS = Gdal_DoOpenStorage(smi, rwMode, GDAL_OF_RASTER, false);
 }
 
@@ -71,7 +300,25 @@ void GdalGridSM::DoCloseStorage(bool mustCommit) const
 	DBG_START("GdalGridSM", "DoCloseStorage", true);
 	dms_assert(m_hDS);
 
-	m_hDS = nullptr; // calls GDALClose
+	m_hDS = nullptr; // calls GDALClose; m_BlockReader is kept for the next storage handle
+
+	// the intermediate of a cloud optimized GeoTIFF was copied by CompleteWrite if the write succeeded;
+	// as this is also called from the destructor of StorageCloseHandle, it doesn't throw
+	if (std::exchange(m_IsWriting, false) && m_WritesCog)
+	{
+		std::error_code ec;
+		std::filesystem::remove(Gdal_CogIntermediateName(GetNameStr().c_str()).c_str(), ec);
+	}
+}
+
+// builds the overviews or the cloud optimized GeoTIFF of a written grid, before the storage is closed, such that their errors are thrown by WriteDataItem
+void GdalGridSM::CompleteWrite() const
+{
+	assert(m_IsWriting && m_hDS);
+	if (m_WritesCog)
+		Gdal_CopyToCog(m_hDS, GetNameStr().c_str(), m_CogCreationOptions, m_WriteConfigurationOptions);
+	else if (CharPtr resampling = m_WriteConfigurationOptions.FetchNameValue("GEODMS_BUILD_OVERVIEWS"))
+		gdalGridImpl::BuildInternalOverviews(m_hDS, resampling);
 }
 
 bool GdalGridSM::ReadPalette(AbstrDataObject* ado)
@@ -124,13 +371,15 @@ FileResult GdalGridSM::ReadDataItem(StorageMetaInfoPtr smi, AbstrDataObject* bor
 // ------------------------------------------------------------------------
 
 
-GDalGridImp::GDalGridImp(GDALDataset* hDS, const AbstrDataObject* ado, UPoint viewPortSize, SharedStr sqlBandSpecification, StorageMetaInfoPtr smi)
+GDalGridImp::GDalGridImp(GDALDataset* hDS, const AbstrDataObject* ado, UPoint viewPortSize, SharedStr sqlBandSpecification, StorageMetaInfoPtr smi, gdalGridImpl::BlockReader* blockReader)
 	: m_hDS(hDS)
 	, m_RasterBand(GetRasterBand(sqlBandSpecification))
 	, m_ValueClassID(ado->GetValueClass()->GetValueClassID())
 	, m_ViewPortSize(viewPortSize)
+	, m_BlockReader(blockReader)
 {
 	MG_CHECK(m_RasterBand);
+	m_BandNr = m_RasterBand->GetBand();
 	auto rasterDataType = m_RasterBand->GetRasterDataType();
 	auto valueClass = ado->GetValueClass();
 	auto geoDmsDataType = gdalRasterDataType(valueClass->GetValueClassID(), false);
@@ -292,23 +541,116 @@ CPLErr GDalGridImp::ReadInterleavedMultiBandTile(void* stripBuff, UInt32 tile_x,
 	return resultCode;//resultCode;
 }
 
-SizeT GDalGridImp::ReadTile(void* stripBuff, UInt32 tile_x, UInt32 tile_y, UInt32 strip_y, SizeT tileByteSize) const
+bool GDalGridImp::IsInterleaved() const
+{
+	// interleaved UInt32 four bands of type GDT_Byte
+	return m_RasterBand->GetRasterDataType() == GDT_Byte && m_hDS->GetRasterCount() == 4 && m_ValueClassID == ValueClassID::VT_UInt32;
+}
+
+// reads the block at (tile_x, tile_y) of the band of this, or of the interleaved bands
+CPLErr GDalGridImp::ReadBlock(void* stripBuff, UInt32 tile_x, UInt32 tile_y) const
 {
 	dms_assert(tile_x < GetWidth()); UInt32 sx = Min<UInt32>(GetTileSize().X(), GetWidth() - tile_x);
 	dms_assert(tile_y < GetHeight()); UInt32 sy = Min<UInt32>(GetTileSize().Y(), GetHeight() - tile_y);
-	dms_assert(GetTileByteSize() <= tileByteSize);
+
+	if (IsInterleaved())
+		return ReadInterleavedMultiBandTile(stripBuff, tile_x, tile_y, sx, sy, m_hDS->GetRasterCount());
+	return ReadSingleBandTile(stripBuff, tile_x, tile_y, sx, sy, m_RasterBand);
+}
+
+auto GDalGridImp::BlockKey(UInt32 blockX, UInt32 blockY) const -> gdalGridImpl::block_key
+{
+	return { IsInterleaved() ? 0 : m_BandNr, m_OverviewLevel, gdalRasterDataType(m_ValueClassID), blockX, blockY };
+}
+
+// the downsampling factor of each overview of the band, in cells of the band per cell of the overview
+std::vector<DPoint> GDalGridImp::GetOverviewFactors() const
+{
+	std::vector<DPoint> result;
+	if (IsInterleaved())
+		return result; // the interleaved bands are read from the dataset, which has no overviews
+
+	for (int i = 0, n = m_RasterBand->GetOverviewCount(); i != n; ++i)
+	{
+		auto overview = m_RasterBand->GetOverview(i);
+		if (overview && overview->GetXSize() && overview->GetYSize())
+			result.emplace_back(shp2dms_order<Float64>(Float64(GetWidth()) / overview->GetXSize(), Float64(GetHeight()) / overview->GetYSize()));
+		else
+			result.emplace_back(shp2dms_order<Float64>(1.0, 1.0));
+	}
+	return result;
+}
+
+// reads from the given overview instead of from the band itself
+void GDalGridImp::SetOverviewLevel(int level)
+{
+	assert(m_OverviewLevel == -1);
+	auto overview = m_RasterBand->GetOverview(level);
+	MG_CHECK(overview);
+	m_RasterBand = overview;
+	m_OverviewLevel = level;
+}
+
+// builds the overviews with the power of 2 factors up to maxFactor that the band doesn't have yet, with the given GDAL resampling method;
+// as the dataset is opened read-only, GDAL writes them to a .ovr sidecar file
+void GDalGridImp::BuildOverviews(CharPtr resampling, Float64 maxFactor)
+{
+	assert(m_OverviewLevel == -1);
+	std::vector<int> levels;
+	auto existingFactors = GetOverviewFactors();
+	for (int level = 2; level <= maxFactor; level *= 2)
+		if (std::none_of(existingFactors.begin(), existingFactors.end(), [level](DPoint f) { return int(f.X() + 0.5) == level; }))
+			levels.emplace_back(level);
+	if (levels.empty())
+		return;
+
+	reportF(SeverityTypeID::ST_MajorTrace, "gdal.grid: building %d overview levels with %s resampling for %s", levels.size(), resampling, m_hDS->GetDescription());
+	GDAL_ErrorFrame x;
+	int bandNr = m_BandNr;
+	auto resultCode = m_hDS->BuildOverviews(resampling, int(levels.size()), levels.data(), 1, &bandNr, GDALDummyProgress, nullptr);
+	if (resultCode != CE_None || x.HasError())
+		throwErrorF("gdal.grid", "cannot build the overviews of %s\n%s", m_hDS->GetDescription(), x.GetMsgAndReleaseError().c_str());
+}
+
+// decodes the blocks of the tiles/strips in the ranges txr and tyr into the BlockReader, from which ReadTile copies them
+void GDalGridImp::PrepareTiles(const Grid::TileCount& txr, const Grid::TileCount& tyr) const
+{
+	if (!m_BlockReader)
+		return;
 
 	UPoint tileSize = GetTileSize();
-	auto resultCode = CE_None;
-	auto nBandCount = m_hDS->GetRasterCount();
-	auto bandType = m_RasterBand->GetRasterDataType();
+	std::vector<gdalGridImpl::block_key> keys;
+	for (UInt32 ty = 0; ty != tyr.t_cnt; ++ty)
+		for (UInt32 tx = 0; tx != txr.t_cnt; ++tx)
+			if (txr.t_min + Int32(tx) >= 0 && tyr.t_min + Int32(ty) >= 0)
+			{
+				UInt32 blockX = txr.t_min + tx, blockY = tyr.t_min + ty;
+				if (UInt64(blockX) * tileSize.X() < GetWidth() && UInt64(blockY) * tileSize.Y() < GetHeight())
+					keys.emplace_back(BlockKey(blockX, blockY));
+			}
+	if (keys.empty())
+		return;
 
-	if (bandType == GDT_Byte && nBandCount == 4 && m_ValueClassID == ValueClassID::VT_UInt32) // interleaved UInt32 four bands of type GDT_Byte
-		resultCode = ReadInterleavedMultiBandTile(stripBuff, tile_x, tile_y, sx, sy, nBandCount);
-	else // single band
-		resultCode = ReadSingleBandTile(stripBuff, tile_x, tile_y, sx, sy, m_RasterBand);
+	m_BlockReader->Decode(std::move(keys), GetTileByteSize(), m_hDS->GetDescription(), [this, tileSize](void* buff, const gdalGridImpl::block_key& key)
+		{
+			return ReadBlock(buff, key.x * tileSize.X(), key.y * tileSize.Y());
+		}
+	);
+}
 
-	dms_assert(resultCode == CE_None);
+SizeT GDalGridImp::ReadTile(void* stripBuff, UInt32 tile_x, UInt32 tile_y, UInt32 strip_y, SizeT tileByteSize) const
+{
+	dms_assert(GetTileByteSize() <= tileByteSize);
+
+	if (m_BlockReader)
+	{
+		UPoint tileSize = GetTileSize();
+		if (m_BlockReader->CopyBlock(BlockKey(tile_x / tileSize.X(), tile_y / tileSize.Y()), stripBuff, GetTileByteSize()))
+			return GetTileByteSize();
+	}
+
+	if (ReadBlock(stripBuff, tile_x, tile_y) != CE_None)
+		throwErrorF("gdal.grid", "Cannot read the block at (%u, %u) of %s", tile_x, tile_y, m_hDS->GetDescription());
 	return GetTileByteSize();
 }
 
@@ -420,19 +762,61 @@ void GDalGridImp::SetTiled()
 //		TIFFSetField(m_TiffHandle, TIFFTAG_TILELENGTH, UInt32(256));
 }
 
+auto GdalGridSM::BlockReader(const StorageMetaInfo& smi) const -> gdalGridImpl::BlockReader*
+{
+	FileDateTime fileTime = GetCachedChangeDateTime(smi.StorageHolder(), "");
+	if (!m_BlockReader || !m_BlockReader->IsFor(fileTime))
+		m_BlockReader = gdalGridImpl::SharedBlockReader(GetNameStr(), fileTime);
+	return m_BlockReader.get();
+}
+
+// For a viewport that is coarser than the grid, the coarsest overview that still has a cell per viewport cell is read instead of the grid.
+// This is opted into with the configuration option GEODMS_USE_OVERVIEWS=YES of the storage (see Gdal_UsesOverviews),
+// which can be combined with GEODMS_BUILD_OVERVIEWS=<GDAL resampling method> to first build the missing overviews up to the factor of the viewport.
+auto GdalGridSM::SelectOverview(GDalGridImp& imp, const StgViewPortInfo& vpi, const StorageMetaInfo& smi) const -> StgViewPortInfo
+{
+	Float64 vpiFactor = Min(Abs(vpi.Factor().X()), Abs(vpi.Factor().Y()));
+	if (vpiFactor < 2.0 || imp.IsInterleaved())
+		return vpi;
+
+	const auto& gmi = dynamic_cast<const GdalMetaInfo&>(smi);
+	if (!Gdal_UsesOverviews(gmi))
+		return vpi;
+
+	auto configurationOptions = GetOptionArray(gmi.m_ConfigurationOptions);
+
+	auto levelFactors = imp.GetOverviewFactors();
+	auto level = SelectReducedResolutionLevel(vpi, levelFactors);
+	if (CharPtr resampling = configurationOptions.FetchNameValue("GEODMS_BUILD_OVERVIEWS"))
+		if (level == -1 || 2.0 * levelFactors[level].X() <= vpiFactor)
+		{
+			imp.BuildOverviews(resampling, vpiFactor);
+			BlockReader(smi)->Release(); // the levels of its blocks may now refer to other overviews
+			levelFactors = imp.GetOverviewFactors();
+			level = SelectReducedResolutionLevel(vpi, levelFactors);
+		}
+	if (level == -1)
+		return vpi;
+
+	imp.SetOverviewLevel(level);
+	return ReducedResolutionViewPort(vpi, levelFactors[level]);
+}
+
 void GdalGridSM::ReadGridData(StgViewPortInfo& vpi, AbstrDataObject* ado, tile_id t, SharedStr sqlBandSpecification, StorageMetaInfoPtr smi)
 {
 	MG_CHECK(m_hDS->GetRasterCount() >=  1 );
 
 	GDalGridImp imp(m_hDS, ado, Size(vpi.GetViewPortExtents()), sqlBandSpecification, smi);
-	Grid::ReadGridData(imp, vpi, ado, t, GetNameStr().c_str());
+	auto readVpi = SelectOverview(imp, vpi, *smi);
+	imp.SetBlockReader(BlockReader(*smi));
+	Grid::ReadGridData(imp, readVpi, ado, t, GetNameStr().c_str());
 }
 
 void GdalGridSM::ReadGridCounts(StgViewPortInfo& vpi, AbstrDataObject* ado, tile_id t, SharedStr sqlBandSpecification, StorageMetaInfoPtr smi)
 {
 	MG_CHECK(m_hDS->GetRasterCount() >= 1);
 
-	GDalGridImp imp(m_hDS, ado, Size(vpi.GetViewPortExtents()), sqlBandSpecification, smi);
+	GDalGridImp imp(m_hDS, ado, Size(vpi.GetViewPortExtents()), sqlBandSpecification, smi, BlockReader(*smi));
 	Grid::ReadGridCounts(imp, vpi, ado, t, GetNameStr().c_str());
 }
 
@@ -462,6 +846,7 @@ FileResult GdalGridSM::WriteDataItem(StorageMetaInfoPtr&& smi)
 	ViewPortInfoProvider vpip(storageHolder, adi.get(), false, true);
 
 	Grid::WriteGridData(imp, vpip.GetViewportInfoEx(no_tile, storageHandle.MetaInfo()), storageHolder, adi.get(), adi->GetCurrRefObj()->GetValuesType(), GetNameStr().c_str());
+	CompleteWrite();
 	return {};
 }
 
@@ -13,7 +13,11 @@
 #include "gdal/gdal_base.h"
 #include "GridStorageManager.h"
 
+#include <memory>
+
 class  GDALDataset;
+class  GDalGridImp;
+namespace gdalGridImpl { struct BlockReader; struct block_key; }
 
 // *****************************************************************************
 
@@ -42,8 +46,14 @@ private:
 	void ReadGridCounts(StgViewPortInfo& vip, AbstrDataObject* ado, tile_id t, SharedStr sqlBandSpecification, StorageMetaInfoPtr smi);
 	bool ReadPalette(AbstrDataObject* adi);
 //	void WriteGridData(const TreeItem* storageHolder, const AbstrDataItem* adi);
+	auto BlockReader(const StorageMetaInfo& smi) const -> gdalGridImpl::BlockReader*;
+	auto SelectOverview(GDalGridImp& imp, const StgViewPortInfo& vpi, const StorageMetaInfo& smi) const -> StgViewPortInfo;
+	void CompleteWrite() const;
 
 	mutable GDALDatasetHandle m_hDS;
+	mutable std::shared_ptr<gdalGridImpl::BlockReader> m_BlockReader; // of the file, shared with the other storage managers that read it and kept between storage handles
+	mutable CPLStringList m_WriteConfigurationOptions, m_CogCreationOptions; // of the storage opened for writing, completed by CompleteWrite
+	mutable bool m_IsWriting = false, m_WritesCog = false;
 	//mutable DataItemsWriteStatusInfo m_DataItemsWriteStatus;
 
 	DECL_RTTI(STGDLL_CALL, StorageClass)
@@ -74,7 +84,14 @@ struct GDAL_SimpleReader : gdalComponent
 
 class GDalGridImp {
 public:
-	GDalGridImp(GDALDataset* hDS, const AbstrDataObject* ado, UPoint viewPortSize, SharedStr sqlBandSpecification, StorageMetaInfoPtr smi);
+	GDalGridImp(GDALDataset* hDS, const AbstrDataObject* ado, UPoint viewPortSize, SharedStr sqlBandSpecification, StorageMetaInfoPtr smi, gdalGridImpl::BlockReader* blockReader = nullptr);
+	void PrepareTiles(const Grid::TileCount& txr, const Grid::TileCount& tyr) const;
+	void SetBlockReader(gdalGridImpl::BlockReader* blockReader) { m_BlockReader = blockReader; }
+	CPLErr ReadBlock(void* stripBuff, UInt32 tile_x, UInt32 tile_y) const;
+	bool   IsInterleaved() const;
+	std::vector<DPoint> GetOverviewFactors() const;
+	void SetOverviewLevel(int level);
+	void BuildOverviews(CharPtr resampling, Float64 maxFactor);
 	SizeT ReadTile(void* stripBuff, UInt32 tile_x, UInt32 tile_y, UInt32 strip_y, SizeT tileByteSize) const;
 	Int32 WriteTile(void* stripBuff, UInt32 tile_x, UInt32 tile_y);
 	void UnpackCheck(UInt32 nrDmsBitsPerPixel, UInt32 nrRasterBitsPerPixel, CharPtr functionName, CharPtr direction, CharPtr dataSourceName) const;
@@ -108,11 +125,15 @@ private:
 	std::vector<GDALRasterBand*> GetRasterBands(SharedStr sqlBandSpecification);
 	CPLErr ReadSingleBandTile(void* stripBuff, UInt32 tile_x, UInt32 tile_y, UInt32 sx, UInt32 sy, GDALRasterBand* poBand) const;
 	CPLErr ReadInterleavedMultiBandTile(void* stripBuff, UInt32 tile_x, UInt32 tile_y, UInt32 sx, UInt32 sy, UInt32 nBandCount) const;
+	auto   BlockKey(UInt32 blockX, UInt32 blockY) const -> gdalGridImpl::block_key;
 
 	GDALDataset*    m_hDS;
 	GDALRasterBand* m_RasterBand;
+	int             m_BandNr;
+	int             m_OverviewLevel = -1;
 	UPoint          m_ViewPortSize;
 	ValueClassID    m_ValueClassID;
+	gdalGridImpl::BlockReader* m_BlockReader;
 };
 
 #endif // __STG_GDAL_GRID_H
\ No newline at end of file
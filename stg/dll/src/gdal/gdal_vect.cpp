@@ -8,6 +8,9 @@
 #pragma hdrstop
 #endif //defined(CC_PRAGMAHDRSTOP)
 
+#include <list>
+#include <string>
+
 #include "gdal_base.h"
 #include "gdal_vect.h"
 
@@ -27,6 +30,7 @@
 #include "ser/FormattedStream.h"
 #include "utl/mySPrintF.h"
 #include "utl/encodes.h"
+#include "utl/scoped_exit.h"
 #include "xct/DmsException.h"
 
 #include "ParallelTiles.h"
@@ -172,6 +176,273 @@ namespace gdalVectImpl {
 		return ValueComposition::Unknown;
 	}
 
+	// *****************************************************************************
+	//
+	// ArrowLayerCache: the record batches of a layer, read in one scan with OGRLayer::GetArrowStream,
+	// from which the attributes and geometry of all its data items are read; see the Arrow C data interface.
+	// The scan only includes the fields of the data items with interest, and is kept between the storage handles of these items
+	// until each of its columns has been read for all rows, such that a layer with many attributes isn't scanned once per attribute;
+	// as the record batches of the driver may refer to the dataset, a copy of the columns that are still to be read is kept when the dataset is closed
+	//
+	// *****************************************************************************
+
+	// the values of a column in a record batch
+	struct arrow_column
+	{
+		const ArrowArray* m_Array;
+		SizeT             m_Offset;
+
+		bool IsValid(SizeT i) const
+		{
+			auto validity = static_cast<const UInt8*>(m_Array->buffers[0]);
+			if (!validity || !m_Array->null_count)
+				return true;
+			i += m_Offset;
+			return validity[i / 8] & (1 << (i % 8));
+		}
+		bool Bit(SizeT i) const
+		{
+			i += m_Offset;
+			return static_cast<const UInt8*>(m_Array->buffers[1])[i / 8] & (1 << (i % 8));
+		}
+		template <typename V>
+		V Value(SizeT i) const
+		{
+			return static_cast<const V*>(m_Array->buffers[1])[m_Offset + i];
+		}
+		// the (large) utf8 and binary formats have offsets of type O
+		template <typename O>
+		CharPtrRange Bytes(SizeT i) const
+		{
+			auto offsets = static_cast<const O*>(m_Array->buffers[1]) + m_Offset + i;
+			auto data = static_cast<CharPtr>(m_Array->buffers[2]);
+			return CharPtrRange(data + offsets[0], data + offsets[1]);
+		}
+	};
+
+	struct ArrowLayerCache
+	{
+		ArrowLayerCache(TokenID layerID, SharedStr sqlString, FileDateTime fileTime)
+			: m_LayerID(layerID), m_SqlString(std::move(sqlString)), m_FileTime(fileTime)
+		{}
+		ArrowLayerCache(const ArrowLayerCache&) = delete;
+
+		~ArrowLayerCache()
+		{
+			for (auto& batch : m_Batches)
+				if (batch.release)
+					batch.release(&batch);
+			if (m_Schema.release)
+				m_Schema.release(&m_Schema);
+		}
+
+		bool IsFor(TokenID layerID, const SharedStr& sqlString, FileDateTime fileTime) const { return m_LayerID == layerID && m_SqlString == sqlString && m_FileTime == fileTime; }
+
+		bool HasItem(CharPtr itemName) const
+		{
+			return std::any_of(m_ItemNames.begin(), m_ItemNames.end(), [itemName](const SharedStr& name) { return !stricmp(name.c_str(), itemName); });
+		}
+
+		SizeT NrRows() const { return m_BatchEnds.empty() ? 0 : m_BatchEnds.back(); }
+		CharPtr Format(SizeT column) const { return m_Schema.children[column]->format; }
+
+		// the column of a field with the given item name, or -1
+		SizeT FindColumn(CharPtr itemName) const
+		{
+			for (SizeT c = 0, n = m_Schema.n_children; c != n; ++c)
+			{
+				CharPtr name = m_Schema.children[c]->name;
+				if (c != m_GeometryColumn && !stricmp(itemName, as_item_name(name, name + StrLen(name)).c_str()))
+					return c;
+			}
+			return -1;
+		}
+
+		bool IsRead(SizeT column) const { return column < m_RowsRead.size() && m_RowsRead[column] >= NrRows(); }
+
+		// registers that size rows of a column have been read; returns true when all columns have been read for all rows
+		bool MarkRead(SizeT column, SizeT size)
+		{
+			if (m_RowsRead.size() != m_Schema.n_children)
+				m_RowsRead.assign(m_Schema.n_children, 0);
+			m_RowsRead[column] += size;
+			return std::all_of(m_RowsRead.begin(), m_RowsRead.end(), [nrRows = NrRows()](SizeT rowsRead) { return rowsRead >= nrRows; });
+		}
+
+		// calls func(column, first, last, dataIndex) for the rows [first, last) of each batch that overlaps with the rows [firstRow, firstRow + size),
+		// with dataIndex the position of first relative to firstRow; rows beyond NrRows() are not visited
+		template <typename Func>
+		void ForEachBatch(SizeT column, SizeT firstRow, SizeT size, Func&& func) const
+		{
+			SizeT lastRow = Min<SizeT>(firstRow + size, NrRows());
+			SizeT b = std::upper_bound(m_BatchEnds.begin(), m_BatchEnds.end(), firstRow) - m_BatchEnds.begin();
+			for (SizeT row = firstRow; row < lastRow; ++b)
+			{
+				SizeT batchBegin = b ? m_BatchEnds[b - 1] : 0;
+				SizeT batchEnd = Min<SizeT>(m_BatchEnds[b], lastRow);
+				const ArrowArray& batch = m_Batches[b];
+				arrow_column col{ batch.children[column], SizeT(batch.offset + batch.children[column]->offset) };
+				func(col, row - batchBegin, batchEnd - batchBegin, row - firstRow);
+				row = batchEnd;
+			}
+		}
+
+		// true if the schema and record batches are those of the driver, which may refer to the dataset, rather than a copy
+		bool RefersToDriver() const { return m_Schema.release != nullptr; }
+
+		// a copy of the schema and of the record batches of the columns that are still to be read, which doesn't refer to the memory of the driver;
+		// the other columns are left out as columns of the null format and marked as read, such that they are read feature by feature if requested again
+		std::unique_ptr<ArrowLayerCache> CopyUnreadColumns() const
+		{
+			auto result = std::make_unique<ArrowLayerCache>(m_LayerID, m_SqlString, m_FileTime);
+			result->m_IsAvailable = m_IsAvailable;
+			result->m_ItemNames   = m_ItemNames;
+			result->m_HasGeometry = m_HasGeometry;
+			result->m_BatchEnds   = m_BatchEnds;
+			if (!m_IsAvailable)
+				return result;
+
+			SizeT nrColumns = m_Schema.n_children;
+			std::vector<bool> isCopied(nrColumns);
+			result->m_RowsRead.assign(nrColumns, NrRows());
+			for (SizeT c = 0; c != nrColumns; ++c)
+			{
+				isCopied[c] = !IsRead(c) && IsCopyableFormat(Format(c));
+				if (isCopied[c])
+					result->m_RowsRead[c] = c < m_RowsRead.size() ? m_RowsRead[c] : 0;
+			}
+			if (m_GeometryColumn != -1 && isCopied[m_GeometryColumn])
+				result->m_GeometryColumn = m_GeometryColumn;
+
+			auto& copy = result->m_Copy;
+			copy.m_Names.reserve(nrColumns);
+			copy.m_Formats.reserve(nrColumns);
+			copy.m_Fields.resize(nrColumns);
+			for (SizeT c = 0; c != nrColumns; ++c)
+			{
+				copy.m_Names.emplace_back(m_Schema.children[c]->name);
+				copy.m_Formats.emplace_back(isCopied[c] ? Format(c) : "n");
+				copy.m_Fields[c] = ArrowSchema{ copy.m_Formats.back().c_str(), copy.m_Names.back().c_str() };
+				copy.m_FieldPtrs.emplace_back(&copy.m_Fields[c]);
+			}
+			result->m_Schema = ArrowSchema{ "+s" };
+			result->m_Schema.n_children = nrColumns;
+			result->m_Schema.children = copy.m_FieldPtrs.data();
+
+			copy.m_Columns.resize(m_Batches.size());
+			copy.m_ColumnPtrs.resize(m_Batches.size());
+			for (SizeT b = 0; b != m_Batches.size(); ++b)
+			{
+				const ArrowArray& batch = m_Batches[b];
+				auto& columns = copy.m_Columns[b];
+				columns.resize(nrColumns);
+				for (SizeT c = 0; c != nrColumns; ++c)
+				{
+					copy.m_ColumnPtrs[b].emplace_back(&columns[c]);
+					if (!isCopied[c])
+						continue;
+					const ArrowArray& column = *batch.children[c];
+					// the rows that arrow_column can access
+					SizeT nrElems = batch.offset + column.offset + batch.length;
+					CharPtr format = Format(c);
+					auto& bufferPtrs = copy.m_BufferPtrs.emplace_back();
+					auto copyBuffer = [&copy, &bufferPtrs](const void* buffer, SizeT nrBytes)
+						{
+							if (!buffer)
+							{
+								bufferPtrs.emplace_back(nullptr);
+								return;
+							}
+							auto bytes = static_cast<const UInt8*>(buffer);
+							bufferPtrs.emplace_back(copy.m_Buffers.emplace_back(bytes, bytes + nrBytes).data());
+						};
+					copyBuffer(column.buffers[0], (nrElems + 7) / 8);
+					if (SizeT nrBits = FixedWidthBits(format[0]))
+						copyBuffer(column.buffers[1], (nrElems * nrBits + 7) / 8);
+					else
+					{
+						bool isLarge = (format[0] == 'U' || format[0] == 'Z');
+						SizeT offsetSize = isLarge ? sizeof(Int64) : sizeof(Int32);
+						SizeT nrDataBytes = isLarge ? SizeT(static_cast<const Int64*>(column.buffers[1])[nrElems]) : SizeT(static_cast<const Int32*>(column.buffers[1])[nrElems]);
+						copyBuffer(column.buffers[1], (nrElems + 1) * offsetSize);
+						copyBuffer(column.buffers[2], nrDataBytes);
+					}
+					columns[c] = ArrowArray{ column.length, column.null_count, column.offset, Int64(bufferPtrs.size()), 0, bufferPtrs.data() };
+				}
+				ArrowArray& batchCopy = result->m_Batches.emplace_back(ArrowArray{ batch.length, 0, batch.offset });
+				batchCopy.n_children = nrColumns;
+				batchCopy.children = copy.m_ColumnPtrs[b].data();
+			}
+			return result;
+		}
+
+		TokenID                 m_LayerID;
+		SharedStr               m_SqlString;
+		FileDateTime            m_FileTime;
+		bool                    m_IsAvailable = false; // false if the layer has no Arrow stream, such that its features are read one by one
+		std::vector<SharedStr>  m_ItemNames;           // of the data items whose fields were scanned
+		bool                    m_HasGeometry = false;
+		ArrowSchema             m_Schema = {};
+		std::vector<ArrowArray> m_Batches;
+		std::vector<SizeT>      m_BatchEnds;           // the number of rows in the batches up to and including each batch
+		std::vector<SizeT>      m_RowsRead;            // per column
+		SizeT                   m_GeometryColumn = -1; // with WKB
+
+		// the memory to which m_Schema and m_Batches of a copy refer
+		struct copied_data
+		{
+			std::vector<std::string>               m_Names, m_Formats; // reserved for all columns, such that their c_str()s remain valid
+			std::vector<ArrowSchema>               m_Fields;
+			std::vector<ArrowSchema*>              m_FieldPtrs;
+			std::vector<std::vector<UInt8>>        m_Buffers;
+			std::list<std::vector<const void*>>    m_BufferPtrs;   // per copied column of each batch
+			std::vector<std::vector<ArrowArray>>   m_Columns;      // per batch
+			std::vector<std::vector<ArrowArray*>>  m_ColumnPtrs;   // per batch
+		};
+		copied_data             m_Copy;
+
+	private:
+		// the fixed width formats and the (large) utf8 and binary formats, as read by ReadArrowNumbers, ReadArrowStrings and ArrowGeometrySource
+		static bool IsCopyableFormat(CharPtr format)
+		{
+			return format[0] && !format[1] && (FixedWidthBits(format[0]) || strchr("uUzZ", format[0]));
+		}
+		static SizeT FixedWidthBits(char format)
+		{
+			switch (format)
+			{
+				case 'b': return 1;
+				case 'c': case 'C': return 8;
+				case 's': case 'S': return 16;
+				case 'i': case 'I': case 'f': return 32;
+				case 'l': case 'L': case 'g': return 64;
+			}
+			return 0;
+		}
+	};
+
+	// true for binary columns with an ogc.wkb or geoarrow.wkb extension in their metadata
+	bool IsWkbColumn(const ArrowSchema* schema)
+	{
+		if (strcmp(schema->format, "z") && strcmp(schema->format, "Z"))
+			return false;
+		CharPtr metadata = schema->metadata;
+		if (!metadata)
+			return false;
+
+		auto readInt32 = [&metadata]() { Int32 result; std::memcpy(&result, metadata, sizeof(Int32)); metadata += sizeof(Int32); return result; };
+		for (Int32 n = readInt32(); n; --n)
+		{
+			Int32 keyLen = readInt32();
+			std::string_view key(metadata, keyLen); metadata += keyLen;
+			Int32 valueLen = readInt32();
+			std::string_view value(metadata, valueLen); metadata += valueLen;
+			if (key == "ARROW:extension:name" && (value == "ogc.wkb" || value == "geoarrow.wkb"))
+				return true;
+		}
+		return false;
+	}
+
 }	// namespace gdal2VectImpl
 
 // ------------------------------------------------------------------------
@@ -412,6 +683,11 @@ void GdalVectSM::DoOpenStorage(const StorageMetaInfo& smi, dms_rw_mode rwMode) c
 			,	smi.StorageManager()->GetClsName().c_str()
 			);
 
+	if (rwMode != dms_rw_mode::read_only)
+	{
+		m_ArrowLayerCache.reset();
+		m_KeptArrowLayerCache.reset();
+	}
 	m_hDS = Gdal_DoOpenStorage(smi, rwMode, GDAL_OF_VECTOR, m_DataItemsStatusInfo.m_continueWrite);
 }
 
@@ -421,6 +697,11 @@ void GdalVectSM::DoCloseStorage(bool mustCommit) const
 	assert(!m_CriticalSection.try_acquire()); // must already be locked by caller
 	assert(m_hDS);
 
+	// the record batches of the driver may refer to the dataset and are released before it;
+	// a copy of the columns that are still to be read is kept for the storage handles of the next data items
+	if (m_ArrowLayerCache)
+		m_KeptArrowLayerCache = m_ArrowLayerCache->RefersToDriver() ? m_ArrowLayerCache->CopyUnreadColumns() : std::move(m_ArrowLayerCache);
+	m_ArrowLayerCache.reset();
 	m_hDS = nullptr; // calls GDALClose through GDALDatasetHandle::deleter
 }
 
@@ -708,11 +989,32 @@ OGRFeature* GetNextFeatureInterleaved(OGRLayer* layer, WeakPtr<GDALDataset> hDS)
 	return nextFeature;
 }
 
-template <typename PointType>
-void ReadPointData(typename sequence_traits<PointType>::seq_t data, OGRLayer* layer, SizeT firstIndex, SizeT size, GDALDataset* hDS)
+// provides the geometry of the next feature of a layer with Next(), which remains valid until the next call
+struct FeatureGeometrySource
 {
-	assert(layer);
+	FeatureGeometrySource(OGRLayer* layer, GDALDataset* hDS)
+		: m_Layer(layer), m_hDS(hDS), m_IsInterleaved(hDS->TestCapability(ODsCRandomLayerRead))
+	{
+		assert(layer);
+	}
+
+	OGRGeometry* Next()
+	{
+		gdalVectImpl::FeaturePtr feat = m_IsInterleaved ? GetNextFeatureInterleaved(m_Layer, m_hDS) : m_Layer->GetNextFeature();
+		m_Feature.swap(feat);
+		return m_Feature ? m_Feature->GetGeometryRef() : nullptr;
+	}
 
+private:
+	OGRLayer*                m_Layer;
+	GDALDataset*             m_hDS;
+	bool                     m_IsInterleaved;
+	gdalVectImpl::FeaturePtr m_Feature { nullptr };
+};
+
+template <typename PointType, typename GeometrySource>
+void ReadPointData(typename sequence_traits<PointType>::seq_t data, GeometrySource& source, SizeT firstIndex, SizeT size)
+{
 	DBG_START("ReadPointData", typeid(PointType).name(), true);
 
 	SizeT numPoints = 0;
@@ -728,15 +1030,13 @@ void ReadPointData(typename sequence_traits<PointType>::seq_t data, OGRLayer* la
 	{
 		typename DataArray<PointType>::reference dataElemRef = data[i];
 
-		gdalVectImpl::FeaturePtr feat = hDS->TestCapability(ODsCRandomLayerRead) ? GetNextFeatureInterleaved(layer, hDS) : layer->GetNextFeature();
-		if (feat)
-			if (OGRGeometry* geo = feat->GetGeometryRef())
-				if (OGRPoint* point = dynamic_cast<OGRPoint*>(geo))
-				{
-					dataElemRef.X() = point->getX();
-					dataElemRef.Y() = point->getY();
-					continue;
-				}
+		if (OGRGeometry* geo = source.Next())
+			if (OGRPoint* point = dynamic_cast<OGRPoint*>(geo))
+			{
+				dataElemRef.X() = point->getX();
+				dataElemRef.Y() = point->getY();
+				continue;
+			}
 		Assign( dataElemRef, Undefined() );
 	}
 }
@@ -774,11 +1074,9 @@ void ReadPointZM(typename sequence_traits<T>::seq_t data, OGRLayer* layer, SizeT
 	}
 }
 
-template <typename PolygonType>
-void ReadPolyData(typename sequence_traits<PolygonType>::seq_t dataArray, OGRLayer* layer, SizeT firstIndex, SizeT size, ResourceHandle& readBuffer, GDALDataset* m_hDS)
+template <typename PolygonType, typename GeometrySource>
+void ReadPolyData(typename sequence_traits<PolygonType>::seq_t dataArray, GeometrySource& source, SizeT firstIndex, SizeT size, ResourceHandle& readBuffer)
 {
-	assert(layer);
-
 	DBG_START("ReadPolyData", typeid(PolygonType).name(), true);
 
 	DBG_TRACE(("firstIndex %d, size %d", firstIndex, size));
@@ -796,8 +1094,7 @@ void ReadPolyData(typename sequence_traits<PolygonType>::seq_t dataArray, OGRLay
 	{
 		typename DataArray<PolygonType>::reference dataElemRef = data[i];
 
-		gdalVectImpl::FeaturePtr feat = m_hDS->TestCapability(ODsCRandomLayerRead) ? GetNextFeatureInterleaved(layer, m_hDS) : layer->GetNextFeature();
-		OGRGeometry* geo = feat ? feat ->GetGeometryRef() : nullptr;
+		OGRGeometry* geo = source.Next();
 
 		if (!geo) {
 			Assign( dataElemRef, Undefined() );
@@ -1022,11 +1319,9 @@ void ReadPolyZM(typename sequence_traits<SeqType>::seq_t dataArray, OGRLayer* la
 	assert(dataArray.get_sa().data_size() == data.actual_data_size());
 }
 
-template <typename PolygonType>
-void ReadLinestringData(typename sequence_traits<PolygonType>::seq_t dataArray, OGRLayer* layer, SizeT firstIndex, SizeT size, ResourceHandle& readBuffer, GDALDataset* m_hDS)
+template <typename PolygonType, typename GeometrySource>
+void ReadLinestringData(typename sequence_traits<PolygonType>::seq_t dataArray, GeometrySource& source, SizeT firstIndex, SizeT size, ResourceHandle& readBuffer)
 {
-	assert(layer);
-
 	DBG_START("ReadLinestringData", typeid(PolygonType).name(), true);
 
 	DBG_TRACE(("firstIndex %d, size %d", firstIndex, size));
@@ -1045,8 +1340,7 @@ void ReadLinestringData(typename sequence_traits<PolygonType>::seq_t dataArray,
 	{
 		typename DataArray<PolygonType>::reference dataElemRef = data[i];
 
-		gdalVectImpl::FeaturePtr feat = m_hDS->TestCapability(ODsCRandomLayerRead) ? GetNextFeatureInterleaved(layer, m_hDS) : layer->GetNextFeature();
-		OGRGeometry* geo = feat ? feat->GetGeometryRef() : nullptr;
+		OGRGeometry* geo = source.Next();
 
 		if (!geo) {
 			Assign(dataElemRef, Undefined());
@@ -1256,10 +1550,9 @@ void ReadLinestringZM(typename sequence_traits<SeqType>::seq_t dataArray, OGRLay
 	assert(dataArray.get_sa().data_size() == data.actual_data_size());
 }
 
-void ReadStringData(sequence_traits<SharedStr>::seq_t dataArray, OGRLayer* layer, SizeT firstIndex, SizeT size, ResourceHandle& readBuffer, GDALDataset* hDS)
+template <typename GeometrySource>
+void ReadStringData(sequence_traits<SharedStr>::seq_t dataArray, GeometrySource& source, SizeT firstIndex, SizeT size, ResourceHandle& readBuffer)
 {
-	assert(layer);
-
 	DBG_START("ReadStringData", "", true);
 
 	DBG_TRACE(("firstIndex %d, size %d", firstIndex, size));
@@ -1278,8 +1571,7 @@ void ReadStringData(sequence_traits<SharedStr>::seq_t dataArray, OGRLayer* layer
 	{
 		DataArray<SharedStr>::reference dataElemRef = data[i];
 
-		gdalVectImpl::FeaturePtr  feat = hDS->TestCapability(ODsCRandomLayerRead) ? GetNextFeatureInterleaved(layer, hDS) : layer->GetNextFeature();
-		OGRGeometry* geo = feat ? feat ->GetGeometryRef() : nullptr;
+		OGRGeometry* geo = source.Next();
 		if (geo)
 		{
 			CplString result;
@@ -1423,53 +1715,64 @@ bool GdalVectSM::ReadGeometryZM(const GdalVectlMetaInfo* br, AbstrDataObject* ad
 	return true;
 }
 
-bool GdalVectSM::ReadGeometry(const GdalVectlMetaInfo* br, AbstrDataObject* ado, tile_id t, SizeT firstIndex, SizeT size)
+template <typename GeometrySource>
+bool ReadGeometryData(ValueClassID vcId, AbstrDataObject* ado, tile_id t, GeometrySource& source, SizeT firstIndex, SizeT size, ResourceHandle& readBuffer)
 {
-	assert(br);
-	assert(br->CurrWD());
+	switch (vcId)
+	{
+		case ValueClassID::VT_DArc:     ReadLinestringData<DPolygon>(mutable_array_cast<DPolygon>(ado)->GetWritableTile(t), source, firstIndex, size, readBuffer); return true;
+		case ValueClassID::VT_DPolygon: ReadPolyData      <DPolygon>(mutable_array_cast<DPolygon>(ado)->GetWritableTile(t), source, firstIndex, size, readBuffer); return true;
+		case ValueClassID::VT_FArc:     ReadLinestringData<FPolygon>(mutable_array_cast<FPolygon>(ado)->GetWritableTile(t), source, firstIndex, size, readBuffer); return true;
+		case ValueClassID::VT_FPolygon: ReadPolyData      <FPolygon>(mutable_array_cast<FPolygon>(ado)->GetWritableTile(t), source, firstIndex, size, readBuffer); return true;
 
-	OGRLayer* layer = m_Layer;
-	if (!t)
-		LayerFieldEnable(layer, CharPtrRange(""), nullptr); // only set once
+		case ValueClassID::VT_IArc:     ReadLinestringData<IPolygon>(mutable_array_cast<IPolygon>(ado)->GetWritableTile(t), source, firstIndex, size, readBuffer); return true;
+		case ValueClassID::VT_IPolygon: ReadPolyData      <IPolygon>(mutable_array_cast<IPolygon>(ado)->GetWritableTile(t), source, firstIndex, size, readBuffer); return true;
+		case ValueClassID::VT_UArc:     ReadLinestringData<UPolygon>(mutable_array_cast<UPolygon>(ado)->GetWritableTile(t), source, firstIndex, size, readBuffer); return true;
+		case ValueClassID::VT_UPolygon: ReadPolyData      <UPolygon>(mutable_array_cast<UPolygon>(ado)->GetWritableTile(t), source, firstIndex, size, readBuffer); return true;
+		case ValueClassID::VT_WArc:     ReadLinestringData<WPolygon>(mutable_array_cast<WPolygon>(ado)->GetWritableTile(t), source, firstIndex, size, readBuffer); return true;
+		case ValueClassID::VT_WPolygon: ReadPolyData      <WPolygon>(mutable_array_cast<WPolygon>(ado)->GetWritableTile(t), source, firstIndex, size, readBuffer); return true;
+		case ValueClassID::VT_SArc:     ReadLinestringData<SPolygon>(mutable_array_cast<SPolygon>(ado)->GetWritableTile(t), source, firstIndex, size, readBuffer); return true;
+		case ValueClassID::VT_SPolygon: ReadPolyData      <SPolygon>(mutable_array_cast<SPolygon>(ado)->GetWritableTile(t), source, firstIndex, size, readBuffer); return true;
 
-	const ValueClass* vc = ado->GetValuesType();
-	auto vcId = vc->GetValueClassID();
+		case ValueClassID::VT_DPoint: ReadPointData<DPoint>(mutable_array_cast<DPoint>(ado)->GetWritableTile(t), source, firstIndex, size); return true;
+		case ValueClassID::VT_FPoint: ReadPointData<FPoint>(mutable_array_cast<FPoint>(ado)->GetWritableTile(t), source, firstIndex, size); return true;
+		case ValueClassID::VT_IPoint: ReadPointData<IPoint>(mutable_array_cast<IPoint>(ado)->GetWritableTile(t), source, firstIndex, size); return true;
+		case ValueClassID::VT_UPoint: ReadPointData<UPoint>(mutable_array_cast<UPoint>(ado)->GetWritableTile(t), source, firstIndex, size); return true;
+		case ValueClassID::VT_SPoint: ReadPointData<SPoint>(mutable_array_cast<SPoint>(ado)->GetWritableTile(t), source, firstIndex, size); return true;
+		case ValueClassID::VT_WPoint: ReadPointData<WPoint>(mutable_array_cast<WPoint>(ado)->GetWritableTile(t), source, firstIndex, size); return true;
+
+		case ValueClassID::VT_SharedStr: ReadStringData(mutable_array_cast<SharedStr>(ado)->GetWritableTile(t), source, firstIndex, size, readBuffer); return true;
+		default: return false;
+	}
+}
+
+ValueClassID GeometryValueClassID(const GdalVectlMetaInfo* br, const AbstrDataObject* ado)
+{
+	auto vcId = ado->GetValuesType()->GetValueClassID();
 	if (IsPolygonType(vcId))
 	{
 		auto vComposition = br->CurrWD()->GetValueComposition();
 		if (vComposition == ValueComposition::Sequence) // not a polygon, but a (multi) linestring or multipoint
 			reinterpret_cast<UInt8&>(vcId) -= static_cast<UInt8>(ValueClassID::NrPointTypes); // xPolygon -> xArc
 	}
-	switch (vcId)
-	{
-		case ValueClassID::VT_DArc:     ReadLinestringData<DPolygon>(mutable_array_cast<DPolygon>(ado)->GetWritableTile(t), layer, firstIndex, size, m_ReadBuffer, m_hDS); break;
-		case ValueClassID::VT_DPolygon: ReadPolyData      <DPolygon>(mutable_array_cast<DPolygon>(ado)->GetWritableTile(t), layer, firstIndex, size, m_ReadBuffer, m_hDS); break;
-		case ValueClassID::VT_FArc:     ReadLinestringData<FPolygon>(mutable_array_cast<FPolygon>(ado)->GetWritableTile(t), layer, firstIndex, size, m_ReadBuffer, m_hDS); break;
-		case ValueClassID::VT_FPolygon: ReadPolyData      <FPolygon>(mutable_array_cast<FPolygon>(ado)->GetWritableTile(t), layer, firstIndex, size, m_ReadBuffer, m_hDS); break;
-
-		case ValueClassID::VT_IArc:     ReadLinestringData<IPolygon>(mutable_array_cast<IPolygon>(ado)->GetWritableTile(t), layer, firstIndex, size, m_ReadBuffer, m_hDS); break;
-		case ValueClassID::VT_IPolygon: ReadPolyData      <IPolygon>(mutable_array_cast<IPolygon>(ado)->GetWritableTile(t), layer, firstIndex, size, m_ReadBuffer, m_hDS); break;
-		case ValueClassID::VT_UArc:     ReadLinestringData<UPolygon>(mutable_array_cast<UPolygon>(ado)->GetWritableTile(t), layer, firstIndex, size, m_ReadBuffer, m_hDS); break;
-		case ValueClassID::VT_UPolygon: ReadPolyData      <UPolygon>(mutable_array_cast<UPolygon>(ado)->GetWritableTile(t), layer, firstIndex, size, m_ReadBuffer, m_hDS); break;
-		case ValueClassID::VT_WArc:     ReadLinestringData<WPolygon>(mutable_array_cast<WPolygon>(ado)->GetWritableTile(t), layer, firstIndex, size, m_ReadBuffer, m_hDS); break;
-		case ValueClassID::VT_WPolygon: ReadPolyData      <WPolygon>(mutable_array_cast<WPolygon>(ado)->GetWritableTile(t), layer, firstIndex, size, m_ReadBuffer, m_hDS); break;
-		case ValueClassID::VT_SArc:     ReadLinestringData<SPolygon>(mutable_array_cast<SPolygon>(ado)->GetWritableTile(t), layer, firstIndex, size, m_ReadBuffer, m_hDS); break;
-		case ValueClassID::VT_SPolygon: ReadPolyData      <SPolygon>(mutable_array_cast<SPolygon>(ado)->GetWritableTile(t), layer, firstIndex, size, m_ReadBuffer, m_hDS); break;
-
-		case ValueClassID::VT_DPoint: ReadPointData<DPoint>(mutable_array_cast<DPoint>(ado)->GetWritableTile(t), layer, firstIndex, size, m_hDS); break;
-		case ValueClassID::VT_FPoint: ReadPointData<FPoint>(mutable_array_cast<FPoint>(ado)->GetWritableTile(t), layer, firstIndex, size, m_hDS); break;
-		case ValueClassID::VT_IPoint: ReadPointData<IPoint>(mutable_array_cast<IPoint>(ado)->GetWritableTile(t), layer, firstIndex, size, m_hDS); break;
-		case ValueClassID::VT_UPoint: ReadPointData<UPoint>(mutable_array_cast<UPoint>(ado)->GetWritableTile(t), layer, firstIndex, size, m_hDS); break;
-		case ValueClassID::VT_SPoint: ReadPointData<SPoint>(mutable_array_cast<SPoint>(ado)->GetWritableTile(t), layer, firstIndex, size, m_hDS); break;
-		case ValueClassID::VT_WPoint: ReadPointData<WPoint>(mutable_array_cast<WPoint>(ado)->GetWritableTile(t), layer, firstIndex, size, m_hDS); break;
-
-		case ValueClassID::VT_SharedStr: ReadStringData(mutable_array_cast<SharedStr>(ado)->GetWritableTile(t), layer, firstIndex, size, m_ReadBuffer, m_hDS); break;
-	default:
-			ado->throwItemErrorF(
-				"GdalVectSM::ReadDataItem not implemented for DataItems with ValuesUnitType: %s", 
-				vc->GetName()
-			);
-	}
+	return vcId;
+}
+
+bool GdalVectSM::ReadGeometry(const GdalVectlMetaInfo* br, AbstrDataObject* ado, tile_id t, SizeT firstIndex, SizeT size)
+{
+	assert(br);
+	assert(br->CurrWD());
+
+	OGRLayer* layer = m_Layer;
+	if (!t)
+		LayerFieldEnable(layer, CharPtrRange(""), nullptr); // only set once
+
+	FeatureGeometrySource source(layer, m_hDS);
+	if (!ReadGeometryData(GeometryValueClassID(br, ado), ado, t, source, firstIndex, size, m_ReadBuffer))
+		ado->throwItemErrorF(
+			"GdalVectSM::ReadDataItem not implemented for DataItems with ValuesUnitType: %s", 
+			ado->GetValuesType()->GetName()
+		);
 
 	m_CurrFeatureIndex += size;
 
@@ -1653,6 +1956,324 @@ void ReadDoubleAttrData(OGRLayer* layer, SizeT currFieldIndex, typename sequence
 	}
 }
 
+// *****************************************************************************
+//
+// Reading from the Arrow record batches of a layer
+//
+// *****************************************************************************
+
+// getValue(column, i) provides the value of row i of a batch, which is only called for valid rows;
+// rows beyond the record batches are undefined as rows without a feature
+template <typename T, typename GetValue>
+void ReadArrowValues(const gdalVectImpl::ArrowLayerCache& cache, SizeT column, SizeT firstIndex, SizeT size, typename sequence_traits<T>::seq_t data, GetValue getValue)
+{
+	cache.ForEachBatch(column, firstIndex, size, [data, &getValue](const gdalVectImpl::arrow_column& col, SizeT first, SizeT last, SizeT dataIndex)
+		{
+			parallel_for_if_separable<SizeT, T>(first, last, [col, data, dataIndex, first, &getValue](SizeT i) mutable
+				{
+					typename DataArray<T>::reference dataElemRef = data[dataIndex + (i - first)];
+					if (col.IsValid(i))
+						dataElemRef = getValue(col, i);
+					else
+						Assign(dataElemRef, Undefined());
+				}
+			);
+		}
+	);
+	for (SizeT i = Max<SizeT>(cache.NrRows(), firstIndex); i < firstIndex + size; ++i)
+		Assign(data[i - firstIndex], Undefined());
+}
+
+// true if each value of type V is exactly represented by T, such that reading a column of V doesn't narrow its values
+template <typename V, typename T>
+constexpr bool IsExactlyRepresented()
+{
+	if constexpr (is_bitvalue_v<T>)
+		return false;
+	else if constexpr (std::is_floating_point_v<V>)
+		return std::is_floating_point_v<T> && sizeof(V) <= sizeof(T);
+	else if constexpr (std::is_floating_point_v<T>)
+		return std::numeric_limits<V>::digits <= std::numeric_limits<T>::digits;
+	else
+		return (std::is_unsigned_v<V> || std::is_signed_v<T>) && std::numeric_limits<V>::digits <= std::numeric_limits<T>::digits;
+}
+
+// returns false if the values of type V of the column are not exactly represented by T, such that the column is read feature by feature
+template <typename T, typename V>
+bool ReadArrowColumn(const gdalVectImpl::ArrowLayerCache& cache, SizeT column, SizeT firstIndex, SizeT size, typename sequence_traits<T>::seq_t data)
+{
+	if constexpr (!IsExactlyRepresented<V, T>())
+		return false;
+	else
+	{
+		ReadArrowValues<T>(cache, column, firstIndex, size, data, [](const gdalVectImpl::arrow_column& col, SizeT i) { return col.Value<V>(i); });
+		return true;
+	}
+}
+
+// returns false if the format of the column cannot be converted to T without loss, as for ReadAttrData
+template <typename T>
+bool ReadArrowNumbers(const gdalVectImpl::ArrowLayerCache& cache, SizeT column, SizeT firstIndex, SizeT size, typename sequence_traits<T>::seq_t data)
+{
+	CharPtr format = cache.Format(column);
+	if (!format[0] || format[1])
+		return false;
+	switch (format[0])
+	{
+		case 'b': ReadArrowValues<T>(cache, column, firstIndex, size, data, [](const gdalVectImpl::arrow_column& col, SizeT i) { return col.Bit(i); }); return true;
+		case 'c': return ReadArrowColumn<T, Int8   >(cache, column, firstIndex, size, data);
+		case 'C': return ReadArrowColumn<T, UInt8  >(cache, column, firstIndex, size, data);
+		case 's': return ReadArrowColumn<T, Int16  >(cache, column, firstIndex, size, data);
+		case 'S': return ReadArrowColumn<T, UInt16 >(cache, column, firstIndex, size, data);
+		case 'i': return ReadArrowColumn<T, Int32  >(cache, column, firstIndex, size, data);
+		case 'I': return ReadArrowColumn<T, UInt32 >(cache, column, firstIndex, size, data);
+		case 'l': return ReadArrowColumn<T, Int64  >(cache, column, firstIndex, size, data);
+		case 'L': return ReadArrowColumn<T, UInt64 >(cache, column, firstIndex, size, data);
+		case 'f': return ReadArrowColumn<T, Float32>(cache, column, firstIndex, size, data);
+		case 'g': return ReadArrowColumn<T, Float64>(cache, column, firstIndex, size, data);
+	}
+	return false; // half floats, decimals, dates, times, lists etc.
+}
+
+bool ReadArrowStrings(const gdalVectImpl::ArrowLayerCache& cache, SizeT column, SizeT firstIndex, SizeT size, sequence_traits<SharedStr>::seq_t data)
+{
+	CharPtr format = cache.Format(column);
+	bool isLarge = !strcmp(format, "U");
+	if (!isLarge && strcmp(format, "u"))
+		return false;
+
+	cache.ForEachBatch(column, firstIndex, size, [data, isLarge](const gdalVectImpl::arrow_column& col, SizeT first, SizeT last, SizeT dataIndex) mutable
+		{
+			for (SizeT i = first; i != last; ++i)
+			{
+				DataArray<SharedStr>::reference dataElemRef = data[dataIndex + (i - first)];
+				if (col.IsValid(i))
+				{
+					CharPtrRange value = isLarge ? col.Bytes<Int64>(i) : col.Bytes<Int32>(i);
+					dataElemRef.assign(value.first, value.second MG_DEBUG_ALLOCATOR_SRC("gdal.vect.ReadArrowStrings"));
+				}
+				else
+					Assign(dataElemRef, Undefined());
+			}
+		}
+	);
+	for (SizeT i = Max<SizeT>(cache.NrRows(), firstIndex); i < firstIndex + size; ++i)
+		Assign(data[i - firstIndex], Undefined());
+	return true;
+}
+
+// provides the geometries of the WKB column of a layer in row order with Next(); blocks of rows are parsed concurrently
+struct ArrowGeometrySource
+{
+	static const SizeT s_BlockSize = 4096, s_NrBlocksPerChunk = 64;
+
+	ArrowGeometrySource(const gdalVectImpl::ArrowLayerCache& cache, SizeT firstRow, SizeT nrRows)
+		: m_Cache(cache), m_NextRow(firstRow), m_EndRow(firstRow + nrRows)
+		, m_IsLarge(!strcmp(cache.Format(cache.m_GeometryColumn), "Z"))
+	{}
+
+	OGRGeometry* Next()
+	{
+		if (m_Pos == m_Geometries.size())
+			ParseNextChunk();
+		assert(m_Pos < m_Geometries.size());
+		return m_Geometries[m_Pos++].get();
+	}
+
+private:
+	void ParseNextChunk()
+	{
+		SizeT nrRows = Min<SizeT>(m_EndRow - m_NextRow, s_BlockSize * s_NrBlocksPerChunk);
+		m_Geometries.clear();
+		m_Geometries.resize(nrRows);
+		m_Pos = 0;
+
+		m_Cache.ForEachBatch(m_Cache.m_GeometryColumn, m_NextRow, nrRows, [this](const gdalVectImpl::arrow_column& col, SizeT first, SizeT last, SizeT dataIndex)
+			{
+				SizeT nrBlocks = (last - first + s_BlockSize - 1) / s_BlockSize;
+				parallel_for<SizeT>(nrBlocks, [this, col, first, last, dataIndex](SizeT b)
+					{
+						gdalThread gdal_thread;
+						for (SizeT i = first + b * s_BlockSize, e = Min<SizeT>(i + s_BlockSize, last); i != e; ++i)
+						{
+							if (!col.IsValid(i))
+								continue;
+							CharPtrRange wkb = m_IsLarge ? col.Bytes<Int64>(i) : col.Bytes<Int32>(i);
+							OGRGeometry* geo = nullptr;
+							if (OGRGeometryFactory::createFromWkb(wkb.first, nullptr, &geo, wkb.size()) == OGRERR_NONE)
+								m_Geometries[dataIndex + (i - first)].reset(geo);
+						}
+					}
+				);
+			}
+		);
+		m_NextRow += nrRows;
+	}
+
+	const gdalVectImpl::ArrowLayerCache& m_Cache;
+	SizeT m_NextRow, m_EndRow;
+	bool  m_IsLarge;
+	std::vector<OGRGeometryUniquePtr> m_Geometries;
+	SizeT m_Pos = 0;
+};
+
+auto GdalVectSM::ArrowLayer(const GdalVectlMetaInfo* br) const -> gdalVectImpl::ArrowLayerCache*
+{
+	auto adi = br->CurrRD();
+	bool isGeometry = adi->GetID() == token::geometry || adi->GetAbstrValuesUnit()->GetValueType()->GetNrDims() == 2;
+	FileDateTime fileTime = GetCachedChangeDateTime(br->StorageHolder(), "");
+
+	if (!m_ArrowLayerCache)
+		m_ArrowLayerCache = std::move(m_KeptArrowLayerCache);
+
+	// a scan of the same layer that doesn't include the requested item is replaced by a scan that also includes its fields that are still to be read
+	std::unique_ptr<gdalVectImpl::ArrowLayerCache> prevCache;
+	if (m_ArrowLayerCache && m_ArrowLayerCache->IsFor(br->m_NameID, br->m_SqlString, fileTime))
+	{
+		auto& cache = *m_ArrowLayerCache;
+		if (!cache.m_IsAvailable || (isGeometry ? cache.m_HasGeometry : cache.HasItem(adi->GetName().c_str())))
+			return cache.m_IsAvailable ? &cache : nullptr;
+		prevCache = std::move(m_ArrowLayerCache);
+	}
+	m_ArrowLayerCache.reset();
+	m_ArrowLayerCache = std::make_unique<gdalVectImpl::ArrowLayerCache>(br->m_NameID, br->m_SqlString, fileTime);
+
+	// only drivers with their own Arrow stream, such as Parquet, Arrow and GPKG, are faster than reading the features one by one
+	OGRLayer* layer = Layer(br);
+	if (m_hDS->TestCapability(ODsCRandomLayerRead) || !layer->TestCapability(OLCFastGetArrowStream))
+		return nullptr;
+
+	// the fields of the requested item and of the other data items with interest, that are all read in the same scan
+	std::vector<SharedStr> itemNames;
+	bool hasGeometry = isGeometry || (prevCache && prevCache->m_HasGeometry && !prevCache->IsRead(prevCache->m_GeometryColumn));
+	if (prevCache)
+		for (const auto& itemName : prevCache->m_ItemNames)
+			if (!prevCache->IsRead(prevCache->FindColumn(itemName.c_str())))
+				itemNames.emplace_back(itemName);
+	prevCache.reset();
+
+	for (auto item = adi->GetTreeParent()->GetFirstSubItem(); item; item = item->GetNextItem())
+	{
+		if (!IsDataItem(item) || item->IsDisabledStorage() || item->HasCalculator())
+			continue;
+		if (item != adi.get() && !item->HasInterest())
+			continue;
+		if (item->GetID() == token::geometry || IsValidGeometry(item, true))
+			hasGeometry = true;
+		else if (std::none_of(itemNames.begin(), itemNames.end(), [item](const SharedStr& itemName) { return !stricmp(itemName.c_str(), item->GetName().c_str()); }))
+			itemNames.emplace_back(item->GetName());
+	}
+
+	GDAL_ErrorFrame gdal_error_frame;
+	CPLStringList ignoredFields;
+	WeakPtr<OGRFeatureDefn> featureDefn = layer->GetLayerDefn();
+	for (SizeT i = 0, numFields = featureDefn->GetFieldCount(); i != numFields; ++i)
+	{
+		CharPtr fieldName = featureDefn->GetFieldDefn(i)->GetNameRef();
+		auto fieldNameAsItemName = as_item_name(fieldName, fieldName + StrLen(fieldName));
+		if (std::none_of(itemNames.begin(), itemNames.end(), [&fieldNameAsItemName](const SharedStr& itemName) { return !stricmp(itemName.c_str(), fieldNameAsItemName.c_str()); }))
+			ignoredFields.AddString(fieldName);
+	}
+	if (!hasGeometry)
+		ignoredFields.AddString("OGR_GEOMETRY");
+	ignoredFields.AddString("OGR_STYLE");
+	layer->SetIgnoredFields(const_cast<const char**>(ignoredFields.List()));
+
+	// the feature readers set their own ignored fields and restart from the first feature
+	auto restoreLayer = make_scoped_exit([this, layer]()
+		{
+			layer->SetIgnoredFields(nullptr);
+			layer->ResetReading();
+			m_CurrFeatureIndex = 0;
+			m_CurrFieldIndex = -1;
+		}
+	);
+
+	CPLStringList options;
+	options.SetNameValue("INCLUDE_FID", "NO");
+	options.SetNameValue("GEOMETRY_ENCODING", "WKB");
+	ArrowArrayStream stream;
+	if (!layer->GetArrowStream(&stream, options.List()))
+	{
+		gdal_error_frame.ReleaseError();
+		return nullptr;
+	}
+	auto releaseStream = make_scoped_exit([&stream]() { stream.release(&stream); });
+
+	auto& cache = *m_ArrowLayerCache;
+	cache.m_ItemNames = std::move(itemNames);
+	cache.m_HasGeometry = hasGeometry;
+	if (stream.get_schema(&stream, &cache.m_Schema))
+		throwErrorF("gdal.vect", "cannot get the Arrow schema of layer %s: %s", layer->GetName(), stream.get_last_error(&stream));
+	for (SizeT c = 0, n = cache.m_Schema.n_children; c != n; ++c)
+		if (gdalVectImpl::IsWkbColumn(cache.m_Schema.children[c]))
+		{
+			cache.m_GeometryColumn = c;
+			break;
+		}
+
+	while (true)
+	{
+		ArrowArray batch;
+		if (stream.get_next(&stream, &batch))
+			throwErrorF("gdal.vect", "cannot read the Arrow record batches of layer %s: %s", layer->GetName(), stream.get_last_error(&stream));
+		if (!batch.release)
+			break;
+		cache.m_Batches.emplace_back(batch);
+		cache.m_BatchEnds.emplace_back(cache.NrRows() + batch.length);
+	}
+	cache.m_IsAvailable = true;
+	return &cache;
+}
+
+// reads from the Arrow record batches of the layer; returns false if the data item is to be read feature by feature
+bool GdalVectSM::ReadArrowData(const GdalVectlMetaInfo* br, AbstrDataObject* ado, tile_id t, SizeT firstIndex, SizeT size)
+{
+	auto cache = ArrowLayer(br);
+	if (!cache)
+		return false;
+
+	// the scan is released when all its columns have been read; columns that are read feature by feature, as their format cannot be converted, also count as read
+	auto markRead = [this, cache, size](SizeT column, bool isRead)
+		{
+			if (cache->MarkRead(column, size))
+				m_ArrowLayerCache.reset();
+			return isRead;
+		};
+
+	auto adi = br->CurrRD();
+	if (adi->GetID() == token::geometry || adi->GetAbstrValuesUnit()->GetValueType()->GetNrDims() == 2)
+	{
+		if (cache->m_GeometryColumn == -1)
+			return false;
+		ArrowGeometrySource source(*cache, firstIndex, size);
+		return markRead(cache->m_GeometryColumn, ReadGeometryData(GeometryValueClassID(br, ado), ado, t, source, firstIndex, size, m_ReadBuffer));
+	}
+
+	SizeT column = cache->FindColumn(adi->GetName().c_str());
+	if (column == -1)
+		return false;
+
+	switch (ado->GetValuesType()->GetValueClassID())
+	{
+		case ValueClassID::VT_SharedStr: return markRead(column, ReadArrowStrings      (*cache, column, firstIndex, size, mutable_array_cast<SharedStr>(ado)->GetWritableTile(t, dms_rw_mode::write_only_all)));
+		case ValueClassID::VT_Bool:      return markRead(column, ReadArrowNumbers<Bool>   (*cache, column, firstIndex, size, mutable_array_cast<Bool>   (ado)->GetWritableTile(t, dms_rw_mode::write_only_all)));
+		case ValueClassID::VT_UInt2:     return markRead(column, ReadArrowNumbers<UInt2>  (*cache, column, firstIndex, size, mutable_array_cast<UInt2>  (ado)->GetWritableTile(t, dms_rw_mode::write_only_all)));
+		case ValueClassID::VT_UInt4:     return markRead(column, ReadArrowNumbers<UInt4>  (*cache, column, firstIndex, size, mutable_array_cast<UInt4>  (ado)->GetWritableTile(t, dms_rw_mode::write_only_all)));
+		case ValueClassID::VT_Int64:     return markRead(column, ReadArrowNumbers< Int64> (*cache, column, firstIndex, size, mutable_array_cast<Int64>  (ado)->GetWritableTile(t, dms_rw_mode::write_only_all)));
+		case ValueClassID::VT_UInt64:    return markRead(column, ReadArrowNumbers<UInt64> (*cache, column, firstIndex, size, mutable_array_cast<UInt64> (ado)->GetWritableTile(t, dms_rw_mode::write_only_all)));
+		case ValueClassID::VT_Int32:     return markRead(column, ReadArrowNumbers< Int32> (*cache, column, firstIndex, size, mutable_array_cast<Int32>  (ado)->GetWritableTile(t, dms_rw_mode::write_only_all)));
+		case ValueClassID::VT_UInt32:    return markRead(column, ReadArrowNumbers<UInt32> (*cache, column, firstIndex, size, mutable_array_cast<UInt32> (ado)->GetWritableTile(t, dms_rw_mode::write_only_all)));
+		case ValueClassID::VT_Int16:     return markRead(column, ReadArrowNumbers< Int16> (*cache, column, firstIndex, size, mutable_array_cast<Int16>  (ado)->GetWritableTile(t, dms_rw_mode::write_only_all)));
+		case ValueClassID::VT_UInt16:    return markRead(column, ReadArrowNumbers<UInt16> (*cache, column, firstIndex, size, mutable_array_cast<UInt16> (ado)->GetWritableTile(t, dms_rw_mode::write_only_all)));
+		case ValueClassID::VT_Int8:      return markRead(column, ReadArrowNumbers< Int8 > (*cache, column, firstIndex, size, mutable_array_cast<Int8>   (ado)->GetWritableTile(t, dms_rw_mode::write_only_all)));
+		case ValueClassID::VT_UInt8:     return markRead(column, ReadArrowNumbers<UInt8 > (*cache, column, firstIndex, size, mutable_array_cast<UInt8>  (ado)->GetWritableTile(t, dms_rw_mode::write_only_all)));
+		case ValueClassID::VT_Float32:   return markRead(column, ReadArrowNumbers<Float32>(*cache, column, firstIndex, size, mutable_array_cast<Float32>(ado)->GetWritableTile(t, dms_rw_mode::write_only_all)));
+		case ValueClassID::VT_Float64:   return markRead(column, ReadArrowNumbers<Float64>(*cache, column, firstIndex, size, mutable_array_cast<Float64>(ado)->GetWritableTile(t, dms_rw_mode::write_only_all)));
+	}
+	return markRead(column, false);
+}
+
 OGRLayer* GdalVectSM::Layer(const GdalVectlMetaInfo* br) const
 {
 	assert(br);
@@ -1789,10 +2410,14 @@ bool GdalVectSM::ReadLayerData(const GdalVectlMetaInfo* br, AbstrDataObject* ado
 	auto trd = ado->GetTiledRangeData();
 	SizeT firstIndex = trd->GetFirstRowIndex(t);
 	auto size      = trd->GetTileSize(t);
+
+	auto adi = br->CurrRD();
+	if (adi->GetID() != token::geometry_z && adi->GetID() != token::geometry_m && ReadArrowData(br, ado, t, firstIndex, size))
+		return true;
+
 	if (size)
 		SetCurrFeatureIndex(firstIndex);
 
-	auto adi = br->CurrRD();
 	if (adi->GetID() == token::geometry || adi->GetAbstrValuesUnit()->GetValueType()->GetNrDims() == 2)
 		return ReadGeometry(br, ado, t, firstIndex, size);
 	if (adi->GetID() == token::geometry_z)
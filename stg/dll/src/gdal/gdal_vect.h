@@ -13,12 +13,14 @@
 #include "ptr/Resource.h"
 
 #include <filesystem>
+#include <memory>
 #include <ranges>
 
 class GDALDataset;
 class OGRLayer;
 
 struct GdalVectSM;
+namespace gdalVectImpl { struct ArrowLayerCache; }
 
 // ------------------------------------------------------------------------
 // installation of gdalVect component
@@ -87,11 +89,13 @@ private:
 	void DoUpdateTableAttributes(AbstrUnit* layerDomain, OGRLayer* layer) const;
 	void SetCurrFeatureIndex(SizeT firstFeatureIndex) const;
 	OGRLayer* Layer(const GdalVectlMetaInfo* br) const;
+	auto ArrowLayer(const GdalVectlMetaInfo* br) const -> gdalVectImpl::ArrowLayerCache*;
 
 	bool ReadLayerData(const GdalVectlMetaInfo* br, AbstrDataObject* ado, tile_id t);
 	bool ReadGeometry (const GdalVectlMetaInfo* br, AbstrDataObject* ado, tile_id t, SizeT firstIndex, SizeT size);
 	bool ReadGeometryZM(const GdalVectlMetaInfo* br, AbstrDataObject* ado, tile_id t, SizeT firstIndex, SizeT size, bool isZ, ValueComposition geometryComposition);
 	bool ReadAttrData (const GdalVectlMetaInfo* br, AbstrDataObject* ado, tile_id t, SizeT firstIndex, SizeT size);
+	bool ReadArrowData(const GdalVectlMetaInfo* br, AbstrDataObject* ado, tile_id t, SizeT firstIndex, SizeT size);
 	bool WriteGeometryElement(const AbstrDataItem* adi, OGRFeature* feature, tile_id t, SizeT featureIndex);
 	bool WriteFieldElement   (const AbstrDataItem* adi, int field_index, OGRFeature* feature, tile_id t, SizeT featureIndex);
 
@@ -103,6 +107,8 @@ private:
 	mutable ResourceHandle  m_ReadBuffer;
 	mutable SizeT           m_CurrFeatureIndex = 0;
 	mutable SizeT           m_CurrFieldIndex = -1;
+	mutable std::unique_ptr<gdalVectImpl::ArrowLayerCache> m_ArrowLayerCache;     // of the open dataset; released when all its columns are read, the layer is switched or the file changes
+	mutable std::unique_ptr<gdalVectImpl::ArrowLayerCache> m_KeptArrowLayerCache; // copy of the columns of m_ArrowLayerCache still to be read when the dataset was closed
 
 
 	DECL_RTTI(STGDLL_CALL, StorageClass)
@@ -449,6 +449,43 @@ bool TifImp::ReadNextDir()
 	return TIFFReadDirectory(m_TiffHandle);
 }
 
+UInt32 TifImp::GetDirectory() const
+{
+	dms_assert(m_TiffHandle);
+	return TIFFCurrentDirectory(m_TiffHandle);
+}
+
+bool TifImp::SetDirectory(UInt32 dir)
+{
+	dms_assert(m_TiffHandle);
+	return TIFFSetDirectory(m_TiffHandle, dir);
+}
+
+// the reduced resolution images that directly follow the current image with the same pixel layout, such as the internal overviews written by gdaladdo;
+// the current directory is restored afterwards
+std::vector<std::pair<UInt32, UPoint>> TifImp::GetReducedResolutionImages()
+{
+	dms_assert(m_TiffHandle);
+	std::vector<std::pair<UInt32, UPoint>> result;
+
+	UInt32 currDir = GetDirectory();
+	UInt32 nrBitsPerPixel = GetNrBitsPerPixel();
+	bool isTiled = IsTiledTiff();
+	for (UInt32 dir = currDir + 1, nrDirs = TIFFNumberOfDirectories(m_TiffHandle); dir < nrDirs; ++dir)
+	{
+		if (!SetDirectory(dir))
+			break;
+		UInt32 subFileType = 0;
+		if (!TIFFGetField(m_TiffHandle, TIFFTAG_SUBFILETYPE, &subFileType) || !(subFileType & FILETYPE_REDUCEDIMAGE))
+			break; // the next full resolution image; its pyramid is not ours
+		if ((subFileType & FILETYPE_MASK) || GetNrBitsPerPixel() != nrBitsPerPixel || IsTiledTiff() != isTiled)
+			continue;
+		result.emplace_back(dir, GetSize());
+	}
+	SetDirectory(currDir);
+	return result;
+}
+
 bool TifImp::IsTiledTiff() const 
 {
 	dms_assert(m_TiffHandle);
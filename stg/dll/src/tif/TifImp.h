@@ -136,6 +136,9 @@ public:
 	STGIMPL_CALL bool OpenForReadDirect (WeakStr name);
 	STGIMPL_CALL bool OpenForWriteDirect(WeakStr name);
 	STGIMPL_CALL bool ReadNextDir();
+	STGIMPL_CALL UInt32 GetDirectory() const;
+	STGIMPL_CALL bool SetDirectory(UInt32 dir);
+	STGIMPL_CALL std::vector<std::pair<UInt32, UPoint>> GetReducedResolutionImages(); // directory and size of each pyramid level of the current image
 //	STGIMPL_CALL void ReportFieldInfo();
 	STGIMPL_CALL void WriteStrip(UInt32 row, const void* data, UInt32 size);
 
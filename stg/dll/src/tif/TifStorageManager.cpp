@@ -30,6 +30,7 @@
 #include "ser/BaseStreamBuff.h"  
 #include "utl/Environment.h"
 #include "utl/mySPrintF.h"
+#include "utl/scoped_exit.h"
 #include "utl/SplitPath.h"
 
 #include "AbstrDataItem.h"
@@ -47,6 +48,7 @@
 
 #include "stg/StorageClass.h"
 
+#include "gdal/gdal_base.h"
 #include "tif/TifImp.h"
 
 // ------------------------------------------------------------------------
@@ -179,6 +181,28 @@ void TiffSM::ReadGridData(const StgViewPortInfo& vpi, AbstrDataItem* adi, AbstrD
 			);
 
 
+	// read from the coarsest pyramid level that still has a cell per viewport cell, if opted into with GEODMS_USE_OVERVIEWS=YES
+	if (Min(Abs(vpi.Factor().X()), Abs(vpi.Factor().Y())) >= 2.0 && Gdal_UsesOverviews(*debug_cast<const GdalMetaInfo*>(smi.get())))
+	{
+		auto levels = m_pImp->GetReducedResolutionImages();
+		UPoint gridSize = m_pImp->GetSize();
+		std::vector<DPoint> levelFactors;
+		for (const auto& level : levels)
+			levelFactors.emplace_back(Float64(gridSize.X()) / level.second.X(), Float64(gridSize.Y()) / level.second.Y());
+
+		auto level = SelectReducedResolutionLevel(vpi, levelFactors);
+		if (level != -1)
+		{
+			UInt32 currDir = m_pImp->GetDirectory();
+			if (m_pImp->SetDirectory(levels[level].first))
+			{
+				auto restoreDirectory = make_scoped_exit([this, currDir] { m_pImp->SetDirectory(currDir); });
+				Grid::ReadGridData(*m_pImp, ReducedResolutionViewPort(vpi, levelFactors[level]), ado, t, GetNameStr().c_str());
+				return;
+			}
+			m_pImp->SetDirectory(currDir);
+		}
+	}
 	Grid::ReadGridData(*m_pImp, vpi, ado, t, GetNameStr().c_str());
 }
 
@@ -14,12 +14,15 @@
 //     - Production / output selection for OD matrices and aggregated origin metrics.
 //     - Interaction / trip distribution modeling (TripDistr, Interaction, etc.).
 //     - Spatial / Euclidean pre-filters (OrgZoneLoc, DstZoneLoc, UseEuclidicFilter).
+//     - Searches restricted to given OD pairs (OdPairs, GoalDirected, LandmarkNode, LandmarkImp, BidirectionalSearch).
+//     - Queries on a preprocessed contraction hierarchy (ContractionHierarchy).
 //     - Composite convenience bundles (TripDistr, Interaction, etc.).
 //
 //   Notes:
 //     * OD implies multiple sources (multi-source Dijkstra).
 //     * OrgZone requires OD (zones partition origins).
 //     * Some flags require additional per-edge mass/attributes (UseAltLinkImp, UseLinkAttr).
+//     * Bidirectional refers to two-way links; BidirectionalSearch to searching from both ends of an OD pair.
 //     * Composite flags are combinations; keep them synchronized with individual base flags.
 //     * Bit values must remain stable (persisted settings / parsing logic).
 /////////////////////////////////////////////////////////////////////////////
@@ -92,6 +95,14 @@ enum class DijkstraFlag : UInt64
 	ProdTraceBack    = 0x10'0000, // Store predecessor info for path reconstruction (non-OD single-source).
 	ProdOdLinkSet    = 0x20'0000, // Produce per-OD link set (set of traversed edges).
 
+	// Searches restricted to given OD pairs
+	OdPairs             = 0x40'0000,    // Only the given (OrgZone, DstZone) pairs are requested; results are in the order of the pairs.
+	GoalDirected        = 0x80'0000,    // A* search with landmark (ALT) lower bounds towards the requested DstZones.
+	LandmarkNode        = 0x2000'0000,  // Landmark nodes are given (else: selected by farthest-node heuristic). Requires GoalDirected.
+	LandmarkImp         = 0x20'0000'0000'0000, // Impedances from and to landmarks are given, as calculated by landmark_impedances. Requires GoalDirected.
+	BidirectionalSearch = 0x4000'0000,  // Search from both the OrgZone and the DstZone of each pair for origins with few requested DstZones.
+	SearchFlags         = GoalDirected | LandmarkNode | LandmarkImp | BidirectionalSearch, // Any search strategy that requires OdPairs.
+
 	// OD relative outputs
 	ProdOdOrgZone_rel    = 0x100'0000, // Output: origin zone (per OD pair).
 	ProdOdDstZone_rel    = 0x200'0000, // Output: destination zone (per OD pair).
@@ -127,6 +138,10 @@ enum class DijkstraFlag : UInt64
 
 	PrecalculatedNrDstZones = 0x2'0000'0000'0000, // Use externally precomputed number of destination zones.
 
+	ContractionHierarchy = 0x10'0000'0000'0000, // Links are the result of contraction_hierarchy, given with the Node_rank of their nodes (impedance_table_ch / impedance_matrix_ch).
+
+	FastHeap             = 0x40'0000'0000'0000, // Frontier in a radix heap (integral impedances) or 4-ary heap instead of a binary heap; nodes with equal impedance may be finalized in another order.
+
 	// Composite Euclidean group
 	EuclidFlags = OrgZoneLoc | DstZoneLoc | UseEuclidicFilter, // Any Euclidean spatial capability.
 
@@ -18,10 +18,13 @@
 //        - impCutRule: optional impedance cut
 //        - dstLimitRule: destination limiting
 //        - dstEuclidicRule: Euclidean filter
+//        - pairsRule: restriction to given OD pairs
+//        - searchRule: search strategy for OD pairs (landmarks and/or bidirectional)
 //        - altLinkImpRule: alternative link impedance / attributes (+ production outputs)
 //        - interactionRule: interaction model inputs (+ production outputs)
 //        - tbRule: traceback production
 //        - odRule: OD matrix related options + outputs
+//        - heapRule: opt-in for the faster heaps of DijkstraHeapPolicy.h
 //        - verboseLoggingRule: enable verbose logging
 //        - paramRule: master rule chaining the above in a fixed ordered,
 //          optionally-present sequence separated by ';'.
@@ -117,6 +120,22 @@ DijkstraFlag ParseDijkstraString(CharPtr str)
 	boost::spirit::rule<>  dstEuclidicRule =
 		strlit<>("euclid(maxSqrDist)")[AssignFlags(result, DijkstraFlag::UseEuclidicFilter)];
 
+	// Optional restriction to given (OrgZone, DstZone) pairs
+	boost::spirit::rule<>  pairsRule =
+		strlit<>("pairs(OrgZone_rel,DstZone_rel)")[AssignFlags(result, DijkstraFlag::OdPairs)];
+
+	// Search strategy for the given pairs; the longer token must be tried first
+	boost::spirit::rule<>  searchRule =
+		strlit<>("search")
+		>>	LBRACE
+		>>	(	strlit<>("landmarks(Node_rel)")[AssignFlags(result, DijkstraFlag::GoalDirected | DijkstraFlag::LandmarkNode)]
+			|	strlit<>("landmarks(FromLandmark_imp,ToLandmark_imp)")[AssignFlags(result, DijkstraFlag::GoalDirected | DijkstraFlag::LandmarkImp)]
+			|	strlit<>("landmarks")[AssignFlags(result, DijkstraFlag::GoalDirected)]
+			|	strlit<>("bidirectional")[AssignFlags(result, DijkstraFlag::BidirectionalSearch)]
+			)
+			% COMMA
+		>> RBRACE;
+
 	// Alternative link impedance / attribute usage + optional production outputs
 	boost::spirit::rule<>  altLinkImpRule =
 		strlit<>("alternative")
@@ -187,6 +206,11 @@ DijkstraFlag ParseDijkstraString(CharPtr str)
 				%	COMMA
 			);
 
+	// Frontier heap: the radix heap for integral impedances or the 4-ary heap for floating point impedances.
+	// Impedances are the same, but paths of equal impedance may be chosen differently than with the default binary heap,
+	// which affects TraceBack, alt_imp, link_attr, Link_flow and the order of sparse results.
+	boost::spirit::rule<>  heapRule = strlit<>("heap(fast)")[AssignFlags(result, DijkstraFlag::FastHeap)];
+
 	// Verbose logging control
 	boost::spirit::rule<>  verboseLoggingRule = strlit<>("verboseLogging")[AssignFlags(result, DijkstraFlag::VerboseLogging)];
 
@@ -199,10 +223,13 @@ DijkstraFlag ParseDijkstraString(CharPtr str)
 		>> !(chlit<>(';') >> impCutRule)
 		>> !(chlit<>(';') >> dstLimitRule)
 		>> !(chlit<>(';') >> dstEuclidicRule)
+		>> !(chlit<>(';') >> pairsRule)
+		>> !(chlit<>(';') >> searchRule)
 		>> !(chlit<>(';') >> altLinkImpRule)
 		>> !(chlit<>(';') >> interactionRule)
 		>> !(chlit<>(';') >> tbRule)
 		>> !(chlit<>(';') >> odRule)
+		>> !(chlit<>(';') >> heapRule)
 		>> !(chlit<>(';') >> verboseLoggingRule)
 		;
 
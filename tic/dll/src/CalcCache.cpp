@@ -0,0 +1,368 @@
+// Copyright (C) 1998-2026 Object Vision b.v.
+// License: GNU GPL 3
+/////////////////////////////////////////////////////////////////////////////
+
+#include "TicPCH.h"
+
+#if defined(CC_PRAGMAHDRSTOP)
+#pragma hdrstop
+#endif //defined(CC_PRAGMAHDRSTOP)
+
+#include "CalcCache.h"
+
+#include "RtcInterface.h"
+#include "dbg/SeverityType.h"
+#include "mci/ValueClass.h"
+#include "ser/BinaryStream.h"
+#include "ser/FileStreamBuff.h"
+#include "utl/Environment.h"
+#include "utl/mySPrintF.h"
+#include "utl/splitPath.h"
+
+#include "LispRef.h"
+
+#include "AbstrDataItem.h"
+#include "AbstrDataObject.h"
+#include "AbstrUnit.h"
+#include "DataLocks.h"
+#include "MoreDataControllers.h"
+#include "SessionData.h"
+#include "stg/AbstrStorageManager.h"
+
+#include <filesystem>
+#include <set>
+
+// *****************************************************************************
+// Section:     key calculation
+// *****************************************************************************
+
+namespace {
+
+	const UInt32 CALCCACHE_MAGIC = 0x43436D44; // "DmCC"
+	const SizeT  CALCCACHE_MAX_CONFIGDATA_SIGNATURE_SIZE = 0x10000; // larger config data is not hashed but makes the result uncacheable
+
+	// FNV-1a hashing of everything that is written to it
+	struct key_hasher : OutStreamBuff
+	{
+		void WriteBytes(CBytePtr data, streamsize_t size) override
+		{
+			m_Pos += size;
+			for (; size; --size)
+			{
+				m_Hash ^= UInt8(*data++);
+				m_Hash *= 0x100000001b3;
+			}
+		}
+		streamsize_t CurrPos() const override { return m_Pos; }
+		bool AtEnd() const override { return false; }
+
+		void Add(CharPtr str)
+		{
+			WriteBytes(str, StrLen(str) + 1); // include terminator to separate consecutive strings
+		}
+		void Add(WeakStr str) { Add(str.c_str()); }
+		void Add(UInt64 v) { WriteBytes(reinterpret_cast<CBytePtr>(&v), sizeof(v)); }
+
+		CalcCache::key_t m_Hash = 0xcbf29ce484222325;
+		streamsize_t     m_Pos  = 0;
+	};
+
+	bool AddUnitSignature(key_hasher& hasher, const AbstrUnit* au)
+	{
+		hasher.Add(au->GetValueType()->GetID().GetStr().c_str());
+		hasher.Add(au->GetMetricStr(FormattingFlags::None));
+		hasher.Add(au->GetProjectionStr(FormattingFlags::None));
+		if (!CheckDataReady(au))
+			return false;
+		au->StoreBlobStream(&hasher); // range data
+		return true;
+	}
+
+	bool AddItemSignature(key_hasher& hasher, const TreeItem* item)
+	{
+		if (!item)
+			return false;
+		hasher.Add(item->GetFullName());
+
+		auto storageParent = item->GetStorageParent(false);
+		if (storageParent)
+		{
+			AbstrStorageManager* sm = storageParent->GetStorageManager(false);
+			if (!sm)
+				return false;
+			auto relativeName = item->GetRelativeName(storageParent.get());
+			FileDateTime lastFileChange = sm->GetCachedChangeDateTime(storageParent.get(), relativeName.c_str());
+			if (!lastFileChange)
+				return false;
+			hasher.Add(sm->GetNameStr());
+			hasher.Add(relativeName);
+			hasher.Add(lastFileChange);
+			return true;
+		}
+		if (IsUnit(item))
+			return AddUnitSignature(hasher, AsUnit(item));
+
+		if (!IsDataItem(item) || !item->HasConfigData())
+			return false; // not an authentic source, thus its derivation is not covered by the key
+
+		auto adi = AsDataItem(item);
+		if (!CheckDataReady(adi))
+			return false;
+		auto ado = adi->GetCurrRefObj();
+		if (!ado || !ado->IsSmallerThan(CALCCACHE_MAX_CONFIGDATA_SIGNATURE_SIZE))
+			return false;
+
+		hasher.Add(ado->GetValuesType()->GetID().GetStr().c_str());
+		BinaryOutStream ar(&hasher);
+		for (tile_id t = 0, tn = ado->GetTiledRangeData()->GetNrTiles(); t != tn; ++t)
+			ado->DoWriteData(ar, t);
+		return true;
+	}
+
+	bool AddSourceSignatures(key_hasher& hasher, const DataController* dc, std::set<const DataController*>& visited)
+	{
+		if (!dc)
+			return false;
+		if (!visited.insert(dc).second)
+			return true;
+		if (dc->IsTransient())
+			return false;
+
+		if (auto funcDC = dynamic_cast<const FuncDC*>(dc))
+		{
+			const AbstrOperGroup* og = funcDC->m_OperatorGroup;
+			if (!og || og->IsTransient() || og->HasExternalEffects() || og->HasSupplTreeArg())
+				return false;
+			if (funcDC->HasOtherSuppliers())
+				return false;
+			for (auto argElem = funcDC->GetArgList(); argElem; argElem = argElem->m_Next.get())
+				if (!AddSourceSignatures(hasher, argElem->m_DC.get(), visited))
+					return false;
+			return true;
+		}
+		if (!dc->IsSymbDC())
+			return true; // literals are fully described by the key expression
+
+		return AddItemSignature(hasher, dc->GetOld());
+	}
+
+	SharedStr GetCalcCacheDir()
+	{
+		static std::mutex s_DirSection;
+		static SharedStr  s_ConfigDir, s_CalcCacheDir;
+
+		auto sd = SessionData::Curr();
+		if (!sd)
+			return {};
+
+		auto configDir = sd->GetConfigDir();
+		std::lock_guard lock(s_DirSection);
+		if (s_ConfigDir != configDir)
+		{
+			s_CalcCacheDir = AbstrStorageManager::Expand(configDir.c_str(), "%calcCacheDir%");
+			s_ConfigDir = configDir;
+		}
+		return s_CalcCacheDir;
+	}
+
+	SharedStr GetEntryFileName(WeakStr calcCacheDir, CalcCache::key_t key)
+	{
+		char keyStr[17];
+		snprintf(keyStr, sizeof(keyStr), "%016llx", static_cast<unsigned long long>(key));
+		return DelimitedConcat(calcCacheDir.c_str(), keyStr) + ".dmscc";
+	}
+
+	UInt64 GetMaxCacheSize()
+	{
+		return UInt64(RTC_GetRegDWord(RegDWordEnum::CalcCacheMaxSize_GB)) << 30;
+	}
+
+	SizeT GetMinEntrySize()
+	{
+		return SizeT(RTC_GetRegDWord(RegDWordEnum::CalcCacheMinSize_KB)) << 10;
+	}
+
+	std::mutex s_CalcCacheSection;
+	std::optional<UInt64> s_CurrCacheSize; // known after first Trim
+	std::atomic<UInt32> s_TmpFileCounter = 0;
+
+} // anonymous namespace
+
+// *****************************************************************************
+// Section:     CalcCache interface
+// *****************************************************************************
+
+namespace CalcCache {
+
+	bool IsEnabled()
+	{
+		return RTC_GetRegDWord(RegDWordEnum::CalcCacheMaxSize_GB) != 0;
+	}
+
+	auto GetKey(const FuncDC* dc) -> std::optional<key_t>
+	{
+		if (!IsEnabled())
+			return {};
+
+		assert(dc);
+		auto resultItem = dc->GetOld();
+		if (!resultItem || !IsDataItem(resultItem) || resultItem->GetCurrFirstSubItem())
+			return {};
+		auto adi = AsDataItem(resultItem);
+		auto adu = adi->GetAbstrDomainUnit();
+		if (!CheckDataReady(adu->GetCurrRangeItem()))
+			return {}; // domain is produced by the same calculation
+
+		try {
+			key_hasher hasher;
+			hasher.Add(DMS_GetVersion());
+			hasher.Add(AsFLispSharedStr(dc->GetLispRef(), FormattingFlags::None));
+			hasher.Add(adi->GetAbstrValuesUnit()->GetValueType(adi->GetValueComposition())->GetID().GetStr().c_str());
+			hasher.Add(adu->GetCount());
+			for (tile_id t = 0, tn = adu->GetNrTiles(); t != tn; ++t)
+				hasher.Add(adu->GetTileCount(t));
+
+			std::set<const DataController*> visited;
+			if (!AddSourceSignatures(hasher, dc, visited))
+				return {};
+			return hasher.m_Hash;
+		}
+		catch (...)
+		{
+			return {}; // no signature, no cache
+		}
+	}
+
+	bool TryLoad(key_t key, AbstrDataItem* adi)
+	{
+		assert(adi);
+		auto calcCacheDir = GetCalcCacheDir();
+		if (calcCacheDir.empty())
+			return false;
+
+		auto fileName = GetEntryFileName(calcCacheDir, key);
+		if (!IsFileOrDirAccessible(fileName))
+			return false;
+
+		try {
+			FileInpStreamBuff inp(fileName, false);
+			if (!inp.IsOpen())
+				return false;
+			BinaryInpStream ar(&inp);
+
+			UInt32 magic = 0; key_t storedKey = 0;
+			ar >> magic >> storedKey;
+			if (magic != CALCCACHE_MAGIC || storedKey != key)
+				return false;
+
+			DataWriteLock writeHandle(adi);
+			for (tile_id t = 0, tn = adi->GetAbstrDomainUnit()->GetNrTiles(); t != tn; ++t)
+				writeHandle->DoReadData(ar, t);
+			writeHandle.Commit();
+		}
+		catch (...)
+		{
+			reportF(MsgCategory::storage_read, SeverityTypeID::ST_Warning, "CalcCache: dropping unreadable entry %s", fileName);
+			KillFileOrDir(fileName, false);
+			return false;
+		}
+
+		// refresh the entry for least-recently-used eviction
+		std::error_code ec;
+		std::filesystem::last_write_time(std::filesystem::path(fileName.c_str()), std::filesystem::file_time_type::clock::now(), ec);
+
+		reportF(MsgCategory::storage_read, SeverityTypeID::ST_MajorTrace, "CalcCache: restored %s from %s", adi->GetFullName(), fileName);
+		return true;
+	}
+
+	void Store(key_t key, const AbstrDataItem* adi)
+	{
+		assert(adi);
+		auto ado = adi->GetCurrRefObj();
+		if (!ado || !ado->IsMemoryObject())
+			return; // don't materialize lazy results just to store them
+
+		if (!adi->GetStoreDataState() && ado->IsSmallerThan(GetMinEntrySize()))
+			return; // cheaper to recalculate than to read from disk
+
+		auto calcCacheDir = GetCalcCacheDir();
+		if (calcCacheDir.empty())
+			return;
+
+		auto fileName = GetEntryFileName(calcCacheDir, key);
+		auto tmpFileName = fileName + mySSPrintF(".%d.tmp", ++s_TmpFileCounter);
+		streamsize_t nrBytes = 0;
+		try {
+			MakeDirsForFile(tmpFileName);
+			{
+				FileOutStreamBuff out(tmpFileName, false);
+				if (!out.IsOpen())
+					return;
+				BinaryOutStream ar(&out);
+				ar << CALCCACHE_MAGIC << key;
+				for (tile_id t = 0, tn = ado->GetTiledRangeData()->GetNrTiles(); t != tn; ++t)
+					ado->DoWriteData(ar, t);
+				nrBytes = out.CurrPos();
+			}
+			std::filesystem::rename(std::filesystem::path(tmpFileName.c_str()), std::filesystem::path(fileName.c_str()));
+		}
+		catch (...)
+		{
+			reportF(MsgCategory::storage_write, SeverityTypeID::ST_Warning, "CalcCache: failed to store %s in %s", adi->GetFullName(), fileName);
+			KillFileOrDir(tmpFileName, false);
+			return;
+		}
+		reportF(MsgCategory::storage_write, SeverityTypeID::ST_MinorTrace, "CalcCache: stored %s in %s", adi->GetFullName(), fileName);
+
+		bool mustTrim = false;
+		{
+			std::lock_guard lock(s_CalcCacheSection);
+			mustTrim = !s_CurrCacheSize || (*s_CurrCacheSize += nrBytes) > GetMaxCacheSize();
+		}
+		if (mustTrim)
+			Trim();
+	}
+
+	void Trim()
+	{
+		auto calcCacheDir = GetCalcCacheDir();
+		if (calcCacheDir.empty())
+			return;
+
+		std::lock_guard lock(s_CalcCacheSection);
+
+		struct entry { std::filesystem::file_time_type lastUse; UInt64 size; std::filesystem::path path; };
+		std::vector<entry> entries;
+		UInt64 totalSize = 0;
+
+		std::error_code ec;
+		for (const auto& dirEntry : std::filesystem::directory_iterator(std::filesystem::path(calcCacheDir.c_str()), ec))
+		{
+			if (!dirEntry.is_regular_file(ec) || dirEntry.path().extension() != ".dmscc")
+				continue;
+			auto size = dirEntry.file_size(ec);
+			if (ec)
+				continue;
+			entries.emplace_back(dirEntry.last_write_time(ec), size, dirEntry.path());
+			totalSize += size;
+		}
+
+		auto maxSize = GetMaxCacheSize();
+		if (totalSize > maxSize)
+		{
+			std::sort(entries.begin(), entries.end(), [](const entry& a, const entry& b) { return a.lastUse < b.lastUse; });
+
+			auto targetSize = maxSize - maxSize / 8; // leave some headroom to avoid trimming after each store
+			for (const auto& e : entries)
+			{
+				if (totalSize <= targetSize)
+					break;
+				if (std::filesystem::remove(e.path, ec))
+					totalSize -= e.size;
+			}
+			reportF(MsgCategory::storage_write, SeverityTypeID::ST_MinorTrace, "CalcCache: trimmed %s to %d MB", calcCacheDir, totalSize >> 20);
+		}
+		s_CurrCacheSize = totalSize;
+	}
+
+} // namespace CalcCache
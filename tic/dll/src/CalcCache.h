@@ -0,0 +1,55 @@
+// Copyright (C) 1998-2026 Object Vision b.v.
+// License: GNU GPL 3
+/////////////////////////////////////////////////////////////////////////////
+
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+File: CalcCache.h
+Purpose:
+- Cross-session, content-addressed store of calculation results of FuncDC's.
+
+Summary:
+- An entry is addressed by a 64 bit hash of the decontextualized key expression (FuncDC::m_Key),
+  the GeoDMS version, the result value type and tiling and the signatures of all authentic sources
+  reachable from the key: storage names with their last change date-time or the content of (small) config data.
+- Results that are not reproducible from their key (transient operators, operators with external effects,
+  explicit other suppliers or sources without a signature) yield no key and are never cached.
+- Entries are written as <calcCacheDir>/<hex key>.dmscc after a successful calculation of a materialized data item
+  that is at least CalcCacheMinSize_KB kilobytes large (default 64, 0 stores all results) or has the StoreData property set.
+- Lookup happens before Operator::CalcResult; a hit fills the result tiles from disk and refreshes the entry's
+  last write time, which is used for least-recently-used eviction when the directory exceeds CalcCacheMaxSize_GB.
+- The cache is disabled when the registry setting CalcCacheMaxSize_GB is 0 (default).
+*/
+
+#if !defined(__TIC_CALCCACHE_H)
+#define __TIC_CALCCACHE_H
+
+#include "TicBase.h"
+
+#include <optional>
+
+struct FuncDC;
+class AbstrDataItem;
+
+namespace CalcCache {
+
+	using key_t = UInt64;
+
+	TIC_CALL bool IsEnabled();
+
+	// returns no key if the result of dc cannot be determined from its key expression and source signatures
+	TIC_CALL auto GetKey(const FuncDC* dc) -> std::optional<key_t>;
+
+	// PRECONDITION: adi is the (write locked) result of the FuncDC that produced key and its domain is ready
+	TIC_CALL bool TryLoad(key_t key, AbstrDataItem* adi);
+	TIC_CALL void Store(key_t key, const AbstrDataItem* adi);
+
+	// removes least recently used entries until the cache directory is within the configured size limit
+	TIC_CALL void Trim();
+
+} // namespace CalcCache
+
+#endif // __TIC_CALCCACHE_H
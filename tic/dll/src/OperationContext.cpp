@@ -19,9 +19,12 @@
 //
 // Threading model
 // ---------------
-// - cs_ThreadMessing protects all shared scheduling state: queues, phase maps,
-//   counters, and OperationContext life-cycle changes.
-// - s_TileTaskGroupsMutex protects the global list of tile_task_group instances.
+// - cs_ThreadMessing protects the phase queues, phase transitions, counters, supplier/waiter
+//   links and the OperationContext life-cycle changes that go with them.
+// - tile_task_group slots are commissioned lock-free and distributed over per-thread
+//   work-stealing deques; the mutex of a per_thread_deques registry only guards deque registration.
+// - Activated OperationContexts are also distributed over per-thread work-stealing deques and
+//   the license to run one is obtained with a compare-exchange of its status, without cs_ThreadMessing.
 // - task_group from PPL executes background functors.
 //
 // OperationContext life-cycle
@@ -31,7 +34,7 @@
 // - Schedule* methods enqueue contexts and manage supplier connections.
 // - collectOperationContexts scans scheduled queues (by phase), activates contexts,
 //   and transfers them to the "radio actives" queue for potential inline/parallel run.
-// - TryRunningTaskInline tries to acquire a unique run license and inlines execution.
+// - TryRunningTaskInline tries to acquire a unique run license (activated -> running, lock-free) and inlines execution.
 // - Join waits for completion; on non-main threads it steals work; on main thread it
 //   pumps UI-related work and respects suspend triggers.
 // - OnEnd/separateResources finalize state, detach waiters/suppliers, and free resources.
@@ -40,14 +43,17 @@
 // ---------------
 // Manages a pool of tile tasks with ticketing (commissioned slots) and cooperatively
 // executes them via the same task_group. It supports:
-// - Work stealing by threads via TakeOneTileTask.
+// - Work stealing by threads via per-thread Chase-Lev deques (takeOneTileTask).
 // - Exception propagation and early decommissioning.
-// - Controlled thread commissioning based on available vCPUs.
+// - Controlled thread commissioning based on available vCPUs; when low on RAM (see utl/MemGuard.h),
+//   at most one worker is commissioned and idle workers decommission, which limits the number of tiles in progress.
 //
 // Important invariants and practices
 // ----------------------------------
-// - All modifications to scheduling state happen under cs_ThreadMessing.
-// - All modifications to tile_task_group registry happen under s_TileTaskGroupsMutex.
+// - All modifications to scheduling state happen under cs_ThreadMessing, except the
+//   activated -> running transition, which is a compare-exchange that only one thread can win.
+// - tile_task_group slot ticketing and deque operations are lock-free; a group's
+//   m_Mutex is only taken to settle an exception or to signal completion.
 // - Notifications (cv_TaskCompleted) are signaled while holding cs_ThreadMessing to
 //   avoid missed wakeups.
 // - No lock order inversions: keep lock ordering consistent and avoid acquiring
@@ -89,6 +95,7 @@
 #include "LockLevels.h"
 #include "LispTreeType.h"
 
+#include "CalcCache.h"
 #include "DataLocks.h"
 #include "DataStoreManagerCaller.h"
 #include "Operator.h"
@@ -115,97 +122,151 @@ concurrency::task_group& GetTaskGroup();
 // A light-weight ticket dispenser for tile-level tasks.
 // - Multiple tile_task_group instances can coexist. Each instance has 'm_Last'
 //   indicating the total number of tiles (tickets).
-// - Global array s_TileTaskGroups functions as a registry for stealing.
-// - Threads grab a commissioned index and process it; completion is tracked.
+// - Slots are commissioned with an atomic increment of m_Commissioned; no lock is
+//   taken per slot.
+// - Each thread owns a Chase-Lev work-stealing deque of tile_task_group pointers.
+//   A new group is pushed on the deque of its constructing thread; worker threads
+//   pop from their own deque and steal from the top of the others. A worker that
+//   obtained a slot from a group with remaining slots pushes it on its own deque,
+//   so that the group stays available for other thieves.
+// - Every deque entry holds a reference (counted in m_NrPending together with the
+//   uncompleted slots). A group is done, and can be destructed, when m_NrPending
+//   drops to zero; that transition is signalled under the group's own m_Mutex.
+// - s_TileTaskDequesMutex is only taken to register or recycle a thread's deque.
 // - Destructor waits for all slots to be completed or propagates exception.
 //
 // *****************************************************************************
 
 #include "ParallelTiles.h"
-#include <numeric>
+#include "set/WorkStealingDeque.h"
 
-// Global registry of tile task groups for work stealing.
-static std::vector<tile_task_group*> s_TileTaskGroups;
-// Guards s_TileTaskGroups.
-std::mutex s_TileTaskGroupsMutex;
+struct tile_task_deque : work_stealing_deque<tile_task_group*> {};
+
+// Registry of per-thread deques for work stealing. Deques are never destroyed, since thieves may still inspect them;
+// the deque of a terminated thread is recycled for a new thread, including the entries that it still holds.
+template <typename Deque>
+struct per_thread_deques
+{
+	static constexpr UInt32 MAX_NR_DEQUES = 1024;
+
+	// Returns the deque of the calling thread, or nullptr when all MAX_NR_DEQUES are in use.
+	Deque* GetOwn()
+	{
+		static thread_local handle s_Own;
+		if (!s_Own.m_Deque)
+		{
+			auto lock = std::lock_guard(m_Mutex);
+			if (!m_FreeDeques.empty())
+			{
+				s_Own.m_Deque = m_FreeDeques.back();
+				m_FreeDeques.pop_back();
+			}
+			else
+			{
+				auto nrDeques = m_NrDeques.load(std::memory_order_relaxed);
+				if (nrDeques < MAX_NR_DEQUES)
+				{
+					s_Own.m_Deque = new Deque;
+					m_Deques[nrDeques].store(s_Own.m_Deque, std::memory_order_release);
+					m_NrDeques.store(nrDeques + 1, std::memory_order_release);
+				}
+			}
+			s_Own.m_Registry = this;
+		}
+		return s_Own.m_Deque;
+	}
+
+	UInt32 GetNrDeques() const { return m_NrDeques.load(std::memory_order_acquire); }
+	Deque* GetDeque(UInt32 i) const { return m_Deques[i].load(std::memory_order_acquire); }
+
+private:
+	struct handle
+	{
+		per_thread_deques* m_Registry = nullptr;
+		Deque* m_Deque = nullptr;
+
+		~handle()
+		{
+			if (!m_Deque)
+				return;
+			auto lock = std::lock_guard(m_Registry->m_Mutex);
+			m_Registry->m_FreeDeques.emplace_back(m_Deque);
+		}
+	};
+
+	std::atomic<Deque*> m_Deques[MAX_NR_DEQUES] = {};
+	std::atomic<UInt32> m_NrDeques = 0;
+	std::vector<Deque*> m_FreeDeques;
+	std::mutex m_Mutex; // guards m_FreeDeques and the registration of new deques.
+};
+
+static per_thread_deques<tile_task_deque> s_TileTaskDeques;
 // Global cancellation flag for tile tasks (currently unused here).
 static bool s_IsCancelled = false;
 
 // Number of worker threads currently running DoThisOrThatAndDecommission loop.
-static UInt32 s_NrRunningTileTaskThreads = 0;
+static std::atomic<UInt32> s_NrRunningTileTaskThreads = 0;
 
 static concurrency::task_group* s_OcTaskGroup = nullptr;
 static bool s_OcTaskGroupIsCanceling = false;
 
-
-void CheckThis(tile_task_group* self)
+// Returns the deque of the calling thread, or nullptr when all deques are in use.
+// All tile_task_groups constructed by a thread are withdrawn before it terminates and worker loops drain their own deque,
+// thus a recycled deque is empty.
+tile_task_deque* GetOwnTileTaskDeque()
 {
-#if defined(MG_DEBUG)
-	assert(!s_TileTaskGroupsMutex.try_lock()); // don't let the notification fall outside a waiter lock
-
-	auto nrCompleted = std::accumulate(self->md_CompletedWork.begin(), self->md_CompletedWork.end(), 0, std::plus<>());
-	assert(nrCompleted == self->m_NrCompleted);
-
-	if (self->m_Commissioned == 858 && self->m_Last == 857)
-	{
-		reportD(SeverityTypeID::ST_Warning, "Daar gaan we");
-	}
-	if (self->m_NrCompleted == 856 && self->m_Last == 857)
-	{
-		reportD(SeverityTypeID::ST_Warning, "KoekKoek");
-	}
-#endif
+	return s_TileTaskDeques.GetOwn();
 }
 
-// Internal: pop a valid commissioned slot from any registered tile_task_group.
-// Requires s_TileTaskGroupsMutex to be held.
-auto takeOneTileTask() -> std::pair<tile_task_group*, tile_task_group::IndexType>
+// Internal: take entries from victim (popping when it is the own deque, stealing otherwise) until a slot is obtained.
+// The reference of each taken entry is either passed on to ownDeque (mayRepush and the group has remaining slots) or released.
+auto takeOneTileTaskFrom(tile_task_deque* victim, tile_task_deque* ownDeque, bool mayRepush) -> std::pair<tile_task_group*, tile_task_group::IndexType>
 {
 	assert(!SuspendTrigger::DidSuspend());
-	assert(!s_TileTaskGroupsMutex.try_lock());
-	while (!s_TileTaskGroups.empty())
+	while (auto* taskGroup = (victim == ownDeque) ? victim->pop() : victim->steal())
 	{
-		auto* taskGroup = s_TileTaskGroups.back();
-		if (taskGroup)
-		{
-			auto i = taskGroup->getNextCommissioned();
-			if (IsDefined(i))
-				return { taskGroup, i };
-			if (SuspendTrigger::DidSuspend())
-				break;
-		}
-		s_TileTaskGroups.pop_back();
+		auto i = taskGroup->getNextCommissioned();
+		if (IsDefined(i) && mayRepush && ownDeque && taskGroup->hasUncommissioned())
+			ownDeque->push(taskGroup); // keep the remaining slots available for thieves
+		else
+			taskGroup->releasePending(1); // from here, taskGroup can only be accessed with a valid ticket to a slot
+		if (IsDefined(i))
+			return { taskGroup, i };
+		if (SuspendTrigger::DidSuspend())
+			break;
 	}
 	return { nullptr, UNDEFINED_VALUE(tile_task_group::IndexType) };
 }
 
-// Try to take a tile task. Thread-safe wrapper.
-auto TakeOneTileTask() -> std::pair<tile_task_group*, tile_task_group::IndexType>
+// Internal: obtain a commissioned slot from the own deque, or else steal one from the deque of another thread.
+auto takeOneTileTask(tile_task_deque* ownDeque, bool mayRepush) -> std::pair<tile_task_group*, tile_task_group::IndexType>
 {
-	assert(!SuspendTrigger::DidSuspend());
-
-	auto lock = std::unique_lock<std::mutex>(s_TileTaskGroupsMutex);
-	return takeOneTileTask();
-}
+	if (ownDeque)
+	{
+		auto tileTask = takeOneTileTaskFrom(ownDeque, ownDeque, mayRepush);
+		if (tileTask.first || SuspendTrigger::DidSuspend())
+			return tileTask;
+	}
 
-// Take a tile task or decide the caller should decommission its worker thread.
-auto TakeOneTaskOrDecommissionThread() -> std::pair<tile_task_group*, tile_task_group::IndexType>
-{
-	auto lock = std::unique_lock<std::mutex>(s_TileTaskGroupsMutex);
-	auto tileTask = takeOneTileTask();
-	if (!SuspendTrigger::DidSuspend())
-		if (!tileTask.first)
-		{
-			assert(s_NrRunningTileTaskThreads > 0);
-			--s_NrRunningTileTaskThreads; // no task available, caller must decommission this thread
-		}
-	return tileTask;
+	static thread_local UInt32 tl_NextVictim = 0;
+	auto nrDeques = s_TileTaskDeques.GetNrDeques();
+	auto firstVictim = tl_NextVictim++;
+	for (UInt32 k = 0; k != nrDeques; ++k)
+	{
+		auto* victim = s_TileTaskDeques.GetDeque((firstVictim + k) % nrDeques);
+		if (!victim || victim == ownDeque)
+			continue;
+		auto tileTask = takeOneTileTaskFrom(victim, ownDeque, mayRepush);
+		if (tileTask.first || SuspendTrigger::DidSuspend())
+			return tileTask;
+	}
+	return { nullptr, UNDEFINED_VALUE(tile_task_group::IndexType) };
 }
 
-// Attempt to steal and execute a single tile task. Returns true if did work.
+// Attempt to steal and execute the slots of a single tile task group.
 void StealTasks()
 {
-	auto tileTask = TakeOneTileTask();
+	auto tileTask = takeOneTileTask(GetOwnTileTaskDeque(), false);
 	if (tileTask.first)
 	{
 		assert(!SuspendTrigger::DidSuspend());
@@ -220,15 +281,30 @@ void DoThisOrThatAndDecommission()
 	SuspendTrigger::SilentBlocker blockSuspensionInWorkerTask("DoThisOrThatAndDecommission");
 	assert(!SuspendTrigger::DidSuspend());
 
+	auto ownDeque = GetOwnTileTaskDeque();
 	while(true)
 	{
-		auto tileTask = TakeOneTaskOrDecommissionThread();
+		auto tileTask = takeOneTileTask(ownDeque, true);
 		assert(!SuspendTrigger::DidSuspend());
 		if (!tileTask.first)
+		{
+			assert(!ownDeque || ownDeque->empty());
+			assert(s_NrRunningTileTaskThreads > 0);
+			--s_NrRunningTileTaskThreads; // no task available, decommission this thread
 			return;
+		}
 		assert(IsDefined(tileTask.second)); // we assume starting with a valid ticket to a slot, or else this tile_task_group may already be destroyed.
 		tileTask.first->DoWork(tileTask.second);
 		assert(!SuspendTrigger::DidSuspend());
+
+		// when low on RAM, reduce the number of workers between task groups; remaining slots are processed by the others or by the owner in Join.
+		if ((!ownDeque || ownDeque->empty()) && IsLowOnFreeRAM())
+		{
+			auto nrRunningThreads = s_NrRunningTileTaskThreads.load(std::memory_order_relaxed);
+			while (nrRunningThreads > 1)
+				if (s_NrRunningTileTaskThreads.compare_exchange_weak(nrRunningThreads, nrRunningThreads - 1, std::memory_order_relaxed))
+					return;
+		}
 	}
 }
 
@@ -238,161 +314,145 @@ tile_task_group::tile_task_group(IndexType last, task_func func)
 	: m_Last(last)
 	, m_Func(func)
 	, m_CallingContext(CancelableFrame::CurrActive())
+	, m_NrPending(last)
 {
 #if defined(MG_DEBUG)
 	md_CompletedWork.resize(m_Last);
 #endif
 
-	UInt32 nrThreadsToCommission = 0;
-	if (m_Last > 0)
+	if (!m_Last)
 	{
-		auto lock = std::unique_lock<std::mutex>(s_TileTaskGroupsMutex);
-		s_TileTaskGroups.emplace_back(this);
+		m_IsDone = true;
+		return;
+	}
 
-		// Fire workers, bounded by available vCPUs and remaining slots.
-		if (IsMultiThreaded1())
-		{
-			auto maxNrThreads = GetNrVCPUs();
-			if (s_NrRunningTileTaskThreads < maxNrThreads)
+	m_OwnerDeque = GetOwnTileTaskDeque();
+	if (!m_OwnerDeque)
+		return; // not stealable, Join will do all the work.
+
+	++m_NrPending; // reference of the entry in the owner's deque
+	m_OwnerDeque->push(this);
+
+	// Fire workers, bounded by available vCPUs, available RAM and remaining slots.
+	UInt32 nrThreadsToCommission = 0;
+	if (IsMultiThreaded1())
+	{
+		auto maxNrThreads = IsLowOnFreeRAM() ? 1 : GetNrVCPUs();
+		auto nrRunningThreads = s_NrRunningTileTaskThreads.load(std::memory_order_relaxed);
+		do {
+			if (nrRunningThreads >= maxNrThreads)
 			{
-				nrThreadsToCommission = maxNrThreads - s_NrRunningTileTaskThreads;
-				if (last < nrThreadsToCommission)
-					nrThreadsToCommission = last;
+				nrThreadsToCommission = 0;
+				break;
 			}
-		}
-		s_NrRunningTileTaskThreads += nrThreadsToCommission;
+			nrThreadsToCommission = maxNrThreads - nrRunningThreads;
+			if (m_Last < nrThreadsToCommission)
+				nrThreadsToCommission = m_Last;
+		} while (!s_NrRunningTileTaskThreads.compare_exchange_weak(nrRunningThreads, nrRunningThreads + nrThreadsToCommission, std::memory_order_relaxed));
 	}
 
-	// Launch workers outside of lock.
 	while (nrThreadsToCommission-- > 0)
 		GetTaskGroup().run([] { DoThisOrThatAndDecommission(); });
 }
 
-// Destructor waits for all commissioned slots to complete and propagates exceptions.
+// Destructor waits for all commissioned slots to complete and deque entries to be released.
 tile_task_group::~tile_task_group()
 {
-	auto lock = std::unique_lock<std::mutex>(s_TileTaskGroupsMutex);
-	if (m_Commissioned < m_Last) // recheck if decommission is still required
-	{
-		auto remainingTasks = (m_Last - m_Commissioned); // current slot still has to be registered as completed, after which this task_group may be destructed.
-		m_Commissioned += remainingTasks;
-		CheckThis(this);
-		assert(m_Commissioned == m_Last);
-		decommission(); // stop handing out slots for this task group, so that no new tasks will be started, but the current ones can still finish.
-		registerCompletions(remainingTasks); // other tasks in flight might still come in before m_TileTasksDone can be notified.
-	}
-	assert(m_Commissioned == m_Last); // we now expect to have completed all commissioned task-slots.
-	while (true)
-	{
-		if (m_NrCompleted >= m_Last)
-			break;
+	auto remainingTasks = commissionAllRemaining(); // stop handing out slots for this task group, so that no new tasks will be started, but the current ones can still finish.
+	if (remainingTasks)
+		releasePending(remainingTasks);
+	withdrawFromOwnerDeque();
 
+	auto lock = std::unique_lock(m_Mutex);
+	while (!m_IsDone)
 		m_TileTasksDone.wait_for(lock, std::chrono::milliseconds(500));
-	}
-	assert(m_NrCompleted == m_Last); // we now expect to have completed all commissioned task-slots.
-}
-
-// Remove this group from the global registry, preventing new slots to be handed out.
-void tile_task_group::decommission()
-{
-	assert(!s_TileTaskGroupsMutex.try_lock()); // don't let the notification fall outside a waiter lock
-	assert(m_Commissioned == m_Last);
-
-	auto ttgFirst = s_TileTaskGroups.begin();
-	auto ttgPtr = s_TileTaskGroups.end();
-
-	while (ttgPtr != ttgFirst)
-		if (*--ttgPtr == this)
-		{
-			*ttgPtr = nullptr; // decommission this task group
-			break;
-		}
+	assert(m_NrPending == 0);
 }
 
 // Commission next slot if available and return the ticket; otherwise undefined.
 auto tile_task_group::getNextCommissioned() -> IndexType
 {
 	assert(!SuspendTrigger::DidSuspend());
-	assert(!s_TileTaskGroupsMutex.try_lock()); // don't let the notification fall outside a waiter lock
 
-	if (m_Commissioned >= m_Last)
+	if (!hasUncommissioned())
 		return UNDEFINED_VALUE(IndexType);
 
 	if (SuspendTrigger::MustSuspend())
 		return UNDEFINED_VALUE(IndexType);
 
-	auto result = m_Commissioned++; // ownership of this slot of the task_group is now obtained and will continue until this thread causes m_NrCompleted to increment accordingly
-	CheckThis(this);
-	assert(result < m_Last);
-	if (m_Commissioned >= m_Last)
-		decommission(); // stop handing out slots for this task group, so that no new tasks will be started, but the current ones, including the slot that the caller must complete, can still finish.
+	auto result = m_Commissioned.fetch_add(1, std::memory_order_relaxed); // ownership of this slot of the task_group is now obtained and will continue until this thread releases it with releasePending
+	if (result >= m_Last)
+		return UNDEFINED_VALUE(IndexType); // another thread took the last slot
 	return result;
 }
 
-// Thread-safe wrapper to get a commissioned slot.
-auto tile_task_group::GetNextCommissioned() -> IndexType
+// Claim all slots that have not been commissioned yet; returns their number.
+auto tile_task_group::commissionAllRemaining() -> IndexType
 {
-	auto lock = std::unique_lock<std::mutex>(s_TileTaskGroupsMutex);
-	return getNextCommissioned();
+	auto commissioned = m_Commissioned.exchange(m_Last, std::memory_order_relaxed);
+	return (commissioned < m_Last) ? m_Last - commissioned : 0;
 }
 
-// Register multiple completions (e.g., on exception settle path).
-void tile_task_group::registerCompletions(IndexType nr)
+// Release completed slots and/or deque references. After this, only the owner or another holder of a slot or reference may access this.
+void tile_task_group::releasePending(IndexType nr)
 {
-	assert(!s_TileTaskGroupsMutex.try_lock()); // don't let the notification fall outside a waiter lock
-
 	assert(nr);
-	m_NrCompleted += nr;
-	CheckThis(this);
-	assert(m_NrCompleted <= m_Last);
-	if (m_NrCompleted == m_Last)
-		m_TileTasksDone.notify_all();
-}
-
-bool tile_task_group::registerCompletion(IndexType i)
-{
-	assert(!s_TileTaskGroupsMutex.try_lock()); // don't let the notification fall outside a waiter lock
-
-	assert(m_NrCompleted < m_Last);
-
-#if defined(MG_DEBUG)
-	assert(md_CompletedWork[i] == 0);
-	md_CompletedWork[i] = 1;
-#endif
+	auto nrPending = m_NrPending.fetch_sub(nr, std::memory_order_acq_rel);
+	assert(nrPending >= nr);
+	if (nrPending != nr)
+		return;
 
-	auto nrCompleted = ++m_NrCompleted; // don't increment outside lock as it may cause another thread to Join and destruct
-	CheckThis(this);
-	if (nrCompleted != m_Last) 
-		return false;
+	auto lock = std::lock_guard(m_Mutex); // don't let the notification fall outside a waiter lock
+	m_IsDone = true;
 	m_TileTasksDone.notify_all();
-	return true;
-}
-
-/*
-// Register a single completion.
-void tile_task_group::RegisterCompletion(IndexType i)
-{
-	auto lock = std::unique_lock<std::mutex>(s_TileTaskGroupsMutex); // don't let the notification fall outside a waiter lock
-
-	registerCompletion(i); // perform debug checks and bookkeeping for this completion
 }
-*/
 
-// Register completion and immediately try to commission a next slot (if any).
-auto tile_task_group::RegisterCompletionAndGetNextCommissioned(IndexType i)->IndexType
+// Release the entry in the deque of the constructing thread, unless a thief already took it.
+void tile_task_group::withdrawFromOwnerDeque()
 {
-	assert(!SuspendTrigger::DidSuspend());
-	auto lock = std::unique_lock<std::mutex>(s_TileTaskGroupsMutex); // don't let the notification fall outside a waiter lock
-
-	auto isCompleted = registerCompletion(i); // perform debug checks and bookkeeping for this completion
+	auto ownerDeque = std::exchange(m_OwnerDeque, nullptr);
+	if (!ownerDeque)
+		return;
 
-	if (isCompleted)
-		return UNDEFINED_VALUE(IndexType);
+	if (ownerDeque == GetOwnTileTaskDeque())
+	{
+		// Task groups that were constructed later on this thread but are joined after this one have their entries below this one;
+		// these are popped and pushed back in their original order, so that only the entry of this is removed, if it wasn't stolen.
+		std::vector<tile_task_group*> laterEntries;
+		while (auto* taskGroup = ownerDeque->pop())
+		{
+			if (taskGroup == this)
+			{
+				releasePending(1);
+				break;
+			}
+			laterEntries.emplace_back(taskGroup);
+		}
+		for (auto ri = laterEntries.rbegin(); ri != laterEntries.rend(); ++ri)
+			ownerDeque->push(*ri);
+		return;
+	}
 
-	return getNextCommissioned();
+	// Joined or destructed on another thread than the constructing one, which may only steal from the top of the owner's deque.
+	// Entries of other groups above this one are not dropped, as their owners rely on them for parallel processing:
+	// their remaining slots are processed here, as any thief would, before their entry is released.
+	SuspendTrigger::SilentBlocker dontSuspendThis("tile_task_group::withdrawFromOwnerDeque()");
+	while (auto* taskGroup = ownerDeque->steal())
+	{
+		if (taskGroup == this)
+		{
+			releasePending(1);
+			return;
+		}
+		auto i = taskGroup->getNextCommissioned();
+		if (IsDefined(i))
+			taskGroup->DoWork(i); // continues with all remaining slots; the deque entry keeps taskGroup alive meanwhile
+		taskGroup->releasePending(1);
+	}
+	// a thief took this entry and releases it after taking its slots
 }
 
-// Execute slot 'i' and optionally continue with more slots (doMore=true).
+// Execute slot 'i' and continue with more slots of this task group.
 // Handles cancellation and exception paths, ensuring proper decommissioning.
 void tile_task_group::DoWork(IndexType i)
 {
@@ -410,47 +470,39 @@ void tile_task_group::DoWork(IndexType i)
 			UpdateMarker::PrepareDataInvalidatorLock preventInvalidations;
 			m_Func(i);
 
-			i = RegisterCompletionAndGetNextCommissioned(i); // release this slot and obtain the next one, or none if this task group is done.
+#if defined(MG_DEBUG)
+			assert(md_CompletedWork[i] == 0);
+			md_CompletedWork[i] = 1;
+#endif
+			auto nextSlot = getNextCommissioned(); // obtain the next slot before releasing this one, as releasing the last pending slot allows the owner to destruct this.
+			releasePending(1);
+			i = nextSlot;
 		}
-//		assert((m_Commissioned == m_Last) || SuspendTrigger::DidSuspend()); // post condition, but this task_group may already be destructed by owner
 	}
 	catch (...)
 	{
-		auto lock = std::unique_lock<std::mutex>(s_TileTaskGroupsMutex);
-		if (m_ExceptionPtr)
-			registerCompletions(1); // release this slot of the task_group, so from here, this may be destroyed; decommissioning already was done by an earlier settler of m_Exception.
-		else
 		{
-			m_ExceptionPtr = std::current_exception();
-			auto remainingTasks = m_Last - m_Commissioned; // current slot still has to be registered as completed, after which this task_group may be destructed.
-			m_Commissioned += remainingTasks;
-			CheckThis(this);
-			assert(m_Commissioned == m_Last);
-			decommission(); // stop handing out slots for this task group, so that no new tasks will be started, but the current ones can still finish.
-			registerCompletions(1 + remainingTasks); // other tasks in flight might still come in before m_TileTasksDone can be notified.
+			auto lock = std::lock_guard(m_Mutex);
+			if (!m_ExceptionPtr)
+				m_ExceptionPtr = std::current_exception();
 		}
-//		assert(m_Commissioned == m_Last); // post condition, but this task_group may already be destructed by owner
+		auto remainingTasks = commissionAllRemaining(); // stop handing out slots for this task group, so that no new tasks will be started, but the current ones can still finish.
+		releasePending(1 + remainingTasks); // release this slot of the task_group, so from here, this may be destroyed.
 	}
 }
 
-// Wait until all commissioned slots are completed. No exceptions thrown.
+// Wait until all commissioned slots are completed. Throws when the calling context gets cancelled.
 void tile_task_group::AwaitRunningSlots() 
 {
-	MG_CHECK(m_Commissioned == m_Last); // post condition of DoWork
+	MG_CHECK(!hasUncommissioned()); // post condition of DoWork
 
-	while (true)
+	auto lock = std::unique_lock(m_Mutex);
+	while (!m_IsDone)
 	{
 		// TODO: this can cause other tiles to process that use the same m_Mutex in FutureTileFunctor::tile_record::GetTile
 		// if (StealOneTileTask(false))
 		//	 continue;
 
-		auto lock = std::unique_lock<std::mutex>(s_TileTaskGroupsMutex);
-
-		assert(m_NrCompleted <= m_Last);
-
-		if (m_NrCompleted >= m_Last)
-			break;
-
 		if (m_CallingContext)
 			DSM::CancelIfOutOfInterest();
 		ASyncContinueCheck(); // can throw !
@@ -465,12 +517,13 @@ void tile_task_group::Join()
 	assert(!SuspendTrigger::DidSuspend());
 	SuspendTrigger::SilentBlocker dontSuspendThis("tile_task_group::Join()");
 
-	IndexType nextSlot = GetNextCommissioned();
+	IndexType nextSlot = getNextCommissioned();
 	if (IsDefined(nextSlot))
 		DoWork(nextSlot);
 	assert(!SuspendTrigger::DidSuspend());
-	assert(m_Commissioned == m_Last); // post condition of DoWork
+	assert(!hasUncommissioned()); // post condition of DoWork
 
+	withdrawFromOwnerDeque();
 	AwaitRunningSlots();
 	// no more other worker threads can access this task group, so we can safely access m_ExceptionPtr now.
 
@@ -535,8 +588,8 @@ void OperatorContextHandle::GenerateDescription()
 //
 // Central scheduling structures and synchronization for OperationContext.
 // - s_ScheduledContextsMap: per-phase queues of weak_ptrs ready to be activated.
-// - s_RadioActives: "radio-active" queue of contexts that have been activated and
-//   are candidates for inline execution or stealing.
+// - s_RadioActiveDeques: per-thread work-stealing deques of contexts that have been activated
+//   and are candidates for inline execution or stealing; they are lock-free.
 // - s_NrActivatedOrRunningOperations: per-phase counters (activated+running).
 // - s_CurrActivePhaseNumber: currently focus phase; only this phase is activated.
 //
@@ -545,7 +598,7 @@ void OperatorContextHandle::GenerateDescription()
 leveled_std_section cs_ThreadMessing(item_level_type(0), ord_level_type::ThreadMessing, "LockedThreadMessing");
 std::condition_variable cv_TaskCompleted;
 
-phase_number s_CurrBlockedPhaseNumber = 0;
+std::atomic<phase_number> s_CurrBlockedPhaseNumber = 0;
 const TreeItem* s_CurrBlockedPhaseItem = nullptr;
 const TreeItem* s_CurrPhaseContainer = nullptr;
 
@@ -555,9 +608,13 @@ using RunningOperationsCounter = UInt32;
 
 // protected by exclusive lock on cs_ThreadMessing
 static std::map<phase_number, contexts_within_one_phase> s_ScheduledContextsMap;
-static contexts_within_one_phase s_RadioActives; // contexts that were collected for running, some of them may be already running, made for work stealing and prioritizing in case the GUI thread calls Join on a specific context.
 static std::map<phase_number, RunningOperationsCounter> s_NrActivatedOrRunningOperations; 
-static phase_number s_CurrActivePhaseNumber = 0;
+static std::atomic<phase_number> s_CurrActivePhaseNumber = 0; // only modified under cs_ThreadMessing, but also read by GetUniqueLicenseToRun
+
+// contexts that were collected for running, some of them may be already running, made for work stealing and prioritizing in case the GUI thread calls Join on a specific context.
+// Entries are heap allocated weak pointers, owned by the deque until a thread takes them.
+struct radio_active_deque : work_stealing_deque<OperationContextWPtr*> {};
+static per_thread_deques<radio_active_deque> s_RadioActiveDeques;
 static bool s_IsInLowRamMode = false;
 static UInt32 s_CurrFinishedCount = 0;
 
@@ -700,11 +757,12 @@ TIC_CALL tg_maintainer::~tg_maintainer()
 		dbg_assert(sd_runOperationContextsRecursionCount == 0);
 
 		s_ScheduledContextsMap.clear();
-		s_RadioActives.clear();
-
 		assert(s_ScheduledContextsMap.empty());
-		assert(s_RadioActives.empty());
 	}
+	for (UInt32 i = 0, n = s_RadioActiveDeques.GetNrDeques(); i != n; ++i)
+		while (auto entry = s_RadioActiveDeques.GetDeque(i)->steal())
+			delete entry;
+
 	s_OcTaskGroup->cancel();
 	s_OcTaskGroup->wait();
 
@@ -834,15 +892,17 @@ void connect(OperationContext* waiter, OperationContextSPtr supplier)
 void scheduleRunnableTask(OperationContext* self)
 {
 	assert(!cs_ThreadMessing.try_lock());
-	assert(self->m_Status < task_status::scheduled || self->m_Status == task_status::activated);
+	assert(self->m_Status < task_status::scheduled || self->m_Status == task_status::running); // running: claimed by getUniqueLicenseToRun to place it back
 
 	// next StartOperationContexts() must not start scheduling tasks with phase numbers higher than this task.
 	auto fn = self->m_PhaseNumber;
-	MakeMin<phase_number>(s_CurrActivePhaseNumber, fn);
+	if (fn < s_CurrActivePhaseNumber)
+		s_CurrActivePhaseNumber = fn;
 	assert(s_CurrBlockedPhaseNumber == 0 || s_CurrBlockedPhaseNumber >= s_CurrActivePhaseNumber);
 
 	s_ScheduledContextsMap[fn].emplace_back(self->weak_from_this());
-	self->releaseRunCount(task_status::scheduled);
+	[[maybe_unused]] bool released = self->releaseRunCount(task_status::scheduled);
+	assert(released);
 	assert(self->m_Status == task_status::scheduled);
 	assert(!self->m_FuncDC || self->GetOperator()->CanRunParallel());
 	assert(IsDefined(getScheduledContextsPos(self->shared_from_this()))); // always true for scheduled tasks outzide cs_ThreadMessing
@@ -1130,6 +1190,18 @@ TIC_CALL void StartOperationContexts()
 
 inline bool IsActiveOrRunning(task_status s) { return s >= task_status::activated && s <= task_status::running; }
 
+// Transition from 'expected' to 'status'. Requires cs_ThreadMessing.
+// All status changes go through a compare_exchange, as OperationContext_ClaimLicenseToRun changes activated to running without the lock.
+void OperationContext_TransitStatus(OperationContext* self, task_status expected, task_status status)
+{
+	assert(!cs_ThreadMessing.try_lock());
+	assert(!IsActiveOrRunning(expected)); // else a lock-free claimant could have intervened
+
+	auto prior = expected;
+	bool transited = self->m_Status.compare_exchange_strong(prior, status, std::memory_order_acq_rel);
+	MG_CHECK(transited);
+}
+
 // Transition a context to 'activated' and bump counters. Requires cs_ThreadMessing.
 void OperationContex_setActivated(OperationContext* self)
 {
@@ -1143,7 +1215,7 @@ void OperationContex_setActivated(OperationContext* self)
 	CheckNumberOfRunningOCConsistency();
 #endif
 
-	self->m_Status = task_status::activated;
+	OperationContext_TransitStatus(self, self->getStatus(), task_status::activated);
 	++s_NrActivatedOrRunningOperations[self->m_PhaseNumber];
 
 	assert(IsActiveOrRunning(self->m_Status));
@@ -1277,7 +1349,7 @@ void OperationContext_scheduleThis(OperationContext* self)
 			else
 				OperationContext_scheduleThis(supplier);
 		}
-		self->m_Status = task_status::waiting_for_suppliers;
+		OperationContext_TransitStatus(self, task_status::none, task_status::waiting_for_suppliers);
 		assert(!(self->m_Suppliers.empty()));
 	}
 }
@@ -1429,7 +1501,7 @@ task_status OperationContext::GetStatus() const
 }
 
 // Try to collect task payload and transition to 'activated'.
-// Adds to s_RadioActives for potential inline/stealing.
+// Pushes it on the radio-active deque of this thread for potential inline/stealing.
 bool OperationContext::collectTaskImpl()
 {
 	assert(!cs_ThreadMessing.try_lock());
@@ -1456,8 +1528,8 @@ bool OperationContext::collectTaskImpl()
 
 	m_ResKeeper = std::move(resKeeper);
 
-	std::weak_ptr<OperationContext> selfWptr = shared_from_this();
-	s_RadioActives.emplace_back(selfWptr);
+	if (auto ownDeque = s_RadioActiveDeques.GetOwn())
+		ownDeque->push(new OperationContextWPtr(weak_from_this()));
 	return true;
 }
 
@@ -1475,7 +1547,14 @@ bool OperationContext::TryRunningTaskInline()
 }
 
 
-// Acquire the unique run license under scheduling constraints (phase fences).
+// Transition from activated to running; only one thread ever wins per OC. Doesn't require cs_ThreadMessing.
+bool OperationContext_ClaimLicenseToRun(OperationContext* self)
+{
+	auto status = task_status::activated;
+	return self->m_Status.compare_exchange_strong(status, task_status::running, std::memory_order_acq_rel);
+}
+
+// Acquire the unique run license under scheduling constraints (phase fences). Requires cs_ThreadMessing.
 // If 'runDirect' is false and the phase is not active, reschedule back.
 bool  OperationContext::getUniqueLicenseToRun(bool runDirect)
 {
@@ -1494,7 +1573,8 @@ bool  OperationContext::getUniqueLicenseToRun(bool runDirect)
 	if (!runDirect)
 		if (m_PhaseNumber > s_CurrActivePhaseNumber)
 		{
-			scheduleRunnableTask(this); // place it back 
+			if (OperationContext_ClaimLicenseToRun(this)) // keep lock-free claimants out
+				scheduleRunnableTask(this); // place it back 
 			return false;
 		}
 
@@ -1502,15 +1582,46 @@ bool  OperationContext::getUniqueLicenseToRun(bool runDirect)
 	if (GetTaskGroup().is_canceling())
 		throw task_canceled{};
 
-	m_Status = task_status::running;
-	return true;
+	return OperationContext_ClaimLicenseToRun(this);
 }
 
-// Thread-safe wrapper for licensing.
+// Transition from running back to activated, for a claimant that hit a phase fence after its claim.
+void OperationContext_UnclaimLicenseToRun(OperationContext* self)
+{
+	auto status = task_status::running;
+	bool unclaimed = self->m_Status.compare_exchange_strong(status, task_status::activated, std::memory_order_acq_rel);
+	MG_CHECK(unclaimed);
+}
+
+// Thread-safe licensing; only takes cs_ThreadMessing when the phase of this is not active and it must be placed back.
+// s_CurrActivePhaseNumber can be lowered after the first test, therefore the phase fence is tested again after the claim;
+// a claim that still passes the fence is equivalent to a claim that preceded the lowering, as a running task is not placed back.
 bool OperationContext::GetUniqueLicenseToRun()
 {
+	if (getStatus() != task_status::activated)
+		return false;
+
+	if (m_PhaseNumber > s_CurrActivePhaseNumber)
+	{
+		leveled_std_section::scoped_lock lock(cs_ThreadMessing);
+		return getUniqueLicenseToRun(false);
+	}
+
+	DSM::CancelIfOutOfInterest(m_Result);
+	if (GetTaskGroup().is_canceling())
+		throw task_canceled{};
+
+	if (!OperationContext_ClaimLicenseToRun(this))
+		return false;
+
+	if (m_PhaseNumber <= s_CurrActivePhaseNumber)
+		return true;
+
 	leveled_std_section::scoped_lock lock(cs_ThreadMessing);
-	return getUniqueLicenseToRun(false);
+	if (m_PhaseNumber <= s_CurrActivePhaseNumber) // only lowered under cs_ThreadMessing
+		return true;
+	scheduleRunnableTask(this); // place it back
+	return false;
 }
 
 // Transition to 'exception' final state (no-throw wrapper).
@@ -1545,15 +1656,22 @@ void OperationContext::OnEnd(task_status status) noexcept
 	assert(getStatus() >= task_status::cancelled);
 }
 
-// Decrease activated/running count and set 'status'. Requires cs_ThreadMessing.
-void OperationContext::releaseRunCount(task_status status)
+// Set 'status' and decrease the activated/running count if it replaced one of those. Requires cs_ThreadMessing.
+// The replaced status is the one observed by the compare_exchange, so a concurrent lock-free claim (activated -> running) is never overwritten unaccounted.
+bool OperationContext::releaseRunCount(task_status status)
 {
 	assert(!IsActiveOrRunning(status));
 
 	assert(cs_ThreadMessing.isLocked());
 
-	assert(m_Status <= task_status::running);
-	if (IsActiveOrRunning(m_Status))
+	auto prior = m_Status.load(std::memory_order_acquire);
+	do {
+		if (prior >= task_status::cancelled) // don't change an already established final status
+			return false;
+		assert(prior <= task_status::running);
+	} while (!m_Status.compare_exchange_weak(prior, status, std::memory_order_acq_rel));
+
+	if (IsActiveOrRunning(prior))
 	{
 		assert(s_NrActivatedOrRunningOperations[m_PhaseNumber] > 0);
 
@@ -1581,9 +1699,7 @@ void OperationContext::releaseRunCount(task_status status)
 	if (status > task_status::running)
 		s_CurrFinishedCount++;
 	assert(s_NrActivatedOrRunningOperations[m_PhaseNumber] >= 0);
-	m_Status = status;
-	assert(!IsActiveOrRunning(m_Status));
-
+	return true;
 }
 
 // Core resource separation on final states: drop suppliers, task payload,
@@ -1593,10 +1709,8 @@ garbage_can OperationContext::separateResources(task_status status)
 	assert(cs_ThreadMessing.isLocked());
 
 	assert(status >= task_status::cancelled); // new status must be a final status
-	if (m_Status >= task_status::cancelled) // don't change an already established final status
+	if (!releaseRunCount(status)) // an already established final status is kept
 		return {};
-	
-	releaseRunCount(status);
 	assert(getStatus() == status);
 
 	garbage_can releaseBin;
@@ -2177,41 +2291,58 @@ auto PopActiveSuppliers(OperationContextSPtr waiter) -> std::pair<SupplierSet, c
 //
 // Work stealing for OperationContexts and tile tasks:
 //  - First try to steal a tile task.
-//  - Then try to pick an activated OperationContext from s_RadioActives and
-//    acquire the unique run license.
+//  - Then try to pick an activated OperationContext from the own radio-active deque,
+//    or else steal one from the deque of another thread, and acquire the unique run license.
 //  - Run inline if successful.
 //
 // *****************************************************************************
 
-// Find and license a single activated OperationContext to run inline.
-auto FindAndLicenceOnePriorityTasks() -> OperationContextSPtr
+// PhaseContainer blocks the phases from s_CurrBlockedPhaseNumber on while it updates the items of a phase.
+static bool IsBlockedByPhaseFence(phase_number pn)
 {
-	std::vector<OperationContextSPtr> garbage;
-
-	leveled_std_section::unique_lock lock(cs_ThreadMessing);
+	auto blockedPhaseNumber = s_CurrBlockedPhaseNumber.load();
+	return blockedPhaseNumber && pn >= blockedPhaseNumber;
+}
 
-	while (!s_RadioActives.empty()) {
-		auto oc = s_RadioActives.front(); 
+// Find and license a single activated OperationContext to run inline, without taking cs_ThreadMessing.
+auto FindAndLicenceOnePriorityTasks() -> OperationContextSPtr
+{
+	auto ownDeque = s_RadioActiveDeques.GetOwn();
+	auto nrDeques = s_RadioActiveDeques.GetNrDeques();
 
-		auto ocSPtr = oc.lock();
-		if (!ocSPtr) // expired?
-		{
-			s_RadioActives.pop_front();
+	static thread_local UInt32 tl_NextVictim = 0;
+	auto firstVictim = tl_NextVictim++;
+	for (UInt32 k = 0; k <= nrDeques; ++k)
+	{
+		auto* victim = k ? s_RadioActiveDeques.GetDeque((firstVictim + k) % nrDeques) : ownDeque;
+		if (!victim || (k && victim == ownDeque))
 			continue;
-		}
 
-		if (s_CurrBlockedPhaseNumber && ocSPtr->m_PhaseNumber >= s_CurrBlockedPhaseNumber) // phase fence?
-			return {};
+		while (auto entry = (victim == ownDeque) ? victim->pop() : victim->steal())
+		{
+			auto ocSPtr = std::unique_ptr<OperationContextWPtr>(entry)->lock();
+			if (!ocSPtr) // expired?
+				continue;
 
-		// take from the list
-		s_RadioActives.pop_front();
+			if (IsBlockedByPhaseFence(ocSPtr->m_PhaseNumber)) // phase fence? leave it for later
+			{
+				if (ownDeque)
+					ownDeque->push(new OperationContextWPtr(ocSPtr));
+				return {};
+			}
 
-		// try to grab the license—only one thread ever wins per OC
-		if (ocSPtr->getUniqueLicenseToRun(false))
-			return ocSPtr; // got it
-		// otherwise, someone else is already running it; try the next one
-		garbage.emplace_back(std::move(ocSPtr)); // maybe we-re the last owner and we dón't wat to destry here 
-		assert(!ocSPtr);
+			// try to grab the license—only one thread ever wins per OC
+			if (ocSPtr->GetUniqueLicenseToRun())
+			{
+				if (!IsBlockedByPhaseFence(ocSPtr->m_PhaseNumber)) // the fence can have been raised since the first test
+					return ocSPtr; // got it
+				OperationContext_UnclaimLicenseToRun(ocSPtr.get());
+				if (ownDeque)
+					ownDeque->push(new OperationContextWPtr(ocSPtr));
+				return {};
+			}
+			// otherwise, someone else is already running it; try the next one
+		}
 	}
 	return {};
 }
@@ -2267,7 +2398,7 @@ task_status OperationContext::Join()
 			, CancelableFrame::CurrActive()->GetResult()->GetFullName()
 		);
 	}
-	if (IsMetaThread() && s_CurrBlockedPhaseNumber && s_CurrBlockedPhaseNumber <= m_PhaseNumber)
+	if (IsMetaThread() && IsBlockedByPhaseFence(m_PhaseNumber))
 		throwErrorF("PhaseContainer", "Invalid Recursion, OperationContext(%s)::Join called from updating %s for %s"
 		,	GetResult()->GetFullName()
 		,	s_CurrBlockedPhaseItem->GetFullName()
@@ -2529,7 +2660,19 @@ void OperationContext::RunOperator(ArgRefs argRefs, std::vector<ItemReadLock> re
 			auto op = funcDC->m_Operator;
 			MG_CHECK(op);
 
-			actualResult = op->CalcResult(resultHolder, argRefs, std::move(readLocks), context.get()); // ============== payload
+			// try to restore the result from a previous session before calculating it
+			std::optional<CalcCache::key_t> calcCacheKey;
+			if (!context && resultHolder.IsNew())
+				calcCacheKey = CalcCache::GetKey(funcDC.get());
+			if (calcCacheKey)
+				actualResult = CalcCache::TryLoad(*calcCacheKey, AsDataItem(resultHolder.GetNew()));
+
+			if (!actualResult)
+			{
+				actualResult = op->CalcResult(resultHolder, argRefs, std::move(readLocks), context.get()); // ============== payload
+				if (actualResult && calcCacheKey && !resultHolder->WasFailed(FailType::Data))
+					CalcCache::Store(*calcCacheKey, AsDataItem(resultHolder.GetNew()));
+			}
 
 			assert(resultHolder || IsCanceled());
 			assert(actualResult || SuspendTrigger::DidSuspend());
@@ -50,6 +50,7 @@ Diagnostics:
 #include "MoreDataControllers.h"
 
 #include <ppltasks.h>
+#include <atomic>
 #include <optional>
 
 // tg_maintainer
@@ -178,9 +179,10 @@ public:
 
 	// GetUniqueLicenseToRun
 	// Acquire exclusive execution license to ensure only one active runner per context.
+	// Lock-free (compare-exchange of m_Status) unless the context must be placed back because its phase is not active.
 	TIC_CALL bool GetUniqueLicenseToRun();
 	// getUniqueLicenseToRun (overload)
-	// If runDirect is true, try to claim license immediately for inlining.
+	// Requires cs_ThreadMessing. If runDirect is true, try to claim license immediately for inlining.
 	TIC_CALL bool getUniqueLicenseToRun(bool runDirect);
 
 	// OnException
@@ -237,7 +239,8 @@ public:
 
 	// releaseRunCount
 	// Release execution license and update status upon completion.
-	void releaseRunCount(task_status status);
+	// Returns false, without changing anything, when a final status was already established.
+	bool releaseRunCount(task_status status);
 
 	// separateResources
 	// Decouple heavy resources (locks/interests) for cleanup based on terminal status.
@@ -336,7 +339,7 @@ TIC_CALL void WakeUpJoiners();
 // - s_CurrBlockedPhaseNumber: phase that is currently blocked
 // - s_CurrBlockedPhaseItem:   item that caused the current block
 // - s_CurrPhaseContainer:     container/owner of the current phase
-TIC_CALL extern phase_number s_CurrBlockedPhaseNumber;
+TIC_CALL extern std::atomic<phase_number> s_CurrBlockedPhaseNumber; // set by PhaseContainer, read lock-free by licensing worker threads
 TIC_CALL extern const TreeItem* s_CurrBlockedPhaseItem;
 TIC_CALL extern const TreeItem* s_CurrPhaseContainer;
 
@@ -19,6 +19,8 @@
 
 #include <ppl.h>
 
+struct tile_task_deque;
+
 struct tile_task_group
 {
 	using IndexType = SizeT;
@@ -27,9 +29,13 @@ struct tile_task_group
 private:
 	IndexType m_Last;
 	OperationContext* m_CallingContext = nullptr;
+	tile_task_deque*  m_OwnerDeque = nullptr;
 
-	mutable IndexType m_Commissioned = 0;
-	mutable IndexType m_NrCompleted = 0;
+	// slot ticketing is lock-free; m_Mutex is only taken to settle an exception or to signal that all pending work is done.
+	mutable std::atomic<IndexType> m_Commissioned = 0;
+	mutable std::atomic<IndexType> m_NrPending = 0; // uncompleted slots + work-stealing deque entries that still refer to this
+	mutable bool m_IsDone = false;
+	mutable std::mutex m_Mutex;
 
 protected:
 	task_func m_Func;
@@ -50,23 +56,19 @@ private:
 
 	void AwaitRunningSlots();
 
-	void decommission();
+	bool hasUncommissioned() const { return m_Commissioned.load(std::memory_order_relaxed) < m_Last; }
 	IndexType getNextCommissioned();
-	IndexType GetNextCommissioned();
-	void registerCompletions(IndexType nr);
-//	void RegisterCompletion(IndexType i);
-	auto RegisterCompletionAndGetNextCommissioned(IndexType i)->IndexType;
-
-	bool registerCompletion(IndexType i);
-
+	IndexType commissionAllRemaining();
+	void releasePending(IndexType nr);
+	void withdrawFromOwnerDeque();
 
 	void DoWork(IndexType i);
 
-	friend auto takeOneTileTask() -> std::pair<tile_task_group*, tile_task_group::IndexType>;
+	friend auto takeOneTileTask(tile_task_deque* ownDeque, bool mayRepush) -> std::pair<tile_task_group*, tile_task_group::IndexType>;
+	friend auto takeOneTileTaskFrom(tile_task_deque* victim, tile_task_deque* ownDeque, bool mayRepush) -> std::pair<tile_task_group*, tile_task_group::IndexType>;
 	friend void StealTasks();
 	friend void DoThisOrThatAndDecommission();
 	template <typename R> friend struct tile_task_result;
-	friend void CheckThis(tile_task_group* self);
 
 #if defined(MG_DEBUG)
 	std::vector<int> md_CompletedWork;
@@ -236,6 +238,18 @@ void parallel_tileloop_if_separable(tile_id last, Func&& func)
 	serial_for<tile_id>(0, last, std::move(func));
 }
 
+// executor for the algorithms of set/ParallelSort.h
+struct tile_task_executor
+{
+	SizeT nrThreads = IsMultiThreaded1() ? MaxConcurrentTreads() : 1;
+
+	template <typename Func>
+	void operator ()(SizeT n, Func&& func) const
+	{
+		parallel_for<SizeT>(n, std::forward<Func>(func));
+	}
+};
+
 
 
 #endif // __TIC_PARALLELTILES_H
@@ -0,0 +1,142 @@
+// Copyright (C) 1998-2026 Object Vision b.v.
+// License: GNU GPL 3
+/////////////////////////////////////////////////////////////////////////////
+
+// Test of the persistent CalcCache (see tic/dll/src/CalcCache.h):
+// - a calculated result is stored under a key that a new session derives again from the same configuration;
+// - the stored entry restores the calculated values into an item of the same domain, and a wrong key restores nothing;
+// - results smaller than CalcCacheMinSize_KB are not stored, unless the threshold is 0.
+
+#include "SystemTest.h"
+#include "TestConfig.h"
+
+#include "utl/Environment.h"
+
+#include "CalcCache.h"
+#include "MoreDataControllers.h"
+
+#include <cmath>
+#include <iostream>
+#include <optional>
+#include <vector>
+
+namespace {
+
+const CharPtr CALCCACHE_TEST_CONFIG =
+	"container CalcCacheTest { "
+	"	unit<ipoint> g := range(ipoint, point_yx(0i, 0i), point_yx(23i, 31i)); "
+	"	unit<ipoint> t := TiledUnit(point_yx(8i, 6i, g)) "
+	"	{ "
+	"		attribute<int32> v := pointrow(id(.)) * 37i + pointcol(id(.)) * 11i; "
+	"		attribute<int32> restored; "
+	"	} "
+	"	unit<uint32> small := range(uint32, 0, 10) "
+	"	{ "
+	"		attribute<float64> w := float64(id(.)) * 0.5; "
+	"		attribute<float64> restored; "
+	"	} "
+	"}";
+
+// settings of the CalcCache that the test overrides
+struct calc_cache_settings
+{
+	calc_cache_settings(DWORD minSizeKB)
+		: m_MaxSizeGB(RTC_GetRegDWord(RegDWordEnum::CalcCacheMaxSize_GB))
+		, m_MinSizeKB(RTC_GetRegDWord(RegDWordEnum::CalcCacheMinSize_KB))
+	{
+		RTC_SetCachedDWord(RegDWordEnum::CalcCacheMaxSize_GB, 1);
+		RTC_SetCachedDWord(RegDWordEnum::CalcCacheMinSize_KB, minSizeKB);
+	}
+	~calc_cache_settings()
+	{
+		RTC_SetCachedDWord(RegDWordEnum::CalcCacheMaxSize_GB, m_MaxSizeGB);
+		RTC_SetCachedDWord(RegDWordEnum::CalcCacheMinSize_KB, m_MinSizeKB);
+	}
+	DWORD m_MaxSizeGB, m_MinSizeKB;
+};
+
+auto GetKey(const TestConfig& cfg, CharPtr path) -> std::optional<CalcCache::key_t>
+{
+	auto dc = cfg.Item(path)->GetCheckedDC();
+	auto funcDC = dynamic_cast<const FuncDC*>(dc.get());
+	if (!funcDC)
+		return {};
+	return CalcCache::GetKey(funcDC);
+}
+
+// restores the entry of key into the item at path, which has no calculation rule of its own
+auto Restore(const TestConfig& cfg, CharPtr path, CalcCache::key_t key) -> std::optional<std::vector<Float64>>
+{
+	auto adi = const_cast<AbstrDataItem*>(cfg.Item(path));
+	if (!CalcCache::TryLoad(key, adi))
+		return {};
+	return cfg.Values(path);
+}
+
+bool AreEqual(const std::vector<Float64>& a, const std::vector<Float64>& b)
+{
+	if (a.size() != b.size())
+		return false;
+	for (std::size_t i = 0; i != a.size(); ++i)
+		if (a[i] != b[i] && !(std::isnan(a[i]) && std::isnan(b[i])))
+			return false;
+	return true;
+}
+
+bool Report(CharPtr name, bool ok)
+{
+	std::cout << "CalcCache\t" << name << (ok ? "" : "\tWRONG") << std::endl;
+	return ok;
+}
+
+bool TestStoreAndReload()
+{
+	calc_cache_settings settings(0);
+	bool ok = true;
+
+	std::vector<Float64> calculated;
+	std::optional<CalcCache::key_t> key;
+	{
+		TestConfig cfg(CALCCACHE_TEST_CONFIG);
+		calculated = cfg.Values("t/v");
+		key = GetKey(cfg, "t/v");
+		ok &= Report("key of a reproducible result", key.has_value());
+		if (!key)
+			return false;
+		auto restored = Restore(cfg, "t/restored", *key);
+		ok &= Report("restore in the same session", restored && AreEqual(*restored, calculated));
+	}
+
+	// a new session derives the same key and its calculation of the same item is served by the stored entry
+	TestConfig cfg(CALCCACHE_TEST_CONFIG);
+	ok &= Report("values in a new session", AreEqual(cfg.Values("t/v"), calculated));
+	auto newKey = GetKey(cfg, "t/v");
+	ok &= Report("key in a new session", newKey == key);
+
+	auto restored = Restore(cfg, "t/restored", *key);
+	ok &= Report("restore in a new session", restored && AreEqual(*restored, calculated));
+	ok &= Report("nothing restored for another key", !CalcCache::TryLoad(*key ^ 1, const_cast<AbstrDataItem*>(cfg.Item("t/restored"))));
+	return ok;
+}
+
+bool TestMinSize()
+{
+	calc_cache_settings settings(64);
+
+	TestConfig cfg(CALCCACHE_TEST_CONFIG);
+	cfg.Values("small/w");
+	auto key = GetKey(cfg, "small/w");
+	if (!key)
+		return Report("key of a small result", false);
+	return Report("small results are not stored", !Restore(cfg, "small/restored", *key));
+}
+
+} // anonymous namespace
+
+bool CalcCacheTest()
+{
+	bool ok = true;
+	ok &= TestStoreAndReload();
+	ok &= TestMinSize();
+	return ok;
+}
@@ -0,0 +1,106 @@
+// Copyright (C) 1998-2026 Object Vision b.v.
+// License: GNU GPL 3
+/////////////////////////////////////////////////////////////////////////////
+
+// Test of the queries on a contraction hierarchy (see geo/dll/src/ContractionHierarchy.cpp and Dijkstra.cpp):
+// impedance_matrix_ch on the result of contraction_hierarchy must give the same (OrgZone, DstZone) impedances as
+// impedance_matrix on the original links, both for all pairs and with an OrgZone_max_imp cut that differs per OrgZone.
+// The network is a directed torus of 12x10 nodes with different impedances in both directions of each link.
+
+#include "SystemTest.h"
+#include "TestConfig.h"
+
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <vector>
+
+namespace {
+
+const CharPtr CH_TEST_CONFIG =
+	"container ContractionHierarchyTest { "
+	"	unit<uint32> node := range(uint32, 0, 120) "
+	"	{ "
+	"		attribute<float64> max_imp := float64(id(.) % 5) * 3.0 + 4.0; "
+	"	} "
+	"	unit<uint32> link := range(uint32, 0, 480) "
+	"	{ "
+	"		attribute<node>    F1  := id(.) / 4; "
+	"		attribute<uint32>  dir := id(.) % 4; "
+	"		attribute<uint32>  row := F1 / 10; "
+	"		attribute<uint32>  col := F1 % 10; "
+	"		attribute<node>    F2  := value(iif(dir == 0, row * 10 + (col + 1) % 10 "
+	"			, iif(dir == 1, row * 10 + (col + 9) % 10 "
+	"			, iif(dir == 2, ((row + 1) % 12) * 10 + col "
+	"			, ((row + 11) % 12) * 10 + col))), node); "
+	"		attribute<float64> imp := float64((F1 * 7 + dir * 13) % 11) + 1.0; "
+	"	} "
+	"	unit<uint32> ch := contraction_hierarchy(link/imp, link/F1, link/F2); "
+	"	unit<uint32> plain := impedance_matrix('directed;startPoint(Node_rel);endPoint(Node_rel);od:impedance,OrgZone_rel,DstZone_rel' "
+	"		, link/imp, link/F1, link/F2, id(node), id(node)) "
+	"	{ "
+	"		attribute<uint32> key := OrgZone_rel * 1000 + DstZone_rel; "
+	"	} "
+	"	unit<uint32> onch := impedance_matrix_ch('directed;startPoint(Node_rel);endPoint(Node_rel);od:impedance,OrgZone_rel,DstZone_rel' "
+	"		, ch/impedance, ch/F1, ch/F2, ch/Node_rank, id(node), id(node)) "
+	"	{ "
+	"		attribute<uint32> key := OrgZone_rel * 1000 + DstZone_rel; "
+	"	} "
+	"	unit<uint32> plain_cut := impedance_matrix('directed;startPoint(Node_rel);endPoint(Node_rel);cut(OrgZone_max_imp);od:impedance,OrgZone_rel,DstZone_rel' "
+	"		, link/imp, link/F1, link/F2, id(node), id(node), node/max_imp) "
+	"	{ "
+	"		attribute<uint32> key := OrgZone_rel * 1000 + DstZone_rel; "
+	"	} "
+	"	unit<uint32> onch_cut := impedance_matrix_ch('directed;startPoint(Node_rel);endPoint(Node_rel);cut(OrgZone_max_imp);od:impedance,OrgZone_rel,DstZone_rel' "
+	"		, ch/impedance, ch/F1, ch/F2, ch/Node_rank, id(node), id(node), node/max_imp) "
+	"	{ "
+	"		attribute<uint32> key := OrgZone_rel * 1000 + DstZone_rel; "
+	"	} "
+	"}";
+
+// impedance per (OrgZone, DstZone) key; defined impedances only
+auto Impedances(const TestConfig& cfg, CharPtr odUnit) -> std::map<UInt32, Float64>
+{
+	SharedStr unitName(odUnit);
+	auto keys = cfg.Values((unitName + "/key").c_str());
+	auto imps = cfg.Values((unitName + "/impedance").c_str());
+	MG_CHECK(keys.size() == imps.size());
+
+	std::map<UInt32, Float64> result;
+	for (SizeT i = 0; i != keys.size(); ++i)
+		if (!std::isnan(imps[i]))
+			result[UInt32(keys[i])] = imps[i];
+	return result;
+}
+
+bool Compare(CharPtr name, const std::map<UInt32, Float64>& expected, const std::map<UInt32, Float64>& actual)
+{
+	bool ok = (expected == actual);
+	std::cout << "ContractionHierarchy\t" << name << "\t" << expected.size() << " pairs" << (ok ? "" : "\tWRONG") << std::endl;
+	if (!ok)
+		for (const auto& e : expected)
+		{
+			auto a = actual.find(e.first);
+			if (a == actual.end() || a->second != e.second)
+			{
+				std::cout << "first difference at OrgZone " << e.first / 1000 << ", DstZone " << e.first % 1000
+					<< ": " << e.second << " instead of " << (a == actual.end() ? std::nan("") : a->second) << std::endl;
+				break;
+			}
+		}
+	return ok;
+}
+
+} // anonymous namespace
+
+bool ContractionHierarchyTest()
+{
+	TestConfig cfg(CH_TEST_CONFIG);
+	bool ok = true;
+
+	auto all = Impedances(cfg, "plain");
+	ok &= all.size() == 120 * 120; // a torus is strongly connected
+	ok &= Compare("all pairs", all, Impedances(cfg, "onch"));
+	ok &= Compare("OrgZone_max_imp cut", Impedances(cfg, "plain_cut"), Impedances(cfg, "onch_cut"));
+	return ok;
+}
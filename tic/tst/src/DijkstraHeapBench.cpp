@@ -0,0 +1,100 @@
+// Copyright (C) 1998-2026 Object Vision b.v.
+// License: GNU GPL 3
+/////////////////////////////////////////////////////////////////////////////
+
+// Benchmark of the heaps of impedance_table and impedance_matrix (see geo/dll/src/DijkstraHeapPolicy.h and ProcessDijkstra in Dijkstra.cpp):
+// seconds of the default binary heap and of heap(fast), which uses the radix heap for integral impedances and the 4-ary heap
+// for floating point impedances, with UInt32, Float32 and Float64 impedances on a road network of 400x400 nodes with a grid of
+// local roads and a coarser grid of fast roads. The impedances must be equal; the chosen paths among paths of equal impedance may differ.
+
+#include "SystemTest.h"
+#include "TestConfig.h"
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+const CharPtr DIJKSTRA_HEAP_BENCH_CONFIG =
+	"container DijkstraHeapBench { "
+	"	unit<uint32> node := range(uint32, 0, 160000); "
+	"	unit<uint32> link := range(uint32, 0, 320000) "
+	"	{ "
+	"		attribute<uint32>  N1   := id(.) / 2; "
+	"		attribute<uint32>  row  := N1 / 400; "
+	"		attribute<uint32>  col  := N1 % 400; "
+	"		attribute<bool>    down := id(.) % 2 == 1; "
+	"		attribute<bool>    fast := iif(down, col % 16 == 0, row % 16 == 0); "
+	"		attribute<node>    F1   := value(N1, node); "
+	"		attribute<node>    F2   := value(iif(down, iif(row < 399, N1 + 400, N1), iif(col < 399, N1 + 1, N1)), node); "
+	"		attribute<uint32>  imp_u32 := iif(fast, 8 + (N1 * 7919) % 5, 20 + (id(.) * 7919) % 60); "
+	"		attribute<float32> imp_f32 := float32(imp_u32); "
+	"		attribute<float64> imp_f64 := float64(imp_u32); "
+	"	} "
+	"	unit<uint32> org := range(uint32, 0, 16) "
+	"	{ "
+	"		attribute<node> Node_rel := value((id(.) * 9973) % 160000, node); "
+	"	} "
+	"	attribute<uint32>  table_u32      (node) := impedance_table('bidirectional;startPoint(Node_rel)', link/imp_u32, link/F1, link/F2, org/Node_rel); "
+	"	attribute<uint32>  table_u32_fast (node) := impedance_table('bidirectional;startPoint(Node_rel);heap(fast)', link/imp_u32, link/F1, link/F2, org/Node_rel); "
+	"	attribute<float32> table_f32      (node) := impedance_table('bidirectional;startPoint(Node_rel)', link/imp_f32, link/F1, link/F2, org/Node_rel); "
+	"	attribute<float32> table_f32_fast (node) := impedance_table('bidirectional;startPoint(Node_rel);heap(fast)', link/imp_f32, link/F1, link/F2, org/Node_rel); "
+	"	attribute<float64> table_f64      (node) := impedance_table('bidirectional;startPoint(Node_rel)', link/imp_f64, link/F1, link/F2, org/Node_rel); "
+	"	attribute<float64> table_f64_fast (node) := impedance_table('bidirectional;startPoint(Node_rel);heap(fast)', link/imp_f64, link/F1, link/F2, org/Node_rel); "
+	"	unit<uint32> matrix_u32 := impedance_matrix('bidirectional;startPoint(Node_rel);endPoint(Node_rel);od:impedance', link/imp_u32, link/F1, link/F2, org/Node_rel, id(node)); "
+	"	unit<uint32> matrix_u32_fast := impedance_matrix('bidirectional;startPoint(Node_rel);endPoint(Node_rel);od:impedance;heap(fast)', link/imp_u32, link/F1, link/F2, org/Node_rel, id(node)); "
+	"	unit<uint32> matrix_f32 := impedance_matrix('bidirectional;startPoint(Node_rel);endPoint(Node_rel);od:impedance', link/imp_f32, link/F1, link/F2, org/Node_rel, id(node)); "
+	"	unit<uint32> matrix_f32_fast := impedance_matrix('bidirectional;startPoint(Node_rel);endPoint(Node_rel);od:impedance;heap(fast)', link/imp_f32, link/F1, link/F2, org/Node_rel, id(node)); "
+	"	unit<uint32> matrix_f64 := impedance_matrix('bidirectional;startPoint(Node_rel);endPoint(Node_rel);od:impedance', link/imp_f64, link/F1, link/F2, org/Node_rel, id(node)); "
+	"	unit<uint32> matrix_f64_fast := impedance_matrix('bidirectional;startPoint(Node_rel);endPoint(Node_rel);od:impedance;heap(fast)', link/imp_f64, link/F1, link/F2, org/Node_rel, id(node)); "
+	"}";
+
+// the values of the item at path and the seconds of their calculation
+auto TimedValues(const TestConfig& cfg, const SharedStr& path, double& seconds) -> std::vector<Float64>
+{
+	auto start = std::chrono::steady_clock::now();
+	auto result = cfg.Values(path.c_str());
+	seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	return result;
+}
+
+// the results of item with the default binary heap and of item_fast with heap(fast), or of their sub item
+bool Bench(const TestConfig& cfg, CharPtr oper, CharPtr typeName, CharPtr item, CharPtr subItem = "")
+{
+	double binarySeconds, fastSeconds;
+	auto binary = TimedValues(cfg, SharedStr(item) + subItem, binarySeconds);
+	auto fast = TimedValues(cfg, SharedStr(item) + "_fast" + subItem, fastSeconds);
+
+	bool ok = binary.size() == fast.size();
+	for (SizeT i = 0; ok && i != binary.size(); ++i)
+		ok = binary[i] == fast[i] || (std::isnan(binary[i]) && std::isnan(fast[i]));
+
+	std::cout << "DijkstraHeapBench\t" << oper << "\t" << typeName << "\t" << binary.size()
+		<< "\t" << binarySeconds << "\t" << fastSeconds << (ok ? "" : "\tWRONG") << std::endl;
+	return ok;
+}
+
+} // anonymous namespace
+
+bool DijkstraHeapBench()
+{
+	TestConfig cfg(DIJKSTRA_HEAP_BENCH_CONFIG);
+	InterestRetainContextBase networkInterest; // keeps the network calculated during the timed runs
+	for (CharPtr input : { "link/F1", "link/F2", "link/imp_u32", "link/imp_f32", "link/imp_f64", "org/Node_rel" })
+	{
+		networkInterest.Add(cfg.Item(input));
+		cfg.Values(input);
+	}
+
+	bool ok = true;
+	std::cout << "DijkstraHeapBench\toperator\ttype\tresults\tbinary heap (s)\theap(fast) (s)" << std::endl;
+	ok &= Bench(cfg, "impedance_table" , "UInt32" , "table_u32");
+	ok &= Bench(cfg, "impedance_table" , "Float32", "table_f32");
+	ok &= Bench(cfg, "impedance_table" , "Float64", "table_f64");
+	ok &= Bench(cfg, "impedance_matrix", "UInt32" , "matrix_u32", "/impedance");
+	ok &= Bench(cfg, "impedance_matrix", "Float32", "matrix_f32", "/impedance");
+	ok &= Bench(cfg, "impedance_matrix", "Float64", "matrix_f64", "/impedance");
+	return ok;
+}
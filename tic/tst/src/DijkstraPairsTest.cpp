@@ -0,0 +1,143 @@
+// Copyright (C) 1998-2026 Object Vision b.v.
+// License: GNU GPL 3
+/////////////////////////////////////////////////////////////////////////////
+
+// Test of the searches for given OD pairs (see ProcessDijkstraPairs and LandmarkInfo in geo/dll/src/Dijkstra.cpp):
+// impedance_matrix with pairs(OrgZone_rel,DstZone_rel) must give, per pair, the impedance of plain impedance_matrix,
+// for each search strategy: landmarks (ALT) with selected nodes, given Node_rel or the tables of landmark_impedances,
+// bidirectional, and both combined, also with an OrgZone_max_imp cut.
+// The network is a directed corridor of 150x4 nodes, with one-way links along its last row and 5 isolated nodes,
+// such that the landmarks at its ends give tight lower bounds that prune the searches for the nearby DstZones
+// of the first 400 pairs, and the isolated DstZones of every 50th pair have infinite bounds.
+// The last 400 pairs have 10 far DstZones per OrgZone, for which the bidirectional search falls back on one search per OrgZone.
+
+#include "SystemTest.h"
+#include "TestConfig.h"
+
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <vector>
+
+namespace {
+
+const CharPtr DIJKSTRA_PAIRS_TEST_CONFIG =
+	"container DijkstraPairsTest { "
+	"	unit<uint32> node := range(uint32, 0, 605) "
+	"	{ "
+	"		attribute<float64> max_imp := float64(id(.) % 7) * 6.0 + 10.0; "
+	"	} "
+	"	unit<uint32> link := range(uint32, 0, 2400) "
+	"	{ "
+	"		attribute<uint32>  N1  := id(.) / 4; "
+	"		attribute<node>    F1  := value(N1, node); "
+	"		attribute<uint32>  dir := id(.) % 4; "
+	"		attribute<uint32>  row := N1 % 4; "
+	"		attribute<uint32>  col := N1 / 4; "
+	"		attribute<node>    F2  := value(iif(dir == 0 && col < 149, N1 + 4 "
+	"			, iif(dir == 1 && col > 0 && row != 3, N1 - 4 "
+	"			, iif(dir == 2 && row < 3, N1 + 1 "
+	"			, iif(dir == 3 && row > 0, N1 - 1, N1)))), node); "
+	"		attribute<float64> imp := float64((N1 * 7 + dir * 13) % 11) + 1.0; "
+	"	} "
+	"	unit<uint32> pair := range(uint32, 0, 800) "
+	"	{ "
+	"		attribute<uint32> org := iif(id(.) < 400, (id(.) * 37) % 600, ((id(.) % 40) * 29) % 600); "
+	"		attribute<uint32> dst := iif(id(.) % 50 == 7, 600 + id(.) % 5 "
+	"			, iif(id(.) < 400, (org + (id(.) % 9) * 4 + 8) % 600, (id(.) * 131 + 17) % 600)); "
+	"		attribute<node> OrgZone_rel := value(org, node); "
+	"		attribute<node> DstZone_rel := value(dst, node); "
+	"		attribute<uint32> key := org * 1000 + dst; "
+	"	} "
+	"	unit<uint32> corner := range(uint32, 0, 4) "
+	"	{ "
+	"		attribute<node> Node_rel := value(iif(id(.) == 0, 0, iif(id(.) == 1, 3, iif(id(.) == 2, 596, 599))), node); "
+	"	} "
+	"	unit<uint32> lm := landmark_impedances(link/imp, link/F1, link/F2); "
+	"	unit<uint32> plain := impedance_matrix('directed;startPoint(Node_rel);endPoint(Node_rel);od:impedance,OrgZone_rel,DstZone_rel' "
+	"		, link/imp, link/F1, link/F2, id(node), id(node)) "
+	"	{ "
+	"		attribute<uint32> key := OrgZone_rel * 1000 + DstZone_rel; "
+	"	} "
+	"	unit<uint32> plain_cut := impedance_matrix('directed;startPoint(Node_rel);endPoint(Node_rel);cut(OrgZone_max_imp);od:impedance,OrgZone_rel,DstZone_rel' "
+	"		, link/imp, link/F1, link/F2, id(node), id(node), node/max_imp) "
+	"	{ "
+	"		attribute<uint32> key := OrgZone_rel * 1000 + DstZone_rel; "
+	"	} "
+	"	unit<uint32> given_pairs := impedance_matrix('directed;startPoint(Node_rel);endPoint(Node_rel);pairs(OrgZone_rel,DstZone_rel);od:impedance' "
+	"		, link/imp, link/F1, link/F2, id(node), id(node), pair/OrgZone_rel, pair/DstZone_rel); "
+	"	unit<uint32> alt := impedance_matrix('directed;startPoint(Node_rel);endPoint(Node_rel);pairs(OrgZone_rel,DstZone_rel);search(landmarks);od:impedance' "
+	"		, link/imp, link/F1, link/F2, id(node), id(node), pair/OrgZone_rel, pair/DstZone_rel); "
+	"	unit<uint32> alt_given := impedance_matrix('directed;startPoint(Node_rel);endPoint(Node_rel);pairs(OrgZone_rel,DstZone_rel);search(landmarks(Node_rel));od:impedance' "
+	"		, link/imp, link/F1, link/F2, id(node), id(node), pair/OrgZone_rel, pair/DstZone_rel, corner/Node_rel); "
+	"	unit<uint32> alt_tables := impedance_matrix('directed;startPoint(Node_rel);endPoint(Node_rel);pairs(OrgZone_rel,DstZone_rel);search(landmarks(FromLandmark_imp,ToLandmark_imp));od:impedance' "
+	"		, link/imp, link/F1, link/F2, id(node), id(node), pair/OrgZone_rel, pair/DstZone_rel, lm/Table/FromLandmark_imp, lm/Table/ToLandmark_imp); "
+	"	unit<uint32> bidir := impedance_matrix('directed;startPoint(Node_rel);endPoint(Node_rel);pairs(OrgZone_rel,DstZone_rel);search(bidirectional);od:impedance' "
+	"		, link/imp, link/F1, link/F2, id(node), id(node), pair/OrgZone_rel, pair/DstZone_rel); "
+	"	unit<uint32> alt_bidir := impedance_matrix('directed;startPoint(Node_rel);endPoint(Node_rel);pairs(OrgZone_rel,DstZone_rel);search(landmarks,bidirectional);od:impedance' "
+	"		, link/imp, link/F1, link/F2, id(node), id(node), pair/OrgZone_rel, pair/DstZone_rel); "
+	"	unit<uint32> alt_bidir_cut := impedance_matrix('directed;startPoint(Node_rel);endPoint(Node_rel);cut(OrgZone_max_imp);pairs(OrgZone_rel,DstZone_rel);search(landmarks,bidirectional);od:impedance' "
+	"		, link/imp, link/F1, link/F2, id(node), id(node), node/max_imp, pair/OrgZone_rel, pair/DstZone_rel); "
+	"}";
+
+// impedance per (OrgZone, DstZone) key of a plain impedance_matrix; defined impedances only
+auto Impedances(const TestConfig& cfg, CharPtr odUnit) -> std::map<UInt32, Float64>
+{
+	SharedStr unitName(odUnit);
+	auto keys = cfg.Values((unitName + "/key").c_str());
+	auto imps = cfg.Values((unitName + "/impedance").c_str());
+	MG_CHECK(keys.size() == imps.size());
+
+	std::map<UInt32, Float64> result;
+	for (SizeT i = 0; i != keys.size(); ++i)
+		if (!std::isnan(imps[i]))
+			result[UInt32(keys[i])] = imps[i];
+	return result;
+}
+
+// the impedance per pair, or NaN for pairs that are not connected
+auto PairImpedances(const std::map<UInt32, Float64>& impedances, const std::vector<Float64>& pairKeys) -> std::vector<Float64>
+{
+	std::vector<Float64> result;
+	for (auto key : pairKeys)
+	{
+		auto i = impedances.find(UInt32(key));
+		result.emplace_back(i == impedances.end() ? std::nan("") : i->second);
+	}
+	return result;
+}
+
+bool Compare(CharPtr name, const std::vector<Float64>& expected, const std::vector<Float64>& actual)
+{
+	bool ok = expected.size() == actual.size();
+	SizeT nrConnected = 0, p = 0;
+	for (; ok && p != expected.size(); ++p)
+	{
+		ok = expected[p] == actual[p] || (std::isnan(expected[p]) && std::isnan(actual[p]));
+		nrConnected += !std::isnan(expected[p]);
+	}
+	std::cout << "DijkstraPairs\t" << name << "\t" << nrConnected << " connected pairs" << (ok ? "" : "\tWRONG") << std::endl;
+	if (!ok && p)
+		std::cout << "first difference at pair " << p - 1 << ": " << expected[p - 1] << " instead of " << actual[p - 1] << std::endl;
+	return ok;
+}
+
+} // anonymous namespace
+
+bool DijkstraPairsTest()
+{
+	TestConfig cfg(DIJKSTRA_PAIRS_TEST_CONFIG);
+	auto pairKeys = cfg.Values("pair/key");
+	auto expected = PairImpedances(Impedances(cfg, "plain"), pairKeys);
+	auto expectedCut = PairImpedances(Impedances(cfg, "plain_cut"), pairKeys);
+
+	bool ok = true;
+	ok &= Compare("pairs"                                     , expected   , cfg.Values("given_pairs/impedance"));
+	ok &= Compare("landmarks"                                 , expected   , cfg.Values("alt/impedance"));
+	ok &= Compare("landmarks(Node_rel)"                       , expected   , cfg.Values("alt_given/impedance"));
+	ok &= Compare("landmarks(FromLandmark_imp,ToLandmark_imp)", expected   , cfg.Values("alt_tables/impedance"));
+	ok &= Compare("bidirectional"                             , expected   , cfg.Values("bidir/impedance"));
+	ok &= Compare("landmarks,bidirectional"                   , expected   , cfg.Values("alt_bidir/impedance"));
+	ok &= Compare("landmarks,bidirectional with cut"          , expectedCut, cfg.Values("alt_bidir_cut/impedance"));
+	return ok;
+}
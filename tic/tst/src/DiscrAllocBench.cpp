@@ -0,0 +1,98 @@
+// Copyright (C) 1998-2026 Object Vision b.v.
+// License: GNU GPL 3
+/////////////////////////////////////////////////////////////////////////////
+
+// Benchmark of discrete_alloc (see geo/dll/src/DiscrAlloc.cpp) with and without multi-threading (RSF_MultiThreading1):
+// - discrete_alloc_np, of which all claims form one component; cells before each splitter update are inserted in the facet queues in parallel;
+// - discrete_alloc_sp with 64 regions, of which the claims form one component per region that are allocated in parallel.
+// Both runs must allocate the same land use to each cell. The time per scale level is reported in the trace log by DiscrAlloc.Solve.
+
+#include "SystemTest.h"
+#include "TestConfig.h"
+
+#include "utl/Environment.h"
+#include "utl/mySPrintF.h"
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+const UInt32 NR_CELLS = 2000000, NR_TYPES = 8, NR_REGIONS = 64;
+
+// the configuration of an allocation of NR_CELLS cells to NR_TYPES types with pseudo-random suitabilities;
+// with regions, the claims are per region and the cells are assigned to the regions in turn
+std::string Config(bool withRegions)
+{
+	UInt32 nrClaimCells = withRegions ? NR_CELLS / NR_REGIONS : NR_CELLS;
+	auto claim = [&](const std::string& name, UInt32 value)
+		{
+			return withRegions
+				?	mySSPrintF("attribute<uint32> %s (region) := const(%uu, region); ", name.c_str(), value)
+				:	mySSPrintF("parameter<uint32> %s := %uu; ", name.c_str(), value);
+		};
+
+	std::string names, suitabilities, minClaims, maxClaims;
+	for (UInt32 t = 0; t != NR_TYPES; ++t)
+	{
+		std::string name = "T" + std::to_string(t);
+		names += (t ? ", '" : "'") + name + "'";
+		suitabilities += mySSPrintF("attribute<int32> %s (cells) := int32((id(cells) * %uu + id(cells) / %uu) %% 10007u); ", name.c_str(), 1009 + 61 * t, 7 + 3 * t).c_str();
+		minClaims += claim(name, nrClaimCells / (2 * NR_TYPES)).c_str();
+		maxClaims += claim(name, 2 * nrClaimCells / NR_TYPES).c_str();
+	}
+
+	return
+		"container DiscrAllocBench { "
+		"	unit<uint8> lu: nrofrows = " + std::to_string(NR_TYPES) + " { attribute<string> name: [" + names + "]; } "
+		"	unit<uint32> cells := range(uint32, 0, " + std::to_string(NR_CELLS) + "); "
+		"	unit<uint16> region := range(uint16, 0w, " + std::to_string(NR_REGIONS) + "w); "
+		"	attribute<region> regionMap (cells) := value(id(cells) % " + std::to_string(NR_REGIONS) + ", region); "
+		"	container suit { " + suitabilities + "} "
+		"	container minc { " + minClaims + "} "
+		"	container maxc { " + maxClaims + "} "
+		"	container alloc := " + (withRegions
+			?	"discrete_alloc_sp(lu/name, cells, suit, region, regionMap, minc, maxc, 0i); "
+			:	"discrete_alloc_np(lu/name, cells, suit, minc, maxc, 0i); ") +
+		"}";
+}
+
+// the land use and the time of the allocation
+auto Allocate(const std::string& config, bool multiThreaded) -> std::pair<std::vector<Float64>, double>
+{
+	bool wasMultiThreaded = IsMultiThreaded1();
+	SetCachedStatusFlag(RSF_MultiThreading1, multiThreaded);
+
+	TestConfig cfg(config.c_str());
+	for (UInt32 t = 0; t != NR_TYPES; ++t)
+		cfg.Values(("suit/T" + std::to_string(t)).c_str());
+	auto start = std::chrono::steady_clock::now();
+	auto landUse = cfg.Values("alloc/landuse");
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	SetCachedStatusFlag(RSF_MultiThreading1, wasMultiThreaded);
+	return { landUse, seconds };
+}
+
+bool Bench(CharPtr name, bool withRegions)
+{
+	auto config = Config(withRegions);
+	auto serial   = Allocate(config, false);
+	auto parallel = Allocate(config, true);
+	bool ok = (serial.first == parallel.first);
+	std::cout << "DiscrAllocBench\t" << name << "\t" << NR_CELLS << " cells\t" << NR_TYPES << " types"
+		<< "\tsingle-threaded " << serial.second << "s\tmulti-threaded " << parallel.second << "s" << (ok ? "" : "\tDIFFERENT LAND USE") << std::endl;
+	return ok;
+}
+
+} // anonymous namespace
+
+bool DiscrAllocBench()
+{
+	bool ok = true;
+	ok &= Bench("discrete_alloc_np, one component", false);
+	ok &= Bench("discrete_alloc_sp, 64 components", true);
+	return ok;
+}
@@ -0,0 +1,178 @@
+// Copyright (C) 1998-2026 Object Vision b.v.
+// License: GNU GPL 3
+/////////////////////////////////////////////////////////////////////////////
+
+// Test of the tile parallel district labelling (see geo/dll/src/DistrictLabelling.h) against a flood fill
+// that numbers the districts in the raster order of their first cell, as Districter in SpatialAnalyzer.h does,
+// for random zone grids with undefined cells, with 4 and 8 neighbours, and with regular and irregular tilings,
+// and of the district_4 and district_8 operators on a tiled grid.
+
+#include "SystemTest.h"
+#include "TestConfig.h"
+
+#include "DistrictLabelling.h"
+
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+const int undefined_zone = -1;
+
+std::vector<std::size_t> FloodFill(const std::vector<int>& zones, std::size_t nrRows, std::size_t nrCols, bool rule8, std::size_t& nrDistricts)
+{
+	const std::size_t none = std::size_t(-1);
+	std::vector<std::size_t> result(zones.size(), none);
+	nrDistricts = 0;
+	for (std::size_t seed = 0; seed != zones.size(); ++seed)
+	{
+		if (zones[seed] == undefined_zone || result[seed] != none)
+			continue;
+		std::vector<std::size_t> stack{ seed };
+		result[seed] = nrDistricts;
+		while (!stack.empty())
+		{
+			std::size_t i = stack.back(); stack.pop_back();
+			std::ptrdiff_t r = i / nrCols, c = i % nrCols;
+			for (int dr = -1; dr <= 1; ++dr)
+				for (int dc = -1; dc <= 1; ++dc)
+				{
+					if ((!dr && !dc) || (!rule8 && dr && dc))
+						continue;
+					std::ptrdiff_t nr = r + dr, nc = c + dc;
+					if (nr < 0 || nc < 0 || nr >= std::ptrdiff_t(nrRows) || nc >= std::ptrdiff_t(nrCols))
+						continue;
+					std::size_t j = nr * nrCols + nc;
+					if (result[j] == none && zones[j] == zones[seed])
+					{
+						result[j] = nrDistricts;
+						stack.push_back(j);
+					}
+				}
+		}
+		++nrDistricts;
+	}
+	return result;
+}
+
+struct tile_rect { std::size_t top, left, nrRows, nrCols; };
+
+bool Test(std::mt19937& rng, std::size_t nrRows, std::size_t nrCols, int nrZones, const std::vector<std::size_t>& rowCuts, const std::vector<std::size_t>& colCuts, bool rule8)
+{
+	std::uniform_int_distribution<int> zone(undefined_zone, nrZones - 1);
+	std::vector<int> zones(nrRows * nrCols);
+	for (auto& z : zones)
+		z = zone(rng);
+
+	// tiles between consecutive cuts, numbered per tile row; each tile row has its own column cuts when colCuts is empty
+	std::vector<tile_rect> tiles;
+	std::vector<std::size_t> tileOfCell(zones.size());
+	for (std::size_t tr = 0; tr + 1 < rowCuts.size(); ++tr)
+	{
+		std::vector<std::size_t> cuts = colCuts;
+		if (cuts.empty())
+		{
+			cuts = { 0 };
+			while (cuts.back() != nrCols)
+				cuts.push_back(std::min(nrCols, cuts.back() + 1 + rng() % 7));
+		}
+		for (std::size_t tc = 0; tc + 1 < cuts.size(); ++tc)
+		{
+			tile_rect tile{ rowCuts[tr], cuts[tc], rowCuts[tr + 1] - rowCuts[tr], cuts[tc + 1] - cuts[tc] };
+			for (std::size_t r = 0; r != tile.nrRows; ++r)
+				for (std::size_t c = 0; c != tile.nrCols; ++c)
+					tileOfCell[(tile.top + r) * nrCols + tile.left + c] = tiles.size();
+			tiles.push_back(tile);
+		}
+	}
+
+	district_labeller<int> labeller(nrRows, nrCols, tiles.size(), rule8);
+	std::vector<std::vector<std::uint32_t>> labels(tiles.size());
+	for (std::size_t t = 0; t != tiles.size(); ++t)
+	{
+		const tile_rect& tile = tiles[t];
+		std::vector<int> data;
+		for (std::size_t r = 0; r != tile.nrRows; ++r)
+			for (std::size_t c = 0; c != tile.nrCols; ++c)
+				data.push_back(zones[(tile.top + r) * nrCols + tile.left + c]);
+		labels[t].resize(data.size());
+		labeller.LabelTile(t, tile.top, tile.left, tile.nrRows, tile.nrCols, data.begin(), [](int z) { return z != undefined_zone; }, labels[t].data());
+	}
+	std::size_t nrDistricts = labeller.Unite([&](std::size_t r, std::size_t c) { return tileOfCell[r * nrCols + c]; });
+
+	std::size_t nrExpected;
+	auto expected = FloodFill(zones, nrRows, nrCols, rule8, nrExpected);
+	bool ok = (nrDistricts == nrExpected);
+	for (std::size_t t = 0; t != tiles.size(); ++t)
+	{
+		const tile_rect& tile = tiles[t];
+		for (std::size_t r = 0, i = 0; r != tile.nrRows; ++r)
+			for (std::size_t c = 0; c != tile.nrCols; ++c, ++i)
+			{
+				std::size_t id = (labels[t][i] == no_district_label) ? std::size_t(-1) : labeller.DistrictId(t, labels[t][i]);
+				ok &= (id == expected[(tile.top + r) * nrCols + tile.left + c]);
+			}
+	}
+	std::cout << nrRows << "x" << nrCols << "\tzones " << nrZones << "\ttiles " << tiles.size() << "\trule8 " << rule8
+		<< "\tdistricts " << nrDistricts << "\texpected " << nrExpected << (ok ? "" : "\tWRONG") << std::endl;
+	return ok;
+}
+
+std::vector<std::size_t> RegularCuts(std::size_t n, std::size_t tileSize)
+{
+	std::vector<std::size_t> result;
+	for (std::size_t i = 0; i < n; i += tileSize)
+		result.push_back(i);
+	result.push_back(n);
+	return result;
+}
+
+bool TestOperator(bool rule8)
+{
+	const std::size_t nrRows = 23, nrCols = 31;
+	TestConfig cfg(
+		"container DistrictTest { "
+		"	unit<ipoint> g := range(ipoint, point_yx(0i, 0i), point_yx(23i, 31i)); "
+		"	unit<ipoint> t := TiledUnit(point_yx(8i, 6i, g)) "
+		"	{ "
+		"		attribute<uint32> zone := uint32((pointrow(id(.)) * pointrow(id(.)) * 7i + pointcol(id(.)) * 5i + pointrow(id(.)) * pointcol(id(.))) % 3i); "
+		"	} "
+		"	unit<uint32> districts_4 := district_4(t/zone); "
+		"	unit<uint32> districts_8 := district_8(t/zone); "
+		"}"
+	);
+	auto zoneValues = cfg.Values("t/zone");
+	auto districtValues = cfg.Values(rule8 ? "districts_8/Districts" : "districts_4/Districts");
+	std::vector<int> zones(zoneValues.begin(), zoneValues.end());
+	if (zones.size() != nrRows * nrCols)
+		return false;
+
+	std::size_t nrExpected;
+	auto expected = FloodFill(zones, nrRows, nrCols, rule8, nrExpected);
+	bool ok = (districtValues.size() == expected.size());
+	for (std::size_t i = 0; ok && i != expected.size(); ++i)
+		ok &= (districtValues[i] == expected[i]);
+	std::cout << "district_" << (rule8 ? 8 : 4) << " operator	districts " << nrExpected << (ok ? "" : "\tWRONG") << std::endl;
+	return ok;
+}
+
+} // anonymous namespace
+
+bool DistrictLabellingTest()
+{
+	std::mt19937 rng(7);
+	bool ok = true;
+	for (bool rule8 : { false, true })
+	{
+		ok &= Test(rng, 1, 1, 2, RegularCuts(1, 1), RegularCuts(1, 1), rule8);
+		ok &= Test(rng, 10, 12, 2, RegularCuts(10, 10), RegularCuts(12, 12), rule8);   // one tile
+		ok &= Test(rng, 40, 50, 2, RegularCuts(40, 8), RegularCuts(50, 16), rule8);
+		ok &= Test(rng, 40, 50, 3, RegularCuts(40, 1), RegularCuts(50, 1), rule8);     // single cell tiles
+		ok &= Test(rng, 37, 41, 2, RegularCuts(37, 5), {}, rule8);                      // staggered tile columns
+		ok &= Test(rng, 64, 64, 6, RegularCuts(64, 3), {}, rule8);
+		ok &= Test(rng, 200, 300, 2, RegularCuts(200, 64), RegularCuts(300, 64), rule8);
+		ok &= TestOperator(rule8);
+	}
+	return ok;
+}
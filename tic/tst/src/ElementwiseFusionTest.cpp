@@ -0,0 +1,91 @@
+// Copyright (C) 1998-2026 Object Vision b.v.
+// License: GNU GPL 3
+/////////////////////////////////////////////////////////////////////////////
+
+// Test of the fusion of chains of elementwise attribute operators (see clc/dll/include/ElementwiseFusion.h):
+// - fused chains on a tiled domain give the same results as the direct calculation and as the same chain
+//   that reads a materialized intermediate (through lookup, which isn't elementwise);
+// - a failure in a fused intermediate fails both the consumer and the intermediate item itself.
+
+#include "SystemTest.h"
+#include "TestConfig.h"
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+const CharPtr FUSION_TEST_CONFIG =
+	"container ElementwiseFusionTest { "
+	"	unit<ipoint> g := range(ipoint, point_yx(0i, 0i), point_yx(23i, 31i)); "
+	"	unit<ipoint> t := TiledUnit(point_yx(8i, 6i, g)) "
+	"	{ "
+	"		attribute<float64> a := float64(pointrow(id(.))); "
+	"		attribute<float64> b := float64(pointcol(id(.))) - 10.0; "
+	"		attribute<float64> fused := sqrt(a * a + b * b) * 2.0; "
+	"		attribute<float64> sq := a * a + b * b; "
+	"		attribute<float64> unfused := sqrt(lookup(id(.), sq)) * 2.0; "
+	"		attribute<int32> ifused := (pointrow(id(.)) * 3i + pointcol(id(.))) * 2i - 1i; "
+	"		attribute<int32> x := pointrow(id(.)) + 2147483640i; "
+	"		attribute<int32> y := x - 1i; "
+	"	} "
+	"}";
+
+const int NR_ROWS = 23, NR_COLS = 31;
+
+bool Compare(CharPtr name, const std::vector<Float64>& values, double (*expected)(int r, int c))
+{
+	bool ok = values.size() == NR_ROWS * NR_COLS;
+	for (int r = 0; ok && r != NR_ROWS; ++r)
+		for (int c = 0; ok && c != NR_COLS; ++c)
+			ok = (values[r * NR_COLS + c] == expected(r, c));
+	std::cout << "ElementwiseFusion\t" << name << (ok ? "" : "\tWRONG") << std::endl;
+	return ok;
+}
+
+double Distance(int r, int c)
+{
+	double a = r, b = c - 10.0;
+	return std::sqrt(a * a + b * b) * 2.0;
+}
+
+double IntegerChain(int r, int c)
+{
+	return (r * 3 + c) * 2 - 1;
+}
+
+bool TestResults()
+{
+	TestConfig cfg(FUSION_TEST_CONFIG);
+	bool ok = true;
+	ok &= Compare("fused float64 chain"  , cfg.Values("t/fused"), Distance);
+	ok &= Compare("unfused float64 chain", cfg.Values("t/unfused"), Distance);
+	ok &= Compare("fused int32 chain"    , cfg.Values("t/ifused"), IntegerChain);
+	return ok;
+}
+
+bool TestFailure()
+{
+	TestConfig cfg(FUSION_TEST_CONFIG);
+
+	// y fuses with x, which overflows from row 8 on; x is not requested before y
+	bool consumerFails = cfg.Fails("t/y");
+	bool intermediateFailed = cfg.Item("t/x")->WasFailed(FailType::Data);
+	bool ok = consumerFails && intermediateFailed && cfg.Fails("t/x");
+	std::cout << "ElementwiseFusion\tfailure of a fused intermediate"
+		<< "\tconsumer " << (consumerFails ? "failed" : "succeeded")
+		<< "\tintermediate " << (intermediateFailed ? "failed" : "not failed")
+		<< (ok ? "" : "\tWRONG") << std::endl;
+	return ok;
+}
+
+} // anonymous namespace
+
+bool ElementwiseFusionTest()
+{
+	bool ok = true;
+	ok &= TestResults();
+	ok &= TestFailure();
+	return ok;
+}
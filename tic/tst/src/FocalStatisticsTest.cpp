@@ -0,0 +1,223 @@
+// Copyright (C) 1998-2026 Object Vision b.v.
+// License: GNU GPL 3
+/////////////////////////////////////////////////////////////////////////////
+
+// Test of the focal statistics (see geo/dll/src/FocalStatistics.h) against a direct evaluation of each window,
+// for square and circular windows of several radii, random class grids with undefined cells, and blocks
+// that are processed separately, and of the focal operators on a tiled grid, also for values of a wide range.
+// FocalStatisticsBench reports the time of the focal mean, maximum and majority for increasing radii.
+
+#include "SystemTest.h"
+#include "TestConfig.h"
+
+#include "FocalStatistics.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+const int undefined_value = -1;
+bool IsDefinedValue(int v) { return v != undefined_value; }
+
+// the defined values in the window of (y, x), in window order
+std::vector<int> WindowValues(const std::vector<int>& data, std::size_t nrRows, std::size_t nrCols, std::ptrdiff_t radius, bool isCircle, std::ptrdiff_t y, std::ptrdiff_t x)
+{
+	std::vector<int> result;
+	for (std::ptrdiff_t dy = -radius; dy <= radius; ++dy)
+		for (std::ptrdiff_t dx = -radius; dx <= radius; ++dx)
+		{
+			if (isCircle && dx * dx + dy * dy > radius * radius)
+				continue;
+			std::ptrdiff_t wy = y + dy, wx = x + dx;
+			if (wy < 0 || wx < 0 || wy >= std::ptrdiff_t(nrRows) || wx >= std::ptrdiff_t(nrCols))
+				continue;
+			int v = data[wy * nrCols + wx];
+			if (IsDefinedValue(v))
+				result.push_back(v);
+		}
+	return result;
+}
+
+// processes the grid in blocks of blockSize x blockSize cells, in reverse order to exclude dependencies between blocks
+void ForEachBlock(std::size_t nrRows, std::size_t nrCols, std::size_t blockSize, const std::function<void(const focal_block&)>& func)
+{
+	for (std::size_t r = (nrRows + blockSize - 1) / blockSize; r--; )
+		for (std::size_t c = (nrCols + blockSize - 1) / blockSize; c--; )
+			func(focal_block{ r * blockSize, std::min(nrRows, (r + 1) * blockSize), c * blockSize, std::min(nrCols, (c + 1) * blockSize) });
+}
+
+bool Test(std::mt19937& rng, std::size_t nrRows, std::size_t nrCols, std::size_t radius, bool isCircle, int nrClasses, std::size_t blockSize)
+{
+	std::uniform_int_distribution<int> value(undefined_value, nrClasses - 1);
+	std::vector<int> data(nrRows * nrCols);
+	for (auto& v : data)
+		v = value(rng);
+
+	focal_window window(radius, isCircle);
+	std::size_t n = data.size();
+	std::vector<double> sums(n), mins(n), maxs(n), majorities(n), percentiles(n);
+	std::vector<std::size_t> counts(n);
+	const double percentage = 30;
+
+	ForEachBlock(nrRows, nrCols, blockSize, [&](const focal_block& block)
+		{
+			auto at = [nrCols](std::size_t y, std::size_t x) { return y * nrCols + x; };
+			FocalSums(data.begin(), nrRows, nrCols, window, block, IsDefinedValue, [&](std::size_t y, std::size_t x, double sum, std::size_t count) { sums[at(y, x)] = sum; counts[at(y, x)] = count; });
+			FocalExtremes<int>(data.begin(), nrRows, nrCols, window, block, IsDefinedValue, std::less<int>(),
+				[&](std::size_t y, std::size_t x, focal_extreme<int> e) { mins[at(y, x)] = e.defined ? e.value : undefined_value; });
+			FocalExtremes<int>(data.begin(), nrRows, nrCols, window, block, IsDefinedValue, std::greater<int>(),
+				[&](std::size_t y, std::size_t x, focal_extreme<int> e) { maxs[at(y, x)] = e.defined ? e.value : undefined_value; });
+			focal_majority_histogram majority(nrClasses);
+			FocalHistogram(data.begin(), nrRows, nrCols, window, block, IsDefinedValue, [](int v) { return std::size_t(v); }, majority,
+				[&](std::size_t y, std::size_t x, focal_majority_histogram& h) { majorities[at(y, x)] = h.Total() ? int(h.Majority()) : undefined_value; });
+			focal_percentile_histogram percentile(nrClasses);
+			FocalHistogram(data.begin(), nrRows, nrCols, window, block, IsDefinedValue, [](int v) { return std::size_t(v); }, percentile,
+				[&](std::size_t y, std::size_t x, focal_percentile_histogram& h) { percentiles[at(y, x)] = h.Total() ? int(h.Percentile(percentage)) : undefined_value; });
+		}
+	);
+
+	std::size_t nrWrong = 0;
+	for (std::size_t y = 0; y != nrRows; ++y)
+		for (std::size_t x = 0; x != nrCols; ++x)
+		{
+			std::size_t i = y * nrCols + x;
+			auto values = WindowValues(data, nrRows, nrCols, radius, isCircle, y, x);
+			double sum = 0;
+			std::vector<std::size_t> classCounts(nrClasses);
+			for (int v : values)
+			{
+				sum += v;
+				++classCounts[v];
+			}
+			std::sort(values.begin(), values.end());
+			bool any = !values.empty();
+			double expectedMin = any ? values.front() : undefined_value;
+			double expectedMax = any ? values.back() : undefined_value;
+			double expectedMajority = any ? double(std::max_element(classCounts.begin(), classCounts.end()) - classCounts.begin()) : undefined_value;
+			double expectedPercentile = undefined_value;
+			if (any)
+			{
+				std::size_t rank = std::clamp<std::size_t>(std::size_t(std::ceil(percentage / 100 * values.size())), 1, values.size());
+				expectedPercentile = values[rank - 1];
+			}
+			nrWrong += (std::abs(sums[i] - sum) > 1e-9) || counts[i] != values.size() || mins[i] != expectedMin || maxs[i] != expectedMax
+				|| majorities[i] != expectedMajority || percentiles[i] != expectedPercentile;
+		}
+	std::cout << nrRows << "x" << nrCols << "\tradius " << radius << (isCircle ? " circle" : " square") << "\tclasses " << nrClasses << "\tblock " << blockSize
+		<< "\twrong cells " << nrWrong << (nrWrong ? "\tWRONG" : "") << std::endl;
+	return !nrWrong;
+}
+
+// the focal operators on a grid with several tiles, against the window values of the grid that is read back
+bool TestOperator(std::size_t radius, bool isCircle)
+{
+	const std::size_t nrRows = 23, nrCols = 31;
+	auto radiusStr = std::to_string(radius);
+	auto configSource =
+		"container FocalTest { "
+		"	unit<ipoint> g := range(ipoint, point_yx(0i, 0i), point_yx(23i, 31i)); "
+		"	unit<ipoint> t := TiledUnit(point_yx(8i, 6i, g)) "
+		"	{ "
+		"		attribute<int32>   v    := (pointrow(id(.)) * pointrow(id(.)) * 7i + pointcol(id(.)) * 5i + pointrow(id(.)) * pointcol(id(.))) % 4i; "
+		"		attribute<float64> focalSum := focal_sum(v, " + radiusStr + "w, " + (isCircle ? "1w" : "0w") + "); "
+		"		attribute<int32>   focalMax := focal_max(v, " + radiusStr + "w, " + (isCircle ? "1w" : "0w") + "); "
+		"		attribute<int32>   focalMode := focal_majority(v, " + radiusStr + "w, " + (isCircle ? "1w" : "0w") + "); "
+		"		attribute<int32>   focalModeWide := focal_majority(v * 100000i, " + radiusStr + "w, " + (isCircle ? "1w" : "0w") + "); "
+		"	} "
+		"}";
+	TestConfig cfg(configSource.c_str());
+	auto values = cfg.Values("t/v");
+	auto sums = cfg.Values("t/focalSum");
+	auto maxs = cfg.Values("t/focalMax");
+	auto modes = cfg.Values("t/focalMode");
+	auto wideModes = cfg.Values("t/focalModeWide");
+	std::vector<int> data(values.begin(), values.end());
+	if (data.size() != nrRows * nrCols || sums.size() != data.size() || maxs.size() != data.size() || modes.size() != data.size() || wideModes.size() != data.size())
+		return false;
+
+	std::size_t nrWrong = 0;
+	for (std::size_t y = 0; y != nrRows; ++y)
+		for (std::size_t x = 0; x != nrCols; ++x)
+		{
+			std::size_t i = y * nrCols + x;
+			auto window = WindowValues(data, nrRows, nrCols, radius, isCircle, y, x);
+			std::vector<std::size_t> classCounts(4);
+			double sum = 0;
+			for (int v : window)
+			{
+				sum += v;
+				++classCounts[v];
+			}
+			double mode = double(std::max_element(classCounts.begin(), classCounts.end()) - classCounts.begin());
+			nrWrong += (std::abs(sums[i] - sum) > 1e-9) || maxs[i] != *std::max_element(window.begin(), window.end())
+				|| modes[i] != mode || wideModes[i] != mode * 100000;
+		}
+	std::cout << "focal operators\tradius " << radius << (isCircle ? " circle" : " square") << "\twrong cells " << nrWrong << (nrWrong ? "\tWRONG" : "") << std::endl;
+	return !nrWrong;
+}
+
+void Bench(std::size_t size, std::size_t radius, bool isCircle)
+{
+	std::mt19937 rng(1);
+	std::vector<int> data(size * size);
+	for (auto& v : data)
+		v = rng() % 20;
+	focal_window window(radius, isCircle);
+	std::vector<double> output(data.size());
+
+	focal_block block{ 0, size, 0, size };
+
+	auto t0 = std::chrono::steady_clock::now();
+	FocalSums(data.begin(), size, size, window, block, IsDefinedValue, [&](std::size_t y, std::size_t x, double sum, std::size_t count) { output[y * size + x] = sum / count; });
+	auto t1 = std::chrono::steady_clock::now();
+	FocalExtremes<int>(data.begin(), size, size, window, block, IsDefinedValue, std::greater<int>(), [&](std::size_t y, std::size_t x, focal_extreme<int> e) { output[y * size + x] = e.value; });
+	auto t2 = std::chrono::steady_clock::now();
+	focal_majority_histogram majority(20);
+	FocalHistogram(data.begin(), size, size, window, block, IsDefinedValue, [](int v) { return std::size_t(v); }, majority,
+		[&](std::size_t y, std::size_t x, focal_majority_histogram& h) { output[y * size + x] = double(h.Majority()); });
+	auto t3 = std::chrono::steady_clock::now();
+
+	std::cout << size << "x" << size << "\tradius " << radius << (isCircle ? " circle" : " square")
+		<< ":\tmean " << std::chrono::duration<double>(t1 - t0).count() << " s"
+		<< ", max " << std::chrono::duration<double>(t2 - t1).count() << " s"
+		<< ", majority " << std::chrono::duration<double>(t3 - t2).count() << " s" << std::endl;
+}
+
+} // anonymous namespace
+
+bool FocalStatisticsTest()
+{
+	std::mt19937 rng(11);
+	bool ok = true;
+	for (bool isCircle : { false, true })
+	{
+		ok &= Test(rng, 1, 1, 0, isCircle, 3, 1);
+		ok &= Test(rng, 1, 17, 2, isCircle, 3, 1);
+		ok &= Test(rng, 17, 1, 2, isCircle, 3, 4);
+		ok &= Test(rng, 20, 30, 1, isCircle, 4, 7);
+		ok &= Test(rng, 33, 29, 3, isCircle, 5, 33);
+		ok &= Test(rng, 40, 35, 6, isCircle, 7, 9);
+		ok &= Test(rng, 25, 25, 30, isCircle, 3, 6); // window larger than the grid
+		ok &= Test(rng, 50, 45, 9, isCircle, 5, 16); // column histograms for squares: fewer classes than the radius
+		ok &= Test(rng, 30, 30, 4, isCircle, 300, 11);
+		ok &= TestOperator(2, isCircle);
+		ok &= TestOperator(7, isCircle);             // window larger than the tiles
+	}
+	return ok;
+}
+
+bool FocalStatisticsBench()
+{
+	for (std::size_t radius : { 5, 20, 80 })
+		Bench(1000, radius, true);
+	for (std::size_t radius : { 5, 20, 80 })
+		Bench(1000, radius, false);
+	return true;
+}
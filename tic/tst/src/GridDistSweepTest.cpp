@@ -0,0 +1,114 @@
+// Copyright (C) 1998-2026 Object Vision b.v.
+// License: GNU GPL 3
+/////////////////////////////////////////////////////////////////////////////
+
+// Test of griddist_sweep (see geo/dll/src/GridDist.cpp) against griddist, which uses Dijkstra, on a tiled grid:
+// - without obstacles, in which the sweeps of each tile converge;
+// - with walls of undefined costs that leave a gap at alternating sides, such that a path turns back at each wall
+//   and the sweeps of the tiles don't converge within their bound and are completed by Dijkstra;
+// - with a maximum impedance.
+// Impedances of paths with equal cost can be summed in another order, so they are compared with a relative tolerance.
+// GridDistSweepBench reports the times of both on a larger grid, with and without walls.
+
+#include "SystemTest.h"
+#include "TestConfig.h"
+
+#include "utl/mySPrintF.h"
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+// a grid of nrRows x nrCols cells in tiles of tileRows x tileCols cells, with walls at each row r with r % 8 == 4 if withWalls, and 3 start points
+const CharPtr GRIDDIST_CONFIG =
+	"container GridDistSweepTest { "
+	"	unit<ipoint> g := range(ipoint, point_yx(0i, 0i), point_yx(%di, %di)); "
+	"	unit<ipoint> t := TiledUnit(point_yx(%di, %di, g)) "
+	"	{ "
+	"		attribute<int32>   row  := pointrow(id(.)); "
+	"		attribute<int32>   col  := pointcol(id(.)); "
+	"		attribute<bool>    wall := %s && row %% 8i == 4i && iif((row / 8i) %% 2i == 0i, col >= 2i, col < %di - 2i); "
+	"		attribute<float64> cost := iif(wall, null_d, float64((row * 7i + col * 13i) %% 5i) + 1.0); "
+	"	} "
+	"	unit<uint32> s := range(uint32, 0, 3) "
+	"	{ "
+	"		attribute<t> loc := point_yx(int32(id(.)) * 17i %% %di, int32(id(.)) * 29i %% %di + 3i, t); "
+	"	} "
+	"	attribute<float64> dijkstra (t) := griddist(t/cost, s/loc); "
+	"	attribute<float64> sweep    (t) := griddist_sweep(t/cost, s/loc); "
+	"	attribute<float64> dijkstra_max (t) := griddist_maximp(t/cost, s/loc, 40.0); "
+	"	attribute<float64> sweep_max    (t) := griddist_sweep_maximp(t/cost, s/loc, 40.0); "
+	"}";
+
+SharedStr Config(int nrRows, int nrCols, int tileRows, int tileCols, bool withWalls)
+{
+	return mySSPrintF(GRIDDIST_CONFIG, nrRows, nrCols, tileRows, tileCols, withWalls ? "true" : "false", nrCols, nrRows, nrCols - 3);
+}
+
+bool IsEqual(Float64 a, Float64 b)
+{
+	if (std::isnan(a) || std::isnan(b))
+		return std::isnan(a) && std::isnan(b);
+	return std::abs(a - b) <= 1e-9 * std::max(1.0, std::abs(a));
+}
+
+bool Compare(CharPtr name, const std::vector<Float64>& expected, const std::vector<Float64>& actual)
+{
+	SizeT nrWrong = (expected.size() == actual.size()) ? 0 : 1, nrReached = 0;
+	for (SizeT i = 0; !nrWrong && i != expected.size(); ++i)
+	{
+		nrReached += !std::isnan(expected[i]);
+		nrWrong += !IsEqual(expected[i], actual[i]);
+	}
+	std::cout << "GridDistSweep\t" << name << "\t" << nrReached << " of " << expected.size() << " cells reached"
+		<< "\twrong cells " << nrWrong << (nrWrong ? "\tWRONG" : "") << std::endl;
+	return !nrWrong;
+}
+
+bool Test(CharPtr name, bool withWalls)
+{
+	TestConfig cfg(Config(60, 50, 16, 12, withWalls).c_str());
+	auto dijkstra = cfg.Values("dijkstra");
+	bool ok = Compare(name, dijkstra, cfg.Values("sweep"));
+	ok &= Compare((SharedStr(name) + " maximp").c_str(), cfg.Values("dijkstra_max"), cfg.Values("sweep_max"));
+
+	// with walls, the cells behind the last gap are only reachable along the full serpentine
+	if (withWalls)
+		ok &= !std::isnan(dijkstra.back());
+	return ok;
+}
+
+double SecondsOf(const TestConfig& cfg, CharPtr path)
+{
+	auto start = std::chrono::steady_clock::now();
+	cfg.Values(path);
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // anonymous namespace
+
+bool GridDistSweepTest()
+{
+	bool ok = true;
+	ok &= Test("open grid", false);
+	ok &= Test("walls", true);
+	return ok;
+}
+
+bool GridDistSweepBench()
+{
+	const int size = 1000, tileSize = 256;
+	for (bool withWalls : { false, true })
+	{
+		TestConfig cfg(Config(size, size, tileSize, tileSize, withWalls).c_str());
+		cfg.Values("t/cost");
+		double dijkstraTime = SecondsOf(cfg, "dijkstra");
+		double sweepTime = SecondsOf(cfg, "sweep");
+		std::cout << "GridDistSweepBench\t" << size << "x" << size << "\ttiles " << tileSize << "x" << tileSize << (withWalls ? "\twalls" : "\topen")
+			<< "\tgriddist " << dijkstraTime << "s\tgriddist_sweep " << sweepTime << "s" << std::endl;
+	}
+	return true;
+}
@@ -0,0 +1,109 @@
+// Copyright (C) 1998-2026 Object Vision b.v.
+// License: GNU GPL 3
+/////////////////////////////////////////////////////////////////////////////
+
+// Test of the parallel processing of tiles by griddist (see geo/dll/src/GridDist.cpp), which exchanges the border cases of adjacent tiles
+// in bulk-synchronous rounds, against the untiled variants, which process the whole grid as one tile:
+// griddist, griddist_maximp and griddist_zonal with zones that don't align with the tiles must give the same impedance and TraceBack per cell
+// as griddist_untiled, griddist_maximp_untiled and griddist_zonal_untiled, and griddist_zonal with one zone the same as griddist.
+// The grid of 60x50 cells has tiles of 16x12 cells and walls of undefined costs with gaps at alternating sides,
+// such that the paths to most cells cross tile borders several times. The cell costs are square roots of pseudo-random numbers,
+// which makes the shortest path to each cell unique, and thus its TraceBack.
+
+#include "SystemTest.h"
+#include "TestConfig.h"
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+const Int32 NR_ROWS = 60, NR_COLS = 50, TILE_ROWS = 16, TILE_COLS = 12;
+
+const CharPtr GRIDDIST_TILING_TEST_CONFIG =
+	"container GridDistTilingTest { "
+	"	unit<ipoint> g := range(ipoint, point_yx(0i, 0i), point_yx(60i, 50i)); "
+	"	unit<ipoint> t := TiledUnit(point_yx(16i, 12i, g)) "
+	"	{ "
+	"		attribute<int32>   row  := pointrow(id(.)); "
+	"		attribute<int32>   col  := pointcol(id(.)); "
+	"		attribute<bool>    wall := row % 8i == 4i && iif((row / 8i) % 2i == 0i, col >= 2i, col < 48i); "
+	"		attribute<float64> cost := iif(wall, null_d, 1.0 + sqrt(float64((row * 7919i + col * 6151i) % 10007i))); "
+	"		attribute<uint16>  zone := uint16(row / 10i * 3i + col / 20i); "
+	"		attribute<uint16>  one  := const(uint16(0), .); "
+	"	} "
+	"	unit<uint32> s := range(uint32, 0, 3) "
+	"	{ "
+	"		attribute<t> loc := point_yx(int32(id(.)) * 17i % 50i, int32(id(.)) * 29i % 47i + 3i, t); "
+	"	} "
+	"	attribute<float64> tiled          (t) := griddist(t/cost, s/loc); "
+	"	attribute<float64> untiled        (t) := griddist_untiled(t/cost, s/loc); "
+	"	attribute<float64> tiled_max      (t) := griddist_maximp(t/cost, s/loc, 150.0); "
+	"	attribute<float64> untiled_max    (t) := griddist_maximp_untiled(t/cost, s/loc, 150.0); "
+	"	attribute<float64> tiled_zonal    (t) := griddist_zonal(t/cost, s/loc, t/zone, 7.5); "
+	"	attribute<float64> untiled_zonal  (t) := griddist_zonal_untiled(t/cost, s/loc, t/zone, 7.5); "
+	"	attribute<float64> tiled_one_zone (t) := griddist_zonal(t/cost, s/loc, t/one, 7.5); "
+	"}";
+
+bool IsEqual(Float64 a, Float64 b)
+{
+	return a == b || (std::isnan(a) && std::isnan(b));
+}
+
+// the number of cells of which the TraceBack comes from a cell in another tile;
+// the TraceBack is the direction (D_North = 1, D_East = 2, D_West = 4, D_South = 8) of the step into the cell
+SizeT NrTileBorderCrossings(const std::vector<Float64>& traceBack)
+{
+	SizeT result = 0;
+	for (Int32 row = 0; row != NR_ROWS; ++row)
+		for (Int32 col = 0; col != NR_COLS; ++col)
+		{
+			Float64 traceBackValue = traceBack[row * NR_COLS + col];
+			if (std::isnan(traceBackValue))
+				continue;
+			auto d = UInt32(traceBackValue);
+			Int32 prevRow = row + ((d & 1) ? 1 : 0) - ((d & 8) ? 1 : 0);
+			Int32 prevCol = col + ((d & 4) ? 1 : 0) - ((d & 2) ? 1 : 0);
+			if (prevRow / TILE_ROWS != row / TILE_ROWS || prevCol / TILE_COLS != col / TILE_COLS)
+				++result;
+		}
+	return result;
+}
+
+// compares the impedances and TraceBack of the items at tiledPath and untiledPath cell by cell
+bool Compare(const TestConfig& cfg, CharPtr name, CharPtr tiledPath, CharPtr untiledPath)
+{
+	auto tiled = cfg.Values(tiledPath), untiled = cfg.Values(untiledPath);
+	auto tiledTB = cfg.Values((SharedStr(tiledPath) + "/TraceBack").c_str()), untiledTB = cfg.Values((SharedStr(untiledPath) + "/TraceBack").c_str());
+
+	bool ok = tiled.size() == SizeT(NR_ROWS * NR_COLS) && untiled.size() == tiled.size() && tiledTB.size() == tiled.size() && untiledTB.size() == tiled.size();
+	SizeT nrReached = 0, nrWrongImp = 0, nrWrongTB = 0;
+	for (SizeT i = 0; ok && i != tiled.size(); ++i)
+	{
+		nrReached += !std::isnan(untiled[i]);
+		nrWrongImp += !IsEqual(tiled[i], untiled[i]);
+		nrWrongTB += !std::isnan(untiled[i]) && tiledTB[i] != untiledTB[i];
+	}
+	SizeT nrCrossings = ok ? NrTileBorderCrossings(untiledTB) : 0; // start points and unreached cells have no direction
+	ok = ok && !nrWrongImp && !nrWrongTB && nrCrossings;
+	std::cout << "GridDistTiling\t" << name << "\t" << nrReached << " of " << tiled.size() << " cells reached\tfrom another tile " << nrCrossings
+		<< "\twrong impedances " << nrWrongImp << "\twrong TraceBack " << nrWrongTB << (ok ? "" : "\tWRONG") << std::endl;
+	return ok;
+}
+
+} // anonymous namespace
+
+bool GridDistTilingTest()
+{
+	TestConfig cfg(GRIDDIST_TILING_TEST_CONFIG);
+	bool ok = true;
+	ok &= Compare(cfg, "griddist"               , "tiled"         , "untiled");
+	ok &= Compare(cfg, "griddist_maximp"        , "tiled_max"     , "untiled_max");
+	ok &= Compare(cfg, "griddist_zonal"         , "tiled_zonal"   , "untiled_zonal");
+	ok &= Compare(cfg, "griddist_zonal, one zone", "tiled_one_zone", "untiled");
+
+	// the cells below the last wall are reached through its gap
+	ok &= !std::isnan(cfg.Values("tiled").back());
+	return ok;
+}
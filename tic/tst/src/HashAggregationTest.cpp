@@ -0,0 +1,105 @@
+// Copyright (C) 1998-2026 Object Vision b.v.
+// License: GNU GPL 3
+/////////////////////////////////////////////////////////////////////////////
+
+// Test of the hash aggregation of wide value ranges (see clc/dll/include/HashAggregation.h) against the former paths:
+// the same pseudo-random values, with undefined values and many ties in their counts, are given once in a small values range,
+// for which unique and modus keep the sort-merge and counting paths, and once multiplied by SPREAD into the full uint32 range,
+// for which they take the hash path. The results must correspond, and the modus must be the lowest of the values that occur most.
+
+#include "SystemTest.h"
+#include "TestConfig.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+const UInt32 NR_ELEMS = 500000, NR_VALUES = 1000, NR_PARTS = 37, SPREAD = 4000037;
+
+const CharPtr HASH_AGGREGATION_TEST_CONFIG =
+	"container HashAggregationTest { "
+	"	unit<uint32> base := range(uint32, 0, 500000); "
+	"	unit<uint32> e := TiledUnit(value(65536u, base)); "
+	"	unit<uint32> small := range(uint32, 0, 1000); "
+	"	unit<uint32> part := range(uint32, 0, 37); "
+	"	attribute<uint32> r (e) := iif(id(e) % 11u == 0u, null_u, (id(e) * 7919u) % 1000u); "
+	"	attribute<small> xs (e) := value(r, small); "
+	"	attribute<uint32> xw (e) := r * 4000037u; "
+	"	attribute<part> p (e) := value(id(e) % 37u, part); "
+	"	parameter<small> modus_s := modus(xs); "
+	"	parameter<uint32> modus_w := modus(xw); "
+	"	attribute<small> modus_ps (part) := modus(xs, p); "
+	"	attribute<uint32> modus_pw (part) := modus(xw, p); "
+	"	unit<uint32> unique_s := unique(xs); "
+	"	unit<uint32> unique_w := unique(xw); "
+	"	unit<uint32> unique_ns := unique_with_null(xs); "
+	"	unit<uint32> unique_nw := unique_with_null(xw); "
+	"}";
+
+bool IsUndefinedElem(UInt32 i) { return i % 11 == 0; }
+UInt32 ValueOf(UInt32 i) { return UInt32((UInt64(i) * 7919) % NR_VALUES); }
+
+// the lowest value of the highest count, or NaN when no value is counted
+Float64 LowestModus(const std::vector<UInt32>& counts)
+{
+	auto maxPtr = std::max_element(counts.begin(), counts.end()); // first of the maximal elements
+	return (maxPtr == counts.end() || !*maxPtr) ? std::nan("") : Float64(maxPtr - counts.begin());
+}
+
+bool Equal(Float64 a, Float64 b)
+{
+	return a == b || (std::isnan(a) && std::isnan(b));
+}
+
+// the values in the small range, spread as in the wide range
+std::vector<Float64> Spread(std::vector<Float64> values)
+{
+	for (auto& v : values)
+		v *= SPREAD; // NaN stays NaN
+	return values;
+}
+
+bool Compare(CharPtr name, const std::vector<Float64>& hashed, const std::vector<Float64>& former, const std::vector<Float64>& expected)
+{
+	bool ok = hashed.size() == expected.size() && former.size() == expected.size();
+	for (SizeT i = 0; ok && i != expected.size(); ++i)
+		ok = Equal(hashed[i], expected[i]) && Equal(former[i], expected[i]);
+	std::cout << "HashAggregation\t" << name << "\t" << expected.size() << " results" << (ok ? "" : "\tWRONG") << std::endl;
+	return ok;
+}
+
+} // anonymous namespace
+
+bool HashAggregationTest()
+{
+	std::vector<UInt32> counts(NR_VALUES);
+	std::vector<std::vector<UInt32>> partCounts(NR_PARTS, std::vector<UInt32>(NR_VALUES));
+	for (UInt32 i = 0; i != NR_ELEMS; ++i)
+		if (!IsUndefinedElem(i))
+		{
+			++counts[ValueOf(i)];
+			++partCounts[i % NR_PARTS][ValueOf(i)];
+		}
+
+	std::vector<Float64> expectedModus = { LowestModus(counts) * SPREAD };
+	std::vector<Float64> expectedPartModus, expectedUnique, expectedUniqueWithNull = { std::nan("") }; // null first
+	for (const auto& pc : partCounts)
+		expectedPartModus.emplace_back(LowestModus(pc) * SPREAD);
+	for (UInt32 v = 0; v != NR_VALUES; ++v)
+		if (counts[v])
+		{
+			expectedUnique.emplace_back(Float64(v) * SPREAD);
+			expectedUniqueWithNull.emplace_back(Float64(v) * SPREAD);
+		}
+
+	TestConfig cfg(HASH_AGGREGATION_TEST_CONFIG);
+	bool ok = true;
+	ok &= Compare("modus"                        , cfg.Values("modus_w")          , Spread(cfg.Values("modus_s"))          , expectedModus);
+	ok &= Compare("modus per partition"          , cfg.Values("modus_pw")         , Spread(cfg.Values("modus_ps"))         , expectedPartModus);
+	ok &= Compare("unique"                       , cfg.Values("unique_w/Values")  , Spread(cfg.Values("unique_s/Values"))  , expectedUnique);
+	ok &= Compare("unique with undefined values" , cfg.Values("unique_nw/Values") , Spread(cfg.Values("unique_ns/Values")) , expectedUniqueWithNull);
+	return ok;
+}
@@ -1,6 +1,15 @@
+#include "SystemTest.h"
+
+#include "ClcInterface.h"
+#include "GeoInterface.h"
+#include "OperationContext.h"
+
 #include "boost/geometry.hpp"
 #include "boost/geometry/algorithms/union.hpp"
 
+#include <cstring>
+#include <iostream>
+
 namespace bg = boost::geometry;
 
 constexpr bool ClockWise = true;
@@ -11,7 +20,7 @@ using Ring         = bg::model::ring   <Point, ClockWise, Closed>;
 using Polygon      = bg::model::polygon<Point, ClockWise, Closed>;
 using MultiPolygon = bg::model::multi_polygon<Polygon>;
 
-int main(int argc, char** argv)
+void UnionOfAdjacentRings()
 {
 	Ring s1{
 		{ 173904.25160630842, 604340     }, // A
@@ -51,3 +60,18 @@ int main(int argc, char** argv)
 		}
 	}
 }
+
+// Usage: DmTicTst [bench]; runs the test cases, or the benchmarks
+int main(int argc, char** argv)
+{
+	DMS_Geo_Load();
+	DMS_Clc_Load();
+
+	tg_maintainer manageOperationContextTasks;
+
+	if (argc > 1 && !std::strcmp(argv[1], "bench"))
+		return DmsSystemBench() ? 0 : 1;
+
+	UnionOfAdjacentRings();
+	return DmsSystemTest() ? 0 : 1;
+}
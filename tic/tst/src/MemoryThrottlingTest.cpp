@@ -0,0 +1,85 @@
+// Copyright (C) 1998-2026 Object Vision b.v.
+// License: GNU GPL 3
+/////////////////////////////////////////////////////////////////////////////
+
+// Test of the throttling of tile tasks when low on memory (see utl/MemGuard.cpp and tile_task_group in OperationContext.cpp):
+// - with MemoryFlushThreshold at 100%, memory is never low;
+// - with a memory budget of 1 GB (MemoryRAM_MAX_GB) that may only be loaded for 1%, memory is low after the next sample of the memory state,
+//   and a parallel_for then runs its slots on the calling thread and at most one worker thread.
+// The settings are restored afterwards.
+
+#include "SystemTest.h"
+
+#include "utl/Environment.h"
+#include "utl/MemGuard.h"
+#include "utl/scoped_exit.h"
+
+#include "ParallelTiles.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+namespace {
+
+const auto SAMPLE_WAIT_TIME = std::chrono::milliseconds(200); // more than the interval between samples of the memory state
+const auto SLOT_TIME = std::chrono::milliseconds(5);
+
+// the maximum number of slots that ran at the same time
+UInt32 MaxConcurrentSlots(SizeT nrSlots)
+{
+	std::atomic<UInt32> nrRunning = 0, maxNrRunning = 0;
+	parallel_for<SizeT>(nrSlots, [&](SizeT)
+		{
+			auto n = ++nrRunning;
+			auto m = maxNrRunning.load();
+			while (m < n && !maxNrRunning.compare_exchange_weak(m, n))
+			{}
+			std::this_thread::sleep_for(SLOT_TIME);
+			--nrRunning;
+		}
+	);
+	return maxNrRunning;
+}
+
+bool Report(CharPtr name, bool ok)
+{
+	std::cout << "MemoryThrottling\t" << name << (ok ? "" : "\tWRONG") << std::endl;
+	return ok;
+}
+
+} // anonymous namespace
+
+bool MemoryThrottlingTest()
+{
+	auto flushThreshold = RTC_GetRegDWord(RegDWordEnum::MemoryFlushThreshold);
+	auto maxRamGB = RTC_GetRegDWord(RegDWordEnum::MemoryRAM_MAX_GB);
+	bool wasMultiThreaded = IsMultiThreaded1();
+	auto restoreSettings = make_scoped_exit([=]()
+		{
+			RTC_SetCachedDWord(RegDWordEnum::MemoryFlushThreshold, flushThreshold);
+			RTC_SetCachedDWord(RegDWordEnum::MemoryRAM_MAX_GB, maxRamGB); // applied by the next sample of the memory state
+			SetCachedStatusFlag(RSF_MultiThreading1, wasMultiThreaded);
+		}
+	);
+	SetCachedStatusFlag(RSF_MultiThreading1, true);
+
+	bool ok = true;
+	SizeT nrSlots = 4 * std::max<SizeT>(GetNrVCPUs(), 2);
+
+	RTC_SetCachedDWord(RegDWordEnum::MemoryFlushThreshold, 100);
+	ok &= Report("never low at a threshold of 100%", !IsLowOnFreeRAM() && SufficientFreeSpace(SizeT(1) << 40));
+	auto nrUnthrottled = MaxConcurrentSlots(nrSlots);
+
+	RTC_SetCachedDWord(RegDWordEnum::MemoryRAM_MAX_GB, 1);
+	RTC_SetCachedDWord(RegDWordEnum::MemoryFlushThreshold, 1);
+	std::this_thread::sleep_for(SAMPLE_WAIT_TIME); // the budget is applied by the next sample; meanwhile, the worker threads of the former parallel_for decommission
+	ok &= Report("low on a budget of 1 GB with a threshold of 1%", IsLowOnFreeRAM() && !SufficientFreeSpace(SizeT(1) << 30));
+
+	auto nrThrottled = MaxConcurrentSlots(nrSlots);
+	std::cout << "MemoryThrottling\tconcurrent slots of " << nrSlots << "\tunthrottled " << nrUnthrottled << "\tthrottled " << nrThrottled << std::endl;
+	ok &= Report("at most one worker thread besides the calling thread when low", nrThrottled <= 2);
+	return ok;
+}
@@ -0,0 +1,102 @@
+// Copyright (C) 1998-2026 Object Vision b.v.
+// License: GNU GPL 3
+/////////////////////////////////////////////////////////////////////////////
+
+// Round trip of tiled data through MmdStorageManager (StorageType = "mmd"):
+// - a first session calculates both tiled attributes in a writable mmd storage, which FileTileArray<V> writes to the
+//   .dmsdata files of the storage and, for the sequences of the string attribute, to a .seq file with a mempage_table;
+// - a second session reads the same attributes from the read-only storage and compares them with the expected values.
+// The string values grow with the row and column, such that the chunks of the tiles in the .seq file are reallocated.
+// The storage folder is written in the current folder and removed afterwards.
+
+#include "SystemTest.h"
+#include "TestConfig.h"
+
+#include "utl/Environment.h"
+#include "utl/mySPrintF.h"
+
+#include <iostream>
+#include <vector>
+
+namespace {
+
+const CharPtr MMD_WRITE_CONFIG =
+	"container MmdRoundTripTest { "
+	"	unit<ipoint> g := range(ipoint, point_yx(0i, 0i), point_yx(40i, 30i)); "
+	"	unit<ipoint> t := TiledUnit(point_yx(16i, 8i, g)); "
+	"	container store: StorageName = \"%s\", StorageType = \"mmd\" "
+	"	{ "
+	"		attribute<uint32> v (t) := uint32(pointrow(id(t))) * 1000003 + uint32(pointcol(id(t))) * 7; "
+	"		attribute<string> s (t) := repeat('abc', uint32(pointrow(id(t)) + pointcol(id(t)))); "
+	"	} "
+	"	attribute<uint32> len (t) := strlen(store/s); "
+	"	attribute<uint32> nrB (t) := strcount(store/s, 'b'); "
+	"}";
+
+const CharPtr MMD_READ_CONFIG =
+	"container MmdRoundTripTest { "
+	"	unit<ipoint> g := range(ipoint, point_yx(0i, 0i), point_yx(40i, 30i)); "
+	"	unit<ipoint> t := TiledUnit(point_yx(16i, 8i, g)); "
+	"	container store: StorageName = \"%s\", StorageType = \"mmd\", StorageReadOnly = \"True\" "
+	"	{ "
+	"		attribute<uint32> v (t); "
+	"		attribute<string> s (t); "
+	"	} "
+	"	attribute<uint32> len (t) := strlen(store/s); "
+	"	attribute<uint32> nrB (t) := strcount(store/s, 'b'); "
+	"}";
+
+const int NR_ROWS = 40, NR_COLS = 30;
+
+double Value      (int r, int c) { return UInt32(r) * 1000003u + UInt32(c) * 7u; }
+double StringLen  (int r, int c) { return 3 * (r + c); }
+double StringCount(int r, int c) { return r + c; }
+
+bool Compare(CharPtr name, const std::vector<Float64>& values, double (*expected)(int r, int c))
+{
+	bool ok = values.size() == NR_ROWS * NR_COLS;
+	for (int r = 0; ok && r != NR_ROWS; ++r)
+		for (int c = 0; ok && c != NR_COLS; ++c)
+			ok = (values[r * NR_COLS + c] == expected(r, c));
+	std::cout << "MmdRoundTrip\t" << name << (ok ? "" : "\tWRONG") << std::endl;
+	return ok;
+}
+
+bool WriteAndRead(WeakStr storageName)
+{
+	bool ok = true;
+	{
+		TestConfig cfg(mySSPrintF(MMD_WRITE_CONFIG, storageName.c_str()).c_str());
+		ok &= Compare("calculated values"        , cfg.Values("store/v"), Value);
+		ok &= Compare("calculated string lengths", cfg.Values("len"), StringLen); // also requests store/s, so that it is written
+		ok &= Compare("calculated string contents", cfg.Values("nrB"), StringCount);
+	}
+	ok &= IsFileOrDirAccessible(storageName);
+
+	TestConfig cfg(mySSPrintF(MMD_READ_CONFIG, storageName.c_str()).c_str());
+	ok &= Compare("values read back"        , cfg.Values("store/v"), Value);
+	ok &= Compare("string lengths read back", cfg.Values("len"), StringLen);
+	ok &= Compare("string contents read back", cfg.Values("nrB"), StringCount);
+	return ok;
+}
+
+} // anonymous namespace
+
+bool MmdRoundTripTest()
+{
+	SharedStr storageName = GetCurrentDir() + "/MmdRoundTripTest.mmd";
+	KillFileOrDir(storageName);
+
+	bool ok = false;
+	try {
+		ok = WriteAndRead(storageName);
+	}
+	catch (const DmsException& e)
+	{
+		std::cout << "MmdRoundTripTest: " << e.AsErrMsg()->Why().c_str() << std::endl;
+	}
+	KillFileOrDir(storageName);
+
+	std::cout << "MmdRoundTripTest " << (ok ? "OK" : "Failed") << std::endl;
+	return ok;
+}
@@ -0,0 +1,239 @@
+// Copyright (C) 1998-2026 Object Vision b.v.
+// License: GNU GPL 3
+/////////////////////////////////////////////////////////////////////////////
+
+// Test of the STR-packed R-tree (see rtc/dll/src/geo/PackedRTree.h) and of spatial_index (see geo/dll/src/Connect.cpp):
+// - the range and point queries of a built tree, a moved tree and a view on its arrays return the same objects as brute force,
+//   for random rectangles with an undefined one and for random points, of sizes around the node capacity and its powers;
+// - the proximity upper bound has at least one object within it;
+// - a view with an inconsistent number of nodes is rejected;
+// - connect_info, dist_info and point_in_polygon give the same results with the result of spatial_index as without.
+
+#include "SystemTest.h"
+#include "TestConfig.h"
+
+#include "geo/Geometry.h"
+#include "geo/PackedRTree.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+using RectTree  = PackedRTree<Float64, const DRect*>;
+using PointTree = PackedRTree<Float64, const DPoint*>;
+
+bool IsIndexed(const DRect& r) { return IsDefined(r) && !r.inverted(); }
+
+template <typename Tree, typename SelType, typename Object>
+auto Query(const Tree& tree, const SelType& sel, const std::vector<Object>& objects) -> std::vector<SizeT>
+{
+	std::vector<SizeT> result;
+	for (auto iter = tree.begin(sel); iter; ++iter)
+		result.push_back((*iter)->get_ptr() - objects.data());
+	std::sort(result.begin(), result.end());
+	return result;
+}
+
+template <typename SelType, typename Object, typename Pred>
+auto BruteForce(const SelType& sel, const std::vector<Object>& objects, Pred&& isIndexed) -> std::vector<SizeT>
+{
+	std::vector<SizeT> result;
+	for (SizeT i = 0; i != objects.size(); ++i)
+		if (isIndexed(objects[i]) && IsIntersecting(sel, objects[i]))
+			result.push_back(i);
+	return result;
+}
+
+// the number of wrong query results for nrObjects rectangles and points
+SizeT TestTrees(SizeT nrObjects, std::mt19937& rng)
+{
+	std::uniform_real_distribution<Float64> location(0, 1000), size(0, 20);
+	auto randomPoint = [&]() { return DPoint(location(rng), location(rng)); };
+
+	std::vector<DRect> rects;
+	for (SizeT i = 0; i != nrObjects; ++i)
+	{
+		DPoint p = randomPoint();
+		rects.emplace_back(p, DPoint(p.first + size(rng), p.second + size(rng)));
+	}
+	if (nrObjects > 3)
+		rects[2] = DRect(); // not indexed
+
+	RectTree built(rects.data(), rects.data() + nrObjects);
+	std::vector<UInt32> order(built.GetOrder(), built.GetOrder() + built.NrLeafs());
+	std::vector<DPoint> leafLower(built.GetLeafLower(), built.GetLeafLower() + built.NrLeafs());
+	std::vector<DPoint> leafUpper(built.GetLeafUpper(), built.GetLeafUpper() + built.NrLeafs());
+	std::vector<DPoint> nodeLower(built.GetNodeLower(), built.GetNodeLower() + built.NrNodes());
+	std::vector<DPoint> nodeUpper(built.GetNodeUpper(), built.GetNodeUpper() + built.NrNodes());
+	RectTree moved(std::move(built));
+	RectTree view(rects.data(), nrObjects, order.data(), order.size(), leafLower.data(), leafUpper.data(), nodeLower.data(), nodeUpper.data(), nodeLower.size());
+
+	SizeT nrWrong = 0;
+	for (int q = 0; q != 300; ++q)
+	{
+		DPoint p = randomPoint();
+		DRect box(p, DPoint(p.first + 50, p.second + 50));
+		auto expected = BruteForce(box, rects, IsIndexed);
+		nrWrong += (Query(moved, box, rects) != expected);
+		nrWrong += (Query(view , box, rects) != expected);
+		nrWrong += (Query(view, p, rects) != BruteForce(p, rects, IsIndexed));
+
+		if (!view.NrLeafs())
+			continue;
+		UInt32 maxDepth = MAX_VALUE(UInt32);
+		Float64 bound = view.GetSqrProximityUpperBound<Float64>(p, maxDepth, nullptr);
+		bool anyWithin = false;
+		for (const auto& r : rects)
+		{
+			if (!IsIndexed(r))
+				continue;
+			Float64 dx = std::max(std::abs(r.first.first - p.first), std::abs(r.second.first - p.first));
+			Float64 dy = std::max(std::abs(r.first.second - p.second), std::abs(r.second.second - p.second));
+			anyWithin |= (dx * dx + dy * dy <= bound * (1 + 1e-12));
+		}
+		nrWrong += !anyWithin;
+	}
+
+	std::vector<DPoint> points;
+	for (SizeT i = 0; i != nrObjects; ++i)
+		points.emplace_back(randomPoint());
+	PointTree builtPoints(points.data(), points.data() + nrObjects);
+	std::vector<DPoint> pointNodeLower(builtPoints.GetNodeLower(), builtPoints.GetNodeLower() + builtPoints.NrNodes());
+	std::vector<DPoint> pointNodeUpper(builtPoints.GetNodeUpper(), builtPoints.GetNodeUpper() + builtPoints.NrNodes());
+	PointTree pointView(points.data(), nrObjects, builtPoints.GetOrder(), builtPoints.NrLeafs(), nullptr, nullptr, pointNodeLower.data(), pointNodeUpper.data(), pointNodeLower.size());
+	for (int q = 0; q != 100; ++q)
+	{
+		DPoint p = randomPoint();
+		DRect box(p, DPoint(p.first + 80, p.second + 80));
+		auto expected = BruteForce(box, points, [](const DPoint& p) { return IsDefined(p); });
+		nrWrong += (Query(builtPoints, box, points) != expected);
+		nrWrong += (Query(pointView  , box, points) != expected);
+	}
+
+	std::cout << "PackedRTree\t" << nrObjects << " objects\t" << moved.NrLeafs() << " leafs\t" << moved.NrNodes() << " nodes\t" << moved.NrLevels() << " levels"
+		<< "\twrong queries " << nrWrong << (nrWrong ? "\tWRONG" : "") << std::endl;
+	return nrWrong;
+}
+
+bool RejectsInconsistentView()
+{
+	std::vector<DRect> rects(40);
+	std::vector<UInt32> order(40);
+	std::vector<DPoint> boxes(40);
+	try
+	{
+		RectTree view(rects.data(), rects.size(), order.data(), order.size(), boxes.data(), boxes.data(), boxes.data(), boxes.data(), 2); // 40 leafs have 4 nodes
+	}
+	catch (...)
+	{
+		return true;
+	}
+	std::cout << "PackedRTree\ta view with 2 nodes for 40 leafs is accepted\tWRONG" << std::endl;
+	return false;
+}
+
+// random arcs and points, and polygons that don't overlap, such that point_in_polygon has one answer regardless of the order of the tree
+const std::string SPATIAL_INDEX_CONFIG =
+	"container PackedRTreeTest { "
+	"	unit<dpoint> world; "
+	"	unit<uint32> arc := range(uint32, 0, 2000) "
+	"	{ "
+	"		attribute<float64> x  := rnd_uniform(1, ., range(float64, 0.0, 1000.0)); "
+	"		attribute<float64> y  := rnd_uniform(2, ., range(float64, 0.0, 1000.0)); "
+	"		attribute<float64> dx := rnd_uniform(3, ., range(float64, -20.0, 20.0)); "
+	"		attribute<float64> dy := rnd_uniform(4, ., range(float64, -20.0, 20.0)); "
+	"		unit<uint32> pointset := range(uint32, 0, 4000) "
+	"		{ "
+	"			attribute<arc>    seq_nr  := value(id(.) / 2, arc); "
+	"			attribute<uint32> ordinal := id(.) % 2; "
+	"			attribute<world>  point   := point_yx(y[seq_nr] + iif(ordinal == 1, dy[seq_nr], 0.0), x[seq_nr] + iif(ordinal == 1, dx[seq_nr], 0.0), world); "
+	"		} "
+	"		attribute<world> geometry (arc) := points2sequence(pointset/point, pointset/seq_nr, pointset/ordinal); "
+	"	} "
+	"	unit<uint32> poly := range(uint32, 0, 2500) "
+	"	{ "
+	"		attribute<float64> cx := float64(id(.) % 50) * 20.0 + 10.0; "
+	"		attribute<float64> cy := float64(id(.) / 50) * 20.0 + 10.0; "
+	"		attribute<float64> hw := rnd_uniform(5, ., range(float64, 2.0, 9.0)); "
+	"		attribute<float64> hh := rnd_uniform(6, ., range(float64, 2.0, 9.0)); "
+	"		unit<uint32> pointset := range(uint32, 0, 12500) "
+	"		{ "
+	"			attribute<poly>   seq_nr  := value(id(.) / 5, poly); "
+	"			attribute<uint32> ordinal := id(.) % 5; "
+	"			attribute<uint32> corner  := ordinal % 4; "
+	"			attribute<world>  point   := point_yx( "
+	"				cy[seq_nr] + iif(corner >= 2, hh[seq_nr], -hh[seq_nr]), "
+	"				cx[seq_nr] + iif(corner == 1 || corner == 2, hw[seq_nr], -hw[seq_nr]), world); "
+	"		} "
+	"		attribute<world> geometry (polygon) := points2sequence(pointset/point, pointset/seq_nr, pointset/ordinal); "
+	"	} "
+	"	unit<uint32> loc := range(uint32, 0, 3000) "
+	"	{ "
+	"		attribute<world> point := point_yx(rnd_uniform(7, ., range(float64, 0.0, 1000.0)), rnd_uniform(8, ., range(float64, 0.0, 1000.0)), world); "
+	"	} "
+	"	unit<uint32> arc_index  := spatial_index(arc/geometry); "
+	"	unit<uint32> poly_index := spatial_index(poly/geometry); "
+	"	container ci         := connect_info(arc/geometry, loc/point); "
+	"	container ci_indexed := connect_info(arc/geometry, loc/point, arc_index); "
+	"	attribute<float64> di         (loc) := dist_info(arc/geometry, loc/point); "
+	"	attribute<float64> di_indexed (loc) := dist_info(arc/geometry, loc/point, arc_index); "
+	"	attribute<poly>    pip         (loc) := point_in_polygon(loc/point, poly/geometry); "
+	"	attribute<poly>    pip_indexed (loc) := point_in_polygon(loc/point, poly/geometry, poly_index); "
+	"}";
+
+bool IsEqual(const std::vector<Float64>& a, const std::vector<Float64>& b)
+{
+	return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](Float64 x, Float64 y) { return x == y || (std::isnan(x) && std::isnan(y)); });
+}
+
+bool Compare(const TestConfig& cfg, CharPtr name, CharPtr path, CharPtr indexedPath)
+{
+	auto values = cfg.Values(path);
+	bool ok = IsEqual(values, cfg.Values(indexedPath));
+	std::cout << "PackedRTree\t" << name << "\t" << values.size() << " values" << (ok ? "" : "\tDIFFERENT WITH spatial_index") << std::endl;
+	return ok;
+}
+
+// feature_rel is a permutation of the features, all of which have defined extents
+bool IsPermutation(const std::vector<Float64>& featureRel, SizeT nrFeatures)
+{
+	std::vector<Float64> sorted = featureRel;
+	std::sort(sorted.begin(), sorted.end());
+	for (SizeT i = 0; i != sorted.size(); ++i)
+		if (sorted[i] != i)
+			return false;
+	return sorted.size() == nrFeatures;
+}
+
+bool TestSpatialIndex()
+{
+	TestConfig cfg(SPATIAL_INDEX_CONFIG.c_str());
+	bool ok = true;
+	ok &= IsPermutation(cfg.Values("arc_index/feature_rel"), 2000);
+	ok &= IsPermutation(cfg.Values("poly_index/feature_rel"), 2500);
+	ok &= Compare(cfg, "connect_info dist"   , "ci/dist"   , "ci_indexed/dist");
+	ok &= Compare(cfg, "connect_info arc_rel", "ci/arc_rel", "ci_indexed/arc_rel");
+	ok &= Compare(cfg, "dist_info"           , "di"        , "di_indexed");
+	ok &= Compare(cfg, "point_in_polygon"    , "pip"       , "pip_indexed");
+	return ok;
+}
+
+} // anonymous namespace
+
+bool PackedRTreeTest()
+{
+	std::mt19937 rng(1);
+	SizeT nrWrong = 0;
+	for (SizeT n : { 0, 1, 5, 16, 17, 256, 257, 300, 5000, 70000 })
+		nrWrong += TestTrees(n, rng);
+
+	bool ok = !nrWrong;
+	ok &= RejectsInconsistentView();
+	ok &= TestSpatialIndex();
+	return ok;
+}
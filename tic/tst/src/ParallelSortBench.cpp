@@ -0,0 +1,166 @@
+// Copyright (C) 1998-2026 Object Vision b.v.
+// License: GNU GPL 3
+/////////////////////////////////////////////////////////////////////////////
+
+// Benchmark and check of set/ParallelSort.h against the former single-threaded paths:
+// std::sort for the sort operator and std::stable_sort on an index for index, subindex, unique and rlookup.
+// Values contain about 1% nulls (max for unsigned, min for signed, NaN for floats) that must be ordered first.
+
+#include "SystemTest.h"
+
+#include "set/ParallelSort.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <thread>
+#include <vector>
+
+using SizeT = std::size_t;
+
+namespace {
+
+struct thread_executor
+{
+	SizeT nrThreads;
+
+	template <typename Func>
+	void operator ()(SizeT n, Func&& func) const
+	{
+		std::vector<std::thread> threads;
+		for (SizeT t = 1; t < n; ++t)
+			threads.emplace_back([&func, t] { func(t); });
+		if (n)
+			func(0);
+		for (auto& thread : threads)
+			thread.join();
+	}
+};
+
+template <typename V> V Null() { return std::is_floating_point_v<V> ? std::numeric_limits<V>::quiet_NaN() : std::is_signed_v<V> ? std::numeric_limits<V>::min() : std::numeric_limits<V>::max(); }
+template <typename V> bool IsNull(V v) { return std::is_floating_point_v<V> ? v != v : v == Null<V>(); }
+
+// as DataLessThanCompare: null first
+template <typename V>
+struct null_first_less
+{
+	bool operator ()(V a, V b) const { return !IsNull(b) && (IsNull(a) || a < b); }
+};
+
+template <typename V>
+auto MakeData(SizeT n, V maxValue) -> std::vector<V>
+{
+	std::mt19937_64 rng(42);
+	std::vector<V> data(n);
+	for (auto& v : data)
+	{
+		if (rng() % 100 == 0)
+			v = Null<V>();
+		else if constexpr (std::is_floating_point_v<V>)
+			v = V(std::uniform_real_distribution<double>(-double(maxValue), double(maxValue))(rng));
+		else if constexpr (std::is_signed_v<V>)
+			v = V(rng() % SizeT(maxValue)) - maxValue / 2;
+		else
+			v = V(rng() % SizeT(maxValue));
+	}
+	return data;
+}
+
+template <typename Func>
+double Seconds(Func&& func)
+{
+	auto start = std::chrono::steady_clock::now();
+	func();
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+template <typename V>
+bool SameValues(const std::vector<V>& a, const std::vector<V>& b)
+{
+	return std::memcmp(a.data(), b.data(), a.size() * sizeof(V)) == 0;
+}
+
+template <typename V>
+bool Bench(const char* name, SizeT n, V maxValue, SizeT nrThreads)
+{
+	auto data = MakeData<V>(n, maxValue);
+	thread_executor exec{ nrThreads };
+
+	auto sortedRef = data, sorted = data;
+	double tSortRef = Seconds([&] { std::sort(sortedRef.begin(), sortedRef.end(), null_first_less<V>()); });
+	double tSort    = Seconds([&] { parallel_sort::sort(sorted.begin(), sorted.end(), null_first_less<V>(), exec); });
+	// -0.0 and +0.0 may be in a different order, so compare by ordering instead of bits
+	bool sortOk = std::is_sorted(sorted.begin(), sorted.end(), null_first_less<V>())
+		&& std::equal(sorted.begin(), sorted.end(), sortedRef.begin(), [](V a, V b) { return !null_first_less<V>()(a, b) && !null_first_less<V>()(b, a); });
+
+	std::vector<std::uint32_t> indexRef(n), index(n);
+	for (SizeT i = 0; i != n; ++i)
+		indexRef[i] = index[i] = std::uint32_t(i);
+	auto indexComp = [&data](std::uint32_t a, std::uint32_t b) { return null_first_less<V>()(data[a], data[b]); };
+	double tIndexRef = Seconds([&] { std::stable_sort(indexRef.begin(), indexRef.end(), indexComp); });
+	double tIndex    = Seconds([&] { parallel_sort::index_sort(index.begin(), index.end(), data.begin(), indexComp, exec); });
+	bool indexOk = SameValues(index, indexRef);
+
+	std::cout << name << "\t" << n << "\t" << nrThreads
+		<< "\t" << tSortRef << "\t" << tSort << (sortOk ? "" : " WRONG")
+		<< "\t" << tIndexRef << "\t" << tIndex << (indexOk ? "" : " WRONG")
+		<< std::endl;
+	return sortOk && indexOk;
+}
+
+// points and strings take the merge sort path
+struct point { std::int32_t row, col; };
+bool operator <(point a, point b) { return a.row < b.row || (a.row == b.row && a.col < b.col); }
+
+bool BenchPoints(SizeT n, SizeT nrThreads)
+{
+	std::mt19937_64 rng(7);
+	std::vector<point> data(n);
+	for (auto& p : data)
+		p = point{ std::int32_t(rng() % 1000), std::int32_t(rng() % 1000) };
+	thread_executor exec{ nrThreads };
+
+	auto sortedRef = data, sorted = data;
+	double tSortRef = Seconds([&] { std::stable_sort(sortedRef.begin(), sortedRef.end(), std::less<point>()); });
+	double tSort    = Seconds([&] { parallel_sort::sort(sorted.begin(), sorted.end(), std::less<point>(), exec); });
+	bool sortOk = SameValues(sorted, sortedRef);
+
+	std::vector<std::uint32_t> indexRef(n), index(n);
+	for (SizeT i = 0; i != n; ++i)
+		indexRef[i] = index[i] = std::uint32_t(i);
+	auto indexComp = [&data](std::uint32_t a, std::uint32_t b) { return data[a] < data[b]; };
+	double tIndexRef = Seconds([&] { std::stable_sort(indexRef.begin(), indexRef.end(), indexComp); });
+	double tIndex    = Seconds([&] { parallel_sort::index_sort(index.begin(), index.end(), data.begin(), indexComp, exec); });
+	bool indexOk = SameValues(index, indexRef);
+
+	std::cout << "IPoint\t" << n << "\t" << nrThreads
+		<< "\t" << tSortRef << "\t" << tSort << (sortOk ? "" : " WRONG")
+		<< "\t" << tIndexRef << "\t" << tIndex << (indexOk ? "" : " WRONG")
+		<< std::endl;
+	return sortOk && indexOk;
+}
+
+} // anonymous namespace
+
+bool ParallelSortBench()
+{
+	SizeT n = 10000000;
+	SizeT nrThreads = std::max(1u, std::thread::hardware_concurrency());
+
+	std::cout << "type\tn\tthreads\tstd::sort (s)\tparallel sort (s)\tstd::stable_sort index (s)\tparallel index (s)" << std::endl;
+	bool ok = true;
+	for (SizeT m : { SizeT(1000), n })
+	{
+		ok &= Bench<std::uint32_t>("UInt32", m, 1u << 30, nrThreads);
+		ok &= Bench<std::uint32_t>("UInt32 small range", m, 1000, nrThreads);
+		ok &= Bench<std::int32_t >("Int32", m, 1 << 30, nrThreads);
+		ok &= Bench<std::uint64_t>("UInt64", m, std::uint64_t(1) << 60, nrThreads);
+		ok &= Bench<float        >("Float32", m, 1e6f, nrThreads);
+		ok &= Bench<double       >("Float64", m, 1e9, nrThreads);
+		ok &= BenchPoints(m, nrThreads);
+	}
+	return ok;
+}
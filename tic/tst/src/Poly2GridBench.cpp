@@ -0,0 +1,82 @@
+// Copyright (C) 1998-2026 Object Vision b.v.
+// License: GNU GPL 3
+/////////////////////////////////////////////////////////////////////////////
+
+// Benchmark of the rasterization of many small polygons (see geo/dll/src/Poly2GridOper.cpp) onto a tiled grid:
+// - poly2grid, which bins the polygons to the raster tiles once and rasterizes the tiles in parallel;
+// - poly2grid_untiled, which rasterizes all polygons once into the whole grid, and must give the same result;
+// - poly2allgrids, which collects the covered cells of each polygon.
+// The polygons are rectangles at random locations, such that the polygon blocks of the bounding box cache
+// span the whole grid, which was the worst case for the scan of all polygon blocks per raster tile before binning.
+
+#include "SystemTest.h"
+#include "TestConfig.h"
+
+#include "utl/mySPrintF.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+const UInt32 NR_POLYGONS = 250000, GRID_SIZE = 4000, TILE_SIZE = 256;
+
+const CharPtr POLY2GRID_CONFIG =
+	"container Poly2GridBench { "
+	"	unit<dpoint> world; "
+	"	unit<ipoint> g := range(gridset(world, point_yx(1.0, 1.0), point_yx(0.0, 0.0), ipoint), point_yx(0i, 0i), point_yx(%ui, %ui)); "
+	"	unit<ipoint> t := TiledUnit(point_yx(%ui, %ui, g)); "
+	"	unit<uint32> poly := range(uint32, 0, %u) "
+	"	{ "
+	"		attribute<float64> cx := rnd_uniform(1, ., range(float64, 20.0, %u.0)); "
+	"		attribute<float64> cy := rnd_uniform(2, ., range(float64, 20.0, %u.0)); "
+	"		attribute<float64> hw := rnd_uniform(3, ., range(float64, 2.0, 10.0)); "
+	"		attribute<float64> hh := rnd_uniform(4, ., range(float64, 2.0, 10.0)); "
+	"		unit<uint32> pointset := range(uint32, 0, %u) "
+	"		{ "
+	"			attribute<poly>   seq_nr  := value(id(.) / 5, poly); "
+	"			attribute<uint32> ordinal := id(.) %% 5; "
+	"			attribute<uint32> corner  := ordinal %% 4; "
+	"			attribute<world>  point   := point_yx( "
+	"				cy[seq_nr] + iif(corner >= 2, hh[seq_nr], -hh[seq_nr]), "
+	"				cx[seq_nr] + iif(corner == 1 || corner == 2, hw[seq_nr], -hw[seq_nr]), world); "
+	"		} "
+	"		attribute<world> geometry (polygon) := points2sequence(pointset/point, pointset/seq_nr, pointset/ordinal); "
+	"		attribute<float64> area := area(geometry, float64); "
+	"	} "
+	"	attribute<poly> binned   (t) := poly2grid(poly/geometry, t); "
+	"	attribute<poly> untiled  (t) := poly2grid_untiled(poly/geometry, t); "
+	"	unit<uint32>    allgrids     := poly2allgrids(poly/geometry, t); "
+	"}";
+
+double SecondsOf(const TestConfig& cfg, CharPtr path)
+{
+	auto start = std::chrono::steady_clock::now();
+	cfg.Values(path);
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// cells that no polygon covers are undefined in both
+bool IsEqual(const std::vector<Float64>& a, const std::vector<Float64>& b)
+{
+	return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](Float64 x, Float64 y) { return x == y || (std::isnan(x) && std::isnan(y)); });
+}
+
+} // anonymous namespace
+
+bool Poly2GridBench()
+{
+	TestConfig cfg(mySSPrintF(POLY2GRID_CONFIG, GRID_SIZE, GRID_SIZE, TILE_SIZE, TILE_SIZE, NR_POLYGONS, GRID_SIZE - 20, GRID_SIZE - 20, 5 * NR_POLYGONS).c_str());
+	cfg.Values("poly/area"); // calculates the polygons before the timing
+	double binnedTime = SecondsOf(cfg, "binned");
+	double untiledTime = SecondsOf(cfg, "untiled");
+	double allGridsTime = SecondsOf(cfg, "allgrids/polygon_rel");
+	bool ok = IsEqual(cfg.Values("binned"), cfg.Values("untiled"));
+	std::cout << "Poly2GridBench\t" << NR_POLYGONS << " polygons\t" << GRID_SIZE << "x" << GRID_SIZE << "\ttiles " << TILE_SIZE << "x" << TILE_SIZE
+		<< "\tpoly2grid " << binnedTime << "s\tpoly2grid_untiled " << untiledTime << "s\tpoly2allgrids " << allGridsTime << "s"
+		<< (ok ? "" : "\tDIFFERENT RESULT") << std::endl;
+	return ok;
+}
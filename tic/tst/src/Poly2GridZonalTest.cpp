@@ -0,0 +1,192 @@
+// Copyright (C) 1998-2026 Object Vision b.v.
+// License: GNU GPL 3
+/////////////////////////////////////////////////////////////////////////////
+
+// Test of the zonal statistics of polygons on a grid (see geo/dll/src/Poly2GridOper.cpp) on a 10x10 grid of unit cells with 4x4 tiles:
+// poly2grid_zonal_sum, poly2grid_zonal_count, poly2grid_zonal_mean and poly2grid_class_area must match the exact area of
+// the intersection of each polygon with each cell, which is determined here by clipping the polygon to the cell.
+// The polygons cross tile and class boundaries, are not aligned to the cells, extend beyond the grid or lie outside it,
+// and one cell has an undefined value.
+
+#include "SystemTest.h"
+#include "TestConfig.h"
+
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct point { double x, y; };
+using ring = std::vector<point>;
+
+const int GRID_SIZE = 10;
+
+const std::vector<ring> POLYGONS = {
+	{ { 2, 2 }, { 7, 2 }, { 7, 7 }, { 2, 7 } },                // aligned to the cells, across 4 tiles and 4 classes
+	{ { 1, 8 }, { 3, 9 }, { 1, 9.5 } },                        // a triangle within a tile
+	{ { 6.3, 2.4 }, { 8.5, 4.6 }, { 6.3, 6.8 }, { 4.1, 4.6 } }, // a diamond across tiles and classes
+	{ { 8, 8 }, { 11, 8.5 }, { 9, 11 } },                      // partly beyond the grid
+	{ { 12, 1 }, { 14, 1 }, { 13, 3 } },                       // outside the grid
+};
+
+// the grid values and classes of cell (r, c), as in the configuration
+double Value(int r, int c) { return (r == 3 && c == 3) ? std::nan("") : r * 10 + c; }
+int    Class(int r, int c) { return c / 5 + 2 * (r / 5); }
+
+// Sutherland-Hodgman clipping of poly to the half plane inside(p), of which the boundary is crossed at intersect(p, q)
+template <typename Inside, typename Intersect>
+ring ClipHalfPlane(const ring& poly, Inside&& inside, Intersect&& intersect)
+{
+	ring result;
+	for (std::size_t i = 0, n = poly.size(); i != n; ++i)
+	{
+		const point& p = poly[(i + n - 1) % n];
+		const point& q = poly[i];
+		if (inside(q))
+		{
+			if (!inside(p))
+				result.push_back(intersect(p, q));
+			result.push_back(q);
+		}
+		else if (inside(p))
+			result.push_back(intersect(p, q));
+	}
+	return result;
+}
+
+double Area(const ring& poly)
+{
+	double result = 0;
+	for (std::size_t i = 0, n = poly.size(); i != n; ++i)
+	{
+		const point& p = poly[(i + n - 1) % n];
+		const point& q = poly[i];
+		result += p.x * q.y - q.x * p.y;
+	}
+	return std::abs(result) / 2;
+}
+
+// the area of poly within the cell of row r and column c
+double CellArea(ring poly, int r, int c)
+{
+	auto atX = [](double x) { return [x](const point& p, const point& q) { return point{ x, p.y + (x - p.x) * (q.y - p.y) / (q.x - p.x) }; }; };
+	auto atY = [](double y) { return [y](const point& p, const point& q) { return point{ p.x + (y - p.y) * (q.x - p.x) / (q.y - p.y), y }; }; };
+	poly = ClipHalfPlane(poly, [c](const point& p) { return p.x >= c;     }, atX(c));
+	poly = ClipHalfPlane(poly, [c](const point& p) { return p.x <= c + 1; }, atX(c + 1));
+	poly = ClipHalfPlane(poly, [r](const point& p) { return p.y >= r;     }, atY(r));
+	poly = ClipHalfPlane(poly, [r](const point& p) { return p.y <= r + 1; }, atY(r + 1));
+	return poly.size() < 3 ? 0.0 : Area(poly);
+}
+
+std::string Config()
+{
+	std::string xs, ys, seqNrs, ordinals;
+	std::size_t nrPoints = 0;
+	for (std::size_t p = 0; p != POLYGONS.size(); ++p)
+		for (std::size_t i = 0, n = POLYGONS[p].size(); i <= n; ++i, ++nrPoints) // closed rings
+		{
+			const char* sep = nrPoints ? ", " : "";
+			xs       += sep + std::to_string(POLYGONS[p][i % n].x);
+			ys       += sep + std::to_string(POLYGONS[p][i % n].y);
+			seqNrs   += sep + std::to_string(p);
+			ordinals += sep + std::to_string(i);
+		}
+
+	return
+		"container Poly2GridZonalTest { "
+		"	unit<dpoint> world; "
+		"	unit<ipoint> g := range(gridset(world, point_yx(1.0, 1.0), point_yx(0.0, 0.0), ipoint), point_yx(0i, 0i), point_yx(" + std::to_string(GRID_SIZE) + "i, " + std::to_string(GRID_SIZE) + "i)); "
+		"	unit<ipoint> t := TiledUnit(point_yx(4i, 4i, g)) "
+		"	{ "
+		"		attribute<int32>   row := pointrow(id(.)); "
+		"		attribute<int32>   col := pointcol(id(.)); "
+		"		attribute<float64> val := iif(row == 3i && col == 3i, null_d, float64(row * 10i + col)); "
+		"		attribute<uint8>   cls := uint8(col / 5i + 2i * (row / 5i)); "
+		"	} "
+		"	unit<uint32> poly: nrofrows = " + std::to_string(POLYGONS.size()) + " "
+		"	{ "
+		"		unit<uint32> pointset: nrofrows = " + std::to_string(nrPoints) + " "
+		"		{ "
+		"			attribute<float64> x       : [" + xs + "]; "
+		"			attribute<float64> y       : [" + ys + "]; "
+		"			attribute<poly>    seq_nr  : [" + seqNrs + "]; "
+		"			attribute<uint32>  ordinal : [" + ordinals + "]; "
+		"			attribute<world>   point   := point_xy(x, y, world); "
+		"		} "
+		"		attribute<world>   geometry (polygon) := points2sequence(pointset/point, pointset/seq_nr, pointset/ordinal); "
+		"		attribute<float64> sum   := poly2grid_zonal_sum  (geometry, t/val); "
+		"		attribute<float64> count := poly2grid_zonal_count(geometry, t/val); "
+		"		attribute<float64> mean  := poly2grid_zonal_mean (geometry, t/val); "
+		"	} "
+		"	unit<uint32> class_area := poly2grid_class_area(poly/geometry, t/cls); "
+		"}";
+}
+
+bool IsEqual(double expected, double actual)
+{
+	if (std::isnan(expected) || std::isnan(actual))
+		return std::isnan(expected) && std::isnan(actual);
+	return std::abs(expected - actual) <= 1e-9 * std::max(1.0, std::abs(expected));
+}
+
+bool Compare(const char* name, std::size_t p, double expected, double actual)
+{
+	bool ok = IsEqual(expected, actual);
+	std::cout << "Poly2GridZonal\tpolygon " << p << "\t" << name << "\texpected " << expected << "\tactual " << actual << (ok ? "" : "\tWRONG") << std::endl;
+	return ok;
+}
+
+} // anonymous namespace
+
+bool Poly2GridZonalTest()
+{
+	TestConfig cfg(Config().c_str());
+	auto sums   = cfg.Values("poly/sum");
+	auto counts = cfg.Values("poly/count");
+	auto means  = cfg.Values("poly/mean");
+	auto polygonRels = cfg.Values("class_area/polygon_rel");
+	auto classRels   = cfg.Values("class_area/class_rel");
+	auto areas       = cfg.Values("class_area/area");
+	MG_CHECK(sums.size() == POLYGONS.size());
+
+	// the area per (polygon, class) as key polygon * 10 + class
+	std::map<int, double> classAreas;
+	for (std::size_t k = 0; k != areas.size(); ++k)
+		classAreas[int(polygonRels[k]) * 10 + int(classRels[k])] += areas[k];
+
+	bool ok = true;
+	for (std::size_t p = 0; p != POLYGONS.size(); ++p)
+	{
+		double sum = 0, count = 0;
+		std::map<int, double> expectedClassAreas;
+		for (int r = 0; r != GRID_SIZE; ++r)
+			for (int c = 0; c != GRID_SIZE; ++c)
+			{
+				double area = CellArea(POLYGONS[p], r, c);
+				if (!area)
+					continue;
+				expectedClassAreas[int(p) * 10 + Class(r, c)] += area;
+				if (std::isnan(Value(r, c)))
+					continue;
+				sum   += area * Value(r, c);
+				count += area;
+			}
+		ok &= Compare("sum",   p, sum,   sums  [p]);
+		ok &= Compare("count", p, count, counts[p]);
+		ok &= Compare("mean",  p, count > 0 ? sum / count : std::nan(""), means[p]);
+
+		for (const auto& [key, area] : expectedClassAreas)
+		{
+			auto found = classAreas.find(key);
+			ok &= Compare(("class_area of class " + std::to_string(key % 10)).c_str(), p, area, found == classAreas.end() ? 0.0 : found->second);
+			if (found != classAreas.end())
+				classAreas.erase(found);
+		}
+	}
+	// no areas of classes that the polygons don't cover
+	ok &= classAreas.empty();
+	return ok;
+}
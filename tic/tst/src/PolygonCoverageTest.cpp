@@ -0,0 +1,164 @@
+// Copyright (C) 1998-2026 Object Vision b.v.
+// License: GNU GPL 3
+/////////////////////////////////////////////////////////////////////////////
+
+// Test of the anti-aliased rasterization of poly2grid_coverage (see geo/dll/src/PolygonCoverage.h):
+// - the covered fractions of random star shaped polygons within the grid add up to their area;
+// - the covered fraction of each cell matches point sampling on a fine grid, also for polygons that extend
+//   beyond the grid on all sides and for a polygon with a hole that is connected to its outer ring by a lane.
+// - poly2grid_coverage adds the covered fractions of the polygons of an attribute up to their area on a tiled grid.
+
+#include "SystemTest.h"
+#include "TestConfig.h"
+
+#include "PolygonCoverage.h"
+
+#include <cmath>
+#include <iostream>
+#include <numbers>
+#include <random>
+#include <vector>
+
+namespace {
+
+struct point
+{
+	double x, y;
+	double X() const { return x; }
+	double Y() const { return y; }
+};
+
+using ring = std::vector<point>;
+
+ring StarPolygon(std::mt19937& rng, double cx, double cy, double rMin, double rMax, int nrPoints)
+{
+	std::uniform_real_distribution<double> radius(rMin, rMax);
+	ring result;
+	for (int i = 0; i != nrPoints; ++i)
+	{
+		double angle = 2 * std::numbers::pi * i / nrPoints;
+		double r = radius(rng);
+		result.push_back({ cx + r * std::cos(angle), cy + r * std::sin(angle) });
+	}
+	return result;
+}
+
+double Area(const ring& poly)
+{
+	double result = 0;
+	for (std::size_t i = 0, n = poly.size(); i != n; ++i)
+	{
+		const point& p = poly[(i + n - 1) % n];
+		const point& q = poly[i];
+		result += p.x * q.y - q.x * p.y;
+	}
+	return std::abs(result) / 2;
+}
+
+// even-odd test, as the connecting lanes of holes cancel out
+bool IsInside(const ring& poly, double x, double y)
+{
+	bool inside = false;
+	for (std::size_t i = 0, n = poly.size(); i != n; ++i)
+	{
+		const point& p = poly[(i + n - 1) % n];
+		const point& q = poly[i];
+		if ((p.y > y) != (q.y > y) && x < p.x + (y - p.y) * (q.x - p.x) / (q.y - p.y))
+			inside = !inside;
+	}
+	return inside;
+}
+
+std::vector<double> Rasterize(const ring& poly, std::size_t nrCols, std::size_t nrRows)
+{
+	coverage_accumulator acc;
+	acc.Reset(nrCols, nrRows);
+	acc.AddRing(poly.data(), poly.data() + poly.size());
+	std::vector<double> result(nrCols * nrRows);
+	acc.AddCoverageTo(result.data(), nrCols);
+	return result;
+}
+
+bool TestArea(const char* name, const ring& poly, std::size_t nrCols, std::size_t nrRows)
+{
+	auto coverage = Rasterize(poly, nrCols, nrRows);
+	double sum = 0;
+	for (double c : coverage)
+		sum += c;
+	double area = Area(poly);
+	bool ok = std::abs(sum - area) <= 1e-9 * area;
+	std::cout << name << "\tarea " << area << "\tsum of coverage " << sum << (ok ? "" : "\tWRONG") << std::endl;
+	return ok;
+}
+
+bool TestSampling(const char* name, const ring& poly, std::size_t nrCols, std::size_t nrRows)
+{
+	const int nrSamples = 64;
+	auto coverage = Rasterize(poly, nrCols, nrRows);
+	double maxErr = 0;
+	for (std::size_t r = 0; r != nrRows; ++r)
+		for (std::size_t c = 0; c != nrCols; ++c)
+		{
+			int nrInside = 0;
+			for (int i = 0; i != nrSamples; ++i)
+				for (int j = 0; j != nrSamples; ++j)
+					nrInside += IsInside(poly, c + (j + 0.5) / nrSamples, r + (i + 0.5) / nrSamples);
+			maxErr = std::max(maxErr, std::abs(coverage[r * nrCols + c] - double(nrInside) / (nrSamples * nrSamples)));
+		}
+	bool ok = maxErr <= 0.05;
+	std::cout << name << "\tmax deviation from sampling " << maxErr << (ok ? "" : "\tWRONG") << std::endl;
+	return ok;
+}
+
+// a square of 5x5 and a triangle of 1.5 within a 10x10 grid of unit cells with 4x4 tiles
+bool TestOperator()
+{
+	TestConfig cfg(
+		"container PolygonCoverageTest { "
+		"	unit<dpoint> world; "
+		"	unit<ipoint> g := range(gridset(world, point_yx(1.0, 1.0), point_yx(0.0, 0.0), ipoint), point_yx(0i, 0i), point_yx(10i, 10i)); "
+		"	unit<ipoint> t := TiledUnit(point_yx(4i, 4i, g)) "
+		"	{ "
+		"		attribute<float32> coverage := poly2grid_coverage(poly/geometry, .); "
+		"	} "
+		"	unit<uint32> poly: nrofrows = 2 "
+		"	{ "
+		"		unit<uint32> pointset: nrofrows = 9 "
+		"		{ "
+		"			attribute<world>  point   : [{2, 2}, {7, 2}, {7, 7}, {2, 7}, {2, 2}, {1, 8}, {3, 9}, {1, 9.5}, {1, 8}]; "
+		"			attribute<poly>   seq_nr  : [0, 0, 0, 0, 0, 1, 1, 1, 1]; "
+		"			attribute<uint32> ordinal : [0, 1, 2, 3, 4, 0, 1, 2, 3]; "
+		"		} "
+		"		attribute<world> geometry (polygon) := points2sequence(pointset/point, pointset/seq_nr, pointset/ordinal); "
+		"	} "
+		"}"
+	);
+	double sum = 0;
+	for (double c : cfg.Values("t/coverage"))
+		sum += c;
+	bool ok = std::abs(sum - 26.5) <= 1e-4;
+	std::cout << "poly2grid_coverage\tarea 26.5\tsum of coverage " << sum << (ok ? "" : "\tWRONG") << std::endl;
+	return ok;
+}
+
+} // anonymous namespace
+
+bool PolygonCoverageTest()
+{
+	std::mt19937 rng(3);
+	bool ok = true;
+
+	ok &= TestArea("square"          , ring{ {2, 2}, {7, 2}, {7, 7}, {2, 7} }, 10, 10);
+	ok &= TestArea("unaligned square", ring{ {2.3, 2.6}, {7.1, 2.6}, {7.1, 7.9}, {2.3, 7.9} }, 10, 10);
+	ok &= TestArea("sliver"          , ring{ {0.1, 0.1}, {9.9, 0.3}, {9.8, 0.35} }, 10, 10);
+	for (int i = 0; i != 5; ++i)
+		ok &= TestArea("star", StarPolygon(rng, 20, 15, 2, 12, 40), 40, 30);
+
+	ok &= TestSampling("star within"    , StarPolygon(rng, 10, 8, 1, 6, 25), 20, 16);
+	ok &= TestSampling("star beyond"    , StarPolygon(rng, 6, 5, 2, 12, 25), 12, 10);
+	ok &= TestSampling("reversed star"  , [&] { auto p = StarPolygon(rng, 10, 8, 1, 6, 25); return ring(p.rbegin(), p.rend()); }(), 20, 16);
+	ok &= TestSampling("square with hole", ring{ {1, 1}, {9, 1}, {9, 9}, {1, 9}, {1, 1}, {3.5, 3.5}, {3.5, 6.5}, {6.5, 6.5}, {6.5, 3.5}, {3.5, 3.5} }, 10, 10);
+
+	ok &= TestOperator();
+	return ok;
+}
@@ -0,0 +1,114 @@
+// Copyright (C) 1998-2026 Object Vision b.v.
+// License: GNU GPL 3
+/////////////////////////////////////////////////////////////////////////////
+
+// Test of the potentialFft operator (see geo/dll/src/FftConvolution.h) against the potentialSlow operator on tiled grids,
+// for Float32 and Float64 data, kernels that are smaller and larger than the tiles, rectangular kernels and narrower edge tiles.
+// Kernels that are large enough to be split into blocks by fft_kernel would make potentialSlow too slow for a test,
+// therefore the blocked convolution is compared with the unblocked one, which the operator test covers, with a small maximum FFT size.
+// PotentialFftBench reports the time of potentialSlow and potentialFft for a 10km kernel on a 100m grid tile.
+
+#include "SystemTest.h"
+#include "PotentialReference.h"
+
+#include "FftConvolution.h"
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+// the convolution with data and kernel blocks of at most maxFftSize rows and columns against the one without blocks
+template <typename T>
+bool TestBlocks(std::size_t nrDataRows, std::size_t nrDataCols, std::size_t nrKernelRows, std::size_t nrKernelCols, std::size_t maxFftSize)
+{
+	auto data   = RandomData<T>(nrDataRows * nrDataCols, unsigned(nrDataRows * 1000 + nrKernelCols), 0.5);
+	auto kernel = RandomData<T>(nrKernelRows * nrKernelCols, unsigned(nrKernelRows), 0.0);
+	std::size_t nrOutputValues = (nrDataRows + nrKernelRows - 1) * (nrDataCols + nrKernelCols - 1);
+
+	std::vector<std::complex<double>> workspace;
+	fft_kernel<double> unblocked(kernel.data(), nrKernelRows, nrKernelCols, nrDataRows, nrDataCols);
+	std::vector<double> expected(nrOutputValues);
+	unblocked.Convolve(data.data(), nrDataRows, nrDataCols, expected.data(), workspace);
+
+	fft_kernel<double> blocked(kernel.data(), nrKernelRows, nrKernelCols, nrDataRows, nrDataCols, maxFftSize);
+	std::vector<T> output(nrOutputValues);
+	blocked.Convolve(data.data(), nrDataRows, nrDataCols, output.data(), workspace);
+
+	double maxAbs = MaxAbs(expected), maxErr = 0;
+	for (std::size_t i = 0; i != nrOutputValues; ++i)
+		maxErr = std::max(maxErr, std::abs(expected[i] - double(output[i])));
+	bool ok = blocked.NrKernelBlocks() > 1 && workspace.size() <= 2 * maxFftSize * maxFftSize
+		&& maxErr <= maxAbs * (sizeof(T) == sizeof(float) ? 1e-5 : 1e-11);
+	std::cout << "fft blocks\t" << (sizeof(T) == sizeof(float) ? "Float32" : "Float64")
+		<< "\tdata " << nrDataRows << "x" << nrDataCols << "\tkernel " << nrKernelRows << "x" << nrKernelCols << "\tmax fft size " << maxFftSize
+		<< "\t" << blocked.NrKernelBlocks() << " kernel blocks\tmax abs error " << maxErr << " of " << maxAbs << (ok ? "" : "\tWRONG") << std::endl;
+	return ok;
+}
+
+void Bench(int tileSize, int radius)
+{
+	auto ts = std::to_string(tileSize), r = std::to_string(radius);
+	auto configSource =
+		"container PotentialFftBench { "
+		"	unit<ipoint> g := range(ipoint, point_yx(0i, 0i), point_yx(" + ts + "i, " + ts + "i)) "
+		"	{ "
+		"		attribute<float32> data := float32((pointrow(id(.)) * 7i + pointcol(id(.)) * 13i) % 10i) - 3f; "
+		"		attribute<float32> slow := potentialSlow(data, k/w); "
+		"		attribute<float32> fast := potentialFft(data, k/w); "
+		"	} "
+		"	unit<ipoint> k := range(ipoint, point_yx(-" + r + "i, -" + r + "i), point_yx(" + r + "i + 1i, " + r + "i + 1i)) "
+		"	{ "
+		"		attribute<float32> w := float32(1.0 / (1.0 + float64(pointrow(id(.)) * pointrow(id(.)) + pointcol(id(.)) * pointcol(id(.))))); "
+		"	} "
+		"}";
+	TestConfig cfg(configSource.c_str());
+	cfg.Values("g/data");
+	cfg.Values("k/w");
+
+	auto t0 = std::chrono::steady_clock::now();
+	cfg.Values("g/slow");
+	auto t1 = std::chrono::steady_clock::now();
+	cfg.Values("g/fast");
+	auto t2 = std::chrono::steady_clock::now();
+
+	std::cout << "tile " << tileSize << "x" << tileSize << ", kernel " << 2 * radius + 1 << "x" << 2 * radius + 1
+		<< ": potentialSlow " << std::chrono::duration<double>(t1 - t0).count() << " s"
+		<< ", potentialFft " << std::chrono::duration<double>(t2 - t1).count() << " s" << std::endl;
+}
+
+// weights that decrease with the distance to the center of the kernel
+std::string ConeWeights(int radius)
+{
+	return "3i * " + std::to_string(radius) + "i + 1i - abs(pointrow(id(.))) - abs(pointcol(id(.)))";
+}
+
+} // anonymous namespace
+
+bool PotentialFftTest()
+{
+	bool ok = true;
+	ok &= PotentialOperatorTest("potentialFft", "float64", 40, 16, 3, ConeWeights(3));
+	ok &= PotentialOperatorTest("potentialFft", "float64", 45, 16, 20, ConeWeights(20)); // kernel larger than the tiles, and narrower edge tiles
+	ok &= PotentialOperatorTest("potentialFft", "float64", 30, 30, 0, 0, "1i");          // a single tile and a kernel of one cell
+	ok &= PotentialOperatorTest("potentialFft", "float64", 37, 12, 2, 9, ConeWeights(9)); // rectangular kernel, wider than the tiles
+	ok &= PotentialOperatorTest("potentialFft", "float32", 50, 32, 7, ConeWeights(7));
+	ok &= PotentialOperatorTest("potentialFft", "float32", 64, 24, 10, 3, ConeWeights(10));
+
+	ok &= TestBlocks<double>(16, 16, 5, 9, 8);
+	ok &= TestBlocks<double>(10, 30, 41, 41, 16);
+	ok &= TestBlocks<double>(100, 100, 51, 51, 64);
+	ok &= TestBlocks<double>(3, 70, 50, 2, 8);
+	ok &= TestBlocks<float >(64, 48, 21, 21, 32);
+	return ok;
+}
+
+bool PotentialFftBench()
+{
+	Bench(256, 100); // 10km radius on a 100m grid
+	return true;
+}
@@ -0,0 +1,95 @@
+// Copyright (C) 1998-2026 Object Vision b.v.
+// License: GNU GPL 3
+/////////////////////////////////////////////////////////////////////////////
+
+#if !defined(DMS_TEST_POTENTIALREFERENCE_H)
+#define DMS_TEST_POTENTIALREFERENCE_H
+
+// The reference results for the tests of the potential backends (PotentialFftTest.cpp and PotentialSeparableTest.cpp).
+
+#include "TestConfig.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// output[r][c] = sum_ij data[r + i - kRows + 1][c + j - kCols + 1] * kernel[i][j], as CalculateClassic for PotentialSlow, accumulated in double
+template <typename T>
+std::vector<T> DirectPotential(const std::vector<T>& data, std::size_t nrDataRows, std::size_t nrDataCols, const std::vector<T>& kernel, std::size_t nrKernelRows, std::size_t nrKernelCols)
+{
+	std::size_t nrOutputCols = nrDataCols + nrKernelCols - 1;
+	std::vector<double> output((nrDataRows + nrKernelRows - 1) * nrOutputCols);
+	for (std::size_t dr = 0; dr != nrDataRows; ++dr)
+		for (std::size_t dc = 0; dc != nrDataCols; ++dc)
+		{
+			double v = data[dr * nrDataCols + dc];
+			if (!v)
+				continue;
+			for (std::size_t i = 0; i != nrKernelRows; ++i)
+				for (std::size_t j = 0; j != nrKernelCols; ++j)
+					output[(dr + nrKernelRows - 1 - i) * nrOutputCols + (dc + nrKernelCols - 1 - j)] += v * kernel[i * nrKernelCols + j];
+		}
+	return std::vector<T>(output.begin(), output.end());
+}
+
+// values in [-2, 10), of which zeroShare are zero
+template <typename T>
+std::vector<T> RandomData(std::size_t n, unsigned seed, double zeroShare)
+{
+	std::mt19937 rng(seed);
+	std::uniform_real_distribution<double> value(-2.0, 10.0), zero(0.0, 1.0);
+	std::vector<T> result(n);
+	for (auto& v : result)
+		v = (zero(rng) < zeroShare) ? T() : T(value(rng));
+	return result;
+}
+
+inline double MaxAbs(const std::vector<double>& values)
+{
+	double result = 0;
+	for (double v : values)
+		result = std::max(result, std::abs(v));
+	return result;
+}
+
+// the result of the operator against that of potentialSlow for a data grid of gridSize x gridSize cells, in tiles of tileSize x tileSize cells,
+// and a kernel of (2 * rowRadius + 1) x (2 * colRadius + 1) cells with the weights of weightExpr, in terms of pointrow(id(.)) and pointcol(id(.))
+inline bool PotentialOperatorTest(CharPtr oper, CharPtr valueType, int gridSize, int tileSize, int rowRadius, int colRadius, const std::string& weightExpr)
+{
+	auto n = std::to_string(gridSize), ts = std::to_string(tileSize), r = std::to_string(rowRadius), c = std::to_string(colRadius), vt = std::string(valueType);
+	auto configSource =
+		"container PotentialTest { "
+		"	unit<ipoint> g := range(ipoint, point_yx(0i, 0i), point_yx(" + n + "i, " + n + "i)); "
+		"	unit<ipoint> t := TiledUnit(point_yx(" + ts + "i, " + ts + "i, g)) "
+		"	{ "
+		"		attribute<" + vt + "> data := " + vt + "((pointrow(id(.)) * 7i + pointcol(id(.)) * 13i + pointrow(id(.)) * pointcol(id(.))) % 11i); "
+		"		attribute<" + vt + "> slow := potentialSlow(data, k/w); "
+		"		attribute<" + vt + "> fast := " + oper + "(data, k/w); "
+		"	} "
+		"	unit<ipoint> k := range(ipoint, point_yx(-" + r + "i, -" + c + "i), point_yx(" + r + "i + 1i, " + c + "i + 1i)) "
+		"	{ "
+		"		attribute<" + vt + "> w := " + vt + "(" + weightExpr + "); "
+		"	} "
+		"}";
+	TestConfig cfg(configSource.c_str());
+	auto expected = cfg.Values("t/slow");
+	auto output = cfg.Values("t/fast");
+
+	double maxAbs = MaxAbs(expected), maxErr = 0;
+	for (std::size_t i = 0; i != std::min(expected.size(), output.size()); ++i)
+		maxErr = std::max(maxErr, std::abs(expected[i] - output[i]));
+	bool ok = (expected.size() == std::size_t(gridSize * gridSize)) && (output.size() == expected.size()) && maxAbs > 0 && maxErr <= maxAbs * (vt == "float32" ? 1e-4 : 1e-11);
+	std::cout << oper << "\t" << valueType << "\tgrid " << gridSize << "\ttile " << tileSize << "\tkernel radius " << rowRadius << "x" << colRadius
+		<< "\tmax abs error " << maxErr << " of " << maxAbs << (ok ? "" : "\tWRONG") << std::endl;
+	return ok;
+}
+
+inline bool PotentialOperatorTest(CharPtr oper, CharPtr valueType, int gridSize, int tileSize, int radius, const std::string& weightExpr)
+{
+	return PotentialOperatorTest(oper, valueType, gridSize, tileSize, radius, radius, weightExpr);
+}
+
+#endif //!defined(DMS_TEST_POTENTIALREFERENCE_H)
@@ -0,0 +1,165 @@
+// Copyright (C) 1998-2026 Object Vision b.v.
+// License: GNU GPL 3
+/////////////////////////////////////////////////////////////////////////////
+
+// Test of the kernel shape detection and of the PotentialSeparable and PotentialBox convolutions (see geo/dll/src/SeparableConvolution.h)
+// against direct convolution as PotentialSlow does it in CalculateClassic, for box kernels, Gaussian weights on a rectangle,
+// and kernels that are neither, such as Gaussian weights on a disc, and of the potentialSeparable and potentialBox operators
+// against the potentialSlow operator on tiled grids. PotentialSeparableBench reports the time of each for a 10km kernel on a 100m grid tile.
+
+#include "SystemTest.h"
+#include "PotentialReference.h"
+
+#include "SeparableConvolution.h"
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+enum class kernel_kind { box, gaussian_rect, gaussian_disc, random };
+
+template <typename T>
+std::vector<T> MakeKernel(kernel_kind kind, std::size_t nrRows, std::size_t nrCols)
+{
+	std::vector<T> result(nrRows * nrCols);
+	std::mt19937 rng(5);
+	double cr = (nrRows - 1) / 2.0, cc = (nrCols - 1) / 2.0, radius = std::min(cr, cc);
+	for (std::size_t i = 0; i != nrRows; ++i)
+		for (std::size_t j = 0; j != nrCols; ++j)
+		{
+			double sqrDist = (i - cr) * (i - cr) + (j - cc) * (j - cc);
+			T& w = result[i * nrCols + j];
+			switch (kind)
+			{
+				case kernel_kind::box:           w = T(0.25); break;
+				case kernel_kind::gaussian_rect: w = T(std::exp(-sqrDist / (2 * radius * radius + 1))); break;
+				case kernel_kind::gaussian_disc: w = (sqrDist <= radius * radius) ? T(std::exp(-sqrDist / (2 * radius * radius + 1))) : T(); break;
+				case kernel_kind::random:        w = T(rng() % 100) / T(10); break;
+			}
+		}
+	return result;
+}
+
+const char* KindName(kernel_kind kind)
+{
+	switch (kind)
+	{
+		case kernel_kind::box:           return "box";
+		case kernel_kind::gaussian_rect: return "gaussian on rectangle";
+		case kernel_kind::gaussian_disc: return "gaussian on disc";
+		default:                         return "random";
+	}
+}
+
+template <typename T>
+bool Test(kernel_kind kind, std::size_t nrDataRows, std::size_t nrDataCols, std::size_t nrKernelRows, std::size_t nrKernelCols)
+{
+	auto data   = RandomData<T>(nrDataRows * nrDataCols, unsigned(nrDataRows * 31 + nrKernelCols), 0.5);
+	auto kernel = MakeKernel<T>(kind, nrKernelRows, nrKernelCols);
+	auto shape  = DetectKernelShape(kernel.data(), nrKernelRows, nrKernelCols);
+
+	bool expectBox = (kind == kernel_kind::box) || (nrKernelRows * nrKernelCols == 1);
+	bool expectSeparable = (kind != kernel_kind::random && kind != kernel_kind::gaussian_disc) || (nrKernelRows == 1 || nrKernelCols == 1);
+	bool ok = (shape.IsBox() == expectBox) && (shape.IsSeparable() == expectSeparable);
+
+	auto expected = DirectPotential(data, nrDataRows, nrDataCols, kernel, nrKernelRows, nrKernelCols);
+	double maxAbs = 0;
+	for (T v : expected)
+		maxAbs = std::max(maxAbs, std::abs(double(v)));
+	double tolerance = maxAbs * (sizeof(T) == sizeof(float) ? 1e-5 : 1e-11);
+
+	std::vector<T> output(expected.size());
+	std::vector<double> workspace;
+	auto maxError = [&]()
+		{
+			double result = 0;
+			for (std::size_t i = 0; i != expected.size(); ++i)
+				result = std::max(result, std::abs(double(expected[i]) - double(output[i])));
+			return result;
+		};
+
+	std::cout << (sizeof(T) == sizeof(float) ? "Float32" : "Float64") << "\t" << KindName(kind)
+		<< "\tdata " << nrDataRows << "x" << nrDataCols << "\tkernel " << nrKernelRows << "x" << nrKernelCols
+		<< "\tbox " << shape.IsBox() << "\tseparable " << shape.IsSeparable();
+	if (shape.IsSeparable())
+	{
+		ConvolveSeparable(shape, data.data(), nrDataRows, nrDataCols, output.data(), workspace);
+		double err = maxError();
+		ok &= (err <= tolerance);
+		std::cout << "\tseparable error " << err;
+	}
+	if (shape.IsBox())
+	{
+		ConvolveBox(shape, nrKernelRows, nrKernelCols, data.data(), nrDataRows, nrDataCols, output.data(), workspace);
+		double err = maxError();
+		ok &= (err <= tolerance);
+		std::cout << "\tbox error " << err;
+	}
+	std::cout << " of " << maxAbs << (ok ? "" : "\tWRONG") << std::endl;
+	return ok;
+}
+
+// weights that are the product of a row and a column factor, or all 1 for a box
+std::string SeparableWeights(int radius, bool isBox)
+{
+	auto r = std::to_string(radius);
+	return isBox
+		? std::string("1i + 0i * pointrow(id(.))")
+		: "(" + r + "i + 1i - abs(pointrow(id(.)))) * (2i * " + r + "i + 1i - abs(pointcol(id(.))))";
+}
+
+void Bench(std::size_t tileSize, std::size_t kernelSize)
+{
+	auto data = RandomData<float>(tileSize * tileSize, 1, 0.5);
+	std::vector<float> output((tileSize + kernelSize - 1) * (tileSize + kernelSize - 1));
+	std::vector<double> workspace;
+
+	auto gaussian = MakeKernel<float>(kernel_kind::gaussian_rect, kernelSize, kernelSize);
+	auto box      = MakeKernel<float>(kernel_kind::box,           kernelSize, kernelSize);
+
+	auto t0 = std::chrono::steady_clock::now();
+	auto expected = DirectPotential(data, tileSize, tileSize, gaussian, kernelSize, kernelSize);
+	auto t1 = std::chrono::steady_clock::now();
+	ConvolveSeparable(DetectKernelShape(gaussian.data(), kernelSize, kernelSize), data.data(), tileSize, tileSize, output.data(), workspace);
+	auto t2 = std::chrono::steady_clock::now();
+	ConvolveBox(DetectKernelShape(box.data(), kernelSize, kernelSize), kernelSize, kernelSize, data.data(), tileSize, tileSize, output.data(), workspace);
+	auto t3 = std::chrono::steady_clock::now();
+
+	std::cout << "tile " << tileSize << "x" << tileSize << ", kernel " << kernelSize << "x" << kernelSize
+		<< ": direct " << std::chrono::duration<double>(t1 - t0).count() << " s"
+		<< ", separable " << std::chrono::duration<double>(t2 - t1).count() << " s"
+		<< ", box " << std::chrono::duration<double>(t3 - t2).count() << " s" << std::endl;
+}
+
+} // anonymous namespace
+
+bool PotentialSeparableTest()
+{
+	bool ok = true;
+	for (auto kind : { kernel_kind::box, kernel_kind::gaussian_rect, kernel_kind::gaussian_disc, kernel_kind::random })
+	{
+		ok &= Test<double>(kind, 1, 1, 1, 1);
+		ok &= Test<double>(kind, 7, 5, 3, 3);
+		ok &= Test<double>(kind, 16, 16, 5, 9);
+		ok &= Test<double>(kind, 10, 30, 41, 41); // kernel larger than the tile
+		ok &= Test<double>(kind, 20, 20, 1, 7);
+		ok &= Test<float >(kind, 64, 48, 21, 21);
+		ok &= Test<float >(kind, 30, 50, 9, 15);
+	}
+	ok &= PotentialOperatorTest("potentialSeparable", "float64", 40, 16, 3, SeparableWeights(3, false));
+	ok &= PotentialOperatorTest("potentialSeparable", "float32", 45, 16, 20, SeparableWeights(20, false)); // kernel larger than the tiles
+	ok &= PotentialOperatorTest("potentialBox"      , "float64", 40, 16, 3, SeparableWeights(3, true));
+	ok &= PotentialOperatorTest("potentialBox"      , "float32", 45, 16, 20, SeparableWeights(20, true));
+	return ok;
+}
+
+bool PotentialSeparableBench()
+{
+	Bench(256, 201); // 10km radius on a 100m grid
+	return true;
+}
@@ -21,10 +21,47 @@ bool DmsSystemTest()
 		result &= DBG_TEST("Rtc", DMS_RTC_Test());
 		result &= DBG_TEST("ExplCalculatorTest", ExprCalculatorTest());
 
+		result &= DMS_TEST("DistrictLabelling" , DistrictLabellingTest());
+		result &= DMS_TEST("FocalStatistics"   , FocalStatisticsTest());
+		result &= DMS_TEST("PolygonCoverage"   , PolygonCoverageTest());
+		result &= DMS_TEST("Poly2GridZonal"    , Poly2GridZonalTest());
+		result &= DMS_TEST("PotentialFft"      , PotentialFftTest());
+		result &= DMS_TEST("PotentialSeparable", PotentialSeparableTest());
+		result &= DMS_TEST("MmdRoundTrip"      , MmdRoundTripTest());
+		result &= DMS_TEST("CalcCache"         , CalcCacheTest());
+		result &= DMS_TEST("ElementwiseFusion" , ElementwiseFusionTest());
+		result &= DMS_TEST("ContractionHierarchy", ContractionHierarchyTest());
+		result &= DMS_TEST("GridDistSweep"     , GridDistSweepTest());
+		result &= DMS_TEST("PackedRTree"       , PackedRTreeTest());
+		result &= DMS_TEST("HashAggregation"   , HashAggregationTest());
+		result &= DMS_TEST("MemoryThrottling"  , MemoryThrottlingTest());
+		result &= DMS_TEST("DijkstraPairs"     , DijkstraPairsTest());
+		result &= DMS_TEST("GridDistTiling"    , GridDistTilingTest());
+
 		DBG_TRACE(("DmsSystemTest %s" , result ? "OK" : "Failed"));
-		return true;
+		return result;
 
 	DMS_CALL_END;
 	DBG_TRACE(("Exception caught"));
 	return false;
 }
+
+bool DmsSystemBench()
+{
+	DMS_CALL_BEGIN
+
+		bool result = true;
+		result &= DMS_TEST("FocalStatisticsBench"   , FocalStatisticsBench());
+		result &= DMS_TEST("PotentialFftBench"      , PotentialFftBench());
+		result &= DMS_TEST("PotentialSeparableBench", PotentialSeparableBench());
+		result &= DMS_TEST("TileTaskBench"          , TileTaskBench());
+		result &= DMS_TEST("ParallelSortBench"      , ParallelSortBench());
+		result &= DMS_TEST("DijkstraHeapBench"      , DijkstraHeapBench());
+		result &= DMS_TEST("GridDistSweepBench"     , GridDistSweepBench());
+		result &= DMS_TEST("DiscrAllocBench"        , DiscrAllocBench());
+		result &= DMS_TEST("Poly2GridBench"         , Poly2GridBench());
+		return result;
+
+	DMS_CALL_END;
+	return false;
+}
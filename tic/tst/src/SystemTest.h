@@ -2,6 +2,37 @@
 #define DMS_TEST_SYSTEMTESTL_H
 
 bool DmsSystemTest();
+bool DmsSystemBench();
 
+// test cases of DmTicTst; each reports its cases to std::cout and returns false if any fails
+
+bool DistrictLabellingTest();
+bool FocalStatisticsTest();
+bool PolygonCoverageTest();
+bool Poly2GridZonalTest();
+bool PotentialFftTest();
+bool PotentialSeparableTest();
+bool MmdRoundTripTest();
+bool CalcCacheTest();
+bool ElementwiseFusionTest();
+bool ContractionHierarchyTest();
+bool GridDistSweepTest();
+bool PackedRTreeTest();
+bool HashAggregationTest();
+bool MemoryThrottlingTest();
+bool DijkstraPairsTest();
+bool GridDistTilingTest();
+
+// benchmarks, run with "DmTicTst bench"; they also check their results against the former implementations
+
+bool FocalStatisticsBench();
+bool PotentialFftBench();
+bool PotentialSeparableBench();
+bool TileTaskBench();
+bool ParallelSortBench();
+bool DijkstraHeapBench();
+bool GridDistSweepBench();
+bool DiscrAllocBench();
+bool Poly2GridBench();
 
 #endif //!defined(DMS_TEST_SYSTEMTESTL_H)
@@ -0,0 +1,67 @@
+// Copyright (C) 1998-2026 Object Vision b.v.
+// License: GNU GPL 3
+/////////////////////////////////////////////////////////////////////////////
+
+#if !defined(DMS_TEST_TESTCONFIG_H)
+#define DMS_TEST_TESTCONFIG_H
+
+#include "StxInterface.h"
+#include "act/InterestRetainContext.h"
+#include "ptr/AutoDeletePtr.h"
+#include "xct/DmsException.h"
+
+#include "AbstrDataItem.h"
+#include "AbstrDataObject.h"
+#include "AbstrUnit.h"
+#include "DataLocks.h"
+#include "TreeItem.h"
+
+#include <vector>
+
+// A configuration that is parsed from a string, as ExprCalculatorTest does, of which test cases calculate data items
+// through the operators, with their argument checks and tiling, and read the results as Float64 values (undefined as NaN).
+
+struct TestConfig
+{
+	TestConfig(CharPtr configSource)
+		: m_Root(DMS_CreateTreeFromString(configSource))
+	{
+		MG_CHECK(m_Root);
+	}
+
+	auto Item(CharPtr path) const -> const AbstrDataItem*
+	{
+		auto item = m_Root->FindItem(CharPtrRange(path));
+		MG_CHECK(item && IsDataItem(item.get()));
+		return AsDataItem(item.get());
+	}
+
+	auto Values(CharPtr path) const -> std::vector<Float64>
+	{
+		const AbstrDataItem* adi = Item(path);
+		InterestRetainContextBase base;
+		base.Add(adi);
+		PreparedDataReadLock lck(adi, "TestConfig::Values");
+		std::vector<Float64> result(adi->GetAbstrDomainUnit()->GetCount());
+		for (SizeT i = 0; i != result.size(); ++i)
+			result[i] = lck->GetValueAsFloat64(i);
+		return result;
+	}
+
+	// true if calculating the item fails, as it must for arguments that the operator rejects
+	bool Fails(CharPtr path) const
+	{
+		try {
+			Values(path);
+		}
+		catch (const DmsException&)
+		{
+			return true;
+		}
+		return false;
+	}
+
+	AutoDeletePtr<TreeItem> m_Root;
+};
+
+#endif //!defined(DMS_TEST_TESTCONFIG_H)
@@ -0,0 +1,106 @@
+// Copyright (C) 1998-2026 Object Vision b.v.
+// License: GNU GPL 3
+/////////////////////////////////////////////////////////////////////////////
+
+// Benchmark of tile task dispensing by tile_task_group (see tic/dll/src/ParallelTiles.h and OperationContext.cpp):
+// tasks/second of parallel_for and parallel_tileloop with empty and tiny tile functors, single- and multi-threaded (RSF_MultiThreading1).
+// - flat:   the calling thread repeatedly creates a group of NR_SLOTS tile tasks and joins it;
+// - nested: each of NR_OUTER tile tasks runs a parallel_tileloop of NR_SLOTS tiles per iteration, so that joining threads steal from the groups of others.
+// Every slot must be executed exactly once.
+
+#include "SystemTest.h"
+
+#include "utl/Environment.h"
+
+#include "ParallelTiles.h"
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+
+namespace {
+
+const SizeT NR_SLOTS = 64, NR_GROUPS = 20000, NR_OUTER = 64;
+
+struct slot_counts
+{
+	std::unique_ptr<std::atomic<UInt32>[]> m_Counts = std::make_unique<std::atomic<UInt32>[]>(NR_SLOTS);
+
+	void Reset() { for (SizeT i = 0; i != NR_SLOTS; ++i) m_Counts[i] = 0; }
+	bool AllOnce() const { for (SizeT i = 0; i != NR_SLOTS; ++i) if (m_Counts[i] != 1) return false; return true; }
+};
+
+void TileFunc(slot_counts& counts, SizeT i, bool isTiny)
+{
+	if (isTiny)
+	{
+		Float64 sum = 0;
+		for (int k = 0; k != 64; ++k)
+			sum += Float64(k) * i;
+		volatile Float64 sink = sum; (void)sink;
+	}
+	++counts.m_Counts[i];
+}
+
+// the number of executed tiles per second, or 0 when a slot was not executed exactly once
+double TasksPerSecond(bool multiThreaded, bool isTiny, bool nested)
+{
+	bool wasMultiThreaded = IsMultiThreaded1();
+	SetCachedStatusFlag(RSF_MultiThreading1, multiThreaded);
+
+	std::atomic<bool> ok = true;
+	SizeT nrTasks = 0;
+	auto start = std::chrono::steady_clock::now();
+	if (nested)
+	{
+		SizeT nrGroupsPerOuter = NR_GROUPS / NR_OUTER;
+		parallel_for<SizeT>(NR_OUTER, [&](SizeT)
+			{
+				slot_counts counts;
+				for (SizeT g = 0; g != nrGroupsPerOuter; ++g)
+				{
+					counts.Reset();
+					parallel_tileloop(NR_SLOTS, [&counts, isTiny](tile_id t) { TileFunc(counts, t, isTiny); });
+					if (!counts.AllOnce())
+						ok = false;
+				}
+			}
+		);
+		nrTasks = NR_OUTER * nrGroupsPerOuter * NR_SLOTS;
+	}
+	else
+	{
+		slot_counts counts;
+		for (SizeT g = 0; g != NR_GROUPS; ++g)
+		{
+			counts.Reset();
+			parallel_for<SizeT>(NR_SLOTS, [&counts, isTiny](SizeT i) { TileFunc(counts, i, isTiny); });
+			if (!counts.AllOnce())
+				ok = false;
+		}
+		nrTasks = NR_GROUPS * NR_SLOTS;
+	}
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	SetCachedStatusFlag(RSF_MultiThreading1, wasMultiThreaded);
+	return ok ? nrTasks / seconds : 0;
+}
+
+} // anonymous namespace
+
+bool TileTaskBench()
+{
+	bool ok = true;
+	std::cout << "TileTaskBench\tgroups\tfunctor\tsingle-threaded (tasks/s)\tmulti-threaded (tasks/s)" << std::endl;
+	for (bool nested : { false, true })
+		for (bool isTiny : { false, true })
+		{
+			auto serial   = TasksPerSecond(false, isTiny, nested);
+			auto parallel = TasksPerSecond(true , isTiny, nested);
+			ok &= (serial && parallel);
+			std::cout << "TileTaskBench\t" << (nested ? "nested" : "flat") << "\t" << (isTiny ? "tiny" : "empty")
+				<< "\t" << SizeT(serial) << "\t" << SizeT(parallel) << ((serial && parallel) ? "" : "\tSLOT NOT EXECUTED ONCE") << std::endl;
+		}
+	return ok;
+}